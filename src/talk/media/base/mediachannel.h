@@ -847,6 +847,8 @@ struct VideoSenderInfo : public MediaSenderInfo {
   VariableInfo<int> adapt_frame_drops;
   VariableInfo<int> effects_frame_drops;
   VariableInfo<double> capturer_frame_time;
+  // Bytes of pixel data copied or converted per captured frame.
+  VariableInfo<int> capturer_frame_copy_bytes;
 };
 
 struct VideoReceiverInfo : public MediaReceiverInfo {
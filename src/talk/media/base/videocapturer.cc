@@ -109,6 +109,7 @@ VideoCapturer::VideoCapturer()
       adapt_frame_drops_data_(kMaxAccumulatorSize),
       effect_frame_drops_data_(kMaxAccumulatorSize),
       frame_time_data_(kMaxAccumulatorSize),
+      frame_copy_bytes_data_(kMaxAccumulatorSize),
       apply_rotation_(true) {
   Construct();
 }
@@ -118,6 +119,7 @@ VideoCapturer::VideoCapturer(rtc::Thread* thread)
       adapt_frame_drops_data_(kMaxAccumulatorSize),
       effect_frame_drops_data_(kMaxAccumulatorSize),
       frame_time_data_(kMaxAccumulatorSize),
+      frame_copy_bytes_data_(kMaxAccumulatorSize),
       apply_rotation_(true) {
   Construct();
 }
@@ -360,16 +362,19 @@ void VideoCapturer::set_frame_factory(VideoFrameFactory* frame_factory) {
 void VideoCapturer::GetStats(VariableInfo<int>* adapt_drops_stats,
                              VariableInfo<int>* effect_drops_stats,
                              VariableInfo<double>* frame_time_stats,
+                             VariableInfo<int>* frame_copy_bytes_stats,
                              VideoFormat* last_captured_frame_format) {
   rtc::CritScope cs(&frame_stats_crit_);
   GetVariableSnapshot(adapt_frame_drops_data_, adapt_drops_stats);
   GetVariableSnapshot(effect_frame_drops_data_, effect_drops_stats);
   GetVariableSnapshot(frame_time_data_, frame_time_stats);
+  GetVariableSnapshot(frame_copy_bytes_data_, frame_copy_bytes_stats);
   *last_captured_frame_format = last_captured_frame_format_;
 
   adapt_frame_drops_data_.Reset();
   effect_frame_drops_data_.Reset();
   frame_time_data_.Reset();
+  frame_copy_bytes_data_.Reset();
 }
 
 void VideoCapturer::OnFrameCaptured(VideoCapturer*,
@@ -574,11 +579,21 @@ void VideoCapturer::OnFrameCaptured(VideoCapturer*,
   }
   if (muted_) {
     // TODO(pthatcher): Use frame_factory_->CreateBlackFrame() instead.
+    // The buffer may be shared with the capturer.
+    adapted_frame->MakeExclusive();
     adapted_frame->SetToBlack();
   }
+  // The frame still points to the captured pixels unless it had to be
+  // converted, scaled or written to on the way.
+  const VideoFrame* const_adapted_frame = adapted_frame.get();
+  const int frame_copy_bytes =
+      const_adapted_frame->GetYPlane() == captured_frame->data
+          ? 0
+          : static_cast<int>(VideoFrame::SizeOf(adapted_frame->GetWidth(),
+                                                adapted_frame->GetHeight()));
   SignalVideoFrame(this, adapted_frame.get());
 
-  UpdateStats(captured_frame);
+  UpdateStats(captured_frame, frame_copy_bytes);
 }
 
 void VideoCapturer::SetCaptureState(CaptureState state) {
@@ -712,6 +727,10 @@ int64 VideoCapturer::GetFormatDistance(const VideoFormat& desired,
 bool VideoCapturer::ApplyProcessors(VideoFrame* video_frame) {
   bool drop_frame = false;
   rtc::CritScope cs(&crit_);
+  // Processors may write to the frame, whose buffer may be shared with the
+  // capturer.
+  if (!video_processors_.empty())
+    video_frame->MakeExclusive();
   for (VideoProcessors::iterator iter = video_processors_.begin();
        iter != video_processors_.end(); ++iter) {
     (*iter)->OnFrame(kDummyVideoSsrc, video_frame, &drop_frame);
@@ -752,7 +771,8 @@ bool VideoCapturer::ShouldFilterFormat(const VideoFormat& format) const {
          format.height > max_format_->height;
 }
 
-void VideoCapturer::UpdateStats(const CapturedFrame* captured_frame) {
+void VideoCapturer::UpdateStats(const CapturedFrame* captured_frame,
+                                int frame_copy_bytes) {
   // Update stats protected from fetches from different thread.
   rtc::CritScope cs(&frame_stats_crit_);
 
@@ -767,6 +787,7 @@ void VideoCapturer::UpdateStats(const CapturedFrame* captured_frame) {
     adapt_frame_drops_data_.AddSample(adapt_frame_drops_);
     effect_frame_drops_data_.AddSample(effect_frame_drops_);
     frame_time_data_.AddSample(time_now - previous_frame_time_);
+    frame_copy_bytes_data_.AddSample(frame_copy_bytes);
   }
   previous_frame_time_ = time_now;
   effect_frame_drops_ = 0;
@@ -47,6 +47,7 @@
 #include "webrtc/base/sigslot.h"
 #include "webrtc/base/thread.h"
 #include "webrtc/base/timing.h"
+#include "webrtc/common_video/interface/video_frame_buffer.h"
 
 
 namespace cricket {
@@ -105,6 +106,10 @@ struct CapturedFrame {
   void*  data;          // pointer to the frame data. This object allocates the
                         // memory or points to an existing memory.
 
+  // Optional. The I420 buffer which |data| points into, if any. Frames created
+  // from this frame may then reference the buffer rather than copy |data|.
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> video_frame_buffer;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(CapturedFrame);
 };
@@ -314,9 +319,13 @@ class VideoCapturer
   // Gets statistics for tracked variables recorded since the last call to
   // GetStats.  Note that calling GetStats resets any gathered data so it
   // should be called only periodically to log statistics.
+  // |frame_copy_bytes_stats| is the number of bytes of pixel data copied or
+  // converted per frame between the capturer and SignalVideoFrame, which is
+  // zero when the captured buffer is passed on as is.
   void GetStats(VariableInfo<int>* adapt_drop_stats,
                 VariableInfo<int>* effect_drop_stats,
                 VariableInfo<double>* frame_time_stats,
+                VariableInfo<int>* frame_copy_bytes_stats,
                 VideoFormat* last_captured_frame_format);
 
  protected:
@@ -372,7 +381,8 @@ class VideoCapturer
   // Returns true if format doesn't fulfill all applied restrictions.
   bool ShouldFilterFormat(const VideoFormat& format) const;
 
-  void UpdateStats(const CapturedFrame* captured_frame);
+  void UpdateStats(const CapturedFrame* captured_frame,
+                   int frame_copy_bytes);
 
   // Helper function to save statistics on the current data from a
   // RollingAccumulator into stats.
@@ -412,6 +422,7 @@ class VideoCapturer
   rtc::RollingAccumulator<int> effect_frame_drops_data_;
   double previous_frame_time_;
   rtc::RollingAccumulator<double> frame_time_data_;
+  rtc::RollingAccumulator<int> frame_copy_bytes_data_;
   // The captured frame format before potential adapation.
   VideoFormat last_captured_frame_format_;
 
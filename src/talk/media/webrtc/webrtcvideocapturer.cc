@@ -123,6 +123,26 @@ static bool FormatToCapability(const VideoFormat& format,
   return true;
 }
 
+// Returns true if the planes of |buffer| follow each other in memory without
+// padding, i.e. the way a CapturedFrame of fourcc I420 is laid out.
+static bool IsPackedI420(
+    const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer) {
+  if (!buffer || buffer->native_handle() != nullptr)
+    return false;
+  const webrtc::VideoFrameBuffer* const_buffer = buffer.get();
+  const int width = buffer->width();
+  const int height = buffer->height();
+  const int chroma_width = (width + 1) / 2;
+  const int chroma_height = (height + 1) / 2;
+  const uint8_t* y_plane = const_buffer->data(webrtc::kYPlane);
+  return buffer->stride(webrtc::kYPlane) == width &&
+         buffer->stride(webrtc::kUPlane) == chroma_width &&
+         buffer->stride(webrtc::kVPlane) == chroma_width &&
+         const_buffer->data(webrtc::kUPlane) == y_plane + width * height &&
+         const_buffer->data(webrtc::kVPlane) ==
+             y_plane + width * height + chroma_width * chroma_height;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // Implementation of class WebRtcVideoCapturer
 ///////////////////////////////////////////////////////////////////////////
@@ -405,13 +425,25 @@ void WebRtcVideoCapturer::SignalFrameCapturedOnStartThread(
     const webrtc::I420VideoFrame* frame) {
   DCHECK(start_thread_->IsCurrent());
   // Signal down stream components on captured frame.
-  // The CapturedFrame class doesn't support planes. We have to ExtractBuffer
-  // to one block for it.
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer =
+      frame->video_frame_buffer();
   size_t length =
       webrtc::CalcBufferSize(webrtc::kI420, frame->width(), frame->height());
+  if (IsPackedI420(buffer)) {
+    // The planes are laid out as one block already, which the CapturedFrame
+    // can point to. The buffer is passed along so that it can be shared by
+    // the frames sent down stream instead of copied.
+    const webrtc::VideoFrameBuffer* const_buffer = buffer.get();
+    WebRtcCapturedFrame webrtc_frame(
+        *frame, const_cast<uint8_t*>(const_buffer->data(webrtc::kYPlane)),
+        length);
+    webrtc_frame.video_frame_buffer = buffer;
+    SignalFrameCaptured(this, &webrtc_frame);
+    return;
+  }
+  // The CapturedFrame class doesn't support planes. We have to ExtractBuffer
+  // to one block for it.
   capture_buffer_.resize(length);
-  // TODO(magjed): Refactor the WebRtcCapturedFrame to avoid memory copy or
-  // take over ownership of the buffer held by |frame| if that's possible.
   webrtc::ExtractBuffer(*frame, length, &capture_buffer_[0]);
   WebRtcCapturedFrame webrtc_frame(*frame, &capture_buffer_[0], length);
   SignalFrameCaptured(this, &webrtc_frame);
@@ -96,6 +96,7 @@ class WebRtcVideoCapturer : public VideoCapturer,
   rtc::scoped_ptr<WebRtcVcmFactoryInterface> factory_;
   webrtc::VideoCaptureModule* module_;
   int captured_frames_;
+  // Only used for frames whose planes can't be referenced as one block.
   std::vector<uint8_t> capture_buffer_;
   rtc::Thread* start_thread_;  // Set in Start(), unset in Stop();
 
@@ -43,6 +43,19 @@ static const std::string kTestDeviceId = "foo://bar/baz";
 const VideoFormat kDefaultVideoFormat =
     VideoFormat(640, 400, VideoFormat::FpsToInterval(30), cricket::FOURCC_ANY);
 
+class VideoFrameCounter : public sigslot::has_slots<> {
+ public:
+  VideoFrameCounter() : frame_count_(0) {}
+  int frame_count() const { return frame_count_; }
+  void OnVideoFrame(cricket::VideoCapturer* capturer,
+                    const cricket::VideoFrame* frame) {
+    ++frame_count_;
+  }
+
+ private:
+  int frame_count_;
+};
+
 class WebRtcVideoCapturerTest : public testing::Test {
  public:
   WebRtcVideoCapturerTest()
@@ -113,6 +126,34 @@ TEST_F(WebRtcVideoCapturerTest, TestCapture) {
   EXPECT_TRUE(capturer_->GetCaptureFormat() == NULL);
 }
 
+TEST_F(WebRtcVideoCapturerTest, TestCaptureWithoutCopy) {
+  EXPECT_TRUE(capturer_->Init(cricket::Device(kTestDeviceName, kTestDeviceId)));
+  cricket::VideoFormat format(
+      capturer_->GetSupportedFormats()->at(0));
+  EXPECT_EQ(cricket::CS_STARTING, capturer_->Start(format));
+  EXPECT_EQ_WAIT(cricket::CS_RUNNING, listener_.last_capture_state(), 1000);
+  VideoFrameCounter counter;
+  capturer_->SignalVideoFrame.connect(&counter,
+                                      &VideoFrameCounter::OnVideoFrame);
+  // Stats are sampled from the second frame on.
+  const int kNumFrames = 3;
+  for (int i = 0; i < kNumFrames; ++i)
+    EXPECT_TRUE(factory_->modules[0]->SendFrame(640, 480));
+  EXPECT_EQ_WAIT(kNumFrames, counter.frame_count(), 5000);
+  cricket::VariableInfo<int> adapt_drop_stats;
+  cricket::VariableInfo<int> effect_drop_stats;
+  cricket::VariableInfo<double> frame_time_stats;
+  cricket::VariableInfo<int> frame_copy_bytes_stats;
+  cricket::VideoFormat last_captured_frame_format;
+  capturer_->GetStats(&adapt_drop_stats, &effect_drop_stats, &frame_time_stats,
+                      &frame_copy_bytes_stats, &last_captured_frame_format);
+  // The captured buffer is sent on as is.
+  EXPECT_EQ(0, frame_copy_bytes_stats.max_val);
+  EXPECT_EQ(640, last_captured_frame_format.width);
+  EXPECT_EQ(480, last_captured_frame_format.height);
+  capturer_->Stop();
+}
+
 TEST_F(WebRtcVideoCapturerTest, TestCaptureVcm) {
   EXPECT_TRUE(capturer_->Init(factory_->Create(0,
       reinterpret_cast<const char*>(kTestDeviceId.c_str()))));
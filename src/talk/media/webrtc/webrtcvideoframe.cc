@@ -30,6 +30,7 @@
 #include "libyuv/convert.h"
 #include "talk/media/base/videocapturer.h"
 #include "talk/media/base/videocommon.h"
+#include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/video_frame.h"
 
@@ -92,6 +93,21 @@ bool WebRtcVideoFrame::Init(uint32 format,
 
 bool WebRtcVideoFrame::Init(const CapturedFrame* frame, int dw, int dh,
                             bool apply_rotation) {
+  // Reference the captured buffer if it can be used as is.
+  if (frame->video_frame_buffer &&
+      CanonicalFourCC(frame->fourcc) == FOURCC_I420 &&
+      frame->width == dw && frame->height == dh &&
+      (!apply_rotation || frame->GetRotation() == webrtc::kVideoRotation_0)) {
+    DCHECK_EQ(frame->video_frame_buffer->width(), frame->width);
+    DCHECK_EQ(frame->video_frame_buffer->height(), frame->height);
+    video_frame_buffer_ = frame->video_frame_buffer;
+    pixel_width_ = frame->pixel_width;
+    pixel_height_ = frame->pixel_height;
+    elapsed_time_ns_ = frame->elapsed_time;
+    time_stamp_ns_ = frame->time_stamp;
+    rotation_ = frame->GetRotation();
+    return true;
+  }
   return Reset(frame->fourcc, frame->width, frame->height, dw, dh,
                static_cast<uint8*>(frame->data), frame->data_size,
                frame->pixel_width, frame->pixel_height, frame->elapsed_time,
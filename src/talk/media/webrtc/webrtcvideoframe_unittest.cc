@@ -29,6 +29,7 @@
 
 #include "talk/media/base/videoframe_unittest.h"
 #include "talk/media/webrtc/webrtcvideoframe.h"
+#include "talk/media/webrtc/webrtcvideoframeconverter.h"
 
 namespace {
 
@@ -355,3 +356,86 @@ TEST_F(WebRtcVideoFrameTest, ApplyRotationToFrame) {
   EXPECT_EQ(applied360->GetVideoRotation(), webrtc::kVideoRotation_0);
   EXPECT_TRUE(IsEqual(applied0, *applied360, 0));
 }
+
+TEST_F(WebRtcVideoFrameTest, ConverterMatchesFrame) {
+  cricket::WebRtcVideoFrame frame1;
+  cricket::WebRtcVideoFrame frame2;
+  ASSERT_TRUE(LoadFrameNoRepeat(&frame1));
+  ASSERT_TRUE(LoadFrameNoRepeat(&frame2));
+  frame2.SetTimeStamp(frame1.GetTimeStamp() + 1);
+  cricket::WebRtcVideoFrameConverter converter;
+
+  // RGB conversions of two frames in one batch.
+  const uint32 fourccs[] = {cricket::FOURCC_ARGB, cricket::FOURCC_24BG,
+                            cricket::FOURCC_YUY2};
+  const int bpps[] = {4, 3, 2};
+  for (size_t i = 0; i < ARRAY_SIZE(fourccs); ++i) {
+    const int stride = kWidth * bpps[i];
+    const size_t size = stride * kHeight;
+    rtc::scoped_ptr<uint8[]> expected1(new uint8[size]);
+    rtc::scoped_ptr<uint8[]> expected2(new uint8[size]);
+    rtc::scoped_ptr<uint8[]> out1(new uint8[size]);
+    rtc::scoped_ptr<uint8[]> out2(new uint8[size]);
+    EXPECT_EQ(size, frame1.ConvertToRgbBuffer(fourccs[i], expected1.get(),
+                                              size, stride));
+    EXPECT_EQ(size, frame2.ConvertToRgbBuffer(fourccs[i], expected2.get(),
+                                              size, stride));
+    std::vector<cricket::WebRtcVideoFrameConverter::RgbConversion> conversions;
+    conversions.push_back(
+        cricket::WebRtcVideoFrameConverter::RgbConversion(
+            &frame1, fourccs[i], out1.get(), size, stride));
+    conversions.push_back(
+        cricket::WebRtcVideoFrameConverter::RgbConversion(
+            &frame2, fourccs[i], out2.get(), size, stride));
+    EXPECT_TRUE(converter.ConvertToRgbBuffers(conversions));
+    EXPECT_EQ(0, memcmp(expected1.get(), out1.get(), size));
+    EXPECT_EQ(0, memcmp(expected2.get(), out2.get(), size));
+
+    // And back.
+    cricket::WebRtcVideoFrame expected;
+    ASSERT_TRUE(expected.Init(fourccs[i], kWidth, kHeight, kWidth, kHeight,
+                              out1.get(), size, 1, 1, 0, 0,
+                              webrtc::kVideoRotation_0));
+    cricket::WebRtcVideoFrame converted;
+    ASSERT_TRUE(converted.InitToBlack(kWidth, kHeight, 1, 1, 0, 0));
+    EXPECT_TRUE(converter.ConvertFromRgbBuffer(fourccs[i], out1.get(), size,
+                                               &converted));
+    EXPECT_TRUE(IsEqual(expected, converted, 0));
+  }
+
+  // A buffer which is too small is reported with the size needed.
+  const size_t argb_size = kWidth * 4 * kHeight;
+  rtc::scoped_ptr<uint8[]> argb(new uint8[argb_size]);
+  EXPECT_EQ(argb_size,
+            converter.ConvertToRgbBuffer(frame1, cricket::FOURCC_ARGB,
+                                         argb.get(), argb_size - 1,
+                                         kWidth * 4));
+
+  // Copies.
+  cricket::WebRtcVideoFrame copy;
+  ASSERT_TRUE(copy.InitToBlack(kWidth, kHeight, 1, 1, frame1.GetElapsedTime(),
+                               frame1.GetTimeStamp()));
+  EXPECT_TRUE(converter.CopyToPlanes(frame1, copy.GetYPlane(),
+                                     copy.GetUPlane(), copy.GetVPlane(),
+                                     copy.GetYPitch(), copy.GetUPitch(),
+                                     copy.GetVPitch()));
+  EXPECT_TRUE(IsEqual(frame1, copy, 0));
+
+  // Stretches, with and without interpolation. The box and bilinear filters
+  // only differ when shrinking by more than 2.
+  const size_t sizes[][2] = {{kWidth / 2, kHeight / 2},
+                             {kWidth / 4, kHeight / 4},
+                             {kWidth * 3 / 8, kHeight * 3 / 8},
+                             {kWidth * 3 / 2, kHeight * 3 / 2}};
+  for (size_t i = 0; i < ARRAY_SIZE(sizes); ++i) {
+    for (int interpolate = 0; interpolate < 2; ++interpolate) {
+      cricket::WebRtcVideoFrame expected;
+      cricket::WebRtcVideoFrame stretched;
+      ASSERT_TRUE(expected.InitToBlack(sizes[i][0], sizes[i][1], 1, 1, 0, 0));
+      ASSERT_TRUE(stretched.InitToBlack(sizes[i][0], sizes[i][1], 1, 1, 0, 0));
+      frame1.StretchToFrame(&expected, interpolate != 0, false);
+      converter.StretchToFrame(frame1, &stretched, interpolate != 0, false);
+      EXPECT_TRUE(IsEqual(expected, stretched, 0));
+    }
+  }
+}
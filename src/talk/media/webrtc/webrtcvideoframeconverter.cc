@@ -0,0 +1,194 @@
+/*
+ * libjingle
+ * Copyright 2015 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "talk/media/webrtc/webrtcvideoframeconverter.h"
+
+#include <stdlib.h>
+
+#include "webrtc/base/logging.h"
+#include "webrtc/common_video/libyuv/include/scaler.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/system_wrappers/interface/worker_pool.h"
+
+namespace cricket {
+
+namespace {
+
+bool HasPlanes(const VideoFrame& frame) {
+  return frame.GetYPlane() && frame.GetUPlane() && frame.GetVPlane();
+}
+
+}  // namespace
+
+WebRtcVideoFrameConverter::WebRtcVideoFrameConverter()
+    : scaler_thread_pool_(webrtc::WorkerPool::GetSharedPool()) {
+}
+
+WebRtcVideoFrameConverter::~WebRtcVideoFrameConverter() {
+  webrtc::WorkerPool::ReturnSharedPool();
+}
+
+size_t WebRtcVideoFrameConverter::ConvertToRgbBuffer(const VideoFrame& frame,
+                                                     uint32 to_fourcc,
+                                                     uint8* buffer,
+                                                     size_t size,
+                                                     int stride_rgb) const {
+  const size_t needed = std::abs(stride_rgb) * frame.GetHeight();
+  if (size < needed) {
+    LOG(LS_WARNING) << "RGB buffer is not large enough";
+    return needed;
+  }
+  std::vector<RgbConversion> conversions(
+      1, RgbConversion(&frame, to_fourcc, buffer, size, stride_rgb));
+  return ConvertToRgbBuffers(conversions) ? needed : 0;  // 0 indicates error
+}
+
+bool WebRtcVideoFrameConverter::ConvertToRgbBuffers(
+    const std::vector<RgbConversion>& conversions) const {
+  bool success = true;
+  std::vector<webrtc::I420Conversion> i420_conversions;
+  i420_conversions.reserve(conversions.size());
+  for (const RgbConversion& conversion : conversions) {
+    const VideoFrame& frame = *conversion.frame;
+    if (!HasPlanes(frame)) {
+      LOG(LS_ERROR) << "NULL plane pointer.";
+      success = false;
+      continue;
+    }
+    if (conversion.size <
+        std::abs(conversion.stride_rgb) * frame.GetHeight()) {
+      LOG(LS_WARNING) << "RGB buffer is not large enough";
+      success = false;
+      continue;
+    }
+    const webrtc::I420Conversion i420_conversion = {
+        frame.GetYPlane(), frame.GetYPitch(),
+        frame.GetUPlane(), frame.GetUPitch(),
+        frame.GetVPlane(), frame.GetVPitch(),
+        conversion.buffer, conversion.stride_rgb,
+        static_cast<int>(frame.GetWidth()),
+        static_cast<int>(frame.GetHeight()),
+        conversion.to_fourcc};
+    i420_conversions.push_back(i420_conversion);
+  }
+  if (!i420_conversions.empty() &&
+      webrtc::ConvertFromI420(scaler_thread_pool_, &i420_conversions[0],
+                              static_cast<int>(i420_conversions.size())) != 0) {
+    LOG(LS_ERROR) << "RGB conversion failed, type not supported?";
+    success = false;
+  }
+  return success;
+}
+
+bool WebRtcVideoFrameConverter::ConvertFromRgbBuffer(uint32 from_fourcc,
+                                                     const uint8* buffer,
+                                                     size_t size,
+                                                     VideoFrame* frame) const {
+  if (!frame || !HasPlanes(*frame)) {
+    LOG(LS_ERROR) << "NULL plane pointer.";
+    return false;
+  }
+  if (webrtc::ConvertToI420(scaler_thread_pool_, buffer, size,
+                            frame->GetYPlane(), frame->GetYPitch(),
+                            frame->GetUPlane(), frame->GetUPitch(),
+                            frame->GetVPlane(), frame->GetVPitch(),
+                            static_cast<int>(frame->GetWidth()),
+                            static_cast<int>(frame->GetHeight()),
+                            from_fourcc) != 0) {
+    LOG(LS_ERROR) << "Failed to convert from type " << from_fourcc;
+    return false;
+  }
+  return true;
+}
+
+bool WebRtcVideoFrameConverter::CopyToPlanes(const VideoFrame& frame,
+                                             uint8* dst_y,
+                                             uint8* dst_u,
+                                             uint8* dst_v,
+                                             int32 dst_pitch_y,
+                                             int32 dst_pitch_u,
+                                             int32 dst_pitch_v) const {
+  if (!HasPlanes(frame)) {
+    LOG(LS_ERROR) << "NULL plane pointer.";
+    return false;
+  }
+  return webrtc::CopyI420(scaler_thread_pool_,
+                          frame.GetYPlane(), frame.GetYPitch(),
+                          frame.GetUPlane(), frame.GetUPitch(),
+                          frame.GetVPlane(), frame.GetVPitch(),
+                          dst_y, dst_pitch_y,
+                          dst_u, dst_pitch_u,
+                          dst_v, dst_pitch_v,
+                          static_cast<int>(frame.GetWidth()),
+                          static_cast<int>(frame.GetHeight())) == 0;
+}
+
+void WebRtcVideoFrameConverter::StretchToFrame(const VideoFrame& frame,
+                                               VideoFrame* dst,
+                                               bool interpolate,
+                                               bool vert_crop) const {
+  if (!dst) {
+    LOG(LS_ERROR) << "NULL dst pointer.";
+    return;
+  }
+  const size_t width = dst->GetWidth();
+  const size_t height = dst->GetHeight();
+  // Only VideoFrame can change the rotation of |dst|.
+  if ((vert_crop &&
+       frame.GetWidth() * height != frame.GetHeight() * width) ||
+      dst->GetVideoRotation() != frame.GetVideoRotation()) {
+    frame.StretchToFrame(dst, interpolate, vert_crop);
+    return;
+  }
+  if (!HasPlanes(frame) || !HasPlanes(*dst)) {
+    LOG(LS_ERROR) << "NULL plane pointer.";
+    return;
+  }
+
+  if (width == frame.GetWidth() && height == frame.GetHeight()) {
+    CopyToPlanes(frame, dst->GetYPlane(), dst->GetUPlane(), dst->GetVPlane(),
+                 dst->GetYPitch(), dst->GetUPitch(), dst->GetVPitch());
+  } else if (webrtc::ScaleI420(scaler_thread_pool_,
+                               frame.GetYPlane(), frame.GetYPitch(),
+                               frame.GetUPlane(), frame.GetUPitch(),
+                               frame.GetVPlane(), frame.GetVPitch(),
+                               static_cast<int>(frame.GetWidth()),
+                               static_cast<int>(frame.GetHeight()),
+                               dst->GetYPlane(), dst->GetYPitch(),
+                               dst->GetUPlane(), dst->GetUPitch(),
+                               dst->GetVPlane(), dst->GetVPitch(),
+                               static_cast<int>(width),
+                               static_cast<int>(height),
+                               interpolate ? webrtc::kScaleAverage
+                                           : webrtc::kScalePoint) != 0) {
+    LOG(LS_WARNING) << "Failed to scale frame to " << width << "x" << height;
+  }
+  dst->SetElapsedTime(frame.GetElapsedTime());
+  dst->SetTimeStamp(frame.GetTimeStamp());
+}
+
+}  // namespace cricket
@@ -0,0 +1,101 @@
+/*
+ * libjingle
+ * Copyright 2015 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TALK_MEDIA_WEBRTC_WEBRTCVIDEOFRAMECONVERTER_H_
+#define TALK_MEDIA_WEBRTC_WEBRTCVIDEOFRAMECONVERTER_H_
+
+#include <vector>
+
+#include "talk/media/base/videoframe.h"
+#include "webrtc/base/basictypes.h"
+#include "webrtc/base/constructormagic.h"
+
+namespace webrtc {
+class WorkerPool;
+}  // namespace webrtc
+
+namespace cricket {
+
+// Converts, copies and stretches VideoFrames like the VideoFrame methods of
+// the same names, but splits the rows of each frame in stripes which are
+// converted in parallel on the shared scaler threads. The caller provides the
+// destination buffers, so they can be pooled. Useful when many streams are
+// rendered or exported, e.g. by a recorder compositing them in RGB.
+class WebRtcVideoFrameConverter {
+ public:
+  // Conversion of |frame| to |to_fourcc| for ConvertToRgbBuffers().
+  struct RgbConversion {
+    RgbConversion(const VideoFrame* frame, uint32 to_fourcc, uint8* buffer,
+                  size_t size, int stride_rgb)
+        : frame(frame), to_fourcc(to_fourcc), buffer(buffer), size(size),
+          stride_rgb(stride_rgb) {}
+
+    const VideoFrame* frame;
+    uint32 to_fourcc;
+    uint8* buffer;
+    size_t size;
+    int stride_rgb;
+  };
+
+  WebRtcVideoFrameConverter();
+  ~WebRtcVideoFrameConverter();
+
+  // Same as VideoFrame::ConvertToRgbBuffer().
+  size_t ConvertToRgbBuffer(const VideoFrame& frame, uint32 to_fourcc,
+                            uint8* buffer, size_t size, int stride_rgb) const;
+
+  // Converts all |conversions| in one go, which keeps the threads busy when
+  // the frames are small. Returns false if any of them failed, for instance
+  // because a buffer is too small; the others are still written.
+  bool ConvertToRgbBuffers(const std::vector<RgbConversion>& conversions) const;
+
+  // Converts the RGB image of type |from_fourcc| in |buffer| to |frame|, which
+  // must already have the size of the image. Returns false on failure.
+  bool ConvertFromRgbBuffer(uint32 from_fourcc, const uint8* buffer,
+                            size_t size, VideoFrame* frame) const;
+
+  // Same as VideoFrame::CopyToPlanes().
+  bool CopyToPlanes(const VideoFrame& frame,
+                    uint8* dst_y, uint8* dst_u, uint8* dst_v,
+                    int32 dst_pitch_y, int32 dst_pitch_u,
+                    int32 dst_pitch_v) const;
+
+  // Same as VideoFrame::StretchToFrame(). Frames which are cropped to the
+  // aspect ratio of |dst|, or whose rotation differs from that of |dst|, are
+  // stretched on the calling thread.
+  void StretchToFrame(const VideoFrame& frame, VideoFrame* dst,
+                      bool interpolate, bool vert_crop) const;
+
+ private:
+  webrtc::WorkerPool* const scaler_thread_pool_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebRtcVideoFrameConverter);
+};
+
+}  // namespace cricket
+
+#endif  // TALK_MEDIA_WEBRTC_WEBRTCVIDEOFRAMECONVERTER_H_
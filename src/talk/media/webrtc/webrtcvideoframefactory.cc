@@ -25,12 +25,25 @@
  * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+
+#include "talk/media/base/videocapturer.h"
 #include "talk/media/webrtc/webrtcvideoframe.h"
 #include "talk/media/webrtc/webrtcvideoframefactory.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/common_video/libyuv/include/scaler.h"
+#include "webrtc/system_wrappers/interface/worker_pool.h"
 
 namespace cricket {
 
+WebRtcVideoFrameFactory::WebRtcVideoFrameFactory()
+    : scaler_thread_pool_(webrtc::WorkerPool::GetSharedPool()) {
+}
+
+WebRtcVideoFrameFactory::~WebRtcVideoFrameFactory() {
+  webrtc::WorkerPool::ReturnSharedPool();
+}
+
 VideoFrame* WebRtcVideoFrameFactory::CreateAliasedFrame(
     const CapturedFrame* aliased_frame, int width, int height) const {
   rtc::scoped_ptr<WebRtcVideoFrame> frame(new WebRtcVideoFrame());
@@ -42,4 +55,64 @@ VideoFrame* WebRtcVideoFrameFactory::CreateAliasedFrame(
   return frame.release();
 }
 
+VideoFrame* WebRtcVideoFrameFactory::CreateAliasedFrame(
+    const CapturedFrame* input_frame,
+    int cropped_input_width,
+    int cropped_input_height,
+    int output_width,
+    int output_height) const {
+  // Frames which need to be cropped to the output aspect ratio take the
+  // generic path.
+  if (static_cast<int64_t>(cropped_input_width) * output_height !=
+      static_cast<int64_t>(cropped_input_height) * output_width) {
+    return VideoFrameFactory::CreateAliasedFrame(
+        input_frame, cropped_input_width, cropped_input_height, output_width,
+        output_height);
+  }
+
+  rtc::scoped_ptr<VideoFrame> cropped_input_frame(CreateAliasedFrame(
+      input_frame, cropped_input_width, cropped_input_height));
+  if (!cropped_input_frame)
+    return nullptr;
+
+  if (cropped_input_width == output_width &&
+      cropped_input_height == output_height) {
+    // No scaling needed.
+    return cropped_input_frame.release();
+  }
+
+  // If the frame is rotated, we need to switch the width and height.
+  if (apply_rotation_ &&
+      (input_frame->GetRotation() == webrtc::kVideoRotation_90 ||
+       input_frame->GetRotation() == webrtc::kVideoRotation_270)) {
+    std::swap(output_width, output_height);
+  }
+
+  // The input may share its buffer with the captured frame, so it is only
+  // read through const accessors.
+  const VideoFrame& input = *cropped_input_frame;
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer =
+      buffer_pool_.CreateBuffer(output_width, output_height);
+  if (webrtc::ScaleI420(scaler_thread_pool_,
+                        input.GetYPlane(), input.GetYPitch(),
+                        input.GetUPlane(), input.GetUPitch(),
+                        input.GetVPlane(), input.GetVPitch(),
+                        static_cast<int>(input.GetWidth()),
+                        static_cast<int>(input.GetHeight()),
+                        buffer->data(webrtc::kYPlane),
+                        buffer->stride(webrtc::kYPlane),
+                        buffer->data(webrtc::kUPlane),
+                        buffer->stride(webrtc::kUPlane),
+                        buffer->data(webrtc::kVPlane),
+                        buffer->stride(webrtc::kVPlane),
+                        output_width, output_height,
+                        webrtc::kScaleBox) != 0) {
+    LOG(LS_WARNING) << "Failed to scale frame to " << output_width << "x"
+                    << output_height;
+    return NULL;
+  }
+  return new WebRtcVideoFrame(buffer, input.GetElapsedTime(),
+                              input.GetTimeStamp(), input.GetVideoRotation());
+}
+
 }  // namespace cricket
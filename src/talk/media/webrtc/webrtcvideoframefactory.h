@@ -29,6 +29,11 @@
 #define TALK_MEDIA_WEBRTC_WEBRTCVIDEOFRAMEFACTORY_H_
 
 #include "talk/media/base/videoframefactory.h"
+#include "webrtc/common_video/interface/i420_buffer_pool.h"
+
+namespace webrtc {
+class WorkerPool;
+}  // namespace webrtc
 
 namespace cricket {
 
@@ -37,9 +42,24 @@ struct CapturedFrame;
 // Creates instances of cricket::WebRtcVideoFrame.
 class WebRtcVideoFrameFactory : public VideoFrameFactory {
  public:
+  WebRtcVideoFrameFactory();
+  ~WebRtcVideoFrameFactory() override;
+
   VideoFrame* CreateAliasedFrame(const CapturedFrame* aliased_frame,
                                  int width,
                                  int height) const override;
+
+  // Scales on the shared scaler threads into pooled buffers, so frames in
+  // flight to the encoder don't force a new allocation per frame.
+  VideoFrame* CreateAliasedFrame(const CapturedFrame* input_frame,
+                                 int cropped_input_width,
+                                 int cropped_input_height,
+                                 int output_width,
+                                 int output_height) const override;
+
+ private:
+  webrtc::WorkerPool* const scaler_thread_pool_;
+  mutable webrtc::I420BufferPool buffer_pool_;
 };
 
 }  // namespace cricket
@@ -108,8 +108,43 @@ class WebRtcVideoFrameFactoryTest
                 new_height / 2, apply_rotation);
   }
 
+  // Scales a frame with gradients about as the generic path in
+  // cricket::VideoFrameFactory does. The filters differ slightly, so only
+  // smooth content gives the same result.
+  void TestScaleMatchesGenericPath() {
+    InitFrame(webrtc::kVideoRotation_0);
+    const int width = captured_frame_.width;
+    const int height = captured_frame_.height;
+    uint8* y_plane = captured_frame_buffer_.get();
+    uint8* u_plane = y_plane + width * height;
+    uint8* v_plane = u_plane + (width / 2) * (height / 2);
+    FillGradient(y_plane, width, height);
+    FillGradient(u_plane, width / 2, height / 2);
+    FillGradient(v_plane, width / 2, height / 2);
+    const int new_width = captured_frame_.width / 3;
+    const int new_height = captured_frame_.height / 3;
+    rtc::scoped_ptr<cricket::VideoFrame> frame(factory_.CreateAliasedFrame(
+        &captured_frame_, captured_frame_.width, captured_frame_.height,
+        new_width, new_height));
+    rtc::scoped_ptr<cricket::VideoFrame> reference(
+        factory_.VideoFrameFactory::CreateAliasedFrame(
+            &captured_frame_, captured_frame_.width, captured_frame_.height,
+            new_width, new_height));
+    ASSERT_TRUE(frame.get() != NULL);
+    ASSERT_TRUE(reference.get() != NULL);
+    EXPECT_TRUE(IsEqual(*reference, *frame, 1));
+  }
+
   const cricket::CapturedFrame& get_captured_frame() { return captured_frame_; }
 
+  static void FillGradient(uint8* plane, int width, int height) {
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x)
+        plane[y * width + x] = static_cast<uint8>(255 * (x + y) /
+                                                  (width + height));
+    }
+  }
+
  private:
   cricket::CapturedFrame captured_frame_;
   rtc::scoped_ptr<uint8[]> captured_frame_buffer_;
@@ -123,3 +158,7 @@ TEST_F(WebRtcVideoFrameFactoryTest, NoApplyRotation) {
 TEST_F(WebRtcVideoFrameFactoryTest, ApplyRotation) {
   TestCreateAliasedFrame(true);
 }
+
+TEST_F(WebRtcVideoFrameFactoryTest, ScaleMatchesGenericPath) {
+  TestScaleMatchesGenericPath();
+}
@@ -220,6 +220,23 @@ TEST(AtomicOpsTest, Simple) {
   EXPECT_EQ(0, value);
 }
 
+TEST(AtomicOpsTest, SimplePtr) {
+  int a = 0;
+  int b = 0;
+  int* volatile ptr = NULL;
+  EXPECT_TRUE(AtomicOps::AcquireLoadPtr(&ptr) == NULL);
+  // Swapping in |a| works when the old value matches.
+  EXPECT_TRUE(AtomicOps::CompareAndSwapPtr(&ptr, static_cast<int*>(NULL),
+                                           &a) == NULL);
+  EXPECT_EQ(&a, AtomicOps::AcquireLoadPtr(&ptr));
+  // It fails, and returns the current value, when the old value doesn't.
+  EXPECT_EQ(&a, AtomicOps::CompareAndSwapPtr(&ptr, static_cast<int*>(NULL),
+                                             &b));
+  EXPECT_EQ(&a, AtomicOps::AcquireLoadPtr(&ptr));
+  EXPECT_EQ(&a, AtomicOps::CompareAndSwapPtr(&ptr, &a, &b));
+  EXPECT_EQ(&b, AtomicOps::AcquireLoadPtr(&ptr));
+}
+
 TEST(AtomicOpsTest, Increment) {
   // Create and start lots of threads.
   AtomicOpRunner<IncrementOp, UniqueValueVerifier> runner(0);
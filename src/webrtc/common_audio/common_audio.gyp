@@ -134,7 +134,10 @@
           ],
         }],
         ['target_arch=="ia32" or target_arch=="x64"', {
-          'dependencies': ['common_audio_sse2',],
+          'dependencies': [
+            'common_audio_avx2',
+            'common_audio_sse2',
+          ],
         }],
         ['target_arch=="arm"', {
           'sources': [
@@ -200,6 +203,8 @@
           'sources': [
             'fir_filter_sse.cc',
             'resampler/sinc_resampler_sse.cc',
+            'signal_processing/cross_correlation_sse2.c',
+            'signal_processing/downsample_fast_sse2.c',
           ],
           'conditions': [
             ['os_posix==1', {
@@ -210,6 +215,22 @@
             }],
           ],
         },
+        {
+          # Only called on CPUs which support AVX2.
+          'target_name': 'common_audio_avx2',
+          'type': 'static_library',
+          'sources': [
+            'signal_processing/cross_correlation_avx2.c',
+          ],
+          'conditions': [
+            ['os_posix==1', {
+              'cflags': [ '-mavx2', ],
+              'xcode_settings': {
+                'OTHER_CFLAGS': [ '-mavx2', ],
+              },
+            }],
+          ],
+        },
       ],  # targets
     }],
     ['target_arch=="arm" and arm_version>=7 or target_arch=="arm64"', {
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <immintrin.h>
+
+/* Same as the SSE2 version, 16 products at a time. */
+static int32_t DotProductWithScaleAVX2(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       int length,
+                                       __m128i scaling) {
+  __m256i sum = _mm256_setzero_si256();
+  __m128i sum128;
+  int32_t sums[4];
+  int32_t sum_res = 0;
+  int i = 0;
+
+  for (; i < length - 15; i += 16) {
+    __m256i seq1 = _mm256_loadu_si256((const __m256i*)&vector1[i]);
+    __m256i seq2 = _mm256_loadu_si256((const __m256i*)&vector2[i]);
+    __m256i low = _mm256_mullo_epi16(seq1, seq2);
+    __m256i high = _mm256_mulhi_epi16(seq1, seq2);
+    /* The unpacks work within each 128-bit lane, which doesn't matter since
+     * all products are summed. */
+    __m256i products0 =
+        _mm256_sra_epi32(_mm256_unpacklo_epi16(low, high), scaling);
+    __m256i products1 =
+        _mm256_sra_epi32(_mm256_unpackhi_epi16(low, high), scaling);
+    sum = _mm256_add_epi32(sum, _mm256_add_epi32(products0, products1));
+  }
+  sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                         _mm256_extracti128_si256(sum, 1));
+  _mm_storeu_si128((__m128i*)sums, sum128);
+  sum_res = sums[0] + sums[1] + sums[2] + sums[3];
+  for (; i < length; i++) {
+    sum_res += (vector1[i] * vector2[i]) >> _mm_cvtsi128_si32(scaling);
+  }
+  return sum_res;
+}
+
+/* AVX2 version of WebRtcSpl_CrossCorrelation() for x86 platforms. Bit-exact
+ * with WebRtcSpl_CrossCorrelationC(). */
+void WebRtcSpl_CrossCorrelationAVX2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    int16_t dim_seq,
+                                    int16_t dim_cross_correlation,
+                                    int16_t right_shifts,
+                                    int16_t step_seq2) {
+  const __m128i scaling = _mm_cvtsi32_si128(right_shifts);
+  int i = 0;
+
+  for (i = 0; i < dim_cross_correlation; i++) {
+    *cross_correlation++ = DotProductWithScaleAVX2(
+        seq1, seq2 + step_seq2 * i, dim_seq, scaling);
+  }
+  _mm256_zeroupper();
+}
@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <emmintrin.h>
+
+/* Returns the sum of the products of |vector1| and |vector2|, each shifted
+ * right by |scaling| before it is added, like the C version does. The
+ * products are formed in 32 bits from the low and high halves of the 16-bit
+ * multiplications so that each one can be shifted on its own. */
+static int32_t DotProductWithScaleSSE2(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       int length,
+                                       __m128i scaling) {
+  __m128i sum = _mm_setzero_si128();
+  int32_t sums[4];
+  int32_t sum_res = 0;
+  int i = 0;
+
+  for (; i < length - 7; i += 8) {
+    __m128i seq1 = _mm_loadu_si128((const __m128i*)&vector1[i]);
+    __m128i seq2 = _mm_loadu_si128((const __m128i*)&vector2[i]);
+    __m128i low = _mm_mullo_epi16(seq1, seq2);
+    __m128i high = _mm_mulhi_epi16(seq1, seq2);
+    __m128i products0 = _mm_sra_epi32(_mm_unpacklo_epi16(low, high), scaling);
+    __m128i products1 = _mm_sra_epi32(_mm_unpackhi_epi16(low, high), scaling);
+    sum = _mm_add_epi32(sum, _mm_add_epi32(products0, products1));
+  }
+  _mm_storeu_si128((__m128i*)sums, sum);
+  sum_res = sums[0] + sums[1] + sums[2] + sums[3];
+  for (; i < length; i++) {
+    sum_res += (vector1[i] * vector2[i]) >> _mm_cvtsi128_si32(scaling);
+  }
+  return sum_res;
+}
+
+/* SSE2 version of WebRtcSpl_CrossCorrelation() for x86 platforms. Bit-exact
+ * with WebRtcSpl_CrossCorrelationC(). */
+void WebRtcSpl_CrossCorrelationSSE2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    int16_t dim_seq,
+                                    int16_t dim_cross_correlation,
+                                    int16_t right_shifts,
+                                    int16_t step_seq2) {
+  const __m128i scaling = _mm_cvtsi32_si128(right_shifts);
+  int i = 0;
+
+  for (i = 0; i < dim_cross_correlation; i++) {
+    *cross_correlation++ = DotProductWithScaleSSE2(
+        seq1, seq2 + step_seq2 * i, dim_seq, scaling);
+  }
+}
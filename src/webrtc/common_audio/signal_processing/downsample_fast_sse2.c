@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <emmintrin.h>
+
+/* Longest filter which is kept in registers; longer ones use the C version.
+ * NetEq uses at most 7 coefficients. */
+enum { kMaxCoefficients = 16 };
+
+/* SSE2 version of WebRtcSpl_DownsampleFast() for x86 platforms. Each output
+ * sample is one dot product of the reversed filter, zero-padded to 8 or 16
+ * taps, with the input samples it covers, 8 multiply-adds at a time. The
+ * 32-bit sums wrap the same way as in the C version, so the output is
+ * bit-exact. */
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 int data_in_length,
+                                 int16_t* data_out,
+                                 int data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 int coefficients_length,
+                                 int factor,
+                                 int delay) {
+  int16_t reversed[kMaxCoefficients];
+  __m128i taps0;
+  __m128i taps1;
+  int num_taps = coefficients_length <= 8 ? 8 : kMaxCoefficients;
+  int i = 0;
+  int j = 0;
+  int32_t out_s32 = 0;
+  int endpos = delay + factor * (data_out_length - 1) + 1;
+  /* The padded taps read |num_taps - coefficients_length| samples past the
+   * ones the filter covers, which must be within |data_in|. */
+  int vector_endpos = data_in_length - num_taps + coefficients_length;
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length <= 0 || coefficients_length <= 0
+                           || data_in_length < endpos) {
+    return -1;
+  }
+  if (coefficients_length > kMaxCoefficients) {
+    return WebRtcSpl_DownsampleFastC(data_in, data_in_length, data_out,
+                                     data_out_length, coefficients,
+                                     coefficients_length, factor, delay);
+  }
+
+  /* Output sample i is the sum of coefficients[j] * data_in[i - j], which is
+   * the dot product of |reversed| with the samples from
+   * i - coefficients_length + 1 on. */
+  for (j = 0; j < kMaxCoefficients; j++) {
+    reversed[j] = 0;
+  }
+  for (j = 0; j < coefficients_length; j++) {
+    reversed[coefficients_length - 1 - j] = coefficients[j];
+  }
+  taps0 = _mm_loadu_si128((const __m128i*)&reversed[0]);
+  taps1 = _mm_loadu_si128((const __m128i*)&reversed[8]);
+
+  for (i = delay; i < endpos; i += factor) {
+    if (i < vector_endpos) {
+      const int16_t* window = &data_in[i - coefficients_length + 1];
+      __m128i sum =
+          _mm_madd_epi16(_mm_loadu_si128((const __m128i*)&window[0]), taps0);
+      if (num_taps > 8) {
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(
+            _mm_loadu_si128((const __m128i*)&window[8]), taps1));
+      }
+      sum = _mm_add_epi32(sum,
+                          _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+      sum = _mm_add_epi32(sum,
+                          _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+      out_s32 = 2048 + _mm_cvtsi128_si32(sum);  // Round value, 0.5 in Q12.
+    } else {
+      out_s32 = 2048;  // Round value, 0.5 in Q12.
+      for (j = 0; j < coefficients_length; j++) {
+        out_s32 += coefficients[j] * data_in[i - j];  // Q12.
+      }
+    }
+
+    out_s32 >>= 12;  // Q0.
+
+    // Saturate and store the output.
+    *data_out++ = WebRtcSpl_SatW32ToW16(out_s32);
+  }
+
+  return 0;
+}
@@ -8,8 +8,11 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string.h>
+
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 
 static const int kVector16Size = 9;
 static const int16_t vector16[kVector16Size] = {1, -15511, 4323, 1963,
@@ -477,10 +480,11 @@ TEST_F(SplTest, CrossCorrelationTest) {
   const int32_t kExpected[kCrossCorrelationDimension] =
       {-266947903, -15579555, -171282001};
   const int32_t* expected = kExpected;
-#if !defined(MIPS32_LE)
+#if (defined WEBRTC_DETECT_ARM_NEON) || (defined WEBRTC_ARCH_ARM_NEON) || \
+  (defined WEBRTC_ARCH_ARM64_NEON)
   const int32_t kExpectedNeon[kCrossCorrelationDimension] =
       {-266947901, -15579553, -171281999};
-  if (WebRtcSpl_CrossCorrelation != WebRtcSpl_CrossCorrelationC) {
+  if (WebRtcSpl_CrossCorrelation == WebRtcSpl_CrossCorrelationNeon) {
     expected = kExpectedNeon;
   }
 #endif
@@ -489,6 +493,77 @@ TEST_F(SplTest, CrossCorrelationTest) {
   }
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// The SSE2 and AVX2 versions must be bit-exact with the C versions, including
+// when the products and sums wrap around.
+TEST_F(SplTest, X86BitExactTest) {
+  const int kLength = 1000;
+  int16_t seq[kLength];
+  uint32_t seed = 1;
+  for (int i = 0; i < kLength; ++i) {
+    // Alternate full scale and small values.
+    seq[i] = static_cast<int16_t>(WebRtcSpl_RandU(&seed) * 2 -
+                                  (i % 100 < 50 ? 32768 : 0));
+  }
+  seq[10] = WEBRTC_SPL_WORD16_MIN;
+  seq[11] = WEBRTC_SPL_WORD16_MIN;
+
+  const int kMaxCorrelations = 50;
+  const int kSeqDimensions[] = {0, 1, 7, 8, 15, 16, 17, 33, 240};
+  for (int dim_seq : kSeqDimensions) {
+    for (int right_shifts = 0; right_shifts < 16; right_shifts += 5) {
+      for (int step = -1; step <= 1; ++step) {
+        int32_t expected[kMaxCorrelations];
+        int32_t sse2[kMaxCorrelations];
+        int32_t avx2[kMaxCorrelations];
+        const int16_t* seq2 = &seq[kLength / 2];
+        WebRtcSpl_CrossCorrelationC(expected, seq, seq2, dim_seq,
+                                    kMaxCorrelations, right_shifts, step);
+        WebRtcSpl_CrossCorrelationSSE2(sse2, seq, seq2, dim_seq,
+                                       kMaxCorrelations, right_shifts, step);
+        if (WebRtc_GetCPUInfo(kAVX2) != 0) {
+          WebRtcSpl_CrossCorrelationAVX2(avx2, seq, seq2, dim_seq,
+                                         kMaxCorrelations, right_shifts, step);
+        } else {
+          memcpy(avx2, expected, sizeof(avx2));
+        }
+        for (int i = 0; i < kMaxCorrelations; ++i) {
+          EXPECT_EQ(expected[i], sse2[i]);
+          EXPECT_EQ(expected[i], avx2[i]);
+        }
+      }
+    }
+  }
+
+  const int16_t kCoefficients[] = {1234, -4321, 32767, -32768, 2048, 77, -9,
+                                   4000, -100, 3, 5000, -6000, 7000, 12, 13,
+                                   -14, 15};
+  const int kMaxOutputs = 100;
+  for (int num_coefficients = 1; num_coefficients <= 17; ++num_coefficients) {
+    for (int factor = 1; factor <= 12; factor += 3) {
+      for (int delay = 0; delay <= num_coefficients + 1; delay += 2) {
+        int16_t expected[kMaxOutputs];
+        int16_t sse2[kMaxOutputs];
+        // Ends the input right at the last output sample, so the vector
+        // version must not read beyond it.
+        const int length = delay + factor * (kMaxOutputs - 1) + 1;
+        const int16_t* data_in = &seq[20];
+        EXPECT_EQ(0, WebRtcSpl_DownsampleFastC(data_in, length, expected,
+                                               kMaxOutputs, kCoefficients,
+                                               num_coefficients, factor,
+                                               delay));
+        EXPECT_EQ(0, WebRtcSpl_DownsampleFastSSE2(data_in, length, sse2,
+                                                  kMaxOutputs, kCoefficients,
+                                                  num_coefficients, factor,
+                                                  delay));
+        for (int i = 0; i < kMaxOutputs; ++i)
+          EXPECT_EQ(expected[i], sse2[i]);
+      }
+    }
+  }
+}
+#endif
+
 TEST_F(SplTest, AutoCorrelationTest) {
   int scale = 0;
   int32_t vector32[kVector16Size];
@@ -9,7 +9,7 @@
  */
 
 /* The global function contained in this file initializes SPL function
- * pointers, currently only for ARM platforms.
+ * pointers, for ARM, MIPS and x86 platforms.
  *
  * Some code came from common/rtcd.c in the WebM project.
  */
@@ -64,6 +64,20 @@ static void InitPointersToNeon() {
 }
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+/* Replace the C versions with SSE2 and AVX2 ones the CPU supports. They are
+ * bit-exact with the C versions. */
+static void InitPointersToX86() {
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationSSE2;
+    WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastSSE2;
+  }
+  if (WebRtc_GetCPUInfo(kAVX2) != 0) {
+    WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationAVX2;
+  }
+}
+#endif
+
 #if defined(MIPS32_LE)
 /* Initialize function pointers to the MIPS version. */
 static void InitPointersToMIPS() {
@@ -99,6 +113,9 @@ static void InitFunctionPointers(void) {
   InitPointersToMIPS();
 #else
   InitPointersToC();
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  InitPointersToX86();
+#endif
 #endif  /* WEBRTC_DETECT_ARM_NEON */
 }
 
@@ -53,13 +53,13 @@ I420BufferPool::I420BufferPool() {
 }
 
 void I420BufferPool::Release() {
-  thread_checker_.DetachFromThread();
+  rtc::CritScope cs(&crit_);
   buffers_.clear();
 }
 
 rtc::scoped_refptr<VideoFrameBuffer> I420BufferPool::CreateBuffer(int width,
                                                                   int height) {
-  DCHECK(thread_checker_.CalledOnValidThread());
+  rtc::CritScope cs(&crit_);
   // Release buffers with wrong resolution.
   for (auto it = buffers_.begin(); it != buffers_.end();) {
     if ((*it)->width() != width || (*it)->height() != height)
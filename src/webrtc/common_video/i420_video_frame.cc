@@ -19,6 +19,30 @@
 
 namespace webrtc {
 
+// Regions made of more rectangles than this become unknown when merged, so
+// that a long run of dropped frames doesn't grow them without bound.
+static const size_t kMaxUpdatedRects = 256;
+
+void UpdatedRegion::Union(const UpdatedRegion& other) {
+  if (!known_)
+    return;
+  if (!other.known_ || rects_.size() + other.rects_.size() > kMaxUpdatedRects) {
+    known_ = false;
+    rects_.clear();
+    return;
+  }
+  rects_.insert(rects_.end(), other.rects_.begin(), other.rects_.end());
+}
+
+bool UpdatedRegion::MergeDropped(UpdatedRegion* dropped) {
+  if (dropped->IsEmpty())
+    return false;
+  Union(*dropped);
+  dropped->known_ = true;
+  dropped->rects_.clear();
+  return true;
+}
+
 I420VideoFrame::I420VideoFrame() {
   // Intentionally using Reset instead of initializer list so that any missed
   // fields in Reset will be caught by memory checkers.
@@ -67,6 +91,7 @@ int I420VideoFrame::CreateEmptyFrame(int width, int height,
   ntp_time_ms_ = 0;
   render_time_ms_ = 0;
   rotation_ = kVideoRotation_0;
+  updated_region_ = UpdatedRegion();
 
   // Check if it's safe to reuse allocation.
   if (video_frame_buffer_ &&
@@ -149,6 +174,7 @@ int I420VideoFrame::CopyFrame(const I420VideoFrame& videoFrame) {
   ntp_time_ms_ = videoFrame.ntp_time_ms_;
   render_time_ms_ = videoFrame.render_time_ms_;
   rotation_ = videoFrame.rotation_;
+  updated_region_ = videoFrame.updated_region_;
   return 0;
 }
 
@@ -158,6 +184,7 @@ void I420VideoFrame::ShallowCopy(const I420VideoFrame& videoFrame) {
   ntp_time_ms_ = videoFrame.ntp_time_ms_;
   render_time_ms_ = videoFrame.render_time_ms_;
   rotation_ = videoFrame.rotation_;
+  updated_region_ = videoFrame.updated_region_;
 }
 
 void I420VideoFrame::Reset() {
@@ -166,6 +193,7 @@ void I420VideoFrame::Reset() {
   ntp_time_ms_ = 0;
   render_time_ms_ = 0;
   rotation_ = kVideoRotation_0;
+  updated_region_ = UpdatedRegion();
 }
 
 uint8_t* I420VideoFrame::buffer(PlaneType type) {
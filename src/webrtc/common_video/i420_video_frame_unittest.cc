@@ -199,6 +199,54 @@ TEST(TestI420VideoFrame, Reset) {
   EXPECT_TRUE(frame.video_frame_buffer() == NULL);
 }
 
+TEST(TestI420VideoFrame, UpdatedRegion) {
+  I420VideoFrame frame;
+  ASSERT_EQ(0, frame.CreateEmptyFrame(32, 32, 32, 16, 16));
+  EXPECT_FALSE(frame.updated_region().known());
+
+  const UpdatedRegion::Rect kRect1 = {0, 0, 16, 16};
+  const UpdatedRegion::Rect kRect2 = {16, 8, 8, 8};
+  frame.set_updated_region(
+      UpdatedRegion(std::vector<UpdatedRegion::Rect>(1, kRect1)));
+  I420VideoFrame shallow_copy;
+  shallow_copy.ShallowCopy(frame);
+  I420VideoFrame deep_copy;
+  deep_copy.CopyFrame(frame);
+  EXPECT_TRUE(shallow_copy.updated_region().known());
+  EXPECT_EQ(1u, shallow_copy.updated_region().rects().size());
+  EXPECT_TRUE(deep_copy.updated_region().known());
+  EXPECT_EQ(1u, deep_copy.updated_region().rects().size());
+
+  // Merging regions collects their rectangles, an unknown one wins.
+  UpdatedRegion region(std::vector<UpdatedRegion::Rect>(1, kRect2));
+  region.Union(frame.updated_region());
+  ASSERT_EQ(2u, region.rects().size());
+  EXPECT_EQ(kRect1.x, region.rects()[1].x);
+  region.Union(UpdatedRegion(std::vector<UpdatedRegion::Rect>()));
+  EXPECT_EQ(2u, region.rects().size());
+  region.Union(UpdatedRegion());
+  EXPECT_FALSE(region.known());
+  EXPECT_TRUE(region.rects().empty());
+
+  // Merging the dropped region empties it, and does nothing if it's empty.
+  UpdatedRegion dropped(std::vector<UpdatedRegion::Rect>(1, kRect2));
+  region = frame.updated_region();
+  EXPECT_TRUE(region.MergeDropped(&dropped));
+  EXPECT_EQ(2u, region.rects().size());
+  EXPECT_TRUE(dropped.IsEmpty());
+  EXPECT_FALSE(region.MergeDropped(&dropped));
+  EXPECT_EQ(2u, region.rects().size());
+  dropped.Union(UpdatedRegion());
+  EXPECT_TRUE(region.MergeDropped(&dropped));
+  EXPECT_FALSE(region.known());
+  EXPECT_TRUE(dropped.IsEmpty());
+
+  frame.Reset();
+  EXPECT_FALSE(frame.updated_region().known());
+  ASSERT_EQ(0, deep_copy.CreateEmptyFrame(32, 32, 32, 16, 16));
+  EXPECT_FALSE(deep_copy.updated_region().known());
+}
+
 TEST(TestI420VideoFrame, CopyBuffer) {
   I420VideoFrame frame1, frame2;
   int width = 15;
@@ -24,20 +24,19 @@
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/common_video/video_render_frames.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
-#include "webrtc/system_wrappers/interface/event_wrapper.h"
-#include "webrtc/system_wrappers/interface/thread_wrapper.h"
 #include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 
 namespace webrtc {
 
-IncomingVideoStream::IncomingVideoStream(uint32_t stream_id)
+IncomingVideoStream::IncomingVideoStream(uint32_t stream_id,
+                                         bool disable_prerenderer_smoothing)
     : stream_id_(stream_id),
+      disable_prerenderer_smoothing_(disable_prerenderer_smoothing),
       stream_critsect_(CriticalSectionWrapper::CreateCriticalSection()),
       thread_critsect_(CriticalSectionWrapper::CreateCriticalSection()),
       buffer_critsect_(CriticalSectionWrapper::CreateCriticalSection()),
-      incoming_render_thread_(),
-      deliver_buffer_event_(EventTimerWrapper::Create()),
+      scheduler_(NULL),
       running_(false),
       external_callback_(nullptr),
       render_callback_(nullptr),
@@ -80,31 +79,60 @@ int32_t IncomingVideoStream::RenderFrame(const uint32_t stream_id,
     last_rate_calculation_time_ms_ = now_ms;
   }
 
+  if (disable_prerenderer_smoothing_) {
+    CriticalSectionScoped csT(thread_critsect_.get());
+    DeliverFrame(video_frame);
+    return 0;
+  }
+
   // Insert frame.
-  CriticalSectionScoped csB(buffer_critsect_.get());
-  if (render_buffers_->AddFrame(video_frame) == 1)
-    deliver_buffer_event_->Set();
+  int64_t release_time_ms;
+  {
+    CriticalSectionScoped csB(buffer_critsect_.get());
+    if (render_buffers_->AddFrame(video_frame) != 1) {
+      // Already scheduled for the frames queued before this one.
+      return 0;
+    }
+    release_time_ms = now_ms + render_buffers_->TimeToNextFrameRelease();
+  }
+  scheduler_->Schedule(this, release_time_ms);
 
   return 0;
 }
 
 int32_t IncomingVideoStream::SetStartImage(
     const I420VideoFrame& video_frame) {
-  CriticalSectionScoped csS(thread_critsect_.get());
-  return start_image_.CopyFrame(video_frame);
+  CriticalSectionScoped csS(stream_critsect_.get());
+  int32_t ret;
+  {
+    CriticalSectionScoped csT(thread_critsect_.get());
+    ret = start_image_.CopyFrame(video_frame);
+  }
+  ScheduleNow();
+  return ret;
 }
 
 int32_t IncomingVideoStream::SetTimeoutImage(
     const I420VideoFrame& video_frame, const uint32_t timeout) {
-  CriticalSectionScoped csS(thread_critsect_.get());
-  timeout_time_ = timeout;
-  return timeout_image_.CopyFrame(video_frame);
+  CriticalSectionScoped csS(stream_critsect_.get());
+  int32_t ret;
+  {
+    CriticalSectionScoped csT(thread_critsect_.get());
+    timeout_time_ = timeout;
+    ret = timeout_image_.CopyFrame(video_frame);
+  }
+  ScheduleNow();
+  return ret;
 }
 
 void IncomingVideoStream::SetRenderCallback(
     VideoRenderCallback* render_callback) {
-  CriticalSectionScoped cs(thread_critsect_.get());
-  render_callback_ = render_callback;
+  CriticalSectionScoped csS(stream_critsect_.get());
+  {
+    CriticalSectionScoped csT(thread_critsect_.get());
+    render_callback_ = render_callback;
+  }
+  ScheduleNow();
 }
 
 int32_t IncomingVideoStream::SetExpectedRenderDelay(
@@ -129,21 +157,16 @@ int32_t IncomingVideoStream::Start() {
     return 0;
   }
 
-  CriticalSectionScoped csT(thread_critsect_.get());
-  assert(incoming_render_thread_ == NULL);
-
-  incoming_render_thread_ = ThreadWrapper::CreateThread(
-      IncomingVideoStreamThreadFun, this, "IncomingVideoStreamThread");
-  if (!incoming_render_thread_) {
-    return -1;
-  }
-
-  if (incoming_render_thread_->Start()) {
-  } else {
-    return -1;
+  assert(scheduler_ == NULL);
+  if (!disable_prerenderer_smoothing_) {
+    scheduler_ = VideoRenderScheduler::GetScheduler();
+    if (!scheduler_) {
+      VideoRenderScheduler::ReturnScheduler();
+      return -1;
+    }
+    scheduler_->Schedule(
+        this, TickTime::MillisecondTimestamp() + kEventStartupTimeMs);
   }
-  incoming_render_thread_->SetPriority(kRealtimePriority);
-  deliver_buffer_event_->StartTimer(false, kEventStartupTimeMs);
 
   running_ = true;
   return 0;
@@ -156,25 +179,11 @@ int32_t IncomingVideoStream::Stop() {
     return 0;
   }
 
-  ThreadWrapper* thread = NULL;
-  {
-    CriticalSectionScoped cs_thread(thread_critsect_.get());
-    if (incoming_render_thread_) {
-      // Setting the incoming render thread to NULL marks that we're performing
-      // a shutdown and will make IncomingVideoStreamProcess abort after wakeup.
-      thread = incoming_render_thread_.release();
-      deliver_buffer_event_->StopTimer();
-      // Set the event to allow the thread to wake up and shut down without
-      // waiting for a timeout.
-      deliver_buffer_event_->Set();
-    }
-  }
-  if (thread) {
-    if (thread->Stop()) {
-      delete thread;
-    } else {
-      assert(false);
-    }
+  if (scheduler_) {
+    // Waits for frames being rendered.
+    scheduler_->Unschedule(this);
+    scheduler_ = NULL;
+    VideoRenderScheduler::ReturnScheduler();
   }
   running_ = false;
   return 0;
@@ -195,63 +204,60 @@ uint32_t IncomingVideoStream::IncomingRate() const {
   return incoming_rate_;
 }
 
-bool IncomingVideoStream::IncomingVideoStreamThreadFun(void* obj) {
-  return static_cast<IncomingVideoStream*>(obj)->IncomingVideoStreamProcess();
-}
-
-bool IncomingVideoStream::IncomingVideoStreamProcess() {
-  if (kEventError != deliver_buffer_event_->Wait(kEventMaxWaitTimeMs)) {
-    CriticalSectionScoped cs(thread_critsect_.get());
-    if (incoming_render_thread_ == NULL) {
-      // Terminating
-      return false;
-    }
-    // Get a new frame to render and the time for the frame after this one.
-    I420VideoFrame frame_to_render;
-    uint32_t wait_time;
-    {
-      CriticalSectionScoped cs(buffer_critsect_.get());
-      frame_to_render = render_buffers_->FrameToRender();
-      wait_time = render_buffers_->TimeToNextFrameRelease();
-    }
+int64_t IncomingVideoStream::RenderPendingFrames(int64_t now_ms) {
+  CriticalSectionScoped cs(thread_critsect_.get());
+  // Get a new frame to render and the time for the frame after this one.
+  I420VideoFrame frame_to_render;
+  bool frames_pending;
+  uint32_t wait_time;
+  {
+    CriticalSectionScoped cs(buffer_critsect_.get());
+    frame_to_render = render_buffers_->FrameToRender();
+    frames_pending = !render_buffers_->Empty();
+    wait_time = render_buffers_->TimeToNextFrameRelease();
+  }
 
-    // Set timer for next frame to render.
-    if (wait_time > kEventMaxWaitTimeMs) {
-      wait_time = kEventMaxWaitTimeMs;
-    }
-    deliver_buffer_event_->StartTimer(false, wait_time);
-
-    if (frame_to_render.IsZeroSize()) {
-      if (render_callback_) {
-        if (last_render_time_ms_ == 0 && !start_image_.IsZeroSize()) {
-          // We have not rendered anything and have a start image.
-          temp_frame_.CopyFrame(start_image_);
-          render_callback_->RenderFrame(stream_id_, temp_frame_);
-        } else if (!timeout_image_.IsZeroSize() &&
-                   last_render_time_ms_ + timeout_time_ <
-                       TickTime::MillisecondTimestamp()) {
-          // Render a timeout image.
-          temp_frame_.CopyFrame(timeout_image_);
-          render_callback_->RenderFrame(stream_id_, temp_frame_);
-        }
+  if (frame_to_render.IsZeroSize()) {
+    if (render_callback_) {
+      if (last_render_time_ms_ == 0 && !start_image_.IsZeroSize()) {
+        // We have not rendered anything and have a start image.
+        temp_frame_.CopyFrame(start_image_);
+        render_callback_->RenderFrame(stream_id_, temp_frame_);
+      } else if (!timeout_image_.IsZeroSize() &&
+                 last_render_time_ms_ + timeout_time_ < now_ms) {
+        // Render a timeout image.
+        temp_frame_.CopyFrame(timeout_image_);
+        render_callback_->RenderFrame(stream_id_, temp_frame_);
       }
-
-      // No frame.
-      return true;
     }
+  } else {
+    DeliverFrame(frame_to_render);
+    last_render_time_ms_ = frame_to_render.render_time_ms();
+  }
 
-    // Send frame for rendering.
-    if (external_callback_) {
-      external_callback_->RenderFrame(stream_id_, frame_to_render);
-    } else if (render_callback_) {
-      render_callback_->RenderFrame(stream_id_, frame_to_render);
-    }
+  if (frames_pending)
+    return now_ms + wait_time;
+  // Nothing to do until the next frame arrives, unless a start or timeout
+  // image may have to be rendered before that.
+  if (render_callback_ &&
+      (!start_image_.IsZeroSize() || !timeout_image_.IsZeroSize())) {
+    return now_ms + kEventMaxWaitTimeMs;
+  }
+  return -1;
+}
+
+void IncomingVideoStream::ScheduleNow() {
+  // The scheduler is only set while running with the smoothing enabled.
+  if (scheduler_)
+    scheduler_->Schedule(this, TickTime::MillisecondTimestamp());
+}
 
-    // We're done with this frame.
-    if (!frame_to_render.IsZeroSize())
-      last_render_time_ms_ = frame_to_render.render_time_ms();
+void IncomingVideoStream::DeliverFrame(const I420VideoFrame& video_frame) {
+  if (external_callback_) {
+    external_callback_->RenderFrame(stream_id_, video_frame);
+  } else if (render_callback_) {
+    render_callback_->RenderFrame(stream_id_, video_frame);
   }
-  return true;
 }
 
 }  // namespace webrtc
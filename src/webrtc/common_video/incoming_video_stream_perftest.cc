@@ -0,0 +1,157 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the cost of rendering many received streams at once, as in a
+// process recording or composing a large conference: the CPU time and the
+// number of thread wakeups (voluntary context switches) per second, and how
+// late frames are delivered relative to their release time.
+
+#if defined(WEBRTC_POSIX)
+#include <sys/resource.h>
+#endif
+
+#include <sstream>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_video/interface/incoming_video_stream.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kFrameIntervalMs = 33;
+const int kRunTimeMs = 2000;
+// Frames are received this long before they are to be rendered.
+const int kRenderDelayMs = 40;
+// The release time is this much before the render time.
+const int kExpectedRenderDelayMs = 10;
+
+struct ResourceUsage {
+  ResourceUsage() : cpu_time_us(0), context_switches(0) {}
+  int64_t cpu_time_us;
+  int64_t context_switches;
+};
+
+ResourceUsage GetResourceUsage() {
+  ResourceUsage usage;
+#if defined(WEBRTC_POSIX)
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru) == 0) {
+    usage.cpu_time_us =
+        (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000LL +
+        ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+    usage.context_switches = ru.ru_nvcsw;
+  }
+#endif
+  return usage;
+}
+
+class LatenessCounter : public VideoRenderCallback {
+ public:
+  LatenessCounter()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        num_frames_(0),
+        total_lateness_ms_(0) {}
+
+  int32_t RenderFrame(const uint32_t stream_id,
+                      const I420VideoFrame& video_frame) override {
+    const int64_t release_time_ms =
+        video_frame.render_time_ms() - kExpectedRenderDelayMs;
+    CriticalSectionScoped cs(crit_.get());
+    ++num_frames_;
+    total_lateness_ms_ += TickTime::MillisecondTimestamp() - release_time_ms;
+    return 0;
+  }
+
+  int num_frames() const {
+    CriticalSectionScoped cs(crit_.get());
+    return num_frames_;
+  }
+
+  double MeanLatenessMs() const {
+    CriticalSectionScoped cs(crit_.get());
+    return num_frames_ > 0 ? static_cast<double>(total_lateness_ms_) /
+                                 num_frames_
+                           : 0.0;
+  }
+
+ private:
+  const rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+  int num_frames_;
+  int64_t total_lateness_ms_;
+};
+
+void RunStreams(int num_streams, bool disable_prerenderer_smoothing) {
+  LatenessCounter counter;
+  rtc::scoped_ptr<rtc::scoped_ptr<IncomingVideoStream>[]> streams(
+      new rtc::scoped_ptr<IncomingVideoStream>[num_streams]);
+  for (int i = 0; i < num_streams; ++i) {
+    streams[i].reset(
+        new IncomingVideoStream(i, disable_prerenderer_smoothing));
+    streams[i]->SetExternalCallback(&counter);
+    ASSERT_EQ(0, streams[i]->Start());
+  }
+  I420VideoFrame frame;
+  frame.CreateEmptyFrame(16, 16, 16, 8, 8);
+
+  const ResourceUsage start_usage = GetResourceUsage();
+  const int64_t start_ms = TickTime::MillisecondTimestamp();
+  int num_frames = 0;
+  while (TickTime::MillisecondTimestamp() - start_ms < kRunTimeMs) {
+    // All frames of a tick share a buffer, so this thread does little work.
+    frame.set_render_time_ms(TickTime::MillisecondTimestamp() +
+                             kRenderDelayMs);
+    for (int i = 0; i < num_streams; ++i)
+      streams[i]->RenderFrame(i, frame);
+    num_frames += num_streams;
+    SleepMs(kFrameIntervalMs);
+  }
+  // Let the last frames be rendered.
+  SleepMs(kRenderDelayMs + kFrameIntervalMs);
+  for (int i = 0; i < num_streams; ++i)
+    streams[i]->Stop();
+  const int64_t elapsed_ms = TickTime::MillisecondTimestamp() - start_ms;
+  const ResourceUsage end_usage = GetResourceUsage();
+  EXPECT_EQ(num_frames, counter.num_frames());
+
+  std::stringstream ss;
+  ss << num_streams << "_streams"
+     << (disable_prerenderer_smoothing ? "_no_smoothing" : "");
+  webrtc::test::PrintResult(
+      "incoming_video_stream_cpu", "", ss.str(),
+      static_cast<double>(end_usage.cpu_time_us - start_usage.cpu_time_us) /
+          elapsed_ms,
+      "ms/s", false);
+  webrtc::test::PrintResult(
+      "incoming_video_stream_wakeups", "", ss.str(),
+      1000.0 * (end_usage.context_switches - start_usage.context_switches) /
+          elapsed_ms,
+      "wakeups/s", false);
+  if (!disable_prerenderer_smoothing) {
+    webrtc::test::PrintResult("incoming_video_stream_lateness", "", ss.str(),
+                              counter.MeanLatenessMs(), "ms", false);
+  }
+}
+
+}  // namespace
+
+TEST(IncomingVideoStreamPerfTest, ManyStreams) {
+  const int kNumStreams[] = {1, 10, 50};
+  for (int num_streams : kNumStreams) {
+    RunStreams(num_streams, false);
+    RunStreams(num_streams, true);
+  }
+}
+
+}  // namespace webrtc
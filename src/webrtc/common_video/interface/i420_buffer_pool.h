@@ -13,7 +13,8 @@
 
 #include <list>
 
-#include "webrtc/base/thread_checker.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/thread_annotations.h"
 #include "webrtc/common_video/interface/video_frame_buffer.h"
 
 namespace webrtc {
@@ -22,20 +23,20 @@ namespace webrtc {
 // The pool manages the memory of the I420Buffer returned from CreateBuffer.
 // When the I420Buffer is destructed, the memory is returned to the pool for use
 // by subsequent calls to CreateBuffer. If the resolution passed to CreateBuffer
-// changes, old buffers will be purged from the pool.
+// changes, old buffers will be purged from the pool. The pool can be used from
+// any thread, e.g. by a capturer which is called on varying threads.
 class I420BufferPool {
  public:
   I420BufferPool();
   // Returns a buffer from the pool, or creates a new buffer if no suitable
   // buffer exists in the pool.
   rtc::scoped_refptr<VideoFrameBuffer> CreateBuffer(int width, int height);
-  // Clears buffers_ and detaches the thread checker so that it can be reused
-  // later from another thread.
+  // Clears buffers_. Buffers which are in use are freed when released.
   void Release();
 
  private:
-  rtc::ThreadChecker thread_checker_;
-  std::list<rtc::scoped_refptr<I420Buffer>> buffers_;
+  rtc::CriticalSection crit_;
+  std::list<rtc::scoped_refptr<I420Buffer>> buffers_ GUARDED_BY(crit_);
 };
 
 }  // namespace webrtc
@@ -14,11 +14,10 @@
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/common_video/video_render_frames.h"
+#include "webrtc/common_video/video_render_scheduler.h"
 
 namespace webrtc {
 class CriticalSectionWrapper;
-class EventTimerWrapper;
-class ThreadWrapper;
 
 class VideoRenderCallback {
  public:
@@ -28,9 +27,14 @@ class VideoRenderCallback {
   virtual ~VideoRenderCallback() {}
 };
 
-class IncomingVideoStream : public VideoRenderCallback {
+// Frames are rendered at their render time by the VideoRenderScheduler shared
+// by all streams. Consumers which don't render to a display, e.g. recorders,
+// can disable the smoothing to have frames delivered as soon as they arrive,
+// on the thread delivering them.
+class IncomingVideoStream : public VideoRenderCallback,
+                            public VideoRenderScheduler::Stream {
  public:
-  explicit IncomingVideoStream(uint32_t stream_id);
+  IncomingVideoStream(uint32_t stream_id, bool disable_prerenderer_smoothing);
   ~IncomingVideoStream();
 
   // Get callback to deliver frames to the module.
@@ -63,22 +67,28 @@ class IncomingVideoStream : public VideoRenderCallback {
   int32_t SetExpectedRenderDelay(int32_t delay_ms);
 
  protected:
-  static bool IncomingVideoStreamThreadFun(void* obj);
-  bool IncomingVideoStreamProcess();
+  // Implements VideoRenderScheduler::Stream.
+  int64_t RenderPendingFrames(int64_t now_ms) override;
 
  private:
   enum { kEventStartupTimeMs = 10 };
   enum { kEventMaxWaitTimeMs = 100 };
   enum { kFrameRatePeriodMs = 1000 };
 
+  void DeliverFrame(const I420VideoFrame& video_frame)
+      EXCLUSIVE_LOCKS_REQUIRED(thread_critsect_);
+  // Has RenderPendingFrames() called as soon as possible while running, for a
+  // new start image, timeout image or render callback to take effect.
+  void ScheduleNow() EXCLUSIVE_LOCKS_REQUIRED(stream_critsect_);
+
   uint32_t const stream_id_;
+  const bool disable_prerenderer_smoothing_;
   // Critsects in allowed to enter order.
   const rtc::scoped_ptr<CriticalSectionWrapper> stream_critsect_;
   const rtc::scoped_ptr<CriticalSectionWrapper> thread_critsect_;
   const rtc::scoped_ptr<CriticalSectionWrapper> buffer_critsect_;
-  rtc::scoped_ptr<ThreadWrapper> incoming_render_thread_
-      GUARDED_BY(thread_critsect_);
-  rtc::scoped_ptr<EventTimerWrapper> deliver_buffer_event_;
+  // Set while running, unless the smoothing is disabled.
+  VideoRenderScheduler* scheduler_ GUARDED_BY(stream_critsect_);
 
   bool running_ GUARDED_BY(stream_critsect_);
   VideoRenderCallback* external_callback_ GUARDED_BY(thread_critsect_);
@@ -0,0 +1,210 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures how long the conversions between I420 and packed formats take on
+// one and on all cores, per frame and for batches of small frames such as a
+// recorder compositing many streams sees.
+
+#include <stdio.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+// NOTE(ajm): Path provided by gyp.
+#include "libyuv.h"  // NOLINT
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_video/libyuv/include/scaler.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/system_wrappers/interface/cpu_info.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/system_wrappers/interface/worker_pool.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kCifWidth = 352;
+const int kCifHeight = 288;
+const int kNumFrames = 50;
+const int kNumStreams = 16;
+
+struct Resolution {
+  const char* name;
+  int width;
+  int height;
+};
+
+const Resolution kResolutions[] = {
+  {"720p", 1280, 720},
+  {"1080p", 1920, 1080},
+  {"4k", 3840, 2160},
+};
+
+const Resolution kStreamResolution = {"360p", 640, 360};
+
+struct Format {
+  const char* name;
+  uint32_t fourcc;
+  int bytes_per_pixel;
+};
+
+const Format kFormats[] = {
+  {"argb", libyuv::FOURCC_ARGB, 4},
+  {"24bg", libyuv::FOURCC_24BG, 3},
+  {"yuy2", libyuv::FOURCC_YUY2, 2},
+};
+
+void ReadCifFrame(I420VideoFrame* frame) {
+  const size_t cif_length = CalcBufferSize(kI420, kCifWidth, kCifHeight);
+  rtc::scoped_ptr<uint8_t[]> cif_buffer(new uint8_t[cif_length]);
+  FILE* file = fopen(test::ResourcePath("foreman_cif", "yuv").c_str(), "rb");
+  ASSERT_TRUE(file != NULL);
+  ASSERT_EQ(cif_length, fread(cif_buffer.get(), 1, cif_length, file));
+  fclose(file);
+  ASSERT_EQ(0, frame->CreateFrame(cif_buffer.get(), kCifWidth, kCifHeight,
+                                  kVideoRotation_0));
+}
+
+void ScaleFrame(const I420VideoFrame& src, const Resolution& resolution,
+                I420VideoFrame* dst) {
+  Scaler scaler;
+  ASSERT_EQ(0, scaler.Set(src.width(), src.height(), resolution.width,
+                          resolution.height, kI420, kI420, kScaleBilinear));
+  ASSERT_EQ(0, scaler.Scale(src, dst));
+}
+
+I420Conversion MakeConversion(const I420VideoFrame& frame,
+                              const Format& format,
+                              uint8_t* dst) {
+  const I420Conversion conversion = {
+      frame.buffer(kYPlane), frame.stride(kYPlane),
+      frame.buffer(kUPlane), frame.stride(kUPlane),
+      frame.buffer(kVPlane), frame.stride(kVPlane),
+      dst, frame.width() * format.bytes_per_pixel,
+      frame.width(), frame.height(), format.fourcc};
+  return conversion;
+}
+
+void PrintTime(const std::string& measurement, const std::string& trace,
+               int64_t elapsed_us) {
+  test::PrintResult(measurement, "", trace,
+                    static_cast<double>(elapsed_us) / kNumFrames, "us", false);
+}
+
+// Measures the conversions of |frame| to and from each of the formats, and
+// the copy of |frame|, with |pool|.
+void MeasureFrame(const I420VideoFrame& frame, WorkerPool* pool,
+                  const std::string& trace) {
+  const int width = frame.width();
+  const int height = frame.height();
+  I420VideoFrame copy;
+  ASSERT_EQ(0, copy.CreateEmptyFrame(width, height, frame.stride(kYPlane),
+                                     frame.stride(kUPlane),
+                                     frame.stride(kVPlane)));
+  for (const Format& format : kFormats) {
+    const size_t size = static_cast<size_t>(width) * height *
+                        format.bytes_per_pixel;
+    rtc::scoped_ptr<uint8_t[]> packed(new uint8_t[size]);
+    const I420Conversion conversion = MakeConversion(frame, format,
+                                                     packed.get());
+    // The first conversion pays for the page faults.
+    ASSERT_EQ(0, ConvertFromI420(pool, &conversion, 1));
+    int64_t start_us = TickTime::MicrosecondTimestamp();
+    for (int i = 0; i < kNumFrames; ++i)
+      ConvertFromI420(pool, &conversion, 1);
+    PrintTime("i420_to_" + std::string(format.name) + "_time", trace,
+              TickTime::MicrosecondTimestamp() - start_us);
+
+    start_us = TickTime::MicrosecondTimestamp();
+    for (int i = 0; i < kNumFrames; ++i) {
+      ConvertToI420(pool, packed.get(), size,
+                    copy.buffer(kYPlane), copy.stride(kYPlane),
+                    copy.buffer(kUPlane), copy.stride(kUPlane),
+                    copy.buffer(kVPlane), copy.stride(kVPlane),
+                    width, height, format.fourcc);
+    }
+    PrintTime(std::string(format.name) + "_to_i420_time", trace,
+              TickTime::MicrosecondTimestamp() - start_us);
+  }
+
+  const int64_t start_us = TickTime::MicrosecondTimestamp();
+  for (int i = 0; i < kNumFrames; ++i) {
+    CopyI420(pool, frame.buffer(kYPlane), frame.stride(kYPlane),
+             frame.buffer(kUPlane), frame.stride(kUPlane),
+             frame.buffer(kVPlane), frame.stride(kVPlane),
+             copy.buffer(kYPlane), copy.stride(kYPlane),
+             copy.buffer(kUPlane), copy.stride(kUPlane),
+             copy.buffer(kVPlane), copy.stride(kVPlane), width, height);
+  }
+  PrintTime("i420_copy_time", trace,
+            TickTime::MicrosecondTimestamp() - start_us);
+}
+
+}  // namespace
+
+TEST(ConversionPerfTest, Resolutions) {
+  I420VideoFrame cif_frame;
+  ReadCifFrame(&cif_frame);
+  const int num_cores = CpuInfo::DetectNumberOfCores();
+  WorkerPool pool(num_cores - 1, "ConversionPerfThread");
+  for (const Resolution& resolution : kResolutions) {
+    I420VideoFrame frame;
+    ScaleFrame(cif_frame, resolution, &frame);
+    std::stringstream trace;
+    trace << resolution.name << "_";
+    MeasureFrame(frame, NULL, trace.str() + "1_thread");
+    if (num_cores > 1) {
+      std::stringstream threads;
+      threads << num_cores << "_threads";
+      MeasureFrame(frame, &pool, trace.str() + threads.str());
+    }
+  }
+}
+
+// Converts |kNumStreams| frames to ARGB one by one and in one batch.
+TEST(ConversionPerfTest, BatchedStreams) {
+  I420VideoFrame cif_frame;
+  ReadCifFrame(&cif_frame);
+  I420VideoFrame frame;
+  ScaleFrame(cif_frame, kStreamResolution, &frame);
+  const Format& format = kFormats[0];
+  const size_t size = static_cast<size_t>(frame.width()) * frame.height() *
+                      format.bytes_per_pixel;
+  rtc::scoped_ptr<uint8_t[]> packed(new uint8_t[size * kNumStreams]);
+  std::vector<I420Conversion> conversions;
+  for (int i = 0; i < kNumStreams; ++i)
+    conversions.push_back(MakeConversion(frame, format, &packed[i * size]));
+
+  const int num_cores = CpuInfo::DetectNumberOfCores();
+  WorkerPool pool(num_cores - 1, "ConversionPerfThread");
+  std::stringstream trace;
+  trace << kNumStreams << "x" << kStreamResolution.name << "_" << num_cores
+        << "_threads_";
+  ASSERT_EQ(0, ConvertFromI420(&pool, &conversions[0], kNumStreams));
+
+  int64_t start_us = TickTime::MicrosecondTimestamp();
+  for (int i = 0; i < kNumFrames; ++i) {
+    for (const I420Conversion& conversion : conversions)
+      ConvertFromI420(&pool, &conversion, 1);
+  }
+  PrintTime("i420_to_argb_time", trace.str() + "one_by_one",
+            TickTime::MicrosecondTimestamp() - start_us);
+
+  start_us = TickTime::MicrosecondTimestamp();
+  for (int i = 0; i < kNumFrames; ++i)
+    ConvertFromI420(&pool, &conversions[0], kNumStreams);
+  PrintTime("i420_to_argb_time", trace.str() + "batched",
+            TickTime::MicrosecondTimestamp() - start_us);
+}
+
+}  // namespace webrtc
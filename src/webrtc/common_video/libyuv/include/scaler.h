@@ -15,20 +15,44 @@
 #ifndef WEBRTC_COMMON_VIDEO_LIBYUV_INCLUDE_SCALER_H_
 #define WEBRTC_COMMON_VIDEO_LIBYUV_INCLUDE_SCALER_H_
 
+#include <vector>
+
 #include "webrtc/common_video/interface/i420_buffer_pool.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
 #include "webrtc/typedefs.h"
 #include "webrtc/video_frame.h"
 
 namespace webrtc {
 
-// Supported scaling types
+// Supported scaling types, in the order of libyuv::FilterMode.
 enum ScaleMethod {
   kScalePoint,  // no interpolation
-  kScaleBilinear,
-  kScaleBox
+  kScaleBilinear,  // horizontal interpolation only
+  kScaleBox,  // bilinear interpolation
+  kScaleAverage  // averages the source pixels when scaling down
 };
 
+class WorkerPool;
+
+// Same as libyuv::I420Scale, except that the planes are scaled in parallel on
+// the threads of |pool|. When a plane is scaled down by a whole factor, its
+// rows are also split in stripes which are scaled in parallel; other ratios
+// can't be split without changing the result. |pool| may be NULL, in which case
+// everything is done on the calling thread.
+// Return value: 0 - OK,
+//              -1 - parameter error
+int ScaleI420(WorkerPool* pool,
+              const uint8_t* src_y, int src_stride_y,
+              const uint8_t* src_u, int src_stride_u,
+              const uint8_t* src_v, int src_stride_v,
+              int src_width, int src_height,
+              uint8_t* dst_y, int dst_stride_y,
+              uint8_t* dst_u, int dst_stride_u,
+              uint8_t* dst_v, int dst_stride_v,
+              int dst_width, int dst_height,
+              ScaleMethod method);
+
 class Scaler {
  public:
   Scaler();
@@ -51,6 +75,10 @@ class Scaler {
   int Scale(const I420VideoFrame& src_frame,
             I420VideoFrame* dst_frame);
 
+  // Splits the scaling across the threads of |pool|, which must outlive this
+  // object. NULL, the default, scales on the calling thread.
+  void SetThreadPool(WorkerPool* pool) { thread_pool_ = pool; }
+
  private:
   // Determine if the VideoTypes are currently supported.
   bool SupportedVideoType(VideoType src_video_type,
@@ -63,6 +91,48 @@ class Scaler {
   int           dst_height_;
   bool          set_;
   I420BufferPool buffer_pool_;
+  WorkerPool* thread_pool_;
+};
+
+// Scales frames to several resolutions at once, e.g. for the layers of
+// simulcast. Each layer is scaled from the smallest larger layer rather than
+// from the input frame, which is much less work for the lower layers when the
+// input is large. Unlike Scaler, frames are stretched rather than cropped if
+// the aspect ratio differs.
+class PyramidScaler {
+ public:
+  struct Resolution {
+    Resolution(int width, int height) : width(width), height(height) {}
+    int width;
+    int height;
+  };
+
+  // |pool| may be NULL, in which case everything is done on the calling
+  // thread. It must outlive this object.
+  explicit PyramidScaler(WorkerPool* pool);
+  ~PyramidScaler();
+
+  // Sets the resolutions to scale to, in any order.
+  // Return value: 0 - OK
+  //              -1 - parameter error
+  int Set(const std::vector<Resolution>& resolutions, ScaleMethod method);
+
+  // Scales |src_frame| to each of the resolutions, in the order they were
+  // given. Layers with the resolution of |src_frame| share its buffer. Memory
+  // is allocated by this object and recycled using one pool per layer.
+  // Return value: 0 - OK,
+  //              -1 - parameter error
+  //              -2 - scaler not set
+  int Scale(const I420VideoFrame& src_frame,
+            std::vector<I420VideoFrame>* dst_frames);
+
+ private:
+  WorkerPool* const thread_pool_;
+  ScaleMethod method_;
+  std::vector<Resolution> resolutions_;
+  // Indices into |resolutions_|, largest resolution first.
+  std::vector<size_t> scale_order_;
+  ScopedVector<I420BufferPool> buffer_pools_;
 };
 
 }  // namespace webrtc
@@ -24,6 +24,8 @@
 
 namespace webrtc {
 
+class WorkerPool;
+
 // Supported video types.
 enum VideoType {
   kUnknown,
@@ -134,6 +136,59 @@ int ConvertFromYV12(const I420VideoFrame& src_frame,
                     VideoType dst_video_type, int dst_sample_size,
                     uint8_t* dst_frame);
 
+// Conversion of an I420 image to |fourcc|, any libyuv FOURCC which
+// libyuv::ConvertFromI420 supports, for ConvertFromI420() below.
+struct I420Conversion {
+  const uint8_t* src_y;
+  int src_stride_y;
+  const uint8_t* src_u;
+  int src_stride_u;
+  const uint8_t* src_v;
+  int src_stride_v;
+  uint8_t* dst;
+  int dst_stride;
+  int width;
+  int height;
+  uint32_t fourcc;
+};
+
+// Same as libyuv::ConvertFromI420 on each of the |num_conversions| entries of
+// |conversions|, which are all run in one go on the threads of |pool|. The
+// rows of packed formats, such as ARGB and YUY2, are split in stripes which
+// are converted in parallel; other formats take one thread per conversion.
+// |pool| may be NULL, in which case everything is done on the calling thread.
+// Return value: 0 - OK,
+//              -1 - one or more conversions failed
+int ConvertFromI420(WorkerPool* pool,
+                    const I420Conversion* conversions,
+                    int num_conversions);
+
+// Same as libyuv::ConvertToI420 without cropping or rotation, except that the
+// rows of packed formats, such as ARGB and YUY2, are split in stripes which
+// are converted in parallel on the threads of |pool|. Other formats, and
+// flipped images with a negative |src_height|, are converted on the calling
+// thread.
+// Return value: 0 if OK, < 0 otherwise.
+int ConvertToI420(WorkerPool* pool,
+                  const uint8_t* sample, size_t sample_size,
+                  uint8_t* dst_y, int dst_stride_y,
+                  uint8_t* dst_u, int dst_stride_u,
+                  uint8_t* dst_v, int dst_stride_v,
+                  int src_width, int src_height,
+                  uint32_t fourcc);
+
+// Same as libyuv::I420Copy, with the rows split in stripes which are copied in
+// parallel on the threads of |pool|.
+// Return value: 0 if OK, < 0 otherwise.
+int CopyI420(WorkerPool* pool,
+             const uint8_t* src_y, int src_stride_y,
+             const uint8_t* src_u, int src_stride_u,
+             const uint8_t* src_v, int src_stride_v,
+             uint8_t* dst_y, int dst_stride_y,
+             uint8_t* dst_u, int dst_stride_u,
+             uint8_t* dst_v, int dst_stride_v,
+             int width, int height);
+
 // The following list describes designated conversion functions which
 // are not covered by the previous general functions.
 // Input and output descriptions mostly match the above descriptions, and are
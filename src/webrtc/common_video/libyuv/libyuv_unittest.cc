@@ -11,10 +11,13 @@
 #include <math.h>
 #include <string.h>
 
+// NOTE(ajm): Path provided by gyp.
+#include "libyuv.h"  // NOLINT
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/system_wrappers/interface/worker_pool.h"
 #include "webrtc/test/testsupport/fileutils.h"
 #include "webrtc/video_frame.h"
 
@@ -76,6 +79,25 @@ void CreateImage(I420VideoFrame* frame, int plane_offset[kNumOfPlanes]) {
   }
 }
 
+// Whether |frame1| and |frame2| have the same size and pixels.
+bool EqualPixels(const I420VideoFrame& frame1, const I420VideoFrame& frame2) {
+  if (frame1.width() != frame2.width() || frame1.height() != frame2.height())
+    return false;
+  for (int plane_num = 0; plane_num < kNumOfPlanes; ++plane_num) {
+    PlaneType plane_type = static_cast<PlaneType>(plane_num);
+    int width = (plane_num ? (frame1.width() + 1) / 2 : frame1.width());
+    int height = (plane_num ? (frame1.height() + 1) / 2 : frame1.height());
+    for (int i = 0; i < height; i++) {
+      if (memcmp(frame1.buffer(plane_type) + i * frame1.stride(plane_type),
+                 frame2.buffer(plane_type) + i * frame2.stride(plane_type),
+                 width) != 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 class TestLibYuv : public ::testing::Test {
  protected:
   TestLibYuv();
@@ -347,4 +369,83 @@ TEST_F(TestLibYuv, StrideAlignment) {
   EXPECT_EQ(64, stride_uv);
 }
 
+TEST_F(TestLibYuv, ThreadedConversionsGiveSameResult) {
+  WorkerPool pool(3, "LibYuvTestThread");
+  // Packed formats, which are split in stripes, and a planar one.
+  const uint32_t kFourccs[] = {libyuv::FOURCC_ARGB, libyuv::FOURCC_24BG,
+                               libyuv::FOURCC_YUY2, libyuv::FOURCC_I422};
+  const int kNumFourccs = sizeof(kFourccs) / sizeof(kFourccs[0]);
+  // An odd number of rows leaves a last row without a pair.
+  const int height = height_ - 1;
+  const int stride = width_ * 4;
+  const size_t size = stride * height;
+  rtc::scoped_ptr<uint8_t[]> threaded(new uint8_t[kNumFourccs * size]);
+  rtc::scoped_ptr<uint8_t[]> single(new uint8_t[size]);
+  I420Conversion conversions[kNumFourccs];
+  for (int i = 0; i < kNumFourccs; ++i) {
+    I420Conversion conversion = {
+        orig_frame_.buffer(kYPlane), orig_frame_.stride(kYPlane),
+        orig_frame_.buffer(kUPlane), orig_frame_.stride(kUPlane),
+        orig_frame_.buffer(kVPlane), orig_frame_.stride(kVPlane),
+        threaded.get() + i * size, stride, width_, height, kFourccs[i]};
+    conversions[i] = conversion;
+  }
+  // All formats in one batch.
+  memset(threaded.get(), 0, kNumFourccs * size);
+  EXPECT_EQ(0, ConvertFromI420(&pool, conversions, kNumFourccs));
+  for (int i = 0; i < kNumFourccs; ++i) {
+    memset(single.get(), 0, size);
+    EXPECT_EQ(0, libyuv::ConvertFromI420(
+        orig_frame_.buffer(kYPlane), orig_frame_.stride(kYPlane),
+        orig_frame_.buffer(kUPlane), orig_frame_.stride(kUPlane),
+        orig_frame_.buffer(kVPlane), orig_frame_.stride(kVPlane),
+        single.get(), stride, width_, height, kFourccs[i]));
+    EXPECT_EQ(0, memcmp(single.get(), threaded.get() + i * size, size))
+        << "fourcc " << i;
+  }
+
+  // And back to I420, for the packed formats.
+  for (int i = 0; i < kNumFourccs - 1; ++i) {
+    I420VideoFrame frames[2];
+    for (I420VideoFrame& frame : frames) {
+      frame.CreateEmptyFrame(width_, height, width_, (width_ + 1) / 2,
+                             (width_ + 1) / 2);
+    }
+    const uint8_t* sample = threaded.get() + i * size;
+    EXPECT_EQ(0, ConvertToI420(&pool, sample, size,
+                               frames[0].buffer(kYPlane),
+                               frames[0].stride(kYPlane),
+                               frames[0].buffer(kUPlane),
+                               frames[0].stride(kUPlane),
+                               frames[0].buffer(kVPlane),
+                               frames[0].stride(kVPlane),
+                               width_, height, kFourccs[i]));
+    EXPECT_EQ(0, ConvertToI420(NULL, sample, size,
+                               frames[1].buffer(kYPlane),
+                               frames[1].stride(kYPlane),
+                               frames[1].buffer(kUPlane),
+                               frames[1].stride(kUPlane),
+                               frames[1].buffer(kVPlane),
+                               frames[1].stride(kVPlane),
+                               width_, height, kFourccs[i]));
+    EXPECT_TRUE(EqualPixels(frames[0], frames[1])) << "fourcc " << i;
+  }
+
+  I420VideoFrame copy;
+  copy.CreateEmptyFrame(width_, height_, width_, (width_ + 1) / 2,
+                        (width_ + 1) / 2);
+  EXPECT_EQ(0, CopyI420(&pool,
+                        orig_frame_.buffer(kYPlane),
+                        orig_frame_.stride(kYPlane),
+                        orig_frame_.buffer(kUPlane),
+                        orig_frame_.stride(kUPlane),
+                        orig_frame_.buffer(kVPlane),
+                        orig_frame_.stride(kVPlane),
+                        copy.buffer(kYPlane), copy.stride(kYPlane),
+                        copy.buffer(kUPlane), copy.stride(kUPlane),
+                        copy.buffer(kVPlane), copy.stride(kVPlane),
+                        width_, height_));
+  EXPECT_TRUE(EqualPixels(copy, orig_frame_));
+}
+
 }  // namespace
@@ -15,15 +15,162 @@
 // NOTE(ajm): Path provided by gyp.
 #include "libyuv.h"  // NOLINT
 
+#include "webrtc/system_wrappers/interface/worker_pool.h"
+
 namespace webrtc {
 
+namespace {
+
+// Stripes of fewer destination rows than this aren't worth a thread switch.
+const int kMinRowsPerStripe = 32;
+
+struct PlaneStripe {
+  const uint8_t* src;
+  int src_stride;
+  int src_width;
+  int src_height;
+  uint8_t* dst;
+  int dst_stride;
+  int dst_width;
+  int dst_height;
+};
+
+struct ScaleJob {
+  std::vector<PlaneStripe> stripes;
+  libyuv::FilterMode filter;
+};
+
+int GreatestCommonDivisor(int a, int b) {
+  while (b != 0) {
+    const int r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+// Returns whether a plane scaled from |src_height| to |dst_height| rows can be
+// split in stripes without changing the result. libyuv steps through the
+// source rows in fixed point from the top of the plane, and for most ratios
+// the rounding of that step makes the rows sampled by a stripe differ from
+// those sampled by the whole plane. When scaling down by a whole factor the
+// step is exact, and each destination row is made from source rows of its
+// own.
+bool CanSplitPlane(int src_height, int dst_height) {
+  return dst_height <= src_height && src_height % dst_height == 0;
+}
+
+// Splits the scaling of a plane in up to |max_stripes| stripes of rows. Each
+// stripe starts at a source row which maps exactly onto a destination row, so
+// that the stripes scale the same as the whole plane would.
+void AddPlaneStripes(const uint8_t* src, int src_stride,
+                     int src_width, int src_height,
+                     uint8_t* dst, int dst_stride,
+                     int dst_width, int dst_height,
+                     int max_stripes,
+                     std::vector<PlaneStripe>* stripes) {
+  // The plane consists of |num_units| units of |src_unit| rows, each of which
+  // is scaled to |dst_unit| rows.
+  const int num_units = GreatestCommonDivisor(src_height, dst_height);
+  const int src_unit = src_height / num_units;
+  const int dst_unit = dst_height / num_units;
+  const int num_stripes = std::max(
+      1, std::min(std::min(max_stripes, num_units),
+                  dst_height / kMinRowsPerStripe));
+  for (int i = 0; i < num_stripes; ++i) {
+    const int first_unit = num_units * i / num_stripes;
+    const int end_unit = num_units * (i + 1) / num_stripes;
+    PlaneStripe stripe;
+    stripe.src = src + first_unit * src_unit * src_stride;
+    stripe.src_stride = src_stride;
+    stripe.src_width = src_width;
+    stripe.src_height = (end_unit - first_unit) * src_unit;
+    stripe.dst = dst + first_unit * dst_unit * dst_stride;
+    stripe.dst_stride = dst_stride;
+    stripe.dst_width = dst_width;
+    stripe.dst_height = (end_unit - first_unit) * dst_unit;
+    stripes->push_back(stripe);
+  }
+}
+
+void ScaleStripe(void* context, size_t index) {
+  const ScaleJob* job = static_cast<const ScaleJob*>(context);
+  const PlaneStripe& stripe = job->stripes[index];
+  libyuv::ScalePlane(stripe.src, stripe.src_stride,
+                     stripe.src_width, stripe.src_height,
+                     stripe.dst, stripe.dst_stride,
+                     stripe.dst_width, stripe.dst_height,
+                     job->filter);
+}
+
+}  // namespace
+
+int ScaleI420(WorkerPool* pool,
+              const uint8_t* src_y, int src_stride_y,
+              const uint8_t* src_u, int src_stride_u,
+              const uint8_t* src_v, int src_stride_v,
+              int src_width, int src_height,
+              uint8_t* dst_y, int dst_stride_y,
+              uint8_t* dst_u, int dst_stride_u,
+              uint8_t* dst_v, int dst_stride_v,
+              int dst_width, int dst_height,
+              ScaleMethod method) {
+  // Inverted sources are left to libyuv.
+  if (!pool || pool->num_threads() == 0 || src_height <= 0 ||
+      dst_height < 2 * kMinRowsPerStripe) {
+    return libyuv::I420Scale(src_y, src_stride_y,
+                             src_u, src_stride_u,
+                             src_v, src_stride_v,
+                             src_width, src_height,
+                             dst_y, dst_stride_y,
+                             dst_u, dst_stride_u,
+                             dst_v, dst_stride_v,
+                             dst_width, dst_height,
+                             libyuv::FilterMode(method));
+  }
+  if (!src_y || !src_u || !src_v || src_width <= 0 ||
+      !dst_y || !dst_u || !dst_v || dst_width <= 0) {
+    return -1;
+  }
+  const int src_half_width = (src_width + 1) / 2;
+  const int src_half_height = (src_height + 1) / 2;
+  const int dst_half_width = (dst_width + 1) / 2;
+  const int dst_half_height = (dst_height + 1) / 2;
+  // The chroma planes have a quarter of the pixels each, so split them in
+  // fewer stripes to give the threads equal amounts of work. The calling
+  // thread takes part, hence the + 1.
+  // The planes are independent, so they are still scaled in parallel when
+  // they can't be split.
+  const int max_stripes = static_cast<int>(pool->num_threads()) + 1;
+  const int luma_stripes =
+      CanSplitPlane(src_height, dst_height) ? max_stripes : 1;
+  const int chroma_stripes =
+      CanSplitPlane(src_half_height, dst_half_height)
+          ? std::max(1, max_stripes / 4)
+          : 1;
+  ScaleJob job;
+  job.filter = libyuv::FilterMode(method);
+  AddPlaneStripes(src_y, src_stride_y, src_width, src_height,
+                  dst_y, dst_stride_y, dst_width, dst_height,
+                  luma_stripes, &job.stripes);
+  AddPlaneStripes(src_u, src_stride_u, src_half_width, src_half_height,
+                  dst_u, dst_stride_u, dst_half_width, dst_half_height,
+                  chroma_stripes, &job.stripes);
+  AddPlaneStripes(src_v, src_stride_v, src_half_width, src_half_height,
+                  dst_v, dst_stride_v, dst_half_width, dst_half_height,
+                  chroma_stripes, &job.stripes);
+  pool->Run(&ScaleStripe, &job, job.stripes.size());
+  return 0;
+}
+
 Scaler::Scaler()
     : method_(kScaleBox),
       src_width_(0),
       src_height_(0),
       dst_width_(0),
       dst_height_(0),
-      set_(false) {}
+      set_(false),
+      thread_pool_(NULL) {}
 
 Scaler::~Scaler() {}
 
@@ -58,6 +205,8 @@ int Scaler::Scale(const I420VideoFrame& src_frame,
   // Making sure that destination frame is of sufficient size.
   dst_frame->set_video_frame_buffer(
       buffer_pool_.CreateBuffer(dst_width_, dst_height_));
+  // The updated region of |src_frame| is in the coordinates of the source.
+  dst_frame->set_updated_region(UpdatedRegion());
 
   // We want to preserve aspect ratio instead of stretching the frame.
   // Therefore, we need to crop the source frame. Calculate the largest center
@@ -80,21 +229,22 @@ int Scaler::Scale(const I420VideoFrame& src_frame,
                          src_offset_y / 2 * src_frame.stride(kVPlane) +
                          src_offset_x / 2;
 
-  return libyuv::I420Scale(y_ptr,
-                           src_frame.stride(kYPlane),
-                           u_ptr,
-                           src_frame.stride(kUPlane),
-                           v_ptr,
-                           src_frame.stride(kVPlane),
-                           cropped_src_width, cropped_src_height,
-                           dst_frame->buffer(kYPlane),
-                           dst_frame->stride(kYPlane),
-                           dst_frame->buffer(kUPlane),
-                           dst_frame->stride(kUPlane),
-                           dst_frame->buffer(kVPlane),
-                           dst_frame->stride(kVPlane),
-                           dst_width_, dst_height_,
-                           libyuv::FilterMode(method_));
+  return ScaleI420(thread_pool_,
+                   y_ptr,
+                   src_frame.stride(kYPlane),
+                   u_ptr,
+                   src_frame.stride(kUPlane),
+                   v_ptr,
+                   src_frame.stride(kVPlane),
+                   cropped_src_width, cropped_src_height,
+                   dst_frame->buffer(kYPlane),
+                   dst_frame->stride(kYPlane),
+                   dst_frame->buffer(kUPlane),
+                   dst_frame->stride(kUPlane),
+                   dst_frame->buffer(kVPlane),
+                   dst_frame->stride(kVPlane),
+                   dst_width_, dst_height_,
+                   method_);
 }
 
 bool Scaler::SupportedVideoType(VideoType src_video_type,
@@ -109,4 +259,93 @@ bool Scaler::SupportedVideoType(VideoType src_video_type,
   return false;
 }
 
+PyramidScaler::PyramidScaler(WorkerPool* pool)
+    : thread_pool_(pool),
+      method_(kScaleBox) {}
+
+PyramidScaler::~PyramidScaler() {}
+
+int PyramidScaler::Set(const std::vector<Resolution>& resolutions,
+                       ScaleMethod method) {
+  resolutions_.clear();
+  scale_order_.clear();
+  buffer_pools_.clear();
+  for (size_t i = 0; i < resolutions.size(); ++i) {
+    if (resolutions[i].width < 1 || resolutions[i].height < 1)
+      return -1;
+  }
+  resolutions_ = resolutions;
+  method_ = method;
+  // Insertion sort by decreasing number of pixels; there are only a few.
+  for (size_t i = 0; i < resolutions_.size(); ++i) {
+    const int pixels = resolutions_[i].width * resolutions_[i].height;
+    std::vector<size_t>::iterator it = scale_order_.begin();
+    while (it != scale_order_.end() &&
+           resolutions_[*it].width * resolutions_[*it].height >= pixels) {
+      ++it;
+    }
+    scale_order_.insert(it, i);
+    buffer_pools_.push_back(new I420BufferPool());
+  }
+  return 0;
+}
+
+int PyramidScaler::Scale(const I420VideoFrame& src_frame,
+                         std::vector<I420VideoFrame>* dst_frames) {
+  assert(dst_frames);
+  if (src_frame.IsZeroSize())
+    return -1;
+  if (resolutions_.empty())
+    return -2;
+
+  dst_frames->resize(resolutions_.size());
+  for (size_t i = 0; i < scale_order_.size(); ++i) {
+    const size_t layer = scale_order_[i];
+    const int width = resolutions_[layer].width;
+    const int height = resolutions_[layer].height;
+    // Scale from the smallest frame so far which is at least as large in
+    // both dimensions, or from the input frame if there is none.
+    const I420VideoFrame* source = &src_frame;
+    for (size_t j = 0; j < i; ++j) {
+      const I420VideoFrame& larger = (*dst_frames)[scale_order_[j]];
+      if (larger.width() >= width && larger.height() >= height &&
+          larger.width() * larger.height() <
+              source->width() * source->height()) {
+        source = &larger;
+      }
+    }
+    I420VideoFrame* dst_frame = &(*dst_frames)[layer];
+    if (source->width() == width && source->height() == height) {
+      dst_frame->ShallowCopy(*source);
+      continue;
+    }
+    dst_frame->set_video_frame_buffer(
+        buffer_pools_[layer]->CreateBuffer(width, height));
+    dst_frame->set_updated_region(UpdatedRegion());
+    const int ret_val = ScaleI420(thread_pool_,
+                                  source->buffer(kYPlane),
+                                  source->stride(kYPlane),
+                                  source->buffer(kUPlane),
+                                  source->stride(kUPlane),
+                                  source->buffer(kVPlane),
+                                  source->stride(kVPlane),
+                                  source->width(), source->height(),
+                                  dst_frame->buffer(kYPlane),
+                                  dst_frame->stride(kYPlane),
+                                  dst_frame->buffer(kUPlane),
+                                  dst_frame->stride(kUPlane),
+                                  dst_frame->buffer(kVPlane),
+                                  dst_frame->stride(kVPlane),
+                                  width, height,
+                                  method_);
+    if (ret_val < 0)
+      return -1;
+    dst_frame->set_timestamp(src_frame.timestamp());
+    dst_frame->set_ntp_time_ms(src_frame.ntp_time_ms());
+    dst_frame->set_render_time_ms(src_frame.render_time_ms());
+    dst_frame->set_rotation(src_frame.rotation());
+  }
+  return 0;
+}
+
 }  // namespace webrtc
@@ -9,11 +9,16 @@
  */
 
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/common_video/libyuv/include/scaler.h"
 #include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/system_wrappers/interface/worker_pool.h"
 #include "webrtc/test/testsupport/fileutils.h"
 #include "webrtc/test/testsupport/gtest_disable.h"
 
@@ -281,6 +286,162 @@ TEST_F(TestScaler, DISABLED_ON_ANDROID(BoxScaleTest)) {
                 400, 300);
 }
 
+namespace {
+
+// Fills |frame| with diagonal stripes, which go from black to white and back
+// over |period| pixels.
+void CreatePatternFrame(int width, int height, int period,
+                        I420VideoFrame* frame) {
+  const int half_width = (width + 1) / 2;
+  frame->CreateEmptyFrame(width, height, width, half_width, half_width);
+  for (int plane = kYPlane; plane < kNumOfPlanes; ++plane) {
+    const PlaneType type = static_cast<PlaneType>(plane);
+    const int plane_width = type == kYPlane ? width : half_width;
+    const int plane_height = type == kYPlane ? height : (height + 1) / 2;
+    for (int y = 0; y < plane_height; ++y) {
+      for (int x = 0; x < plane_width; ++x) {
+        const int phase = (x + y + plane * period / 3) % period;
+        frame->buffer(type)[y * frame->stride(type) + x] = static_cast<uint8_t>(
+            abs(2 * phase - period) * 255 / period);
+      }
+    }
+  }
+}
+
+// Returns the largest difference of any pixel between two frames of the same
+// size.
+int MaxPixelDifference(const I420VideoFrame& frame1,
+                       const I420VideoFrame& frame2) {
+  int max_diff = 0;
+  for (int plane = kYPlane; plane < kNumOfPlanes; ++plane) {
+    const PlaneType type = static_cast<PlaneType>(plane);
+    const int plane_width =
+        type == kYPlane ? frame1.width() : (frame1.width() + 1) / 2;
+    const int plane_height =
+        type == kYPlane ? frame1.height() : (frame1.height() + 1) / 2;
+    for (int y = 0; y < plane_height; ++y) {
+      for (int x = 0; x < plane_width; ++x) {
+        max_diff = std::max(
+            max_diff, abs(frame1.buffer(type)[y * frame1.stride(type) + x] -
+                          frame2.buffer(type)[y * frame2.stride(type) + x]));
+      }
+    }
+  }
+  return max_diff;
+}
+
+// Scales |src_frame| with |pool| and on the calling thread alone, and returns
+// the largest difference of any pixel between the two results.
+int ScaleWithAndWithoutThreads(WorkerPool* pool,
+                               const I420VideoFrame& src_frame,
+                               int dst_width, int dst_height,
+                               ScaleMethod method) {
+  I420VideoFrame frames[2];
+  WorkerPool* pools[2] = {pool, NULL};
+  const int half_width = (dst_width + 1) / 2;
+  for (int i = 0; i < 2; ++i) {
+    frames[i].CreateEmptyFrame(dst_width, dst_height, dst_width, half_width,
+                               half_width);
+    EXPECT_EQ(0, ScaleI420(pools[i],
+                           src_frame.buffer(kYPlane),
+                           src_frame.stride(kYPlane),
+                           src_frame.buffer(kUPlane),
+                           src_frame.stride(kUPlane),
+                           src_frame.buffer(kVPlane),
+                           src_frame.stride(kVPlane),
+                           src_frame.width(), src_frame.height(),
+                           frames[i].buffer(kYPlane),
+                           frames[i].stride(kYPlane),
+                           frames[i].buffer(kUPlane),
+                           frames[i].stride(kUPlane),
+                           frames[i].buffer(kVPlane),
+                           frames[i].stride(kVPlane),
+                           dst_width, dst_height,
+                           method));
+  }
+  return MaxPixelDifference(frames[0], frames[1]);
+}
+
+}  // namespace
+
+TEST(ScaleI420Test, ThreadsGiveSameResult) {
+  WorkerPool pool(3, "ScalerTestThread");
+  I420VideoFrame src_frame;
+  CreatePatternFrame(1280, 720, 6, &src_frame);
+  const ScaleMethod kMethods[] = {kScalePoint, kScaleBilinear, kScaleBox,
+                                  kScaleAverage};
+  for (ScaleMethod method : kMethods) {
+    EXPECT_EQ(0, ScaleWithAndWithoutThreads(&pool, src_frame, 640, 360,
+                                            method));
+    EXPECT_EQ(0, ScaleWithAndWithoutThreads(&pool, src_frame, 320, 180,
+                                            method));
+    EXPECT_EQ(0, ScaleWithAndWithoutThreads(&pool, src_frame, 960, 540,
+                                            method));
+    // Neither plane height divides evenly.
+    EXPECT_EQ(0, ScaleWithAndWithoutThreads(&pool, src_frame, 720, 405,
+                                            method));
+    EXPECT_EQ(0, ScaleWithAndWithoutThreads(&pool, src_frame, 1920, 1080,
+                                            method));
+    // Ratios which aren't whole numbers.
+    EXPECT_EQ(0, ScaleWithAndWithoutThreads(&pool, src_frame, 922, 519,
+                                            method));
+    EXPECT_EQ(0, ScaleWithAndWithoutThreads(&pool, src_frame, 1283, 722,
+                                            method));
+  }
+  CreatePatternFrame(1920, 1080, 6, &src_frame);
+  for (ScaleMethod method : kMethods) {
+    EXPECT_EQ(0, ScaleWithAndWithoutThreads(&pool, src_frame, 686, 386,
+                                            method));
+    EXPECT_EQ(0, ScaleWithAndWithoutThreads(&pool, src_frame, 1134, 638,
+                                            method));
+    EXPECT_EQ(0, ScaleWithAndWithoutThreads(&pool, src_frame, 640, 360,
+                                            method));
+  }
+}
+
+TEST(PyramidScalerTest, ScalesToAllResolutions) {
+  WorkerPool pool(3, "ScalerTestThread");
+  PyramidScaler scaler(&pool);
+  I420VideoFrame src_frame;
+  CreatePatternFrame(1280, 720, 64, &src_frame);
+  src_frame.set_timestamp(90000);
+  std::vector<I420VideoFrame> dst_frames;
+  EXPECT_EQ(-2, scaler.Scale(src_frame, &dst_frames));
+
+  std::vector<PyramidScaler::Resolution> resolutions;
+  resolutions.push_back(PyramidScaler::Resolution(0, 180));
+  EXPECT_EQ(-1, scaler.Set(resolutions, kScaleBilinear));
+  resolutions.clear();
+  // Simulcast order, smallest first.
+  resolutions.push_back(PyramidScaler::Resolution(320, 180));
+  resolutions.push_back(PyramidScaler::Resolution(640, 360));
+  resolutions.push_back(PyramidScaler::Resolution(1280, 720));
+  EXPECT_EQ(0, scaler.Set(resolutions, kScaleBilinear));
+
+  EXPECT_EQ(0, scaler.Scale(src_frame, &dst_frames));
+  ASSERT_EQ(3u, dst_frames.size());
+  for (size_t i = 0; i < dst_frames.size(); ++i) {
+    EXPECT_EQ(resolutions[i].width, dst_frames[i].width());
+    EXPECT_EQ(resolutions[i].height, dst_frames[i].height());
+    EXPECT_EQ(90000u, dst_frames[i].timestamp());
+  }
+  // The full resolution isn't copied.
+  EXPECT_EQ(src_frame.video_frame_buffer(), dst_frames[2].video_frame_buffer());
+  // The smallest layer is scaled from the middle one.
+  I420VideoFrame expected_frame;
+  Scaler expected_scaler;
+  EXPECT_EQ(0, expected_scaler.Set(640, 360, 320, 180, kI420, kI420,
+                                   kScaleBilinear));
+  EXPECT_EQ(0, expected_scaler.Scale(dst_frames[1], &expected_frame));
+  EXPECT_EQ(0, MaxPixelDifference(expected_frame, dst_frames[0]));
+
+  // Buffers which are no longer used are reused.
+  const uint8_t* small_buffer = dst_frames[0].buffer(kYPlane);
+  dst_frames.clear();
+  EXPECT_EQ(0, scaler.Scale(src_frame, &dst_frames));
+  EXPECT_EQ(small_buffer, dst_frames[0].buffer(kYPlane));
+}
+
 double TestScaler::ComputeAvgSequencePSNR(FILE* input_file,
                                           std::string out_name,
                                           int width, int height) {
@@ -13,8 +13,12 @@
 #include <assert.h>
 #include <string.h>
 
+#include <algorithm>
+#include <vector>
+
 // NOTE(ajm): Path provided by gyp.
 #include "libyuv.h"  // NOLINT
+#include "webrtc/system_wrappers/interface/worker_pool.h"
 
 namespace webrtc {
 
@@ -290,6 +294,263 @@ int ConvertFromYV12(const I420VideoFrame& src_frame,
                                  ConvertVideoType(dst_video_type));
 }
 
+namespace {
+
+// Stripes of fewer rows than this aren't worth a thread switch.
+const int kMinRowsPerStripe = 32;
+
+// Rows |first_row| to |first_row| + |num_rows| of image |image|.
+struct RowStripe {
+  int image;
+  int first_row;
+  int num_rows;
+};
+
+// Splits the |height| rows of image |image| in up to |max_stripes| stripes.
+// All stripes but the last have an even number of rows, so that each stripe
+// starts at the first of the two rows which share a chroma row.
+void AddRowStripes(int image, int height, int max_stripes,
+                   std::vector<RowStripe>* stripes) {
+  const int num_stripes = std::max(
+      1, std::min(max_stripes, height / kMinRowsPerStripe));
+  const int half_height = height / 2;
+  for (int i = 0; i < num_stripes; ++i) {
+    RowStripe stripe;
+    stripe.image = image;
+    stripe.first_row = 2 * (half_height * i / num_stripes);
+    const int end_row =
+        i + 1 < num_stripes ? 2 * (half_height * (i + 1) / num_stripes)
+                            : height;
+    stripe.num_rows = end_row - stripe.first_row;
+    stripes->push_back(stripe);
+  }
+}
+
+// Calls |task| for each of the |num_tasks| on the threads of |pool|, or on the
+// calling thread if |pool| is NULL.
+void RunTasks(WorkerPool* pool, WorkerPool::TaskFunction task,
+              void* context, size_t num_tasks) {
+  if (pool) {
+    pool->Run(task, context, num_tasks);
+    return;
+  }
+  for (size_t i = 0; i < num_tasks; ++i)
+    task(context, i);
+}
+
+// The calling thread converts a stripe as well.
+int MaxStripes(WorkerPool* pool) {
+  return pool ? static_cast<int>(pool->num_threads()) + 1 : 1;
+}
+
+// Whether each row of an image of |fourcc| is stored by itself, so that the
+// rows can be converted in separate stripes.
+bool IsPackedFormat(uint32_t fourcc) {
+  switch (libyuv::CanonicalFourCC(fourcc)) {
+    case libyuv::FOURCC_YUY2:
+    case libyuv::FOURCC_UYVY:
+    case libyuv::FOURCC_RGBP:
+    case libyuv::FOURCC_RGBO:
+    case libyuv::FOURCC_R444:
+    case libyuv::FOURCC_24BG:
+    case libyuv::FOURCC_RAW:
+    case libyuv::FOURCC_ARGB:
+    case libyuv::FOURCC_BGRA:
+    case libyuv::FOURCC_ABGR:
+    case libyuv::FOURCC_RGBA:
+      return true;
+    default:
+      return false;
+  }
+}
+
+struct FromI420Job {
+  const I420Conversion* conversions;
+  std::vector<RowStripe> stripes;
+  std::vector<int> results;
+};
+
+void ConvertFromI420Stripe(void* context, size_t index) {
+  FromI420Job* job = static_cast<FromI420Job*>(context);
+  const RowStripe& stripe = job->stripes[index];
+  const I420Conversion& c = job->conversions[stripe.image];
+  const int chroma_row = stripe.first_row / 2;
+  job->results[index] = libyuv::ConvertFromI420(
+      c.src_y + stripe.first_row * c.src_stride_y, c.src_stride_y,
+      c.src_u + chroma_row * c.src_stride_u, c.src_stride_u,
+      c.src_v + chroma_row * c.src_stride_v, c.src_stride_v,
+      c.dst + stripe.first_row * c.dst_stride, c.dst_stride,
+      c.width, stripe.num_rows, c.fourcc);
+}
+
+struct ToI420Job {
+  const uint8_t* sample;
+  size_t sample_size;
+  uint8_t* dst_y;
+  int dst_stride_y;
+  uint8_t* dst_u;
+  int dst_stride_u;
+  uint8_t* dst_v;
+  int dst_stride_v;
+  int width;
+  int height;
+  uint32_t fourcc;
+  std::vector<RowStripe> stripes;
+  std::vector<int> results;
+};
+
+void ConvertToI420Stripe(void* context, size_t index) {
+  ToI420Job* job = static_cast<ToI420Job*>(context);
+  const RowStripe& stripe = job->stripes[index];
+  const int chroma_row = stripe.first_row / 2;
+  // The stripe is cropped out of the whole sample.
+  job->results[index] = libyuv::ConvertToI420(
+      job->sample, job->sample_size,
+      job->dst_y + stripe.first_row * job->dst_stride_y, job->dst_stride_y,
+      job->dst_u + chroma_row * job->dst_stride_u, job->dst_stride_u,
+      job->dst_v + chroma_row * job->dst_stride_v, job->dst_stride_v,
+      0, stripe.first_row, job->width, job->height,
+      job->width, stripe.num_rows, libyuv::kRotate0, job->fourcc);
+}
+
+struct CopyJob {
+  const uint8_t* src_y;
+  int src_stride_y;
+  const uint8_t* src_u;
+  int src_stride_u;
+  const uint8_t* src_v;
+  int src_stride_v;
+  uint8_t* dst_y;
+  int dst_stride_y;
+  uint8_t* dst_u;
+  int dst_stride_u;
+  uint8_t* dst_v;
+  int dst_stride_v;
+  int width;
+  std::vector<RowStripe> stripes;
+  std::vector<int> results;
+};
+
+void CopyStripe(void* context, size_t index) {
+  CopyJob* job = static_cast<CopyJob*>(context);
+  const RowStripe& stripe = job->stripes[index];
+  const int chroma_row = stripe.first_row / 2;
+  job->results[index] = libyuv::I420Copy(
+      job->src_y + stripe.first_row * job->src_stride_y, job->src_stride_y,
+      job->src_u + chroma_row * job->src_stride_u, job->src_stride_u,
+      job->src_v + chroma_row * job->src_stride_v, job->src_stride_v,
+      job->dst_y + stripe.first_row * job->dst_stride_y, job->dst_stride_y,
+      job->dst_u + chroma_row * job->dst_stride_u, job->dst_stride_u,
+      job->dst_v + chroma_row * job->dst_stride_v, job->dst_stride_v,
+      job->width, stripe.num_rows);
+}
+
+// Returns 0 if all |results| are 0, the first which isn't otherwise.
+int CombineResults(const std::vector<int>& results) {
+  for (int result : results) {
+    if (result != 0)
+      return result;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int ConvertFromI420(WorkerPool* pool,
+                    const I420Conversion* conversions,
+                    int num_conversions) {
+  FromI420Job job;
+  job.conversions = conversions;
+  for (int i = 0; i < num_conversions; ++i) {
+    const I420Conversion& c = conversions[i];
+    // Flipped images, images of which libyuv picks the stride, and invalid
+    // parameters, which libyuv rejects, are left to libyuv as a whole.
+    if (c.src_y && c.src_u && c.src_v && c.dst && c.width > 0 &&
+        c.height > 0 && c.dst_stride != 0 && IsPackedFormat(c.fourcc)) {
+      AddRowStripes(i, c.height, MaxStripes(pool), &job.stripes);
+    } else {
+      const RowStripe stripe = {i, 0, c.height};
+      job.stripes.push_back(stripe);
+    }
+  }
+  job.results.resize(job.stripes.size());
+  RunTasks(pool, &ConvertFromI420Stripe, &job, job.stripes.size());
+  return CombineResults(job.results) == 0 ? 0 : -1;
+}
+
+int ConvertToI420(WorkerPool* pool,
+                  const uint8_t* sample, size_t sample_size,
+                  uint8_t* dst_y, int dst_stride_y,
+                  uint8_t* dst_u, int dst_stride_u,
+                  uint8_t* dst_v, int dst_stride_v,
+                  int src_width, int src_height,
+                  uint32_t fourcc) {
+  if (!sample || !dst_y || !dst_u || !dst_v || src_width <= 0 ||
+      src_height <= 0 || !IsPackedFormat(fourcc)) {
+    return libyuv::ConvertToI420(sample, sample_size,
+                                 dst_y, dst_stride_y,
+                                 dst_u, dst_stride_u,
+                                 dst_v, dst_stride_v,
+                                 0, 0, src_width, src_height,
+                                 src_width, src_height,
+                                 libyuv::kRotate0, fourcc);
+  }
+  ToI420Job job;
+  job.sample = sample;
+  job.sample_size = sample_size;
+  job.dst_y = dst_y;
+  job.dst_stride_y = dst_stride_y;
+  job.dst_u = dst_u;
+  job.dst_stride_u = dst_stride_u;
+  job.dst_v = dst_v;
+  job.dst_stride_v = dst_stride_v;
+  job.width = src_width;
+  job.height = src_height;
+  job.fourcc = fourcc;
+  AddRowStripes(0, src_height, MaxStripes(pool), &job.stripes);
+  job.results.resize(job.stripes.size());
+  RunTasks(pool, &ConvertToI420Stripe, &job, job.stripes.size());
+  return CombineResults(job.results);
+}
+
+int CopyI420(WorkerPool* pool,
+             const uint8_t* src_y, int src_stride_y,
+             const uint8_t* src_u, int src_stride_u,
+             const uint8_t* src_v, int src_stride_v,
+             uint8_t* dst_y, int dst_stride_y,
+             uint8_t* dst_u, int dst_stride_u,
+             uint8_t* dst_v, int dst_stride_v,
+             int width, int height) {
+  if (!src_y || !src_u || !src_v || !dst_y || !dst_u || !dst_v ||
+      width <= 0 || height <= 0) {
+    return libyuv::I420Copy(src_y, src_stride_y,
+                            src_u, src_stride_u,
+                            src_v, src_stride_v,
+                            dst_y, dst_stride_y,
+                            dst_u, dst_stride_u,
+                            dst_v, dst_stride_v,
+                            width, height);
+  }
+  CopyJob job;
+  job.src_y = src_y;
+  job.src_stride_y = src_stride_y;
+  job.src_u = src_u;
+  job.src_stride_u = src_stride_u;
+  job.src_v = src_v;
+  job.src_stride_v = src_stride_v;
+  job.dst_y = dst_y;
+  job.dst_stride_y = dst_stride_y;
+  job.dst_u = dst_u;
+  job.dst_stride_u = dst_stride_u;
+  job.dst_v = dst_v;
+  job.dst_stride_v = dst_stride_v;
+  job.width = width;
+  AddRowStripes(0, height, MaxStripes(pool), &job.stripes);
+  job.results.resize(job.stripes.size());
+  RunTasks(pool, &CopyStripe, &job, job.stripes.size());
+  return CombineResults(job.results);
+}
+
 // Compute PSNR for an I420 frame (all planes)
 double I420PSNR(const I420VideoFrame* ref_frame,
                 const I420VideoFrame* test_frame) {
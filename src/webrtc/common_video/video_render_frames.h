@@ -33,6 +33,9 @@ class VideoRenderFrames {
   // Releases all frames
   int32_t ReleaseAllFrames();
 
+  // Returns true if there are no frames waiting to be rendered.
+  bool Empty() const { return incoming_frames_.empty(); }
+
   // Returns the number of ms to next frame to render
   uint32_t TimeToNextFrameRelease();
 
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_video/video_render_scheduler.h"
+
+#include <assert.h>
+
+#include "webrtc/system_wrappers/interface/condition_variable_wrapper.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+
+VideoRenderScheduler* VideoRenderScheduler::GetScheduler() {
+  return GetStaticInstance<VideoRenderScheduler>(kAddRef);
+}
+
+void VideoRenderScheduler::ReturnScheduler() {
+  GetStaticInstance<VideoRenderScheduler>(kRelease);
+}
+
+VideoRenderScheduler* VideoRenderScheduler::Create() {
+  VideoRenderScheduler* scheduler = new VideoRenderScheduler();
+  scheduler->thread_ = ThreadWrapper::CreateThread(
+      &VideoRenderScheduler::SchedulerThreadFun, scheduler,
+      "VideoRenderScheduler");
+  if (!scheduler->thread_->Start()) {
+    scheduler->thread_.reset();
+    delete scheduler;
+    return NULL;
+  }
+  scheduler->thread_->SetPriority(kRealtimePriority);
+  return scheduler;
+}
+
+VideoRenderScheduler::VideoRenderScheduler()
+    : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      wake_(ConditionVariableWrapper::CreateConditionVariable()),
+      stream_done_(ConditionVariableWrapper::CreateConditionVariable()),
+      running_stream_(NULL),
+      stopping_(false) {
+}
+
+VideoRenderScheduler::~VideoRenderScheduler() {
+  if (thread_) {
+    {
+      CriticalSectionScoped cs(crit_.get());
+      stopping_ = true;
+      wake_->Wake();
+    }
+    thread_->Stop();
+  }
+  assert(scheduled_.empty());
+}
+
+void VideoRenderScheduler::Schedule(Stream* stream, int64_t time_ms) {
+  CriticalSectionScoped cs(crit_.get());
+  ScheduleLocked(stream, time_ms);
+}
+
+void VideoRenderScheduler::ScheduleLocked(Stream* stream, int64_t time_ms) {
+  ScheduledStreams::iterator it = scheduled_.find(stream);
+  if (it != scheduled_.end()) {
+    if (it->second->first <= time_ms)
+      return;
+    deadlines_.erase(it->second);
+    scheduled_.erase(it);
+  }
+  const bool earliest =
+      deadlines_.empty() || time_ms < deadlines_.begin()->first;
+  scheduled_[stream] = deadlines_.insert(std::make_pair(time_ms, stream));
+  if (earliest)
+    wake_->Wake();
+}
+
+void VideoRenderScheduler::Unschedule(Stream* stream) {
+  CriticalSectionScoped cs(crit_.get());
+  while (running_stream_ == stream)
+    stream_done_->SleepCS(*crit_);
+  ScheduledStreams::iterator it = scheduled_.find(stream);
+  if (it != scheduled_.end()) {
+    deadlines_.erase(it->second);
+    scheduled_.erase(it);
+  }
+}
+
+bool VideoRenderScheduler::SchedulerThreadFun(void* obj) {
+  return static_cast<VideoRenderScheduler*>(obj)->Process();
+}
+
+bool VideoRenderScheduler::Process() {
+  CriticalSectionScoped cs(crit_.get());
+  if (stopping_)
+    return false;
+  if (deadlines_.empty()) {
+    wake_->SleepCS(*crit_);
+    return true;
+  }
+  int64_t now_ms = TickTime::MillisecondTimestamp();
+  DeadlineQueue::iterator next = deadlines_.begin();
+  if (next->first > now_ms) {
+    wake_->SleepCS(*crit_, static_cast<unsigned long>(next->first - now_ms));
+    return true;
+  }
+
+  Stream* stream = next->second;
+  scheduled_.erase(stream);
+  deadlines_.erase(next);
+  running_stream_ = stream;
+  int64_t next_time_ms;
+  {
+    // The stream may be scheduled again while rendering, e.g. by a new frame.
+    crit_->Leave();
+    next_time_ms = stream->RenderPendingFrames(now_ms);
+    crit_->Enter();
+  }
+  running_stream_ = NULL;
+  if (next_time_ms >= 0)
+    ScheduleLocked(stream, next_time_ms);
+  stream_done_->WakeAll();
+  return true;
+}
+
+}  // namespace webrtc
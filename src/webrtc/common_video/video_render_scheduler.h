@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_VIDEO_VIDEO_RENDER_SCHEDULER_H_
+#define WEBRTC_COMMON_VIDEO_VIDEO_RENDER_SCHEDULER_H_
+
+#include <map>
+
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/system_wrappers/interface/static_instance.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+class ConditionVariableWrapper;
+class CriticalSectionWrapper;
+class ThreadWrapper;
+
+// Runs the rendering of any number of streams on one thread. The pending
+// deadlines of all streams are kept in one queue, ordered by time, and the
+// thread only wakes up when the earliest one is due. Streams which have
+// nothing to render aren't woken up at all.
+class VideoRenderScheduler {
+ public:
+  class Stream {
+   public:
+    // Renders what is due at |now_ms|. Returns the time at which to be called
+    // again, or -1 to not be called until scheduled again.
+    virtual int64_t RenderPendingFrames(int64_t now_ms) = 0;
+
+   protected:
+    virtual ~Stream() {}
+  };
+
+  // Returns the scheduler shared by all streams in the process, which is
+  // created on first use. Each call must be matched by a ReturnScheduler().
+  static VideoRenderScheduler* GetScheduler();
+  static void ReturnScheduler();
+
+  static VideoRenderScheduler* Create();
+  ~VideoRenderScheduler();
+
+  // Makes sure |stream| is called at, or as soon as possible after, |time_ms|.
+  // Does nothing if it is already scheduled earlier.
+  void Schedule(Stream* stream, int64_t time_ms);
+
+  // Cancels the scheduled call of |stream|, waiting for a call in progress to
+  // return. Must not be called from RenderPendingFrames().
+  void Unschedule(Stream* stream);
+
+ protected:
+  static VideoRenderScheduler* CreateInstance() { return Create(); }
+
+ private:
+  friend VideoRenderScheduler* GetStaticInstance<VideoRenderScheduler>(
+      CountOperation count_operation);
+
+  typedef std::multimap<int64_t, Stream*> DeadlineQueue;
+  typedef std::map<Stream*, DeadlineQueue::iterator> ScheduledStreams;
+
+  VideoRenderScheduler();
+
+  static bool SchedulerThreadFun(void* obj);
+  bool Process();
+
+  void ScheduleLocked(Stream* stream, int64_t time_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  const rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+  // Wakes the thread when an earlier deadline is scheduled.
+  const rtc::scoped_ptr<ConditionVariableWrapper> wake_;
+  // Signaled when a call to RenderPendingFrames() returns.
+  const rtc::scoped_ptr<ConditionVariableWrapper> stream_done_;
+  rtc::scoped_ptr<ThreadWrapper> thread_;
+
+  DeadlineQueue deadlines_ GUARDED_BY(crit_);
+  ScheduledStreams scheduled_ GUARDED_BY(crit_);
+  Stream* running_stream_ GUARDED_BY(crit_);
+  bool stopping_ GUARDED_BY(crit_);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_VIDEO_VIDEO_RENDER_SCHEDULER_H_
@@ -0,0 +1,227 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_video/interface/incoming_video_stream.h"
+#include "webrtc/common_video/video_render_scheduler.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+namespace {
+
+const int kWaitTimeoutMs = 1000;
+
+// Records the order and time of its calls.
+class RecordingStream : public VideoRenderScheduler::Stream {
+ public:
+  RecordingStream(int id, std::vector<int>* call_order,
+                  CriticalSectionWrapper* crit, EventWrapper* called)
+      : id_(id), call_order_(call_order), crit_(crit), called_(called),
+        next_time_ms_(-1), last_call_ms_(-1) {}
+
+  int64_t RenderPendingFrames(int64_t now_ms) override {
+    CriticalSectionScoped cs(crit_);
+    call_order_->push_back(id_);
+    last_call_ms_ = now_ms;
+    called_->Set();
+    return next_time_ms_;
+  }
+
+  void set_next_time_ms(int64_t next_time_ms) {
+    CriticalSectionScoped cs(crit_);
+    next_time_ms_ = next_time_ms;
+  }
+
+  int64_t last_call_ms() const {
+    CriticalSectionScoped cs(crit_);
+    return last_call_ms_;
+  }
+
+ private:
+  const int id_;
+  std::vector<int>* const call_order_;
+  CriticalSectionWrapper* const crit_;
+  EventWrapper* const called_;
+  int64_t next_time_ms_;
+  int64_t last_call_ms_;
+};
+
+class FrameCounter : public VideoRenderCallback {
+ public:
+  FrameCounter()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        num_frames_(0),
+        last_frame_time_ms_(-1) {}
+
+  int32_t RenderFrame(const uint32_t stream_id,
+                      const I420VideoFrame& video_frame) override {
+    CriticalSectionScoped cs(crit_.get());
+    ++num_frames_;
+    last_frame_time_ms_ = TickTime::MillisecondTimestamp();
+    return 0;
+  }
+
+  int num_frames() const {
+    CriticalSectionScoped cs(crit_.get());
+    return num_frames_;
+  }
+
+  int64_t last_frame_time_ms() const {
+    CriticalSectionScoped cs(crit_.get());
+    return last_frame_time_ms_;
+  }
+
+ private:
+  const rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+  int num_frames_;
+  int64_t last_frame_time_ms_;
+};
+
+}  // namespace
+
+class VideoRenderSchedulerTest : public ::testing::Test {
+ protected:
+  VideoRenderSchedulerTest()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        called_(EventWrapper::Create()),
+        scheduler_(VideoRenderScheduler::Create()) {}
+
+  std::vector<int> CallOrder() {
+    CriticalSectionScoped cs(crit_.get());
+    return call_order_;
+  }
+
+  std::vector<int> call_order_;
+  const rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+  const rtc::scoped_ptr<EventWrapper> called_;
+  rtc::scoped_ptr<VideoRenderScheduler> scheduler_;
+};
+
+TEST_F(VideoRenderSchedulerTest, CallsStreamsInDeadlineOrder) {
+  RecordingStream stream1(1, &call_order_, crit_.get(), called_.get());
+  RecordingStream stream2(2, &call_order_, crit_.get(), called_.get());
+  RecordingStream stream3(3, &call_order_, crit_.get(), called_.get());
+  const int64_t now_ms = TickTime::MillisecondTimestamp();
+  scheduler_->Schedule(&stream1, now_ms + 60);
+  scheduler_->Schedule(&stream2, now_ms + 20);
+  scheduler_->Schedule(&stream3, now_ms + 40);
+  // Moving a deadline later doesn't delay the call.
+  scheduler_->Schedule(&stream2, now_ms + 100);
+
+  for (int i = 0; i < 3; ++i)
+    EXPECT_EQ(kEventSignaled, called_->Wait(kWaitTimeoutMs));
+  std::vector<int> expected_order;
+  expected_order.push_back(2);
+  expected_order.push_back(3);
+  expected_order.push_back(1);
+  EXPECT_EQ(expected_order, CallOrder());
+  EXPECT_GE(stream2.last_call_ms(), now_ms + 20);
+  EXPECT_GE(stream3.last_call_ms(), now_ms + 40);
+  EXPECT_GE(stream1.last_call_ms(), now_ms + 60);
+
+  // Not called again unless scheduled.
+  SleepMs(50);
+  EXPECT_EQ(3u, CallOrder().size());
+}
+
+TEST_F(VideoRenderSchedulerTest, ReschedulesAtReturnedTime) {
+  RecordingStream stream(1, &call_order_, crit_.get(), called_.get());
+  const int64_t now_ms = TickTime::MillisecondTimestamp();
+  stream.set_next_time_ms(now_ms + 30);
+  scheduler_->Schedule(&stream, now_ms);
+  EXPECT_EQ(kEventSignaled, called_->Wait(kWaitTimeoutMs));
+  stream.set_next_time_ms(-1);
+  EXPECT_EQ(kEventSignaled, called_->Wait(kWaitTimeoutMs));
+  EXPECT_GE(stream.last_call_ms(), now_ms + 30);
+  scheduler_->Unschedule(&stream);
+}
+
+TEST_F(VideoRenderSchedulerTest, NotCalledAfterUnschedule) {
+  RecordingStream stream(1, &call_order_, crit_.get(), called_.get());
+  scheduler_->Schedule(&stream, TickTime::MillisecondTimestamp() + 20);
+  scheduler_->Unschedule(&stream);
+  EXPECT_EQ(kEventTimeout, called_->Wait(100));
+  EXPECT_TRUE(CallOrder().empty());
+}
+
+TEST(IncomingVideoStreamTest, DeliversFramesAtRenderTime) {
+  IncomingVideoStream stream(0, false);
+  FrameCounter counter;
+  stream.SetExternalCallback(&counter);
+  ASSERT_EQ(0, stream.Start());
+  I420VideoFrame frame;
+  frame.CreateEmptyFrame(16, 16, 16, 8, 8);
+  const int64_t render_time_ms = TickTime::MillisecondTimestamp() + 100;
+  frame.set_render_time_ms(render_time_ms);
+  EXPECT_EQ(0, stream.RenderFrame(0, frame));
+  EXPECT_EQ(0, counter.num_frames());
+  for (int i = 0; i < kWaitTimeoutMs && counter.num_frames() == 0; ++i)
+    SleepMs(1);
+  EXPECT_EQ(1, counter.num_frames());
+  // Released the default render delay of 10 ms ahead of the render time.
+  EXPECT_GE(counter.last_frame_time_ms(), render_time_ms - 10);
+  EXPECT_EQ(0, stream.Stop());
+}
+
+TEST(IncomingVideoStreamTest, RendersStartImageOnceCallbackIsSet) {
+  IncomingVideoStream stream(0, false);
+  FrameCounter counter;
+  ASSERT_EQ(0, stream.Start());
+  // Let the stream go idle, with nothing scheduled.
+  SleepMs(50);
+  I420VideoFrame frame;
+  frame.CreateEmptyFrame(16, 16, 16, 8, 8);
+  EXPECT_EQ(0, stream.SetStartImage(frame));
+  SleepMs(50);
+  stream.SetRenderCallback(&counter);
+  for (int i = 0; i < kWaitTimeoutMs && counter.num_frames() == 0; ++i)
+    SleepMs(1);
+  EXPECT_GE(counter.num_frames(), 1);
+  EXPECT_EQ(0, stream.Stop());
+}
+
+TEST(IncomingVideoStreamTest, RendersTimeoutImageOnceSet) {
+  IncomingVideoStream stream(0, false);
+  FrameCounter counter;
+  stream.SetRenderCallback(&counter);
+  ASSERT_EQ(0, stream.Start());
+  SleepMs(50);
+  EXPECT_EQ(0, counter.num_frames());
+  I420VideoFrame frame;
+  frame.CreateEmptyFrame(16, 16, 16, 8, 8);
+  EXPECT_EQ(0, stream.SetTimeoutImage(frame, 0));
+  for (int i = 0; i < kWaitTimeoutMs && counter.num_frames() == 0; ++i)
+    SleepMs(1);
+  EXPECT_GE(counter.num_frames(), 1);
+  EXPECT_EQ(0, stream.Stop());
+}
+
+TEST(IncomingVideoStreamTest, DeliversFramesWithoutSmoothing) {
+  IncomingVideoStream stream(0, true);
+  FrameCounter counter;
+  stream.SetExternalCallback(&counter);
+  ASSERT_EQ(0, stream.Start());
+  I420VideoFrame frame;
+  frame.CreateEmptyFrame(16, 16, 16, 8, 8);
+  // Render times in the future are ignored.
+  frame.set_render_time_ms(TickTime::MillisecondTimestamp() + 5000);
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(0, stream.RenderFrame(0, frame));
+  EXPECT_EQ(10, counter.num_frames());
+  EXPECT_EQ(0, stream.Stop());
+}
+
+}  // namespace webrtc
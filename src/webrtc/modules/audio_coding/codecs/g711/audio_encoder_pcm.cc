@@ -60,7 +60,7 @@ int AudioEncoderPcm::NumChannels() const {
 }
 
 size_t AudioEncoderPcm::MaxEncodedBytes() const {
-  return full_frame_samples_;
+  return full_frame_samples_ * BytesPerSample();
 }
 
 int AudioEncoderPcm::Num10MsFramesInNextPacket() const {
@@ -87,7 +87,7 @@ AudioEncoder::EncodedInfo AudioEncoderPcm::EncodeInternal(
     return EncodedInfo();
   }
   CHECK_EQ(speech_buffer_.size(), full_frame_samples_);
-  CHECK_GE(max_encoded_bytes, full_frame_samples_);
+  CHECK_GE(max_encoded_bytes, MaxEncodedBytes());
   int16_t ret = EncodeCall(&speech_buffer_[0], full_frame_samples_, encoded);
   CHECK_GE(ret, 0);
   speech_buffer_.clear();
@@ -104,12 +104,20 @@ int16_t AudioEncoderPcmA::EncodeCall(const int16_t* audio,
   return WebRtcG711_EncodeA(audio, static_cast<int16_t>(input_len), encoded);
 }
 
+int AudioEncoderPcmA::BytesPerSample() const {
+  return 1;
+}
+
 int16_t AudioEncoderPcmU::EncodeCall(const int16_t* audio,
                                      size_t input_len,
                                      uint8_t* encoded) {
   return WebRtcG711_EncodeU(audio, static_cast<int16_t>(input_len), encoded);
 }
 
+int AudioEncoderPcmU::BytesPerSample() const {
+  return 1;
+}
+
 namespace {
 template <typename T>
 typename T::Config CreateConfig(const CodecInst& codec_inst) {
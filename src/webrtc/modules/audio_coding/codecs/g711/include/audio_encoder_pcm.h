@@ -53,6 +53,8 @@ class AudioEncoderPcm : public AudioEncoder {
                              size_t input_len,
                              uint8_t* encoded) = 0;
 
+  virtual int BytesPerSample() const = 0;
+
  private:
   const int sample_rate_hz_;
   const int num_channels_;
@@ -77,6 +79,8 @@ class AudioEncoderPcmA : public AudioEncoderPcm {
                      size_t input_len,
                      uint8_t* encoded) override;
 
+  int BytesPerSample() const override;
+
  private:
   static const int kSampleRateHz = 8000;
 };
@@ -95,6 +99,8 @@ class AudioEncoderPcmU : public AudioEncoderPcm {
                      size_t input_len,
                      uint8_t* encoded) override;
 
+  int BytesPerSample() const override;
+
  private:
   static const int kSampleRateHz = 8000;
 };
@@ -21,6 +21,9 @@
 
 #include "structs.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 void WebRtcIsac_ResetBitstream(Bitstr* bit_stream);
 
@@ -170,20 +173,48 @@ void WebRtcIsac_InitPitchAnalysis(PitchAnalysisStruct* State);
 
 void WebRtcIsac_InitTransform();
 
-void WebRtcIsac_Time2Spec(double* inre1, double* inre2, int16_t* outre,
+typedef void (*Time2Spec)(double* inre1, double* inre2, int16_t* outre,
                           int16_t* outim, FFTstr* fftstr_obj);
-
-void WebRtcIsac_Spec2time(double* inre, double* inim, double* outre1,
+typedef void (*Spec2time)(double* inre, double* inim, double* outre1,
                           double* outre2, FFTstr* fftstr_obj);
 
+extern Time2Spec WebRtcIsac_Time2Spec;
+extern Spec2time WebRtcIsac_Spec2time;
+
+void WebRtcIsac_Time2SpecC(double* inre1, double* inre2, int16_t* outre,
+                           int16_t* outim, FFTstr* fftstr_obj);
+void WebRtcIsac_Spec2timeC(double* inre, double* inim, double* outre1,
+                           double* outre2, FFTstr* fftstr_obj);
+
+/* The tables filled in by WebRtcIsac_InitTransform(). */
+extern double WebRtcIsac_costab1[FRAMESAMPLES_HALF];
+extern double WebRtcIsac_sintab1[FRAMESAMPLES_HALF];
+extern double WebRtcIsac_costab2[FRAMESAMPLES_QUARTER];
+extern double WebRtcIsac_sintab2[FRAMESAMPLES_QUARTER];
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcIsac_Time2SpecSSE2(double* inre1, double* inre2, int16_t* outre,
+                              int16_t* outim, FFTstr* fftstr_obj);
+void WebRtcIsac_Spec2timeSSE2(double* inre, double* inim, double* outre1,
+                              double* outre2, FFTstr* fftstr_obj);
+#endif
+
 
 /******************************* filter functions ****************************/
 
 void WebRtcIsac_AllPoleFilter(double* InOut, double* Coef, int lengthInOut,
                               int orderCoef);
 
-void WebRtcIsac_AllZeroFilter(double* In, double* Coef, int lengthInOut,
+typedef void (*AllZeroFilter)(double* In, double* Coef, int lengthInOut,
                               int orderCoef, double* Out);
+extern AllZeroFilter WebRtcIsac_AllZeroFilter;
+
+void WebRtcIsac_AllZeroFilterC(double* In, double* Coef, int lengthInOut,
+                               int orderCoef, double* Out);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcIsac_AllZeroFilterSSE2(double* In, double* Coef, int lengthInOut,
+                                  int orderCoef, double* Out);
+#endif
 
 void WebRtcIsac_ZeroPoleFilter(double* In, double* ZeroCoef, double* PoleCoef,
                                int lengthInOut, int orderCoef, double* Out);
@@ -191,6 +222,26 @@ void WebRtcIsac_ZeroPoleFilter(double* In, double* ZeroCoef, double* PoleCoef,
 
 /***************************** filterbank functions **************************/
 
+/* Filters |InOut| in place through a cascade of |NumberOfSections| first order
+ * all-pass sections. */
+typedef void (*AllPassFilter2Float)(float* InOut,
+                                    const float* APSectionFactors,
+                                    int lengthInOut, int NumberOfSections,
+                                    float* FilterState);
+extern AllPassFilter2Float WebRtcIsac_AllPassFilter2Float;
+
+void WebRtcIsac_AllPassFilter2FloatC(float* InOut,
+                                     const float* APSectionFactors,
+                                     int lengthInOut, int NumberOfSections,
+                                     float* FilterState);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+/* Handles up to four sections. */
+void WebRtcIsac_AllPassFilter2FloatSSE2(float* InOut,
+                                        const float* APSectionFactors,
+                                        int lengthInOut, int NumberOfSections,
+                                        float* FilterState);
+#endif
+
 void WebRtcIsac_SplitAndFilterFloat(float* in, float* LP, float* HP,
                                     double* LP_la, double* HP_la,
                                     PreFiltBankstr* prefiltdata);
@@ -212,6 +263,21 @@ void WebRtcIsac_NormLatticeFilterAr(int orderCoef, float* stateF, float* stateG,
 
 void WebRtcIsac_Dir2Lat(double* a, int orderCoef, float* sth, float* cth);
 
-void WebRtcIsac_AutoCorr(double* r, const double* x, int N, int order);
+typedef void (*AutoCorr)(double* r, const double* x, int N, int order);
+extern AutoCorr WebRtcIsac_AutoCorr;
+
+void WebRtcIsac_AutoCorrC(double* r, const double* x, int N, int order);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcIsac_AutoCorrSSE2(double* r, const double* x, int N, int order);
+#endif
+
+/* Selects the fastest versions of the functions above, and of
+ * WebRtcIsac_PitchCorr, which the CPU supports. Called once by
+ * WebRtcIsac_Create(), so only tests which switch the pointers need it. */
+void WebRtcIsac_InitFunctionPointers(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
 
 #endif /* WEBRTC_MODULES_AUDIO_CODING_CODECS_ISAC_MAIN_SOURCE_CODEC_H_ */
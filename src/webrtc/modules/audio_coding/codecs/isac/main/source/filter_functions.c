@@ -53,7 +53,10 @@ void WebRtcIsac_AllPoleFilter(double *InOut, double *Coef, int lengthInOut, int
 }
 
 
-void WebRtcIsac_AllZeroFilter(double *In, double *Coef, int lengthInOut, int orderCoef, double *Out){
+AllZeroFilter WebRtcIsac_AllZeroFilter = WebRtcIsac_AllZeroFilterC;
+AutoCorr WebRtcIsac_AutoCorr = WebRtcIsac_AutoCorrC;
+
+void WebRtcIsac_AllZeroFilterC(double *In, double *Coef, int lengthInOut, int orderCoef, double *Out){
 
   /* the state of filter is assumed to be in In[-1] to In[-orderCoef] */
 
@@ -85,7 +88,7 @@ void WebRtcIsac_ZeroPoleFilter(double *In, double *ZeroCoef, double *PoleCoef, i
 }
 
 
-void WebRtcIsac_AutoCorr(
+void WebRtcIsac_AutoCorrC(
     double *r,
     const double *x,
     int N,
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/* SSE2 versions of the filter functions in filter_functions.c. Each lane
+ * accumulates its products in the same order as the C code, so the results
+ * are bit-exact with it. */
+
+#include <emmintrin.h>
+
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/codec.h"
+
+void WebRtcIsac_AutoCorrSSE2(double* r, const double* x, int N, int order) {
+  int lag = 0;
+  int j, n;
+
+  /* Four lags at a time, in two independent sums. */
+  for (; lag + 3 <= order; lag += 4) {
+    /* The number of products all four lags have. */
+    const int length = N - lag - 3;
+    __m128d sum01 = _mm_setzero_pd();
+    __m128d sum23 = _mm_setzero_pd();
+    for (n = 0; n < length; n++) {
+      const __m128d xn = _mm_set1_pd(x[n]);
+      sum01 = _mm_add_pd(sum01, _mm_mul_pd(xn, _mm_loadu_pd(&x[n + lag])));
+      sum23 = _mm_add_pd(sum23, _mm_mul_pd(xn, _mm_loadu_pd(&x[n + lag + 2])));
+    }
+    _mm_storeu_pd(&r[lag], sum01);
+    _mm_storeu_pd(&r[lag + 2], sum23);
+    /* Lag |lag + j| has 3 - j more products. */
+    for (j = 0; j < 3; j++) {
+      for (n = length; n < N - lag - j; n++)
+        r[lag + j] += x[n] * x[n + lag + j];
+    }
+  }
+
+  for (; lag <= order; lag++) {
+    double sum = 0.0;
+    for (n = 0; n < N - lag; n++)
+      sum += x[n] * x[n + lag];
+    r[lag] = sum;
+  }
+}
+
+void WebRtcIsac_AllZeroFilterSSE2(double* In, double* Coef, int lengthInOut,
+                                  int orderCoef, double* Out) {
+  int n = 0;
+  int k;
+
+  /* Four outputs at a time, in two independent sums. */
+  for (; n + 3 < lengthInOut; n += 4) {
+    const __m128d coef0 = _mm_set1_pd(Coef[0]);
+    __m128d out01 = _mm_mul_pd(_mm_loadu_pd(&In[n]), coef0);
+    __m128d out23 = _mm_mul_pd(_mm_loadu_pd(&In[n + 2]), coef0);
+    for (k = 1; k <= orderCoef; k++) {
+      const __m128d coef = _mm_set1_pd(Coef[k]);
+      out01 = _mm_add_pd(out01, _mm_mul_pd(coef, _mm_loadu_pd(&In[n - k])));
+      out23 = _mm_add_pd(out23,
+                         _mm_mul_pd(coef, _mm_loadu_pd(&In[n + 2 - k])));
+    }
+    _mm_storeu_pd(&Out[n], out01);
+    _mm_storeu_pd(&Out[n + 2], out23);
+  }
+
+  for (; n < lengthInOut; n++) {
+    double tmp = In[n] * Coef[0];
+    for (k = 1; k <= orderCoef; k++)
+      tmp += Coef[k] * In[n - k];
+    Out[n] = tmp;
+  }
+}
@@ -26,9 +26,12 @@
  * sections are used to filter the input in a cascade manner.
  * The input is overwritten!!
  */
-static void WebRtcIsac_AllPassFilter2Float(float *InOut, const float *APSectionFactors,
-                                           int lengthInOut, int NumberOfSections,
-                                           float *FilterState)
+AllPassFilter2Float WebRtcIsac_AllPassFilter2Float =
+    WebRtcIsac_AllPassFilter2FloatC;
+
+void WebRtcIsac_AllPassFilter2FloatC(float *InOut, const float *APSectionFactors,
+                                     int lengthInOut, int NumberOfSections,
+                                     float *FilterState)
 {
   int n, j;
   float temp;
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/codec.h"
+
+/* Runs the all-pass sections as a pipeline: lane j of the registers holds
+ * section j, which at step t filters sample t - j, the output section j - 1
+ * produced in the step before. The C version filters the whole signal through
+ * one section before it starts the next, so every step waits for the previous
+ * one; here the sections overlap. Each section does the same operations on
+ * the same samples as in the C version, so the results are bit-exact with
+ * it. */
+void WebRtcIsac_AllPassFilter2FloatSSE2(float* InOut,
+                                        const float* APSectionFactors,
+                                        int lengthInOut, int NumberOfSections,
+                                        float* FilterState) {
+  float factors[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  float states[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  float outputs[4];
+  const __m128 lanes = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+  const int last = NumberOfSections - 1;
+  __m128 factor, neg_factor, state, out;
+  int j, t;
+
+  if (NumberOfSections > 4 || lengthInOut < NumberOfSections) {
+    WebRtcIsac_AllPassFilter2FloatC(InOut, APSectionFactors, lengthInOut,
+                                    NumberOfSections, FilterState);
+    return;
+  }
+
+  for (j = 0; j < NumberOfSections; j++) {
+    factors[j] = APSectionFactors[j];
+    states[j] = FilterState[j];
+  }
+  factor = _mm_loadu_ps(factors);
+  neg_factor = _mm_xor_ps(factor, _mm_set1_ps(-0.0f));
+  state = _mm_loadu_ps(states);
+  out = _mm_setzero_ps();
+
+  for (t = 0; t < lengthInOut + last; t++) {
+    /* Feed the output of each section to the next, and a new sample to the
+     * first. */
+    const float sample = t < lengthInOut ? InOut[t] : 0.0f;
+    const __m128 in = _mm_move_ss(
+        _mm_shuffle_ps(out, out, _MM_SHUFFLE(2, 1, 0, 0)),
+        _mm_set_ss(sample));
+    __m128 new_state;
+    out = _mm_add_ps(state, _mm_mul_ps(factor, in));
+    new_state = _mm_add_ps(_mm_mul_ps(neg_factor, out), in);
+    if (t >= last && t < lengthInOut) {
+      state = new_state;
+    } else {
+      /* While the pipeline fills and drains, only the sections which have a
+       * sample to filter may update their states. */
+      const __m128 active = _mm_and_ps(
+          _mm_cmple_ps(lanes, _mm_set1_ps((float)t)),
+          _mm_cmpgt_ps(lanes, _mm_set1_ps((float)(t - lengthInOut))));
+      state = _mm_or_ps(_mm_and_ps(active, new_state),
+                        _mm_andnot_ps(active, state));
+    }
+    if (t >= last) {
+      _mm_storeu_ps(outputs, out);
+      InOut[t - last] = outputs[last];
+    }
+  }
+
+  _mm_storeu_ps(states, state);
+  for (j = 0; j < NumberOfSections; j++)
+    FilterState[j] = states[j];
+}
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/codec.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/filterbank_tables.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/pitch_estimator.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/typedefs.h"
+
+namespace {
+
+// Fills |x| with values in [-amplitude, amplitude].
+template <typename T>
+void FillRandom(T* x, int length, double amplitude) {
+  for (int i = 0; i < length; ++i)
+    x[i] = static_cast<T>(amplitude * (2.0 * rand() / RAND_MAX - 1.0));
+}
+
+}  // namespace
+
+class FiltersTest : public testing::Test {
+ protected:
+  void SetUp() override { srand(17); }
+
+  // The optimized versions must give the same results as the C versions.
+  void AutoCorrTester(AutoCorr WebRtcIsac_AutoCorrFunction) {
+    const int kN = WINLEN;
+    double x[kN];
+    FillRandom(x, kN, 1000.0);
+    for (int order = 0; order <= ORDERLO + 1; ++order) {
+      double r_expected[ORDERLO + 2];
+      double r[ORDERLO + 2];
+      WebRtcIsac_AutoCorrC(r_expected, x, kN, order);
+      WebRtcIsac_AutoCorrFunction(r, x, kN, order);
+      for (int i = 0; i <= order; ++i)
+        EXPECT_EQ(r_expected[i], r[i]) << "order " << order << ", lag " << i;
+    }
+  }
+
+  void AllZeroFilterTester(AllZeroFilter WebRtcIsac_AllZeroFilterFunction) {
+    const int kOrder = PITCH_WLPCORDER;
+    double in[kOrder + PITCH_SUBFRAME_LEN + 3];
+    double coef[kOrder + 1];
+    FillRandom(in, kOrder + PITCH_SUBFRAME_LEN + 3, 1000.0);
+    FillRandom(coef, kOrder + 1, 1.0);
+    // Include lengths which are not a multiple of the vector width.
+    for (int length = PITCH_SUBFRAME_LEN; length <= PITCH_SUBFRAME_LEN + 3;
+         ++length) {
+      double out_expected[PITCH_SUBFRAME_LEN + 3];
+      double out[PITCH_SUBFRAME_LEN + 3];
+      WebRtcIsac_AllZeroFilterC(&in[kOrder], coef, length, kOrder,
+                                out_expected);
+      WebRtcIsac_AllZeroFilterFunction(&in[kOrder], coef, length, kOrder, out);
+      for (int i = 0; i < length; ++i)
+        EXPECT_EQ(out_expected[i], out[i]) << "length " << length;
+    }
+  }
+
+  void AllPassFilter2FloatTester(
+      AllPassFilter2Float WebRtcIsac_AllPassFilter2FloatFunction) {
+    // The composite and the channel filters of the filterbank, for a frame
+    // and for the lookahead.
+    const float* kFactors[] = {WebRtcIsac_kCompositeApFactorsFloat,
+                               WebRtcIsac_kUpperApFactorsFloat};
+    const int kSections[] = {NUMBEROFCOMPOSITEAPSECTIONS,
+                             NUMBEROFCHANNELAPSECTIONS};
+    const int kLengths[] = {FRAMESAMPLES_HALF, QLOOKAHEAD};
+    for (int f = 0; f < 2; ++f) {
+      for (int l = 0; l < 2; ++l) {
+        float in_out_expected[FRAMESAMPLES_HALF];
+        float in_out[FRAMESAMPLES_HALF];
+        float state_expected[NUMBEROFCOMPOSITEAPSECTIONS];
+        float state[NUMBEROFCOMPOSITEAPSECTIONS];
+        FillRandom(in_out_expected, kLengths[l], 10000.0);
+        FillRandom(state_expected, kSections[f], 100.0);
+        memcpy(in_out, in_out_expected, sizeof(in_out));
+        memcpy(state, state_expected, sizeof(state));
+        WebRtcIsac_AllPassFilter2FloatC(in_out_expected, kFactors[f],
+                                        kLengths[l], kSections[f],
+                                        state_expected);
+        WebRtcIsac_AllPassFilter2FloatFunction(in_out, kFactors[f],
+                                               kLengths[l], kSections[f],
+                                               state);
+        for (int i = 0; i < kLengths[l]; ++i)
+          EXPECT_EQ(in_out_expected[i], in_out[i]);
+        for (int i = 0; i < kSections[f]; ++i)
+          EXPECT_EQ(state_expected[i], state[i]);
+      }
+    }
+  }
+
+  void PitchCorrTester(PitchCorr WebRtcIsac_PitchCorrFunction) {
+    const int kLength = PITCH_CORR_LEN2 + PITCH_MAX_LAG / 2 + 2;
+    double in[kLength];
+    double corr_expected[PITCH_LAG_SPAN2];
+    double corr[PITCH_LAG_SPAN2];
+    FillRandom(in, kLength, 1000.0);
+    WebRtcIsac_PitchCorrC(in, corr_expected);
+    WebRtcIsac_PitchCorrFunction(in, corr);
+    for (int i = 0; i < PITCH_LAG_SPAN2; ++i)
+      EXPECT_EQ(corr_expected[i], corr[i]) << "lag " << i;
+  }
+};
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST_F(FiltersTest, AutoCorrSSE2) {
+  if (WebRtc_GetCPUInfo(kSSE2) != 0)
+    AutoCorrTester(WebRtcIsac_AutoCorrSSE2);
+}
+
+TEST_F(FiltersTest, AllZeroFilterSSE2) {
+  if (WebRtc_GetCPUInfo(kSSE2) != 0)
+    AllZeroFilterTester(WebRtcIsac_AllZeroFilterSSE2);
+}
+
+TEST_F(FiltersTest, AllPassFilter2FloatSSE2) {
+  if (WebRtc_GetCPUInfo(kSSE2) != 0)
+    AllPassFilter2FloatTester(WebRtcIsac_AllPassFilter2FloatSSE2);
+}
+
+TEST_F(FiltersTest, PitchCorrSSE2) {
+  if (WebRtc_GetCPUInfo(kSSE2) != 0)
+    PitchCorrTester(WebRtcIsac_PitchCorrSSE2);
+}
+
+TEST_F(FiltersTest, PitchCorrAVX2) {
+  if (WebRtc_GetCPUInfo(kAVX2) != 0)
+    PitchCorrTester(WebRtcIsac_PitchCorrAVX2);
+}
+#endif
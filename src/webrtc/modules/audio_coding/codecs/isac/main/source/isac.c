@@ -29,7 +29,9 @@
 #include "webrtc/modules/audio_coding/codecs/isac/main/source/entropy_coding.h"
 #include "webrtc/modules/audio_coding/codecs/isac/main/source/lpc_shape_swb16_tables.h"
 #include "webrtc/modules/audio_coding/codecs/isac/main/source/os_specific_inline.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/pitch_estimator.h"
 #include "webrtc/modules/audio_coding/codecs/isac/main/source/structs.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 
 #define BIT_MASK_DEC_INIT 0x0001
 #define BIT_MASK_ENC_INIT 0x0002
@@ -258,6 +260,33 @@ int16_t WebRtcIsac_Assign(ISACStruct** ISAC_main_inst,
 }
 
 
+#if defined(WEBRTC_POSIX)
+#include <pthread.h>
+
+static void InitFunctionPointersOnce(void) {
+  static pthread_once_t lock = PTHREAD_ONCE_INIT;
+  pthread_once(&lock, WebRtcIsac_InitFunctionPointers);
+}
+
+#elif defined(_WIN32)
+#include <windows.h>
+
+static void InitFunctionPointersOnce(void) {
+  /* Statically initialized, as in WebRtcSpl_Init(), since there's no
+   * race-free context in which to call InitializeCriticalSection(). */
+  static CRITICAL_SECTION lock = {(void *)((size_t)-1), -1, 0, 0, 0, 0};
+  static int done = 0;
+
+  EnterCriticalSection(&lock);
+  if (!done) {
+    WebRtcIsac_InitFunctionPointers();
+    done = 1;
+  }
+  LeaveCriticalSection(&lock);
+}
+#endif  /* WEBRTC_POSIX */
+
+
 /****************************************************************************
  * WebRtcIsac_Create(...)
  *
@@ -273,6 +302,8 @@ int16_t WebRtcIsac_Assign(ISACStruct** ISAC_main_inst,
 int16_t WebRtcIsac_Create(ISACStruct** ISAC_main_inst) {
   ISACMainStruct* instISAC;
 
+  InitFunctionPointersOnce();
+
   if (ISAC_main_inst != NULL) {
     instISAC = (ISACMainStruct*)malloc(sizeof(ISACMainStruct));
     *ISAC_main_inst = (ISACStruct*)instISAC;
@@ -294,6 +325,32 @@ int16_t WebRtcIsac_Create(ISACStruct** ISAC_main_inst) {
 }
 
 
+/****************************************************************************
+ * WebRtcIsac_InitFunctionPointers(...)
+ *
+ * This function points the functions which have optimized versions to the
+ * fastest ones the CPU supports. WebRtcIsac_Create() calls it once per
+ * process; tests which switch the pointers call it to switch them back, while
+ * no instance runs.
+ */
+void WebRtcIsac_InitFunctionPointers(void) {
+  /* The pointers are initialized to the C versions. */
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    WebRtcIsac_AllPassFilter2Float = WebRtcIsac_AllPassFilter2FloatSSE2;
+    WebRtcIsac_AllZeroFilter = WebRtcIsac_AllZeroFilterSSE2;
+    WebRtcIsac_AutoCorr = WebRtcIsac_AutoCorrSSE2;
+    WebRtcIsac_PitchCorr = WebRtcIsac_PitchCorrSSE2;
+    WebRtcIsac_Spec2time = WebRtcIsac_Spec2timeSSE2;
+    WebRtcIsac_Time2Spec = WebRtcIsac_Time2SpecSSE2;
+  }
+  if (WebRtc_GetCPUInfo(kAVX2) != 0) {
+    WebRtcIsac_PitchCorr = WebRtcIsac_PitchCorrAVX2;
+  }
+#endif
+}
+
+
 /****************************************************************************
  * WebRtcIsac_Free(...)
  *
@@ -20,7 +20,21 @@
 
 #include "structs.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
 
+/* Computes the normalized correlation between the PITCH_CORR_LEN2 samples at
+ * in[PITCH_MAX_LAG/2 + 2] and those at in[k], for the PITCH_LAG_SPAN2 lags k.
+ * The correlation for k = 0 is written last in |outcorr|. */
+typedef void (*PitchCorr)(const double* in, double* outcorr);
+extern PitchCorr WebRtcIsac_PitchCorr;
+
+void WebRtcIsac_PitchCorrC(const double* in, double* outcorr);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcIsac_PitchCorrSSE2(const double* in, double* outcorr);
+void WebRtcIsac_PitchCorrAVX2(const double* in, double* outcorr);
+#endif
 
 void WebRtcIsac_PitchAnalysis(const double *in,               /* PITCH_FRAME_LEN samples */
                               double *out,                    /* PITCH_FRAME_LEN+QLOOKAHEAD samples */
@@ -68,4 +82,8 @@ void WebRtcIsac_DecimateAllpass(const double *in,
                                 int N,                   /* number of input samples */
                                 double *out);            /* array of size N/2 */
 
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
 #endif /* WEBRTC_MODULES_AUDIO_CODING_CODECS_ISAC_MAIN_SOURCE_PITCH_ESTIMATOR_H_ */
@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+#include <math.h>
+
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/pitch_estimator.h"
+
+/* Like WebRtcIsac_PitchCorrSSE2, but eight lags at a time. */
+void WebRtcIsac_PitchCorrAVX2(const double* in, double* outcorr) {
+  const double* x = in + PITCH_MAX_LAG / 2 + 2;
+  double sums[PITCH_LAG_SPAN2];
+  double ysum;
+  int k, n;
+
+  for (k = 0; k + 7 < PITCH_LAG_SPAN2; k += 8) {
+    __m256d sum0123 = _mm256_setzero_pd();
+    __m256d sum4567 = _mm256_setzero_pd();
+    for (n = 0; n < PITCH_CORR_LEN2; n++) {
+      const __m256d xn = _mm256_broadcast_sd(&x[n]);
+      sum0123 = _mm256_add_pd(sum0123,
+                              _mm256_mul_pd(xn, _mm256_loadu_pd(&in[k + n])));
+      sum4567 = _mm256_add_pd(
+          sum4567, _mm256_mul_pd(xn, _mm256_loadu_pd(&in[k + n + 4])));
+    }
+    _mm256_storeu_pd(&sums[k], sum0123);
+    _mm256_storeu_pd(&sums[k + 4], sum4567);
+  }
+  for (; k < PITCH_LAG_SPAN2; k++) {
+    sums[k] = 0.0;
+    for (n = 0; n < PITCH_CORR_LEN2; n++)
+      sums[k] += x[n] * in[k + n];
+  }
+
+  ysum = 1e-13;
+  for (n = 0; n < PITCH_CORR_LEN2; n++)
+    ysum += in[n] * in[n];
+  outcorr[PITCH_LAG_SPAN2 - 1] = sums[0] / sqrt(ysum);
+  for (k = 1; k < PITCH_LAG_SPAN2; k++) {
+    ysum -= in[k - 1] * in[k - 1];
+    ysum += in[PITCH_CORR_LEN2 + k - 1] * in[PITCH_CORR_LEN2 + k - 1];
+    outcorr[PITCH_LAG_SPAN2 - 1 - k] = sums[k] / sqrt(ysum);
+  }
+}
@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+#include <math.h>
+
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/pitch_estimator.h"
+
+/* Computes four lags at a time, in two independent sums. Each lane sums its
+ * products in the same order as the C version, so the results are bit-exact
+ * with it. */
+void WebRtcIsac_PitchCorrSSE2(const double* in, double* outcorr) {
+  const double* x = in + PITCH_MAX_LAG / 2 + 2;
+  double sums[PITCH_LAG_SPAN2];
+  double ysum;
+  int k, n;
+
+  for (k = 0; k + 3 < PITCH_LAG_SPAN2; k += 4) {
+    __m128d sum01 = _mm_setzero_pd();
+    __m128d sum23 = _mm_setzero_pd();
+    for (n = 0; n < PITCH_CORR_LEN2; n++) {
+      const __m128d xn = _mm_set1_pd(x[n]);
+      sum01 = _mm_add_pd(sum01, _mm_mul_pd(xn, _mm_loadu_pd(&in[k + n])));
+      sum23 = _mm_add_pd(sum23, _mm_mul_pd(xn, _mm_loadu_pd(&in[k + n + 2])));
+    }
+    _mm_storeu_pd(&sums[k], sum01);
+    _mm_storeu_pd(&sums[k + 2], sum23);
+  }
+  for (; k < PITCH_LAG_SPAN2; k++) {
+    sums[k] = 0.0;
+    for (n = 0; n < PITCH_CORR_LEN2; n++)
+      sums[k] += x[n] * in[k + n];
+  }
+
+  ysum = 1e-13;
+  for (n = 0; n < PITCH_CORR_LEN2; n++)
+    ysum += in[n] * in[n];
+  outcorr[PITCH_LAG_SPAN2 - 1] = sums[0] / sqrt(ysum);
+  for (k = 1; k < PITCH_LAG_SPAN2; k++) {
+    ysum -= in[k - 1] * in[k - 1];
+    ysum += in[PITCH_CORR_LEN2 + k - 1] * in[PITCH_CORR_LEN2 + k - 1];
+    outcorr[PITCH_LAG_SPAN2 - 1 - k] = sums[k] / sqrt(ysum);
+  }
+}
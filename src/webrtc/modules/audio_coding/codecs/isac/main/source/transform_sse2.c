@@ -0,0 +1,142 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/* SSE2 versions of the modulation around the FFT in transform.c, two samples
+ * at a time. They do the same operations as the C versions, so the results
+ * are bit-exact with them. */
+
+#include <emmintrin.h>
+#include <math.h>
+
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/codec.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/fft.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/settings.h"
+
+/* Swaps the two lanes, for the samples counted from the end. */
+static __inline __m128d Reverse(__m128d x) {
+  return _mm_shuffle_pd(x, x, 1);
+}
+
+static __inline __m128d Negate(__m128d x) {
+  return _mm_xor_pd(x, _mm_set1_pd(-0.0));
+}
+
+/* Rounds to the nearest integer like lrint(), and stores the lower 16 bits. */
+static __inline void StoreQ7(__m128d x, int16_t* lane0, int16_t* lane1) {
+  const __m128i rounded = _mm_cvtpd_epi32(_mm_mul_pd(x, _mm_set1_pd(128.0)));
+  *lane0 = (int16_t)_mm_cvtsi128_si32(rounded);
+  *lane1 = (int16_t)_mm_cvtsi128_si32(_mm_srli_si128(rounded, 4));
+}
+
+void WebRtcIsac_Time2SpecSSE2(double* inre1,
+                              double* inre2,
+                              int16_t* outreQ7,
+                              int16_t* outimQ7,
+                              FFTstr* fftstr_obj) {
+  int k;
+  int dims[1];
+  double tmpre[FRAMESAMPLES_HALF], tmpim[FRAMESAMPLES_HALF];
+  const __m128d fact = _mm_set1_pd(0.5 / sqrt(FRAMESAMPLES_HALF));
+
+  dims[0] = FRAMESAMPLES_HALF;
+
+  /* Multiply with complex exponentials and combine into one complex vector */
+  for (k = 0; k < FRAMESAMPLES_HALF; k += 2) {
+    const __m128d tmp1r = _mm_loadu_pd(&WebRtcIsac_costab1[k]);
+    const __m128d tmp1i = _mm_loadu_pd(&WebRtcIsac_sintab1[k]);
+    const __m128d in1 = _mm_loadu_pd(&inre1[k]);
+    const __m128d in2 = _mm_loadu_pd(&inre2[k]);
+    _mm_storeu_pd(&tmpre[k],
+                  _mm_mul_pd(_mm_add_pd(_mm_mul_pd(in1, tmp1r),
+                                        _mm_mul_pd(in2, tmp1i)), fact));
+    _mm_storeu_pd(&tmpim[k],
+                  _mm_mul_pd(_mm_sub_pd(_mm_mul_pd(in2, tmp1r),
+                                        _mm_mul_pd(in1, tmp1i)), fact));
+  }
+
+  /* Get DFT */
+  WebRtcIsac_Fftns(1, dims, tmpre, tmpim, -1, 1.0, fftstr_obj);
+
+  /* Use symmetry to separate into two complex vectors and center frames in
+   * time around zero */
+  for (k = 0; k < FRAMESAMPLES_QUARTER; k += 2) {
+    const int r = FRAMESAMPLES_HALF - 2 - k;
+    const __m128d re = _mm_loadu_pd(&tmpre[k]);
+    const __m128d im = _mm_loadu_pd(&tmpim[k]);
+    const __m128d re_r = Reverse(_mm_loadu_pd(&tmpre[r]));
+    const __m128d im_r = Reverse(_mm_loadu_pd(&tmpim[r]));
+    const __m128d xr = _mm_add_pd(re, re_r);
+    const __m128d yi = _mm_add_pd(Negate(re), re_r);
+    const __m128d xi = _mm_sub_pd(im, im_r);
+    const __m128d yr = _mm_add_pd(im, im_r);
+    const __m128d tmp1r = _mm_loadu_pd(&WebRtcIsac_costab2[k]);
+    const __m128d tmp1i = _mm_loadu_pd(&WebRtcIsac_sintab2[k]);
+    StoreQ7(_mm_sub_pd(_mm_mul_pd(xr, tmp1r), _mm_mul_pd(xi, tmp1i)),
+            &outreQ7[k], &outreQ7[k + 1]);
+    StoreQ7(_mm_add_pd(_mm_mul_pd(xr, tmp1i), _mm_mul_pd(xi, tmp1r)),
+            &outimQ7[k], &outimQ7[k + 1]);
+    StoreQ7(_mm_sub_pd(_mm_mul_pd(Negate(yr), tmp1i), _mm_mul_pd(yi, tmp1r)),
+            &outreQ7[r + 1], &outreQ7[r]);
+    StoreQ7(_mm_add_pd(_mm_mul_pd(Negate(yr), tmp1r), _mm_mul_pd(yi, tmp1i)),
+            &outimQ7[r + 1], &outimQ7[r]);
+  }
+}
+
+void WebRtcIsac_Spec2timeSSE2(double* inre,
+                              double* inim,
+                              double* outre1,
+                              double* outre2,
+                              FFTstr* fftstr_obj) {
+  int k;
+  int dims;
+  const __m128d fact = _mm_set1_pd(sqrt(FRAMESAMPLES_HALF));
+
+  dims = FRAMESAMPLES_HALF;
+
+  for (k = 0; k < FRAMESAMPLES_QUARTER; k += 2) {
+    const int r = FRAMESAMPLES_HALF - 2 - k;
+    /* Move zero in time to beginning of frames */
+    const __m128d tmp1r = _mm_loadu_pd(&WebRtcIsac_costab2[k]);
+    const __m128d tmp1i = _mm_loadu_pd(&WebRtcIsac_sintab2[k]);
+    const __m128d re = _mm_loadu_pd(&inre[k]);
+    const __m128d im = _mm_loadu_pd(&inim[k]);
+    const __m128d re_r = Reverse(_mm_loadu_pd(&inre[r]));
+    const __m128d im_r = Reverse(_mm_loadu_pd(&inim[r]));
+    const __m128d xr = _mm_add_pd(_mm_mul_pd(re, tmp1r), _mm_mul_pd(im, tmp1i));
+    const __m128d xi = _mm_sub_pd(_mm_mul_pd(im, tmp1r), _mm_mul_pd(re, tmp1i));
+    const __m128d yr = _mm_sub_pd(_mm_mul_pd(Negate(im_r), tmp1r),
+                                  _mm_mul_pd(re_r, tmp1i));
+    const __m128d yi = _mm_add_pd(_mm_mul_pd(Negate(re_r), tmp1r),
+                                  _mm_mul_pd(im_r, tmp1i));
+
+    /* Combine into one vector,  z = x + j * y */
+    _mm_storeu_pd(&outre1[k], _mm_sub_pd(xr, yi));
+    _mm_storeu_pd(&outre1[r], Reverse(_mm_add_pd(xr, yi)));
+    _mm_storeu_pd(&outre2[k], _mm_add_pd(xi, yr));
+    _mm_storeu_pd(&outre2[r], Reverse(_mm_add_pd(Negate(xi), yr)));
+  }
+
+  /* Get IDFT */
+  WebRtcIsac_Fftns(1, &dims, outre1, outre2, 1, FRAMESAMPLES_HALF, fftstr_obj);
+
+  /* Demodulate and separate */
+  for (k = 0; k < FRAMESAMPLES_HALF; k += 2) {
+    const __m128d tmp1r = _mm_loadu_pd(&WebRtcIsac_costab1[k]);
+    const __m128d tmp1i = _mm_loadu_pd(&WebRtcIsac_sintab1[k]);
+    const __m128d out1 = _mm_loadu_pd(&outre1[k]);
+    const __m128d out2 = _mm_loadu_pd(&outre2[k]);
+    _mm_storeu_pd(&outre1[k],
+                  _mm_mul_pd(_mm_sub_pd(_mm_mul_pd(out1, tmp1r),
+                                        _mm_mul_pd(out2, tmp1i)), fact));
+    _mm_storeu_pd(&outre2[k],
+                  _mm_mul_pd(_mm_add_pd(_mm_mul_pd(out2, tmp1r),
+                                        _mm_mul_pd(out1, tmp1i)), fact));
+  }
+}
@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/codec.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/typedefs.h"
+
+class TransformTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    srand(17);
+    WebRtcIsac_InitTransform();
+    memset(&fft_, 0, sizeof(fft_));
+  }
+
+  void FillRandom(double* x, double amplitude) {
+    for (int i = 0; i < FRAMESAMPLES_HALF; ++i)
+      x[i] = amplitude * (2.0 * rand() / RAND_MAX - 1.0);
+  }
+
+  // The optimized versions must give the same results as the C versions.
+  void Time2SpecTester(Time2Spec WebRtcIsac_Time2SpecFunction) {
+    double in1[FRAMESAMPLES_HALF];
+    double in2[FRAMESAMPLES_HALF];
+    int16_t re_expected[FRAMESAMPLES_HALF];
+    int16_t im_expected[FRAMESAMPLES_HALF];
+    int16_t re[FRAMESAMPLES_HALF];
+    int16_t im[FRAMESAMPLES_HALF];
+    FillRandom(in1, 100.0);
+    FillRandom(in2, 100.0);
+    WebRtcIsac_Time2SpecC(in1, in2, re_expected, im_expected, &fft_);
+    WebRtcIsac_Time2SpecFunction(in1, in2, re, im, &fft_);
+    for (int i = 0; i < FRAMESAMPLES_HALF; ++i) {
+      EXPECT_EQ(re_expected[i], re[i]) << i;
+      EXPECT_EQ(im_expected[i], im[i]) << i;
+    }
+  }
+
+  void Spec2timeTester(Spec2time WebRtcIsac_Spec2timeFunction) {
+    double re[FRAMESAMPLES_HALF];
+    double im[FRAMESAMPLES_HALF];
+    double out1_expected[FRAMESAMPLES_HALF];
+    double out2_expected[FRAMESAMPLES_HALF];
+    double out1[FRAMESAMPLES_HALF];
+    double out2[FRAMESAMPLES_HALF];
+    FillRandom(re, 1000.0);
+    FillRandom(im, 1000.0);
+    WebRtcIsac_Spec2timeC(re, im, out1_expected, out2_expected, &fft_);
+    WebRtcIsac_Spec2timeFunction(re, im, out1, out2, &fft_);
+    for (int i = 0; i < FRAMESAMPLES_HALF; ++i) {
+      EXPECT_EQ(out1_expected[i], out1[i]) << i;
+      EXPECT_EQ(out2_expected[i], out2[i]) << i;
+    }
+  }
+
+  FFTstr fft_;
+};
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST_F(TransformTest, Time2SpecSSE2) {
+  if (WebRtc_GetCPUInfo(kSSE2) != 0)
+    Time2SpecTester(WebRtcIsac_Time2SpecSSE2);
+}
+
+TEST_F(TransformTest, Spec2timeSSE2) {
+  if (WebRtc_GetCPUInfo(kSSE2) != 0)
+    Spec2timeTester(WebRtcIsac_Spec2timeSSE2);
+}
+#endif
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/codecs/isac/main/interface/isac.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/codec.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/pitch_estimator.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/settings.h"
+#include "webrtc/modules/audio_coding/codecs/tools/audio_codec_speed_test.h"
+
+using ::std::string;
+
+namespace webrtc {
+
+static const int kIsacBlockDurationMs = 30;
+static const int kIsacInputSamplingKhz = 16;
+static const int kIsacOutputSamplingKhz = 16;
+
+class IsacSpeedTest : public AudioCodecSpeedTest {
+ protected:
+  IsacSpeedTest();
+  void SetUp() override;
+  void TearDown() override;
+  virtual float EncodeABlock(int16_t* in_data, uint8_t* bit_stream,
+                             int max_bytes, int* encoded_bytes);
+  virtual float DecodeABlock(const uint8_t* bit_stream, int encoded_bytes,
+                             int16_t* out_data);
+  ISACStruct* isac_inst_;
+};
+
+IsacSpeedTest::IsacSpeedTest()
+    : AudioCodecSpeedTest(kIsacBlockDurationMs,
+                          kIsacInputSamplingKhz,
+                          kIsacOutputSamplingKhz),
+      isac_inst_(NULL) {
+}
+
+void IsacSpeedTest::SetUp() {
+  AudioCodecSpeedTest::SetUp();
+
+  // Check whether the allocated buffer for the bit stream is large enough.
+  EXPECT_GE(max_bytes_, STREAM_SIZE_MAX_60);
+
+  // Create encoder memory.
+  EXPECT_EQ(0, WebRtcIsac_Create(&isac_inst_));
+  EXPECT_EQ(0, WebRtcIsac_EncoderInit(isac_inst_, 1));
+  EXPECT_EQ(0, WebRtcIsac_DecoderInit(isac_inst_));
+  // Set bitrate and block length.
+  EXPECT_EQ(0, WebRtcIsac_Control(isac_inst_, bit_rate_, block_duration_ms_));
+}
+
+void IsacSpeedTest::TearDown() {
+  AudioCodecSpeedTest::TearDown();
+  // Free memory.
+  EXPECT_EQ(0, WebRtcIsac_Free(isac_inst_));
+  // Undo the effect of IsacEncodeDecodePlainCTest.
+  WebRtcIsac_InitFunctionPointers();
+}
+
+float IsacSpeedTest::EncodeABlock(int16_t* in_data, uint8_t* bit_stream,
+                                  int max_bytes, int* encoded_bytes) {
+  // ISAC takes 10 ms everycall
+  const int subblocks = block_duration_ms_ / 10;
+  const int subblock_length = 10 * input_sampling_khz_;
+  int value;
+
+  clock_t clocks = clock();
+  size_t pointer = 0;
+  for (int idx = 0; idx < subblocks; idx++, pointer += subblock_length) {
+    value = WebRtcIsac_Encode(isac_inst_, &in_data[pointer], bit_stream);
+  }
+  clocks = clock() - clocks;
+  EXPECT_GT(value, 0);
+  assert(value <= max_bytes);
+  *encoded_bytes = value;
+  return 1000.0 * clocks / CLOCKS_PER_SEC;
+}
+
+float IsacSpeedTest::DecodeABlock(const uint8_t* bit_stream, int encoded_bytes,
+                                  int16_t* out_data) {
+  int value;
+  int16_t audio_type;
+  clock_t clocks = clock();
+  value = WebRtcIsac_Decode(isac_inst_, bit_stream, encoded_bytes, out_data,
+                            &audio_type);
+  clocks = clock() - clocks;
+  EXPECT_EQ(output_length_sample_, value);
+  return 1000.0 * clocks / CLOCKS_PER_SEC;
+}
+
+TEST_P(IsacSpeedTest, IsacEncodeDecodeTest) {
+  size_t kDurationSec = 400;  // Test audio length in second.
+  EncodeDecode(kDurationSec);
+}
+
+// Runs without the SSE2 and AVX2 versions of the filters and transforms, for
+// comparison with IsacEncodeDecodeTest.
+TEST_P(IsacSpeedTest, IsacEncodeDecodePlainCTest) {
+  WebRtcIsac_AllPassFilter2Float = WebRtcIsac_AllPassFilter2FloatC;
+  WebRtcIsac_AllZeroFilter = WebRtcIsac_AllZeroFilterC;
+  WebRtcIsac_AutoCorr = WebRtcIsac_AutoCorrC;
+  WebRtcIsac_PitchCorr = WebRtcIsac_PitchCorrC;
+  WebRtcIsac_Spec2time = WebRtcIsac_Spec2timeC;
+  WebRtcIsac_Time2Spec = WebRtcIsac_Time2SpecC;
+  size_t kDurationSec = 400;  // Test audio length in second.
+  EncodeDecode(kDurationSec);
+}
+
+const coding_param param_set[] =
+    {::std::tr1::make_tuple(1, 32000, string("audio_coding/speech_mono_16kHz"),
+                            string("pcm"), true)};
+
+INSTANTIATE_TEST_CASE_P(AllTest, IsacSpeedTest,
+                        ::testing::ValuesIn(param_set));
+
+}  // namespace webrtc
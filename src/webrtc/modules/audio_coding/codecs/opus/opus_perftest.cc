@@ -0,0 +1,354 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures how fast Opus encodes and decodes through AudioEncoderOpus and
+// AudioDecoderOpus, sweeping complexity, bitrate, frame size, channels, FEC,
+// DTX and packet loss over a minute of speech or music. Prints the real-time
+// factor and percentiles of the time per packet, and how many instances one
+// core runs in real time when all cores encode and decode at once, for sizing
+// servers.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_coding/codecs/opus/interface/audio_encoder_opus.h"
+#include "webrtc/modules/audio_coding/neteq/audio_decoder_impl.h"
+#include "webrtc/system_wrappers/interface/cpu_info.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kSampleRateHz = 48000;
+const int kSamplesPer10Ms = kSampleRateHz / 100;
+const int kDurationSec = 60;
+const int kNum10MsBlocks = kDurationSec * 100;
+const int kMaxFrameSizeMs = 60;
+
+struct OpusSetup {
+  OpusSetup()
+      : num_channels(1),
+        complexity(9),
+        bitrate_bps(32000),
+        frame_size_ms(20),
+        fec_enabled(false),
+        dtx_enabled(false),
+        loss_rate(0.0) {}
+
+  int num_channels;
+  int complexity;
+  int bitrate_bps;
+  int frame_size_ms;
+  bool fec_enabled;
+  bool dtx_enabled;
+  double loss_rate;
+};
+
+// Timings of one encoder and decoder pair going through the whole input.
+struct CodecTimes {
+  CodecTimes() : encode_us(0), decode_us(0) {}
+
+  int64_t encode_us;
+  int64_t decode_us;
+  // Time per encoded packet, summed over the Encode() calls for its 10 ms
+  // blocks, and per decoded packet, whether decoded, recovered with FEC or
+  // concealed.
+  std::vector<int64_t> encode_packet_us;
+  std::vector<int64_t> decode_packet_us;
+};
+
+// Sets |audio| to |kDurationSec| seconds of interleaved 48 kHz audio with
+// |num_channels| channels, repeating a speech or music resource. Fails if the
+// resource can't be read, since silence would be far cheaper to code.
+void ReadInput(int num_channels, std::vector<int16_t>* audio) {
+  const std::string name = num_channels == 1
+                               ? "audio_coding/speech_mono_32_48kHz"
+                               : "audio_coding/music_stereo_48kHz";
+  const std::string file_name = test::ResourcePath(name, "pcm");
+  FILE* file = fopen(file_name.c_str(), "rb");
+  ASSERT_TRUE(file != NULL) << "Cannot open " << file_name;
+  std::vector<int16_t> file_audio;
+  int16_t buffer[kSamplesPer10Ms];
+  size_t num_read;
+  while ((num_read = fread(buffer, sizeof(int16_t), kSamplesPer10Ms, file)) >
+         0) {
+    file_audio.insert(file_audio.end(), buffer, buffer + num_read);
+  }
+  fclose(file);
+  ASSERT_FALSE(file_audio.empty()) << file_name << " is empty";
+  audio->resize(kNum10MsBlocks * kSamplesPer10Ms * num_channels);
+  for (size_t i = 0; i < audio->size(); ++i)
+    (*audio)[i] = file_audio[i % file_audio.size()];
+}
+
+// Returns true for the packets to drop, about |loss_rate| of them. The losses
+// are the same from run to run.
+bool IsLost(uint32_t* random, double loss_rate) {
+  *random = *random * 1103515245 + 12345;
+  return (*random >> 16) % 10000 < loss_rate * 10000;
+}
+
+// Encodes |audio| with |setup| and decodes the packets which are not lost,
+// as a receiver would: a packet following a lost one first recovers it with
+// FEC if it can, and conceals it otherwise.
+void RunCodec(const OpusSetup& setup,
+              const std::vector<int16_t>& audio,
+              CodecTimes* times) {
+  AudioEncoderOpus::Config config;
+  config.num_channels = setup.num_channels;
+  config.application = setup.num_channels == 1 ? AudioEncoderOpus::kVoip
+                                               : AudioEncoderOpus::kAudio;
+  config.complexity = setup.complexity;
+  config.bitrate_bps = setup.bitrate_bps;
+  config.frame_size_ms = setup.frame_size_ms;
+  config.fec_enabled = setup.fec_enabled;
+  config.dtx_enabled = setup.dtx_enabled;
+  AudioEncoderOpus encoder(config);
+  encoder.SetProjectedPacketLossRate(setup.loss_rate);
+  AudioDecoderOpus decoder(setup.num_channels);
+  ASSERT_EQ(0, decoder.Init());
+
+  const size_t max_encoded_bytes = encoder.MaxEncodedBytes();
+  rtc::scoped_ptr<uint8_t[]> encoded(new uint8_t[max_encoded_bytes]);
+  const size_t max_decoded_samples =
+      kMaxFrameSizeMs * kSampleRateHz / 1000 * setup.num_channels;
+  rtc::scoped_ptr<int16_t[]> decoded(new int16_t[max_decoded_samples]);
+  const size_t max_decoded_bytes = max_decoded_samples * sizeof(int16_t);
+  times->encode_packet_us.reserve(kNum10MsBlocks);
+  times->decode_packet_us.reserve(kNum10MsBlocks);
+
+  uint32_t random = 17;
+  bool previous_lost = false;
+  int blocks_in_packet = 0;
+  int64_t packet_us = 0;
+  for (int i = 0; i < kNum10MsBlocks; ++i) {
+    const int16_t* block = &audio[i * kSamplesPer10Ms * setup.num_channels];
+    int64_t start_us = TickTime::MicrosecondTimestamp();
+    AudioEncoder::EncodedInfo info =
+        encoder.Encode(i * kSamplesPer10Ms, block, kSamplesPer10Ms,
+                       max_encoded_bytes, encoded.get());
+    int64_t elapsed_us = TickTime::MicrosecondTimestamp() - start_us;
+    times->encode_us += elapsed_us;
+    // The encoder buffers the blocks and codes them in the call for the last
+    // one of the packet, so the time per packet includes all of the calls.
+    packet_us += elapsed_us;
+    if (++blocks_in_packet == encoder.Num10MsFramesInNextPacket()) {
+      times->encode_packet_us.push_back(packet_us);
+      blocks_in_packet = 0;
+      packet_us = 0;
+    }
+    // No packet yet, or none to send during DTX.
+    if (info.encoded_bytes == 0)
+      continue;
+    if (IsLost(&random, setup.loss_rate)) {
+      previous_lost = true;
+      continue;
+    }
+
+    AudioDecoder::SpeechType speech_type;
+    if (previous_lost) {
+      start_us = TickTime::MicrosecondTimestamp();
+      if (decoder.PacketHasFec(encoded.get(), info.encoded_bytes)) {
+        EXPECT_GT(decoder.DecodeRedundant(encoded.get(), info.encoded_bytes,
+                                          kSampleRateHz, max_decoded_bytes,
+                                          decoded.get(), &speech_type),
+                  0);
+      } else {
+        EXPECT_GT(decoder.DecodePlc(1, decoded.get()), 0);
+      }
+      elapsed_us = TickTime::MicrosecondTimestamp() - start_us;
+      times->decode_us += elapsed_us;
+      times->decode_packet_us.push_back(elapsed_us);
+      previous_lost = false;
+    }
+    start_us = TickTime::MicrosecondTimestamp();
+    EXPECT_GT(decoder.Decode(encoded.get(), info.encoded_bytes, kSampleRateHz,
+                             max_decoded_bytes, decoded.get(), &speech_type),
+              0);
+    elapsed_us = TickTime::MicrosecondTimestamp() - start_us;
+    times->decode_us += elapsed_us;
+    times->decode_packet_us.push_back(elapsed_us);
+  }
+}
+
+// Returns the |percent|th percentile of |values|, which it sorts.
+int64_t Percentile(std::vector<int64_t>* values, int percent) {
+  if (values->empty())
+    return 0;
+  std::sort(values->begin(), values->end());
+  return (*values)[(values->size() - 1) * percent / 100];
+}
+
+void PrintTimes(const std::string& measurement,
+                const std::string& trace,
+                int64_t total_us,
+                std::vector<int64_t>* packet_us) {
+  // How many times faster than real time; 0 if it took no measurable time.
+  const double real_time_factor =
+      total_us > 0 ? kDurationSec * 1e6 / total_us : 0;
+  test::PrintResult(measurement + "_real_time_factor", "", trace,
+                    real_time_factor, "x", false);
+  const int kPercents[] = {50, 90, 99};
+  for (int percent : kPercents) {
+    std::stringstream ss;
+    ss << measurement << "_packet_p" << percent;
+    test::PrintResult(ss.str(), "", trace, Percentile(packet_us, percent),
+                      "us", false);
+  }
+  test::PrintResult(measurement + "_packet_max", "", trace,
+                    packet_us->empty() ? 0 : packet_us->back(), "us", false);
+}
+
+// Runs the encoder and decoder of |setup| over a minute of audio and prints
+// the real-time factor and percentiles of the time per packet of each.
+void MeasureCodec(const OpusSetup& setup, const std::string& trace) {
+  std::vector<int16_t> audio;
+  ASSERT_NO_FATAL_FAILURE(ReadInput(setup.num_channels, &audio));
+  CodecTimes times;
+  RunCodec(setup, audio, &times);
+  PrintTimes("opus_encode", trace, times.encode_us, &times.encode_packet_us);
+  PrintTimes("opus_decode", trace, times.decode_us, &times.decode_packet_us);
+}
+
+// One thread of the concurrency measurement; runs its own encoder and
+// decoder once over the shared input.
+class CodecThread {
+ public:
+  CodecThread(const OpusSetup& setup, const std::vector<int16_t>* audio)
+      : setup_(setup), audio_(audio), elapsed_us_(0) {}
+
+  static bool Run(void* obj) {
+    CodecThread* codec_thread = static_cast<CodecThread*>(obj);
+    const int64_t start_us = TickTime::MicrosecondTimestamp();
+    CodecTimes times;
+    RunCodec(codec_thread->setup_, *codec_thread->audio_, &times);
+    codec_thread->elapsed_us_ = TickTime::MicrosecondTimestamp() - start_us;
+    return false;
+  }
+
+  int64_t elapsed_us() const { return elapsed_us_; }
+
+ private:
+  const OpusSetup setup_;
+  const std::vector<int16_t>* const audio_;
+  int64_t elapsed_us_;
+};
+
+// Runs one encoder and decoder pair per core at once and prints how many
+// pairs each core would run in real time.
+void MeasureInstancesPerCore(const OpusSetup& setup,
+                             const std::string& trace) {
+  const int num_cores = CpuInfo::DetectNumberOfCores();
+  std::vector<int16_t> audio;
+  ASSERT_NO_FATAL_FAILURE(ReadInput(setup.num_channels, &audio));
+  std::vector<CodecThread*> codec_threads;
+  std::vector<ThreadWrapper*> threads;
+  for (int i = 0; i < num_cores; ++i) {
+    codec_threads.push_back(new CodecThread(setup, &audio));
+    threads.push_back(ThreadWrapper::CreateThread(
+        &CodecThread::Run, codec_threads.back(), "OpusPerfThread").release());
+  }
+  for (ThreadWrapper* thread : threads)
+    EXPECT_TRUE(thread->Start());
+  int64_t slowest_us = 0;
+  for (int i = 0; i < num_cores; ++i) {
+    EXPECT_TRUE(threads[i]->Stop());
+    slowest_us = std::max(slowest_us, codec_threads[i]->elapsed_us());
+    delete threads[i];
+    delete codec_threads[i];
+  }
+  // Each core ran one pair, |kDurationSec| of audio, in |slowest_us| at most.
+  test::PrintResult("opus_instances_per_core", "", trace,
+                    slowest_us > 0 ? kDurationSec * 1e6 / slowest_us : 0,
+                    "instances", false);
+}
+
+}  // namespace
+
+TEST(OpusPerfTest, Complexity) {
+  OpusSetup setup;
+  for (setup.complexity = 0; setup.complexity <= 10; ++setup.complexity) {
+    std::stringstream trace;
+    trace << "complexity_" << setup.complexity;
+    MeasureCodec(setup, trace.str());
+  }
+}
+
+TEST(OpusPerfTest, Bitrate) {
+  const int kBitratesBps[] = {8000, 16000, 32000, 64000, 128000};
+  OpusSetup setup;
+  for (int bitrate_bps : kBitratesBps) {
+    setup.bitrate_bps = bitrate_bps;
+    std::stringstream trace;
+    trace << bitrate_bps / 1000 << "_kbps";
+    MeasureCodec(setup, trace.str());
+  }
+}
+
+TEST(OpusPerfTest, FrameSize) {
+  const int kFrameSizesMs[] = {10, 20, 40, 60};
+  OpusSetup setup;
+  for (int frame_size_ms : kFrameSizesMs) {
+    setup.frame_size_ms = frame_size_ms;
+    std::stringstream trace;
+    trace << frame_size_ms << "_ms";
+    MeasureCodec(setup, trace.str());
+  }
+}
+
+TEST(OpusPerfTest, Stereo) {
+  OpusSetup setup;
+  setup.num_channels = 2;
+  setup.bitrate_bps = 64000;
+  MeasureCodec(setup, "stereo_64_kbps");
+}
+
+TEST(OpusPerfTest, FecDtxAndConcealment) {
+  const double kLossRates[] = {0.0, 0.05, 0.2};
+  for (double loss_rate : kLossRates) {
+    const int loss_percent = static_cast<int>(loss_rate * 100 + 0.5);
+    OpusSetup setup;
+    setup.loss_rate = loss_rate;
+    std::stringstream trace;
+    trace << loss_percent << "_percent_loss";
+    MeasureCodec(setup, "plc_" + trace.str());
+    setup.fec_enabled = true;
+    MeasureCodec(setup, "fec_" + trace.str());
+  }
+  OpusSetup setup;
+  setup.dtx_enabled = true;
+  MeasureCodec(setup, "dtx");
+}
+
+TEST(OpusPerfTest, InstancesPerCore) {
+  const int kComplexities[] = {0, 5, 9, 10};
+  OpusSetup setup;
+  for (int complexity : kComplexities) {
+    setup.complexity = complexity;
+    std::stringstream trace;
+    trace << "mono_32_kbps_complexity_" << complexity;
+    MeasureInstancesPerCore(setup, trace.str());
+  }
+  setup.num_channels = 2;
+  setup.bitrate_bps = 64000;
+  setup.complexity = 9;
+  MeasureInstancesPerCore(setup, "stereo_64_kbps_complexity_9");
+}
+
+}  // namespace webrtc
@@ -0,0 +1,401 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/main/interface/audio_transcoder.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_audio/resampler/include/push_resampler.h"
+#include "webrtc/modules/audio_coding/main/acm2/acm_codec_database.h"
+#include "webrtc/modules/audio_coding/main/acm2/codec_owner.h"
+#include "webrtc/modules/audio_coding/main/acm2/codec_pool.h"
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/modules/rtp_rtcp/interface/rtp_header_parser.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/system_wrappers/interface/worker_pool.h"
+
+namespace webrtc {
+
+namespace {
+
+const size_t kRtpHeaderLength = 12;
+
+bool IsSpeechCodec(const CodecInst& codec) {
+  return STR_CASE_CMP(codec.plname, "CN") &&
+         STR_CASE_CMP(codec.plname, "red") &&
+         STR_CASE_CMP(codec.plname, "telephone-event");
+}
+
+// Converts |samples_per_channel| samples of |in_channels| channels to
+// |out_channels| channels. Mono is the average of all input channels, and
+// stereo is made from the first two input channels or a copy of mono input.
+void Remix(const int16_t* in,
+           int samples_per_channel,
+           int in_channels,
+           int out_channels,
+           int16_t* out) {
+  for (int i = 0; i < samples_per_channel; ++i) {
+    const int16_t* in_sample = &in[i * in_channels];
+    if (out_channels == 1) {
+      int32_t sum = 0;
+      for (int j = 0; j < in_channels; ++j)
+        sum += in_sample[j];
+      out[i] = static_cast<int16_t>(sum / in_channels);
+    } else {
+      out[2 * i] = in_sample[0];
+      out[2 * i + 1] = in_sample[in_channels > 1 ? 1 : 0];
+    }
+  }
+}
+
+class TranscoderSession : public AudioTranscoder::Session {
+ public:
+  TranscoderSession(const AudioTranscoder::SessionConfig& config,
+                    const NetEq::Config& neteq_config,
+                    acm2::CodecPool* pool);
+  ~TranscoderSession() override;
+
+  // Registers the receive codecs and sets up the encoder. Returns false if
+  // NetEq doesn't accept one of the receive codecs.
+  bool Init(const AudioTranscoder::SessionConfig& config);
+
+  int InsertPacket(const uint8_t* packet,
+                   size_t length,
+                   int64_t arrival_time_ms) override;
+  int NetworkStatistics(NetEqNetworkStatistics* stats) override;
+  int num_packets_sent() const override { return num_packets_sent_; }
+
+  // Decodes 10 ms of audio and encodes it, and sends a packet if the encoder
+  // produces one. Returns false on failure.
+  bool Process();
+
+ private:
+  struct ReceiveCodec {
+    uint8_t payload_type;
+    NetEqDecoder codec;
+    // NULL for codecs which NetEq decodes without a decoder object.
+    AudioDecoder* decoder;
+    int sample_rate_hz;
+  };
+
+  void SendPacket(const AudioEncoder::EncodedInfo& info);
+
+  acm2::CodecPool* const pool_;
+  const CodecInst send_codec_;
+  const uint32_t ssrc_;
+  Transport* const transport_;
+  const int id_;
+  const rtc::scoped_ptr<RtpHeaderParser> rtp_parser_;
+  rtc::scoped_ptr<NetEq> neteq_;
+  std::vector<ReceiveCodec> receive_codecs_;
+  acm2::CodecOwner* encoder_;
+  PushResampler<int16_t> resampler_;
+  uint16_t sequence_number_;
+  uint32_t encoder_timestamp_;
+  // The next packet starts a talkspurt and gets the marker bit.
+  bool marker_;
+  int num_packets_sent_;
+  // Buffers for one 10 ms block of audio, and for the outgoing packet.
+  int16_t decoded_[AudioFrame::kMaxDataSizeSamples];
+  int16_t remixed_[AudioFrame::kMaxDataSizeSamples];
+  int16_t resampled_[AudioFrame::kMaxDataSizeSamples];
+  std::vector<uint8_t> packet_;
+
+  DISALLOW_COPY_AND_ASSIGN(TranscoderSession);
+};
+
+TranscoderSession::TranscoderSession(
+    const AudioTranscoder::SessionConfig& config,
+    const NetEq::Config& neteq_config,
+    acm2::CodecPool* pool)
+    : pool_(pool),
+      send_codec_(config.send_codec),
+      ssrc_(config.ssrc),
+      transport_(config.transport),
+      id_(config.id),
+      rtp_parser_(RtpHeaderParser::Create()),
+      neteq_(NetEq::Create(neteq_config)),
+      encoder_(NULL),
+      sequence_number_(config.first_sequence_number),
+      encoder_timestamp_(config.first_timestamp),
+      marker_(true),
+      num_packets_sent_(0) {
+}
+
+TranscoderSession::~TranscoderSession() {
+  // NetEq must be gone before its external decoders are used elsewhere.
+  neteq_.reset();
+  for (size_t i = 0; i < receive_codecs_.size(); ++i) {
+    if (receive_codecs_[i].decoder)
+      pool_->ReleaseDecoder(receive_codecs_[i].codec,
+                            receive_codecs_[i].decoder);
+  }
+  if (encoder_)
+    pool_->ReleaseEncoder(send_codec_, encoder_);
+}
+
+bool TranscoderSession::Init(const AudioTranscoder::SessionConfig& config) {
+  receive_codecs_.reserve(config.receive_codecs.size());
+  for (size_t i = 0; i < config.receive_codecs.size(); ++i) {
+    const CodecInst& inst = config.receive_codecs[i];
+    const int codec_id = acm2::ACMCodecDB::ReceiverCodecNumber(inst);
+    if (codec_id < 0 || !acm2::ACMCodecDB::ValidPayloadType(inst.pltype))
+      return false;
+    ReceiveCodec codec;
+    codec.payload_type = static_cast<uint8_t>(inst.pltype);
+    codec.codec = acm2::ACMCodecDB::NetEQDecoders()[codec_id];
+    // Make sure the right decoder is registered for Opus.
+    if (codec.codec == kDecoderOpus && inst.channels == 2)
+      codec.codec = kDecoderOpus_2ch;
+    codec.sample_rate_hz = inst.plfreq;
+    codec.decoder = pool_->AcquireDecoder(codec.codec);
+    receive_codecs_.push_back(codec);
+    const int error =
+        codec.decoder
+            ? neteq_->RegisterExternalDecoder(codec.decoder, codec.codec,
+                                              codec.payload_type)
+            : neteq_->RegisterPayloadType(codec.codec, codec.payload_type);
+    if (error != NetEq::kOK)
+      return false;
+  }
+
+  encoder_ = pool_->AcquireEncoder(send_codec_);
+  encoder_->ChangeCngAndRed(config.send_cng_payload_type, config.vad_mode, -1);
+  packet_.resize(kRtpHeaderLength + encoder_->Encoder()->MaxEncodedBytes());
+  return true;
+}
+
+int TranscoderSession::InsertPacket(const uint8_t* packet,
+                                    size_t length,
+                                    int64_t arrival_time_ms) {
+  WebRtcRTPHeader rtp_header;
+  if (!rtp_parser_->Parse(packet, length, &rtp_header.header))
+    return -1;
+  const ReceiveCodec* codec = NULL;
+  for (size_t i = 0; i < receive_codecs_.size(); ++i) {
+    if (receive_codecs_[i].payload_type == rtp_header.header.payloadType) {
+      codec = &receive_codecs_[i];
+      break;
+    }
+  }
+  if (!codec)
+    return -1;
+  rtp_header.frameType = kAudioFrameSpeech;
+  rtp_header.type.Audio.numEnergy = 0;
+  rtp_header.type.Audio.channel = 1;
+  rtp_header.type.Audio.isCNG = false;
+  rtp_header.ntp_time_ms = 0;
+  const size_t header_length =
+      rtp_header.header.headerLength + rtp_header.header.paddingLength;
+  if (header_length > length)
+    return -1;
+  // Like AcmReceiver, counts the arrival time in samples of the codec.
+  const uint32_t receive_timestamp =
+      static_cast<uint32_t>(arrival_time_ms * (codec->sample_rate_hz / 1000));
+  return neteq_->InsertPacket(rtp_header,
+                              packet + rtp_header.header.headerLength,
+                              length - header_length,
+                              receive_timestamp) == NetEq::kOK ? 0 : -1;
+}
+
+int TranscoderSession::NetworkStatistics(NetEqNetworkStatistics* stats) {
+  return neteq_->NetworkStatistics(stats);
+}
+
+bool TranscoderSession::Process() {
+  uint32_t playout_timestamp;
+  if (!neteq_->GetPlayoutTimestamp(&playout_timestamp)) {
+    // Nothing received yet.
+    return true;
+  }
+  int samples_per_channel;
+  int num_channels;
+  NetEqOutputType type;
+  if (neteq_->GetAudio(AudioFrame::kMaxDataSizeSamples, decoded_,
+                       &samples_per_channel, &num_channels,
+                       &type) != NetEq::kOK) {
+    return false;
+  }
+
+  AudioEncoder* encoder = encoder_->Encoder();
+  const int channels = encoder->NumChannels();
+  const int16_t* audio = decoded_;
+  if (num_channels != channels) {
+    Remix(decoded_, samples_per_channel, num_channels, channels, remixed_);
+    audio = remixed_;
+  }
+  // NetEq always returns 10 ms of audio.
+  const int decoded_rate_hz = samples_per_channel * 100;
+  const int encoder_rate_hz = encoder->SampleRateHz();
+  if (decoded_rate_hz != encoder_rate_hz) {
+    if (resampler_.InitializeIfNeeded(decoded_rate_hz, encoder_rate_hz,
+                                      channels) != 0 ||
+        resampler_.Resample(audio, samples_per_channel * channels, resampled_,
+                            AudioFrame::kMaxDataSizeSamples) < 0) {
+      return false;
+    }
+    audio = resampled_;
+  }
+
+  const size_t max_encoded_bytes = encoder->MaxEncodedBytes();
+  if (packet_.size() < kRtpHeaderLength + max_encoded_bytes)
+    packet_.resize(kRtpHeaderLength + max_encoded_bytes);
+  const AudioEncoder::EncodedInfo info = encoder->Encode(
+      encoder_timestamp_, audio, encoder_rate_hz / 100, max_encoded_bytes,
+      &packet_[kRtpHeaderLength]);
+  encoder_timestamp_ += encoder->RtpTimestampRateHz() / 100;
+  if (info.encoded_bytes > 0 || info.send_even_if_empty)
+    SendPacket(info);
+  return true;
+}
+
+void TranscoderSession::SendPacket(const AudioEncoder::EncodedInfo& info) {
+  uint8_t* header = &packet_[0];
+  header[0] = 0x80;  // Version 2.
+  header[1] = static_cast<uint8_t>(info.payload_type) | (marker_ ? 0x80 : 0);
+  ByteWriter<uint16_t>::WriteBigEndian(&header[2], sequence_number_++);
+  ByteWriter<uint32_t>::WriteBigEndian(&header[4], info.encoded_timestamp);
+  ByteWriter<uint32_t>::WriteBigEndian(&header[8], ssrc_);
+  transport_->SendPacket(id_, header, kRtpHeaderLength + info.encoded_bytes);
+  ++num_packets_sent_;
+  // Comfort noise ends the talkspurt.
+  marker_ = !info.speech;
+}
+
+class AudioTranscoderImpl : public AudioTranscoder {
+ public:
+  explicit AudioTranscoderImpl(const Config& config);
+  ~AudioTranscoderImpl() override;
+
+  Session* CreateSession(const SessionConfig& config) override;
+  void DestroySession(Session* session) override;
+  int num_sessions() const override {
+    return static_cast<int>(sessions_.size());
+  }
+  int num_threads() const override {
+    return static_cast<int>(shard_errors_.size());
+  }
+  int num_codecs_created() const override { return pool_.num_created(); }
+  int Process() override;
+
+ private:
+  static void ProcessShard(void* context, size_t shard);
+
+  // Runs the sessions of |shard| and returns the number of failures.
+  int ProcessSessions(size_t shard);
+
+  const NetEq::Config neteq_config_;
+  // Declared before |sessions_|, which give their codecs back to it when they
+  // are destroyed.
+  acm2::CodecPool pool_;
+  ScopedVector<TranscoderSession> sessions_;
+  // Runs shard i on its thread i; the calling thread runs shard 0.
+  WorkerPool thread_pool_;
+  // The number of failures of each shard in the last tick.
+  std::vector<int> shard_errors_;
+
+  DISALLOW_COPY_AND_ASSIGN(AudioTranscoderImpl);
+};
+
+// The ticks come at the pace of the audio, like on a device thread, so the
+// pool's threads run at real-time priority. Whatever threads could be started
+// are used.
+AudioTranscoderImpl::AudioTranscoderImpl(const Config& config)
+    : neteq_config_(config.neteq_config),
+      thread_pool_(config.num_threads > 1 ? config.num_threads - 1 : 0,
+                   "AudioTranscoderThread", kRealtimePriority),
+      shard_errors_(thread_pool_.num_threads() + 1, 0) {
+}
+
+AudioTranscoderImpl::~AudioTranscoderImpl() {
+}
+
+AudioTranscoder::Session* AudioTranscoderImpl::CreateSession(
+    const SessionConfig& config) {
+  const CodecInst& send_codec = config.send_codec;
+  if (!config.transport || !IsSpeechCodec(send_codec) ||
+      acm2::ACMCodecDB::CodecNumber(send_codec) < 0 ||
+      send_codec.channels < 1 || send_codec.channels > 2) {
+    return NULL;
+  }
+  if (config.send_cng_payload_type != -1 &&
+      (send_codec.channels != 1 ||
+       !acm2::ACMCodecDB::ValidPayloadType(config.send_cng_payload_type))) {
+    return NULL;
+  }
+  rtc::scoped_ptr<TranscoderSession> session(
+      new TranscoderSession(config, neteq_config_, &pool_));
+  if (!session->Init(config))
+    return NULL;
+  sessions_.push_back(session.release());
+  return sessions_.back();
+}
+
+void AudioTranscoderImpl::DestroySession(Session* session) {
+  for (ScopedVector<TranscoderSession>::iterator it = sessions_.begin();
+       it != sessions_.end(); ++it) {
+    if (*it == session) {
+      sessions_.erase(it);
+      return;
+    }
+  }
+}
+
+int AudioTranscoderImpl::Process() {
+  thread_pool_.RunOnEachThread(&AudioTranscoderImpl::ProcessShard, this);
+  int num_errors = 0;
+  for (int shard_errors : shard_errors_)
+    num_errors += shard_errors;
+  return num_errors;
+}
+
+void AudioTranscoderImpl::ProcessShard(void* context, size_t shard) {
+  AudioTranscoderImpl* transcoder = static_cast<AudioTranscoderImpl*>(context);
+  transcoder->shard_errors_[shard] = transcoder->ProcessSessions(shard);
+}
+
+int AudioTranscoderImpl::ProcessSessions(size_t shard) {
+  const size_t num_sessions = sessions_.size();
+  const size_t num_shards = shard_errors_.size();
+  const size_t begin = num_sessions * shard / num_shards;
+  const size_t end = num_sessions * (shard + 1) / num_shards;
+  int num_errors = 0;
+  for (size_t i = begin; i < end; ++i) {
+    if (!sessions_[i]->Process())
+      ++num_errors;
+  }
+  return num_errors;
+}
+
+}  // namespace
+
+AudioTranscoder::SessionConfig::SessionConfig()
+    : send_cng_payload_type(-1),
+      vad_mode(VADNormal),
+      ssrc(0),
+      first_sequence_number(0),
+      first_timestamp(0),
+      transport(NULL),
+      id(0) {
+  memset(&send_codec, 0, sizeof(send_codec));
+}
+
+AudioTranscoder::SessionConfig::~SessionConfig() = default;
+
+AudioTranscoder* AudioTranscoder::Create(const Config& config) {
+  return new AudioTranscoderImpl(config);
+}
+
+}  // namespace webrtc
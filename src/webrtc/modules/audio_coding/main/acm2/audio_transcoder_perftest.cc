@@ -0,0 +1,199 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/engine_configurations.h"
+#include "webrtc/modules/audio_coding/main/acm2/codec_owner.h"
+#include "webrtc/modules/audio_coding/main/interface/audio_transcoder.h"
+#include "webrtc/modules/audio_coding/neteq/tools/resample_input_audio_file.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kNumSessions = 100;
+const int kDurationMs = 5000;
+const int kFileRateHz = 32000;
+
+const CodecInst kPcmu = {0, "PCMU", 8000, 160, 1, 64000};
+#ifdef WEBRTC_CODEC_G722
+const CodecInst kG722 = {9, "G722", 16000, 320, 1, 64000};
+#endif
+#ifdef WEBRTC_CODEC_ISAC
+const CodecInst kIsac = {103, "ISAC", 16000, 480, 1, 32000};
+#endif
+#ifdef WEBRTC_CODEC_OPUS
+const CodecInst kOpus = {120, "opus", 48000, 960, 1, 32000};
+#endif
+
+class CountingTransport : public Transport {
+ public:
+  CountingTransport() : num_packets_(0) {}
+
+  // Only called from the thread which runs Process().
+  int SendPacket(int channel, const void* data, size_t len) override {
+    ++num_packets_;
+    return static_cast<int>(len);
+  }
+  int SendRTCPPacket(int channel, const void* data, size_t len) override {
+    return -1;
+  }
+
+  int num_packets() const { return num_packets_; }
+
+ private:
+  int num_packets_;
+};
+
+// An RTP packet which is due for insertion at |time_ms|.
+struct InputPacket {
+  int time_ms;
+  std::vector<uint8_t> data;
+};
+
+// Encodes |kDurationMs| of speech with |codec| into RTP packets.
+void EncodeInput(const CodecInst& codec, std::vector<InputPacket>* packets) {
+  test::ResampleInputAudioFile input(
+      test::ResourcePath("audio_coding/testfile32kHz", "pcm"), kFileRateHz);
+  acm2::CodecOwner codec_owner;
+  codec_owner.SetEncoders(codec, -1, VADNormal, -1);
+  AudioEncoder* encoder = codec_owner.Encoder();
+  const int samples_per_10ms = encoder->SampleRateHz() / 100;
+  std::vector<int16_t> audio(samples_per_10ms);
+  std::vector<uint8_t> encoded(encoder->MaxEncodedBytes());
+  uint32_t timestamp = 0;
+  uint16_t sequence_number = 0;
+  for (int time_ms = 0; time_ms < kDurationMs; time_ms += 10) {
+    ASSERT_TRUE(input.Read(samples_per_10ms, encoder->SampleRateHz(),
+                           &audio[0]));
+    const AudioEncoder::EncodedInfo info =
+        encoder->Encode(timestamp, &audio[0], samples_per_10ms,
+                        encoded.size(), &encoded[0]);
+    timestamp += encoder->RtpTimestampRateHz() / 100;
+    if (info.encoded_bytes == 0)
+      continue;
+    InputPacket packet;
+    packet.time_ms = time_ms;
+    packet.data.resize(12 + info.encoded_bytes);
+    packet.data[0] = 0x80;
+    packet.data[1] = static_cast<uint8_t>(info.payload_type);
+    ByteWriter<uint16_t>::WriteBigEndian(&packet.data[2], sequence_number++);
+    ByteWriter<uint32_t>::WriteBigEndian(&packet.data[4],
+                                         info.encoded_timestamp);
+    ByteWriter<uint32_t>::WriteBigEndian(&packet.data[8], 1);
+    memcpy(&packet.data[12], &encoded[0], info.encoded_bytes);
+    packets->push_back(packet);
+  }
+}
+
+// Transcodes the same stream in |kNumSessions| sessions on one thread, and
+// reports how many sessions in real time one core can handle.
+void RunCodecPair(const std::string& name,
+                  const CodecInst& receive_codec,
+                  const CodecInst& send_codec) {
+  std::vector<InputPacket> packets;
+  EncodeInput(receive_codec, &packets);
+  ASSERT_FALSE(packets.empty());
+
+  AudioTranscoder::Config config;
+  config.neteq_config.sample_rate_hz = receive_codec.plfreq;
+  rtc::scoped_ptr<AudioTranscoder> transcoder(AudioTranscoder::Create(config));
+  CountingTransport transport;
+  std::vector<AudioTranscoder::Session*> sessions;
+  for (int i = 0; i < kNumSessions; ++i) {
+    AudioTranscoder::SessionConfig session_config;
+    session_config.receive_codecs.push_back(receive_codec);
+    session_config.send_codec = send_codec;
+    session_config.ssrc = i;
+    session_config.transport = &transport;
+    session_config.id = i;
+    sessions.push_back(transcoder->CreateSession(session_config));
+    ASSERT_TRUE(sessions.back() != NULL);
+  }
+
+  size_t next_packet = 0;
+  int num_errors = 0;
+  const int64_t start_us = TickTime::MicrosecondTimestamp();
+  for (int time_ms = 0; time_ms < kDurationMs; time_ms += 10) {
+    for (; next_packet < packets.size() &&
+           packets[next_packet].time_ms <= time_ms;
+         ++next_packet) {
+      const std::vector<uint8_t>& data = packets[next_packet].data;
+      for (int i = 0; i < kNumSessions; ++i)
+        sessions[i]->InsertPacket(&data[0], data.size(), time_ms);
+    }
+    num_errors += transcoder->Process();
+  }
+  const int64_t elapsed_us = TickTime::MicrosecondTimestamp() - start_us;
+  EXPECT_EQ(0, num_errors);
+  EXPECT_GT(transport.num_packets(), 0);
+
+  const double audio_us = 1000.0 * kDurationMs * kNumSessions;
+  test::PrintResult("audio_transcoder_realtime_sessions_per_core", "", name,
+                    audio_us / elapsed_us, "sessions", true);
+}
+
+}  // namespace
+
+TEST(AudioTranscoderPerfTest, PcmuToL16) {
+  const CodecInst kL16 = {107, "L16", 8000, 160, 1, 128000};
+  RunCodecPair("pcmu_to_l16", kPcmu, kL16);
+}
+
+#ifdef WEBRTC_CODEC_G722
+TEST(AudioTranscoderPerfTest, PcmuToG722) {
+  RunCodecPair("pcmu_to_g722", kPcmu, kG722);
+}
+
+TEST(AudioTranscoderPerfTest, G722ToPcmu) {
+  RunCodecPair("g722_to_pcmu", kG722, kPcmu);
+}
+#endif
+
+#ifdef WEBRTC_CODEC_ISAC
+TEST(AudioTranscoderPerfTest, PcmuToIsac) {
+  RunCodecPair("pcmu_to_isac", kPcmu, kIsac);
+}
+
+TEST(AudioTranscoderPerfTest, IsacToPcmu) {
+  RunCodecPair("isac_to_pcmu", kIsac, kPcmu);
+}
+#endif
+
+#ifdef WEBRTC_CODEC_OPUS
+TEST(AudioTranscoderPerfTest, PcmuToOpus) {
+  RunCodecPair("pcmu_to_opus", kPcmu, kOpus);
+}
+
+TEST(AudioTranscoderPerfTest, OpusToPcmu) {
+  RunCodecPair("opus_to_pcmu", kOpus, kPcmu);
+}
+
+#ifdef WEBRTC_CODEC_ISAC
+TEST(AudioTranscoderPerfTest, IsacToOpus) {
+  RunCodecPair("isac_to_opus", kIsac, kOpus);
+}
+
+TEST(AudioTranscoderPerfTest, OpusToIsac) {
+  RunCodecPair("opus_to_isac", kOpus, kIsac);
+}
+#endif
+#endif
+
+}  // namespace webrtc
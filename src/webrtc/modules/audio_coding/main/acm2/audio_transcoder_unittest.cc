@@ -0,0 +1,264 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/main/interface/audio_transcoder.h"
+
+#include <math.h>
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_coding/codecs/g711/include/g711_interface.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+
+namespace webrtc {
+
+namespace {
+
+const CodecInst kPcmu = {0, "PCMU", 8000, 160, 1, 64000};
+const CodecInst kL16 = {96, "L16", 16000, 320, 1, 256000};
+const uint32_t kSsrc = 0x12345678;
+const uint16_t kFirstSequenceNumber = 65530;  // Wraps around.
+const uint32_t kFirstTimestamp = 1000;
+const int kPacketMs = 20;
+const int kPacketSamples = 160;  // 20 ms at 8 kHz.
+const double kAmplitude = 8000.0;
+
+// Keeps the packets of each session, indexed by session id. Sessions run on
+// different threads but each writes only to its own entry.
+class PacketCollector : public Transport {
+ public:
+  explicit PacketCollector(int num_sessions) : packets_(num_sessions) {}
+
+  int SendPacket(int channel, const void* data, size_t len) override {
+    const uint8_t* packet = static_cast<const uint8_t*>(data);
+    packets_[channel].push_back(
+        std::vector<uint8_t>(packet, packet + len));
+    return static_cast<int>(len);
+  }
+
+  int SendRTCPPacket(int channel, const void* data, size_t len) override {
+    return -1;
+  }
+
+  const std::vector<std::vector<uint8_t> >& packets(int channel) const {
+    return packets_[channel];
+  }
+
+ private:
+  std::vector<std::vector<std::vector<uint8_t> > > packets_;
+};
+
+// Generates 20 ms PCMU packets of a 400 Hz tone.
+class PcmuSource {
+ public:
+  PcmuSource() : sequence_number_(0), timestamp_(0) {}
+
+  std::vector<uint8_t> NextPacket() {
+    std::vector<uint8_t> packet(12 + kPacketSamples);
+    packet[0] = 0x80;
+    packet[1] = static_cast<uint8_t>(kPcmu.pltype);
+    ByteWriter<uint16_t>::WriteBigEndian(&packet[2], sequence_number_++);
+    ByteWriter<uint32_t>::WriteBigEndian(&packet[4], timestamp_);
+    ByteWriter<uint32_t>::WriteBigEndian(&packet[8], 4711);
+    int16_t audio[kPacketSamples];
+    for (int i = 0; i < kPacketSamples; ++i) {
+      audio[i] = static_cast<int16_t>(
+          kAmplitude * sin(2 * M_PI * 400 * (timestamp_ + i) / 8000));
+    }
+    WebRtcG711_EncodeU(audio, kPacketSamples, &packet[12]);
+    timestamp_ += kPacketSamples;
+    return packet;
+  }
+
+ private:
+  uint16_t sequence_number_;
+  uint32_t timestamp_;
+};
+
+}  // namespace
+
+class AudioTranscoderTest : public ::testing::Test {
+ protected:
+  AudioTranscoderTest() : collector_(10) {}
+
+  void CreateTranscoder(int num_threads) {
+    AudioTranscoder::Config config;
+    config.num_threads = num_threads;
+    config.neteq_config.sample_rate_hz = 8000;
+    transcoder_.reset(AudioTranscoder::Create(config));
+  }
+
+  AudioTranscoder::SessionConfig PcmuToL16Config(int id) {
+    AudioTranscoder::SessionConfig config;
+    config.receive_codecs.push_back(kPcmu);
+    config.send_codec = kL16;
+    config.ssrc = kSsrc;
+    config.first_sequence_number = kFirstSequenceNumber;
+    config.first_timestamp = kFirstTimestamp;
+    config.transport = &collector_;
+    config.id = id;
+    return config;
+  }
+
+  // Inserts a packet into each session and runs 20 ms.
+  void RunPacket(const std::vector<AudioTranscoder::Session*>& sessions,
+                 PcmuSource* source,
+                 int64_t* time_ms) {
+    const std::vector<uint8_t> packet = source->NextPacket();
+    for (size_t i = 0; i < sessions.size(); ++i) {
+      EXPECT_EQ(0,
+                sessions[i]->InsertPacket(&packet[0], packet.size(), *time_ms));
+    }
+    for (int i = 0; i < kPacketMs / 10; ++i)
+      EXPECT_EQ(0, transcoder_->Process());
+    *time_ms += kPacketMs;
+  }
+
+  PacketCollector collector_;
+  rtc::scoped_ptr<AudioTranscoder> transcoder_;
+};
+
+TEST_F(AudioTranscoderTest, PcmuToL16) {
+  CreateTranscoder(1);
+  AudioTranscoder::Session* session =
+      transcoder_->CreateSession(PcmuToL16Config(0));
+  ASSERT_TRUE(session != NULL);
+
+  // Nothing is sent before the first packet arrives.
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(0, transcoder_->Process());
+  EXPECT_EQ(0, session->num_packets_sent());
+
+  const std::vector<AudioTranscoder::Session*> sessions(1, session);
+  PcmuSource source;
+  int64_t time_ms = 0;
+  const int kNumPackets = 100;
+  for (int i = 0; i < kNumPackets; ++i)
+    RunPacket(sessions, &source, &time_ms);
+
+  const std::vector<std::vector<uint8_t> >& packets = collector_.packets(0);
+  ASSERT_EQ(kNumPackets, static_cast<int>(packets.size()));
+  EXPECT_EQ(kNumPackets, session->num_packets_sent());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    const std::vector<uint8_t>& packet = packets[i];
+    ASSERT_EQ(12u + kL16.pacsize * sizeof(int16_t), packet.size());
+    EXPECT_EQ(0x80, packet[0]);
+    // Only the first packet starts a talkspurt.
+    EXPECT_EQ(i == 0, (packet[1] & 0x80) != 0);
+    EXPECT_EQ(kL16.pltype, packet[1] & 0x7f);
+    EXPECT_EQ(static_cast<uint16_t>(kFirstSequenceNumber + i),
+              ByteReader<uint16_t>::ReadBigEndian(&packet[2]));
+    EXPECT_EQ(kFirstTimestamp + i * kL16.pacsize,
+              ByteReader<uint32_t>::ReadBigEndian(&packet[4]));
+    EXPECT_EQ(kSsrc, ByteReader<uint32_t>::ReadBigEndian(&packet[8]));
+  }
+
+  // Once NetEq has settled, the tone comes through with about its level.
+  const std::vector<uint8_t>& last = packets.back();
+  double energy = 0.0;
+  for (int i = 0; i < kL16.pacsize; ++i) {
+    const double sample = static_cast<int16_t>(
+        ByteReader<uint16_t>::ReadBigEndian(&last[12 + 2 * i]));
+    energy += sample * sample;
+  }
+  const double rms = sqrt(energy / kL16.pacsize);
+  EXPECT_NEAR(kAmplitude / sqrt(2.0), rms, 0.1 * kAmplitude);
+}
+
+TEST_F(AudioTranscoderTest, RejectsUnknownPayloadType) {
+  CreateTranscoder(1);
+  AudioTranscoder::Session* session =
+      transcoder_->CreateSession(PcmuToL16Config(0));
+  ASSERT_TRUE(session != NULL);
+  PcmuSource source;
+  std::vector<uint8_t> packet = source.NextPacket();
+  packet[1] = 8;  // PCMA, which the session doesn't receive.
+  EXPECT_EQ(-1, session->InsertPacket(&packet[0], packet.size(), 0));
+  // Too short to be an RTP packet.
+  EXPECT_EQ(-1, session->InsertPacket(&packet[0], 8, 0));
+}
+
+TEST_F(AudioTranscoderTest, RejectsUnsupportedSessions) {
+  CreateTranscoder(1);
+  AudioTranscoder::SessionConfig config = PcmuToL16Config(0);
+  const CodecInst kCn = {13, "CN", 8000, 240, 1, 0};
+  config.send_codec = kCn;
+  EXPECT_TRUE(transcoder_->CreateSession(config) == NULL);
+
+  config = PcmuToL16Config(0);
+  const CodecInst kUnknown = {100, "foo", 8000, 160, 1, 64000};
+  config.receive_codecs.push_back(kUnknown);
+  EXPECT_TRUE(transcoder_->CreateSession(config) == NULL);
+
+  // CNG needs a mono send codec.
+  config = PcmuToL16Config(0);
+  config.send_codec.channels = 2;
+  config.send_cng_payload_type = 98;
+  EXPECT_TRUE(transcoder_->CreateSession(config) == NULL);
+
+  EXPECT_EQ(0, transcoder_->num_sessions());
+}
+
+TEST_F(AudioTranscoderTest, ReusesCodecsOfDestroyedSessions) {
+  CreateTranscoder(1);
+  AudioTranscoder::Session* session =
+      transcoder_->CreateSession(PcmuToL16Config(0));
+  ASSERT_TRUE(session != NULL);
+  // One decoder and one encoder.
+  EXPECT_EQ(2, transcoder_->num_codecs_created());
+
+  PcmuSource source;
+  int64_t time_ms = 0;
+  RunPacket(std::vector<AudioTranscoder::Session*>(1, session), &source,
+            &time_ms);
+  transcoder_->DestroySession(session);
+  EXPECT_EQ(0, transcoder_->num_sessions());
+
+  session = transcoder_->CreateSession(PcmuToL16Config(1));
+  ASSERT_TRUE(session != NULL);
+  EXPECT_EQ(2, transcoder_->num_codecs_created());
+  // The reused codecs start from scratch: the new session sends the same
+  // packets as the first one.
+  PcmuSource new_source;
+  time_ms = 0;
+  RunPacket(std::vector<AudioTranscoder::Session*>(1, session), &new_source,
+            &time_ms);
+  ASSERT_EQ(1u, collector_.packets(0).size());
+  EXPECT_EQ(collector_.packets(0), collector_.packets(1));
+
+  // A second concurrent session needs codecs of its own.
+  EXPECT_TRUE(transcoder_->CreateSession(PcmuToL16Config(2)) != NULL);
+  EXPECT_EQ(4, transcoder_->num_codecs_created());
+}
+
+TEST_F(AudioTranscoderTest, RunsSessionsOnSeveralThreads) {
+  CreateTranscoder(3);
+  EXPECT_EQ(3, transcoder_->num_threads());
+  const int kNumSessions = 10;
+  std::vector<AudioTranscoder::Session*> sessions;
+  for (int i = 0; i < kNumSessions; ++i) {
+    sessions.push_back(transcoder_->CreateSession(PcmuToL16Config(i)));
+    ASSERT_TRUE(sessions.back() != NULL);
+  }
+  PcmuSource source;
+  int64_t time_ms = 0;
+  const int kNumPackets = 50;
+  for (int i = 0; i < kNumPackets; ++i)
+    RunPacket(sessions, &source, &time_ms);
+
+  // All sessions get the same input, so they send the same packets.
+  ASSERT_EQ(kNumPackets, static_cast<int>(collector_.packets(0).size()));
+  for (int i = 1; i < kNumSessions; ++i)
+    EXPECT_EQ(collector_.packets(0), collector_.packets(i));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/main/acm2/codec_pool.h"
+
+#include "webrtc/base/checks.h"
+#include "webrtc/modules/audio_coding/main/acm2/codec_owner.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+
+namespace webrtc {
+namespace acm2 {
+
+CodecPool::CodecPool()
+    : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      num_created_(0) {
+}
+
+CodecPool::~CodecPool() {
+  for (size_t i = 0; i < idle_encoders_.size(); ++i)
+    delete idle_encoders_[i].encoder;
+  for (size_t i = 0; i < idle_decoders_.size(); ++i)
+    delete idle_decoders_[i].decoder;
+}
+
+CodecOwner* CodecPool::AcquireEncoder(const CodecInst& speech_inst) {
+  {
+    CriticalSectionScoped cs(crit_.get());
+    for (size_t i = 0; i < idle_encoders_.size(); ++i) {
+      if (idle_encoders_[i].speech_inst == speech_inst) {
+        CodecOwner* encoder = idle_encoders_[i].encoder;
+        idle_encoders_[i] = idle_encoders_.back();
+        idle_encoders_.pop_back();
+        return encoder;
+      }
+    }
+    ++num_created_;
+  }
+  // Create the encoder outside the lock; it may take a while.
+  CodecOwner* encoder = new CodecOwner;
+  encoder->SetEncoders(speech_inst, -1, VADNormal, -1);
+  return encoder;
+}
+
+void CodecPool::ReleaseEncoder(const CodecInst& speech_inst,
+                               CodecOwner* encoder) {
+  DCHECK(encoder);
+  // Drop the audio of the finished session and the CNG on top of the speech
+  // encoder, which the next user configures anew.
+  encoder->SpeechEncoder()->Reset();
+  encoder->ChangeCngAndRed(-1, VADNormal, -1);
+  IdleEncoder idle = { speech_inst, encoder };
+  CriticalSectionScoped cs(crit_.get());
+  idle_encoders_.push_back(idle);
+}
+
+AudioDecoder* CodecPool::AcquireDecoder(NetEqDecoder codec) {
+  {
+    CriticalSectionScoped cs(crit_.get());
+    for (size_t i = 0; i < idle_decoders_.size(); ++i) {
+      if (idle_decoders_[i].codec == codec) {
+        AudioDecoder* decoder = idle_decoders_[i].decoder;
+        idle_decoders_[i] = idle_decoders_.back();
+        idle_decoders_.pop_back();
+        return decoder;
+      }
+    }
+  }
+  AudioDecoder* decoder = CreateAudioDecoder(codec);
+  if (!decoder)
+    return NULL;
+  decoder->Init();
+  CriticalSectionScoped cs(crit_.get());
+  ++num_created_;
+  return decoder;
+}
+
+void CodecPool::ReleaseDecoder(NetEqDecoder codec, AudioDecoder* decoder) {
+  DCHECK(decoder);
+  decoder->Init();
+  IdleDecoder idle = { codec, decoder };
+  CriticalSectionScoped cs(crit_.get());
+  idle_decoders_.push_back(idle);
+}
+
+int CodecPool::num_created() const {
+  CriticalSectionScoped cs(crit_.get());
+  return num_created_;
+}
+
+int CodecPool::num_idle() const {
+  CriticalSectionScoped cs(crit_.get());
+  return static_cast<int>(idle_encoders_.size() + idle_decoders_.size());
+}
+
+}  // namespace acm2
+}  // namespace webrtc
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_MAIN_ACM2_CODEC_POOL_H_
+#define WEBRTC_MODULES_AUDIO_CODING_MAIN_ACM2_CODEC_POOL_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/common_types.h"
+#include "webrtc/modules/audio_coding/neteq/audio_decoder_impl.h"
+
+namespace webrtc {
+
+class CriticalSectionWrapper;
+
+namespace acm2 {
+
+class CodecOwner;
+
+// Keeps the encoders and decoders of finished sessions, so that a new session
+// with the same codec reuses them instead of creating and initializing new
+// ones. Encoders are CodecOwners, so that CNG can be put on top of them.
+// All methods are thread-safe.
+class CodecPool {
+ public:
+  CodecPool();
+  ~CodecPool();
+
+  // Returns an encoder for |speech_inst|, which is reset if it has been used
+  // before. |speech_inst| must be a speech codec which
+  // ACMCodecDB::CodecNumber() accepts. The caller owns the encoder until it
+  // gives it back with ReleaseEncoder().
+  CodecOwner* AcquireEncoder(const CodecInst& speech_inst);
+  void ReleaseEncoder(const CodecInst& speech_inst, CodecOwner* encoder);
+
+  // Returns an initialized decoder for |codec|, or NULL if NetEq decodes
+  // |codec| without a decoder object, e.g., for RED and DTMF. The caller owns
+  // the decoder until it gives it back with ReleaseDecoder().
+  AudioDecoder* AcquireDecoder(NetEqDecoder codec);
+  void ReleaseDecoder(NetEqDecoder codec, AudioDecoder* decoder);
+
+  // The number of encoders and decoders which have been created so far, and
+  // the number of them which are in the pool.
+  int num_created() const;
+  int num_idle() const;
+
+ private:
+  struct IdleEncoder {
+    CodecInst speech_inst;
+    CodecOwner* encoder;
+  };
+
+  struct IdleDecoder {
+    NetEqDecoder codec;
+    AudioDecoder* decoder;
+  };
+
+  const rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+  std::vector<IdleEncoder> idle_encoders_ GUARDED_BY(crit_);
+  std::vector<IdleDecoder> idle_decoders_ GUARDED_BY(crit_);
+  int num_created_ GUARDED_BY(crit_);
+
+  DISALLOW_COPY_AND_ASSIGN(CodecPool);
+};
+
+}  // namespace acm2
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CODING_MAIN_ACM2_CODEC_POOL_H_
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_MAIN_INTERFACE_AUDIO_TRANSCODER_H_
+#define WEBRTC_MODULES_AUDIO_CODING_MAIN_INTERFACE_AUDIO_TRANSCODER_H_
+
+#include <vector>
+
+#include "webrtc/common_types.h"
+#include "webrtc/modules/audio_coding/main/interface/audio_coding_module_typedefs.h"
+#include "webrtc/modules/audio_coding/neteq/interface/neteq.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Transcodes RTP audio streams from one codec to another, e.g., between G.711
+// and Opus endpoints in a media server, without voice engine channels. Each
+// session decodes its incoming packets with a NetEq instance, which takes care
+// of jitter and losses, converts the audio to the sample rate and the number
+// of channels of the send codec, and encodes it into RTP packets which it
+// hands to a Transport. The sessions of a transcoder take their encoders and
+// decoders from a common pool and give them back when they are destroyed, so
+// sessions which come and go don't create new codecs each time.
+//
+// Process() runs 10 ms of all sessions. Like NetEqBatch, it splits the
+// sessions into one contiguous shard per thread, so that a thread handles the
+// same sessions tick after tick as long as the set doesn't change.
+//
+// CreateSession(), DestroySession() and Process() must be called on the same
+// thread. Session::InsertPacket() may be called on any thread, concurrently
+// with Process().
+class AudioTranscoder {
+ public:
+  struct Config {
+    Config() : num_threads(1) {}
+
+    // The number of threads which run Process(), counting the calling thread.
+    int num_threads;
+    // Used for the NetEq instances of all sessions.
+    NetEq::Config neteq_config;
+  };
+
+  struct SessionConfig {
+    SessionConfig();
+    ~SessionConfig();
+
+    // The codecs which the session receives, with their payload types in
+    // |pltype|.
+    std::vector<CodecInst> receive_codecs;
+    // The codec which the session sends, with its payload type in |pltype|.
+    // It must have one or two channels.
+    CodecInst send_codec;
+    // Enables CNG with this payload type when it isn't -1, which requires a
+    // mono send codec.
+    int send_cng_payload_type;
+    ACMVADMode vad_mode;
+    uint32_t ssrc;
+    uint16_t first_sequence_number;
+    uint32_t first_timestamp;
+    // Receives the outgoing packets on the threads of Process(), with
+    // |channel| set to |id|.
+    Transport* transport;
+    int id;
+  };
+
+  class Session {
+   public:
+    virtual ~Session() {}
+
+    // Inserts the RTP packet in |packet|, which arrived at |arrival_time_ms|.
+    // Returns 0 on success, or -1 if the packet can't be parsed or has a
+    // payload type which the session doesn't receive.
+    virtual int InsertPacket(const uint8_t* packet,
+                             size_t length,
+                             int64_t arrival_time_ms) = 0;
+
+    // The statistics of the NetEq instance of the session.
+    virtual int NetworkStatistics(NetEqNetworkStatistics* stats) = 0;
+
+    // The number of packets the session has sent. Must be called on the
+    // thread which calls Process().
+    virtual int num_packets_sent() const = 0;
+  };
+
+  static AudioTranscoder* Create(const Config& config);
+  virtual ~AudioTranscoder() {}
+
+  // Returns a session which is owned by the transcoder and valid until it is
+  // passed to DestroySession(), or NULL if one of the codecs isn't supported.
+  // The session sends nothing until it has received its first packet.
+  virtual Session* CreateSession(const SessionConfig& config) = 0;
+  virtual void DestroySession(Session* session) = 0;
+
+  virtual int num_sessions() const = 0;
+  virtual int num_threads() const = 0;
+
+  // The number of encoders and decoders which the pool has created so far.
+  virtual int num_codecs_created() const = 0;
+
+  // Runs 10 ms of all sessions and returns when their packets are sent.
+  // Returns the number of sessions which failed to decode or encode.
+  virtual int Process() = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CODING_MAIN_INTERFACE_AUDIO_TRANSCODER_H_
@@ -361,6 +361,14 @@ int AudioDecoderOpus::DecodeRedundantInternal(const uint8_t* encoded,
   return ret;
 }
 
+int AudioDecoderOpus::DecodePlc(int num_frames, int16_t* decoded) {
+  int16_t ret = WebRtcOpus_DecodePlc(dec_state_, decoded,
+                                     static_cast<int16_t>(num_frames));
+  if (ret > 0)
+    ret *= static_cast<int16_t>(channels_);  // Return total number of samples.
+  return ret;
+}
+
 int AudioDecoderOpus::Init() {
   return WebRtcOpus_DecoderInit(dec_state_);
 }
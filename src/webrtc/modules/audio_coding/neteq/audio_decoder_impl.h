@@ -212,6 +212,9 @@ class AudioDecoderOpus : public AudioDecoder {
   explicit AudioDecoderOpus(int num_channels);
   ~AudioDecoderOpus() override;
 
+  // NetEq conceals lost Opus packets with its own expand, since
+  // HasDecodePlc() is false, but the decoder's concealment can be called.
+  int DecodePlc(int num_frames, int16_t* decoded) override;
   int Init() override;
   int PacketDuration(const uint8_t* encoded, size_t encoded_len) const override;
   int PacketDurationRedundant(const uint8_t* encoded,
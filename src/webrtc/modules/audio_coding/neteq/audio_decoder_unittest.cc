@@ -591,6 +591,7 @@ TEST_F(AudioDecoderOpusTest, EncodeDecode) {
   EncodeDecodeTest(0, tolerance, mse, delay);
   ReInitTest();
   EXPECT_FALSE(decoder_->HasDecodePlc());
+  DecodePlcTest();
 }
 
 TEST_F(AudioDecoderOpusStereoTest, EncodeDecode) {
@@ -602,6 +603,7 @@ TEST_F(AudioDecoderOpusStereoTest, EncodeDecode) {
   EncodeDecodeTest(0, tolerance, mse, delay, channel_diff_tolerance);
   ReInitTest();
   EXPECT_FALSE(decoder_->HasDecodePlc());
+  DecodePlcTest();
 }
 
 TEST(AudioDecoder, CodecSampleRateHz) {
@@ -21,6 +21,7 @@ namespace webrtc {
 AudioMultiVector::AudioMultiVector(size_t N) {
   assert(N > 0);
   if (N < 1) N = 1;
+  channels_.reserve(N);
   for (size_t n = 0; n < N; ++n) {
     channels_.push_back(new AudioVector);
   }
@@ -30,6 +31,7 @@ AudioMultiVector::AudioMultiVector(size_t N) {
 AudioMultiVector::AudioMultiVector(size_t N, size_t initial_size) {
   assert(N > 0);
   if (N < 1) N = 1;
+  channels_.reserve(N);
   for (size_t n = 0; n < N; ++n) {
     channels_.push_back(new AudioVector(initial_size));
   }
@@ -57,6 +59,12 @@ void AudioMultiVector::Zeros(size_t length) {
   }
 }
 
+void AudioMultiVector::Reserve(size_t capacity) {
+  for (size_t i = 0; i < num_channels_; ++i) {
+    channels_[i]->Reserve(capacity);
+  }
+}
+
 void AudioMultiVector::CopyTo(AudioMultiVector* copy_to) const {
   if (copy_to) {
     for (size_t i = 0; i < num_channels_; ++i) {
@@ -69,23 +77,23 @@ void AudioMultiVector::PushBackInterleaved(const int16_t* append_this,
                                            size_t length) {
   assert(length % num_channels_ == 0);
   if (num_channels_ == 1) {
-    // Special case to avoid extra allocation and data shuffling.
+    // Special case to avoid data shuffling.
     channels_[0]->PushBack(append_this, length);
     return;
   }
   size_t length_per_channel = length / num_channels_;
-  int16_t* temp_array = new int16_t[length_per_channel];  // Temporary storage.
   for (size_t channel = 0; channel < num_channels_; ++channel) {
-    // Copy elements to |temp_array|.
+    // De-interleave straight into the end of the channel.
+    AudioVector& channel_vector = *channels_[channel];
+    const size_t start_index = channel_vector.Size();
+    channel_vector.Extend(length_per_channel);
     // Set |source_ptr| to first element of this channel.
     const int16_t* source_ptr = &append_this[channel];
     for (size_t i = 0; i < length_per_channel; ++i) {
-      temp_array[i] = *source_ptr;
+      channel_vector[start_index + i] = *source_ptr;
       source_ptr += num_channels_;  // Jump to next element of this channel.
     }
-    channels_[channel]->PushBack(temp_array, length_per_channel);
   }
-  delete [] temp_array;
 }
 
 void AudioMultiVector::PushBack(const AudioMultiVector& append_this) {
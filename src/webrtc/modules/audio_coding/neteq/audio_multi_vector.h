@@ -39,6 +39,10 @@ class AudioMultiVector {
   // Clears the vector and inserts |length| zeros into each channel.
   virtual void Zeros(size_t length);
 
+  // Makes sure that |capacity| elements fit in each channel without
+  // allocating more memory.
+  virtual void Reserve(size_t capacity);
+
   // Copies all values from this vector to |copy_to|. Any contents in |copy_to|
   // are deleted. After the operation is done, |copy_to| will be an exact
   // replica of this object. The source and the destination must have the same
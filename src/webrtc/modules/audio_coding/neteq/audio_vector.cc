@@ -14,19 +14,22 @@
 
 #include <algorithm>
 
+#include "webrtc/modules/audio_coding/neteq/dsp_helper.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 
 AudioVector::AudioVector()
     : array_(new int16_t[kDefaultInitialSize]),
-      first_free_ix_(0),
+      begin_index_(0),
+      end_index_(0),
       capacity_(kDefaultInitialSize) {
 }
 
 AudioVector::AudioVector(size_t initial_size)
     : array_(new int16_t[initial_size]),
-      first_free_ix_(initial_size),
+      begin_index_(0),
+      end_index_(initial_size),
       capacity_(initial_size) {
   memset(array_.get(), 0, initial_size * sizeof(int16_t));
 }
@@ -34,24 +37,20 @@ AudioVector::AudioVector(size_t initial_size)
 AudioVector::~AudioVector() = default;
 
 void AudioVector::Clear() {
-  first_free_ix_ = 0;
+  begin_index_ = 0;
+  end_index_ = 0;
 }
 
 void AudioVector::CopyTo(AudioVector* copy_to) const {
   if (copy_to) {
-    copy_to->Reserve(Size());
-    assert(copy_to->capacity_ >= Size());
-    memcpy(copy_to->array_.get(), array_.get(), Size() * sizeof(int16_t));
-    copy_to->first_free_ix_ = first_free_ix_;
+    copy_to->Clear();
+    copy_to->PushBack(&array_[begin_index_], Size());
   }
 }
 
 void AudioVector::PushFront(const AudioVector& prepend_this) {
-  size_t insert_length = prepend_this.Size();
-  Reserve(Size() + insert_length);
-  memmove(&array_[insert_length], &array_[0], Size() * sizeof(int16_t));
-  memcpy(&array_[0], &prepend_this.array_[0], insert_length * sizeof(int16_t));
-  first_free_ix_ += insert_length;
+  PushFront(&prepend_this.array_[prepend_this.begin_index_],
+            prepend_this.Size());
 }
 
 void AudioVector::PushFront(const int16_t* prepend_this, size_t length) {
@@ -60,13 +59,13 @@ void AudioVector::PushFront(const int16_t* prepend_this, size_t length) {
 }
 
 void AudioVector::PushBack(const AudioVector& append_this) {
-  PushBack(append_this.array_.get(), append_this.Size());
+  PushBack(&append_this.array_[append_this.begin_index_], append_this.Size());
 }
 
 void AudioVector::PushBack(const int16_t* append_this, size_t length) {
-  Reserve(Size() + length);
-  memcpy(&array_[first_free_ix_], append_this, length * sizeof(int16_t));
-  first_free_ix_ += length;
+  MakeRoom(0, length);
+  memcpy(&array_[end_index_], append_this, length * sizeof(int16_t));
+  end_index_ += length;
 }
 
 void AudioVector::PopFront(size_t length) {
@@ -74,51 +73,57 @@ void AudioVector::PopFront(size_t length) {
     // Remove all elements.
     Clear();
   } else {
-    size_t remaining_samples = Size() - length;
-    memmove(&array_[0], &array_[length], remaining_samples * sizeof(int16_t));
-    first_free_ix_ -= length;
+    begin_index_ += length;
   }
 }
 
 void AudioVector::PopBack(size_t length) {
   // Never remove more than what is in the array.
   length = std::min(length, Size());
-  first_free_ix_ -= length;
+  end_index_ -= length;
 }
 
 void AudioVector::Extend(size_t extra_length) {
-  Reserve(Size() + extra_length);
-  memset(&array_[first_free_ix_], 0, extra_length * sizeof(int16_t));
-  first_free_ix_ += extra_length;
+  MakeRoom(0, extra_length);
+  memset(&array_[end_index_], 0, extra_length * sizeof(int16_t));
+  end_index_ += extra_length;
+}
+
+void AudioVector::Reserve(size_t capacity) {
+  if (capacity > Size())
+    MakeRoom(0, capacity - Size());
 }
 
 void AudioVector::InsertAt(const int16_t* insert_this,
                            size_t length,
                            size_t position) {
-  Reserve(Size() + length);
+  InsertZerosAt(length, position);
   // Cap the position at the current vector length, to be sure the iterator
   // does not extend beyond the end of the vector.
-  position = std::min(Size(), position);
-  int16_t* insert_position_ptr = &array_[position];
-  size_t samples_to_move = Size() - position;
-  memmove(insert_position_ptr + length, insert_position_ptr,
-          samples_to_move * sizeof(int16_t));
-  memcpy(insert_position_ptr, insert_this, length * sizeof(int16_t));
-  first_free_ix_ += length;
+  position = std::min(Size() - length, position);
+  memcpy(&array_[begin_index_ + position], insert_this,
+         length * sizeof(int16_t));
 }
 
 void AudioVector::InsertZerosAt(size_t length,
                                 size_t position) {
-  Reserve(Size() + length);
   // Cap the position at the current vector length, to be sure the iterator
   // does not extend beyond the end of the vector.
-  position = std::min(capacity_, position);
-  int16_t* insert_position_ptr = &array_[position];
-  size_t samples_to_move = Size() - position;
-  memmove(insert_position_ptr + length, insert_position_ptr,
-          samples_to_move * sizeof(int16_t));
-  memset(insert_position_ptr, 0, length * sizeof(int16_t));
-  first_free_ix_ += length;
+  position = std::min(Size(), position);
+  // Move the samples on the shorter side of |position|.
+  if (position <= Size() - position) {
+    MakeRoom(length, 0);
+    memmove(&array_[begin_index_ - length], &array_[begin_index_],
+            position * sizeof(int16_t));
+    begin_index_ -= length;
+  } else {
+    MakeRoom(0, length);
+    int16_t* insert_position_ptr = &array_[begin_index_ + position];
+    memmove(insert_position_ptr + length, insert_position_ptr,
+            (Size() - position) * sizeof(int16_t));
+    end_index_ += length;
+  }
+  memset(&array_[begin_index_ + position], 0, length * sizeof(int16_t));
 }
 
 void AudioVector::OverwriteAt(const int16_t* insert_this,
@@ -126,12 +131,13 @@ void AudioVector::OverwriteAt(const int16_t* insert_this,
                               size_t position) {
   // Cap the insert position at the current array length.
   position = std::min(Size(), position);
-  Reserve(position + length);
-  memcpy(&array_[position], insert_this, length * sizeof(int16_t));
   if (position + length > Size()) {
-    // Array was expanded.
-    first_free_ix_ += position + length - Size();
+    // Array is expanded.
+    MakeRoom(0, position + length - Size());
+    end_index_ = begin_index_ + position + length;
   }
+  memcpy(&array_[begin_index_ + position], insert_this,
+         length * sizeof(int16_t));
 }
 
 void AudioVector::CrossFade(const AudioVector& append_this,
@@ -146,14 +152,13 @@ void AudioVector::CrossFade(const AudioVector& append_this,
   // |alpha| is the mixing factor in Q14.
   // TODO(hlundin): Consider skipping +1 in the denominator to produce a
   // smoother cross-fade, in particular at the end of the fade.
-  int alpha_step = 16384 / (static_cast<int>(fade_length) + 1);
-  int alpha = 16384;
-  for (size_t i = 0; i < fade_length; ++i) {
-    alpha -= alpha_step;
-    array_[position + i] = (alpha * array_[position + i] +
-        (16384 - alpha) * append_this[i] + 8192) >> 14;
+  int16_t alpha_step = 16384 / (static_cast<int>(fade_length) + 1);
+  int16_t alpha = 16384 - alpha_step;
+  if (fade_length > 0) {
+    DspHelper::CrossFade(&(*this)[position], &append_this[0], fade_length,
+                         &alpha, alpha_step, &(*this)[position]);
   }
-  assert(alpha >= 0);  // Verify that the slope was correct.
+  assert(alpha + alpha_step >= 0);  // Verify that the slope was correct.
   // Append what is left of |append_this|.
   size_t samples_to_push_back = append_this.Size() - fade_length;
   if (samples_to_push_back > 0)
@@ -162,29 +167,49 @@ void AudioVector::CrossFade(const AudioVector& append_this,
 
 // Returns the number of elements in this AudioVector.
 size_t AudioVector::Size() const {
-  return first_free_ix_;
+  return end_index_ - begin_index_;
 }
 
 // Returns true if this AudioVector is empty.
 bool AudioVector::Empty() const {
-  return first_free_ix_ == 0;
+  return end_index_ == begin_index_;
 }
 
 const int16_t& AudioVector::operator[](size_t index) const {
-  return array_[index];
+  return array_[begin_index_ + index];
 }
 
 int16_t& AudioVector::operator[](size_t index) {
-  return array_[index];
-}
-
-void AudioVector::Reserve(size_t n) {
-  if (capacity_ < n) {
-    rtc::scoped_ptr<int16_t[]> temp_array(new int16_t[n]);
-    memcpy(temp_array.get(), array_.get(), Size() * sizeof(int16_t));
+  return array_[begin_index_ + index];
+}
+
+void AudioVector::MakeRoom(size_t front_length, size_t back_length) {
+  if (front_length <= begin_index_ && back_length <= capacity_ - end_index_)
+    return;
+  const size_t size = Size();
+  const size_t needed = front_length + size + back_length;
+  if (needed > capacity_) {
+    // Leave as much free space as there are samples, so that a vector which
+    // is pushed to at one end and popped from at the other, like the sync
+    // buffer, is only re-centered once in a while. Growing at least twofold
+    // keeps the number of reallocations low for vectors which are refilled
+    // with slowly increasing lengths.
+    const size_t new_capacity = std::max(needed + size, 2 * capacity_);
+    rtc::scoped_ptr<int16_t[]> temp_array(new int16_t[new_capacity]);
+    const size_t new_begin_index = front_length + size / 2;
+    memcpy(&temp_array[new_begin_index], &array_[begin_index_],
+           size * sizeof(int16_t));
     array_.swap(temp_array);
-    capacity_ = n;
+    capacity_ = new_capacity;
+    begin_index_ = new_begin_index;
+  } else {
+    // Split the free space evenly between the two ends.
+    const size_t new_begin_index = front_length + (capacity_ - needed) / 2;
+    memmove(&array_[new_begin_index], &array_[begin_index_],
+            size * sizeof(int16_t));
+    begin_index_ = new_begin_index;
   }
+  end_index_ = begin_index_ + size;
 }
 
 }  // namespace webrtc
@@ -19,6 +19,13 @@
 
 namespace webrtc {
 
+// The samples are stored contiguously, since the DSP code passes pointers into
+// the vector to the signal processing library, but with free space both before
+// and after them. Removing samples from either end is then O(1), as is adding
+// samples to either end while there is room; when there is not, the samples
+// are re-centered in the array, which is only reallocated if it is too small.
+// The vector thus stops allocating memory once it has reached its largest
+// size.
 class AudioVector {
  public:
   // Creates an empty AudioVector.
@@ -61,6 +68,10 @@ class AudioVector {
   // elements are initialized to zero.
   virtual void Extend(size_t extra_length);
 
+  // Makes sure that |capacity| elements fit in this object without allocating
+  // more memory.
+  virtual void Reserve(size_t capacity);
+
   // Inserts |length| elements taken from the array |insert_this| and insert
   // them at |position|. The length of the AudioVector is increased by |length|.
   // |position| = 0 means that the new values are prepended to the vector.
@@ -98,11 +109,14 @@ class AudioVector {
  private:
   static const size_t kDefaultInitialSize = 10;
 
-  void Reserve(size_t n);
+  // Makes room for |front_length| new elements before the first element and
+  // |back_length| new elements after the last element.
+  void MakeRoom(size_t front_length, size_t back_length);
 
   rtc::scoped_ptr<int16_t[]> array_;
-  size_t first_free_ix_;  // The first index after the last sample in array_.
-                          // Note that this index may point outside of array_.
+  size_t begin_index_;  // The index of the first sample in |array_|.
+  size_t end_index_;  // The first index after the last sample in |array_|.
+                      // Note that this index may point outside of |array_|.
   size_t capacity_;  // Allocated number of samples in the array.
 
   DISALLOW_COPY_AND_ASSIGN(AudioVector);
@@ -15,7 +15,10 @@
 
 #include <algorithm>  // Access to min, max.
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/modules/audio_coding/neteq/dsp_helper_sse2.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 
 namespace webrtc {
 
@@ -257,9 +260,11 @@ int DspHelper::MinDistortion(const int16_t* signal, int min_lag,
   return best_index;
 }
 
-void DspHelper::CrossFade(const int16_t* input1, const int16_t* input2,
-                          size_t length, int16_t* mix_factor,
-                          int16_t factor_decrement, int16_t* output) {
+namespace {
+
+void CrossFadeC(const int16_t* input1, const int16_t* input2,
+                size_t length, int16_t* mix_factor,
+                int16_t factor_decrement, int16_t* output) {
   int16_t factor = *mix_factor;
   int16_t complement_factor = 16384 - factor;
   for (size_t i = 0; i < length; i++) {
@@ -271,6 +276,49 @@ void DspHelper::CrossFade(const int16_t* input1, const int16_t* input2,
   *mix_factor = factor;
 }
 
+}  // namespace
+
+void DspHelper::CrossFade(const int16_t* input1, const int16_t* input2,
+                          size_t length, int16_t* mix_factor,
+                          int16_t factor_decrement, int16_t* output) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  // 1 if the CPU has SSE2, 0 if not, and -1 until it has been checked. NetEq
+  // instances on several threads may get here at once, so it is accessed
+  // atomically.
+  static volatile int has_sse2 = -1;
+  int sse2 = rtc::AtomicOps::Load(&has_sse2);
+  if (sse2 < 0) {
+    sse2 = WebRtc_GetCPUInfo(kSSE2) != 0 ? 1 : 0;
+    rtc::AtomicOps::Store(&has_sse2, sse2);
+  }
+  if (sse2) {
+    CrossFadeSSE2(input1, input2, length, mix_factor, factor_decrement,
+                  output);
+    return;
+  }
+#endif
+  CrossFadeC(input1, input2, length, mix_factor, factor_decrement, output);
+}
+
+int32_t DspHelper::DotProductWithScale(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       size_t length,
+                                       int scaling) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  // One cross-correlation lag is the dot product. The NEON version isn't
+  // bit-exact, so other platforms keep the C function.
+  assert(length <= static_cast<size_t>(WEBRTC_SPL_WORD16_MAX));
+  int32_t dot_product;
+  WebRtcSpl_CrossCorrelation(&dot_product, vector1, vector2,
+                             static_cast<int16_t>(length), 1,
+                             static_cast<int16_t>(scaling), 0);
+  return dot_product;
+#else
+  return WebRtcSpl_DotProductWithScale(vector1, vector2,
+                                       static_cast<int>(length), scaling);
+#endif
+}
+
 void DspHelper::UnmuteSignal(const int16_t* input, size_t length,
                              int16_t* factor, int16_t increment,
                              int16_t* output) {
@@ -106,6 +106,14 @@ class DspHelper {
                         size_t length, int16_t* mix_factor,
                         int16_t factor_decrement, int16_t* output);
 
+  // Same as WebRtcSpl_DotProductWithScale(), but on x86 it goes through the
+  // SSE2 or AVX2 version of WebRtcSpl_CrossCorrelation(), which is bit-exact.
+  // WebRtcSpl_Init() must have been called.
+  static int32_t DotProductWithScale(const int16_t* vector1,
+                                     const int16_t* vector2,
+                                     size_t length,
+                                     int scaling);
+
   // Scales |input| with an increasing gain. Applies |factor| (Q14) to the first
   // sample and increases the gain by |increment| (Q20) for each sample. The
   // result is written to |output|. |length| samples are processed.
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/dsp_helper_sse2.h"
+
+#include <emmintrin.h>
+
+namespace webrtc {
+
+void CrossFadeSSE2(const int16_t* input1, const int16_t* input2,
+                   size_t length, int16_t* mix_factor,
+                   int16_t factor_decrement, int16_t* output) {
+  int16_t factor = *mix_factor;
+  // The gains of eight consecutive samples. Like in the C version, they wrap
+  // around in 16 bits, and the gain of |input2| is 16384 minus that of
+  // |input1| in 16 bits.
+  __m128i factors = _mm_sub_epi16(
+      _mm_set1_epi16(factor),
+      _mm_mullo_epi16(_mm_set1_epi16(factor_decrement),
+                      _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7)));
+  const __m128i step = _mm_set1_epi16(static_cast<int16_t>(
+      factor_decrement * 8));
+  const __m128i one_q14 = _mm_set1_epi16(16384);
+  const __m128i rounding = _mm_set1_epi32(8192);
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    const __m128i in1 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&input1[i]));
+    const __m128i in2 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&input2[i]));
+    const __m128i complements = _mm_sub_epi16(one_q14, factors);
+    // factor * input1 + complement_factor * input2 for each sample, with one
+    // multiply-add of the interleaved samples and gains.
+    __m128i low = _mm_madd_epi16(_mm_unpacklo_epi16(in1, in2),
+                                 _mm_unpacklo_epi16(factors, complements));
+    __m128i high = _mm_madd_epi16(_mm_unpackhi_epi16(in1, in2),
+                                  _mm_unpackhi_epi16(factors, complements));
+    low = _mm_srai_epi32(_mm_add_epi32(low, rounding), 14);
+    high = _mm_srai_epi32(_mm_add_epi32(high, rounding), 14);
+    // Keep the low 16 bits of each result, like the conversion to int16_t in
+    // the C version, instead of saturating.
+    low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+    high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&output[i]),
+                     _mm_packs_epi32(low, high));
+    factors = _mm_sub_epi16(factors, step);
+  }
+  factor = static_cast<int16_t>(factor - static_cast<int>(i) *
+                                             factor_decrement);
+  int16_t complement_factor = 16384 - factor;
+  for (; i < length; i++) {
+    output[i] =
+        (factor * input1[i] + complement_factor * input2[i] + 8192) >> 14;
+    factor -= factor_decrement;
+    complement_factor += factor_decrement;
+  }
+  *mix_factor = factor;
+}
+
+}  // namespace webrtc
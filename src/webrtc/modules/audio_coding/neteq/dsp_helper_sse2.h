@@ -0,0 +1,29 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_DSP_HELPER_SSE2_H_
+#define WEBRTC_MODULES_AUDIO_CODING_NETEQ_DSP_HELPER_SSE2_H_
+
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// SSE2 version of DspHelper::CrossFade(), bit-exact with the C version. It is
+// compiled separately with SSE2 enabled and only called on CPUs which
+// support it.
+void CrossFadeSSE2(const int16_t* input1, const int16_t* input2,
+                   size_t length, int16_t* mix_factor,
+                   int16_t factor_decrement, int16_t* output);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CODING_NETEQ_DSP_HELPER_SSE2_H_
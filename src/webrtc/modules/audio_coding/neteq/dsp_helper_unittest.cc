@@ -10,7 +10,10 @@
 
 #include "webrtc/modules/audio_coding/neteq/dsp_helper.h"
 
+#include <stdlib.h>
+
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 #include "webrtc/modules/audio_coding/neteq/audio_multi_vector.h"
 #include "webrtc/typedefs.h"
 
@@ -86,4 +89,58 @@ TEST(DspHelper, RampSignalAudioMultiVector) {
     }
   }
 }
+
+// Verifies that CrossFade() is bit-exact with the reference implementation
+// below, for full-scale random input and lengths which do not fill up the
+// SIMD registers.
+TEST(DspHelper, CrossFadeBitExact) {
+  static const size_t kMaxLen = 203;
+  int16_t input1[kMaxLen];
+  int16_t input2[kMaxLen];
+  int16_t output[kMaxLen];
+  srand(17);
+  for (size_t length = 1; length <= kMaxLen; length += 7) {
+    for (size_t i = 0; i < length; ++i) {
+      input1[i] = static_cast<int16_t>(rand());
+      input2[i] = static_cast<int16_t>(rand());
+    }
+    const int16_t factor_decrement = static_cast<int16_t>(16384 / length);
+    int16_t mix_factor = 16384;
+    DspHelper::CrossFade(input1, input2, length, &mix_factor,
+                         factor_decrement, output);
+
+    int16_t factor = 16384;
+    int16_t complement_factor = 0;
+    for (size_t i = 0; i < length; ++i) {
+      int16_t expected = static_cast<int16_t>(
+          (factor * input1[i] + complement_factor * input2[i] + 8192) >> 14);
+      ASSERT_EQ(expected, output[i]) << "length " << length << ", i " << i;
+      factor -= factor_decrement;
+      complement_factor += factor_decrement;
+    }
+    EXPECT_EQ(factor, mix_factor);
+  }
+}
+
+TEST(DspHelper, DotProductWithScale) {
+  WebRtcSpl_Init();
+  static const size_t kLen = 120;
+  int16_t vector1[kLen];
+  int16_t vector2[kLen];
+  srand(42);
+  for (size_t i = 0; i < kLen; ++i) {
+    vector1[i] = static_cast<int16_t>(rand());
+    vector2[i] = static_cast<int16_t>(rand());
+  }
+  for (int scaling = 0; scaling < 16; ++scaling) {
+    for (size_t length = 1; length <= kLen; length += 13) {
+      EXPECT_EQ(WebRtcSpl_DotProductWithScale(vector1, vector2,
+                                              static_cast<int>(length),
+                                              scaling),
+                DspHelper::DotProductWithScale(vector1, vector2, length,
+                                               scaling));
+    }
+  }
+}
+
 }  // namespace webrtc
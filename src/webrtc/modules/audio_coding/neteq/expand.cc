@@ -462,11 +462,11 @@ void Expand::AnalyzeSignal(int16_t* random_vector) {
     best_index = best_index + start_index;
 
     // Calculate energies.
-    int32_t energy1 = WebRtcSpl_DotProductWithScale(
+    int32_t energy1 = DspHelper::DotProductWithScale(
         &(audio_history[signal_length - correlation_length]),
         &(audio_history[signal_length - correlation_length]),
         correlation_length, correlation_scale);
-    int32_t energy2 = WebRtcSpl_DotProductWithScale(
+    int32_t energy2 = DspHelper::DotProductWithScale(
         &(audio_history[signal_length - correlation_length - best_index]),
         &(audio_history[signal_length - correlation_length - best_index]),
         correlation_length, correlation_scale);
@@ -503,10 +503,12 @@ void Expand::AnalyzeSignal(int16_t* random_vector) {
     const int16_t* vector1 = &(audio_history[signal_length - expansion_length]);
     const int16_t* vector2 = vector1 - distortion_lag;
     // Normalize the second vector to the same energy as the first.
-    energy1 = WebRtcSpl_DotProductWithScale(vector1, vector1, expansion_length,
-                                            correlation_scale);
-    energy2 = WebRtcSpl_DotProductWithScale(vector2, vector2, expansion_length,
-                                            correlation_scale);
+    energy1 = DspHelper::DotProductWithScale(vector1, vector1,
+                                             expansion_length,
+                                             correlation_scale);
+    energy2 = DspHelper::DotProductWithScale(vector2, vector2,
+                                             expansion_length,
+                                             correlation_scale);
     // Confirm that amplitude ratio sqrt(energy1 / energy2) is within 0.5 - 2.0,
     // i.e., energy1 / energy1 is within 0.25 - 4.
     int16_t amplitude_ratio;
@@ -585,8 +587,8 @@ void Expand::AnalyzeSignal(int16_t* random_vector) {
     size_t temp_index = signal_length - fs_mult_lpc_analysis_len -
         kUnvoicedLpcOrder;
     // Copy signal to temporary vector to be able to pad with leading zeros.
-    int16_t* temp_signal = new int16_t[fs_mult_lpc_analysis_len
-                                       + kUnvoicedLpcOrder];
+    int16_t temp_signal[kMaxSampleRate / 8000 * kLpcAnalysisLength
+                        + kUnvoicedLpcOrder];
     memset(temp_signal, 0,
            sizeof(int16_t) * (fs_mult_lpc_analysis_len + kUnvoicedLpcOrder));
     memcpy(&temp_signal[kUnvoicedLpcOrder],
@@ -597,7 +599,6 @@ void Expand::AnalyzeSignal(int16_t* random_vector) {
                                &temp_signal[kUnvoicedLpcOrder],
                                fs_mult_lpc_analysis_len, kUnvoicedLpcOrder + 1,
                                correlation_scale, -1);
-    delete [] temp_signal;
 
     // Verify that variance is positive.
     if (auto_correlation[0] > 0) {
@@ -659,10 +660,10 @@ void Expand::AnalyzeSignal(int16_t* random_vector) {
     } else {
       unvoiced_prescale = 0;
     }
-    int32_t unvoiced_energy = WebRtcSpl_DotProductWithScale(unvoiced_vector,
-                                                            unvoiced_vector,
-                                                            128,
-                                                            unvoiced_prescale);
+    int32_t unvoiced_energy = DspHelper::DotProductWithScale(unvoiced_vector,
+                                                             unvoiced_vector,
+                                                             128,
+                                                             unvoiced_prescale);
 
     // Normalize |unvoiced_energy| to 28 or 29 bits to preserve sqrt() accuracy.
     int16_t unvoiced_scale = WebRtcSpl_NormW32(unvoiced_energy) - 3;
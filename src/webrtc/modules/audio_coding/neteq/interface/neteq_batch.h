@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_INTERFACE_NETEQ_BATCH_H_
+#define WEBRTC_MODULES_AUDIO_CODING_NETEQ_INTERFACE_NETEQ_BATCH_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_coding/neteq/interface/neteq.h"
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class WorkerPool;
+
+// Drives a set of NetEq instances together, e.g., all receive streams of an
+// audio bridge. Each call to Tick() pulls 10 ms of audio from every instance
+// into a frame which is allocated when the instance is added. The instances
+// are split into one contiguous shard per thread, and a thread handles the
+// same instances tick after tick as long as the set doesn't change, which
+// keeps their state in the cache of one core. The threads are those of a
+// WorkerPool, which runs shard i on its thread i.
+//
+// AddNetEq(), RemoveNetEq() and Tick() must be called on the same thread.
+// Other NetEq methods, e.g., InsertPacket(), may be called concurrently from
+// any thread, since NetEq has its own lock.
+class NetEqBatch {
+ public:
+  struct Output {
+    Output() : type(kOutputNormal), error(NetEq::kOK) {}
+
+    // |data_|, |samples_per_channel_|, |num_channels_| and |sample_rate_hz_|
+    // are set by Tick().
+    AudioFrame frame;
+    NetEqOutputType type;
+    // The return value of the last NetEq::GetAudio() call. The frame holds
+    // silence if it failed.
+    int error;
+  };
+
+  // Creates a batch which runs on |num_threads| threads, counting the thread
+  // which calls Tick().
+  static NetEqBatch* Create(int num_threads);
+  ~NetEqBatch();
+
+  // Adds |neteq|, which the batch does not take ownership of, and returns the
+  // output which Tick() writes its audio to. The output is valid until
+  // |neteq| is removed.
+  const Output* AddNetEq(NetEq* neteq);
+  void RemoveNetEq(NetEq* neteq);
+
+  int num_streams() const { return static_cast<int>(streams_.size()); }
+  int num_threads() const;
+
+  // Pulls 10 ms of audio from all instances and returns when all outputs are
+  // written. Returns the number of instances for which GetAudio() failed.
+  int Tick();
+
+ private:
+  struct Stream {
+    NetEq* neteq;
+    Output output;
+  };
+
+  explicit NetEqBatch(WorkerPool* pool);
+
+  static void ProcessShard(void* context, size_t shard);
+
+  // Pulls audio for the streams of |shard| and returns the number of errors.
+  int ProcessStreams(size_t shard);
+
+  const rtc::scoped_ptr<WorkerPool> pool_;
+  ScopedVector<Stream> streams_;
+  // The number of errors of each shard in the last tick.
+  std::vector<int> shard_errors_;
+
+  DISALLOW_COPY_AND_ASSIGN(NetEqBatch);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CODING_NETEQ_INTERFACE_NETEQ_BATCH_H_
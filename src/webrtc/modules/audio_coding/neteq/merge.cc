@@ -34,7 +34,9 @@ Merge::Merge(int fs_hz,
       timestamps_per_call_(fs_hz_ / 100),
       expand_(expand),
       sync_buffer_(sync_buffer),
-      expanded_(num_channels_) {
+      expanded_(num_channels_),
+      input_vector_(num_channels_),
+      expanded_temp_(num_channels_) {
   assert(num_channels_ > 0);
 }
 
@@ -52,7 +54,8 @@ int Merge::Process(int16_t* input, size_t input_length,
   int expanded_length = GetExpandedSignal(&old_length, &expand_period);
 
   // Transfer input signal to an AudioMultiVector.
-  AudioMultiVector input_vector(num_channels_);
+  AudioMultiVector& input_vector = input_vector_;
+  input_vector.Clear();
   input_vector.PushBackInterleaved(input, input_length);
   size_t input_length_per_channel = input_vector.Size();
   assert(input_length_per_channel == input_length / num_channels_);
@@ -177,7 +180,8 @@ int Merge::GetExpandedSignal(int* old_length, int* expand_period) {
   // This assert should always be true thanks to the if statement above.
   assert(210 * kMaxSampleRate / 8000 - *old_length >= 0);
 
-  AudioMultiVector expanded_temp(num_channels_);
+  AudioMultiVector& expanded_temp = expanded_temp_;
+  expanded_temp.Clear();
   expand_->Process(&expanded_temp);
   *expand_period = static_cast<int>(expanded_temp.Size());  // Samples per
                                                             // channel.
@@ -216,18 +220,18 @@ int16_t Merge::SignalScaling(const int16_t* input, int input_length,
   int expanded_shift = 6 + log_fs_mult
       - WebRtcSpl_NormW32(*expanded_max * *expanded_max);
   expanded_shift = std::max(expanded_shift, 0);
-  int32_t energy_expanded = WebRtcSpl_DotProductWithScale(expanded_signal,
-                                                          expanded_signal,
-                                                          mod_input_length,
-                                                          expanded_shift);
+  int32_t energy_expanded = DspHelper::DotProductWithScale(expanded_signal,
+                                                           expanded_signal,
+                                                           mod_input_length,
+                                                           expanded_shift);
 
   // Calculate energy of input signal.
   int input_shift = 6 + log_fs_mult -
       WebRtcSpl_NormW32(*input_max * *input_max);
   input_shift = std::max(input_shift, 0);
-  int32_t energy_input = WebRtcSpl_DotProductWithScale(input, input,
-                                                       mod_input_length,
-                                                       input_shift);
+  int32_t energy_input = DspHelper::DotProductWithScale(input, input,
+                                                        mod_input_length,
+                                                        input_shift);
 
   // Align to the same Q-domain.
   if (input_shift > expanded_shift) {
@@ -324,9 +328,13 @@ int16_t Merge::CorrelateAndPeakSearch(int16_t expanded_max, int16_t input_max,
   // Normalize correlation to 14 bits and copy to a 16-bit array.
   const int pad_length = static_cast<int>(expand_->overlap_length() - 1);
   const int correlation_buffer_size = 2 * pad_length + kMaxCorrelationLength;
-  rtc::scoped_ptr<int16_t[]> correlation16(
-      new int16_t[correlation_buffer_size]);
-  memset(correlation16.get(), 0, correlation_buffer_size * sizeof(int16_t));
+  // The overlap length is 5 samples per 8 kHz of sample rate, i.e., at most
+  // 30 samples at 48 kHz.
+  int16_t correlation16[2 * (5 * kMaxSampleRate / 8000 - 1) +
+                        kMaxCorrelationLength];
+  assert(correlation_buffer_size <= static_cast<int>(
+      sizeof(correlation16) / sizeof(correlation16[0])));
+  memset(correlation16, 0, correlation_buffer_size * sizeof(int16_t));
   int16_t* correlation_ptr = &correlation16[pad_length];
   int32_t max_correlation = WebRtcSpl_MaxAbsValueW32(correlation,
                                                      stop_position_downsamp);
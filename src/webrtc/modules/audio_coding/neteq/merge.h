@@ -95,6 +95,9 @@ class Merge {
   int16_t expanded_downsampled_[kExpandDownsampLength];
   int16_t input_downsampled_[kInputDownsampLength];
   AudioMultiVector expanded_;
+  // Scratch vectors, which are kept between calls to avoid reallocating them.
+  AudioMultiVector input_vector_;
+  AudioMultiVector expanded_temp_;
 
   DISALLOW_COPY_AND_ASSIGN(Merge);
 };
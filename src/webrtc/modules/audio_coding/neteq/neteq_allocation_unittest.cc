@@ -0,0 +1,146 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Checks that NetEq::GetAudio() does not allocate memory once the buffers
+// have grown to their working size. The allocations are counted by replacing
+// the global operator new, which is why this test is built into a binary of
+// its own, neteq_allocation_unittests.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_coding/codecs/pcm16b/include/pcm16b.h"
+#include "webrtc/modules/audio_coding/neteq/interface/neteq.h"
+#include "webrtc/modules/audio_coding/neteq/tools/rtp_generator.h"
+#include "webrtc/modules/interface/module_common_types.h"
+
+namespace {
+
+// Only touched on the test thread, and only while GetAudio() runs.
+bool count_allocations = false;
+int num_allocations = 0;
+
+}  // namespace
+
+void* operator new(size_t size) {
+  if (count_allocations)
+    ++num_allocations;
+  void* p = malloc(size ? size : 1);
+  // Tests are built without exceptions, so there is no std::bad_alloc.
+  if (!p)
+    abort();
+  return p;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* p) throw() {
+  free(p);
+}
+
+void operator delete[](void* p) throw() {
+  free(p);
+}
+
+namespace webrtc {
+
+namespace {
+
+const int kSampleRateHz = 16000;
+const int kPayloadType = 94;
+const size_t kFrameSamples = 10 * kSampleRateHz / 1000;
+const int kNumTicks = 1000;
+
+}  // namespace
+
+class NetEqAllocationTest : public ::testing::Test {
+ protected:
+  NetEqAllocationTest() : rtp_gen_(kSampleRateHz / 1000), tick_(0) {
+    NetEq::Config config;
+    config.sample_rate_hz = kSampleRateHz;
+    neteq_.reset(NetEq::Create(config));
+    EXPECT_EQ(NetEq::kOK,
+              neteq_->RegisterPayloadType(kDecoderPCM16Bwb, kPayloadType));
+  }
+
+  // Runs |kNumTicks| ticks with bursts of losses, late packets and tone
+  // changes, so that expand, merge, accelerate and preemptive expand all run.
+  // Returns the number of packets inserted.
+  int RunTicks() {
+    int num_packets = 0;
+    int16_t audio[kFrameSamples];
+    uint8_t payload[kFrameSamples * sizeof(int16_t)];
+    int16_t output[AudioFrame::kMaxDataSizeSamples];
+    for (int i = 0; i < kNumTicks; ++i, ++tick_) {
+      const double frequency = (tick_ / 50) % 2 ? 440 : 1000;
+      for (size_t n = 0; n < kFrameSamples; ++n) {
+        audio[n] = static_cast<int16_t>(
+            8000 * sin(2 * M_PI * frequency * (tick_ * kFrameSamples + n) /
+                       kSampleRateHz));
+      }
+      size_t payload_len = WebRtcPcm16b_Encode(audio, kFrameSamples, payload);
+      WebRtcRTPHeader rtp_header;
+      rtp_gen_.GetRtpHeader(kPayloadType, kFrameSamples, &rtp_header);
+      // Drop single packets, and bursts of five packets every 97 ticks. Two
+      // packets arrive together every 13 ticks, filling the buffer up.
+      const bool lost = tick_ % 11 == 0 || tick_ % 97 < 5;
+      const bool late = tick_ % 13 == 0;
+      if (late) {
+        late_header_ = rtp_header;
+        memcpy(late_payload_, payload, payload_len);
+      } else if (!lost) {
+        EXPECT_EQ(NetEq::kOK,
+                  neteq_->InsertPacket(rtp_header, payload, payload_len,
+                                       rtp_header.header.timestamp));
+        ++num_packets;
+      }
+      if (tick_ % 13 == 1) {
+        EXPECT_EQ(NetEq::kOK,
+                  neteq_->InsertPacket(late_header_, late_payload_,
+                                       sizeof(late_payload_),
+                                       rtp_header.header.timestamp));
+        ++num_packets;
+      }
+
+      int samples_per_channel;
+      int num_channels;
+      NetEqOutputType type;
+      count_allocations = true;
+      int error = neteq_->GetAudio(AudioFrame::kMaxDataSizeSamples, output,
+                                   &samples_per_channel, &num_channels, &type);
+      count_allocations = false;
+      EXPECT_EQ(NetEq::kOK, error);
+    }
+    return num_packets;
+  }
+
+  rtc::scoped_ptr<NetEq> neteq_;
+  test::RtpGenerator rtp_gen_;
+  int tick_;
+  WebRtcRTPHeader late_header_;
+  uint8_t late_payload_[kFrameSamples * sizeof(int16_t)];
+};
+
+// The only allocation left in GetAudio() is the list node of each packet
+// taken out of the packet buffer. The first round lets all buffers grow to
+// their working size.
+TEST_F(NetEqAllocationTest, NoAllocationsInGetAudioBeyondPackets) {
+  RunTicks();
+  num_allocations = 0;
+  const int num_packets = RunTicks();
+  EXPECT_LE(num_allocations, num_packets);
+}
+
+}  // namespace webrtc
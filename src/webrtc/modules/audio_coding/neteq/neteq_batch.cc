@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/interface/neteq_batch.h"
+
+#include <assert.h>
+
+#include "webrtc/system_wrappers/interface/worker_pool.h"
+
+namespace webrtc {
+
+NetEqBatch* NetEqBatch::Create(int num_threads) {
+  // Like the audio device thread, which waits for the tick, the pool's
+  // threads run at real-time priority.
+  return new NetEqBatch(new WorkerPool(num_threads > 1 ? num_threads - 1 : 0,
+                                       "NetEqBatchThread", kRealtimePriority));
+}
+
+NetEqBatch::NetEqBatch(WorkerPool* pool)
+    : pool_(pool), shard_errors_(pool->num_threads() + 1, 0) {
+}
+
+NetEqBatch::~NetEqBatch() {
+}
+
+const NetEqBatch::Output* NetEqBatch::AddNetEq(NetEq* neteq) {
+  assert(neteq);
+  Stream* stream = new Stream;
+  stream->neteq = neteq;
+  streams_.push_back(stream);
+  return &stream->output;
+}
+
+void NetEqBatch::RemoveNetEq(NetEq* neteq) {
+  for (ScopedVector<Stream>::iterator it = streams_.begin();
+       it != streams_.end(); ++it) {
+    if ((*it)->neteq == neteq) {
+      streams_.erase(it);
+      return;
+    }
+  }
+}
+
+int NetEqBatch::num_threads() const {
+  return static_cast<int>(shard_errors_.size());
+}
+
+int NetEqBatch::Tick() {
+  pool_->RunOnEachThread(&NetEqBatch::ProcessShard, this);
+  int num_errors = 0;
+  for (int shard_errors : shard_errors_)
+    num_errors += shard_errors;
+  return num_errors;
+}
+
+void NetEqBatch::ProcessShard(void* context, size_t shard) {
+  NetEqBatch* batch = static_cast<NetEqBatch*>(context);
+  batch->shard_errors_[shard] = batch->ProcessStreams(shard);
+}
+
+int NetEqBatch::ProcessStreams(size_t shard) {
+  const size_t num_streams = streams_.size();
+  const size_t num_shards = shard_errors_.size();
+  const size_t begin = num_streams * shard / num_shards;
+  const size_t end = num_streams * (shard + 1) / num_shards;
+  int num_errors = 0;
+  for (size_t i = begin; i < end; ++i) {
+    Stream* stream = streams_[i];
+    AudioFrame* frame = &stream->output.frame;
+    int samples_per_channel;
+    int num_channels;
+    stream->output.error = stream->neteq->GetAudio(
+        AudioFrame::kMaxDataSizeSamples, frame->data_, &samples_per_channel,
+        &num_channels, &stream->output.type);
+    if (stream->output.error != NetEq::kOK) {
+      frame->Mute();
+      ++num_errors;
+      continue;
+    }
+    frame->samples_per_channel_ = samples_per_channel;
+    frame->num_channels_ = num_channels;
+    // NetEq always returns 10 ms of audio.
+    frame->sample_rate_hz_ = samples_per_channel * 100;
+  }
+  return num_errors;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/interface/neteq_batch.h"
+
+#include <math.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_coding/codecs/pcm16b/include/pcm16b.h"
+#include "webrtc/modules/audio_coding/neteq/tools/rtp_generator.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kSampleRateHz = 8000;
+const int kPayloadType = 94;
+const size_t kFrameSamples = 10 * kSampleRateHz / 1000;
+const int kNumStreams = 7;
+
+NetEq* CreateNetEq() {
+  NetEq::Config config;
+  config.sample_rate_hz = kSampleRateHz;
+  NetEq* neteq = NetEq::Create(config);
+  EXPECT_EQ(NetEq::kOK,
+            neteq->RegisterPayloadType(kDecoderPCM16B, kPayloadType));
+  return neteq;
+}
+
+}  // namespace
+
+// Verifies that a batch produces the same audio as calling GetAudio() on each
+// NetEq, for streams with different losses, and on more threads than there
+// are streams per thread.
+TEST(NetEqBatchTest, SameOutputAsSeparateGetAudio) {
+  rtc::scoped_ptr<NetEqBatch> batch(NetEqBatch::Create(3));
+  ScopedVector<NetEq> batch_neteqs;
+  ScopedVector<NetEq> reference_neteqs;
+  std::vector<const NetEqBatch::Output*> outputs;
+  for (int i = 0; i < kNumStreams; ++i) {
+    batch_neteqs.push_back(CreateNetEq());
+    reference_neteqs.push_back(CreateNetEq());
+    outputs.push_back(batch->AddNetEq(batch_neteqs[i]));
+  }
+  EXPECT_EQ(kNumStreams, batch->num_streams());
+
+  test::RtpGenerator rtp_gen(kSampleRateHz / 1000);
+  int16_t audio[kFrameSamples];
+  uint8_t payload[kFrameSamples * sizeof(int16_t)];
+  int16_t reference_audio[AudioFrame::kMaxDataSizeSamples];
+  for (int tick = 0; tick < 200; ++tick) {
+    for (size_t n = 0; n < kFrameSamples; ++n) {
+      audio[n] = static_cast<int16_t>(
+          8000 * sin(2 * M_PI * 440 * (tick * kFrameSamples + n) /
+                     kSampleRateHz));
+    }
+    size_t payload_len = WebRtcPcm16b_Encode(audio, kFrameSamples, payload);
+    WebRtcRTPHeader rtp_header;
+    rtp_gen.GetRtpHeader(kPayloadType, kFrameSamples, &rtp_header);
+    for (int i = 0; i < kNumStreams; ++i) {
+      // Stream |i| loses every (i + 3)th packet.
+      if (tick % (i + 3) == 0)
+        continue;
+      const uint32_t receive_timestamp = rtp_header.header.timestamp;
+      ASSERT_EQ(NetEq::kOK,
+                batch_neteqs[i]->InsertPacket(rtp_header, payload,
+                                              payload_len, receive_timestamp));
+      ASSERT_EQ(NetEq::kOK,
+                reference_neteqs[i]->InsertPacket(rtp_header, payload,
+                                                  payload_len,
+                                                  receive_timestamp));
+    }
+
+    EXPECT_EQ(0, batch->Tick());
+    for (int i = 0; i < kNumStreams; ++i) {
+      int samples_per_channel;
+      int num_channels;
+      NetEqOutputType type;
+      ASSERT_EQ(NetEq::kOK,
+                reference_neteqs[i]->GetAudio(AudioFrame::kMaxDataSizeSamples,
+                                              reference_audio,
+                                              &samples_per_channel,
+                                              &num_channels, &type));
+      const NetEqBatch::Output& output = *outputs[i];
+      EXPECT_EQ(NetEq::kOK, output.error);
+      EXPECT_EQ(type, output.type);
+      ASSERT_EQ(samples_per_channel, output.frame.samples_per_channel_);
+      ASSERT_EQ(num_channels, output.frame.num_channels_);
+      EXPECT_EQ(kSampleRateHz, output.frame.sample_rate_hz_);
+      for (int n = 0; n < samples_per_channel * num_channels; ++n)
+        ASSERT_EQ(reference_audio[n], output.frame.data_[n]);
+    }
+  }
+}
+
+TEST(NetEqBatchTest, AddAndRemove) {
+  rtc::scoped_ptr<NetEqBatch> batch(NetEqBatch::Create(2));
+  rtc::scoped_ptr<NetEq> neteq1(CreateNetEq());
+  rtc::scoped_ptr<NetEq> neteq2(CreateNetEq());
+  EXPECT_EQ(0, batch->Tick());
+
+  batch->AddNetEq(neteq1.get());
+  const NetEqBatch::Output* output2 = batch->AddNetEq(neteq2.get());
+  EXPECT_EQ(2, batch->num_streams());
+  EXPECT_EQ(0, batch->Tick());
+  EXPECT_EQ(static_cast<int>(kFrameSamples),
+            output2->frame.samples_per_channel_);
+
+  batch->RemoveNetEq(neteq1.get());
+  EXPECT_EQ(1, batch->num_streams());
+  // The output of the remaining instance stays valid.
+  EXPECT_EQ(0, batch->Tick());
+  EXPECT_EQ(static_cast<int>(kFrameSamples),
+            output2->frame.samples_per_channel_);
+
+  batch->RemoveNetEq(neteq2.get());
+  EXPECT_EQ(0, batch->num_streams());
+  EXPECT_EQ(0, batch->Tick());
+}
+
+}  // namespace webrtc
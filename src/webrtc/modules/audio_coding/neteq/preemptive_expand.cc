@@ -56,7 +56,7 @@ void PreemptiveExpand::SetParametersForPassiveSpeech(size_t len,
 PreemptiveExpand::ReturnCodes PreemptiveExpand::CheckCriteriaAndStretch(
     const int16_t *input, size_t input_length, size_t peak_index,
     int16_t best_correlation, bool active_speech,
-    AudioMultiVector* output) const {
+    AudioMultiVector* output) {
   // Pre-calculate common multiplication with |fs_mult_|.
   // 120 corresponds to 15 ms.
   int fs_mult_120 = fs_mult_ * 120;
@@ -75,7 +75,8 @@ PreemptiveExpand::ReturnCodes PreemptiveExpand::CheckCriteriaAndStretch(
     output->PushBackInterleaved(
         input, (unmodified_length + peak_index) * num_channels_);
     // Copy the last |peak_index| samples up to 15 ms to |temp_vector|.
-    AudioMultiVector temp_vector(num_channels_);
+    AudioMultiVector& temp_vector = temp_vector_;
+    temp_vector.Clear();
     temp_vector.PushBackInterleaved(
         &input[(unmodified_length - peak_index) * num_channels_],
         peak_index * num_channels_);
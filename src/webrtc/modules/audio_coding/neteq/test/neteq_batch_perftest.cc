@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_coding/codecs/pcm16b/include/pcm16b.h"
+#include "webrtc/modules/audio_coding/neteq/interface/neteq_batch.h"
+#include "webrtc/modules/audio_coding/neteq/tools/audio_loop.h"
+#include "webrtc/modules/audio_coding/neteq/tools/rtp_generator.h"
+#include "webrtc/system_wrappers/interface/cpu_info.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kSampleRateHz = 32000;
+const NetEqDecoder kDecoderType = kDecoderPCM16Bswb32kHz;
+const int kPayloadType = 95;
+const size_t kFrameSamples = 10 * kSampleRateHz / 1000;
+const int kNumStreams = 1000;
+const int kNumTicks = 1000;  // 10 seconds.
+// Every stream drops one in |kLossPeriod| packets, and delays packets by up to
+// |kMaxJitterTicks| ticks, so that all NetEq operations get exercised.
+const int kLossPeriod = 20;
+const int kMaxJitterTicks = 6;
+
+// Returns the |percent|th percentile of |values|, which must be sorted.
+int64_t Percentile(const std::vector<int64_t>& values, int percent) {
+  return values[(values.size() - 1) * percent / 100];
+}
+
+// A packet which is due for insertion at |arrival_tick|.
+struct PendingPacket {
+  int arrival_tick;
+  WebRtcRTPHeader rtp_header;
+  int frame_index;
+};
+
+// Runs |kNumStreams| NetEq instances in a batch on |num_threads| threads and
+// reports the distribution of the time Tick() takes.
+void RunBatch(int num_threads) {
+  test::AudioLoop audio_loop;
+  ASSERT_TRUE(audio_loop.Init(
+      test::ResourcePath("audio_coding/testfile32kHz", "pcm"),
+      kSampleRateHz * 10, kFrameSamples));
+  // Encode the input once; all streams carry the same audio, each with its
+  // own jitter and losses.
+  std::vector<uint8_t> payloads(kNumTicks * kFrameSamples * sizeof(int16_t));
+  for (int i = 0; i < kNumTicks; ++i) {
+    WebRtcPcm16b_Encode(audio_loop.GetNextBlock(), kFrameSamples,
+                        &payloads[i * kFrameSamples * sizeof(int16_t)]);
+  }
+
+  rtc::scoped_ptr<NetEqBatch> batch(NetEqBatch::Create(num_threads));
+  ScopedVector<NetEq> neteqs;
+  ScopedVector<test::RtpGenerator> rtp_generators;
+  std::vector<std::vector<PendingPacket> > pending(kNumStreams);
+  for (int i = 0; i < kNumStreams; ++i) {
+    NetEq::Config config;
+    config.sample_rate_hz = kSampleRateHz;
+    neteqs.push_back(NetEq::Create(config));
+    ASSERT_EQ(NetEq::kOK,
+              neteqs[i]->RegisterPayloadType(kDecoderType, kPayloadType));
+    batch->AddNetEq(neteqs[i]);
+    rtp_generators.push_back(new test::RtpGenerator(
+        kSampleRateHz / 1000, 0, 0, 0, static_cast<uint32_t>(i)));
+    pending[i].reserve(kMaxJitterTicks + 1);
+  }
+
+  srand(42);
+  std::vector<int64_t> tick_us;
+  tick_us.reserve(kNumTicks);
+  int num_errors = 0;
+  for (int tick = 0; tick < kNumTicks; ++tick) {
+    for (int i = 0; i < kNumStreams; ++i) {
+      PendingPacket packet;
+      packet.arrival_tick = tick + rand() % (kMaxJitterTicks + 1);
+      packet.frame_index = tick;
+      rtp_generators[i]->GetRtpHeader(kPayloadType, kFrameSamples,
+                                      &packet.rtp_header);
+      if ((tick + i) % kLossPeriod != 0)
+        pending[i].push_back(packet);
+      // Insert the packets which have arrived by now. Jitter reorders them.
+      std::vector<PendingPacket>& stream_pending = pending[i];
+      size_t kept = 0;
+      for (size_t j = 0; j < stream_pending.size(); ++j) {
+        if (stream_pending[j].arrival_tick > tick) {
+          stream_pending[kept++] = stream_pending[j];
+          continue;
+        }
+        const size_t payload_bytes = kFrameSamples * sizeof(int16_t);
+        neteqs[i]->InsertPacket(
+            stream_pending[j].rtp_header,
+            &payloads[stream_pending[j].frame_index * payload_bytes],
+            payload_bytes, static_cast<uint32_t>(tick * kFrameSamples));
+      }
+      stream_pending.resize(kept);
+    }
+
+    const int64_t start_us = TickTime::MicrosecondTimestamp();
+    num_errors += batch->Tick();
+    tick_us.push_back(TickTime::MicrosecondTimestamp() - start_us);
+  }
+  EXPECT_EQ(0, num_errors);
+
+  std::sort(tick_us.begin(), tick_us.end());
+  std::ostringstream trace;
+  trace << kNumStreams << "_streams_" << batch->num_threads() << "_threads";
+  const int kPercents[] = {50, 90, 99};
+  for (int percent : kPercents) {
+    std::ostringstream measurement;
+    measurement << "neteq_batch_tick_p" << percent;
+    test::PrintResult(measurement.str(), "", trace.str(),
+                      Percentile(tick_us, percent), "us", false);
+  }
+  test::PrintResult("neteq_batch_tick_max", "", trace.str(), tick_us.back(),
+                    "us", false);
+}
+
+}  // namespace
+
+TEST(NetEqBatchPerfTest, OneThousandStreamsOneThread) {
+  RunBatch(1);
+}
+
+TEST(NetEqBatchPerfTest, OneThousandStreamsAllCores) {
+  RunBatch(static_cast<int>(CpuInfo::DetectNumberOfCores()));
+}
+
+}  // namespace webrtc
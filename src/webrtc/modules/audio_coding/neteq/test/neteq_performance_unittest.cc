@@ -39,3 +39,19 @@ TEST(NetEqPerformanceTest, RunClean) {
   webrtc::test::PrintResult(
       "neteq_performance", "", "0_pl_0_drift", runtime, "ms", true);
 }
+
+// Runs a test with up to 80 ms of network jitter on top of 10% packet losses
+// and 10% clock drift. The jitter makes packets arrive in bursts, which
+// triggers Accelerate, PreemptiveExpand and Merge much more frequently than
+// in the other tests.
+TEST(NetEqPerformanceTest, RunJitter) {
+  const int kSimulationTimeMs = 10000000;
+  const int kLossPeriod = 10;  // Drop every 10th packet.
+  const double kDriftFactor = 0.1;
+  const int kMaxJitterMs = 80;
+  int64_t runtime = webrtc::test::NetEqPerformanceTest::Run(
+      kSimulationTimeMs, kLossPeriod, kDriftFactor, kMaxJitterMs);
+  ASSERT_GT(runtime, 0);
+  webrtc::test::PrintResult(
+      "neteq_performance", "", "10_pl_10_drift_80_jitter", runtime, "ms", true);
+}
@@ -29,6 +29,12 @@ static bool ValidateLossrate(const char* flagname, int value) {
   printf("Invalid value for --%s: %d\n", flagname, static_cast<int>(value));
   return false;
 }
+static bool ValidateJitter(const char* flagname, int value) {
+  if (value >= 0)  // Value is ok.
+    return true;
+  printf("Invalid value for --%s: %d\n", flagname, static_cast<int>(value));
+  return false;
+}
 static bool ValidateDriftfactor(const char* flagname, double value) {
   if (value >= 0.0 && value < 1.0)  // Value is ok.
     return true;
@@ -48,6 +54,10 @@ DEFINE_double(drift, 0.1,
              "Clockdrift factor.");
 static const bool drift_dummy =
     google::RegisterFlagValidator(&FLAGS_drift, &ValidateDriftfactor);
+DEFINE_int32(jitter_ms, 0,
+             "Maximum random network jitter per packet in ms.");
+static const bool jitter_ms_dummy =
+    google::RegisterFlagValidator(&FLAGS_jitter_ms, &ValidateJitter);
 
 int main(int argc, char* argv[]) {
   std::string program_name = argv[0];
@@ -56,7 +66,8 @@ int main(int argc, char* argv[]) {
       "  --runtime_ms=N         runtime in ms; default is 10000 ms\n"
       "  --lossrate=N           drop every N packets; default is 10\n"
       "  --drift=F              clockdrift factor between 0.0 and 1.0; "
-      "default is 0.1\n";
+      "default is 0.1\n"
+      "  --jitter_ms=N          max network jitter in ms; default is 0\n";
   google::SetUsageMessage(usage);
   google::ParseCommandLineFlags(&argc, &argv, true);
 
@@ -68,7 +79,7 @@ int main(int argc, char* argv[]) {
 
   int64_t result =
       webrtc::test::NetEqPerformanceTest::Run(FLAGS_runtime_ms, FLAGS_lossrate,
-                                              FLAGS_drift);
+                                              FLAGS_drift, FLAGS_jitter_ms);
   if (result <= 0) {
     std::cout << "There was an error" << std::endl;
     return -1;
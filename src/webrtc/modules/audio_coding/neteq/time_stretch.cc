@@ -12,7 +12,6 @@
 
 #include <algorithm>  // min, max
 
-#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 #include "webrtc/modules/audio_coding/neteq/background_noise.h"
 #include "webrtc/modules/audio_coding/neteq/dsp_helper.h"
@@ -29,7 +28,6 @@ TimeStretch::ReturnCodes TimeStretch::Process(
   int fs_mult_120 = fs_mult_ * 120;  // Corresponds to 15 ms.
 
   const int16_t* signal;
-  rtc::scoped_ptr<int16_t[]> signal_array;
   size_t signal_len;
   if (num_channels_ == 1) {
     signal = input;
@@ -39,11 +37,11 @@ TimeStretch::ReturnCodes TimeStretch::Process(
     // interleaved. Thus, we take the first sample, skip forward |num_channels|
     // samples, and continue like that.
     signal_len = input_len / num_channels_;
-    signal_array.reset(new int16_t[signal_len]);
-    signal = signal_array.get();
+    master_signal_.resize(signal_len);
+    signal = &master_signal_[0];
     size_t j = master_channel_;
     for (size_t i = 0; i < signal_len; ++i) {
-      signal_array[i] = input[j];
+      master_signal_[i] = input[j];
       j += num_channels_;
     }
   }
@@ -90,13 +88,13 @@ TimeStretch::ReturnCodes TimeStretch::Process(
   // Calculate energies for |vec1| and |vec2|, assuming they both contain
   // |peak_index| samples.
   int32_t vec1_energy =
-      WebRtcSpl_DotProductWithScale(vec1, vec1, peak_index, scaling);
+      DspHelper::DotProductWithScale(vec1, vec1, peak_index, scaling);
   int32_t vec2_energy =
-      WebRtcSpl_DotProductWithScale(vec2, vec2, peak_index, scaling);
+      DspHelper::DotProductWithScale(vec2, vec2, peak_index, scaling);
 
   // Calculate cross-correlation between |vec1| and |vec2|.
   int32_t cross_corr =
-      WebRtcSpl_DotProductWithScale(vec1, vec2, peak_index, scaling);
+      DspHelper::DotProductWithScale(vec1, vec2, peak_index, scaling);
 
   // Check if the signal seems to be active speech or not (simple VAD).
   bool active_speech = SpeechDetection(vec1_energy, vec2_energy, peak_index,
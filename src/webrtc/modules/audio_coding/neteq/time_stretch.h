@@ -14,6 +14,8 @@
 #include <assert.h>
 #include <string.h>  // memset, size_t
 
+#include <vector>
+
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/audio_coding/neteq/audio_multi_vector.h"
 #include "webrtc/typedefs.h"
@@ -42,7 +44,8 @@ class TimeStretch {
         num_channels_(static_cast<int>(num_channels)),
         master_channel_(0),  // First channel is master.
         background_noise_(background_noise),
-        max_input_value_(0) {
+        max_input_value_(0),
+        temp_vector_(num_channels) {
     assert(sample_rate_hz_ == 8000 ||
            sample_rate_hz_ == 16000 ||
            sample_rate_hz_ == 32000 ||
@@ -50,6 +53,8 @@ class TimeStretch {
     assert(num_channels_ > 0);
     assert(static_cast<int>(master_channel_) < num_channels_);
     memset(auto_correlation_, 0, sizeof(auto_correlation_));
+    // The sub-classes cross-fade at most 15 ms.
+    temp_vector_.Reserve(fs_mult_ * 120);
   }
 
   virtual ~TimeStretch() {}
@@ -75,7 +80,7 @@ class TimeStretch {
   virtual ReturnCodes CheckCriteriaAndStretch(
       const int16_t* input, size_t input_length, size_t peak_index,
       int16_t best_correlation, bool active_speech,
-      AudioMultiVector* output) const = 0;
+      AudioMultiVector* output) = 0;
 
   static const int kCorrelationLen = 50;
   static const int kLogCorrelationLen = 6;  // >= log2(kCorrelationLen).
@@ -94,6 +99,9 @@ class TimeStretch {
   // Adding 1 to the size of |auto_correlation_| because of how it is used
   // by the peak-detection algorithm.
   int16_t auto_correlation_[kCorrelationLen + 1];
+  // Scratch vector for the sub-classes' cross-fade, which is kept between
+  // calls to avoid reallocating it.
+  AudioMultiVector temp_vector_;
 
  private:
   // Calculates the auto-correlation of |downsampled_input_| and writes the
@@ -104,6 +112,9 @@ class TimeStretch {
   bool SpeechDetection(int32_t vec1_energy, int32_t vec2_energy,
                        int peak_index, int scaling) const;
 
+  // The master channel of multi-channel input, reused between calls.
+  std::vector<int16_t> master_signal_;
+
   DISALLOW_COPY_AND_ASSIGN(TimeStretch);
 };
 
@@ -10,6 +10,10 @@
 
 #include "webrtc/modules/audio_coding/neteq/tools/neteq_performance_test.h"
 
+#include <stdlib.h>
+
+#include <algorithm>
+
 #include "webrtc/modules/audio_coding/codecs/pcm16b/include/pcm16b.h"
 #include "webrtc/modules/audio_coding/neteq/interface/neteq.h"
 #include "webrtc/modules/audio_coding/neteq/tools/audio_loop.h"
@@ -29,6 +33,13 @@ namespace test {
 int64_t NetEqPerformanceTest::Run(int runtime_ms,
                                   int lossrate,
                                   double drift_factor) {
+  return Run(runtime_ms, lossrate, drift_factor, 0);
+}
+
+int64_t NetEqPerformanceTest::Run(int runtime_ms,
+                                  int lossrate,
+                                  double drift_factor,
+                                  int max_jitter_ms) {
   const std::string kInputFileName =
       webrtc::test::ResourcePath("audio_coding/testfile32kHz", "pcm");
   const int kSampRateHz = 32000;
@@ -61,6 +72,11 @@ int64_t NetEqPerformanceTest::Run(int runtime_ms,
   bool drift_flipped = false;
   int32_t packet_input_time_ms =
       rtp_gen.GetRtpHeader(kPayloadType, kInputBlockSizeSamples, &rtp_header);
+  // Fixed seed, so that all runs see the same jitter pattern.
+  srand(42);
+  int32_t packet_arrival_time_ms = packet_input_time_ms;
+  if (max_jitter_ms > 0)
+    packet_arrival_time_ms += rand() % (max_jitter_ms + 1);
   const int16_t* input_samples = audio_loop.GetNextBlock();
   if (!input_samples) exit(1);
   uint8_t input_payload[kInputBlockSizeSamples * sizeof(int16_t)];
@@ -72,7 +88,7 @@ int64_t NetEqPerformanceTest::Run(int runtime_ms,
   webrtc::Clock* clock = webrtc::Clock::GetRealTimeClock();
   int64_t start_time_ms = clock->TimeInMilliseconds();
   while (time_now_ms < runtime_ms) {
-    while (packet_input_time_ms <= time_now_ms) {
+    while (packet_arrival_time_ms <= time_now_ms) {
       // Drop every N packets, where N = FLAGS_lossrate.
       bool lost = false;
       if (lossrate > 0) {
@@ -82,7 +98,7 @@ int64_t NetEqPerformanceTest::Run(int runtime_ms,
         // Insert packet.
         int error = neteq->InsertPacket(
             rtp_header, input_payload, payload_len,
-            packet_input_time_ms * kSampRateHz / 1000);
+            packet_arrival_time_ms * kSampRateHz / 1000);
         if (error != NetEq::kOK)
           return -1;
       }
@@ -91,6 +107,11 @@ int64_t NetEqPerformanceTest::Run(int runtime_ms,
       packet_input_time_ms = rtp_gen.GetRtpHeader(kPayloadType,
                                                   kInputBlockSizeSamples,
                                                   &rtp_header);
+      int32_t jitter_ms = 0;
+      if (max_jitter_ms > 0)
+        jitter_ms = rand() % (max_jitter_ms + 1);
+      packet_arrival_time_ms = std::max(packet_arrival_time_ms,
+                                        packet_input_time_ms + jitter_ms);
       input_samples = audio_loop.GetNextBlock();
       if (!input_samples) return -1;
       payload_len = WebRtcPcm16b_Encode(const_cast<int16_t*>(input_samples),
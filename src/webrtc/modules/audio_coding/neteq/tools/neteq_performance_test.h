@@ -24,6 +24,13 @@ class NetEqPerformanceTest {
   //   |drift_factor|: clock drift in [0, 1].
   // Returns the runtime in ms.
   static int64_t Run(int runtime_ms, int lossrate, double drift_factor);
+
+  // Same as above, but each packet is also delayed by a random network jitter
+  // in [0, |max_jitter_ms|] ms. Packets are never reordered, so a late packet
+  // holds back the ones behind it and they arrive in a burst, which exercises
+  // the Accelerate, PreemptiveExpand and Merge operations.
+  static int64_t Run(int runtime_ms, int lossrate, double drift_factor,
+                     int max_jitter_ms);
 };
 
 }  // namespace test
@@ -43,7 +43,7 @@ bool RtpFileSource::RegisterRtpHeaderExtension(RTPExtensionType type,
 
 Packet* RtpFileSource::NextPacket() {
   while (true) {
-    RtpPacket temp_packet;
+    RtpPacketRef temp_packet;
     if (!rtp_reader_->NextPacket(&temp_packet)) {
       return NULL;
     }
@@ -70,6 +70,11 @@ Packet* RtpFileSource::NextPacket() {
   }
 }
 
+void RtpFileSource::SelectSsrc(uint32_t ssrc) {
+  PacketSource::SelectSsrc(ssrc);
+  rtp_reader_->SetSsrcFilter(ssrc);
+}
+
 RtpFileSource::RtpFileSource()
     : PacketSource(),
       parser_(RtpHeaderParser::Create()) {}
@@ -43,6 +43,10 @@ class RtpFileSource : public PacketSource {
   // reached, or if a the data was corrupt.
   Packet* NextPacket() override;
 
+  // Also makes the reader skip the packets of other SSRCs without reading
+  // them.
+  void SelectSsrc(uint32_t ssrc) override;
+
  private:
   static const int kFirstLineLength = 40;
   static const int kRtpFileHeaderSize = 4 + 4 + 4 + 2 + 2;
@@ -37,9 +37,9 @@ int main(int argc, char* argv[]) {
     CHECK(input.get() != NULL) << "Cannot open input file " << argv[i];
     printf("Input RTP file: %s\n", argv[i]);
 
-    webrtc::test::RtpPacket packet;
+    webrtc::test::RtpPacketRef packet;
     while (input->NextPacket(&packet))
-      CHECK(output->WritePacket(&packet));
+      CHECK(output->WritePacket(packet));
   }
   return 0;
 }
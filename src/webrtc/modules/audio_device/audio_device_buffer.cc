@@ -13,9 +13,13 @@
 #include <assert.h>
 #include <string.h>
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/modules/audio_device/audio_device_config.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 
 namespace webrtc {
@@ -23,6 +27,22 @@ namespace webrtc {
 static const int kHighDelayThresholdMs = 300;
 static const int kLogHighDelayIntervalFrames = 500;  // 5 seconds.
 
+// The file thread empties the FIFOs every 10 ms, which leaves room for 500 ms
+// of delay at the largest format.
+static const int kFileThreadIntervalMs = 10;
+static const size_t kFileFifoSizeBytes = 50 * kMaxBufferSizeBytes;
+
+namespace {
+
+// Precedes the audio of each record in the file FIFOs.
+struct FileRecordHeader
+{
+    int fileSeq;
+    uint32_t size;
+};
+
+}  // namespace
+
 // ----------------------------------------------------------------------------
 //  ctor
 // ----------------------------------------------------------------------------
@@ -32,6 +52,8 @@ AudioDeviceBuffer::AudioDeviceBuffer() :
     _critSect(*CriticalSectionWrapper::CreateCriticalSection()),
     _critSectCb(*CriticalSectionWrapper::CreateCriticalSection()),
     _ptrCbAudioTransport(NULL),
+    _recCallbackCount(0),
+    _playCallbackCount(0),
     _recSampleRate(0),
     _playSampleRate(0),
     _recChannels(0),
@@ -43,8 +65,16 @@ AudioDeviceBuffer::AudioDeviceBuffer() :
     _recSize(0),
     _playSamples(0),
     _playSize(0),
+    _recParameters(0),
+    _playParameters(0),
     _recFile(*FileWrapper::Create()),
     _playFile(*FileWrapper::Create()),
+    _recFileSeq(0),
+    _playFileSeq(0),
+    _recFileFifo(kFileFifoSizeBytes),
+    _playFileFifo(kFileFifoSizeBytes),
+    _fileEvent(EventWrapper::Create()),
+    _fileThreadStopping(0),
     _currentMicLevel(0),
     _newMicLevel(0),
     _typingStatus(false),
@@ -57,6 +87,16 @@ AudioDeviceBuffer::AudioDeviceBuffer() :
     WEBRTC_TRACE(kTraceMemory, kTraceAudioDevice, _id, "%s created", __FUNCTION__);
     memset(_recBuffer, 0, kMaxBufferSizeBytes);
     memset(_playBuffer, 0, kMaxBufferSizeBytes);
+    _recBufferParameters = UnpackParameters(0);
+
+    _fileThread = ThreadWrapper::CreateThread(
+        FileThreadFunc, this, "webrtc_audio_device_buffer_file_thread");
+    if (!_fileThread->Start())
+    {
+        WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
+                     "failed to start the file recording thread");
+        _fileThread.reset();
+    }
 }
 
 // ----------------------------------------------------------------------------
@@ -66,15 +106,19 @@ AudioDeviceBuffer::AudioDeviceBuffer() :
 AudioDeviceBuffer::~AudioDeviceBuffer()
 {
     WEBRTC_TRACE(kTraceMemory, kTraceAudioDevice, _id, "%s destroyed", __FUNCTION__);
+    if (_fileThread)
+    {
+        rtc::AtomicOps::Store(&_fileThreadStopping, 1);
+        _fileEvent->Set();
+        _fileThread->Stop();
+    }
     {
         CriticalSectionScoped lock(&_critSect);
 
-        _recFile.Flush();
-        _recFile.CloseFile();
+        CloseFileRecording(&_recFileSeq, &_recFileFifo, &_recFile);
         delete &_recFile;
 
-        _playFile.Flush();
-        _playFile.CloseFile();
+        CloseFileRecording(&_playFileSeq, &_playFileFifo, &_playFile);
         delete &_playFile;
     }
 
@@ -99,11 +143,40 @@ void AudioDeviceBuffer::SetId(uint32_t id)
 int32_t AudioDeviceBuffer::RegisterAudioCallback(AudioTransport* audioCallback)
 {
     CriticalSectionScoped lock(&_critSectCb);
-    _ptrCbAudioTransport = audioCallback;
-
+    AudioTransport* oldCallback =
+        rtc::AtomicOps::AcquireLoadPtr(&_ptrCbAudioTransport);
+    // The pointer is only written here, under |_critSectCb|, so the swap
+    // can't fail. It is a swap rather than a release store because it must
+    // also be a full barrier: the audio threads may still be in the old
+    // callback. Since the swap and the increments of the counts are full
+    // barriers, a thread which enters the callback after the swap picks up
+    // the new one, and one which entered it before is seen by the waits.
+    AudioTransport* swappedCallback = rtc::AtomicOps::CompareAndSwapPtr(
+        &_ptrCbAudioTransport, oldCallback, audioCallback);
+    assert(swappedCallback == oldCallback);
+    (void)swappedCallback;
+    WaitForCallback(&_recCallbackCount);
+    WaitForCallback(&_playCallbackCount);
     return 0;
 }
 
+// ----------------------------------------------------------------------------
+//  WaitForCallback
+// ----------------------------------------------------------------------------
+
+void AudioDeviceBuffer::WaitForCallback(volatile int* callbackCount)
+{
+    const int count = rtc::AtomicOps::Load(callbackCount);
+    if ((count & 1) == 0)
+    {
+        return;
+    }
+    while (rtc::AtomicOps::Load(callbackCount) == count)
+    {
+        SleepMs(1);
+    }
+}
+
 // ----------------------------------------------------------------------------
 //  InitPlayout
 // ----------------------------------------------------------------------------
@@ -134,6 +207,7 @@ int32_t AudioDeviceBuffer::SetRecordingSampleRate(uint32_t fsHz)
 
     CriticalSectionScoped lock(&_critSect);
     _recSampleRate = fsHz;
+    PublishRecordingParameters();
     return 0;
 }
 
@@ -147,6 +221,7 @@ int32_t AudioDeviceBuffer::SetPlayoutSampleRate(uint32_t fsHz)
 
     CriticalSectionScoped lock(&_critSect);
     _playSampleRate = fsHz;
+    PublishPlayoutParameters();
     return 0;
 }
 
@@ -179,6 +254,7 @@ int32_t AudioDeviceBuffer::SetRecordingChannels(uint8_t channels)
     CriticalSectionScoped lock(&_critSect);
     _recChannels = channels;
     _recBytesPerSample = 2*channels;  // 16 bits per sample in mono, 32 bits in stereo
+    PublishRecordingParameters();
     return 0;
 }
 
@@ -194,6 +270,7 @@ int32_t AudioDeviceBuffer::SetPlayoutChannels(uint8_t channels)
     _playChannels = channels;
     // 16 bits per sample in mono, 32 bits in stereo
     _playBytesPerSample = 2*channels;
+    PublishPlayoutParameters();
     return 0;
 }
 
@@ -228,10 +305,74 @@ int32_t AudioDeviceBuffer::SetRecordingChannel(const AudioDeviceModule::ChannelT
         _recBytesPerSample = 2;
     }
     _recChannel = channel;
+    PublishRecordingParameters();
 
     return 0;
 }
 
+// ----------------------------------------------------------------------------
+//  PackParameters
+//
+//  Packs the parameters into an int as
+//  sampleRate << 8 | channel << 6 | channels << 3 | bytesPerSample,
+//  which holds sample rates up to 8 MHz.
+// ----------------------------------------------------------------------------
+
+int AudioDeviceBuffer::PackParameters(const AudioParameters& params)
+{
+    assert(params.sampleRate < (1u << 23));
+    assert(params.channels < 8);
+    assert(params.bytesPerSample < 8);
+    return static_cast<int>((params.sampleRate << 8) |
+                            (params.channel << 6) |
+                            (params.channels << 3) |
+                            params.bytesPerSample);
+}
+
+// ----------------------------------------------------------------------------
+//  UnpackParameters
+// ----------------------------------------------------------------------------
+
+AudioDeviceBuffer::AudioParameters AudioDeviceBuffer::UnpackParameters(
+    int packed)
+{
+    AudioParameters params;
+    params.sampleRate = static_cast<uint32_t>(packed) >> 8;
+    params.channel =
+        static_cast<AudioDeviceModule::ChannelType>((packed >> 6) & 3);
+    params.channels = (packed >> 3) & 7;
+    params.bytesPerSample = packed & 7;
+    return params;
+}
+
+// ----------------------------------------------------------------------------
+//  PublishRecordingParameters
+// ----------------------------------------------------------------------------
+
+void AudioDeviceBuffer::PublishRecordingParameters()
+{
+    AudioParameters params;
+    params.sampleRate = _recSampleRate;
+    params.channels = _recChannels;
+    params.bytesPerSample = _recBytesPerSample;
+    params.channel = _recChannel;
+    rtc::AtomicOps::Store(&_recParameters, PackParameters(params));
+}
+
+// ----------------------------------------------------------------------------
+//  PublishPlayoutParameters
+// ----------------------------------------------------------------------------
+
+void AudioDeviceBuffer::PublishPlayoutParameters()
+{
+    AudioParameters params;
+    params.sampleRate = _playSampleRate;
+    params.channels = _playChannels;
+    params.bytesPerSample = _playBytesPerSample;
+    params.channel = AudioDeviceModule::kChannelBoth;
+    rtc::AtomicOps::Store(&_playParameters, PackParameters(params));
+}
+
 // ----------------------------------------------------------------------------
 //  RecordingChannel
 // ----------------------------------------------------------------------------
@@ -266,7 +407,7 @@ uint8_t AudioDeviceBuffer::PlayoutChannels() const
 
 int32_t AudioDeviceBuffer::SetCurrentMicLevel(uint32_t level)
 {
-    _currentMicLevel = level;
+    rtc::AtomicOps::Store(&_currentMicLevel, static_cast<int>(level));
     return 0;
 }
 
@@ -282,7 +423,7 @@ int32_t AudioDeviceBuffer::SetTypingStatus(bool typingStatus)
 
 uint32_t AudioDeviceBuffer::NewMicLevel() const
 {
-    return _newMicLevel;
+    return static_cast<uint32_t>(rtc::AtomicOps::Load(&_newMicLevel));
 }
 
 // ----------------------------------------------------------------------------
@@ -301,9 +442,9 @@ void AudioDeviceBuffer::SetVQEData(int playDelayMs, int recDelayMs,
     }
   }
 
-  _playDelayMS = playDelayMs;
-  _recDelayMS = recDelayMs;
-  _clockDrift = clockDrift;
+  rtc::AtomicOps::Store(&_playDelayMS, playDelayMs);
+  rtc::AtomicOps::Store(&_recDelayMS, recDelayMs);
+  rtc::AtomicOps::Store(&_clockDrift, clockDrift);
 }
 
 // ----------------------------------------------------------------------------
@@ -317,10 +458,15 @@ int32_t AudioDeviceBuffer::StartInputFileRecording(
 
     CriticalSectionScoped lock(&_critSect);
 
-    _recFile.Flush();
-    _recFile.CloseFile();
+    CloseFileRecording(&_recFileSeq, &_recFileFifo, &_recFile);
 
-    return (_recFile.OpenFile(fileName, false, false, false));
+    if (_recFile.OpenFile(fileName, false, false, false) != 0)
+    {
+        return -1;
+    }
+    rtc::AtomicOps::Increment(&_recFileSeq);
+    _fileEvent->Set();
+    return 0;
 }
 
 // ----------------------------------------------------------------------------
@@ -333,8 +479,7 @@ int32_t AudioDeviceBuffer::StopInputFileRecording()
 
     CriticalSectionScoped lock(&_critSect);
 
-    _recFile.Flush();
-    _recFile.CloseFile();
+    CloseFileRecording(&_recFileSeq, &_recFileFifo, &_recFile);
 
     return 0;
 }
@@ -350,10 +495,15 @@ int32_t AudioDeviceBuffer::StartOutputFileRecording(
 
     CriticalSectionScoped lock(&_critSect);
 
-    _playFile.Flush();
-    _playFile.CloseFile();
+    CloseFileRecording(&_playFileSeq, &_playFileFifo, &_playFile);
 
-    return (_playFile.OpenFile(fileName, false, false, false));
+    if (_playFile.OpenFile(fileName, false, false, false) != 0)
+    {
+        return -1;
+    }
+    rtc::AtomicOps::Increment(&_playFileSeq);
+    _fileEvent->Set();
+    return 0;
 }
 
 // ----------------------------------------------------------------------------
@@ -366,12 +516,115 @@ int32_t AudioDeviceBuffer::StopOutputFileRecording()
 
     CriticalSectionScoped lock(&_critSect);
 
-    _playFile.Flush();
-    _playFile.CloseFile();
+    CloseFileRecording(&_playFileSeq, &_playFileFifo, &_playFile);
 
     return 0;
 }
 
+// ----------------------------------------------------------------------------
+//  FileThreadProcess
+//
+//  Writes the FIFOs to the files every 10 ms while a file recording is
+//  active.
+// ----------------------------------------------------------------------------
+
+bool AudioDeviceBuffer::FileThreadFunc(void* pThis)
+{
+    return static_cast<AudioDeviceBuffer*>(pThis)->FileThreadProcess();
+}
+
+bool AudioDeviceBuffer::FileThreadProcess()
+{
+    if (rtc::AtomicOps::Load(&_fileThreadStopping))
+    {
+        return false;
+    }
+    const bool fileOpen = (rtc::AtomicOps::Load(&_recFileSeq) & 1) ||
+                          (rtc::AtomicOps::Load(&_playFileSeq) & 1);
+    _fileEvent->Wait(fileOpen ? kFileThreadIntervalMs : WEBRTC_EVENT_INFINITE);
+    CriticalSectionScoped lock(&_critSect);
+    WriteFileFifos();
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+//  WriteFileFifos
+//
+//  Empties the FIFOs into the files. Called with |_critSect| held, which
+//  makes the caller the only reader of the FIFOs and keeps the sequence
+//  numbers from changing.
+// ----------------------------------------------------------------------------
+
+void AudioDeviceBuffer::WriteFileFifos()
+{
+    WriteFileFifo(&_recFileFifo, _recFileSeq, &_recFile);
+    WriteFileFifo(&_playFileFifo, _playFileSeq, &_playFile);
+}
+
+// ----------------------------------------------------------------------------
+//  WriteFileFifo
+// ----------------------------------------------------------------------------
+
+void AudioDeviceBuffer::WriteFileFifo(SingleRwFifo* fifo, int fileSeq,
+                                      FileWrapper* file)
+{
+    FileRecordHeader header;
+    while (fifo->Read(&header, sizeof(header)) == sizeof(header))
+    {
+        // The header and the audio are written together, so the audio is
+        // there as well.
+        const size_t length = fifo->Read(_fileBuffer, header.size);
+        assert(length == header.size);
+        if (header.fileSeq == fileSeq && file->Open())
+        {
+            file->Write(_fileBuffer, length);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+//  CloseFileRecording
+//
+//  Ends the recording to |file|, if any, with the audio which has been
+//  written for it so far. Called with |_critSect| held.
+// ----------------------------------------------------------------------------
+
+void AudioDeviceBuffer::CloseFileRecording(volatile int* fileSeq,
+                                           SingleRwFifo* fifo,
+                                           FileWrapper* file)
+{
+    const int seq = *fileSeq;
+    if (seq & 1)
+    {
+        // Records which the audio threads write from now on are dropped.
+        rtc::AtomicOps::Increment(fileSeq);
+    }
+    WriteFileFifo(fifo, seq, file);
+    file->Flush();
+    file->CloseFile();
+}
+
+// ----------------------------------------------------------------------------
+//  QueueFileRecord
+//
+//  Writes |audio| to |fifo| for the file which is open, if any.
+// ----------------------------------------------------------------------------
+
+void AudioDeviceBuffer::QueueFileRecord(volatile int* fileSeq,
+                                        SingleRwFifo* fifo,
+                                        const void* audio,
+                                        uint32_t size)
+{
+    const int seq = rtc::AtomicOps::Load(fileSeq);
+    if (seq & 1)
+    {
+        // written to the file in mono or stereo (interleaved) by the file
+        // thread
+        FileRecordHeader header = {seq, size};
+        fifo->Write(&header, sizeof(header), audio, size);
+    }
+}
+
 // ----------------------------------------------------------------------------
 //  SetRecordedBuffer
 //
@@ -390,29 +643,24 @@ int32_t AudioDeviceBuffer::StopOutputFileRecording()
 int32_t AudioDeviceBuffer::SetRecordedBuffer(const void* audioBuffer,
                                              uint32_t nSamples)
 {
-    CriticalSectionScoped lock(&_critSect);
+    const AudioParameters params =
+        UnpackParameters(rtc::AtomicOps::Load(&_recParameters));
 
-    if (_recBytesPerSample == 0)
+    if (params.bytesPerSample == 0)
     {
         assert(false);
         return -1;
     }
 
     _recSamples = nSamples;
-    _recSize = _recBytesPerSample*nSamples; // {2,4}*nSamples
+    _recSize = params.bytesPerSample*nSamples; // {2,4}*nSamples
     if (_recSize > kMaxBufferSizeBytes)
     {
         assert(false);
         return -1;
     }
 
-    if (nSamples != _recSamples)
-    {
-        WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id, "invalid number of recorded samples (%d)", nSamples);
-        return -1;
-    }
-
-    if (_recChannel == AudioDeviceModule::kChannelBoth)
+    if (params.channel == AudioDeviceModule::kChannelBoth)
     {
         // (default) copy the complete input buffer to the local buffer
         memcpy(&_recBuffer[0], audioBuffer, _recSize);
@@ -422,7 +670,7 @@ int32_t AudioDeviceBuffer::SetRecordedBuffer(const void* audioBuffer,
         int16_t* ptr16In = (int16_t*)audioBuffer;
         int16_t* ptr16Out = (int16_t*)&_recBuffer[0];
 
-        if (AudioDeviceModule::kChannelRight == _recChannel)
+        if (AudioDeviceModule::kChannelRight == params.channel)
         {
             ptr16In++;
         }
@@ -436,12 +684,9 @@ int32_t AudioDeviceBuffer::SetRecordedBuffer(const void* audioBuffer,
             ptr16In++;
         }
     }
+    _recBufferParameters = params;
 
-    if (_recFile.Open())
-    {
-        // write to binary file in mono or stereo (interleaved)
-        _recFile.Write(&_recBuffer[0], _recSize);
-    }
+    QueueFileRecord(&_recFileSeq, &_recFileFifo, &_recBuffer[0], _recSize);
 
     return 0;
 }
@@ -452,41 +697,52 @@ int32_t AudioDeviceBuffer::SetRecordedBuffer(const void* audioBuffer,
 
 int32_t AudioDeviceBuffer::DeliverRecordedData()
 {
-    CriticalSectionScoped lock(&_critSectCb);
+    // Use the parameters which the buffer was stored with.
+    const AudioParameters& params = _recBufferParameters;
 
     // Ensure that user has initialized all essential members
-    if ((_recSampleRate == 0)     ||
-        (_recSamples == 0)        ||
-        (_recBytesPerSample == 0) ||
-        (_recChannels == 0))
+    if ((params.sampleRate == 0)     ||
+        (_recSamples == 0)           ||
+        (params.bytesPerSample == 0) ||
+        (params.channels == 0))
     {
         assert(false);
         return -1;
     }
 
-    if (_ptrCbAudioTransport == NULL)
+    rtc::AtomicOps::Increment(&_recCallbackCount);
+    AudioTransport* audioCallback =
+        rtc::AtomicOps::AcquireLoadPtr(&_ptrCbAudioTransport);
+
+    if (audioCallback == NULL)
     {
+        rtc::AtomicOps::Increment(&_recCallbackCount);
         WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id, "failed to deliver recorded data (AudioTransport does not exist)");
         return 0;
     }
 
     int32_t res(0);
     uint32_t newMicLevel(0);
-    uint32_t totalDelayMS = _playDelayMS +_recDelayMS;
-
-    res = _ptrCbAudioTransport->RecordedDataIsAvailable(&_recBuffer[0],
-                                                        _recSamples,
-                                                        _recBytesPerSample,
-                                                        _recChannels,
-                                                        _recSampleRate,
-                                                        totalDelayMS,
-                                                        _clockDrift,
-                                                        _currentMicLevel,
-                                                        _typingStatus,
-                                                        newMicLevel);
+    uint32_t totalDelayMS = rtc::AtomicOps::Load(&_playDelayMS) +
+                            rtc::AtomicOps::Load(&_recDelayMS);
+    const int clockDrift = rtc::AtomicOps::Load(&_clockDrift);
+    const uint32_t currentMicLevel =
+        static_cast<uint32_t>(rtc::AtomicOps::Load(&_currentMicLevel));
+
+    res = audioCallback->RecordedDataIsAvailable(&_recBuffer[0],
+                                                 _recSamples,
+                                                 params.bytesPerSample,
+                                                 params.channels,
+                                                 params.sampleRate,
+                                                 totalDelayMS,
+                                                 clockDrift,
+                                                 currentMicLevel,
+                                                 _typingStatus,
+                                                 newMicLevel);
+    rtc::AtomicOps::Increment(&_recCallbackCount);
     if (res != -1)
     {
-        _newMicLevel = newMicLevel;
+        rtc::AtomicOps::Store(&_newMicLevel, static_cast<int>(newMicLevel));
     }
 
     return 0;
@@ -498,69 +754,55 @@ int32_t AudioDeviceBuffer::DeliverRecordedData()
 
 int32_t AudioDeviceBuffer::RequestPlayoutData(uint32_t nSamples)
 {
-    uint32_t playSampleRate = 0;
-    uint8_t playBytesPerSample = 0;
-    uint8_t playChannels = 0;
-    {
-        CriticalSectionScoped lock(&_critSect);
-
-        // Store copies under lock and use copies hereafter to avoid race with
-        // setter methods.
-        playSampleRate = _playSampleRate;
-        playBytesPerSample = _playBytesPerSample;
-        playChannels = _playChannels;
-
-        // Ensure that user has initialized all essential members
-        if ((playBytesPerSample == 0) ||
-            (playChannels == 0)       ||
-            (playSampleRate == 0))
-        {
-            assert(false);
-            return -1;
-        }
+    // Use one snapshot throughout to avoid races with the setter methods.
+    const AudioParameters params =
+        UnpackParameters(rtc::AtomicOps::Load(&_playParameters));
 
-        _playSamples = nSamples;
-        _playSize = playBytesPerSample * nSamples;  // {2,4}*nSamples
-        if (_playSize > kMaxBufferSizeBytes)
-        {
-            assert(false);
-            return -1;
-        }
+    // Ensure that user has initialized all essential members
+    if ((params.bytesPerSample == 0) ||
+        (params.channels == 0)       ||
+        (params.sampleRate == 0))
+    {
+        assert(false);
+        return -1;
+    }
 
-        if (nSamples != _playSamples)
-        {
-            WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id, "invalid number of samples to be played out (%d)", nSamples);
-            return -1;
-        }
+    _playSamples = nSamples;
+    _playSize = params.bytesPerSample * nSamples;  // {2,4}*nSamples
+    if (_playSize > kMaxBufferSizeBytes)
+    {
+        assert(false);
+        return -1;
     }
 
     uint32_t nSamplesOut(0);
 
-    CriticalSectionScoped lock(&_critSectCb);
+    rtc::AtomicOps::Increment(&_playCallbackCount);
+    AudioTransport* audioCallback =
+        rtc::AtomicOps::AcquireLoadPtr(&_ptrCbAudioTransport);
 
-    if (_ptrCbAudioTransport == NULL)
+    if (audioCallback == NULL)
     {
+        rtc::AtomicOps::Increment(&_playCallbackCount);
         WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id, "failed to feed data to playout (AudioTransport does not exist)");
         return 0;
     }
 
-    if (_ptrCbAudioTransport)
+    uint32_t res(0);
+    int64_t elapsed_time_ms = -1;
+    int64_t ntp_time_ms = -1;
+    res = audioCallback->NeedMorePlayData(_playSamples,
+                                          params.bytesPerSample,
+                                          params.channels,
+                                          params.sampleRate,
+                                          &_playBuffer[0],
+                                          nSamplesOut,
+                                          &elapsed_time_ms,
+                                          &ntp_time_ms);
+    rtc::AtomicOps::Increment(&_playCallbackCount);
+    if (res != 0)
     {
-        uint32_t res(0);
-        int64_t elapsed_time_ms = -1;
-        int64_t ntp_time_ms = -1;
-        res = _ptrCbAudioTransport->NeedMorePlayData(_playSamples,
-                                                     playBytesPerSample,
-                                                     playChannels,
-                                                     playSampleRate,
-                                                     &_playBuffer[0],
-                                                     nSamplesOut,
-                                                     &elapsed_time_ms,
-                                                     &ntp_time_ms);
-        if (res != 0)
-        {
-            WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id, "NeedMorePlayData() failed");
-        }
+        WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id, "NeedMorePlayData() failed");
     }
 
     return nSamplesOut;
@@ -572,8 +814,6 @@ int32_t AudioDeviceBuffer::RequestPlayoutData(uint32_t nSamples)
 
 int32_t AudioDeviceBuffer::GetPlayoutData(void* audioBuffer)
 {
-    CriticalSectionScoped lock(&_critSect);
-
     if (_playSize > kMaxBufferSizeBytes)
     {
        WEBRTC_TRACE(kTraceError, kTraceUtility, _id, "_playSize %i exceeds "
@@ -584,11 +824,8 @@ int32_t AudioDeviceBuffer::GetPlayoutData(void* audioBuffer)
 
     memcpy(audioBuffer, &_playBuffer[0], _playSize);
 
-    if (_playFile.Open())
-    {
-        // write to binary file in mono or stereo (interleaved)
-        _playFile.Write(&_playBuffer[0], _playSize);
-    }
+    QueueFileRecord(&_playFileSeq, &_playFileFifo, &_playBuffer[0],
+                    _playSize);
 
     return _playSamples;
 }
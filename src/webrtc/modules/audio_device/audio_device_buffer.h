@@ -11,18 +11,33 @@
 #ifndef WEBRTC_AUDIO_DEVICE_AUDIO_DEVICE_BUFFER_H
 #define WEBRTC_AUDIO_DEVICE_AUDIO_DEVICE_BUFFER_H
 
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/audio_device/include/audio_device.h"
+#include "webrtc/modules/audio_device/single_rw_fifo.h"
 #include "webrtc/system_wrappers/interface/file_wrapper.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 class CriticalSectionWrapper;
+class EventWrapper;
+class ThreadWrapper;
 
 const uint32_t kPulsePeriodMs = 1000;
 const uint32_t kMaxBufferSizeBytes = 3840; // 10ms in stereo @ 96kHz
 
 class AudioDeviceObserver;
 
+// Passes audio between an audio device and the registered AudioTransport.
+//
+// The methods which the device calls for each 10 ms of audio,
+// SetRecordedBuffer(), SetVQEData(), SetCurrentMicLevel(), SetTypingStatus(),
+// DeliverRecordedData(), NewMicLevel(), RequestPlayoutData() and
+// GetPlayoutData(), never wait for another thread, so that a control thread
+// which holds a lock can't make the real-time audio threads miss a deadline.
+// They read the sample rates and channel settings from snapshots which the
+// setters publish with a single atomic store, and write the audio of the
+// input and output file recordings to FIFOs which a separate thread empties
+// into the files.
 class AudioDeviceBuffer
 {
 public:
@@ -30,6 +45,8 @@ public:
     virtual ~AudioDeviceBuffer();
 
     void SetId(uint32_t id);
+    // Returns when the audio threads no longer use the previous callback,
+    // so must not be called from within the callback.
     int32_t RegisterAudioCallback(AudioTransport* audioCallback);
 
     int32_t InitPlayout();
@@ -71,11 +88,44 @@ public:
     int32_t SetTypingStatus(bool typingStatus);
 
 private:
+    // The settings of one direction, as the audio threads see them.
+    struct AudioParameters
+    {
+        uint32_t sampleRate;
+        uint8_t channels;
+        uint8_t bytesPerSample;
+        AudioDeviceModule::ChannelType channel;
+    };
+
+    static int PackParameters(const AudioParameters& params);
+    static AudioParameters UnpackParameters(int packed);
+    void PublishRecordingParameters();
+    void PublishPlayoutParameters();
+
+    // Returns when the callback which the audio thread of |callbackCount| may
+    // be in has returned.
+    static void WaitForCallback(volatile int* callbackCount);
+
+    static bool FileThreadFunc(void* pThis);
+    bool FileThreadProcess();
+    void WriteFileFifos();
+    // Writes the records of |fifo| which were made for the file with sequence
+    // number |fileSeq| to |file| and drops the others.
+    void WriteFileFifo(SingleRwFifo* fifo, int fileSeq, FileWrapper* file);
+    void CloseFileRecording(volatile int* fileSeq, SingleRwFifo* fifo,
+                            FileWrapper* file);
+    static void QueueFileRecord(volatile int* fileSeq, SingleRwFifo* fifo,
+                                const void* audio, uint32_t size);
+
     int32_t                   _id;
     CriticalSectionWrapper&         _critSect;
     CriticalSectionWrapper&         _critSectCb;
 
-    AudioTransport*                 _ptrCbAudioTransport;
+    AudioTransport* volatile        _ptrCbAudioTransport;
+    // Incremented by the recording and the playout thread when they enter and
+    // when they leave the callback, so odd while they are in it.
+    volatile int                    _recCallbackCount;
+    volatile int                    _playCallbackCount;
 
     uint32_t                  _recSampleRate;
     uint32_t                  _playSampleRate;
@@ -104,17 +154,45 @@ private:
     uint32_t                  _playSamples;
     uint32_t                  _playSize;          // in bytes
 
+    // Published by the setters, which hold |_critSect|, and read by the
+    // audio threads.
+    volatile int                    _recParameters;
+    volatile int                    _playParameters;
+
+    // The snapshot of the recording parameters which the audio in
+    // |_recBuffer| was stored with.
+    AudioParameters                 _recBufferParameters;
+
+    // The audio threads write to the FIFOs while the file is open, and the
+    // file thread writes their contents to the file under |_critSect|. The
+    // file thread sleeps on |_fileEvent| while no file is open.
+    //
+    // The sequence numbers are incremented under |_critSect| when a file is
+    // opened and when it is closed, so odd while one is open. Each record in
+    // a FIFO carries the number it was written under, so that audio which a
+    // thread writes after the file it saw open has been closed is dropped
+    // rather than written to the start of the next file.
     FileWrapper&                    _recFile;
     FileWrapper&                    _playFile;
-
-    uint32_t                  _currentMicLevel;
-    uint32_t                  _newMicLevel;
+    volatile int                    _recFileSeq;
+    volatile int                    _playFileSeq;
+    SingleRwFifo                    _recFileFifo;
+    SingleRwFifo                    _playFileFifo;
+    int8_t                          _fileBuffer[kMaxBufferSizeBytes];
+    rtc::scoped_ptr<EventWrapper>   _fileEvent;
+    rtc::scoped_ptr<ThreadWrapper>  _fileThread;
+    volatile int                    _fileThreadStopping;
+
+    // Set and read on different audio threads, so accessed with
+    // rtc::AtomicOps. The mic levels are stored as int.
+    volatile int              _currentMicLevel;
+    volatile int              _newMicLevel;
 
     bool                      _typingStatus;
 
-    int _playDelayMS;
-    int _recDelayMS;
-    int _clockDrift;
+    volatile int _playDelayMS;
+    volatile int _recDelayMS;
+    volatile int _clockDrift;
     int high_delay_counter_;
 };
 
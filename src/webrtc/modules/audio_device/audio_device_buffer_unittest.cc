@@ -0,0 +1,504 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_device/audio_device_buffer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_device/dummy/file_audio_device.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+namespace {
+
+const uint32_t kSampleRateHz = 48000;
+const uint32_t kFrames = kSampleRateHz / 100;
+
+// Remembers the last call from each audio thread. Optionally blocks in
+// RecordedDataIsAvailable() until |release_| is set.
+class FakeAudioTransport : public AudioTransport {
+ public:
+  FakeAudioTransport()
+      : rec_samples_(0),
+        rec_bytes_per_sample_(0),
+        rec_channels_(0),
+        rec_sample_rate_(0),
+        new_mic_level_(0),
+        play_value_(0),
+        entered_(NULL),
+        release_(NULL) {}
+
+  int32_t RecordedDataIsAvailable(const void* audioSamples,
+                                  const uint32_t nSamples,
+                                  const uint8_t nBytesPerSample,
+                                  const uint8_t nChannels,
+                                  const uint32_t samplesPerSec,
+                                  const uint32_t totalDelayMS,
+                                  const int32_t clockDrift,
+                                  const uint32_t currentMicLevel,
+                                  const bool keyPressed,
+                                  uint32_t& newMicLevel) override {
+    if (entered_) {
+      entered_->Set();
+      release_->Wait(WEBRTC_EVENT_INFINITE);
+    }
+    rec_samples_ = nSamples;
+    rec_bytes_per_sample_ = nBytesPerSample;
+    rec_channels_ = nChannels;
+    rec_sample_rate_ = samplesPerSec;
+    const int16_t* samples = static_cast<const int16_t*>(audioSamples);
+    rec_data_.assign(samples, samples + nSamples * nBytesPerSample / 2);
+    newMicLevel = new_mic_level_;
+    return 0;
+  }
+
+  int32_t NeedMorePlayData(const uint32_t nSamples,
+                           const uint8_t nBytesPerSample,
+                           const uint8_t nChannels,
+                           const uint32_t samplesPerSec,
+                           void* audioSamples,
+                           uint32_t& nSamplesOut,
+                           int64_t* elapsed_time_ms,
+                           int64_t* ntp_time_ms) override {
+    int16_t* samples = static_cast<int16_t*>(audioSamples);
+    std::fill(samples, samples + nSamples * nChannels, play_value_);
+    nSamplesOut = nSamples;
+    return 0;
+  }
+
+  uint32_t rec_samples_;
+  uint8_t rec_bytes_per_sample_;
+  uint8_t rec_channels_;
+  uint32_t rec_sample_rate_;
+  std::vector<int16_t> rec_data_;
+  uint32_t new_mic_level_;
+  int16_t play_value_;
+  EventWrapper* entered_;
+  EventWrapper* release_;
+};
+
+std::vector<int16_t> StereoRamp(uint32_t frames) {
+  std::vector<int16_t> audio(2 * frames);
+  for (size_t i = 0; i < audio.size(); ++i)
+    audio[i] = static_cast<int16_t>(i);
+  return audio;
+}
+
+std::vector<int8_t> ReadFile(const std::string& name) {
+  std::vector<int8_t> data(test::GetFileSize(name));
+  FILE* file = fopen(name.c_str(), "rb");
+  if (!file)
+    return std::vector<int8_t>();
+  if (!data.empty()) {
+    EXPECT_EQ(data.size(), fread(&data[0], 1, data.size(), file));
+  }
+  fclose(file);
+  return data;
+}
+
+}  // namespace
+
+class AudioDeviceBufferTest : public ::testing::Test {
+ protected:
+  AudioDeviceBufferTest() {
+    buffer_.RegisterAudioCallback(&transport_);
+    buffer_.SetRecordingSampleRate(kSampleRateHz);
+    buffer_.SetRecordingChannels(2);
+    buffer_.SetPlayoutSampleRate(kSampleRateHz);
+    buffer_.SetPlayoutChannels(1);
+  }
+
+  FakeAudioTransport transport_;
+  AudioDeviceBuffer buffer_;
+};
+
+TEST_F(AudioDeviceBufferTest, DeliversRecordedData) {
+  const std::vector<int16_t> audio = StereoRamp(kFrames);
+  transport_.new_mic_level_ = 17;
+  EXPECT_EQ(0, buffer_.SetRecordedBuffer(&audio[0], kFrames));
+  EXPECT_EQ(0, buffer_.DeliverRecordedData());
+  EXPECT_EQ(kFrames, transport_.rec_samples_);
+  EXPECT_EQ(4, transport_.rec_bytes_per_sample_);
+  EXPECT_EQ(2, transport_.rec_channels_);
+  EXPECT_EQ(kSampleRateHz, transport_.rec_sample_rate_);
+  EXPECT_EQ(audio, transport_.rec_data_);
+  EXPECT_EQ(17u, buffer_.NewMicLevel());
+}
+
+TEST_F(AudioDeviceBufferTest, DeliversSelectedChannel) {
+  EXPECT_EQ(0, buffer_.SetRecordingChannel(AudioDeviceModule::kChannelRight));
+  const std::vector<int16_t> audio = StereoRamp(kFrames);
+  EXPECT_EQ(0, buffer_.SetRecordedBuffer(&audio[0], kFrames));
+  EXPECT_EQ(0, buffer_.DeliverRecordedData());
+  EXPECT_EQ(2, transport_.rec_bytes_per_sample_);
+  ASSERT_EQ(kFrames, transport_.rec_data_.size());
+  for (uint32_t i = 0; i < kFrames; ++i)
+    EXPECT_EQ(audio[2 * i + 1], transport_.rec_data_[i]);
+}
+
+TEST_F(AudioDeviceBufferTest, DeliversWithTheSettingsOfTheStoredBuffer) {
+  const std::vector<int16_t> audio = StereoRamp(kFrames);
+  EXPECT_EQ(0, buffer_.SetRecordedBuffer(&audio[0], kFrames));
+  // A change between storing and delivering applies to the next buffer.
+  EXPECT_EQ(0, buffer_.SetRecordingSampleRate(16000));
+  EXPECT_EQ(0, buffer_.DeliverRecordedData());
+  EXPECT_EQ(kSampleRateHz, transport_.rec_sample_rate_);
+  EXPECT_EQ(0, buffer_.SetRecordedBuffer(&audio[0], 160));
+  EXPECT_EQ(0, buffer_.DeliverRecordedData());
+  EXPECT_EQ(16000u, transport_.rec_sample_rate_);
+}
+
+TEST_F(AudioDeviceBufferTest, RequestsPlayoutData) {
+  transport_.play_value_ = 4711;
+  EXPECT_EQ(static_cast<int32_t>(kFrames),
+            buffer_.RequestPlayoutData(kFrames));
+  std::vector<int16_t> audio(kFrames);
+  EXPECT_EQ(static_cast<int32_t>(kFrames), buffer_.GetPlayoutData(&audio[0]));
+  EXPECT_EQ(std::vector<int16_t>(kFrames, 4711), audio);
+}
+
+TEST_F(AudioDeviceBufferTest, WritesFileRecordings) {
+  const std::string input_name =
+      test::TempFilename(test::OutputPath(), "audio_device_buffer_input");
+  const std::string output_name =
+      test::TempFilename(test::OutputPath(), "audio_device_buffer_output");
+  ASSERT_EQ(0, buffer_.StartInputFileRecording(input_name.c_str()));
+  ASSERT_EQ(0, buffer_.StartOutputFileRecording(output_name.c_str()));
+
+  const int kNumBuffers = 20;
+  const std::vector<int16_t> audio = StereoRamp(kFrames);
+  std::vector<int16_t> played(kFrames);
+  for (int i = 0; i < kNumBuffers; ++i) {
+    EXPECT_EQ(0, buffer_.SetRecordedBuffer(&audio[0], kFrames));
+    EXPECT_EQ(0, buffer_.DeliverRecordedData());
+    transport_.play_value_ = static_cast<int16_t>(i);
+    buffer_.RequestPlayoutData(kFrames);
+    buffer_.GetPlayoutData(&played[0]);
+    // Give the file thread a chance to empty the FIFOs now and then.
+    if (i % 5 == 0)
+      SleepMs(20);
+  }
+  EXPECT_EQ(0, buffer_.StopInputFileRecording());
+  EXPECT_EQ(0, buffer_.StopOutputFileRecording());
+
+  const std::vector<int8_t> input = ReadFile(input_name);
+  ASSERT_EQ(kNumBuffers * audio.size() * sizeof(int16_t), input.size());
+  for (int i = 0; i < kNumBuffers; ++i) {
+    EXPECT_EQ(0, memcmp(&audio[0], &input[i * audio.size() * 2],
+                        audio.size() * 2));
+  }
+  const std::vector<int8_t> output = ReadFile(output_name);
+  ASSERT_EQ(kNumBuffers * kFrames * sizeof(int16_t), output.size());
+  const int16_t* output_samples = reinterpret_cast<const int16_t*>(&output[0]);
+  for (int i = 0; i < kNumBuffers; ++i)
+    EXPECT_EQ(i, output_samples[i * kFrames + kFrames - 1]);
+
+  remove(input_name.c_str());
+  remove(output_name.c_str());
+}
+
+TEST_F(AudioDeviceBufferTest, RestartedFileRecordingStartsWithNewAudio) {
+  const std::string first_name =
+      test::TempFilename(test::OutputPath(), "audio_device_buffer_first");
+  const std::string second_name =
+      test::TempFilename(test::OutputPath(), "audio_device_buffer_second");
+  const std::vector<int16_t> audio = StereoRamp(kFrames);
+  const std::vector<int16_t> silence(audio.size(), 0);
+
+  // The audio recorded for the first file is still queued when the second one
+  // is started.
+  ASSERT_EQ(0, buffer_.StartInputFileRecording(first_name.c_str()));
+  for (int i = 0; i < 3; ++i)
+    EXPECT_EQ(0, buffer_.SetRecordedBuffer(&audio[0], kFrames));
+  ASSERT_EQ(0, buffer_.StartInputFileRecording(second_name.c_str()));
+  for (int i = 0; i < 2; ++i)
+    EXPECT_EQ(0, buffer_.SetRecordedBuffer(&silence[0], kFrames));
+  EXPECT_EQ(0, buffer_.StopInputFileRecording());
+  EXPECT_EQ(0, buffer_.SetRecordedBuffer(&audio[0], kFrames));
+
+  const size_t buffer_bytes = audio.size() * sizeof(int16_t);
+  const std::vector<int8_t> first = ReadFile(first_name);
+  ASSERT_EQ(3 * buffer_bytes, first.size());
+  for (int i = 0; i < 3; ++i)
+    EXPECT_EQ(0, memcmp(&audio[0], &first[i * buffer_bytes], buffer_bytes));
+  EXPECT_EQ(std::vector<int8_t>(2 * buffer_bytes, 0), ReadFile(second_name));
+
+  remove(first_name.c_str());
+  remove(second_name.c_str());
+}
+
+namespace {
+
+struct DeliverThreadData {
+  AudioDeviceBuffer* buffer;
+  volatile int done;
+};
+
+bool DeliverOnce(void* obj) {
+  DeliverThreadData* data = static_cast<DeliverThreadData*>(obj);
+  const std::vector<int16_t> audio = StereoRamp(kFrames);
+  data->buffer->SetRecordedBuffer(&audio[0], kFrames);
+  data->buffer->DeliverRecordedData();
+  rtc::AtomicOps::Increment(&data->done);
+  return false;
+}
+
+bool RegisterNull(void* obj) {
+  DeliverThreadData* data = static_cast<DeliverThreadData*>(obj);
+  data->buffer->RegisterAudioCallback(NULL);
+  rtc::AtomicOps::Increment(&data->done);
+  return false;
+}
+
+}  // namespace
+
+TEST_F(AudioDeviceBufferTest, RegisterAudioCallbackWaitsForTheOldCallback) {
+  rtc::scoped_ptr<EventWrapper> entered(EventWrapper::Create());
+  rtc::scoped_ptr<EventWrapper> release(EventWrapper::Create());
+  transport_.entered_ = entered.get();
+  transport_.release_ = release.get();
+
+  DeliverThreadData delivered = {&buffer_, 0};
+  rtc::scoped_ptr<ThreadWrapper> audio_thread =
+      ThreadWrapper::CreateThread(&DeliverOnce, &delivered, "audio");
+  ASSERT_TRUE(audio_thread->Start());
+  ASSERT_EQ(kEventSignaled, entered->Wait(10000));
+
+  DeliverThreadData registered = {&buffer_, 0};
+  rtc::scoped_ptr<ThreadWrapper> control_thread =
+      ThreadWrapper::CreateThread(&RegisterNull, &registered, "control");
+  ASSERT_TRUE(control_thread->Start());
+  SleepMs(50);
+  EXPECT_EQ(0, rtc::AtomicOps::Load(&registered.done));
+
+  release->Set();
+  EXPECT_TRUE(audio_thread->Stop());
+  EXPECT_TRUE(control_thread->Stop());
+  EXPECT_EQ(1, rtc::AtomicOps::Load(&delivered.done));
+  EXPECT_EQ(1, rtc::AtomicOps::Load(&registered.done));
+}
+
+namespace {
+
+// Records when the audio threads of a FileAudioDevice call in. Two of these
+// take turns as the registered callback, and count calls they get after
+// they have been replaced.
+class TimingTransport : public AudioTransport {
+ public:
+  TimingTransport(std::vector<int64_t>* rec_times,
+                  std::vector<int64_t>* play_times)
+      : rec_times_(rec_times),
+        play_times_(play_times),
+        replaced_(0),
+        late_calls_(0),
+        format_errors_(0) {}
+
+  int32_t RecordedDataIsAvailable(const void* audioSamples,
+                                  const uint32_t nSamples,
+                                  const uint8_t nBytesPerSample,
+                                  const uint8_t nChannels,
+                                  const uint32_t samplesPerSec,
+                                  const uint32_t totalDelayMS,
+                                  const int32_t clockDrift,
+                                  const uint32_t currentMicLevel,
+                                  const bool keyPressed,
+                                  uint32_t& newMicLevel) override {
+    Check(nSamples, nChannels, samplesPerSec);
+    rec_times_->push_back(TickTime::MicrosecondTimestamp());
+    newMicLevel = 0;
+    return 0;
+  }
+
+  int32_t NeedMorePlayData(const uint32_t nSamples,
+                           const uint8_t nBytesPerSample,
+                           const uint8_t nChannels,
+                           const uint32_t samplesPerSec,
+                           void* audioSamples,
+                           uint32_t& nSamplesOut,
+                           int64_t* elapsed_time_ms,
+                           int64_t* ntp_time_ms) override {
+    Check(nSamples, nChannels, samplesPerSec);
+    play_times_->push_back(TickTime::MicrosecondTimestamp());
+    memset(audioSamples, 0, nSamples * nBytesPerSample);
+    nSamplesOut = nSamples;
+    return 0;
+  }
+
+  void set_replaced(bool replaced) {
+    rtc::AtomicOps::Store(&replaced_, replaced ? 1 : 0);
+  }
+  int late_calls() const { return rtc::AtomicOps::Load(&late_calls_); }
+  int format_errors() const { return rtc::AtomicOps::Load(&format_errors_); }
+
+ private:
+  void Check(uint32_t samples, uint8_t channels, uint32_t sample_rate) {
+    if (rtc::AtomicOps::Load(&replaced_))
+      rtc::AtomicOps::Increment(&late_calls_);
+    if (samples != kFrames || channels != 2 || sample_rate != kSampleRateHz)
+      rtc::AtomicOps::Increment(&format_errors_);
+  }
+
+  // Each is only written by one audio thread.
+  std::vector<int64_t>* const rec_times_;
+  std::vector<int64_t>* const play_times_;
+  volatile int replaced_;
+  volatile int late_calls_;
+  volatile int format_errors_;
+};
+
+// Keeps the control paths of an AudioDeviceBuffer busy: swaps the callback,
+// re-applies the device settings and opens and closes the file recordings.
+class Contender {
+ public:
+  Contender(AudioDeviceBuffer* buffer,
+            TimingTransport* transport_a,
+            TimingTransport* transport_b,
+            const std::string& file_name)
+      : buffer_(buffer),
+        current_(transport_a),
+        other_(transport_b),
+        file_name_(file_name),
+        iterations_(0) {}
+
+  static bool Run(void* obj) {
+    static_cast<Contender*>(obj)->Process();
+    return true;
+  }
+
+  int iterations() const { return iterations_; }
+
+ private:
+  void Process() {
+    if (file_name_.empty()) {
+      other_->set_replaced(false);
+      buffer_->RegisterAudioCallback(other_);
+      current_->set_replaced(true);
+      std::swap(current_, other_);
+      buffer_->SetRecordingSampleRate(kSampleRateHz);
+      buffer_->SetRecordingChannels(2);
+      buffer_->SetPlayoutSampleRate(kSampleRateHz);
+      buffer_->SetPlayoutChannels(2);
+    } else {
+      buffer_->StartInputFileRecording(file_name_.c_str());
+      buffer_->StartOutputFileRecording(file_name_.c_str());
+      buffer_->StopInputFileRecording();
+      buffer_->StopOutputFileRecording();
+    }
+    ++iterations_;
+  }
+
+  AudioDeviceBuffer* const buffer_;
+  TimingTransport* current_;
+  TimingTransport* other_;
+  const std::string file_name_;
+  int iterations_;
+};
+
+void PrintJitter(const std::string& trace, const std::vector<int64_t>& times) {
+  int64_t max_deviation_us = 0;
+  int64_t sum_deviation_us = 0;
+  for (size_t i = 1; i < times.size(); ++i) {
+    int64_t deviation_us = times[i] - times[i - 1] - 10000;
+    if (deviation_us < 0)
+      deviation_us = -deviation_us;
+    max_deviation_us = std::max(max_deviation_us, deviation_us);
+    sum_deviation_us += deviation_us;
+  }
+  test::PrintResult("audio_device_buffer_callback_jitter", "_max", trace,
+                    static_cast<size_t>(max_deviation_us), "us", false);
+  test::PrintResult("audio_device_buffer_callback_jitter", "_mean", trace,
+                    static_cast<size_t>(sum_deviation_us / (times.size() - 1)),
+                    "us", false);
+}
+
+}  // namespace
+
+// Runs the real-time threads of a FileAudioDevice while other threads keep
+// the control paths of its AudioDeviceBuffer busy, and reports how regularly
+// the callbacks come. The audio threads never wait for the contending
+// threads, so the jitter is that of the scheduler.
+TEST(AudioDeviceBufferStressTest, CallbackJitterUnderContention) {
+  const std::string input_name =
+      test::TempFilename(test::OutputPath(), "audio_device_stress_input");
+  {
+    // One second of stereo silence, which the device reads in a loop.
+    std::vector<int16_t> silence(2 * kSampleRateHz);
+    FILE* file = fopen(input_name.c_str(), "wb");
+    ASSERT_TRUE(file != NULL);
+    fwrite(&silence[0], sizeof(int16_t), silence.size(), file);
+    fclose(file);
+  }
+  const std::string dump_name =
+      test::TempFilename(test::OutputPath(), "audio_device_stress_dump");
+
+  const int kDurationMs = 2000;
+  std::vector<int64_t> rec_times;
+  std::vector<int64_t> play_times;
+  rec_times.reserve(2 * kDurationMs / 10);
+  play_times.reserve(2 * kDurationMs / 10);
+  TimingTransport transport_a(&rec_times, &play_times);
+  TimingTransport transport_b(&rec_times, &play_times);
+  transport_b.set_replaced(true);
+
+  AudioDeviceBuffer buffer;
+  FileAudioDevice device(0, input_name.c_str(), "");
+  device.AttachAudioBuffer(&buffer);
+  buffer.RegisterAudioCallback(&transport_a);
+  ASSERT_EQ(0, device.InitPlayout());
+  ASSERT_EQ(0, device.InitRecording());
+  ASSERT_EQ(0, device.StartPlayout());
+  ASSERT_EQ(0, device.StartRecording());
+
+  Contender settings(&buffer, &transport_a, &transport_b, "");
+  Contender files(&buffer, &transport_a, &transport_b, dump_name);
+  rtc::scoped_ptr<ThreadWrapper> settings_thread =
+      ThreadWrapper::CreateThread(&Contender::Run, &settings, "settings");
+  rtc::scoped_ptr<ThreadWrapper> files_thread =
+      ThreadWrapper::CreateThread(&Contender::Run, &files, "files");
+  ASSERT_TRUE(settings_thread->Start());
+  ASSERT_TRUE(files_thread->Start());
+
+  SleepMs(kDurationMs);
+
+  EXPECT_TRUE(settings_thread->Stop());
+  EXPECT_TRUE(files_thread->Stop());
+  EXPECT_EQ(0, device.StopRecording());
+  EXPECT_EQ(0, device.StopPlayout());
+
+  EXPECT_GT(settings.iterations(), 0);
+  EXPECT_GT(files.iterations(), 0);
+  EXPECT_EQ(0, transport_a.late_calls());
+  EXPECT_EQ(0, transport_b.late_calls());
+  EXPECT_EQ(0, transport_a.format_errors() + transport_b.format_errors());
+  // Allow for a heavily loaded machine, but the threads must keep running.
+  ASSERT_GT(rec_times.size(), static_cast<size_t>(kDurationMs / 10 / 4));
+  ASSERT_GT(play_times.size(), static_cast<size_t>(kDurationMs / 10 / 4));
+  PrintJitter("recording", rec_times);
+  PrintJitter("playout", play_times);
+
+  remove(input_name.c_str());
+  remove(dump_name.c_str());
+}
+
+}  // namespace webrtc
@@ -0,0 +1,413 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_device/dummy/wav_file_audio_device.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+
+#include "webrtc/common_audio/wav_file.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+
+namespace {
+
+const uint32_t kMaxMicrophoneLevel = 255;
+
+// WavReader and WavWriter CHECK that they can open their files, so look
+// before leaping.
+bool CanOpen(const std::string& filename, const char* mode) {
+  FILE* file = fopen(filename.c_str(), mode);
+  if (!file)
+    return false;
+  fclose(file);
+  return true;
+}
+
+}  // namespace
+
+WavFileAudioDevice::Config::Config()
+    : loop_input(false),
+      playout_sample_rate_hz(48000),
+      playout_channels(1),
+      realtime(true) {
+}
+
+WavFileAudioDevice::WavFileAudioDevice(const Config& config)
+    : config_(config),
+      record_sample_rate_hz_(0),
+      record_channels_(0),
+      audio_callback_(NULL),
+      initialized_(false),
+      play_is_initialized_(false),
+      rec_is_initialized_(false),
+      playing_(false),
+      recording_(false),
+      input_done_(false),
+      input_samples_left_(0),
+      mic_level_(0),
+      playout_buffer_(config.playout_sample_rate_hz / 100 *
+                      config.playout_channels) {
+}
+
+WavFileAudioDevice::~WavFileAudioDevice() {
+  Terminate();
+}
+
+bool WavFileAudioDevice::Tick() {
+  // The transport is called without holding |lock_|, since it may call back
+  // into this device and takes its own locks.
+  AudioTransport* audio_callback;
+  bool record;
+  bool play;
+  bool input_done;
+  int record_sample_rate_hz;
+  int record_channels;
+  uint32_t mic_level;
+  {
+    rtc::CritScope cs(&lock_);
+    if (!initialized_)
+      return false;
+    audio_callback = audio_callback_;
+    record = recording_ && reader_;
+    play = playing_;
+    if (record)
+      ReadInput();
+    input_done = input_done_;
+    record_sample_rate_hz = record_sample_rate_hz_;
+    record_channels = record_channels_;
+    mic_level = mic_level_;
+  }
+
+  uint32_t new_mic_level = 0;
+  if (record && audio_callback) {
+    audio_callback->RecordedDataIsAvailable(
+        &record_buffer_[0], record_sample_rate_hz / 100,
+        static_cast<uint8_t>(sizeof(int16_t) * record_channels),
+        static_cast<uint8_t>(record_channels), record_sample_rate_hz, 0, 0,
+        mic_level, false, new_mic_level);
+  }
+
+  if (play) {
+    const uint32_t samples_per_channel = config_.playout_sample_rate_hz / 100;
+    uint32_t samples_out = 0;
+    if (audio_callback) {
+      int64_t elapsed_time_ms = -1;
+      int64_t ntp_time_ms = -1;
+      audio_callback->NeedMorePlayData(
+          samples_per_channel,
+          static_cast<uint8_t>(sizeof(int16_t) * config_.playout_channels),
+          static_cast<uint8_t>(config_.playout_channels),
+          config_.playout_sample_rate_hz, &playout_buffer_[0], samples_out,
+          &elapsed_time_ms, &ntp_time_ms);
+      samples_out = std::min(samples_out, samples_per_channel);
+    }
+    // Keep the output in step with the input when the transport comes up
+    // short.
+    std::fill(playout_buffer_.begin() + samples_out * config_.playout_channels,
+              playout_buffer_.end(), 0);
+  }
+
+  rtc::CritScope cs(&lock_);
+  if (new_mic_level != 0)
+    mic_level_ = new_mic_level;
+  if (play && writer_)
+    writer_->WriteSamples(&playout_buffer_[0], playout_buffer_.size());
+  return !input_done;
+}
+
+int32_t WavFileAudioDevice::RegisterAudioCallback(
+    AudioTransport* audioCallback) {
+  rtc::CritScope cs(&lock_);
+  audio_callback_ = audioCallback;
+  return 0;
+}
+
+int64_t WavFileAudioDevice::TimeUntilNextProcess() {
+  return 1000;
+}
+
+int32_t WavFileAudioDevice::Init() {
+  {
+    rtc::CritScope cs(&lock_);
+    if (initialized_)
+      return 0;
+    if (config_.playout_sample_rate_hz % 100 != 0 ||
+        config_.playout_channels < 1 || config_.playout_channels > 2) {
+      return -1;
+    }
+    if (!config_.input_filename.empty()) {
+      if (!CanOpen(config_.input_filename, "rb"))
+        return -1;
+      reader_.reset(new WavReader(config_.input_filename));
+      record_sample_rate_hz_ = reader_->sample_rate();
+      record_channels_ = reader_->num_channels();
+      if (record_sample_rate_hz_ % 100 != 0 || record_channels_ > 2) {
+        reader_.reset();
+        return -1;
+      }
+      input_samples_left_ = reader_->num_samples();
+      input_done_ = input_samples_left_ == 0;
+      record_buffer_.resize(record_sample_rate_hz_ / 100 * record_channels_);
+    }
+    if (!config_.output_filename.empty()) {
+      if (!CanOpen(config_.output_filename, "wb")) {
+        reader_.reset();
+        return -1;
+      }
+      writer_.reset(new WavWriter(config_.output_filename,
+                                  config_.playout_sample_rate_hz,
+                                  config_.playout_channels));
+    }
+    initialized_ = true;
+  }
+
+  if (config_.realtime) {
+    tick_.reset(EventTimerWrapper::Create());
+    if (!tick_->StartTimer(true, 10)) {
+      Terminate();
+      return -1;
+    }
+    thread_ = ThreadWrapper::CreateThread(WavFileAudioDevice::Run, this,
+                                          "WavFileAudioDevice");
+    if (!thread_->Start()) {
+      thread_.reset();
+      Terminate();
+      return -1;
+    }
+    thread_->SetPriority(kHighPriority);
+  }
+  return 0;
+}
+
+int32_t WavFileAudioDevice::Terminate() {
+  // The thread takes |lock_| in Tick(), so stop it first.
+  if (thread_) {
+    thread_->Stop();
+    thread_.reset();
+  }
+  if (tick_) {
+    tick_->StopTimer();
+    tick_.reset();
+  }
+
+  rtc::CritScope cs(&lock_);
+  initialized_ = false;
+  play_is_initialized_ = false;
+  rec_is_initialized_ = false;
+  playing_ = false;
+  recording_ = false;
+  reader_.reset();
+  writer_.reset();
+  return 0;
+}
+
+bool WavFileAudioDevice::Initialized() const {
+  rtc::CritScope cs(&lock_);
+  return initialized_;
+}
+
+int32_t WavFileAudioDevice::PlayoutIsAvailable(bool* available) {
+  *available = true;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::InitPlayout() {
+  rtc::CritScope cs(&lock_);
+  if (!initialized_ || playing_)
+    return -1;
+  play_is_initialized_ = true;
+  return 0;
+}
+
+bool WavFileAudioDevice::PlayoutIsInitialized() const {
+  rtc::CritScope cs(&lock_);
+  return play_is_initialized_;
+}
+
+int32_t WavFileAudioDevice::RecordingIsAvailable(bool* available) {
+  *available = !config_.input_filename.empty();
+  return 0;
+}
+
+int32_t WavFileAudioDevice::InitRecording() {
+  rtc::CritScope cs(&lock_);
+  if (!reader_ || recording_)
+    return -1;
+  rec_is_initialized_ = true;
+  return 0;
+}
+
+bool WavFileAudioDevice::RecordingIsInitialized() const {
+  rtc::CritScope cs(&lock_);
+  return rec_is_initialized_;
+}
+
+int32_t WavFileAudioDevice::StartPlayout() {
+  rtc::CritScope cs(&lock_);
+  if (!play_is_initialized_)
+    return -1;
+  playing_ = true;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::StopPlayout() {
+  rtc::CritScope cs(&lock_);
+  playing_ = false;
+  play_is_initialized_ = false;
+  return 0;
+}
+
+bool WavFileAudioDevice::Playing() const {
+  rtc::CritScope cs(&lock_);
+  return playing_;
+}
+
+int32_t WavFileAudioDevice::StartRecording() {
+  rtc::CritScope cs(&lock_);
+  if (!rec_is_initialized_)
+    return -1;
+  recording_ = true;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::StopRecording() {
+  rtc::CritScope cs(&lock_);
+  recording_ = false;
+  rec_is_initialized_ = false;
+  return 0;
+}
+
+bool WavFileAudioDevice::Recording() const {
+  rtc::CritScope cs(&lock_);
+  return recording_;
+}
+
+int32_t WavFileAudioDevice::MicrophoneVolumeIsAvailable(bool* available) {
+  *available = true;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::SetMicrophoneVolume(uint32_t volume) {
+  if (volume > kMaxMicrophoneLevel)
+    return -1;
+  rtc::CritScope cs(&lock_);
+  mic_level_ = volume;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::MicrophoneVolume(uint32_t* volume) const {
+  rtc::CritScope cs(&lock_);
+  *volume = mic_level_;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::MaxMicrophoneVolume(uint32_t* maxVolume) const {
+  *maxVolume = kMaxMicrophoneLevel;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::MinMicrophoneVolume(uint32_t* minVolume) const {
+  *minVolume = 0;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::StereoPlayoutIsAvailable(bool* available) const {
+  *available = config_.playout_channels == 2;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::SetStereoPlayout(bool enable) {
+  return enable == (config_.playout_channels == 2) ? 0 : -1;
+}
+
+int32_t WavFileAudioDevice::StereoPlayout(bool* enabled) const {
+  *enabled = config_.playout_channels == 2;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::StereoRecordingIsAvailable(bool* available) const {
+  rtc::CritScope cs(&lock_);
+  *available = record_channels_ == 2;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::SetStereoRecording(bool enable) {
+  rtc::CritScope cs(&lock_);
+  return enable == (record_channels_ == 2) ? 0 : -1;
+}
+
+int32_t WavFileAudioDevice::StereoRecording(bool* enabled) const {
+  rtc::CritScope cs(&lock_);
+  *enabled = record_channels_ == 2;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::PlayoutDelay(uint16_t* delayMS) const {
+  *delayMS = 0;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::RecordingDelay(uint16_t* delayMS) const {
+  *delayMS = 0;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::RecordingSampleRate(
+    uint32_t* samplesPerSec) const {
+  rtc::CritScope cs(&lock_);
+  if (!reader_)
+    return -1;
+  *samplesPerSec = record_sample_rate_hz_;
+  return 0;
+}
+
+int32_t WavFileAudioDevice::PlayoutSampleRate(uint32_t* samplesPerSec) const {
+  *samplesPerSec = config_.playout_sample_rate_hz;
+  return 0;
+}
+
+bool WavFileAudioDevice::Run(void* obj) {
+  WavFileAudioDevice* device = static_cast<WavFileAudioDevice*>(obj);
+  device->tick_->Wait(WEBRTC_EVENT_INFINITE);
+  device->Tick();
+  return true;
+}
+
+void WavFileAudioDevice::ReadInput() {
+  const size_t num_samples = record_buffer_.size();
+  size_t read = 0;
+  while (read < num_samples && !input_done_) {
+    const size_t n = reader_->ReadSamples(
+        std::min<size_t>(num_samples - read, input_samples_left_),
+        &record_buffer_[read]);
+    if (n == 0) {
+      // The file is shorter than its header says.
+      input_done_ = true;
+      break;
+    }
+    read += n;
+    input_samples_left_ -= static_cast<uint32_t>(n);
+    if (input_samples_left_ == 0) {
+      if (config_.loop_input) {
+        reader_.reset(new WavReader(config_.input_filename));
+        input_samples_left_ = reader_->num_samples();
+      } else {
+        input_done_ = true;
+      }
+    }
+  }
+  std::fill(record_buffer_.begin() + read, record_buffer_.end(), 0);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_DEVICE_DUMMY_WAV_FILE_AUDIO_DEVICE_H_
+#define WEBRTC_MODULES_AUDIO_DEVICE_DUMMY_WAV_FILE_AUDIO_DEVICE_H_
+
+#include <string>
+#include <vector>
+
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/modules/audio_device/include/fake_audio_device.h"
+
+namespace webrtc {
+
+class EventTimerWrapper;
+class ThreadWrapper;
+class WavReader;
+class WavWriter;
+
+// An audio device module which captures audio from a WAV file and plays out
+// into another one, for running whole calls on recorded material.
+//
+// Each call to Tick() handles 10 ms: it delivers one frame of the input file
+// to the registered AudioTransport, if recording, and writes one frame of
+// playout audio, if playing. In real-time mode an internal thread calls
+// Tick() every 10 ms. Otherwise the owner calls it, which lets it run the
+// device as fast as it can or in step with a simulated clock.
+class WavFileAudioDevice : public FakeAudioDeviceModule {
+ public:
+  struct Config {
+    Config();
+
+    // The capture audio. Its sample rate and number of channels are the
+    // recording format. With no input file, recording is not available.
+    std::string input_filename;
+    // Restart the input from the beginning once it has been played through.
+    bool loop_input;
+    // The playout audio is written here. With no output file, it is dropped.
+    std::string output_filename;
+    int playout_sample_rate_hz;
+    int playout_channels;
+    bool realtime;
+  };
+
+  explicit WavFileAudioDevice(const Config& config);
+  ~WavFileAudioDevice() override;
+
+  // Handles the next 10 ms of audio. Returns false once the whole input file
+  // has been delivered; the input is silent from then on. Must not be called
+  // in real-time mode.
+  bool Tick();
+
+  int32_t RegisterAudioCallback(AudioTransport* audioCallback) override;
+  // There is no periodic work for the process thread.
+  int64_t TimeUntilNextProcess() override;
+
+  // Opens the files, and in real-time mode starts the thread. The output
+  // file is finished by Terminate().
+  int32_t Init() override;
+  int32_t Terminate() override;
+  bool Initialized() const override;
+
+  int32_t PlayoutIsAvailable(bool* available) override;
+  int32_t InitPlayout() override;
+  bool PlayoutIsInitialized() const override;
+  int32_t RecordingIsAvailable(bool* available) override;
+  int32_t InitRecording() override;
+  bool RecordingIsInitialized() const override;
+
+  int32_t StartPlayout() override;
+  int32_t StopPlayout() override;
+  bool Playing() const override;
+  int32_t StartRecording() override;
+  int32_t StopRecording() override;
+  bool Recording() const override;
+
+  int32_t MicrophoneVolumeIsAvailable(bool* available) override;
+  int32_t SetMicrophoneVolume(uint32_t volume) override;
+  int32_t MicrophoneVolume(uint32_t* volume) const override;
+  int32_t MaxMicrophoneVolume(uint32_t* maxVolume) const override;
+  int32_t MinMicrophoneVolume(uint32_t* minVolume) const override;
+
+  int32_t StereoPlayoutIsAvailable(bool* available) const override;
+  int32_t SetStereoPlayout(bool enable) override;
+  int32_t StereoPlayout(bool* enabled) const override;
+  int32_t StereoRecordingIsAvailable(bool* available) const override;
+  int32_t SetStereoRecording(bool enable) override;
+  int32_t StereoRecording(bool* enabled) const override;
+
+  int32_t PlayoutDelay(uint16_t* delayMS) const override;
+  int32_t RecordingDelay(uint16_t* delayMS) const override;
+
+  int32_t RecordingSampleRate(uint32_t* samplesPerSec) const override;
+  int32_t PlayoutSampleRate(uint32_t* samplesPerSec) const override;
+
+ private:
+  static bool Run(void* obj);
+
+  // Fills |record_buffer_| with the next 10 ms of input, padded with silence
+  // at the end of the file.
+  void ReadInput() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  const Config config_;
+
+  mutable rtc::CriticalSection lock_;
+  int record_sample_rate_hz_ GUARDED_BY(lock_);
+  int record_channels_ GUARDED_BY(lock_);
+  AudioTransport* audio_callback_ GUARDED_BY(lock_);
+  bool initialized_ GUARDED_BY(lock_);
+  bool play_is_initialized_ GUARDED_BY(lock_);
+  bool rec_is_initialized_ GUARDED_BY(lock_);
+  bool playing_ GUARDED_BY(lock_);
+  bool recording_ GUARDED_BY(lock_);
+  bool input_done_ GUARDED_BY(lock_);
+  uint32_t input_samples_left_ GUARDED_BY(lock_);
+  uint32_t mic_level_ GUARDED_BY(lock_);
+  rtc::scoped_ptr<WavReader> reader_ GUARDED_BY(lock_);
+  rtc::scoped_ptr<WavWriter> writer_ GUARDED_BY(lock_);
+  // Only used by Tick(), which runs on one thread at a time, and by Init()
+  // before the thread starts. The transport reads and writes them without
+  // |lock_| held.
+  std::vector<int16_t> record_buffer_;
+  std::vector<int16_t> playout_buffer_;
+
+  rtc::scoped_ptr<EventTimerWrapper> tick_;
+  rtc::scoped_ptr<ThreadWrapper> thread_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_DEVICE_DUMMY_WAV_FILE_AUDIO_DEVICE_H_
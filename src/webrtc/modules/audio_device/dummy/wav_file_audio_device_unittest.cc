@@ -0,0 +1,276 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_device/dummy/wav_file_audio_device.h"
+
+#include <stdio.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common_audio/wav_file.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/test/testsupport/fileutils.h"
+
+namespace webrtc {
+
+namespace {
+
+// Plays out what was recorded, and remembers the formats it was called with.
+class LoopbackTransport : public AudioTransport {
+ public:
+  LoopbackTransport()
+      : num_recorded_(0),
+        num_played_(0),
+        record_channels_(0),
+        record_rate_hz_(0),
+        playout_channels_(0),
+        playout_rate_hz_(0) {}
+
+  int32_t RecordedDataIsAvailable(const void* audioSamples,
+                                  const uint32_t nSamples,
+                                  const uint8_t nBytesPerSample,
+                                  const uint8_t nChannels,
+                                  const uint32_t samplesPerSec,
+                                  const uint32_t totalDelayMS,
+                                  const int32_t clockDrift,
+                                  const uint32_t currentMicLevel,
+                                  const bool keyPressed,
+                                  uint32_t& newMicLevel) override {
+    EXPECT_EQ(nChannels * sizeof(int16_t), nBytesPerSample);
+    EXPECT_EQ(samplesPerSec / 100, nSamples);
+    const int16_t* samples = static_cast<const int16_t*>(audioSamples);
+    recorded_.insert(recorded_.end(), samples, samples + nSamples * nChannels);
+    ++num_recorded_;
+    record_channels_ = nChannels;
+    record_rate_hz_ = samplesPerSec;
+    newMicLevel = 0;
+    return 0;
+  }
+
+  int32_t NeedMorePlayData(const uint32_t nSamples,
+                           const uint8_t nBytesPerSample,
+                           const uint8_t nChannels,
+                           const uint32_t samplesPerSec,
+                           void* audioSamples,
+                           uint32_t& nSamplesOut,
+                           int64_t* elapsed_time_ms,
+                           int64_t* ntp_time_ms) override {
+    EXPECT_EQ(nChannels * sizeof(int16_t), nBytesPerSample);
+    EXPECT_EQ(samplesPerSec / 100, nSamples);
+    int16_t* samples = static_cast<int16_t*>(audioSamples);
+    for (uint32_t i = 0; i < nSamples * nChannels; ++i) {
+      if (recorded_.empty()) {
+        samples[i] = 0;
+      } else {
+        samples[i] = recorded_.front();
+        recorded_.pop_front();
+      }
+    }
+    nSamplesOut = nSamples;
+    ++num_played_;
+    playout_channels_ = nChannels;
+    playout_rate_hz_ = samplesPerSec;
+    return 0;
+  }
+
+  std::deque<int16_t> recorded_;
+  int num_recorded_;
+  int num_played_;
+  int record_channels_;
+  int record_rate_hz_;
+  int playout_channels_;
+  int playout_rate_hz_;
+};
+
+int16_t InputSample(size_t i) {
+  return static_cast<int16_t>(i % 2000 - 1000);
+}
+
+}  // namespace
+
+class WavFileAudioDeviceTest : public ::testing::Test {
+ protected:
+  WavFileAudioDeviceTest()
+      : input_filename_(
+            test::TempFilename(test::OutputPath(), "wav_file_adm_input")),
+        output_filename_(
+            test::TempFilename(test::OutputPath(), "wav_file_adm_output")) {}
+
+  ~WavFileAudioDeviceTest() {
+    remove(input_filename_.c_str());
+    remove(output_filename_.c_str());
+  }
+
+  void WriteInput(int sample_rate_hz, int num_channels, size_t num_samples) {
+    std::vector<int16_t> samples(num_samples);
+    for (size_t i = 0; i < num_samples; ++i)
+      samples[i] = InputSample(i);
+    WavWriter writer(input_filename_, sample_rate_hz, num_channels);
+    writer.WriteSamples(&samples[0], samples.size());
+  }
+
+  WavFileAudioDevice::Config OfflineConfig() {
+    WavFileAudioDevice::Config config;
+    config.input_filename = input_filename_;
+    config.output_filename = output_filename_;
+    config.playout_sample_rate_hz = 16000;
+    config.playout_channels = 1;
+    config.realtime = false;
+    return config;
+  }
+
+  void Start(WavFileAudioDevice* device) {
+    ASSERT_EQ(0, device->RegisterAudioCallback(&transport_));
+    ASSERT_EQ(0, device->Init());
+    ASSERT_EQ(0, device->InitRecording());
+    ASSERT_EQ(0, device->StartRecording());
+    ASSERT_EQ(0, device->InitPlayout());
+    ASSERT_EQ(0, device->StartPlayout());
+  }
+
+  const std::string input_filename_;
+  const std::string output_filename_;
+  LoopbackTransport transport_;
+};
+
+TEST_F(WavFileAudioDeviceTest, CopiesInputToOutputOffline) {
+  const size_t kNumSamples = 16000;
+  WriteInput(16000, 1, kNumSamples);
+  {
+    WavFileAudioDevice device(OfflineConfig());
+    Start(&device);
+    int num_ticks = 1;
+    while (device.Tick())
+      ++num_ticks;
+    EXPECT_EQ(100, num_ticks);
+    EXPECT_EQ(100, transport_.num_recorded_);
+    EXPECT_EQ(100, transport_.num_played_);
+    EXPECT_EQ(0, device.Terminate());
+  }
+
+  WavReader reader(output_filename_);
+  EXPECT_EQ(16000, reader.sample_rate());
+  EXPECT_EQ(1, reader.num_channels());
+  ASSERT_EQ(kNumSamples, reader.num_samples());
+  std::vector<int16_t> output(kNumSamples);
+  ASSERT_EQ(kNumSamples, reader.ReadSamples(kNumSamples, &output[0]));
+  for (size_t i = 0; i < kNumSamples; ++i)
+    ASSERT_EQ(InputSample(i), output[i]) << "at sample " << i;
+}
+
+TEST_F(WavFileAudioDeviceTest, LoopsInput) {
+  // Not a whole number of 10 ms frames, so the wrap happens mid-frame.
+  const size_t kNumSamples = 1000;
+  WriteInput(16000, 1, kNumSamples);
+  WavFileAudioDevice::Config config = OfflineConfig();
+  config.loop_input = true;
+  config.output_filename.clear();
+  WavFileAudioDevice device(config);
+  Start(&device);
+  ASSERT_EQ(0, device.StopPlayout());
+  for (int i = 0; i < 30; ++i)
+    ASSERT_TRUE(device.Tick());
+
+  ASSERT_EQ(30u * 160, transport_.recorded_.size());
+  for (size_t i = 0; i < transport_.recorded_.size(); ++i)
+    ASSERT_EQ(InputSample(i % kNumSamples), transport_.recorded_[i]);
+}
+
+TEST_F(WavFileAudioDeviceTest, PadsTheEndOfTheInputWithSilence) {
+  const size_t kNumSamples = 250;
+  WriteInput(16000, 1, kNumSamples);
+  WavFileAudioDevice device(OfflineConfig());
+  Start(&device);
+  ASSERT_EQ(0, device.StopPlayout());
+  EXPECT_TRUE(device.Tick());
+  EXPECT_FALSE(device.Tick());
+  EXPECT_FALSE(device.Tick());
+
+  ASSERT_EQ(3u * 160, transport_.recorded_.size());
+  for (size_t i = 0; i < transport_.recorded_.size(); ++i) {
+    ASSERT_EQ(i < kNumSamples ? InputSample(i) : 0, transport_.recorded_[i])
+        << "at sample " << i;
+  }
+}
+
+TEST_F(WavFileAudioDeviceTest, UsesTheFormatsOfTheFiles) {
+  WriteInput(32000, 2, 6400);
+  WavFileAudioDevice::Config config = OfflineConfig();
+  config.playout_sample_rate_hz = 48000;
+  config.playout_channels = 2;
+  WavFileAudioDevice device(config);
+  Start(&device);
+
+  bool available = false;
+  EXPECT_EQ(0, device.StereoRecordingIsAvailable(&available));
+  EXPECT_TRUE(available);
+  EXPECT_EQ(0, device.SetStereoRecording(true));
+  EXPECT_EQ(-1, device.SetStereoRecording(false));
+  EXPECT_EQ(0, device.StereoPlayoutIsAvailable(&available));
+  EXPECT_TRUE(available);
+  uint32_t sample_rate_hz = 0;
+  EXPECT_EQ(0, device.RecordingSampleRate(&sample_rate_hz));
+  EXPECT_EQ(32000u, sample_rate_hz);
+  EXPECT_EQ(0, device.PlayoutSampleRate(&sample_rate_hz));
+  EXPECT_EQ(48000u, sample_rate_hz);
+
+  EXPECT_TRUE(device.Tick());
+  EXPECT_EQ(2, transport_.record_channels_);
+  EXPECT_EQ(32000, transport_.record_rate_hz_);
+  EXPECT_EQ(2, transport_.playout_channels_);
+  EXPECT_EQ(48000, transport_.playout_rate_hz_);
+}
+
+TEST_F(WavFileAudioDeviceTest, RunsInRealTime) {
+  WriteInput(16000, 1, 16000);
+  WavFileAudioDevice::Config config = OfflineConfig();
+  config.realtime = true;
+  WavFileAudioDevice device(config);
+  Start(&device);
+  SleepMs(300);
+  ASSERT_EQ(0, device.Terminate());
+  // About 30 frames, with a wide margin for loaded machines.
+  EXPECT_GT(transport_.num_recorded_, 10);
+  EXPECT_LT(transport_.num_recorded_, 40);
+}
+
+TEST_F(WavFileAudioDeviceTest, FailsToInitWithoutInputFile) {
+  remove(input_filename_.c_str());
+  WavFileAudioDevice device(OfflineConfig());
+  EXPECT_EQ(-1, device.Init());
+  EXPECT_FALSE(device.Initialized());
+}
+
+TEST_F(WavFileAudioDeviceTest, PlaysOutWithoutInputFile) {
+  WavFileAudioDevice::Config config = OfflineConfig();
+  config.input_filename.clear();
+  WavFileAudioDevice device(config);
+  ASSERT_EQ(0, device.RegisterAudioCallback(&transport_));
+  ASSERT_EQ(0, device.Init());
+  bool available = true;
+  EXPECT_EQ(0, device.RecordingIsAvailable(&available));
+  EXPECT_FALSE(available);
+  EXPECT_EQ(-1, device.InitRecording());
+  ASSERT_EQ(0, device.InitPlayout());
+  ASSERT_EQ(0, device.StartPlayout());
+  for (int i = 0; i < 5; ++i)
+    EXPECT_TRUE(device.Tick());
+  EXPECT_EQ(0, transport_.num_recorded_);
+  EXPECT_EQ(5, transport_.num_played_);
+  ASSERT_EQ(0, device.Terminate());
+
+  WavReader reader(output_filename_);
+  EXPECT_EQ(5u * 160, reader.num_samples());
+}
+
+}  // namespace webrtc
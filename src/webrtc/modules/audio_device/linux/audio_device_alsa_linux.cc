@@ -10,6 +10,7 @@
 
 #include <assert.h>
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/modules/audio_device/audio_device_config.h"
 #include "webrtc/modules/audio_device/linux/audio_device_alsa_linux.h"
 
@@ -94,7 +95,7 @@ AudioDeviceLinuxALSA::AudioDeviceLinuxALSA(const int32_t id) :
     _playIsInitialized(false),
     _AGC(false),
     _recordingDelay(0),
-    _playoutDelay(0),
+    _playoutDelayMs(0),
     _playWarning(0),
     _playError(0),
     _recWarning(0),
@@ -1595,6 +1596,7 @@ int32_t AudioDeviceLinuxALSA::StopPlayout()
      // set the pcm input handle to NULL
      _playIsInitialized = false;
      _handlePlayout = NULL;
+     rtc::AtomicOps::Store(&_playoutDelayMs, 0);
      WEBRTC_TRACE(kTraceInfo, kTraceAudioDevice, _id,
                   "  handle_playout is now set to NULL");
 
@@ -1603,7 +1605,7 @@ int32_t AudioDeviceLinuxALSA::StopPlayout()
 
 int32_t AudioDeviceLinuxALSA::PlayoutDelay(uint16_t& delayMS) const
 {
-    delayMS = (uint16_t)_playoutDelay * 1000 / _playoutFreq;
+    delayMS = (uint16_t)rtc::AtomicOps::Load(&_playoutDelayMs);
     return 0;
 }
 
@@ -2005,7 +2007,6 @@ bool AudioDeviceLinuxALSA::PlayThreadProcess()
     snd_pcm_sframes_t frames;
     snd_pcm_sframes_t avail_frames;
 
-    Lock();
     //return a positive number of frames ready otherwise a negative error code
     avail_frames = LATE(snd_pcm_avail_update)(_handlePlayout);
     if (avail_frames < 0)
@@ -2014,13 +2015,10 @@ bool AudioDeviceLinuxALSA::PlayThreadProcess()
                    "playout snd_pcm_avail_update error: %s",
                    LATE(snd_strerror)(avail_frames));
         ErrorRecovery(avail_frames, _handlePlayout);
-        UnLock();
         return true;
     }
     else if (avail_frames == 0)
     {
-        UnLock();
-
         //maximum tixe in milliseconds to wait, a negative value means infinity
         err = LATE(snd_pcm_wait)(_handlePlayout, 2);
         if (err == 0)
@@ -2034,9 +2032,22 @@ bool AudioDeviceLinuxALSA::PlayThreadProcess()
 
     if (_playoutFramesLeft <= 0)
     {
-        UnLock();
+        // Publish the delay for the recording thread, which reports it along
+        // with the recorded audio.
+        snd_pcm_sframes_t delayFrames = 0;
+        err = LATE(snd_pcm_delay)(_handlePlayout, &delayFrames);
+        if (err < 0)
+        {
+            delayFrames = 0;
+            WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
+                         "playout snd_pcm_delay: %s",
+                         LATE(snd_strerror)(err));
+        }
+        rtc::AtomicOps::Store(&_playoutDelayMs,
+                              static_cast<int>(delayFrames * 1000 /
+                                               _playoutFreq));
+
         _ptrAudioBuffer->RequestPlayoutData(_playoutFramesIn10MS);
-        Lock();
 
         _playoutFramesLeft = _ptrAudioBuffer->GetPlayoutData(_playoutBuffer);
         assert(_playoutFramesLeft == _playoutFramesIn10MS);
@@ -2059,7 +2070,6 @@ bool AudioDeviceLinuxALSA::PlayThreadProcess()
                      LATE(snd_strerror)(frames));
         _playoutFramesLeft = 0;
         ErrorRecovery(frames, _handlePlayout);
-        UnLock();
         return true;
     }
     else {
@@ -2067,7 +2077,6 @@ bool AudioDeviceLinuxALSA::PlayThreadProcess()
         _playoutFramesLeft -= frames;
     }
 
-    UnLock();
     return true;
 }
 
@@ -2081,8 +2090,6 @@ bool AudioDeviceLinuxALSA::RecThreadProcess()
     snd_pcm_sframes_t avail_frames;
     int8_t buffer[_recordingBufferSizeIn10MS];
 
-    Lock();
-
     //return a positive number of frames ready otherwise a negative error code
     avail_frames = LATE(snd_pcm_avail_update)(_handleRecord);
     if (avail_frames < 0)
@@ -2091,13 +2098,10 @@ bool AudioDeviceLinuxALSA::RecThreadProcess()
                      "capture snd_pcm_avail_update error: %s",
                      LATE(snd_strerror)(avail_frames));
         ErrorRecovery(avail_frames, _handleRecord);
-        UnLock();
         return true;
     }
     else if (avail_frames == 0)
     { // no frame is available now
-        UnLock();
-
         //maximum time in milliseconds to wait, a negative value means infinity
         err = LATE(snd_pcm_wait)(_handleRecord,
             ALSA_CAPTURE_WAIT_TIMEOUT);
@@ -2119,7 +2123,6 @@ bool AudioDeviceLinuxALSA::RecThreadProcess()
                      "capture snd_pcm_readi error: %s",
                      LATE(snd_strerror)(frames));
         ErrorRecovery(frames, _handleRecord);
-        UnLock();
         return true;
     }
     else if (frames > 0)
@@ -2158,23 +2161,9 @@ bool AudioDeviceLinuxALSA::RecThreadProcess()
                 }
             }
 
-            // calculate delay
-            _playoutDelay = 0;
+            // calculate delay; the playout delay is measured by the playout
+            // thread, which owns |_handlePlayout|.
             _recordingDelay = 0;
-            if (_handlePlayout)
-            {
-                err = LATE(snd_pcm_delay)(_handlePlayout,
-                    &_playoutDelay); // returned delay in frames
-                if (err < 0)
-                {
-                    // TODO(xians): Shall we call ErrorRecovery() here?
-                    _playoutDelay = 0;
-                    WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
-                                 "playout snd_pcm_delay: %s",
-                                 LATE(snd_strerror)(err));
-                }
-            }
-
             err = LATE(snd_pcm_delay)(_handleRecord,
                 &_recordingDelay); // returned delay in frames
             if (err < 0)
@@ -2188,16 +2177,14 @@ bool AudioDeviceLinuxALSA::RecThreadProcess()
 
            // TODO(xians): Shall we add 10ms buffer delay to the record delay?
             _ptrAudioBuffer->SetVQEData(
-                _playoutDelay * 1000 / _playoutFreq,
+                rtc::AtomicOps::Load(&_playoutDelayMs),
                 _recordingDelay * 1000 / _recordingFreq, 0);
 
             _ptrAudioBuffer->SetTypingStatus(KeyPressed());
 
             // Deliver recorded samples at specified sample rate, mic level etc.
             // to the observer using callback.
-            UnLock();
             _ptrAudioBuffer->DeliverRecordedData();
-            Lock();
 
             if (AGC())
             {
@@ -2216,7 +2203,6 @@ bool AudioDeviceLinuxALSA::RecThreadProcess()
         }
     }
 
-    UnLock();
     return true;
 }
 
@@ -231,7 +231,9 @@ private:
     bool _AGC;
 
     snd_pcm_sframes_t _recordingDelay;
-    snd_pcm_sframes_t _playoutDelay;
+    // Written by the playout thread and read by the recording thread, which
+    // don't share |_critSect| or the device handles.
+    volatile int _playoutDelayMs;
 
     uint16_t _playWarning;
     uint16_t _playError;
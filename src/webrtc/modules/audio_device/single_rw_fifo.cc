@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_device/single_rw_fifo.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/base/atomicops.h"
+
+namespace webrtc {
+
+SingleRwFifo::SingleRwFifo(size_t capacity)
+    : size_(static_cast<int>(capacity) + 1),
+      buffer_(new uint8_t[size_]),
+      read_pos_(0),
+      write_pos_(0) {
+}
+
+SingleRwFifo::~SingleRwFifo() {
+}
+
+bool SingleRwFifo::Write(const void* data, size_t length) {
+  return Write(NULL, 0, data, length);
+}
+
+bool SingleRwFifo::Write(const void* header, size_t header_length,
+                         const void* data, size_t length) {
+  const int read_pos = rtc::AtomicOps::Load(&read_pos_);
+  const int write_pos = write_pos_;
+  const int free = (read_pos - write_pos - 1 + size_) % size_;
+  if (static_cast<int>(header_length + length) > free)
+    return false;
+  const int pos = CopyIn(write_pos, header, header_length);
+  // Store() is a barrier, so the reader sees the data before the position.
+  rtc::AtomicOps::Store(&write_pos_, CopyIn(pos, data, length));
+  return true;
+}
+
+size_t SingleRwFifo::Read(void* data, size_t max_length) {
+  const int write_pos = rtc::AtomicOps::Load(&write_pos_);
+  const int read_pos = read_pos_;
+  const int length = std::min((write_pos - read_pos + size_) % size_,
+                              static_cast<int>(max_length));
+  uint8_t* out = static_cast<uint8_t*>(data);
+  const int first = std::min(length, size_ - read_pos);
+  memcpy(out, &buffer_[read_pos], first);
+  memcpy(out + first, &buffer_[0], length - first);
+  // The data is copied out before the writer may overwrite it.
+  rtc::AtomicOps::Store(&read_pos_, (read_pos + length) % size_);
+  return length;
+}
+
+int SingleRwFifo::CopyIn(int pos, const void* data, size_t length) {
+  if (length == 0)
+    return pos;
+  const uint8_t* in = static_cast<const uint8_t*>(data);
+  const int first = std::min(static_cast<int>(length), size_ - pos);
+  memcpy(&buffer_[pos], in, first);
+  memcpy(&buffer_[0], in + first, length - first);
+  return (pos + static_cast<int>(length)) % size_;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,59 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_DEVICE_SINGLE_RW_FIFO_H_
+#define WEBRTC_MODULES_AUDIO_DEVICE_SINGLE_RW_FIFO_H_
+
+#include <stddef.h>
+
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// A byte FIFO with one writer thread and one reader thread which never block
+// each other: the writer drops data which doesn't fit, and the reader gets
+// whatever has been written so far. It lets the audio threads hand data to
+// threads which may block, e.g., on file I/O, without taking a lock.
+class SingleRwFifo {
+ public:
+  explicit SingleRwFifo(size_t capacity);
+  ~SingleRwFifo();
+
+  // Writes all of |data|, or nothing and returns false if there is room for
+  // less than |length| bytes. Only called on the writer thread.
+  bool Write(const void* data, size_t length);
+  // Writes |header| followed by |data| the same way, so that the reader never
+  // sees one without the other.
+  bool Write(const void* header, size_t header_length,
+             const void* data, size_t length);
+
+  // Reads up to |max_length| bytes into |data| and returns the number of bytes
+  // read. Only called on the reader thread.
+  size_t Read(void* data, size_t max_length);
+
+  size_t capacity() const { return size_ - 1; }
+
+ private:
+  // Copies |data| in at |pos| and returns the position after it.
+  int CopyIn(int pos, const void* data, size_t length);
+
+  // One byte more than the capacity, so that a full FIFO can be told from an
+  // empty one.
+  const int size_;
+  rtc::scoped_ptr<uint8_t[]> buffer_;
+  // Written by the reader and the writer thread, respectively.
+  volatile int read_pos_;
+  volatile int write_pos_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_DEVICE_SINGLE_RW_FIFO_H_
@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_device/single_rw_fifo.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kNumBytes = 100000;
+
+// Writes the bytes 0, 1, 2, ... in chunks of varying size, retrying while the
+// FIFO is full.
+class Writer {
+ public:
+  explicit Writer(SingleRwFifo* fifo) : fifo_(fifo), next_(0) {}
+
+  static bool Run(void* obj) { return static_cast<Writer*>(obj)->Process(); }
+
+ private:
+  bool Process() {
+    uint8_t chunk[97];
+    const int length = std::min(1 + next_ % 97, kNumBytes - next_);
+    for (int i = 0; i < length; ++i)
+      chunk[i] = static_cast<uint8_t>(next_ + i);
+    if (fifo_->Write(chunk, length))
+      next_ += length;
+    return next_ < kNumBytes;
+  }
+
+  SingleRwFifo* const fifo_;
+  int next_;
+};
+
+}  // namespace
+
+TEST(SingleRwFifoTest, ReadsWhatWasWritten) {
+  SingleRwFifo fifo(10);
+  EXPECT_EQ(10u, fifo.capacity());
+  uint8_t out[10];
+  EXPECT_EQ(0u, fifo.Read(out, sizeof(out)));
+
+  const uint8_t kData[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  EXPECT_TRUE(fifo.Write(kData, 6));
+  EXPECT_EQ(4u, fifo.Read(out, 4));
+  EXPECT_EQ(0, memcmp(kData, out, 4));
+
+  // Wraps around the end of the buffer.
+  EXPECT_TRUE(fifo.Write(kData, 8));
+  EXPECT_EQ(10u, fifo.Read(out, sizeof(out)));
+  EXPECT_EQ(0, memcmp(&kData[4], out, 2));
+  EXPECT_EQ(0, memcmp(kData, &out[2], 8));
+  EXPECT_EQ(0u, fifo.Read(out, sizeof(out)));
+}
+
+TEST(SingleRwFifoTest, DropsWritesWhichDontFit) {
+  SingleRwFifo fifo(8);
+  const uint8_t kData[9] = {0};
+  EXPECT_FALSE(fifo.Write(kData, 9));
+  EXPECT_TRUE(fifo.Write(kData, 5));
+  EXPECT_FALSE(fifo.Write(kData, 4));
+  EXPECT_TRUE(fifo.Write(kData, 3));
+  EXPECT_FALSE(fifo.Write(kData, 1));
+
+  uint8_t out[8];
+  EXPECT_EQ(2u, fifo.Read(out, 2));
+  EXPECT_TRUE(fifo.Write(kData, 2));
+  EXPECT_EQ(8u, fifo.Read(out, sizeof(out)));
+}
+
+TEST(SingleRwFifoTest, WritesHeaderAndDataTogether) {
+  SingleRwFifo fifo(8);
+  const uint8_t kHeader[] = {1, 2};
+  const uint8_t kData[] = {3, 4, 5, 6, 7};
+  EXPECT_TRUE(fifo.Write(kHeader, sizeof(kHeader), kData, 3));
+  // Only the header would fit.
+  EXPECT_FALSE(fifo.Write(kHeader, sizeof(kHeader), kData, sizeof(kData)));
+
+  uint8_t out[8];
+  EXPECT_EQ(5u, fifo.Read(out, sizeof(out)));
+  EXPECT_EQ(0, memcmp(kHeader, out, 2));
+  EXPECT_EQ(0, memcmp(kData, &out[2], 3));
+
+  // Wraps around the end of the buffer within the header.
+  EXPECT_TRUE(fifo.Write(kData, 3));
+  EXPECT_EQ(3u, fifo.Read(out, sizeof(out)));
+  EXPECT_TRUE(fifo.Write(kHeader, sizeof(kHeader), kData, sizeof(kData)));
+  EXPECT_EQ(7u, fifo.Read(out, sizeof(out)));
+  EXPECT_EQ(0, memcmp(kHeader, out, 2));
+  EXPECT_EQ(0, memcmp(kData, &out[2], 5));
+}
+
+TEST(SingleRwFifoTest, PassesBytesInOrderBetweenThreads) {
+  SingleRwFifo fifo(256);
+  Writer writer(&fifo);
+  rtc::scoped_ptr<ThreadWrapper> thread =
+      ThreadWrapper::CreateThread(&Writer::Run, &writer, "writer");
+  ASSERT_TRUE(thread->Start());
+
+  std::vector<uint8_t> received;
+  uint8_t out[61];
+  while (received.size() < static_cast<size_t>(kNumBytes)) {
+    const size_t length = fifo.Read(out, sizeof(out));
+    received.insert(received.end(), out, out + length);
+  }
+  EXPECT_TRUE(thread->Stop());
+
+  for (int i = 0; i < kNumBytes; ++i)
+    ASSERT_EQ(static_cast<uint8_t>(i), received[i]) << "at byte " << i;
+  EXPECT_EQ(0u, fifo.Read(out, sizeof(out)));
+}
+
+}  // namespace webrtc
@@ -12,43 +12,91 @@
 
 #include "string.h"
 
-#include "webrtc/modules/desktop_capture/differ_block.h"
-#include "webrtc/system_wrappers/interface/logging.h"
+#include <algorithm>
+
+#include "webrtc/system_wrappers/interface/worker_pool.h"
 
 namespace webrtc {
 
-Differ::Differ(int width, int height, int bpp, int stride) {
-  // Dimensions of screen.
-  width_ = width;
-  height_ = height;
-  bytes_per_pixel_ = bpp;
-  bytes_per_row_ = stride;
-
-  // Calc number of blocks (full and partial) required to cover entire image.
-  // One additional row/column is added as a boundary on the right & bottom.
-  diff_info_width_ = ((width_ + kBlockSize - 1) / kBlockSize) + 1;
-  diff_info_height_ = ((height_ + kBlockSize - 1) / kBlockSize) + 1;
-  diff_info_size_ = diff_info_width_ * diff_info_height_ * sizeof(bool);
-  diff_info_.reset(new bool[diff_info_size_]);
+// Each thread compares at least this many rows of blocks, so that small
+// frames aren't split into stripes which take longer to hand out than to
+// compare.
+static const int kMinBlockRowsPerStripe = 4;
+
+struct Differ::DiffJob {
+  Differ* differ;
+  const uint8_t* prev_buffer;
+  const uint8_t* curr_buffer;
+  int num_stripes;
+};
+
+Differ::Differ(int width, int height, int bpp, int stride)
+    : Differ(width, height, bpp, stride, WorkerPool::GetSharedPool()) {
+  uses_shared_pool_ = true;
+}
+
+Differ::Differ(int width, int height, int bpp, int stride,
+               WorkerPool* pool)
+    : width_(width),
+      height_(height),
+      bytes_per_pixel_(bpp),
+      bytes_per_row_(stride),
+      block_rows_((height + kBlockSize - 1) / kBlockSize),
+      thread_pool_(pool),
+      uses_shared_pool_(false),
+      block_difference_(GetBlockDifferenceFunction()) {
+  int num_stripes = 1;
+  if (thread_pool_) {
+    // The calling thread compares a stripe as well.
+    const int num_threads = static_cast<int>(thread_pool_->num_threads()) + 1;
+    num_stripes = std::max(1, std::min(num_threads,
+                                       block_rows_ / kMinBlockRowsPerStripe));
+  }
+  stripe_regions_.resize(num_stripes);
 }
 
-Differ::~Differ() {}
+Differ::~Differ() {
+  if (uses_shared_pool_)
+    WorkerPool::ReturnSharedPool();
+}
 
 void Differ::CalcDirtyRegion(const uint8_t* prev_buffer,
                              const uint8_t* curr_buffer,
                              DesktopRegion* region) {
-  // Identify all the blocks that contain changed pixels.
-  MarkDirtyBlocks(prev_buffer, curr_buffer);
+  region->Clear();
+  if (stripe_regions_.size() == 1) {
+    AddDirtyBlocks(prev_buffer, curr_buffer, 0, block_rows_, region);
+    return;
+  }
 
-  // Now that we've identified the blocks that have changed, merge adjacent
-  // blocks to minimize the number of rects that we return.
-  MergeBlocks(region);
+  DiffJob job;
+  job.differ = this;
+  job.prev_buffer = prev_buffer;
+  job.curr_buffer = curr_buffer;
+  job.num_stripes = static_cast<int>(stripe_regions_.size());
+  thread_pool_->Run(&Differ::DiffStripe, &job, job.num_stripes);
+  // The stripes cover separate rows, so this only joins their regions.
+  for (size_t i = 0; i < stripe_regions_.size(); ++i)
+    region->AddRegion(stripe_regions_[i]);
 }
 
-void Differ::MarkDirtyBlocks(const uint8_t* prev_buffer,
-                             const uint8_t* curr_buffer) {
-  memset(diff_info_.get(), 0, diff_info_size_);
+void Differ::DiffStripe(void* context, size_t index) {
+  DiffJob* job = static_cast<DiffJob*>(context);
+  const int stripe = static_cast<int>(index);
+  Differ* differ = job->differ;
+  DesktopRegion* region = &differ->stripe_regions_[index];
+  region->Clear();
+  differ->AddDirtyBlocks(
+      job->prev_buffer, job->curr_buffer,
+      differ->block_rows_ * stripe / job->num_stripes,
+      differ->block_rows_ * (stripe + 1) / job->num_stripes, region);
+}
 
+void Differ::AddDirtyBlocks(const uint8_t* prev_buffer,
+                            const uint8_t* curr_buffer,
+                            int first_block_row,
+                            int end_block_row,
+                            DesktopRegion* region) {
   // Calc number of full blocks.
   int x_full_blocks = width_ / kBlockSize;
   int y_full_blocks = height_ / kBlockSize;
@@ -60,69 +108,54 @@ void Differ::MarkDirtyBlocks(const uint8_t* prev_buffer,
   // Offset from the start of one block-column to the next.
   int block_x_offset = bytes_per_pixel_ * kBlockSize;
   // Offset from the start of one block-row to the next.
-  int block_y_stride = (width_ * bytes_per_pixel_) * kBlockSize;
-  // Offset from the start of one diff_info row to the next.
-  int diff_info_stride = diff_info_width_ * sizeof(bool);
-
-  const uint8_t* prev_block_row_start = prev_buffer;
-  const uint8_t* curr_block_row_start = curr_buffer;
-  bool* diff_info_row_start = diff_info_.get();
-
-  for (int y = 0; y < y_full_blocks; y++) {
-    const uint8_t* prev_block = prev_block_row_start;
-    const uint8_t* curr_block = curr_block_row_start;
-    bool* diff_info = diff_info_row_start;
-
+  int block_y_stride = bytes_per_row_ * kBlockSize;
+
+  for (int y = first_block_row; y < end_block_row; y++) {
+    const uint8_t* prev_block = prev_buffer + y * block_y_stride;
+    const uint8_t* curr_block = curr_buffer + y * block_y_stride;
+    int top = y * kBlockSize;
+    // The last row may be a partial one. This situation is far more common
+    // than the 'partial column' case.
+    bool partial_row = y == y_full_blocks;
+    int height = partial_row ? partial_row_height : kBlockSize;
+
+    // Start of the run of dirty blocks being collected, or -1.
+    int run_start = -1;
     for (int x = 0; x < x_full_blocks; x++) {
-      // Mark this block as being modified so that it gets incorporated into
-      // a dirty rect.
-      *diff_info = BlockDifference(prev_block, curr_block, bytes_per_row_);
+      bool dirty = partial_row ?
+          !PartialBlocksEqual(prev_block, curr_block, kBlockSize, height) :
+          block_difference_(prev_block, curr_block, bytes_per_row_);
+      if (dirty && run_start < 0) {
+        run_start = x;
+      } else if (!dirty && run_start >= 0) {
+        region->AddRect(DesktopRect::MakeLTRB(
+            run_start * kBlockSize, top, x * kBlockSize, top + height));
+        run_start = -1;
+      }
       prev_block += block_x_offset;
       curr_block += block_x_offset;
-      diff_info += sizeof(bool);
     }
 
     // If there is a partial column at the end, handle it.
     // This condition should rarely, if ever, occur.
-    if (partial_column_width != 0) {
-      *diff_info = !PartialBlocksEqual(prev_block, curr_block, bytes_per_row_,
-                                       partial_column_width, kBlockSize);
-      diff_info += sizeof(bool);
+    int run_end = x_full_blocks * kBlockSize;
+    if (partial_column_width != 0 &&
+        !PartialBlocksEqual(prev_block, curr_block, partial_column_width,
+                            height)) {
+      if (run_start < 0)
+        run_start = x_full_blocks;
+      run_end = width_;
     }
-
-    // Update pointers for next row.
-    prev_block_row_start += block_y_stride;
-    curr_block_row_start += block_y_stride;
-    diff_info_row_start += diff_info_stride;
-  }
-
-  // If the screen height is not a multiple of the block size, then this
-  // handles the last partial row. This situation is far more common than the
-  // 'partial column' case.
-  if (partial_row_height != 0) {
-    const uint8_t* prev_block = prev_block_row_start;
-    const uint8_t* curr_block = curr_block_row_start;
-    bool* diff_info = diff_info_row_start;
-    for (int x = 0; x < x_full_blocks; x++) {
-      *diff_info = !PartialBlocksEqual(prev_block, curr_block,
-                                       bytes_per_row_,
-                                       kBlockSize, partial_row_height);
-      prev_block += block_x_offset;
-      curr_block += block_x_offset;
-      diff_info += sizeof(bool);
-    }
-    if (partial_column_width != 0) {
-      *diff_info = !PartialBlocksEqual(prev_block, curr_block, bytes_per_row_,
-                                       partial_column_width,
-                                       partial_row_height);
-      diff_info += sizeof(bool);
+    if (run_start >= 0) {
+      region->AddRect(DesktopRect::MakeLTRB(
+          run_start * kBlockSize, top, run_end, top + height));
     }
   }
 }
 
 bool Differ::PartialBlocksEqual(const uint8_t* prev_buffer,
                                 const uint8_t* curr_buffer,
-                                int stride, int width, int height) {
+                                int width, int height) {
   int width_bytes = width * bytes_per_pixel_;
   for (int y = 0; y < height; y++) {
     if (memcmp(prev_buffer, curr_buffer, width_bytes) != 0)
@@ -133,79 +166,4 @@ bool Differ::PartialBlocksEqual(const uint8_t* prev_buffer,
   return true;
 }
 
-void Differ::MergeBlocks(DesktopRegion* region) {
-  region->Clear();
-
-  bool* diff_info_row_start = diff_info_.get();
-  int diff_info_stride = diff_info_width_ * sizeof(bool);
-
-  for (int y = 0; y < diff_info_height_; y++) {
-    bool* diff_info = diff_info_row_start;
-    for (int x = 0; x < diff_info_width_; x++) {
-      if (*diff_info) {
-        // We've found a modified block. Look at blocks to the right and below
-        // to group this block with as many others as we can.
-        int left = x * kBlockSize;
-        int top = y * kBlockSize;
-        int width = 1;
-        int height = 1;
-        *diff_info = false;
-
-        // Group with blocks to the right.
-        // We can keep looking until we find an unchanged block because we
-        // have a boundary block which is never marked as having diffs.
-        bool* right = diff_info + 1;
-        while (*right) {
-          *right++ = false;
-          width++;
-        }
-
-        // Group with blocks below.
-        // The entire width of blocks that we matched above much match for
-        // each row that we add.
-        bool* bottom = diff_info;
-        bool found_new_row;
-        do {
-          found_new_row = true;
-          bottom += diff_info_stride;
-          right = bottom;
-          for (int x2 = 0; x2 < width; x2++) {
-            if (!*right++) {
-              found_new_row = false;
-            }
-          }
-
-          if (found_new_row) {
-            height++;
-
-            // We need to go back and erase the diff markers so that we don't
-            // try to add these blocks a second time.
-            right = bottom;
-            for (int x2 = 0; x2 < width; x2++) {
-              *right++ = false;
-            }
-          }
-        } while (found_new_row);
-
-        // Add rect to list of dirty rects.
-        width *= kBlockSize;
-        if (left + width > width_) {
-          width = width_ - left;
-        }
-        height *= kBlockSize;
-        if (top + height > height_) {
-          height = height_ - top;
-        }
-        region->AddRect(DesktopRect::MakeXYWH(left, top, width, height));
-      }
-
-      // Increment to next block in this row.
-      diff_info++;
-    }
-
-    // Go to start of next row.
-    diff_info_row_start += diff_info_stride;
-  }
-}
-
 }  // namespace webrtc
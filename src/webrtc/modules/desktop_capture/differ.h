@@ -11,24 +11,30 @@
 #ifndef WEBRTC_MODULES_DESKTOP_CAPTURE_DIFFER_H_
 #define WEBRTC_MODULES_DESKTOP_CAPTURE_DIFFER_H_
 
+#include <stddef.h>
+
 #include <vector>
 
-#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/desktop_capture/desktop_region.h"
+#include "webrtc/modules/desktop_capture/differ_block.h"
 
 namespace webrtc {
 
-// TODO(sergeyu): Simplify differ now that we are working with DesktopRegion.
-// diff_info_ should no longer be needed, as we can put our data directly into
-// the region that we are calculating.
-// http://crbug.com/92379
+class WorkerPool;
+
 // TODO(sergeyu): Rename this class to something more sensible, e.g.
 // ScreenCaptureFrameDifferencer.
 class Differ {
  public:
   // Create a differ that operates on bitmaps with the specified width, height
-  // and bytes_per_pixel.
+  // and bytes_per_pixel. Large frames are compared on the threads of the
+  // shared WorkerPool.
   Differ(int width, int height, int bytes_per_pixel, int stride);
+  // As above, but compares frames on the threads of |pool|, or only on the
+  // calling thread if |pool| is NULL.
+  Differ(int width, int height, int bytes_per_pixel, int stride,
+         WorkerPool* pool);
   ~Differ();
 
   int width() { return width_; }
@@ -42,16 +48,19 @@ class Differ {
                        DesktopRegion* region);
 
  private:
-  // Allow tests to access our private parts.
-  friend class DifferTest;
+  struct DiffJob;
 
-  // Identify all of the blocks that contain changed pixels.
-  void MarkDirtyBlocks(const uint8_t* prev_buffer, const uint8_t* curr_buffer);
+  static void DiffStripe(void* context, size_t index);
 
-  // After the dirty blocks have been identified, this routine merges adjacent
-  // blocks into a region.
-  // The goal is to minimize the region that covers the dirty blocks.
-  void MergeBlocks(DesktopRegion* region);
+  // Adds the blocks in rows [|first_block_row|, |end_block_row|) which
+  // contain changed pixels to |region|. Runs of changed blocks in a row are
+  // added as one rectangle, and DesktopRegion merges identical runs of
+  // adjacent rows.
+  void AddDirtyBlocks(const uint8_t* prev_buffer,
+                      const uint8_t* curr_buffer,
+                      int first_block_row,
+                      int end_block_row,
+                      DesktopRegion* region);
 
   // Checks whether the upper-left portions of the buffers are equal. The size
   // of the portion to check is specified by the |width| and |height| values.
@@ -59,7 +68,6 @@ class Differ {
   // height are multiples of kBlockSize, then this will never be called.
   bool PartialBlocksEqual(const uint8_t* prev_buffer,
                           const uint8_t* curr_buffer,
-                          int stride,
                           int width, int height);
 
   // Dimensions of screen.
@@ -73,13 +81,16 @@ class Differ {
   // Number of bytes in each row of the image (AKA: stride).
   int bytes_per_row_;
 
-  // Diff information for each block in the image.
-  rtc::scoped_ptr<bool[]> diff_info_;
+  // Number of rows of blocks (full and partial) covering the image.
+  int block_rows_;
+
+  WorkerPool* const thread_pool_;
+  // Whether |thread_pool_| is the shared pool, which must be returned.
+  bool uses_shared_pool_;
+  const BlockDifferenceFunction block_difference_;
 
-  // Dimensions and total size of diff info array.
-  int diff_info_width_;
-  int diff_info_height_;
-  int diff_info_size_;
+  // The dirty region of each stripe of block rows.
+  std::vector<DesktopRegion> stripe_regions_;
 
   DISALLOW_COPY_AND_ASSIGN(Differ);
 };
@@ -28,6 +28,15 @@ bool BlockDifference(const uint8_t* image1,
                      const uint8_t* image2,
                      int stride);
 
+typedef bool (*BlockDifferenceFunction)(const uint8_t* image1,
+                                        const uint8_t* image2,
+                                        int stride);
+
+// Returns the fastest implementation of BlockDifference() for this CPU.
+// Unlike BlockDifference(), this may be called on any number of threads at
+// once.
+BlockDifferenceFunction GetBlockDifferenceFunction();
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_MODULES_DESKTOP_CAPTURE_DIFFER_BLOCK_H_
@@ -84,4 +84,20 @@ TEST(BlockDifferenceTestFirst, BlockDifference) {
   }
 }
 
+TEST(BlockDifferenceTestEachByte, GetBlockDifferenceFunction) {
+  uint8_t* block1;
+  uint8_t* block2;
+  PrepareBuffers(block1, block2);
+  BlockDifferenceFunction block_difference = GetBlockDifferenceFunction();
+
+  EXPECT_FALSE(
+      block_difference(block1, block2, kBlockSize * kBytesPerPixel));
+  for (int i = 0; i < kSizeOfBlock; ++i) {
+    block2[i] += 1;
+    EXPECT_TRUE(block_difference(block1, block2, kBlockSize * kBytesPerPixel))
+        << "when byte " << i << " differs";
+    block2[i] -= 1;
+  }
+}
+
 }  // namespace webrtc
@@ -0,0 +1,179 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures how long Differ takes to find the dirty region of 4K and 5K
+// frames on one and on all cores, for synthetic changes and for recorded
+// screen content (the screenshare slides tiled to fill the screen).
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/desktop_capture/differ.h"
+#include "webrtc/modules/desktop_capture/differ_block.h"
+#include "webrtc/system_wrappers/interface/cpu_info.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/system_wrappers/interface/worker_pool.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kNumFrames = 20;
+const int kSlideWidth = 1850;
+const int kSlideHeight = 1110;
+
+struct Resolution {
+  const char* name;
+  int width;
+  int height;
+};
+
+const Resolution kResolutions[] = {
+  {"4k", 3840, 2160},
+  {"5k", 5120, 2880},
+};
+
+// Reads the first frame of the I420 resource |name| into |frame|.
+bool ReadSlide(const std::string& name, I420VideoFrame* frame) {
+  const size_t length = CalcBufferSize(kI420, kSlideWidth, kSlideHeight);
+  rtc::scoped_ptr<uint8_t[]> buffer(new uint8_t[length]);
+  FILE* file = fopen(test::ResourcePath(name, "yuv").c_str(), "rb");
+  if (!file)
+    return false;
+  bool read = fread(buffer.get(), 1, length, file) == length;
+  fclose(file);
+  return read && frame->CreateFrame(buffer.get(), kSlideWidth, kSlideHeight,
+                                    kVideoRotation_0) == 0;
+}
+
+// Fills |screen|, which is |width| pixels wide and |height| high, with
+// copies of |slide|.
+void TileSlide(const I420VideoFrame& slide, int width, int height,
+               uint8_t* screen) {
+  const int slide_stride = kSlideWidth * kBytesPerPixel;
+  rtc::scoped_ptr<uint8_t[]> argb(new uint8_t[slide_stride * kSlideHeight]);
+  ConvertFromI420(slide, kARGB, 0, argb.get());
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* src = argb.get() + (y % kSlideHeight) * slide_stride;
+    uint8_t* dst = screen + y * width * kBytesPerPixel;
+    for (int x = 0; x < width; x += kSlideWidth) {
+      memcpy(dst + x * kBytesPerPixel, src,
+             std::min(kSlideWidth, width - x) * kBytesPerPixel);
+    }
+  }
+}
+
+// Prints the time it takes |differ| to compare |prev| and |curr|.
+void MeasureDiffer(Differ* differ,
+                   const uint8_t* prev,
+                   const uint8_t* curr,
+                   const std::string& trace) {
+  DesktopRegion dirty;
+  // The first call pays for starting the threads and the page faults.
+  differ->CalcDirtyRegion(prev, curr, &dirty);
+  const int64_t start_us = TickTime::MicrosecondTimestamp();
+  for (int i = 0; i < kNumFrames; ++i)
+    differ->CalcDirtyRegion(prev, curr, &dirty);
+  const int64_t elapsed_us = TickTime::MicrosecondTimestamp() - start_us;
+  test::PrintResult("differ_time", "", trace,
+                    static_cast<double>(elapsed_us) / kNumFrames, "us",
+                    false);
+}
+
+// Measures the differ with one thread and with one thread per core on each
+// pair of |prev| and |curr| frames named in |contents|.
+void RunContents(const Resolution& resolution,
+                 const char* const contents[],
+                 const uint8_t* const prev[],
+                 const uint8_t* const curr[],
+                 int num_contents) {
+  const int stride = resolution.width * kBytesPerPixel;
+  const int num_cores = CpuInfo::DetectNumberOfCores();
+  WorkerPool pool(num_cores - 1, "DifferPerfThread");
+  Differ single_differ(resolution.width, resolution.height, kBytesPerPixel,
+                       stride, NULL);
+  Differ threaded_differ(resolution.width, resolution.height, kBytesPerPixel,
+                         stride, &pool);
+  for (int i = 0; i < num_contents; ++i) {
+    std::stringstream trace;
+    trace << resolution.name << "_" << contents[i] << "_";
+    MeasureDiffer(&single_differ, prev[i], curr[i], trace.str() + "1_thread");
+    if (num_cores > 1) {
+      std::stringstream threads;
+      threads << num_cores << "_threads";
+      MeasureDiffer(&threaded_differ, prev[i], curr[i],
+                    trace.str() + threads.str());
+    }
+  }
+}
+
+}  // namespace
+
+TEST(DifferPerfTest, SyntheticContent) {
+  for (const Resolution& resolution : kResolutions) {
+    const int stride = resolution.width * kBytesPerPixel;
+    const size_t size = static_cast<size_t>(stride) * resolution.height;
+    rtc::scoped_ptr<uint8_t[]> prev(new uint8_t[size]);
+    for (size_t i = 0; i < size; ++i)
+      prev[i] = static_cast<uint8_t>(i * 7 + i / stride);
+    // Static: nothing changes, so every block is compared to its end.
+    rtc::scoped_ptr<uint8_t[]> unchanged(new uint8_t[size]);
+    memcpy(unchanged.get(), prev.get(), size);
+    // Typing: a line of text, about 20 by 800 pixels, changes.
+    rtc::scoped_ptr<uint8_t[]> typing(new uint8_t[size]);
+    memcpy(typing.get(), prev.get(), size);
+    for (int y = 500; y < 520; ++y)
+      memset(&typing[y * stride + 100 * kBytesPerPixel], 0,
+             800 * kBytesPerPixel);
+    // Scrolling: every row changes.
+    rtc::scoped_ptr<uint8_t[]> scrolled(new uint8_t[size]);
+    memcpy(scrolled.get(), prev.get() + stride, size - stride);
+    memset(scrolled.get() + size - stride, 0, stride);
+
+    const char* const contents[] = {"static", "typing", "scrolling"};
+    const uint8_t* const prevs[] = {prev.get(), prev.get(), prev.get()};
+    const uint8_t* const currs[] = {unchanged.get(), typing.get(),
+                                    scrolled.get()};
+    RunContents(resolution, contents, prevs, currs, 3);
+  }
+}
+
+TEST(DifferPerfTest, RecordedContent) {
+  I420VideoFrame web_page;
+  I420VideoFrame presentation;
+  ASSERT_TRUE(ReadSlide("web_screenshot_1850_1110", &web_page));
+  ASSERT_TRUE(ReadSlide("presentation_1850_1110", &presentation));
+  for (const Resolution& resolution : kResolutions) {
+    const size_t size = static_cast<size_t>(resolution.width) *
+                        resolution.height * kBytesPerPixel;
+    rtc::scoped_ptr<uint8_t[]> prev(new uint8_t[size]);
+    rtc::scoped_ptr<uint8_t[]> unchanged(new uint8_t[size]);
+    rtc::scoped_ptr<uint8_t[]> curr(new uint8_t[size]);
+    TileSlide(web_page, resolution.width, resolution.height, prev.get());
+    TileSlide(web_page, resolution.width, resolution.height, unchanged.get());
+    TileSlide(presentation, resolution.width, resolution.height, curr.get());
+
+    // Unchanged, mostly flat content, and a switch to the next slide.
+    const char* const contents[] = {"slide_static", "slide_switch"};
+    const uint8_t* const prevs[] = {prev.get(), prev.get()};
+    const uint8_t* const currs[] = {unchanged.get(), curr.get()};
+    RunContents(resolution, contents, prevs, currs, 2);
+  }
+}
+
+}  // namespace webrtc
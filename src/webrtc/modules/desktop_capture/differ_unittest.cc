@@ -12,6 +12,7 @@
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/desktop_capture/differ.h"
 #include "webrtc/modules/desktop_capture/differ_block.h"
+#include "webrtc/system_wrappers/interface/worker_pool.h"
 
 namespace webrtc {
 
@@ -24,6 +25,11 @@ const int kScreenHeight = 96;
 const int kPartialScreenWidth = 70;
 const int kPartialScreenHeight = 70;
 
+// Large enough to be split in stripes, with partial blocks and padded rows.
+const int kLargeScreenWidth = 1000;
+const int kLargeScreenHeight = 700;
+const int kLargeScreenStride = 4096;
+
 class DifferTest : public testing::Test {
  public:
   DifferTest() {
@@ -31,11 +37,15 @@ class DifferTest : public testing::Test {
 
  protected:
   void InitDiffer(int width, int height) {
+    InitDiffer(width, height, kBytesPerPixel * width);
+  }
+
+  void InitDiffer(int width, int height, int stride) {
     width_ = width;
     height_ = height;
     bytes_per_pixel_ = kBytesPerPixel;
-    stride_ = (kBytesPerPixel * width);
-    buffer_size_ = width_ * height_ * bytes_per_pixel_;
+    stride_ = stride;
+    buffer_size_ = stride_ * height_;
 
     differ_.reset(new Differ(width_, height_, bytes_per_pixel_, stride_));
 
@@ -50,13 +60,11 @@ class DifferTest : public testing::Test {
     memset(buffer, 0, buffer_size_);
   }
 
-  // Here in DifferTest so that tests can access private methods of Differ.
-  void MarkDirtyBlocks(const uint8_t* prev_buffer, const uint8_t* curr_buffer) {
-    differ_->MarkDirtyBlocks(prev_buffer, curr_buffer);
-  }
-
-  void MergeBlocks(DesktopRegion* dirty) {
-    differ_->MergeBlocks(dirty);
+  // Returns the region which changed from |prev_| to |curr_|.
+  DesktopRegion CalcDirtyRegion() {
+    DesktopRegion dirty;
+    differ_->CalcDirtyRegion(prev_.get(), curr_.get(), &dirty);
+    return dirty;
   }
 
   // Convenience method to count rectangles in a region.
@@ -104,46 +112,30 @@ class DifferTest : public testing::Test {
     }
   }
 
-  // DiffInfo utility routines.
-  // These are here so that we don't have to make each DifferText_Xxx_Test
-  // class a friend class to Differ.
-
-  // Clear out the entire |diff_info_| buffer.
-  void ClearDiffInfo() {
-    memset(differ_->diff_info_.get(), 0, differ_->diff_info_size_);
+  // Number of (full and partial) columns of blocks covering the screen.
+  int BlockColumns() {
+    return (width_ + kBlockSize - 1) / kBlockSize;
   }
 
-  // Get the value in the |diff_info_| array at (x,y).
-  bool GetDiffInfo(int x, int y) {
-    bool* diff_info = differ_->diff_info_.get();
-    return diff_info[(y * GetDiffInfoWidth()) + x];
+  // Number of (full and partial) rows of blocks covering the screen.
+  int BlockRows() {
+    return (height_ + kBlockSize - 1) / kBlockSize;
   }
 
-  // Width of |diff_info_| array.
-  int GetDiffInfoWidth() {
-    return differ_->diff_info_width_;
+  // Whether any pixel of the block at (x,y) is in |region|.
+  bool IsBlockDirty(const DesktopRegion& region, int x, int y) {
+    DesktopRegion block(DesktopRect::MakeXYWH(x * kBlockSize, y * kBlockSize,
+                                              kBlockSize, kBlockSize));
+    block.IntersectWith(region);
+    return !block.is_empty();
   }
 
-  // Height of |diff_info_| array.
-  int GetDiffInfoHeight() {
-    return differ_->diff_info_height_;
-  }
-
-  // Size of |diff_info_| array.
-  int GetDiffInfoSize() {
-    return differ_->diff_info_size_;
-  }
-
-  void SetDiffInfo(int x, int y, bool value) {
-    bool* diff_info = differ_->diff_info_.get();
-    diff_info[(y * GetDiffInfoWidth()) + x] = value;
-  }
-
-  // Mark the range of blocks specified.
+  // Change the first pixel of each block in the range specified.
   void MarkBlocks(int x_origin, int y_origin, int width, int height) {
     for (int y = 0; y < height; y++) {
       for (int x = 0; x < width; x++) {
-        SetDiffInfo(x_origin + x, y_origin + y, true);
+        WriteBlockPixel(curr_.get(), x_origin + x, y_origin + y, 0, 0,
+                        0xff00ff);
       }
     }
   }
@@ -169,12 +161,10 @@ class DifferTest : public testing::Test {
   // Only one rectangular region of blocks can be checked with this routine.
   bool MarkBlocksAndCheckMerge(int x_origin, int y_origin,
                                int width, int height) {
-    ClearDiffInfo();
+    ClearBuffer(curr_.get());
     MarkBlocks(x_origin, y_origin, width, height);
 
-    DesktopRegion dirty;
-    MergeBlocks(&dirty);
-
+    DesktopRegion dirty = CalcDirtyRegion();
 
     DesktopRect expected_rect = DesktopRect::MakeXYWH(
         x_origin * kBlockSize, y_origin * kBlockSize,
@@ -209,64 +199,61 @@ class DifferTest : public testing::Test {
 
 TEST_F(DifferTest, Setup) {
   InitDiffer(kScreenWidth, kScreenHeight);
-  // 96x96 pixels results in 3x3 array. Add 1 to each dimension as boundary.
-  // +---+---+---+---+
-  // | o | o | o | _ |
-  // +---+---+---+---+  o = blocks mapped to screen pixels
-  // | o | o | o | _ |
-  // +---+---+---+---+  _ = boundary blocks
-  // | o | o | o | _ |
-  // +---+---+---+---+
-  // | _ | _ | _ | _ |
-  // +---+---+---+---+
-  EXPECT_EQ(4, GetDiffInfoWidth());
-  EXPECT_EQ(4, GetDiffInfoHeight());
-  EXPECT_EQ(16, GetDiffInfoSize());
+  // 96x96 pixels results in 3x3 blocks.
+  // +---+---+---+
+  // | o | o | o |
+  // +---+---+---+  o = blocks mapped to screen pixels
+  // | o | o | o |
+  // +---+---+---+
+  // | o | o | o |
+  // +---+---+---+
+  EXPECT_EQ(3, BlockColumns());
+  EXPECT_EQ(3, BlockRows());
+  // Nothing has changed yet.
+  EXPECT_TRUE(CalcDirtyRegion().is_empty());
 }
 
-TEST_F(DifferTest, MarkDirtyBlocks_All) {
+TEST_F(DifferTest, DirtyBlocks_All) {
   InitDiffer(kScreenWidth, kScreenHeight);
-  ClearDiffInfo();
 
   // Update a pixel in each block.
-  for (int y = 0; y < GetDiffInfoHeight() - 1; y++) {
-    for (int x = 0; x < GetDiffInfoWidth() - 1; x++) {
+  for (int y = 0; y < BlockRows(); y++) {
+    for (int x = 0; x < BlockColumns(); x++) {
       WriteBlockPixel(curr_.get(), x, y, 10, 10, 0xff00ff);
     }
   }
 
-  MarkDirtyBlocks(prev_.get(), curr_.get());
+  DesktopRegion dirty = CalcDirtyRegion();
 
   // Make sure each block is marked as dirty.
-  for (int y = 0; y < GetDiffInfoHeight() - 1; y++) {
-    for (int x = 0; x < GetDiffInfoWidth() - 1; x++) {
-      EXPECT_TRUE(GetDiffInfo(x, y))
+  for (int y = 0; y < BlockRows(); y++) {
+    for (int x = 0; x < BlockColumns(); x++) {
+      EXPECT_TRUE(IsBlockDirty(dirty, x, y))
           << "when x = " << x << ", and y = " << y;
     }
   }
 }
 
-TEST_F(DifferTest, MarkDirtyBlocks_Sampling) {
+TEST_F(DifferTest, DirtyBlocks_Sampling) {
   InitDiffer(kScreenWidth, kScreenHeight);
-  ClearDiffInfo();
 
   // Update some pixels in image.
   WriteBlockPixel(curr_.get(), 1, 0, 10, 10, 0xff00ff);
   WriteBlockPixel(curr_.get(), 2, 1, 10, 10, 0xff00ff);
   WriteBlockPixel(curr_.get(), 0, 2, 10, 10, 0xff00ff);
 
-  MarkDirtyBlocks(prev_.get(), curr_.get());
+  DesktopRegion dirty = CalcDirtyRegion();
 
   // Make sure corresponding blocks are updated.
-  EXPECT_FALSE(GetDiffInfo(0, 0));
-  EXPECT_FALSE(GetDiffInfo(0, 1));
-  EXPECT_TRUE(GetDiffInfo(0, 2));
-  EXPECT_TRUE(GetDiffInfo(1, 0));
-  EXPECT_FALSE(GetDiffInfo(1, 1));
-  EXPECT_FALSE(GetDiffInfo(1, 2));
-  EXPECT_FALSE(GetDiffInfo(2, 0));
-  EXPECT_TRUE(GetDiffInfo(2, 1));
-  EXPECT_FALSE(GetDiffInfo(2, 2));
+  EXPECT_FALSE(IsBlockDirty(dirty, 0, 0));
+  EXPECT_FALSE(IsBlockDirty(dirty, 0, 1));
+  EXPECT_TRUE(IsBlockDirty(dirty, 0, 2));
+  EXPECT_TRUE(IsBlockDirty(dirty, 1, 0));
+  EXPECT_FALSE(IsBlockDirty(dirty, 1, 1));
+  EXPECT_FALSE(IsBlockDirty(dirty, 1, 2));
+  EXPECT_FALSE(IsBlockDirty(dirty, 2, 0));
+  EXPECT_TRUE(IsBlockDirty(dirty, 2, 1));
+  EXPECT_FALSE(IsBlockDirty(dirty, 2, 2));
 }
 
 TEST_F(DifferTest, DiffBlock) {
@@ -296,39 +283,36 @@ TEST_F(DifferTest, DiffBlock) {
 
 TEST_F(DifferTest, Partial_Setup) {
   InitDiffer(kPartialScreenWidth, kPartialScreenHeight);
-  // 70x70 pixels results in 3x3 array: 2x2 full blocks + partials around
-  // the edge. One more is added to each dimension as a boundary.
-  // +---+---+---+---+
-  // | o | o | + | _ |
-  // +---+---+---+---+  o = blocks mapped to screen pixels
-  // | o | o | + | _ |
-  // +---+---+---+---+  + = partial blocks (top/left mapped to screen pixels)
-  // | + | + | + | _ |
-  // +---+---+---+---+  _ = boundary blocks
-  // | _ | _ | _ | _ |
-  // +---+---+---+---+
-  EXPECT_EQ(4, GetDiffInfoWidth());
-  EXPECT_EQ(4, GetDiffInfoHeight());
-  EXPECT_EQ(16, GetDiffInfoSize());
+  // 70x70 pixels results in 3x3 blocks: 2x2 full blocks + partials around
+  // the edge.
+  // +---+---+---+
+  // | o | o | + |
+  // +---+---+---+  o = blocks mapped to screen pixels
+  // | o | o | + |
+  // +---+---+---+  + = partial blocks (top/left mapped to screen pixels)
+  // | + | + | + |
+  // +---+---+---+
+  EXPECT_EQ(3, BlockColumns());
+  EXPECT_EQ(3, BlockRows());
+  EXPECT_TRUE(CalcDirtyRegion().is_empty());
 }
 
 TEST_F(DifferTest, Partial_FirstPixel) {
   InitDiffer(kPartialScreenWidth, kPartialScreenHeight);
-  ClearDiffInfo();
 
   // Update the first pixel in each block.
-  for (int y = 0; y < GetDiffInfoHeight() - 1; y++) {
-    for (int x = 0; x < GetDiffInfoWidth() - 1; x++) {
+  for (int y = 0; y < BlockRows(); y++) {
+    for (int x = 0; x < BlockColumns(); x++) {
       WriteBlockPixel(curr_.get(), x, y, 0, 0, 0xff00ff);
     }
   }
 
-  MarkDirtyBlocks(prev_.get(), curr_.get());
+  DesktopRegion dirty = CalcDirtyRegion();
 
   // Make sure each block is marked as dirty.
-  for (int y = 0; y < GetDiffInfoHeight() - 1; y++) {
-    for (int x = 0; x < GetDiffInfoWidth() - 1; x++) {
-      EXPECT_TRUE(GetDiffInfo(x, y))
+  for (int y = 0; y < BlockRows(); y++) {
+    for (int x = 0; x < BlockColumns(); x++) {
+      EXPECT_TRUE(IsBlockDirty(dirty, x, y))
           << "when x = " << x << ", and y = " << y;
     }
   }
@@ -336,7 +320,6 @@ TEST_F(DifferTest, Partial_FirstPixel) {
 
 TEST_F(DifferTest, Partial_BorderPixel) {
   InitDiffer(kPartialScreenWidth, kPartialScreenHeight);
-  ClearDiffInfo();
 
   // Update the right/bottom border pixels.
   for (int y = 0; y < height_; y++) {
@@ -346,23 +329,24 @@ TEST_F(DifferTest, Partial_BorderPixel) {
     WritePixel(curr_.get(), x, height_ - 1, 0xff00ff);
   }
 
-  MarkDirtyBlocks(prev_.get(), curr_.get());
+  DesktopRegion dirty = CalcDirtyRegion();
 
   // Make sure last (partial) block in each row/column is marked as dirty.
-  int x_last = GetDiffInfoWidth() - 2;
-  for (int y = 0; y < GetDiffInfoHeight() - 1; y++) {
-    EXPECT_TRUE(GetDiffInfo(x_last, y))
+  int x_last = BlockColumns() - 1;
+  for (int y = 0; y < BlockRows(); y++) {
+    EXPECT_TRUE(IsBlockDirty(dirty, x_last, y))
         << "when x = " << x_last << ", and y = " << y;
   }
-  int y_last = GetDiffInfoHeight() - 2;
-  for (int x = 0; x < GetDiffInfoWidth() - 1; x++) {
-    EXPECT_TRUE(GetDiffInfo(x, y_last))
+  int y_last = BlockRows() - 1;
+  for (int x = 0; x < BlockColumns(); x++) {
+    EXPECT_TRUE(IsBlockDirty(dirty, x, y_last))
         << "when x = " << x << ", and y = " << y_last;
   }
   // All other blocks are clean.
-  for (int y = 0; y < GetDiffInfoHeight() - 2; y++) {
-    for (int x = 0; x < GetDiffInfoWidth() - 2; x++) {
-      EXPECT_FALSE(GetDiffInfo(x, y)) << "when x = " << x << ", and y = " << y;
+  for (int y = 0; y < BlockRows() - 1; y++) {
+    for (int x = 0; x < BlockColumns() - 1; x++) {
+      EXPECT_FALSE(IsBlockDirty(dirty, x, y))
+          << "when x = " << x << ", and y = " << y;
     }
   }
 }
@@ -380,10 +364,7 @@ TEST_F(DifferTest, MergeBlocks_Empty) {
   // +---+---+---+---+
   // | _ | _ | _ | _ |
   // +---+---+---+---+
-  ClearDiffInfo();
-
-  DesktopRegion dirty;
-  MergeBlocks(&dirty);
+  DesktopRegion dirty = CalcDirtyRegion();
 
   EXPECT_TRUE(dirty.is_empty());
 }
@@ -392,8 +373,8 @@ TEST_F(DifferTest, MergeBlocks_SingleBlock) {
   InitDiffer(kScreenWidth, kScreenHeight);
   // Mark a single block and make sure that there is a single merged
   // rect with the correct bounds.
-  for (int y = 0; y < GetDiffInfoHeight() - 1; y++) {
-    for (int x = 0; x < GetDiffInfoWidth() - 1; x++) {
+  for (int y = 0; y < BlockRows(); y++) {
+    for (int x = 0; x < BlockColumns(); x++) {
       ASSERT_TRUE(MarkBlocksAndCheckMerge(x, y, 1, 1)) << "x: " << x
                                                        << "y: " << y;
     }
@@ -534,8 +515,8 @@ TEST_F(DifferTest, MergeBlocks_BlockRect) {
 }
 
 // This tests marked regions that require more than 1 single dirty rect.
-// The exact rects returned depend on the current implementation, so these
-// may need to be updated if we modify how we merge blocks.
+// The exact rects returned depend on how DesktopRegion merges rows, so these
+// may need to be updated if that changes.
 TEST_F(DifferTest, MergeBlocks_MultiRect) {
   InitDiffer(kScreenWidth, kScreenHeight);
   DesktopRegion dirty;
@@ -549,13 +530,12 @@ TEST_F(DifferTest, MergeBlocks_MultiRect) {
   // +---+---+---+---+      +---+---+---+
   // | _ | _ | _ | _ |
   // +---+---+---+---+
-  ClearDiffInfo();
+  ClearBuffer(curr_.get());
   MarkBlocks(1, 0, 1, 1);
   MarkBlocks(0, 1, 1, 1);
   MarkBlocks(2, 2, 1, 1);
 
-  dirty.Clear();
-  MergeBlocks(&dirty);
+  dirty = CalcDirtyRegion();
 
   ASSERT_EQ(3, RegionRectCount(dirty));
   ASSERT_TRUE(CheckDirtyRegionContainsRect(dirty, 1, 0, 1, 1));
@@ -571,12 +551,11 @@ TEST_F(DifferTest, MergeBlocks_MultiRect) {
   // +---+---+---+---+      +---+---+---+
   // | _ | _ | _ | _ |
   // +---+---+---+---+
-  ClearDiffInfo();
+  ClearBuffer(curr_.get());
   MarkBlocks(2, 0, 1, 1);
   MarkBlocks(0, 1, 3, 2);
 
-  dirty.Clear();
-  MergeBlocks(&dirty);
+  dirty = CalcDirtyRegion();
 
   ASSERT_EQ(2, RegionRectCount(dirty));
   ASSERT_TRUE(CheckDirtyRegionContainsRect(dirty, 2, 0, 1, 1));
@@ -591,13 +570,12 @@ TEST_F(DifferTest, MergeBlocks_MultiRect) {
   // +---+---+---+---+      +---+---+---+
   // | _ | _ | _ | _ |
   // +---+---+---+---+
-  ClearDiffInfo();
+  ClearBuffer(curr_.get());
   MarkBlocks(0, 1, 1, 1);
   MarkBlocks(2, 1, 1, 1);
   MarkBlocks(0, 2, 3, 1);
 
-  dirty.Clear();
-  MergeBlocks(&dirty);
+  dirty = CalcDirtyRegion();
 
   ASSERT_EQ(3, RegionRectCount(dirty));
   ASSERT_TRUE(CheckDirtyRegionContainsRect(dirty, 0, 1, 1, 1));
@@ -613,14 +591,13 @@ TEST_F(DifferTest, MergeBlocks_MultiRect) {
   // +---+---+---+---+      +---+---+---+
   // | _ | _ | _ | _ |
   // +---+---+---+---+
-  ClearDiffInfo();
+  ClearBuffer(curr_.get());
   MarkBlocks(0, 0, 3, 1);
   MarkBlocks(0, 1, 1, 1);
   MarkBlocks(2, 1, 1, 1);
   MarkBlocks(0, 2, 3, 1);
 
-  dirty.Clear();
-  MergeBlocks(&dirty);
+  dirty = CalcDirtyRegion();
 
   ASSERT_EQ(4, RegionRectCount(dirty));
   ASSERT_TRUE(CheckDirtyRegionContainsRect(dirty, 0, 0, 3, 1));
@@ -637,16 +614,63 @@ TEST_F(DifferTest, MergeBlocks_MultiRect) {
   // +---+---+---+---+      +---+---+---+
   // | _ | _ | _ | _ |
   // +---+---+---+---+
-  ClearDiffInfo();
+  ClearBuffer(curr_.get());
   MarkBlocks(0, 0, 2, 2);
   MarkBlocks(1, 2, 1, 1);
 
-  dirty.Clear();
-  MergeBlocks(&dirty);
+  dirty = CalcDirtyRegion();
 
   ASSERT_EQ(2, RegionRectCount(dirty));
   ASSERT_TRUE(CheckDirtyRegionContainsRect(dirty, 0, 0, 2, 2));
   ASSERT_TRUE(CheckDirtyRegionContainsRect(dirty, 1, 2, 1, 1));
 }
 
+TEST_F(DifferTest, PaddedRows) {
+  InitDiffer(kScreenWidth, kScreenHeight, kBytesPerPixel * kScreenWidth + 64);
+
+  // Changes in the padding are ignored.
+  for (int y = 0; y < height_; y++)
+    curr_[y * stride_ + kBytesPerPixel * width_] = 0xff;
+  EXPECT_TRUE(CalcDirtyRegion().is_empty());
+
+  MarkBlocks(1, 1, 2, 2);
+  DesktopRegion dirty = CalcDirtyRegion();
+  ASSERT_EQ(1, RegionRectCount(dirty));
+  ASSERT_TRUE(CheckDirtyRegionContainsRect(dirty, 1, 1, 2, 2));
+}
+
+// Splitting the frame in stripes compared on several threads gives the same
+// region as comparing it on one thread.
+TEST_F(DifferTest, Threads) {
+  InitDiffer(kLargeScreenWidth, kLargeScreenHeight, kLargeScreenStride);
+  WorkerPool pool(3, "DifferTestThread");
+  Differ threaded_differ(width_, height_, bytes_per_pixel_, stride_, &pool);
+  Differ single_differ(width_, height_, bytes_per_pixel_, stride_, NULL);
+
+  // Change a pattern of blocks which leaves runs of clean and dirty blocks,
+  // including partial ones, in every row.
+  for (int y = 0; y < BlockRows(); y++) {
+    for (int x = 0; x < BlockColumns(); x++) {
+      if ((x + 2 * y) % 5 < 2)
+        MarkBlocks(x, y, 1, 1);
+    }
+  }
+
+  DesktopRegion threaded_dirty;
+  threaded_differ.CalcDirtyRegion(prev_.get(), curr_.get(), &threaded_dirty);
+  DesktopRegion single_dirty;
+  single_differ.CalcDirtyRegion(prev_.get(), curr_.get(), &single_dirty);
+  EXPECT_TRUE(threaded_dirty.Equals(single_dirty));
+  for (int y = 0; y < BlockRows(); y++) {
+    for (int x = 0; x < BlockColumns(); x++) {
+      EXPECT_EQ((x + 2 * y) % 5 < 2, IsBlockDirty(threaded_dirty, x, y))
+          << "when x = " << x << ", and y = " << y;
+    }
+  }
+
+  // The stripes' regions are cleared for the next frame.
+  threaded_differ.CalcDirtyRegion(prev_.get(), prev_.get(), &threaded_dirty);
+  EXPECT_TRUE(threaded_dirty.is_empty());
+}
+
 }  // namespace webrtc
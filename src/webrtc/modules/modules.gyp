@@ -59,6 +59,7 @@
             'audio_coding_module',
             'audio_device'  ,
             'audio_processing',
+            'audio_transcoder',
             'audioproc_test_utils',
             'bitrate_controller',
             'bwe_simulator',
@@ -100,6 +101,7 @@
             'audio_coding/main/acm2/acm_receiver_unittest_oldapi.cc',
             'audio_coding/main/acm2/audio_coding_module_unittest.cc',
             'audio_coding/main/acm2/audio_coding_module_unittest_oldapi.cc',
+            'audio_coding/main/acm2/audio_transcoder_unittest.cc',
             'audio_coding/main/acm2/call_statistics_unittest.cc',
             'audio_coding/main/acm2/codec_owner_unittest.cc',
             'audio_coding/main/acm2/initial_delay_manager_unittest.cc',
@@ -110,7 +112,9 @@
             'audio_coding/codecs/isac/fix/source/lpc_masking_model_unittest.cc',
             'audio_coding/codecs/isac/fix/source/transform_unittest.cc',
             'audio_coding/codecs/isac/main/source/audio_encoder_isac_unittest.cc',
+            'audio_coding/codecs/isac/main/source/filters_unittest.cc',
             'audio_coding/codecs/isac/main/source/isac_unittest.cc',
+            'audio_coding/codecs/isac/main/source/transform_unittest.cc',
             'audio_coding/codecs/opus/audio_encoder_opus_unittest.cc',
             'audio_coding/codecs/opus/opus_unittest.cc',
             'audio_coding/codecs/red/audio_encoder_copy_red_unittest.cc',
@@ -129,6 +133,7 @@
             'audio_coding/neteq/dtmf_tone_generator_unittest.cc',
             'audio_coding/neteq/expand_unittest.cc',
             'audio_coding/neteq/merge_unittest.cc',
+            'audio_coding/neteq/neteq_batch_unittest.cc',
             'audio_coding/neteq/neteq_external_decoder_unittest.cc',
             'audio_coding/neteq/neteq_impl_unittest.cc',
             'audio_coding/neteq/neteq_network_stats_unittest.cc',
@@ -156,6 +161,9 @@
             'audio_coding/neteq/mock/mock_payload_splitter.h',
             'audio_coding/neteq/tools/input_audio_file_unittest.cc',
             'audio_coding/neteq/tools/packet_unittest.cc',
+            'audio_device/audio_device_buffer_unittest.cc',
+            'audio_device/dummy/wav_file_audio_device_unittest.cc',
+            'audio_device/single_rw_fifo_unittest.cc',
             'audio_processing/aec/echo_cancellation_unittest.cc',
             'audio_processing/aec/system_delay_unittest.cc',
             # TODO(ajm): Fix to match new interface.
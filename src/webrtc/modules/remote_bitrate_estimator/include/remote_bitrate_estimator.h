@@ -85,6 +85,37 @@ struct PacketInfo {
   size_t payload_size;
 };
 
+// Compact description of an incoming packet, holding only what the estimators
+// need from the RTP header. Used to feed estimators in batches.
+struct PacketArrival {
+  PacketArrival()
+      : arrival_time_ms(0),
+        payload_size(0),
+        ssrc(0),
+        rtp_timestamp(0),
+        absolute_send_time(0),
+        has_absolute_send_time(false) {}
+  PacketArrival(int64_t arrival_time_ms,
+                size_t payload_size,
+                const RTPHeader& header)
+      : arrival_time_ms(arrival_time_ms),
+        payload_size(payload_size),
+        ssrc(header.ssrc),
+        rtp_timestamp(header.timestamp +
+                      header.extension.transmissionTimeOffset),
+        absolute_send_time(header.extension.absoluteSendTime),
+        has_absolute_send_time(header.extension.hasAbsoluteSendTime) {}
+
+  int64_t arrival_time_ms;
+  size_t payload_size;
+  uint32_t ssrc;
+  // RTP timestamp adjusted with the transmission time offset, if any.
+  uint32_t rtp_timestamp;
+  // 24 bit absolute send time, valid if |has_absolute_send_time| is set.
+  uint32_t absolute_send_time;
+  bool has_absolute_send_time;
+};
+
 class RemoteBitrateEstimator : public CallStatsObserver, public Module {
  public:
   virtual ~RemoteBitrateEstimator() {}
@@ -103,6 +134,22 @@ class RemoteBitrateEstimator : public CallStatsObserver, public Module {
                               size_t payload_size,
                               const RTPHeader& header) = 0;
 
+  // Called with |num_packets| incoming packets, in arrival order. Equivalent to
+  // calling IncomingPacket() for each of them, but lets the implementation
+  // process the whole batch in one go.
+  virtual void IncomingPackets(const PacketArrival* packets,
+                               size_t num_packets) {
+    for (size_t i = 0; i < num_packets; ++i) {
+      RTPHeader header;
+      header.ssrc = packets[i].ssrc;
+      header.timestamp = packets[i].rtp_timestamp;
+      header.extension.absoluteSendTime = packets[i].absolute_send_time;
+      header.extension.hasAbsoluteSendTime = packets[i].has_absolute_send_time;
+      IncomingPacket(packets[i].arrival_time_ms, packets[i].payload_size,
+                     header);
+    }
+  }
+
   // Removes all data for |ssrc|.
   virtual void RemoveStream(unsigned int ssrc) = 0;
 
@@ -21,7 +21,6 @@
 
 namespace webrtc {
 
-enum { kMinFramePeriodHistoryLength = 60 };
 enum { kDeltaCounterMax = 1000 };
 
 OveruseEstimator::OveruseEstimator(const OverUseDetectorOptions& options)
@@ -34,14 +33,15 @@ OveruseEstimator::OveruseEstimator(const OverUseDetectorOptions& options)
       process_noise_(),
       avg_noise_(options_.initial_avg_noise),
       var_noise_(options_.initial_var_noise),
-      ts_delta_hist_() {
+      ts_delta_hist_(),
+      ts_delta_hist_size_(0),
+      ts_delta_hist_pos_(0) {
   memcpy(E_, options_.initial_e, sizeof(E_));
   memcpy(process_noise_, options_.initial_process_noise,
          sizeof(process_noise_));
 }
 
 OveruseEstimator::~OveruseEstimator() {
-  ts_delta_hist_.clear();
 }
 
 void OveruseEstimator::Update(int64_t t_delta,
@@ -115,14 +115,19 @@ void OveruseEstimator::Update(int64_t t_delta,
 
 double OveruseEstimator::UpdateMinFramePeriod(double ts_delta) {
   double min_frame_period = ts_delta;
-  if (ts_delta_hist_.size() >= kMinFramePeriodHistoryLength) {
-    ts_delta_hist_.pop_front();
+  // The oldest entry is about to be overwritten and doesn't take part in the
+  // minimum once the history is full.
+  if (ts_delta_hist_size_ >= kMinFramePeriodHistoryLength) {
+    --ts_delta_hist_size_;
   }
-  std::list<double>::iterator it = ts_delta_hist_.begin();
-  for (; it != ts_delta_hist_.end(); it++) {
-    min_frame_period = std::min(*it, min_frame_period);
+  for (size_t i = 1; i <= ts_delta_hist_size_; ++i) {
+    size_t index = (ts_delta_hist_pos_ + kMinFramePeriodHistoryLength - i) %
+                   kMinFramePeriodHistoryLength;
+    min_frame_period = std::min(ts_delta_hist_[index], min_frame_period);
   }
-  ts_delta_hist_.push_back(ts_delta);
+  ts_delta_hist_[ts_delta_hist_pos_] = ts_delta;
+  ts_delta_hist_pos_ = (ts_delta_hist_pos_ + 1) % kMinFramePeriodHistoryLength;
+  ++ts_delta_hist_size_;
   return min_frame_period;
 }
 
@@ -10,7 +10,7 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_OVERUSE_ESTIMATOR_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_OVERUSE_ESTIMATOR_H_
 
-#include <list>
+#include <stddef.h>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/common_types.h"
@@ -20,6 +20,8 @@ namespace webrtc {
 
 class OveruseEstimator {
  public:
+  enum { kMinFramePeriodHistoryLength = 60 };
+
   explicit OveruseEstimator(const OverUseDetectorOptions& options);
   ~OveruseEstimator();
 
@@ -61,7 +63,11 @@ class OveruseEstimator {
   double process_noise_[2];
   double avg_noise_;
   double var_noise_;
-  std::list<double> ts_delta_hist_;
+  // Circular buffer of the most recent timestamp deltas, used to find the
+  // minimum frame period without allocating on every update.
+  double ts_delta_hist_[kMinFramePeriodHistoryLength];
+  size_t ts_delta_hist_size_;
+  size_t ts_delta_hist_pos_;
 
   DISALLOW_COPY_AND_ASSIGN(OveruseEstimator);
 };
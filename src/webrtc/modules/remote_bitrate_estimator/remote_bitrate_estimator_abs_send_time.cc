@@ -9,6 +9,7 @@
  */
 
 #include <math.h>
+#include <list>
 #include <map>
 
 #include "webrtc/base/constructormagic.h"
@@ -117,6 +118,8 @@ class RemoteBitrateEstimatorAbsSendTimeImpl : public RemoteBitrateEstimator {
   void IncomingPacket(int64_t arrival_time_ms,
                       size_t payload_size,
                       const RTPHeader& header) override;
+  void IncomingPackets(const PacketArrival* packets,
+                       size_t num_packets) override;
   // This class relies on Process() being called periodically (at least once
   // every other second) for streams to be timed out properly. Therefore it
   // shouldn't be detached from the ProcessThread except if it's about to be
@@ -157,6 +160,12 @@ class RemoteBitrateEstimatorAbsSendTimeImpl : public RemoteBitrateEstimator {
                           size_t payload_size,
                           uint32_t ssrc);
 
+  void IncomingPacketInfoLocked(int64_t arrival_time_ms,
+                                uint32_t send_time_24bits,
+                                size_t payload_size,
+                                int64_t now_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
   bool IsProbe(int64_t send_time_ms, int payload_size) const
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
 
@@ -331,14 +340,19 @@ bool RemoteBitrateEstimatorAbsSendTimeImpl::IsBitrateImproving(
 
 void RemoteBitrateEstimatorAbsSendTimeImpl::IncomingPacketFeedbackVector(
     const std::vector<PacketInfo>& packet_feedback_vector) {
+  if (packet_feedback_vector.empty())
+    return;
+  CriticalSectionScoped cs(crit_sect_.get());
+  const int64_t now_ms = clock_->TimeInMilliseconds();
+  ssrcs_[0] = now_ms;
   for (const auto& packet_info : packet_feedback_vector) {
     // TODO(holmer): We should get rid of this conversion if possible as we may
     // lose precision.
     uint32_t send_time_32bits = (packet_info.send_time_ms) / kTimestampToMs;
     uint32_t send_time_24bits =
         send_time_32bits >> kAbsSendTimeInterArrivalUpshift;
-    IncomingPacketInfo(packet_info.arrival_time_ms, send_time_24bits,
-                       packet_info.payload_size, 0);
+    IncomingPacketInfoLocked(packet_info.arrival_time_ms, send_time_24bits,
+                             packet_info.payload_size, now_ms);
   }
 }
 
@@ -354,27 +368,61 @@ void RemoteBitrateEstimatorAbsSendTimeImpl::IncomingPacket(
                      payload_size, header.ssrc);
 }
 
+void RemoteBitrateEstimatorAbsSendTimeImpl::IncomingPackets(
+    const PacketArrival* packets,
+    size_t num_packets) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  // The whole batch is handled at the same wall clock time, so the clock is
+  // only read once.
+  const int64_t now_ms = clock_->TimeInMilliseconds();
+  Ssrcs::iterator last_ssrc = ssrcs_.end();
+  for (size_t i = 0; i < num_packets; ++i) {
+    const PacketArrival& packet = packets[i];
+    if (!packet.has_absolute_send_time) {
+      LOG(LS_WARNING) << "RemoteBitrateEstimatorAbsSendTimeImpl: Incoming "
+                         "packet is missing absolute send time extension!";
+    }
+    // Consecutive packets usually belong to the same stream; avoid the map
+    // lookup for those. The cached entry stays valid since UpdateEstimate()
+    // only drops streams which have timed out.
+    if (last_ssrc == ssrcs_.end() || last_ssrc->first != packet.ssrc)
+      last_ssrc = ssrcs_.insert(std::make_pair(packet.ssrc, now_ms)).first;
+    last_ssrc->second = now_ms;
+    IncomingPacketInfoLocked(packet.arrival_time_ms, packet.absolute_send_time,
+                             packet.payload_size, now_ms);
+  }
+}
+
 void RemoteBitrateEstimatorAbsSendTimeImpl::IncomingPacketInfo(
     int64_t arrival_time_ms,
     uint32_t send_time_24bits,
     size_t payload_size,
     uint32_t ssrc) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  // TODO(holmer): SSRCs are only needed for REMB, should be broken out from
+  // here.
+  ssrcs_[ssrc] = now_ms;
+  IncomingPacketInfoLocked(arrival_time_ms, send_time_24bits, payload_size,
+                           now_ms);
+}
+
+void RemoteBitrateEstimatorAbsSendTimeImpl::IncomingPacketInfoLocked(
+    int64_t arrival_time_ms,
+    uint32_t send_time_24bits,
+    size_t payload_size,
+    int64_t now_ms) {
   assert(send_time_24bits < (1ul << 24));
   // Shift up send time to use the full 32 bits that inter_arrival works with,
   // so wrapping works properly.
   uint32_t timestamp = send_time_24bits << kAbsSendTimeInterArrivalUpshift;
   int64_t send_time_ms = static_cast<int64_t>(timestamp) * kTimestampToMs;
 
-  CriticalSectionScoped cs(crit_sect_.get());
-  int64_t now_ms = clock_->TimeInMilliseconds();
-  // TODO(holmer): SSRCs are only needed for REMB, should be broken out from
-  // here.
-  ssrcs_[ssrc] = now_ms;
   incoming_bitrate_.Update(payload_size, now_ms);
   const BandwidthUsage prior_state = detector_.State();
 
   if (first_packet_time_ms_ == -1)
-    first_packet_time_ms_ = clock_->TimeInMilliseconds();
+    first_packet_time_ms_ = now_ms;
 
   uint32_t ts_delta = 0;
   int64_t t_delta = 0;
@@ -71,6 +71,15 @@ TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, CapacityDropThirtyStreamsWrap) {
   CapacityDropTestHelper(30, true, 666);
 }
 
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, BatchedIncomingPacketsOneStream) {
+  BatchedIncomingPacketsTestHelper(1);
+}
+
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest,
+       BatchedIncomingPacketsThreeStreams) {
+  BatchedIncomingPacketsTestHelper(3);
+}
+
 TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, TestTimestampGrouping) {
   TestTimestampGroupingTestHelper();
 }
@@ -0,0 +1,210 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the cost of feeding the receive-side estimators one packet at a
+// time compared to feeding them batches of packets, as a receiver draining its
+// sockets would. Runs over synthetic arrival traces with an increasing number
+// of streams, and optionally over the arrival times of an rtpdump file.
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
+#include "webrtc/modules/rtp_rtcp/interface/rtp_header_parser.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/rtp_file_reader.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+DEFINE_string(bwe_rtpdump, "",
+              "rtpdump file whose arrival times to run the estimators over. "
+              "The test is skipped if not set.");
+DEFINE_int32(bwe_abs_send_time_id, 3,
+             "Header extension id of the absolute send time in --bwe_rtpdump.");
+
+namespace webrtc {
+namespace {
+
+const int kFramerate = 30;
+const int kPacketsPerFrame = 3;
+const size_t kPayloadSize = 1200;
+const int kTraceDurationMs = 5000;
+const int kPropagationDelayMs = 20;
+const int64_t kProcessIntervalMs = 500;
+const size_t kBatchSize = 64;
+const uint32_t kMinBitrateBps = 30000;
+
+class NullBitrateObserver : public RemoteBitrateObserver {
+ public:
+  virtual ~NullBitrateObserver() {}
+  void OnReceiveBitrateChanged(const std::vector<unsigned int>& ssrcs,
+                               unsigned int bitrate) override {}
+};
+
+uint32_t AbsSendTime(int64_t time_ms) {
+  return static_cast<uint32_t>(((time_ms << 18) + 500) / 1000) & 0x00ffffff;
+}
+
+bool CompareArrivalTime(const PacketArrival& a, const PacketArrival& b) {
+  return a.arrival_time_ms < b.arrival_time_ms;
+}
+
+// Creates |num_streams| video streams with staggered frame times and a small,
+// deterministic queuing delay variation, sorted by arrival time.
+std::vector<PacketArrival> CreateSyntheticTrace(int num_streams) {
+  const int kFrameIntervalMs = 1000 / kFramerate;
+  std::vector<PacketArrival> trace;
+  trace.reserve(num_streams * kPacketsPerFrame * kFramerate *
+                kTraceDurationMs / 1000);
+  for (int64_t frame_time_ms = 0; frame_time_ms < kTraceDurationMs;
+       frame_time_ms += kFrameIntervalMs) {
+    for (int stream = 0; stream < num_streams; ++stream) {
+      const int64_t send_time_ms = frame_time_ms + stream % kFrameIntervalMs;
+      const uint32_t rtp_timestamp =
+          static_cast<uint32_t>(90 * send_time_ms + 1000 * stream);
+      for (int i = 0; i < kPacketsPerFrame; ++i) {
+        PacketArrival packet;
+        packet.arrival_time_ms = send_time_ms + kPropagationDelayMs + i +
+                                 (stream + frame_time_ms) % 3;
+        packet.payload_size = kPayloadSize;
+        packet.ssrc = 1 + stream;
+        packet.rtp_timestamp = rtp_timestamp;
+        packet.absolute_send_time = AbsSendTime(send_time_ms);
+        packet.has_absolute_send_time = true;
+        trace.push_back(packet);
+      }
+    }
+  }
+  std::stable_sort(trace.begin(), trace.end(), CompareArrivalTime);
+  return trace;
+}
+
+bool ReadRtpDumpTrace(const std::string& filename,
+                      std::vector<PacketArrival>* trace) {
+  rtc::scoped_ptr<test::RtpFileReader> reader(
+      test::RtpFileReader::Create(test::RtpFileReader::kRtpDump, filename));
+  if (!reader)
+    return false;
+  rtc::scoped_ptr<RtpHeaderParser> parser(RtpHeaderParser::Create());
+  parser->RegisterRtpHeaderExtension(kRtpExtensionAbsoluteSendTime,
+                                     FLAGS_bwe_abs_send_time_id);
+  test::RtpPacketRef packet;
+  while (reader->NextPacket(&packet)) {
+    RTPHeader header;
+    if (RtpHeaderParser::IsRtcp(packet.data, packet.length) ||
+        !parser->Parse(packet.data, packet.length, &header)) {
+      continue;
+    }
+    trace->push_back(PacketArrival(
+        packet.time_ms, packet.original_length - header.headerLength, header));
+  }
+  return !trace->empty();
+}
+
+RemoteBitrateEstimator* CreateEstimator(bool abs_send_time,
+                                        RemoteBitrateObserver* observer,
+                                        Clock* clock) {
+  if (abs_send_time) {
+    return AbsoluteSendTimeRemoteBitrateEstimatorFactory().Create(
+        observer, clock, kAimdControl, kMinBitrateBps);
+  }
+  return RemoteBitrateEstimatorFactory().Create(observer, clock, kAimdControl,
+                                                kMinBitrateBps);
+}
+
+// Runs |trace| through a new estimator, either packet by packet or in batches
+// of up to |batch_size| packets, and returns the time it took in microseconds.
+int64_t RunTrace(const std::vector<PacketArrival>& trace,
+                 bool abs_send_time,
+                 size_t batch_size) {
+  NullBitrateObserver observer;
+  SimulatedClock clock(trace.front().arrival_time_ms);
+  rtc::scoped_ptr<RemoteBitrateEstimator> estimator(
+      CreateEstimator(abs_send_time, &observer, &clock));
+  int64_t next_process_ms = clock.TimeInMilliseconds() + kProcessIntervalMs;
+  const TickTime start = TickTime::Now();
+  for (size_t i = 0; i < trace.size(); i += batch_size) {
+    const size_t num_packets = std::min(batch_size, trace.size() - i);
+    const PacketArrival* packets = &trace[i];
+    clock.AdvanceTimeMilliseconds(
+        packets[num_packets - 1].arrival_time_ms - clock.TimeInMilliseconds());
+    if (batch_size == 1) {
+      RTPHeader header;
+      header.ssrc = packets->ssrc;
+      header.timestamp = packets->rtp_timestamp;
+      header.extension.hasAbsoluteSendTime = packets->has_absolute_send_time;
+      header.extension.absoluteSendTime = packets->absolute_send_time;
+      estimator->IncomingPacket(packets->arrival_time_ms,
+                                packets->payload_size, header);
+    } else {
+      estimator->IncomingPackets(packets, num_packets);
+    }
+    if (clock.TimeInMilliseconds() >= next_process_ms) {
+      estimator->Process();
+      next_process_ms += kProcessIntervalMs;
+    }
+  }
+  return (TickTime::Now() - start).Microseconds();
+}
+
+void RunAndReport(const std::vector<PacketArrival>& trace,
+                  bool abs_send_time,
+                  const std::string& trace_name) {
+  ASSERT_FALSE(trace.empty());
+  const std::string modifier =
+      abs_send_time ? "_abs_send_time" : "_single_stream";
+  // Warm up caches and the allocator before measuring.
+  RunTrace(trace, abs_send_time, kBatchSize);
+  const int64_t per_packet_us = RunTrace(trace, abs_send_time, 1);
+  const int64_t batched_us = RunTrace(trace, abs_send_time, kBatchSize);
+  webrtc::test::PrintResult("bwe_estimator_batch", modifier,
+                            trace_name + "_per_packet",
+                            1000.0 * per_packet_us / trace.size(),
+                            "ns/packet", false);
+  webrtc::test::PrintResult("bwe_estimator_batch", modifier,
+                            trace_name + "_batched",
+                            1000.0 * batched_us / trace.size(), "ns/packet",
+                            false);
+}
+
+void RunSyntheticTraces(bool abs_send_time) {
+  const int kNumStreams[] = {1, 10, 100, 1000};
+  for (int num_streams : kNumStreams) {
+    std::stringstream ss;
+    ss << num_streams << "_streams";
+    RunAndReport(CreateSyntheticTrace(num_streams), abs_send_time, ss.str());
+  }
+}
+
+}  // namespace
+
+TEST(RemoteBitrateEstimatorBatchPerfTest, AbsSendTimeSyntheticTraces) {
+  RunSyntheticTraces(true);
+}
+
+TEST(RemoteBitrateEstimatorBatchPerfTest, SingleStreamSyntheticTraces) {
+  RunSyntheticTraces(false);
+}
+
+TEST(RemoteBitrateEstimatorBatchPerfTest, RtpDumpTrace) {
+  if (FLAGS_bwe_rtpdump.empty()) {
+    printf("Skipping, no --bwe_rtpdump given.\n");
+    return;
+  }
+  std::vector<PacketArrival> trace;
+  ASSERT_TRUE(ReadRtpDumpTrace(FLAGS_bwe_rtpdump, &trace));
+  RunAndReport(trace, trace.front().has_absolute_send_time, "rtpdump");
+}
+
+}  // namespace webrtc
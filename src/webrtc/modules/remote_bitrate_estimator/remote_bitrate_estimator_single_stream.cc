@@ -39,6 +39,8 @@ class RemoteBitrateEstimatorImpl : public RemoteBitrateEstimator {
   void IncomingPacket(int64_t arrival_time_ms,
                       size_t payload_size,
                       const RTPHeader& header) override;
+  void IncomingPackets(const PacketArrival* packets,
+                       size_t num_packets) override;
   int32_t Process() override;
   int64_t TimeUntilNextProcess() override;
   void OnRttUpdate(int64_t rtt) override;
@@ -65,6 +67,17 @@ class RemoteBitrateEstimatorImpl : public RemoteBitrateEstimator {
 
   typedef std::map<unsigned int, Detector*> SsrcOveruseEstimatorMap;
 
+  // Returns the detector for |ssrc|, creating it if this is a new stream.
+  Detector* GetOrCreateDetector(uint32_t ssrc, int64_t now_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
+  void IncomingPacketLocked(Detector* estimator,
+                            int64_t arrival_time_ms,
+                            size_t payload_size,
+                            uint32_t rtp_timestamp,
+                            int64_t now_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
   // Triggers a new estimate calculation.
   void UpdateEstimate(int64_t time_now)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
@@ -116,6 +129,33 @@ void RemoteBitrateEstimatorImpl::IncomingPacket(
       header.extension.transmissionTimeOffset;
   int64_t now_ms = clock_->TimeInMilliseconds();
   CriticalSectionScoped cs(crit_sect_.get());
+  IncomingPacketLocked(GetOrCreateDetector(ssrc, now_ms), arrival_time_ms,
+                       payload_size, rtp_timestamp, now_ms);
+}
+
+void RemoteBitrateEstimatorImpl::IncomingPackets(const PacketArrival* packets,
+                                                 size_t num_packets) {
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  CriticalSectionScoped cs(crit_sect_.get());
+  uint32_t last_ssrc = 0;
+  Detector* estimator = NULL;
+  for (size_t i = 0; i < num_packets; ++i) {
+    const PacketArrival& packet = packets[i];
+    // Consecutive packets usually belong to the same stream; avoid the map
+    // lookup for those. Detectors are only deleted by UpdateEstimate() once
+    // they have timed out, which can't happen to the one just used.
+    if (!estimator || packet.ssrc != last_ssrc) {
+      estimator = GetOrCreateDetector(packet.ssrc, now_ms);
+      last_ssrc = packet.ssrc;
+    }
+    IncomingPacketLocked(estimator, packet.arrival_time_ms,
+                         packet.payload_size, packet.rtp_timestamp, now_ms);
+  }
+}
+
+RemoteBitrateEstimatorImpl::Detector*
+RemoteBitrateEstimatorImpl::GetOrCreateDetector(uint32_t ssrc,
+                                                int64_t now_ms) {
   SsrcOveruseEstimatorMap::iterator it = overuse_detectors_.find(ssrc);
   if (it == overuse_detectors_.end()) {
     // This is a new SSRC. Adding to map.
@@ -131,7 +171,14 @@ void RemoteBitrateEstimatorImpl::IncomingPacket(
             remote_rate_->GetControlType() == kAimdControl)));
     it = insert_result.first;
   }
-  Detector* estimator = it->second;
+  return it->second;
+}
+
+void RemoteBitrateEstimatorImpl::IncomingPacketLocked(Detector* estimator,
+                                                      int64_t arrival_time_ms,
+                                                      size_t payload_size,
+                                                      uint32_t rtp_timestamp,
+                                                      int64_t now_ms) {
   estimator->last_packet_time_ms = now_ms;
   incoming_bitrate_.Update(payload_size, now_ms);
   const BandwidthUsage prior_state = estimator->detector.State();
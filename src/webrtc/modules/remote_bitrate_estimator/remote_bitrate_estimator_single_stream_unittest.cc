@@ -70,6 +70,14 @@ TEST_F(RemoteBitrateEstimatorSingleTest, CapacityDropThirtyStreamsWrap) {
   CapacityDropTestHelper(30, true, 733);
 }
 
+TEST_F(RemoteBitrateEstimatorSingleTest, BatchedIncomingPacketsOneStream) {
+  BatchedIncomingPacketsTestHelper(1);
+}
+
+TEST_F(RemoteBitrateEstimatorSingleTest, BatchedIncomingPacketsThreeStreams) {
+  BatchedIncomingPacketsTestHelper(3);
+}
+
 TEST_F(RemoteBitrateEstimatorSingleTest, TestTimestampGrouping) {
   TestTimestampGroupingTestHelper();
 }
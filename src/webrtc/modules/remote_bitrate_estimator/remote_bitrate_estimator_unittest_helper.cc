@@ -663,4 +663,79 @@ void RemoteBitrateEstimatorTest::TestWrappingHelper(
   bitrate_estimator_->LatestEstimate(&ssrcs, &bitrate_after);
   EXPECT_LT(bitrate_after, bitrate_before);
 }
+
+void RemoteBitrateEstimatorTest::BatchedIncomingPacketsTestHelper(
+    int number_of_streams) {
+  const int kFramerate = 30;
+  const int kNumFrames = 30 * 20;
+  // Above the capacity of the simulated channel, to trigger over-use.
+  const unsigned int kBitrateBps = 1500e3;
+  for (int i = 0; i < number_of_streams; ++i) {
+    stream_generator_->AddStream(new testing::RtpStream(
+        kFramerate,                       // Frames per second.
+        kBitrateBps / number_of_streams,  // Bitrate.
+        kDefaultSsrc + i,                 // SSRC.
+        90000,                            // RTP frequency.
+        0xFFFFF000 - i * 3000,            // Timestamp offset.
+        0));                              // RTCP receive time.
+  }
+  stream_generator_->SetBitrateBps(kBitrateBps);
+
+  // Keep the estimator created by SetUp() as the per-packet reference and let
+  // SetUp() create a second one of the same type to feed in batches.
+  rtc::scoped_ptr<RemoteBitrateEstimator> reference(
+      bitrate_estimator_.release());
+  SetUp();
+  RemoteBitrateEstimator* batched = bitrate_estimator_.get();
+
+  std::vector<PacketArrival> batch;
+  for (int i = 0; i < kNumFrames; ++i) {
+    testing::RtpStream::PacketList packets;
+    int64_t next_time_us = stream_generator_->GenerateFrame(
+        &packets, clock_.TimeInMicroseconds());
+    ASSERT_FALSE(packets.empty());
+    // Both estimators see the packets of a frame at the arrival time of the
+    // last one, as they would when draining a socket.
+    clock_.AdvanceTimeMicroseconds(packets.back()->arrival_time -
+                                   clock_.TimeInMicroseconds());
+    batch.clear();
+    while (!packets.empty()) {
+      testing::RtpStream::RtpPacket* packet = packets.front();
+      RTPHeader header;
+      header.ssrc = packet->ssrc;
+      header.timestamp = packet->rtp_timestamp;
+      header.extension.hasAbsoluteSendTime = true;
+      header.extension.absoluteSendTime =
+          AbsSendTime(packet->send_time, 1000000);
+      const int64_t arrival_time_ms =
+          (packet->arrival_time + 500) / 1000 + kArrivalTimeClockOffsetMs;
+      reference->IncomingPacket(arrival_time_ms, packet->size, header);
+      batch.push_back(PacketArrival(arrival_time_ms, packet->size, header));
+      delete packet;
+      packets.pop_front();
+    }
+    batched->IncomingPackets(&batch[0], batch.size());
+    reference->Process();
+    batched->Process();
+
+    std::vector<unsigned int> reference_ssrcs;
+    unsigned int reference_bitrate = 0;
+    bool reference_valid =
+        reference->LatestEstimate(&reference_ssrcs, &reference_bitrate);
+    std::vector<unsigned int> batched_ssrcs;
+    unsigned int batched_bitrate = 0;
+    bool batched_valid =
+        batched->LatestEstimate(&batched_ssrcs, &batched_bitrate);
+    ASSERT_EQ(reference_valid, batched_valid);
+    ASSERT_EQ(reference_bitrate, batched_bitrate) << "Frame " << i;
+    ASSERT_EQ(reference_ssrcs.size(), batched_ssrcs.size());
+    clock_.AdvanceTimeMicroseconds(next_time_us - clock_.TimeInMicroseconds());
+  }
+  // Make sure the test actually exercised the over-use detection.
+  std::vector<unsigned int> ssrcs;
+  unsigned int bitrate = 0;
+  EXPECT_TRUE(batched->LatestEstimate(&ssrcs, &bitrate));
+  EXPECT_LT(bitrate, kBitrateBps);
+  EXPECT_EQ(static_cast<size_t>(number_of_streams), ssrcs.size());
+}
 }  // namespace webrtc
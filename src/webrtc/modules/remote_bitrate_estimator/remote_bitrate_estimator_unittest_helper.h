@@ -196,6 +196,10 @@ class RemoteBitrateEstimatorTest : public ::testing::Test {
 
   void TestWrappingHelper(int silence_time_s);
 
+  // Feeds the same frames to a second estimator through IncomingPackets() and
+  // verifies that it produces the same estimates as the per-packet API.
+  void BatchedIncomingPacketsTestHelper(int number_of_streams);
+
   void InitialBehaviorTestHelper(unsigned int expected_converge_bitrate);
   void RateIncreaseReorderingTestHelper(unsigned int expected_bitrate);
   void RateIncreaseRtpTimestampsTestHelper(int expected_iterations);
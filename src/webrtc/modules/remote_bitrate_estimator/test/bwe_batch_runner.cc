@@ -0,0 +1,390 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_batch_runner.h"
+
+#include <sstream>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/format_macros.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_test.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/packet_receiver.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/packet_sender.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/system_wrappers/interface/worker_pool.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+
+namespace {
+
+const int64_t kFlowStartSpreadMs = 10000;
+const int64_t kTcpStartOffsetMs = 5000;
+
+const char* EstimatorName(BandwidthEstimatorType bwe_type) {
+  switch (bwe_type) {
+    case kNullEstimator:
+      return "Null";
+    case kNadaEstimator:
+      return "Nada";
+    case kRembEstimator:
+      return "Remb";
+    case kFullSendSideEstimator:
+      return "SendSide";
+    case kTcpEstimator:
+      return "Tcp";
+  }
+  return "Unknown";
+}
+
+// Counts the media packets passing through it.
+class PacketCounterFilter : public PacketProcessor {
+ public:
+  PacketCounterFilter(PacketProcessorListener* listener,
+                      const FlowIds& flow_ids)
+      : PacketProcessor(listener, flow_ids, kRegular), num_packets_(0) {}
+  virtual ~PacketCounterFilter() {}
+
+  void RunFor(int64_t /*time_ms*/, Packets* in_out) override {
+    for (const Packet* packet : *in_out) {
+      if (packet->GetPacketType() == Packet::kMedia)
+        ++num_packets_;
+    }
+  }
+
+  int64_t num_packets() const { return num_packets_; }
+
+ private:
+  int64_t num_packets_;
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(PacketCounterFilter);
+};
+
+double FairnessIndex(std::map<int, Stats<double>>* flow_throughput_kbps) {
+  if (flow_throughput_kbps->empty())
+    return 1.0;
+  double squared_bitrate_sum = 0.0;
+  double fairness_index = 0.0;
+  for (auto& kv : *flow_throughput_kbps) {
+    squared_bitrate_sum += kv.second.GetMean() * kv.second.GetMean();
+    fairness_index += kv.second.GetMean();
+  }
+  if (squared_bitrate_sum == 0.0)
+    return 0.0;
+  fairness_index *= fairness_index;
+  return fairness_index /
+         (flow_throughput_kbps->size() * squared_bitrate_sum);
+}
+
+// Same stepping as BweTest::RunFor(), without depending on gtest state.
+void RunLinks(Link* uplink,
+              Link* downlink,
+              int64_t run_time_ms,
+              Packets* packets) {
+  int64_t simulation_interval_ms = -1;
+  if (!uplink->senders().empty()) {
+    simulation_interval_ms = uplink->senders()[0]->GetFeedbackIntervalMs();
+  } else if (!downlink->senders().empty()) {
+    simulation_interval_ms = downlink->senders()[0]->GetFeedbackIntervalMs();
+  }
+  DCHECK_GT(simulation_interval_ms, 0);
+  for (int64_t now_ms = simulation_interval_ms;
+       now_ms <= run_time_ms - simulation_interval_ms;
+       now_ms += simulation_interval_ms) {
+    uplink->Run(simulation_interval_ms, now_ms, packets);
+    downlink->Run(simulation_interval_ms, now_ms, packets);
+  }
+}
+
+class ScenarioTask : public WorkerPool::Task {
+ public:
+  ScenarioTask(const BweScenario* scenario, BweScenarioResult* result)
+      : scenario_(scenario), result_(result) {}
+  virtual ~ScenarioTask() {}
+
+  void Run() override { *result_ = RunBweScenario(*scenario_); }
+
+ private:
+  const BweScenario* const scenario_;
+  BweScenarioResult* const result_;
+};
+
+void WriteJsonStats(FILE* file, const char* name, Stats<double> stats) {
+  fprintf(file, "\"%s\": {\"mean\": %f, \"stddev\": %f, \"min\": %f, "
+          "\"max\": %f}", name, stats.GetMean(), stats.GetStdDev(),
+          stats.GetMin(), stats.GetMax());
+}
+
+void WriteJsonFlowStats(FILE* file,
+                        const char* name,
+                        const std::map<int, Stats<double>>& flow_stats) {
+  fprintf(file, "\"%s\": {", name);
+  bool first = true;
+  for (const auto& kv : flow_stats) {
+    Stats<double> stats = kv.second;
+    fprintf(file, "%s\"%d\": {\"mean\": %f, \"stddev\": %f}",
+            first ? "" : ", ", kv.first, stats.GetMean(), stats.GetStdDev());
+    first = false;
+  }
+  fprintf(file, "}");
+}
+
+}  // namespace
+
+BweScenario::BweScenario()
+    : name("Scenario"),
+      bwe_type(kFullSendSideEstimator),
+      num_media_flows(1),
+      num_tcp_flows(0),
+      run_time_ms(60 * 1000),
+      capacity_kbps(1000),
+      max_delay_ms(500),
+      one_way_delay_ms(25),
+      loss_percent(0.0f),
+      jitter_ms(0),
+      seed(0) {
+}
+
+BweScenarioResult::BweScenarioResult()
+    : utilization_percent(0.0),
+      fairness_percent(0.0),
+      loss_percent(0.0),
+      elapsed_ms(0) {
+}
+
+BweScenarioResult RunBweScenario(const BweScenario& scenario) {
+  DCHECK_GT(scenario.num_media_flows + scenario.num_tcp_flows, 0u);
+  const int64_t start_ms = TickTime::MillisecondTimestamp();
+  Link uplink;
+  Link downlink;
+  Random random(scenario.seed);
+
+  FlowIds all_flow_ids;
+  std::vector<int> media_flow_ids;
+  std::vector<int> tcp_flow_ids;
+  int next_flow_id = 0;
+  for (size_t i = 0; i < scenario.num_media_flows; ++i) {
+    media_flow_ids.push_back(next_flow_id);
+    all_flow_ids.insert(next_flow_id++);
+  }
+  for (size_t i = 0; i < scenario.num_tcp_flows; ++i) {
+    tcp_flow_ids.push_back(next_flow_id);
+    all_flow_ids.insert(next_flow_id++);
+  }
+
+  ScopedVector<VideoSource> sources;
+  ScopedVector<PacketSender> senders;
+  for (size_t i = 0; i < media_flow_ids.size(); ++i) {
+    // The first flow starts immediately, the others at random offsets to give
+    // them a different advantage when competing for the bandwidth.
+    const int64_t start_offset_ms =
+        i == 0 ? 0 : static_cast<int64_t>(random.Rand() * kFlowStartSpreadMs);
+    sources.push_back(new AdaptiveVideoSource(media_flow_ids[i], 30, 300, 0,
+                                              start_offset_ms));
+    senders.push_back(
+        new PacedVideoSender(&uplink, sources.back(), scenario.bwe_type));
+  }
+  for (int tcp_flow : tcp_flow_ids)
+    senders.push_back(new TcpSender(&uplink, tcp_flow, kTcpStartOffsetMs));
+
+  PacketCounterFilter sent_counter(&uplink, all_flow_ids);
+  LossFilter loss(&uplink, all_flow_ids);
+  loss.SetLoss(scenario.loss_percent);
+  JitterFilter jitter(&uplink, all_flow_ids);
+  jitter.SetJitter(scenario.jitter_ms);
+  ChokeFilter choke(&uplink, all_flow_ids);
+  choke.SetCapacity(scenario.capacity_kbps);
+  choke.SetMaxDelay(scenario.max_delay_ms);
+  DelayFilter delay_uplink(&uplink, all_flow_ids);
+  delay_uplink.SetDelayMs(scenario.one_way_delay_ms);
+
+  ScopedVector<RateCounterFilter> rate_counters;
+  for (int flow : all_flow_ids) {
+    rate_counters.push_back(
+        new RateCounterFilter(&uplink, flow, "receiver_input"));
+  }
+  RateCounterFilter total_utilization(&uplink, all_flow_ids,
+                                      "total_utilization");
+  PacketCounterFilter received_counter(&uplink, all_flow_ids);
+
+  ScopedVector<PacketReceiver> receivers;
+  for (int media_flow : media_flow_ids) {
+    receivers.push_back(new PacketReceiver(&uplink, media_flow,
+                                           scenario.bwe_type, false, false));
+  }
+  for (int tcp_flow : tcp_flow_ids) {
+    receivers.push_back(
+        new PacketReceiver(&uplink, tcp_flow, kTcpEstimator, false, false));
+  }
+
+  DelayFilter delay_downlink(&downlink, all_flow_ids);
+  delay_downlink.SetDelayMs(scenario.one_way_delay_ms);
+
+  Packets packets;
+  RunLinks(&uplink, &downlink, scenario.run_time_ms, &packets);
+  for (Packet* packet : packets)
+    delete packet;
+
+  BweScenarioResult result;
+  result.scenario = scenario;
+  result.throughput_kbps = total_utilization.GetBitrateStats();
+  result.utilization_percent =
+      100.0 * result.throughput_kbps.GetMean() / scenario.capacity_kbps;
+  for (RateCounterFilter* rate_counter : rate_counters) {
+    result.flow_throughput_kbps[*rate_counter->flow_ids().begin()] =
+        rate_counter->GetBitrateStats();
+  }
+  for (PacketReceiver* receiver : receivers) {
+    result.flow_delay_ms[*receiver->flow_ids().begin()] =
+        receiver->GetDelayStats();
+  }
+  result.fairness_percent = 100.0 * FairnessIndex(&result.flow_throughput_kbps);
+  if (sent_counter.num_packets() > 0) {
+    result.loss_percent =
+        100.0 * (sent_counter.num_packets() - received_counter.num_packets()) /
+        sent_counter.num_packets();
+  }
+  result.elapsed_ms = TickTime::MillisecondTimestamp() - start_ms;
+  return result;
+}
+
+std::vector<BweScenario> ExpandBweScenarioSweep(
+    const BweScenario& base,
+    const BweScenarioSweep& sweep) {
+  const std::vector<BandwidthEstimatorType> bwe_types =
+      sweep.bwe_types.empty()
+          ? std::vector<BandwidthEstimatorType>(1, base.bwe_type)
+          : sweep.bwe_types;
+  const std::vector<int> capacities_kbps =
+      sweep.capacities_kbps.empty()
+          ? std::vector<int>(1, base.capacity_kbps)
+          : sweep.capacities_kbps;
+  const std::vector<int> one_way_delays_ms =
+      sweep.one_way_delays_ms.empty()
+          ? std::vector<int>(1, base.one_way_delay_ms)
+          : sweep.one_way_delays_ms;
+  const std::vector<float> loss_percents =
+      sweep.loss_percents.empty() ? std::vector<float>(1, base.loss_percent)
+                                  : sweep.loss_percents;
+  const std::vector<uint32_t> seeds =
+      sweep.seeds.empty() ? std::vector<uint32_t>(1, base.seed) : sweep.seeds;
+
+  std::vector<BweScenario> scenarios;
+  for (BandwidthEstimatorType bwe_type : bwe_types) {
+    for (int capacity_kbps : capacities_kbps) {
+      for (int one_way_delay_ms : one_way_delays_ms) {
+        for (float loss_percent : loss_percents) {
+          for (uint32_t seed : seeds) {
+            BweScenario scenario = base;
+            scenario.bwe_type = bwe_type;
+            scenario.capacity_kbps = capacity_kbps;
+            scenario.one_way_delay_ms = one_way_delay_ms;
+            scenario.loss_percent = loss_percent;
+            scenario.seed = seed;
+            std::stringstream ss;
+            ss << base.name << "_" << EstimatorName(bwe_type) << "_"
+               << capacity_kbps << "kbps_" << one_way_delay_ms << "ms_"
+               << loss_percent << "loss_seed" << seed;
+            scenario.name = ss.str();
+            scenarios.push_back(scenario);
+          }
+        }
+      }
+    }
+  }
+  return scenarios;
+}
+
+BweBatchRunner::BweBatchRunner(size_t num_threads)
+    : num_threads_(num_threads) {
+}
+
+BweBatchRunner::~BweBatchRunner() {
+}
+
+void BweBatchRunner::AddScenario(const BweScenario& scenario) {
+  scenarios_.push_back(scenario);
+}
+
+void BweBatchRunner::AddScenarios(const std::vector<BweScenario>& scenarios) {
+  scenarios_.insert(scenarios_.end(), scenarios.begin(), scenarios.end());
+}
+
+void BweBatchRunner::Run() {
+  results_.clear();
+  results_.resize(scenarios_.size());
+  ScopedVector<ScenarioTask> tasks;
+  std::vector<WorkerPool::Task*> task_ptrs;
+  for (size_t i = 0; i < scenarios_.size(); ++i) {
+    tasks.push_back(new ScenarioTask(&scenarios_[i], &results_[i]));
+    task_ptrs.push_back(tasks.back());
+  }
+  if (task_ptrs.empty())
+    return;
+  WorkerPool pool(num_threads_, "BweBatchRunner");
+  pool.RunTasks(&task_ptrs[0], task_ptrs.size());
+}
+
+void BweBatchRunner::WriteJsonReport(FILE* file) const {
+  fprintf(file, "[\n");
+  for (size_t i = 0; i < results_.size(); ++i) {
+    const BweScenarioResult& result = results_[i];
+    const BweScenario& scenario = result.scenario;
+    fprintf(file, "  {\"name\": \"%s\", \"estimator\": \"%s\", "
+            "\"media_flows\": %" PRIuS ", \"tcp_flows\": %" PRIuS ", "
+            "\"run_time_ms\": %" PRId64 ", \"capacity_kbps\": %d, "
+            "\"max_delay_ms\": %d, "
+            "\"one_way_delay_ms\": %d, \"configured_loss_percent\": %f, "
+            "\"jitter_ms\": %" PRId64 ", \"seed\": %u, ",
+            scenario.name.c_str(), EstimatorName(scenario.bwe_type),
+            scenario.num_media_flows, scenario.num_tcp_flows,
+            scenario.run_time_ms, scenario.capacity_kbps,
+            scenario.max_delay_ms, scenario.one_way_delay_ms,
+            scenario.loss_percent, scenario.jitter_ms, scenario.seed);
+    fprintf(file, "\"utilization_percent\": %f, \"fairness_percent\": %f, "
+            "\"loss_percent\": %f, \"elapsed_ms\": %" PRId64 ", ",
+            result.utilization_percent, result.fairness_percent,
+            result.loss_percent, result.elapsed_ms);
+    WriteJsonStats(file, "throughput_kbps", result.throughput_kbps);
+    fprintf(file, ", ");
+    WriteJsonFlowStats(file, "flow_throughput_kbps",
+                       result.flow_throughput_kbps);
+    fprintf(file, ", ");
+    WriteJsonFlowStats(file, "flow_delay_ms", result.flow_delay_ms);
+    fprintf(file, "}%s\n", i + 1 < results_.size() ? "," : "");
+  }
+  fprintf(file, "]\n");
+}
+
+void BweBatchRunner::PrintResults() const {
+  for (const BweScenarioResult& result : results_) {
+    const std::string& name = result.scenario.name;
+    webrtc::test::PrintResult("BweBatch", "", name + "_utilization",
+                              result.utilization_percent, "%", false);
+    webrtc::test::PrintResult("BweBatch", "", name + "_fairness",
+                              result.fairness_percent, "%", false);
+    webrtc::test::PrintResult("BweBatch", "", name + "_loss",
+                              result.loss_percent, "%", false);
+    for (const auto& kv : result.flow_delay_ms) {
+      Stats<double> delay_ms = kv.second;
+      std::stringstream ss;
+      ss << name << "_delay_flow_" << kv.first;
+      webrtc::test::PrintResultMeanAndError("BweBatch", "", ss.str(),
+                                            delay_ms.AsString(), "ms", false);
+    }
+  }
+}
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_BATCH_RUNNER_H_
+#define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_BATCH_RUNNER_H_
+
+#include <stdio.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_test_framework.h"
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+
+// Describes one self-contained simulation: a number of media and TCP flows
+// sharing a bottleneck link. Every scenario owns its own links and simulated
+// clocks, so scenarios can run concurrently on different threads.
+struct BweScenario {
+  BweScenario();
+
+  std::string name;
+  BandwidthEstimatorType bwe_type;
+  size_t num_media_flows;
+  size_t num_tcp_flows;
+  int64_t run_time_ms;
+  int capacity_kbps;
+  int max_delay_ms;
+  int one_way_delay_ms;
+  float loss_percent;
+  int64_t jitter_ms;
+  // Seeds the flow start offsets, so that repeated runs of the same scenario
+  // give identical results regardless of which thread runs them.
+  uint32_t seed;
+};
+
+// Cartesian product of parameter values to apply to a base scenario. Empty
+// lists leave the corresponding parameter of the base scenario untouched.
+struct BweScenarioSweep {
+  std::vector<BandwidthEstimatorType> bwe_types;
+  std::vector<int> capacities_kbps;
+  std::vector<int> one_way_delays_ms;
+  std::vector<float> loss_percents;
+  std::vector<uint32_t> seeds;
+};
+
+struct BweScenarioResult {
+  BweScenarioResult();
+
+  BweScenario scenario;
+  double utilization_percent;
+  double fairness_percent;
+  double loss_percent;
+  Stats<double> throughput_kbps;
+  std::map<int, Stats<double>> flow_throughput_kbps;
+  std::map<int, Stats<double>> flow_delay_ms;
+  // Wall clock time spent running the scenario.
+  int64_t elapsed_ms;
+};
+
+// Runs |scenario| to completion on the calling thread.
+BweScenarioResult RunBweScenario(const BweScenario& scenario);
+
+// Expands |sweep| over |base| and returns one scenario per combination. The
+// scenarios are named after the swept parameter values.
+std::vector<BweScenario> ExpandBweScenarioSweep(const BweScenario& base,
+                                                const BweScenarioSweep& sweep);
+
+// Runs a batch of independent scenarios in parallel across cores. Results are
+// reported in the order the scenarios were added, independently of the number
+// of threads used.
+class BweBatchRunner {
+ public:
+  // |num_threads| is the number of worker threads to use in addition to the
+  // thread calling Run().
+  explicit BweBatchRunner(size_t num_threads);
+  ~BweBatchRunner();
+
+  void AddScenario(const BweScenario& scenario);
+  void AddScenarios(const std::vector<BweScenario>& scenarios);
+
+  void Run();
+
+  const std::vector<BweScenarioResult>& results() const { return results_; }
+
+  // Writes the results as a JSON array with one object per scenario.
+  void WriteJsonReport(FILE* file) const;
+  // Prints the results through the perf test reporting.
+  void PrintResults() const;
+
+ private:
+  const size_t num_threads_;
+  std::vector<BweScenario> scenarios_;
+  std::vector<BweScenarioResult> results_;
+
+  DISALLOW_COPY_AND_ASSIGN(BweBatchRunner);
+};
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_BATCH_RUNNER_H_
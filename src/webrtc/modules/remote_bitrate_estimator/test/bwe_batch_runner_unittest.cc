@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_batch_runner.h"
+
+#include <stdio.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/worker_pool.h"
+#include "webrtc/test/testsupport/fileutils.h"
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+
+namespace {
+std::vector<BweScenario> CreateShortSweep() {
+  BweScenario base;
+  base.name = "Short";
+  base.num_media_flows = 2;
+  base.run_time_ms = 5000;
+  BweScenarioSweep sweep;
+  sweep.bwe_types.push_back(kRembEstimator);
+  sweep.bwe_types.push_back(kFullSendSideEstimator);
+  sweep.capacities_kbps.push_back(500);
+  sweep.capacities_kbps.push_back(2000);
+  sweep.seeds.push_back(1);
+  sweep.seeds.push_back(2);
+  return ExpandBweScenarioSweep(base, sweep);
+}
+}  // namespace
+
+TEST(BweBatchRunnerTest, ExpandsSweep) {
+  std::vector<BweScenario> scenarios = CreateShortSweep();
+  ASSERT_EQ(8u, scenarios.size());
+  EXPECT_EQ(kRembEstimator, scenarios[0].bwe_type);
+  EXPECT_EQ(500, scenarios[0].capacity_kbps);
+  EXPECT_EQ(1u, scenarios[0].seed);
+  EXPECT_EQ(2u, scenarios[1].seed);
+  EXPECT_EQ(2000, scenarios[2].capacity_kbps);
+  EXPECT_EQ(kFullSendSideEstimator, scenarios[7].bwe_type);
+  // Parameters which aren't swept are taken from the base scenario.
+  for (const BweScenario& scenario : scenarios) {
+    EXPECT_EQ(2u, scenario.num_media_flows);
+    EXPECT_EQ(5000, scenario.run_time_ms);
+  }
+  EXPECT_NE(scenarios[0].name, scenarios[1].name);
+}
+
+TEST(BweBatchRunnerTest, ParallelRunMatchesSerialRun) {
+  std::vector<BweScenario> scenarios = CreateShortSweep();
+  BweBatchRunner serial(0);
+  serial.AddScenarios(scenarios);
+  serial.Run();
+  BweBatchRunner parallel(4);
+  parallel.AddScenarios(scenarios);
+  parallel.Run();
+
+  ASSERT_EQ(scenarios.size(), serial.results().size());
+  ASSERT_EQ(scenarios.size(), parallel.results().size());
+  for (size_t i = 0; i < scenarios.size(); ++i) {
+    const BweScenarioResult& a = serial.results()[i];
+    const BweScenarioResult& b = parallel.results()[i];
+    EXPECT_EQ(scenarios[i].name, a.scenario.name);
+    EXPECT_EQ(scenarios[i].name, b.scenario.name);
+    EXPECT_GT(a.utilization_percent, 0.0);
+    EXPECT_EQ(a.utilization_percent, b.utilization_percent);
+    EXPECT_EQ(a.fairness_percent, b.fairness_percent);
+    EXPECT_EQ(a.loss_percent, b.loss_percent);
+    ASSERT_EQ(a.flow_delay_ms.size(), b.flow_delay_ms.size());
+    for (const auto& kv : a.flow_delay_ms) {
+      Stats<double> delay_a = kv.second;
+      Stats<double> delay_b = b.flow_delay_ms.find(kv.first)->second;
+      EXPECT_EQ(delay_a.GetMean(), delay_b.GetMean());
+    }
+  }
+}
+
+TEST(BweBatchRunnerTest, WritesJsonReport) {
+  BweScenario scenario;
+  scenario.run_time_ms = 2000;
+  BweBatchRunner runner(1);
+  runner.AddScenario(scenario);
+  runner.AddScenario(scenario);
+  runner.Run();
+  const std::string filename =
+      webrtc::test::OutputPath() + "bwe_batch_runner_report.json";
+  FILE* file = fopen(filename.c_str(), "w");
+  ASSERT_TRUE(file != NULL);
+  runner.WriteJsonReport(file);
+  fclose(file);
+  EXPECT_GT(webrtc::test::GetFileSize(filename), 0u);
+  remove(filename.c_str());
+}
+
+// Example of an estimator tuning sweep. Disabled by default since it runs
+// several hours worth of simulated time.
+TEST(BweBatchRunnerTest, DISABLED_FairnessSweep) {
+  BweScenario base;
+  base.name = "Fairness";
+  base.num_media_flows = 3;
+  base.num_tcp_flows = 1;
+  base.run_time_ms = 300 * 1000;
+  BweScenarioSweep sweep;
+  sweep.bwe_types.push_back(kRembEstimator);
+  sweep.bwe_types.push_back(kFullSendSideEstimator);
+  sweep.bwe_types.push_back(kNadaEstimator);
+  sweep.capacities_kbps.push_back(500);
+  sweep.capacities_kbps.push_back(1000);
+  sweep.capacities_kbps.push_back(3000);
+  sweep.one_way_delays_ms.push_back(25);
+  sweep.one_way_delays_ms.push_back(100);
+  sweep.loss_percents.push_back(0.0f);
+  sweep.loss_percents.push_back(2.0f);
+  for (uint32_t seed = 0; seed < 5; ++seed)
+    sweep.seeds.push_back(seed);
+
+  BweBatchRunner runner(WorkerPool::DefaultNumThreads());
+  runner.AddScenarios(ExpandBweScenarioSweep(base, sweep));
+  runner.Run();
+  runner.PrintResults();
+  FILE* file = fopen(
+      (webrtc::test::OutputPath() + "bwe_fairness_sweep.json").c_str(), "w");
+  ASSERT_TRUE(file != NULL);
+  runner.WriteJsonReport(file);
+  fclose(file);
+}
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
@@ -67,7 +67,7 @@ int main(int argc, char** argv) {
   int64_t first_rtp_time_ms = -1;
   int abs_send_time_count = 0;
   int ts_offset_count = 0;
-  webrtc::test::RtpPacket packet;
+  webrtc::test::RtpPacketRef packet;
   if (!rtp_reader->NextPacket(&packet)) {
     printf("No RTP packet found\n");
     return 0;
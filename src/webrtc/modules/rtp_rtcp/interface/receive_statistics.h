@@ -39,11 +39,13 @@ class StreamStatistician {
   virtual void ResetStatistics() = 0;
 
   // Returns true if the packet with RTP header |header| is likely to be a
-  // retransmitted packet, false otherwise.
+  // retransmitted packet, false otherwise. Must be called on the thread which
+  // delivers the packets to ReceiveStatistics::IncomingPacket().
   virtual bool IsRetransmitOfOldPacket(const RTPHeader& header,
                                        int64_t min_rtt) const = 0;
 
   // Returns true if |sequence_number| is received in order, false otherwise.
+  // Must be called on the thread which delivers the packets.
   virtual bool IsPacketInOrder(uint16_t sequence_number) const = 0;
 };
 
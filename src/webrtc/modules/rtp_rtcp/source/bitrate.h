@@ -37,6 +37,9 @@ class Bitrate {
   // Update with a packet.
   void Update(const size_t bytes);
 
+  // Update with |packets| packets totalling |bytes| bytes.
+  void Update(const size_t bytes, const uint32_t packets);
+
   // Packet rate last second, updated roughly every 100 ms.
   uint32_t PacketRate() const;
 
@@ -12,6 +12,7 @@
 
 #include <math.h>
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/rtp_rtcp/source/bitrate.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
@@ -24,27 +25,47 @@ const int64_t kStatisticsProcessIntervalMs = 1000;
 
 StreamStatistician::~StreamStatistician() {}
 
+StreamStatisticianImpl::ReceiveState::ReceiveState()
+    : ssrc(0),
+      resets(0),
+      jitter_q4(0),
+      jitter_q4_transmission_time_offset(0),
+      last_receive_time_ms(0),
+      last_receive_time_secs(0),
+      last_receive_time_frac(0),
+      last_received_timestamp(0),
+      last_received_transmission_time_offset(0),
+      received_seq_first(0),
+      received_seq_max(0),
+      received_seq_wraps(0),
+      received_packet_overhead(12) {}
+
+void StreamStatisticianImpl::ReceiveState::Reset() {
+  jitter_q4 = 0;
+  jitter_q4_transmission_time_offset = 0;
+  received_seq_wraps = 0;
+  received_seq_max = 0;
+  received_seq_first = 0;
+  stored_sum_receive_counters.Add(receive_counters);
+  receive_counters = StreamDataCounters();
+}
+
 StreamStatisticianImpl::StreamStatisticianImpl(
     Clock* clock,
     RtcpStatisticsCallback* rtcp_callback,
     StreamDataCountersCallback* rtp_callback)
     : clock_(clock),
       stream_lock_(CriticalSectionWrapper::CreateCriticalSection()),
-      incoming_bitrate_(clock, NULL),
-      ssrc_(0),
+      max_reordering_threshold_network_(kDefaultMaxReorderingThreshold),
+      control_version_seen_(0),
+      control_version_(0),
+      published_seq_(0),
       max_reordering_threshold_(kDefaultMaxReorderingThreshold),
-      jitter_q4_(0),
+      resets_requested_(0),
+      incoming_bitrate_(clock, NULL),
+      bitrate_bytes_(0),
+      bitrate_packets_(0),
       cumulative_loss_(0),
-      jitter_q4_transmission_time_offset_(0),
-      last_receive_time_ms_(0),
-      last_receive_time_secs_(0),
-      last_receive_time_frac_(0),
-      last_received_timestamp_(0),
-      last_received_transmission_time_offset_(0),
-      received_seq_first_(0),
-      received_seq_max_(0),
-      received_seq_wraps_(0),
-      received_packet_overhead_(12),
       last_report_inorder_packets_(0),
       last_report_old_packets_(0),
       last_report_seq_max_(0),
@@ -57,38 +78,48 @@ void StreamStatisticianImpl::ResetStatistics() {
   last_report_old_packets_ = 0;
   last_report_seq_max_ = 0;
   last_reported_statistics_ = RtcpStatistics();
-  jitter_q4_ = 0;
   cumulative_loss_ = 0;
-  jitter_q4_transmission_time_offset_ = 0;
-  received_seq_wraps_ = 0;
-  received_seq_max_ = 0;
-  received_seq_first_ = 0;
-  stored_sum_receive_counters_.Add(receive_counters_);
-  receive_counters_ = StreamDataCounters();
+  // The received stats are reset by the network thread on the next packet.
+  ++resets_requested_;
+  rtc::AtomicOps::Increment(&control_version_);
 }
 
 void StreamStatisticianImpl::IncomingPacket(const RTPHeader& header,
                                             size_t packet_length,
                                             bool retransmitted) {
+  ApplyPendingChanges();
   UpdateCounters(header, packet_length, retransmitted);
+  Publish();
   NotifyRtpCallback();
 }
 
+void StreamStatisticianImpl::ApplyPendingChanges() {
+  if (rtc::AtomicOps::Load(&control_version_) == control_version_seen_)
+    return;
+  CriticalSectionScoped cs(stream_lock_.get());
+  control_version_seen_ = rtc::AtomicOps::Load(&control_version_);
+  max_reordering_threshold_network_ = max_reordering_threshold_;
+  if (state_.resets != resets_requested_) {
+    state_.Reset();
+    state_.resets = resets_requested_;
+  }
+}
+
 void StreamStatisticianImpl::UpdateCounters(const RTPHeader& header,
                                             size_t packet_length,
                                             bool retransmitted) {
-  CriticalSectionScoped cs(stream_lock_.get());
-  bool in_order = InOrderPacketInternal(header.sequenceNumber);
-  ssrc_ = header.ssrc;
-  incoming_bitrate_.Update(packet_length);
-  receive_counters_.transmitted.AddPacket(packet_length, header);
+  bool in_order = InOrderPacketInternal(
+      state_, max_reordering_threshold_network_, header.sequenceNumber);
+  state_.ssrc = header.ssrc;
+  StreamDataCounters& counters = state_.receive_counters;
+  counters.transmitted.AddPacket(packet_length, header);
   if (!in_order && retransmitted) {
-    receive_counters_.retransmitted.AddPacket(packet_length, header);
+    counters.retransmitted.AddPacket(packet_length, header);
   }
 
-  if (receive_counters_.transmitted.packets == 1) {
-    received_seq_first_ = header.sequenceNumber;
-    receive_counters_.first_packet_time_ms = clock_->TimeInMilliseconds();
+  if (counters.transmitted.packets == 1) {
+    state_.received_seq_first = header.sequenceNumber;
+    counters.first_packet_time_ms = clock_->TimeInMilliseconds();
   }
 
   // Count only the new packets received. That is, if packets 1, 2, 3, 5, 4, 6
@@ -100,32 +131,32 @@ void StreamStatisticianImpl::UpdateCounters(const RTPHeader& header,
     clock_->CurrentNtp(receive_time_secs, receive_time_frac);
 
     // Wrong if we use RetransmitOfOldPacket.
-    if (receive_counters_.transmitted.packets > 1 &&
-        received_seq_max_ > header.sequenceNumber) {
+    if (counters.transmitted.packets > 1 &&
+        state_.received_seq_max > header.sequenceNumber) {
       // Wrap around detected.
-      received_seq_wraps_++;
+      state_.received_seq_wraps++;
     }
     // New max.
-    received_seq_max_ = header.sequenceNumber;
+    state_.received_seq_max = header.sequenceNumber;
 
     // If new time stamp and more than one in-order packet received, calculate
     // new jitter statistics.
-    if (header.timestamp != last_received_timestamp_ &&
-        (receive_counters_.transmitted.packets -
-         receive_counters_.retransmitted.packets) > 1) {
+    if (header.timestamp != state_.last_received_timestamp &&
+        (counters.transmitted.packets - counters.retransmitted.packets) > 1) {
       UpdateJitter(header, receive_time_secs, receive_time_frac);
     }
-    last_received_timestamp_ = header.timestamp;
-    last_receive_time_secs_ = receive_time_secs;
-    last_receive_time_frac_ = receive_time_frac;
-    last_receive_time_ms_ = clock_->TimeInMilliseconds();
+    state_.last_received_timestamp = header.timestamp;
+    state_.last_receive_time_secs = receive_time_secs;
+    state_.last_receive_time_frac = receive_time_frac;
+    state_.last_receive_time_ms = clock_->TimeInMilliseconds();
   }
 
   size_t packet_oh = header.headerLength + header.paddingLength;
 
   // Our measured overhead. Filter from RFC 5104 4.2.1.2:
   // avg_OH (new) = 15/16*avg_OH (old) + 1/16*pckt_OH,
-  received_packet_overhead_ = (15 * received_packet_overhead_ + packet_oh) >> 4;
+  state_.received_packet_overhead =
+      (15 * state_.received_packet_overhead + packet_oh) >> 4;
 }
 
 void StreamStatisticianImpl::UpdateJitter(const RTPHeader& header,
@@ -134,11 +165,11 @@ void StreamStatisticianImpl::UpdateJitter(const RTPHeader& header,
   uint32_t receive_time_rtp = RtpUtility::ConvertNTPTimeToRTP(
       receive_time_secs, receive_time_frac, header.payload_type_frequency);
   uint32_t last_receive_time_rtp =
-      RtpUtility::ConvertNTPTimeToRTP(last_receive_time_secs_,
-                                      last_receive_time_frac_,
+      RtpUtility::ConvertNTPTimeToRTP(state_.last_receive_time_secs,
+                                      state_.last_receive_time_frac,
                                       header.payload_type_frequency);
   int32_t time_diff_samples = (receive_time_rtp - last_receive_time_rtp) -
-      (header.timestamp - last_received_timestamp_);
+      (header.timestamp - state_.last_received_timestamp);
 
   time_diff_samples = abs(time_diff_samples);
 
@@ -147,8 +178,8 @@ void StreamStatisticianImpl::UpdateJitter(const RTPHeader& header,
   // as the threshold.
   if (time_diff_samples < 450000) {
     // Note we calculate in Q4 to avoid using float.
-    int32_t jitter_diff_q4 = (time_diff_samples << 4) - jitter_q4_;
-    jitter_q4_ += ((jitter_diff_q4 + 8) >> 4);
+    int32_t jitter_diff_q4 = (time_diff_samples << 4) - state_.jitter_q4;
+    state_.jitter_q4 += ((jitter_diff_q4 + 8) >> 4);
   }
 
   // Extended jitter report, RFC 5450.
@@ -157,47 +188,63 @@ void StreamStatisticianImpl::UpdateJitter(const RTPHeader& header,
     (receive_time_rtp - last_receive_time_rtp) -
     ((header.timestamp +
       header.extension.transmissionTimeOffset) -
-     (last_received_timestamp_ +
-      last_received_transmission_time_offset_));
+     (state_.last_received_timestamp +
+      state_.last_received_transmission_time_offset));
 
   time_diff_samples_ext = abs(time_diff_samples_ext);
 
   if (time_diff_samples_ext < 450000) {
     int32_t jitter_diffQ4TransmissionTimeOffset =
-      (time_diff_samples_ext << 4) - jitter_q4_transmission_time_offset_;
-    jitter_q4_transmission_time_offset_ +=
+      (time_diff_samples_ext << 4) - state_.jitter_q4_transmission_time_offset;
+    state_.jitter_q4_transmission_time_offset +=
       ((jitter_diffQ4TransmissionTimeOffset + 8) >> 4);
   }
 }
 
-void StreamStatisticianImpl::NotifyRtpCallback() {
-  StreamDataCounters data;
-  uint32_t ssrc;
-  {
-    CriticalSectionScoped cs(stream_lock_.get());
-    data = receive_counters_;
-    ssrc = ssrc_;
-  }
-  rtp_callback_->DataCountersUpdated(data, ssrc);
+void StreamStatisticianImpl::Publish() {
+  // The increments are full memory barriers, ordering the copy between them.
+  rtc::AtomicOps::Increment(&published_seq_);
+  published_state_ = state_;
+  rtc::AtomicOps::Increment(&published_seq_);
 }
 
-void StreamStatisticianImpl::NotifyRtcpCallback() {
-  RtcpStatistics data;
-  uint32_t ssrc;
-  {
-    CriticalSectionScoped cs(stream_lock_.get());
-    data = last_reported_statistics_;
-    ssrc = ssrc_;
+StreamStatisticianImpl::ReceiveState StreamStatisticianImpl::Snapshot() const {
+  ReceiveState state;
+  int seq;
+  do {
+    seq = rtc::AtomicOps::Load(&published_seq_);
+    state = published_state_;
+  } while ((seq & 1) != 0 || seq != rtc::AtomicOps::Load(&published_seq_));
+  if (state.resets != resets_requested_) {
+    state.Reset();
+    state.resets = resets_requested_;
   }
-  rtcp_callback_->StatisticsUpdated(data, ssrc);
+  return state;
+}
+
+void StreamStatisticianImpl::UpdateBitrate(const ReceiveState& state) const {
+  RtpPacketCounter total = state.receive_counters.transmitted;
+  total.Add(state.stored_sum_receive_counters.transmitted);
+  incoming_bitrate_.Update(total.TotalBytes() - bitrate_bytes_,
+                           total.packets - bitrate_packets_);
+  bitrate_bytes_ = total.TotalBytes();
+  bitrate_packets_ = total.packets;
+}
+
+void StreamStatisticianImpl::NotifyRtpCallback() {
+  rtp_callback_->DataCountersUpdated(state_.receive_counters, state_.ssrc);
+}
+
+void StreamStatisticianImpl::NotifyRtcpCallback(
+    const RtcpStatistics& statistics, uint32_t ssrc) {
+  rtcp_callback_->StatisticsUpdated(statistics, ssrc);
 }
 
 void StreamStatisticianImpl::FecPacketReceived(const RTPHeader& header,
                                                size_t packet_length) {
-  {
-    CriticalSectionScoped cs(stream_lock_.get());
-    receive_counters_.fec.AddPacket(packet_length, header);
-  }
+  ApplyPendingChanges();
+  state_.receive_counters.fec.AddPacket(packet_length, header);
+  Publish();
   NotifyRtpCallback();
 }
 
@@ -205,14 +252,17 @@ void StreamStatisticianImpl::SetMaxReorderingThreshold(
     int max_reordering_threshold) {
   CriticalSectionScoped cs(stream_lock_.get());
   max_reordering_threshold_ = max_reordering_threshold;
+  rtc::AtomicOps::Increment(&control_version_);
 }
 
 bool StreamStatisticianImpl::GetStatistics(RtcpStatistics* statistics,
                                            bool reset) {
+  uint32_t ssrc;
   {
     CriticalSectionScoped cs(stream_lock_.get());
-    if (received_seq_first_ == 0 &&
-        receive_counters_.transmitted.payload_bytes == 0) {
+    const ReceiveState state = Snapshot();
+    if (state.received_seq_first == 0 &&
+        state.receive_counters.transmitted.payload_bytes == 0) {
       // We have not received anything.
       return false;
     }
@@ -227,26 +277,29 @@ bool StreamStatisticianImpl::GetStatistics(RtcpStatistics* statistics,
       return true;
     }
 
-    *statistics = CalculateRtcpStatistics();
+    *statistics = CalculateRtcpStatistics(state);
+    ssrc = state.ssrc;
   }
 
-  NotifyRtcpCallback();
+  NotifyRtcpCallback(*statistics, ssrc);
 
   return true;
 }
 
-RtcpStatistics StreamStatisticianImpl::CalculateRtcpStatistics() {
+RtcpStatistics StreamStatisticianImpl::CalculateRtcpStatistics(
+    const ReceiveState& state) {
   RtcpStatistics stats;
+  const StreamDataCounters& counters = state.receive_counters;
 
   if (last_report_inorder_packets_ == 0) {
     // First time we send a report.
-    last_report_seq_max_ = received_seq_first_ - 1;
+    last_report_seq_max_ = state.received_seq_first - 1;
   }
 
   // Calculate fraction lost.
-  uint16_t exp_since_last = (received_seq_max_ - last_report_seq_max_);
+  uint16_t exp_since_last = (state.received_seq_max - last_report_seq_max_);
 
-  if (last_report_seq_max_ > received_seq_max_) {
+  if (last_report_seq_max_ > state.received_seq_max) {
     // Can we assume that the seq_num can't go decrease over a full RTCP period?
     exp_since_last = 0;
   }
@@ -254,8 +307,8 @@ RtcpStatistics StreamStatisticianImpl::CalculateRtcpStatistics() {
   // Number of received RTP packets since last report, counts all packets but
   // not re-transmissions.
   uint32_t rec_since_last =
-      (receive_counters_.transmitted.packets -
-       receive_counters_.retransmitted.packets) - last_report_inorder_packets_;
+      (counters.transmitted.packets - counters.retransmitted.packets) -
+      last_report_inorder_packets_;
 
   // With NACK we don't know the expected retransmissions during the last
   // second. We know how many "old" packets we have received. We just count
@@ -267,7 +320,7 @@ RtcpStatistics StreamStatisticianImpl::CalculateRtcpStatistics() {
   // re-transmitted. We use RTT to decide if a packet is re-ordered or
   // re-transmitted.
   uint32_t retransmitted_packets =
-      receive_counters_.retransmitted.packets - last_report_old_packets_;
+      counters.retransmitted.packets - last_report_old_packets_;
   rec_since_last += retransmitted_packets;
 
   int32_t missing = 0;
@@ -286,19 +339,18 @@ RtcpStatistics StreamStatisticianImpl::CalculateRtcpStatistics() {
   cumulative_loss_ += missing;
   stats.cumulative_lost = cumulative_loss_;
   stats.extended_max_sequence_number =
-      (received_seq_wraps_ << 16) + received_seq_max_;
+      (state.received_seq_wraps << 16) + state.received_seq_max;
   // Note: internal jitter value is in Q4 and needs to be scaled by 1/16.
-  stats.jitter = jitter_q4_ >> 4;
+  stats.jitter = state.jitter_q4 >> 4;
 
   // Store this report.
   last_reported_statistics_ = stats;
 
   // Only for report blocks in RTCP SR and RR.
   last_report_inorder_packets_ =
-      receive_counters_.transmitted.packets -
-      receive_counters_.retransmitted.packets;
-  last_report_old_packets_ = receive_counters_.retransmitted.packets;
-  last_report_seq_max_ = received_seq_max_;
+      counters.transmitted.packets - counters.retransmitted.packets;
+  last_report_old_packets_ = counters.retransmitted.packets;
+  last_report_seq_max_ = state.received_seq_max;
 
   return stats;
 }
@@ -306,60 +358,67 @@ RtcpStatistics StreamStatisticianImpl::CalculateRtcpStatistics() {
 void StreamStatisticianImpl::GetDataCounters(
     size_t* bytes_received, uint32_t* packets_received) const {
   CriticalSectionScoped cs(stream_lock_.get());
+  const ReceiveState state = Snapshot();
   if (bytes_received) {
-    *bytes_received = receive_counters_.transmitted.payload_bytes +
-                      receive_counters_.transmitted.header_bytes +
-                      receive_counters_.transmitted.padding_bytes;
+    *bytes_received = state.receive_counters.transmitted.payload_bytes +
+                      state.receive_counters.transmitted.header_bytes +
+                      state.receive_counters.transmitted.padding_bytes;
   }
   if (packets_received) {
-    *packets_received = receive_counters_.transmitted.packets;
+    *packets_received = state.receive_counters.transmitted.packets;
   }
 }
 
 void StreamStatisticianImpl::GetReceiveStreamDataCounters(
     StreamDataCounters* data_counters) const {
   CriticalSectionScoped cs(stream_lock_.get());
-  *data_counters = receive_counters_;
-  data_counters->Add(stored_sum_receive_counters_);
+  const ReceiveState state = Snapshot();
+  *data_counters = state.receive_counters;
+  data_counters->Add(state.stored_sum_receive_counters);
 }
 
 uint32_t StreamStatisticianImpl::BitrateReceived() const {
   CriticalSectionScoped cs(stream_lock_.get());
+  UpdateBitrate(Snapshot());
   return incoming_bitrate_.BitrateNow();
 }
 
 void StreamStatisticianImpl::ProcessBitrate() {
   CriticalSectionScoped cs(stream_lock_.get());
+  UpdateBitrate(Snapshot());
   incoming_bitrate_.Process();
 }
 
 void StreamStatisticianImpl::LastReceiveTimeNtp(uint32_t* secs,
                                                 uint32_t* frac) const {
   CriticalSectionScoped cs(stream_lock_.get());
-  *secs = last_receive_time_secs_;
-  *frac = last_receive_time_frac_;
+  const ReceiveState state = Snapshot();
+  *secs = state.last_receive_time_secs;
+  *frac = state.last_receive_time_frac;
 }
 
 bool StreamStatisticianImpl::IsRetransmitOfOldPacket(
     const RTPHeader& header, int64_t min_rtt) const {
-  CriticalSectionScoped cs(stream_lock_.get());
-  if (InOrderPacketInternal(header.sequenceNumber)) {
+  // Called on the network thread, which owns |state_|.
+  const ReceiveState& state = state_;
+  if (InOrderPacketInternal(state, max_reordering_threshold_network_,
+                            header.sequenceNumber)) {
     return false;
   }
   uint32_t frequency_khz = header.payload_type_frequency / 1000;
   assert(frequency_khz > 0);
 
   int64_t time_diff_ms = clock_->TimeInMilliseconds() -
-      last_receive_time_ms_;
+      state.last_receive_time_ms;
 
   // Diff in time stamp since last received in order.
-  uint32_t timestamp_diff = header.timestamp - last_received_timestamp_;
+  uint32_t timestamp_diff = header.timestamp - state.last_received_timestamp;
   uint32_t rtp_time_stamp_diff_ms = timestamp_diff / frequency_khz;
 
   int64_t max_delay_ms = 0;
   if (min_rtt == 0) {
     // Jitter standard deviation in samples.
-    float jitter_std = sqrt(static_cast<float>(jitter_q4_ >> 4));
+    float jitter_std = sqrt(static_cast<float>(state.jitter_q4 >> 4));
 
     // 2 times the standard deviation => 95% confidence.
     // And transform to milliseconds by dividing by the frequency in kHz.
@@ -376,22 +435,24 @@ bool StreamStatisticianImpl::IsRetransmitOfOldPacket(
 }
 
 bool StreamStatisticianImpl::IsPacketInOrder(uint16_t sequence_number) const {
-  CriticalSectionScoped cs(stream_lock_.get());
-  return InOrderPacketInternal(sequence_number);
+  return InOrderPacketInternal(state_, max_reordering_threshold_network_,
+                               sequence_number);
 }
 
 bool StreamStatisticianImpl::InOrderPacketInternal(
-    uint16_t sequence_number) const {
+    const ReceiveState& state,
+    int max_reordering_threshold,
+    uint16_t sequence_number) {
   // First packet is always in order.
-  if (last_receive_time_ms_ == 0)
+  if (state.last_receive_time_ms == 0)
     return true;
 
-  if (IsNewerSequenceNumber(sequence_number, received_seq_max_)) {
+  if (IsNewerSequenceNumber(sequence_number, state.received_seq_max)) {
     return true;
   } else {
     // If we have a restart of the remote side this packet is still in order.
-    return !IsNewerSequenceNumber(sequence_number, received_seq_max_ -
-                                  max_reordering_threshold_);
+    return !IsNewerSequenceNumber(sequence_number, state.received_seq_max -
+                                  max_reordering_threshold);
   }
 }
 
@@ -403,6 +464,8 @@ ReceiveStatisticsImpl::ReceiveStatisticsImpl(Clock* clock)
     : clock_(clock),
       receive_statistics_lock_(CriticalSectionWrapper::CreateCriticalSection()),
       last_rate_update_ms_(0),
+      last_statistician_(NULL),
+      last_ssrc_(0),
       rtcp_stats_callback_(NULL),
       rtp_stats_callback_(NULL) {}
 
@@ -416,27 +479,28 @@ ReceiveStatisticsImpl::~ReceiveStatisticsImpl() {
 void ReceiveStatisticsImpl::IncomingPacket(const RTPHeader& header,
                                            size_t packet_length,
                                            bool retransmitted) {
-  StreamStatisticianImpl* impl;
-  {
-    CriticalSectionScoped cs(receive_statistics_lock_.get());
+  // |statisticians_| is only modified on this thread, so it can be read here
+  // without holding receive_statistics_lock_.
+  StreamStatisticianImpl* impl = last_statistician_;
+  if (last_statistician_ == NULL || last_ssrc_ != header.ssrc) {
     StatisticianImplMap::iterator it = statisticians_.find(header.ssrc);
     if (it != statisticians_.end()) {
       impl = it->second;
     } else {
       impl = new StreamStatisticianImpl(clock_, this, this);
+      CriticalSectionScoped cs(receive_statistics_lock_.get());
       statisticians_[header.ssrc] = impl;
     }
+    last_statistician_ = impl;
+    last_ssrc_ = header.ssrc;
   }
   // StreamStatisticianImpl instance is created once and only destroyed when
-  // this whole ReceiveStatisticsImpl is destroyed. StreamStatisticianImpl has
-  // it's own locking so don't hold receive_statistics_lock_ (potential
-  // deadlock).
+  // this whole ReceiveStatisticsImpl is destroyed.
   impl->IncomingPacket(header, packet_length, retransmitted);
 }
 
 void ReceiveStatisticsImpl::FecPacketReceived(const RTPHeader& header,
                                               size_t packet_length) {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
   StatisticianImplMap::iterator it = statisticians_.find(header.ssrc);
   // Ignore FEC if it is the first packet.
   if (it != statisticians_.end()) {
@@ -527,10 +591,11 @@ void ReceiveStatisticsImpl::RegisterRtpStatisticsCallback(
 
 void ReceiveStatisticsImpl::DataCountersUpdated(const StreamDataCounters& stats,
                                                 uint32_t ssrc) {
+  // The lock is held during the call, so that the callback can't be called
+  // any more once RegisterRtpStatisticsCallback() has replaced it.
   CriticalSectionScoped cs(receive_statistics_lock_.get());
-  if (rtp_stats_callback_) {
+  if (rtp_stats_callback_)
     rtp_stats_callback_->DataCountersUpdated(stats, ssrc);
-  }
 }
 
 void NullReceiveStatistics::IncomingPacket(const RTPHeader& rtp_header,
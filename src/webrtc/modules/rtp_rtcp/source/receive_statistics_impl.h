@@ -23,6 +23,13 @@ namespace webrtc {
 
 class CriticalSectionWrapper;
 
+// Per-packet updates are made by a single network thread without locking. They
+// are published to readers through a sequence lock: the network thread bumps
+// |published_seq_| to an odd value, copies its state and bumps it back to an
+// even value, and readers retry their copy until they see the same even value
+// before and after it. Operations that change the state from other threads,
+// such as ResetStatistics(), are posted to the network thread, which applies
+// them on the next packet. Until then, readers apply them to their copy.
 class StreamStatisticianImpl : public StreamStatistician {
  public:
   StreamStatisticianImpl(Clock* clock,
@@ -37,62 +44,109 @@ class StreamStatisticianImpl : public StreamStatistician {
       StreamDataCounters* data_counters) const override;
   uint32_t BitrateReceived() const override;
   void ResetStatistics() override;
+  // These two must be called on the network thread. They look at the packets
+  // up to the last one, and don't see changes that will be applied with the
+  // next packet.
   bool IsRetransmitOfOldPacket(const RTPHeader& header,
                                int64_t min_rtt) const override;
   bool IsPacketInOrder(uint16_t sequence_number) const override;
 
+  // Must be called on the network thread.
   void IncomingPacket(const RTPHeader& rtp_header,
                       size_t packet_length,
                       bool retransmitted);
   void FecPacketReceived(const RTPHeader& header, size_t packet_length);
+
   void SetMaxReorderingThreshold(int max_reordering_threshold);
   void ProcessBitrate();
   virtual void LastReceiveTimeNtp(uint32_t* secs, uint32_t* frac) const;
 
  private:
-  bool InOrderPacketInternal(uint16_t sequence_number) const;
-  RtcpStatistics CalculateRtcpStatistics();
+  // Stats on received RTP packets.
+  struct ReceiveState {
+    ReceiveState();
+
+    // Clears the statistics as done by ResetStatistics().
+    void Reset();
+
+    uint32_t ssrc;
+    // Number of calls to ResetStatistics() applied to this state.
+    int resets;
+
+    uint32_t jitter_q4;
+    uint32_t jitter_q4_transmission_time_offset;
+
+    int64_t last_receive_time_ms;
+    uint32_t last_receive_time_secs;
+    uint32_t last_receive_time_frac;
+    uint32_t last_received_timestamp;
+    int32_t last_received_transmission_time_offset;
+    uint16_t received_seq_first;
+    uint16_t received_seq_max;
+    uint16_t received_seq_wraps;
+
+    // Current counter values.
+    size_t received_packet_overhead;
+    StreamDataCounters receive_counters;
+
+    // Stored counter values. Includes sum of reset counter values for the
+    // stream.
+    StreamDataCounters stored_sum_receive_counters;
+  };
+
+  static bool InOrderPacketInternal(const ReceiveState& state,
+                                    int max_reordering_threshold,
+                                    uint16_t sequence_number);
+  // Returns a consistent copy of the state published by the network thread,
+  // with pending resets applied.
+  ReceiveState Snapshot() const EXCLUSIVE_LOCKS_REQUIRED(stream_lock_.get());
+  // Feeds the bytes received since the last call to |incoming_bitrate_|.
+  void UpdateBitrate(const ReceiveState& state) const
+      EXCLUSIVE_LOCKS_REQUIRED(stream_lock_.get());
+  RtcpStatistics CalculateRtcpStatistics(const ReceiveState& state)
+      EXCLUSIVE_LOCKS_REQUIRED(stream_lock_.get());
+
+  // Network thread.
+  void ApplyPendingChanges() LOCKS_EXCLUDED(stream_lock_.get());
   void UpdateJitter(const RTPHeader& header,
                     uint32_t receive_time_secs,
                     uint32_t receive_time_frac);
   void UpdateCounters(const RTPHeader& rtp_header,
                       size_t packet_length,
                       bool retransmitted);
-  void NotifyRtpCallback() LOCKS_EXCLUDED(stream_lock_.get());
-  void NotifyRtcpCallback() LOCKS_EXCLUDED(stream_lock_.get());
+  void Publish();
+  void NotifyRtpCallback();
+  void NotifyRtcpCallback(const RtcpStatistics& statistics, uint32_t ssrc)
+      LOCKS_EXCLUDED(stream_lock_.get());
 
   Clock* clock_;
   rtc::scoped_ptr<CriticalSectionWrapper> stream_lock_;
-  Bitrate incoming_bitrate_;
-  uint32_t ssrc_;
-  int max_reordering_threshold_;  // In number of packets or sequence numbers.
 
-  // Stats on received RTP packets.
-  uint32_t jitter_q4_;
-  uint32_t cumulative_loss_;
-  uint32_t jitter_q4_transmission_time_offset_;
-
-  int64_t last_receive_time_ms_;
-  uint32_t last_receive_time_secs_;
-  uint32_t last_receive_time_frac_;
-  uint32_t last_received_timestamp_;
-  int32_t last_received_transmission_time_offset_;
-  uint16_t received_seq_first_;
-  uint16_t received_seq_max_;
-  uint16_t received_seq_wraps_;
-
-  // Current counter values.
-  size_t received_packet_overhead_;
-  StreamDataCounters receive_counters_;
-
-  // Stored counter values. Includes sum of reset counter values for the stream.
-  StreamDataCounters stored_sum_receive_counters_;
+  // Only accessed on the network thread.
+  ReceiveState state_;
+  int max_reordering_threshold_network_;
+  int control_version_seen_;
+
+  // Incremented whenever a reader changes |resets_requested_| or
+  // |max_reordering_threshold_|.
+  volatile int control_version_;
+  volatile int published_seq_;
+  ReceiveState published_state_;
+
+  // In number of packets or sequence numbers.
+  int max_reordering_threshold_ GUARDED_BY(stream_lock_);
+  int resets_requested_ GUARDED_BY(stream_lock_);
+  mutable Bitrate incoming_bitrate_;
+  mutable size_t bitrate_bytes_ GUARDED_BY(stream_lock_);
+  mutable uint32_t bitrate_packets_ GUARDED_BY(stream_lock_);
+
+  uint32_t cumulative_loss_ GUARDED_BY(stream_lock_);
 
   // Counter values when we sent the last report.
-  uint32_t last_report_inorder_packets_;
-  uint32_t last_report_old_packets_;
-  uint16_t last_report_seq_max_;
-  RtcpStatistics last_reported_statistics_;
+  uint32_t last_report_inorder_packets_ GUARDED_BY(stream_lock_);
+  uint32_t last_report_old_packets_ GUARDED_BY(stream_lock_);
+  uint16_t last_report_seq_max_ GUARDED_BY(stream_lock_);
+  RtcpStatistics last_reported_statistics_ GUARDED_BY(stream_lock_);
 
   RtcpStatisticsCallback* const rtcp_callback_;
   StreamDataCountersCallback* const rtp_callback_;
@@ -106,7 +160,8 @@ class ReceiveStatisticsImpl : public ReceiveStatistics,
 
   ~ReceiveStatisticsImpl();
 
-  // Implement ReceiveStatistics.
+  // Implement ReceiveStatistics. IncomingPacket() and FecPacketReceived() must
+  // always be called on the same (network) thread.
   void IncomingPacket(const RTPHeader& header,
                       size_t packet_length,
                       bool retransmitted) override;
@@ -138,7 +193,13 @@ class ReceiveStatisticsImpl : public ReceiveStatistics,
   Clock* clock_;
   rtc::scoped_ptr<CriticalSectionWrapper> receive_statistics_lock_;
   int64_t last_rate_update_ms_;
+  // Only modified on the network thread, under |receive_statistics_lock_|, so
+  // the network thread can look up statisticians without locking.
   StatisticianImplMap statisticians_;
+  // The statistician of the last incoming packet, only accessed on the network
+  // thread.
+  StreamStatisticianImpl* last_statistician_;
+  uint32_t last_ssrc_;
 
   RtcpStatisticsCallback* rtcp_stats_callback_;
   StreamDataCountersCallback* rtp_stats_callback_;
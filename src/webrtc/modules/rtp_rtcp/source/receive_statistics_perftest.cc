@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the per-packet cost of updating the receive statistics, with the
+// packets of an increasing number of streams interleaved as they would be on
+// a busy network thread. A second thread reads the statistics as the RTCP and
+// stats threads would.
+
+#include <sstream>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/rtp_rtcp/interface/receive_statistics.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const size_t kPacketSize = 1200;
+const size_t kHeaderLength = 12;
+const int kNumPackets = 1000000;
+const int kPacketsPerFrame = 3;
+
+class NullDataCountersCallback : public StreamDataCountersCallback {
+ public:
+  void DataCountersUpdated(const StreamDataCounters& counters,
+                           uint32_t ssrc) override {}
+};
+
+class StatisticsReader {
+ public:
+  explicit StatisticsReader(ReceiveStatistics* receive_statistics)
+      : receive_statistics_(receive_statistics) {}
+
+  static bool Run(void* obj) {
+    static_cast<StatisticsReader*>(obj)->Read();
+    return true;
+  }
+
+  void Read() {
+    StatisticianMap statisticians =
+        receive_statistics_->GetActiveStatisticians();
+    for (StatisticianMap::iterator it = statisticians.begin();
+         it != statisticians.end(); ++it) {
+      RtcpStatistics statistics;
+      it->second->GetStatistics(&statistics, true);
+      StreamDataCounters counters;
+      it->second->GetReceiveStreamDataCounters(&counters);
+    }
+    SleepMs(10);
+  }
+
+ private:
+  ReceiveStatistics* const receive_statistics_;
+};
+
+// Returns the time it took to feed |kNumPackets| packets, spread over
+// |num_streams| streams, in nanoseconds per packet.
+double RunStreams(int num_streams, bool with_reader) {
+  SimulatedClock clock(1);
+  rtc::scoped_ptr<ReceiveStatistics> receive_statistics(
+      ReceiveStatistics::Create(&clock));
+  NullDataCountersCallback callback;
+  receive_statistics->RegisterRtpStatisticsCallback(&callback);
+
+  RTPHeader header;
+  memset(&header, 0, sizeof(header));
+  header.headerLength = kHeaderLength;
+  header.payload_type_frequency = 90000;
+  // Create the statisticians before measuring.
+  for (int stream = 0; stream < num_streams; ++stream) {
+    header.ssrc = 1 + stream;
+    receive_statistics->IncomingPacket(header, kPacketSize, false);
+  }
+
+  StatisticsReader reader(receive_statistics.get());
+  rtc::scoped_ptr<ThreadWrapper> thread;
+  if (with_reader) {
+    thread = ThreadWrapper::CreateThread(&StatisticsReader::Run, &reader,
+                                         "StatisticsReader");
+    EXPECT_TRUE(thread->Start());
+  }
+
+  const TickTime start = TickTime::Now();
+  for (int i = 0; i < kNumPackets; ++i) {
+    // Frames of |kPacketsPerFrame| packets, with the streams taking turns.
+    const int frame = i / kPacketsPerFrame;
+    header.ssrc = 1 + frame % num_streams;
+    header.sequenceNumber = static_cast<uint16_t>(
+        1 + (frame / num_streams) * kPacketsPerFrame + i % kPacketsPerFrame);
+    header.timestamp = static_cast<uint32_t>(3000 * (frame / num_streams));
+    receive_statistics->IncomingPacket(header, kPacketSize, false);
+    if (i % 1000 == 0)
+      clock.AdvanceTimeMilliseconds(1);
+  }
+  const int64_t elapsed_us = (TickTime::Now() - start).Microseconds();
+
+  if (thread) {
+    EXPECT_TRUE(thread->Stop());
+  }
+  return 1000.0 * elapsed_us / kNumPackets;
+}
+
+void RunAndReport(int num_streams, bool with_reader) {
+  // Warm up caches and the allocator before measuring.
+  RunStreams(num_streams, with_reader);
+  std::stringstream ss;
+  ss << num_streams << "_streams";
+  webrtc::test::PrintResult("receive_statistics_incoming_packet",
+                            with_reader ? "_with_reader" : "", ss.str(),
+                            RunStreams(num_streams, with_reader), "ns/packet",
+                            false);
+}
+
+}  // namespace
+
+TEST(ReceiveStatisticsPerfTest, IncomingPacket) {
+  const int kNumStreams[] = {1, 100, 1000};
+  for (int num_streams : kNumStreams) {
+    RunAndReport(num_streams, false);
+    RunAndReport(num_streams, true);
+  }
+}
+
+}  // namespace webrtc
@@ -13,6 +13,7 @@
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/rtp_rtcp/interface/receive_statistics.h"
 #include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
 
 namespace webrtc {
 
@@ -155,6 +156,79 @@ TEST_F(ReceiveStatisticsTest, GetReceiveStreamDataCounters) {
   EXPECT_EQ(2u, counters.transmitted.packets);
 }
 
+TEST_F(ReceiveStatisticsTest, ResetStatisticsBeforeNextPacket) {
+  receive_statistics_->IncomingPacket(header1_, kPacketSize1, false);
+  ++header1_.sequenceNumber;
+  receive_statistics_->IncomingPacket(header1_, kPacketSize1, false);
+  ++header1_.sequenceNumber;
+  StreamStatistician* statistician =
+      receive_statistics_->GetStatistician(kSsrc1);
+  ASSERT_TRUE(statistician != NULL);
+  RtcpStatistics statistics;
+  EXPECT_TRUE(statistician->GetStatistics(&statistics, true));
+
+  // The reset is visible before the next packet arrives.
+  statistician->ResetStatistics();
+  size_t bytes_received = 0;
+  uint32_t packets_received = 0;
+  statistician->GetDataCounters(&bytes_received, &packets_received);
+  EXPECT_EQ(0u, bytes_received);
+  EXPECT_EQ(0u, packets_received);
+  EXPECT_FALSE(statistician->GetStatistics(&statistics, true));
+
+  receive_statistics_->IncomingPacket(header1_, kPacketSize1, false);
+  statistician->GetDataCounters(&bytes_received, &packets_received);
+  EXPECT_EQ(kPacketSize1, bytes_received);
+  EXPECT_EQ(1u, packets_received);
+  StreamDataCounters counters;
+  statistician->GetReceiveStreamDataCounters(&counters);
+  EXPECT_EQ(3u, counters.transmitted.packets);
+}
+
+class CounterReader {
+ public:
+  explicit CounterReader(StreamStatistician* statistician)
+      : statistician_(statistician), num_reads_(0), inconsistent_reads_(0) {}
+
+  static bool Run(void* obj) {
+    return static_cast<CounterReader*>(obj)->Read();
+  }
+
+  bool Read() {
+    size_t bytes_received = 0;
+    uint32_t packets_received = 0;
+    statistician_->GetDataCounters(&bytes_received, &packets_received);
+    if (bytes_received != packets_received * kPacketSize1)
+      ++inconsistent_reads_;
+    ++num_reads_;
+    return true;
+  }
+
+  StreamStatistician* const statistician_;
+  int num_reads_;
+  int inconsistent_reads_;
+};
+
+TEST_F(ReceiveStatisticsTest, ConsistentCountersWhileReceiving) {
+  receive_statistics_->IncomingPacket(header1_, kPacketSize1, false);
+  ++header1_.sequenceNumber;
+  StreamStatistician* statistician =
+      receive_statistics_->GetStatistician(kSsrc1);
+  ASSERT_TRUE(statistician != NULL);
+
+  CounterReader reader(statistician);
+  rtc::scoped_ptr<ThreadWrapper> thread = ThreadWrapper::CreateThread(
+      &CounterReader::Run, &reader, "CounterReader");
+  ASSERT_TRUE(thread->Start());
+  for (int i = 0; i < 100000; ++i) {
+    receive_statistics_->IncomingPacket(header1_, kPacketSize1, false);
+    ++header1_.sequenceNumber;
+  }
+  EXPECT_TRUE(thread->Stop());
+  EXPECT_GT(reader.num_reads_, 0);
+  EXPECT_EQ(0, reader.inconsistent_reads_);
+}
+
 TEST_F(ReceiveStatisticsTest, RtcpCallbacks) {
   class TestCallback : public RtcpStatisticsCallback {
    public:
@@ -12,9 +12,10 @@
 
 #include <assert.h>
 #include <stdlib.h>
-#include <string.h>   // memset
+#include <string.h>   // memcpy
+
+#include <algorithm>
 #include <limits>
-#include <set>
 
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
@@ -23,12 +24,26 @@
 namespace webrtc {
 
 static const int kMinPacketRequestBytes = 50;
+// One size bucket per possible packet length, with longer packets sharing the
+// last bucket.
+static const size_t kNumSizeBuckets = IP_PACKET_SIZE + 1;
+static const size_t kSizeBucketGroupSize = 32;
+static const size_t kNumSizeBucketGroups =
+    (kNumSizeBuckets + kSizeBucketGroupSize - 1) / kSizeBucketGroupSize;
+
+RTPPacketHistory::PacketSlot::PacketSlot()
+    : sequence_number(0),
+      stored_time_ms(0),
+      send_time_ms(0),
+      storage_type(kDontStore),
+      prev_in_bucket(-1),
+      next_in_bucket(-1) {
+}
 
 RTPPacketHistory::RTPPacketHistory(Clock* clock)
   : clock_(clock),
     critsect_(CriticalSectionWrapper::CreateCriticalSection()),
     store_(false),
-    prev_index_(0),
     max_packet_length_(0) {
 }
 
@@ -53,13 +68,13 @@ void RTPPacketHistory::SetStorePacketsStatus(bool enable,
 void RTPPacketHistory::Allocate(size_t number_to_store) {
   assert(number_to_store > 0);
   assert(number_to_store <= kMaxHistoryCapacity);
+  size_t capacity = 1;
+  while (capacity < number_to_store)
+    capacity *= 2;
   store_ = true;
-  stored_packets_.resize(number_to_store);
-  stored_seq_nums_.resize(number_to_store);
-  stored_lengths_.resize(number_to_store);
-  stored_times_.resize(number_to_store);
-  stored_send_times_.resize(number_to_store);
-  stored_types_.resize(number_to_store);
+  slots_.assign(capacity, PacketSlot());
+  size_buckets_.assign(kNumSizeBuckets, -1);
+  size_bucket_groups_.assign(kNumSizeBucketGroups, 0);
 }
 
 void RTPPacketHistory::Free() {
@@ -67,48 +82,34 @@ void RTPPacketHistory::Free() {
     return;
   }
 
-  std::vector<std::vector<uint8_t> >::iterator it;
-  for (it = stored_packets_.begin(); it != stored_packets_.end(); ++it) {
-    it->clear();
-  }
-
-  stored_packets_.clear();
-  stored_seq_nums_.clear();
-  stored_lengths_.clear();
-  stored_times_.clear();
-  stored_send_times_.clear();
-  stored_types_.clear();
+  slots_.clear();
+  size_buckets_.clear();
+  size_bucket_groups_.clear();
 
   store_ = false;
-  prev_index_ = 0;
   max_packet_length_ = 0;
 }
 
+void RTPPacketHistory::Expand() {
+  assert(slots_.size() < kMaxHistoryCapacity);
+  std::vector<PacketSlot> slots(slots_.size() * 2);
+  const size_t mask = slots.size() - 1;
+  // Slots which didn't collide before won't collide with the larger mask.
+  for (const PacketSlot& slot : slots_) {
+    if (slot.packet)
+      slots[slot.sequence_number & mask] = slot;
+  }
+  slots_.swap(slots);
+  RebuildSizeBuckets();
+}
+
 bool RTPPacketHistory::StorePackets() const {
   CriticalSectionScoped cs(critsect_.get());
   return store_;
 }
 
-void RTPPacketHistory::VerifyAndAllocatePacketLength(size_t packet_length,
-                                                     uint32_t start_index) {
-  assert(packet_length > 0);
-  if (!store_) {
-    return;
-  }
-
-  // If start_index > 0 this is a resize and we must check any new (empty)
-  // packets created during the resize.
-  if (start_index == 0 && packet_length <= max_packet_length_) {
-    return;
-  }
-
-  max_packet_length_ = std::max(packet_length, max_packet_length_);
-
-  std::vector<std::vector<uint8_t> >::iterator it;
-  for (it = stored_packets_.begin() + start_index; it != stored_packets_.end();
-       ++it) {
-    it->resize(max_packet_length_);
-  }
+size_t RTPPacketHistory::SlotIndex(uint16_t sequence_number) const {
+  return sequence_number & (slots_.size() - 1);
 }
 
 int32_t RTPPacketHistory::PutRTPPacket(const uint8_t* packet,
@@ -128,8 +129,7 @@ int32_t RTPPacketHistory::PutRTPPacket(const uint8_t* packet,
   assert(packet);
   assert(packet_length > 3);
 
-  VerifyAndAllocatePacketLength(max_packet_length, 0);
-
+  max_packet_length_ = std::max(max_packet_length, max_packet_length_);
   if (packet_length > max_packet_length_) {
     LOG(LS_WARNING) << "Failed to store RTP packet with length: "
                     << packet_length;
@@ -138,41 +138,34 @@ int32_t RTPPacketHistory::PutRTPPacket(const uint8_t* packet,
 
   const uint16_t seq_num = (packet[2] << 8) + packet[3];
 
-  // If index we're about to overwrite contains a packet that has not
-  // yet been sent (probably pending in paced sender), we need to expand
-  // the buffer.
-  if (stored_lengths_[prev_index_] > 0 &&
-      stored_send_times_[prev_index_] == 0) {
-    size_t current_size = static_cast<uint16_t>(stored_packets_.size());
-    if (current_size < kMaxHistoryCapacity) {
-      size_t expanded_size = std::max(current_size * 3 / 2, current_size + 1);
-      expanded_size = std::min(expanded_size, kMaxHistoryCapacity);
-      Allocate(expanded_size);
-      VerifyAndAllocatePacketLength(max_packet_length, current_size);
-      // Causes discontinuity, but that's OK-ish. FindSeqNum() will still work,
-      // but may be slower - at least until buffer has wrapped around once.
-      prev_index_ = current_size;
-    }
+  // If the slot we're about to overwrite contains a packet that has not yet
+  // been sent (probably pending in paced sender), we need to expand the
+  // buffer.
+  size_t index = SlotIndex(seq_num);
+  while (slots_[index].packet && slots_[index].send_time_ms == 0 &&
+         slots_[index].sequence_number != seq_num &&
+         slots_.size() < kMaxHistoryCapacity) {
+    Expand();
+    index = SlotIndex(seq_num);
   }
 
-  // Store packet
-  std::vector<std::vector<uint8_t> >::iterator it =
-      stored_packets_.begin() + prev_index_;
-  // TODO(sprang): Overhaul this class and get rid of this copy step.
-  //               (Finally introduce the RtpPacket class?)
-  std::copy(packet, packet + packet_length, it->begin());
-
-  stored_seq_nums_[prev_index_] = seq_num;
-  stored_lengths_[prev_index_] = packet_length;
-  stored_times_[prev_index_] = (capture_time_ms > 0) ? capture_time_ms :
-      clock_->TimeInMilliseconds();
-  stored_send_times_[prev_index_] = 0;  // Packet not sent.
-  stored_types_[prev_index_] = type;
-
-  ++prev_index_;
-  if (prev_index_ >= stored_seq_nums_.size()) {
-    prev_index_ = 0;
+  // Store packet. The buffer of the packet being replaced is reused unless
+  // it's still referenced by someone resending it.
+  PacketSlot& slot = slots_[index];
+  if (slot.packet) {
+    RemoveFromSizeBucket(static_cast<int>(index));
+    if (!slot.packet->HasOneRef())
+      slot.packet = NULL;
   }
+  if (!slot.packet)
+    slot.packet = new rtc::RefCountedObject<StoredPacket>();
+  slot.packet->data_.SetData(packet, packet_length);
+  slot.sequence_number = seq_num;
+  slot.stored_time_ms = (capture_time_ms > 0) ? capture_time_ms :
+      clock_->TimeInMilliseconds();
+  slot.send_time_ms = 0;  // Packet not sent.
+  slot.storage_type = type;
+  AddToSizeBucket(static_cast<int>(index));
   return 0;
 }
 
@@ -182,13 +175,12 @@ bool RTPPacketHistory::HasRTPPacket(uint16_t sequence_number) const {
     return false;
   }
 
-  int32_t index = 0;
-  bool found = FindSeqNum(sequence_number, &index);
-  if (!found) {
+  int index = FindSeqNum(sequence_number);
+  if (index < 0) {
     return false;
   }
 
-  size_t length = stored_lengths_.at(index);
+  size_t length = slots_[index].packet->length();
   if (length == 0 || length > max_packet_length_) {
     // Invalid length.
     return false;
@@ -202,18 +194,17 @@ bool RTPPacketHistory::SetSent(uint16_t sequence_number) {
     return false;
   }
 
-  int32_t index = 0;
-  bool found = FindSeqNum(sequence_number, &index);
-  if (!found) {
+  int index = FindSeqNum(sequence_number);
+  if (index < 0) {
     return false;
   }
 
   // Send time already set.
-  if (stored_send_times_[index] != 0) {
+  if (slots_[index].send_time_ms != 0) {
     return false;
   }
 
-  stored_send_times_[index] = clock_->TimeInMilliseconds();
+  slots_[index].send_time_ms = clock_->TimeInMilliseconds();
   return true;
 }
 
@@ -225,39 +216,62 @@ bool RTPPacketHistory::GetPacketAndSetSendTime(uint16_t sequence_number,
                                                int64_t* stored_time_ms) {
   CriticalSectionScoped cs(critsect_.get());
   assert(*packet_length >= max_packet_length_);
-  if (!store_) {
+  int index = 0;
+  if (!GetPacketIndexAndSetSendTime(sequence_number, min_elapsed_time_ms,
+                                    retransmit, &index)) {
     return false;
   }
+  GetPacket(index, packet, packet_length, stored_time_ms);
+  return true;
+}
 
-  int32_t index = 0;
-  bool found = FindSeqNum(sequence_number, &index);
-  if (!found) {
-    LOG(LS_WARNING) << "No match for getting seqNum " << sequence_number;
+bool RTPPacketHistory::GetPacketAndSetSendTime(
+    uint16_t sequence_number,
+    int64_t min_elapsed_time_ms,
+    bool retransmit,
+    rtc::scoped_refptr<StoredPacket>* packet,
+    int64_t* stored_time_ms) {
+  CriticalSectionScoped cs(critsect_.get());
+  int index = 0;
+  if (!GetPacketIndexAndSetSendTime(sequence_number, min_elapsed_time_ms,
+                                    retransmit, &index)) {
     return false;
   }
+  *packet = slots_[index].packet;
+  *stored_time_ms = slots_[index].stored_time_ms;
+  return true;
+}
 
-  size_t length = stored_lengths_.at(index);
-  assert(length <= max_packet_length_);
-  if (length == 0) {
-    LOG(LS_WARNING) << "No match for getting seqNum " << sequence_number
-                    << ", len " << length;
+bool RTPPacketHistory::GetPacketIndexAndSetSendTime(
+    uint16_t sequence_number,
+    int64_t min_elapsed_time_ms,
+    bool retransmit,
+    int* index) {
+  if (!store_) {
     return false;
   }
 
+  *index = FindSeqNum(sequence_number);
+  if (*index < 0) {
+    LOG(LS_WARNING) << "No match for getting seqNum " << sequence_number;
+    return false;
+  }
+  PacketSlot& slot = slots_[*index];
+  assert(slot.packet->length() <= max_packet_length_);
+
   // Verify elapsed time since last retrieve.
   int64_t now = clock_->TimeInMilliseconds();
   if (min_elapsed_time_ms > 0 &&
-      ((now - stored_send_times_.at(index)) < min_elapsed_time_ms)) {
+      ((now - slot.send_time_ms) < min_elapsed_time_ms)) {
     return false;
   }
 
-  if (retransmit && stored_types_.at(index) == kDontRetransmit) {
+  if (retransmit && slot.storage_type == kDontRetransmit) {
     // No bytes copied since this packet shouldn't be retransmitted or is
     // of zero size.
     return false;
   }
-  stored_send_times_[index] = clock_->TimeInMilliseconds();
-  GetPacket(index, packet, packet_length, stored_time_ms);
+  slot.send_time_ms = now;
   return true;
 }
 
@@ -265,14 +279,10 @@ void RTPPacketHistory::GetPacket(int index,
                                  uint8_t* packet,
                                  size_t* packet_length,
                                  int64_t* stored_time_ms) const {
-  // Get packet.
-  size_t length = stored_lengths_.at(index);
-  std::vector<std::vector<uint8_t> >::const_iterator it_found_packet =
-      stored_packets_.begin() + index;
-  std::copy(it_found_packet->begin(), it_found_packet->begin() + length,
-            packet);
-  *packet_length = length;
-  *stored_time_ms = stored_times_.at(index);
+  const PacketSlot& slot = slots_[index];
+  memcpy(packet, slot.packet->data(), slot.packet->length());
+  *packet_length = slot.packet->length();
+  *stored_time_ms = slot.stored_time_ms;
 }
 
 bool RTPPacketHistory::GetBestFittingPacket(uint8_t* packet,
@@ -288,56 +298,124 @@ bool RTPPacketHistory::GetBestFittingPacket(uint8_t* packet,
   return true;
 }
 
+bool RTPPacketHistory::GetBestFittingPacket(
+    size_t size,
+    rtc::scoped_refptr<StoredPacket>* packet,
+    int64_t* stored_time_ms) {
+  CriticalSectionScoped cs(critsect_.get());
+  if (!store_)
+    return false;
+  int index = FindBestFittingPacket(size);
+  if (index < 0)
+    return false;
+  *packet = slots_[index].packet;
+  *stored_time_ms = slots_[index].stored_time_ms;
+  return true;
+}
+
 // private, lock should already be taken
-bool RTPPacketHistory::FindSeqNum(uint16_t sequence_number,
-                                  int32_t* index) const {
-  uint16_t temp_sequence_number = 0;
-  if (prev_index_ > 0) {
-    *index = prev_index_ - 1;
-    temp_sequence_number = stored_seq_nums_[*index];
+int RTPPacketHistory::FindSeqNum(uint16_t sequence_number) const {
+  if (slots_.empty())
+    return -1;
+  size_t index = SlotIndex(sequence_number);
+  if (!slots_[index].packet ||
+      slots_[index].sequence_number != sequence_number) {
+    return -1;
+  }
+  return static_cast<int>(index);
+}
+
+int RTPPacketHistory::FindBestFittingPacket(size_t size) const {
+  if (size < kMinPacketRequestBytes || slots_.empty())
+    return -1;
+  const size_t bucket = SizeBucket(size);
+  // The closest packets are at the head of the nearest non-empty buckets on
+  // either side.
+  int best_index = -1;  // Returned unchanged if we don't find anything.
+  size_t min_diff = std::numeric_limits<size_t>::max();
+  int below = NonEmptyBucketBelow(bucket);
+  if (below >= 0) {
+    best_index = size_buckets_[below];
+    min_diff = size - std::min(size, slots_[best_index].packet->length());
+  }
+  int above = NonEmptyBucketAbove(bucket);
+  if (above >= 0) {
+    int index = size_buckets_[above];
+    size_t length = slots_[index].packet->length();
+    size_t diff = (length > size) ? (length - size) : (size - length);
+    if (diff < min_diff)
+      best_index = index;
+  }
+  return best_index;
+}
+
+size_t RTPPacketHistory::SizeBucket(size_t length) {
+  return std::min(length, kNumSizeBuckets - 1);
+}
+
+void RTPPacketHistory::AddToSizeBucket(int index) {
+  PacketSlot& slot = slots_[index];
+  const size_t bucket = SizeBucket(slot.packet->length());
+  slot.prev_in_bucket = -1;
+  slot.next_in_bucket = size_buckets_[bucket];
+  if (slot.next_in_bucket >= 0)
+    slots_[slot.next_in_bucket].prev_in_bucket = index;
+  size_buckets_[bucket] = index;
+  ++size_bucket_groups_[bucket / kSizeBucketGroupSize];
+}
+
+void RTPPacketHistory::RemoveFromSizeBucket(int index) {
+  PacketSlot& slot = slots_[index];
+  const size_t bucket = SizeBucket(slot.packet->length());
+  if (slot.prev_in_bucket >= 0) {
+    slots_[slot.prev_in_bucket].next_in_bucket = slot.next_in_bucket;
   } else {
-    *index = stored_seq_nums_.size() - 1;
-    temp_sequence_number = stored_seq_nums_[*index];  // wrap
+    assert(size_buckets_[bucket] == index);
+    size_buckets_[bucket] = slot.next_in_bucket;
   }
+  if (slot.next_in_bucket >= 0)
+    slots_[slot.next_in_bucket].prev_in_bucket = slot.prev_in_bucket;
+  slot.prev_in_bucket = -1;
+  slot.next_in_bucket = -1;
+  --size_bucket_groups_[bucket / kSizeBucketGroupSize];
+}
 
-  int32_t idx = (prev_index_ - 1) - (temp_sequence_number - sequence_number);
-  if (idx >= 0 && idx < static_cast<int>(stored_seq_nums_.size())) {
-    *index = idx;
-    temp_sequence_number = stored_seq_nums_[*index];
+void RTPPacketHistory::RebuildSizeBuckets() {
+  size_buckets_.assign(kNumSizeBuckets, -1);
+  size_bucket_groups_.assign(kNumSizeBucketGroups, 0);
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    if (slots_[i].packet)
+      AddToSizeBucket(static_cast<int>(i));
   }
+}
 
-  if (temp_sequence_number != sequence_number) {
-    // We did not found a match, search all.
-    for (uint16_t m = 0; m < stored_seq_nums_.size(); m++) {
-      if (stored_seq_nums_[m] == sequence_number) {
-        *index = m;
-        temp_sequence_number = stored_seq_nums_[*index];
-        break;
-      }
+int RTPPacketHistory::NonEmptyBucketAbove(size_t bucket) const {
+  size_t i = bucket;
+  while (i < kNumSizeBuckets) {
+    if (i % kSizeBucketGroupSize == 0 &&
+        size_bucket_groups_[i / kSizeBucketGroupSize] == 0) {
+      i += kSizeBucketGroupSize;
+      continue;
     }
+    if (size_buckets_[i] >= 0)
+      return static_cast<int>(i);
+    ++i;
   }
-  if (temp_sequence_number == sequence_number) {
-    // We found a match.
-    return true;
-  }
-  return false;
+  return -1;
 }
 
-int RTPPacketHistory::FindBestFittingPacket(size_t size) const {
-  if (size < kMinPacketRequestBytes || stored_lengths_.empty())
-    return -1;
-  size_t min_diff = std::numeric_limits<size_t>::max();
-  int best_index = -1;  // Returned unchanged if we don't find anything.
-  for (size_t i = 0; i < stored_lengths_.size(); ++i) {
-    if (stored_lengths_[i] == 0)
+int RTPPacketHistory::NonEmptyBucketBelow(size_t bucket) const {
+  int i = static_cast<int>(bucket);
+  while (i >= 0) {
+    if ((i + 1) % kSizeBucketGroupSize == 0 &&
+        size_bucket_groups_[i / kSizeBucketGroupSize] == 0) {
+      i -= kSizeBucketGroupSize;
       continue;
-    size_t diff = (stored_lengths_[i] > size) ?
-        (stored_lengths_[i] - size) : (size - stored_lengths_[i]);
-    if (diff < min_diff) {
-      min_diff = diff;
-      best_index = static_cast<int>(i);
     }
+    if (size_buckets_[i] >= 0)
+      return i;
+    --i;
   }
-  return best_index;
+  return -1;
 }
 }  // namespace webrtc
@@ -15,6 +15,9 @@
 
 #include <vector>
 
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/refcount.h"
+#include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
@@ -25,13 +28,32 @@ namespace webrtc {
 class Clock;
 class CriticalSectionWrapper;
 
-static const size_t kMaxHistoryCapacity = 9600;
+// Must be a power of two, at most half the sequence number space.
+static const size_t kMaxHistoryCapacity = 32768;
 
 class RTPPacketHistory {
  public:
+  // A stored RTP packet. References to stored packets are handed out so that
+  // packets can be resent without copying them out of the history. The history
+  // never modifies a packet while a reference to it is held elsewhere.
+  class StoredPacket : public rtc::RefCountInterface {
+   public:
+    const uint8_t* data() const { return data_.data(); }
+    size_t length() const { return data_.size(); }
+
+    virtual bool HasOneRef() const = 0;
+
+   private:
+    friend class RTPPacketHistory;
+    rtc::Buffer data_;
+  };
+
   RTPPacketHistory(Clock* clock);
   ~RTPPacketHistory();
 
+  // Enables or disables storage of at least |number_to_store| packets. The
+  // history grows on demand, up to kMaxHistoryCapacity packets, if packets
+  // which haven't been sent yet would otherwise be overwritten.
   void SetStorePacketsStatus(bool enable, uint16_t number_to_store);
 
   bool StorePackets() const;
@@ -61,41 +83,89 @@ class RTPPacketHistory {
                                size_t* packet_length,
                                int64_t* stored_time_ms);
 
+  // Same as above, but returns a reference to the stored packet in |packet|
+  // instead of copying it.
+  bool GetPacketAndSetSendTime(uint16_t sequence_number,
+                               int64_t min_elapsed_time_ms,
+                               bool retransmit,
+                               rtc::scoped_refptr<StoredPacket>* packet,
+                               int64_t* stored_time_ms);
+
   bool GetBestFittingPacket(uint8_t* packet, size_t* packet_length,
                             int64_t* stored_time_ms);
 
+  // Returns a reference to the stored packet with a length closest to |size|.
+  bool GetBestFittingPacket(size_t size,
+                            rtc::scoped_refptr<StoredPacket>* packet,
+                            int64_t* stored_time_ms);
+
   bool HasRTPPacket(uint16_t sequence_number) const;
 
   bool SetSent(uint16_t sequence_number);
 
  private:
+  struct PacketSlot {
+    PacketSlot();
+
+    // NULL if the slot is empty.
+    rtc::scoped_refptr<StoredPacket> packet;
+    uint16_t sequence_number;
+    int64_t stored_time_ms;
+    // Zero if the packet hasn't been sent yet.
+    int64_t send_time_ms;
+    StorageType storage_type;
+    // Neighbours in the list of stored packets in the same size bucket.
+    int prev_in_bucket;
+    int next_in_bucket;
+  };
+
+  void Allocate(size_t number_to_store) EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  void Free() EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  // Doubles the capacity, up to kMaxHistoryCapacity, keeping stored packets.
+  void Expand() EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  size_t SlotIndex(uint16_t sequence_number) const
+      EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  // Returns the index of the slot holding |sequence_number|, or -1.
+  int FindSeqNum(uint16_t sequence_number) const
+      EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  int FindBestFittingPacket(size_t size) const
+      EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  bool GetPacketIndexAndSetSendTime(uint16_t sequence_number,
+                                    int64_t min_elapsed_time_ms,
+                                    bool retransmit,
+                                    int* index)
+      EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
   void GetPacket(int index,
                  uint8_t* packet,
                  size_t* packet_length,
                  int64_t* stored_time_ms) const
       EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
-  void Allocate(size_t number_to_store) EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
-  void Free() EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
-  void VerifyAndAllocatePacketLength(size_t packet_length, uint32_t start_index)
-      EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
-  bool FindSeqNum(uint16_t sequence_number, int32_t* index) const
+
+  // Size bucket bookkeeping for FindBestFittingPacket().
+  static size_t SizeBucket(size_t length);
+  void AddToSizeBucket(int index) EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  void RemoveFromSizeBucket(int index) EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  void RebuildSizeBuckets() EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  // Returns the first non-empty bucket at or above/below |bucket|, or -1.
+  int NonEmptyBucketAbove(size_t bucket) const
       EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
-  int FindBestFittingPacket(size_t size) const
+  int NonEmptyBucketBelow(size_t bucket) const
       EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
 
- private:
   Clock* clock_;
   rtc::scoped_ptr<CriticalSectionWrapper> critsect_;
   bool store_ GUARDED_BY(critsect_);
-  uint32_t prev_index_ GUARDED_BY(critsect_);
   size_t max_packet_length_ GUARDED_BY(critsect_);
 
-  std::vector<std::vector<uint8_t> > stored_packets_ GUARDED_BY(critsect_);
-  std::vector<uint16_t> stored_seq_nums_ GUARDED_BY(critsect_);
-  std::vector<size_t> stored_lengths_ GUARDED_BY(critsect_);
-  std::vector<int64_t> stored_times_ GUARDED_BY(critsect_);
-  std::vector<int64_t> stored_send_times_ GUARDED_BY(critsect_);
-  std::vector<StorageType> stored_types_ GUARDED_BY(critsect_);
+  // Ring buffer indexed by the sequence number modulo its size, which is a
+  // power of two, giving O(1) lookups.
+  std::vector<PacketSlot> slots_ GUARDED_BY(critsect_);
+  // Most recently stored packet with a length in each bucket, or -1. Used to
+  // find best fitting packets for padding without scanning the history.
+  std::vector<int> size_buckets_ GUARDED_BY(critsect_);
+  // Number of stored packets per group of consecutive size buckets, allowing
+  // searches to skip over ranges of empty buckets.
+  std::vector<int> size_bucket_groups_ GUARDED_BY(critsect_);
 };
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_RTP_RTCP_RTP_PACKET_HISTORY_H_
@@ -0,0 +1,162 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the cost of a NACK storm against a deep packet history, as seen on
+// high-RTT, high-bitrate links: the history holds several seconds of packets
+// and large bursts of them are requested for retransmission, interleaved with
+// requests for padding packets and new packets being stored.
+
+#include <string.h>
+
+#include <sstream>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_history.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const size_t kMaxPacketLength = IP_PACKET_SIZE;
+const size_t kHeaderLength = 12;
+const uint32_t kSsrc = 12345678;
+const int kNackBurstSize = 500;
+const int kNumBursts = 20;
+const int kPacketsPerBurst = 200;
+
+void CreateRtpPacket(uint16_t seq_num, size_t length, uint8_t* packet) {
+  memset(packet, 0, length);
+  packet[0] = 0x80;
+  packet[1] = 96;
+  packet[2] = static_cast<uint8_t>(seq_num >> 8);
+  packet[3] = static_cast<uint8_t>(seq_num);
+  packet[8] = static_cast<uint8_t>(kSsrc >> 24);
+  packet[9] = static_cast<uint8_t>(kSsrc >> 16);
+  packet[10] = static_cast<uint8_t>(kSsrc >> 8);
+  packet[11] = static_cast<uint8_t>(kSsrc);
+  for (size_t i = kHeaderLength; i < length; ++i)
+    packet[i] = static_cast<uint8_t>(i);
+}
+
+// Deterministic spread of packet sizes, as produced by a video packetizer.
+size_t PacketLength(uint16_t seq_num) {
+  return 200 + (seq_num * 397) % (kMaxPacketLength - 200);
+}
+
+class NackStorm {
+ public:
+  NackStorm(size_t history_size, bool copy)
+      : clock_(1), history_(&clock_), history_size_(history_size),
+        copy_(copy), next_seq_num_(0) {
+    history_.SetStorePacketsStatus(true,
+                                   static_cast<uint16_t>(history_size));
+    // Fill the history, so the storm hits old packets as well as new ones.
+    for (size_t i = 0; i < history_size; ++i)
+      StoreAndSend();
+  }
+
+  // Returns the time it took to run the storm in microseconds, and the number
+  // of history operations in |num_operations|.
+  int64_t Run(int* num_operations) {
+    *num_operations = 0;
+    const TickTime start = TickTime::Now();
+    for (int burst = 0; burst < kNumBursts; ++burst) {
+      // Request a burst spread over the whole history, oldest first.
+      const int stride = static_cast<int>(history_size_ / kNackBurstSize);
+      uint16_t seq_num =
+          static_cast<uint16_t>(next_seq_num_ - history_size_ + burst);
+      for (int i = 0; i < kNackBurstSize; ++i) {
+        Resend(seq_num);
+        seq_num += stride;
+      }
+      // Padding requests of varying sizes, and new media.
+      for (int i = 0; i < kPacketsPerBurst; ++i) {
+        Pad(50 + (i * 131) % (kMaxPacketLength - 50));
+        StoreAndSend();
+      }
+      *num_operations += kNackBurstSize + 2 * kPacketsPerBurst;
+      clock_.AdvanceTimeMilliseconds(10);
+    }
+    return (TickTime::Now() - start).Microseconds();
+  }
+
+ private:
+  void StoreAndSend() {
+    const size_t length = PacketLength(next_seq_num_);
+    CreateRtpPacket(next_seq_num_, length, packet_);
+    EXPECT_EQ(0, history_.PutRTPPacket(packet_, length, kMaxPacketLength,
+                                       clock_.TimeInMilliseconds(),
+                                       kAllowRetransmission));
+    EXPECT_TRUE(history_.SetSent(next_seq_num_));
+    ++next_seq_num_;
+  }
+
+  void Resend(uint16_t seq_num) {
+    int64_t stored_time_ms;
+    if (copy_) {
+      size_t length = kMaxPacketLength;
+      EXPECT_TRUE(history_.GetPacketAndSetSendTime(seq_num, 0, true, packet_,
+                                                   &length, &stored_time_ms));
+    } else {
+      rtc::scoped_refptr<RTPPacketHistory::StoredPacket> packet;
+      EXPECT_TRUE(history_.GetPacketAndSetSendTime(seq_num, 0, true, &packet,
+                                                   &stored_time_ms));
+    }
+  }
+
+  void Pad(size_t size) {
+    int64_t stored_time_ms;
+    if (copy_) {
+      size_t length = size;
+      EXPECT_TRUE(history_.GetBestFittingPacket(packet_, &length,
+                                                &stored_time_ms));
+    } else {
+      rtc::scoped_refptr<RTPPacketHistory::StoredPacket> packet;
+      EXPECT_TRUE(history_.GetBestFittingPacket(size, &packet,
+                                                &stored_time_ms));
+    }
+  }
+
+  SimulatedClock clock_;
+  RTPPacketHistory history_;
+  const size_t history_size_;
+  const bool copy_;
+  uint16_t next_seq_num_;
+  uint8_t packet_[kMaxPacketLength];
+};
+
+void RunAndReport(size_t history_size, bool copy) {
+  NackStorm storm(history_size, copy);
+  int num_operations = 0;
+  // Warm up caches before measuring.
+  storm.Run(&num_operations);
+  const int64_t elapsed_us = storm.Run(&num_operations);
+  std::stringstream ss;
+  ss << history_size << "_packets" << (copy ? "_copy" : "_reference");
+  webrtc::test::PrintResult("rtp_packet_history_nack_storm", "", ss.str(),
+                            1000.0 * elapsed_us / num_operations, "ns/op",
+                            false);
+}
+
+}  // namespace
+
+TEST(RtpPacketHistoryPerfTest, NackStorm) {
+  // 600 packets is the default sender history size. At 10 Mbps, 4096 and
+  // 16384 packets hold roughly 3 and 13 seconds of media.
+  const size_t kHistorySizes[] = {600, 4096, 16384};
+  for (size_t history_size : kHistorySizes) {
+    RunAndReport(history_size, true);
+    RunAndReport(history_size, false);
+  }
+}
+
+}  // namespace webrtc
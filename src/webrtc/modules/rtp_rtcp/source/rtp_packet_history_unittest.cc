@@ -10,6 +10,8 @@
  * This file includes unit tests for the RTPPacketHistory.
  */
 
+#include <string.h>
+
 #include "testing/gtest/include/gtest/gtest.h"
 
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
@@ -271,4 +273,119 @@ TEST_F(RtpPacketHistoryTest, FullExpansion) {
   }
 }
 
+TEST_F(RtpPacketHistoryTest, GetPacketReference) {
+  hist_->SetStorePacketsStatus(true, 10);
+  size_t len = 0;
+  int64_t capture_time_ms = 1;
+  CreateRtpPacket(kSeqNum, kSsrc, kPayload, kTimestamp, packet_, &len);
+  EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, kMaxPacketLength,
+                                   capture_time_ms, kAllowRetransmission));
+
+  rtc::scoped_refptr<RTPPacketHistory::StoredPacket> packet;
+  int64_t time;
+  EXPECT_TRUE(hist_->GetPacketAndSetSendTime(kSeqNum, 0, false, &packet,
+                                             &time));
+  ASSERT_TRUE(packet.get() != NULL);
+  EXPECT_EQ(len, packet->length());
+  EXPECT_EQ(capture_time_ms, time);
+  EXPECT_EQ(0, memcmp(packet_, packet->data(), len));
+}
+
+TEST_F(RtpPacketHistoryTest, ReferencedPacketIsNotOverwritten) {
+  hist_->SetStorePacketsStatus(true, 16);
+  size_t len = 0;
+  int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  CreateRtpPacket(kSeqNum, kSsrc, kPayload, kTimestamp, packet_, &len);
+  EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, kMaxPacketLength,
+                                   capture_time_ms, kAllowRetransmission));
+  rtc::scoped_refptr<RTPPacketHistory::StoredPacket> packet;
+  int64_t time;
+  EXPECT_TRUE(hist_->GetPacketAndSetSendTime(kSeqNum, 0, false, &packet,
+                                             &time));
+
+  // Wrap around the history, replacing the packet while it's referenced.
+  for (int i = 1; i <= 16; ++i) {
+    len = 0;
+    CreateRtpPacket(kSeqNum + i, kSsrc, kPayload, kTimestamp + i, packet_,
+                    &len);
+    EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, kMaxPacketLength,
+                                     capture_time_ms, kAllowRetransmission));
+    EXPECT_TRUE(hist_->SetSent(kSeqNum + i));
+  }
+  EXPECT_FALSE(hist_->HasRTPPacket(kSeqNum));
+  EXPECT_TRUE(hist_->HasRTPPacket(kSeqNum + 16));
+
+  // The referenced packet is intact.
+  len = 0;
+  CreateRtpPacket(kSeqNum, kSsrc, kPayload, kTimestamp, packet_, &len);
+  ASSERT_EQ(len, packet->length());
+  EXPECT_EQ(0, memcmp(packet_, packet->data(), len));
+}
+
+TEST_F(RtpPacketHistoryTest, SequenceNumberWrap) {
+  hist_->SetStorePacketsStatus(true, 100);
+  size_t len;
+  int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  const uint16_t kFirstSeqNum = 0xFFFF - 50;
+  for (int i = 0; i < 100; ++i) {
+    len = 0;
+    CreateRtpPacket(kFirstSeqNum + i, kSsrc, kPayload, kTimestamp, packet_,
+                    &len);
+    EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, kMaxPacketLength,
+                                     capture_time_ms, kAllowRetransmission));
+  }
+  for (int i = 0; i < 100; ++i) {
+    len = kMaxPacketLength;
+    int64_t time;
+    EXPECT_TRUE(hist_->GetPacketAndSetSendTime(
+        static_cast<uint16_t>(kFirstSeqNum + i), 0, false, packet_out_, &len,
+        &time));
+    EXPECT_EQ(static_cast<uint16_t>(kFirstSeqNum + i),
+              (packet_out_[2] << 8) + packet_out_[3]);
+  }
+  EXPECT_FALSE(hist_->HasRTPPacket(kFirstSeqNum - 1));
+  EXPECT_FALSE(hist_->HasRTPPacket(static_cast<uint16_t>(kFirstSeqNum + 100)));
+}
+
+TEST_F(RtpPacketHistoryTest, GetBestFittingPacket) {
+  hist_->SetStorePacketsStatus(true, 10);
+  int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  const size_t kLengths[] = {100, 300, 700};
+  for (size_t i = 0; i < 3; ++i) {
+    size_t len = 0;
+    CreateRtpPacket(kSeqNum + i, kSsrc, kPayload, kTimestamp, packet_, &len);
+    EXPECT_EQ(0, hist_->PutRTPPacket(packet_, kLengths[i], kMaxPacketLength,
+                                     capture_time_ms, kAllowRetransmission));
+  }
+
+  rtc::scoped_refptr<RTPPacketHistory::StoredPacket> packet;
+  int64_t time;
+  // Too small requests aren't served.
+  EXPECT_FALSE(hist_->GetBestFittingPacket(40, &packet, &time));
+  ASSERT_TRUE(hist_->GetBestFittingPacket(290, &packet, &time));
+  EXPECT_EQ(300u, packet->length());
+  ASSERT_TRUE(hist_->GetBestFittingPacket(650, &packet, &time));
+  EXPECT_EQ(700u, packet->length());
+  ASSERT_TRUE(hist_->GetBestFittingPacket(1400, &packet, &time));
+  EXPECT_EQ(700u, packet->length());
+  ASSERT_TRUE(hist_->GetBestFittingPacket(60, &packet, &time));
+  EXPECT_EQ(100u, packet->length());
+
+  size_t len = 480;
+  EXPECT_TRUE(hist_->GetBestFittingPacket(packet_out_, &len, &time));
+  EXPECT_EQ(300u, len);
+  EXPECT_EQ(kSeqNum + 1, (packet_out_[2] << 8) + packet_out_[3]);
+
+  // Replacing the 300 byte packet removes it from the candidates.
+  hist_->SetStorePacketsStatus(true, 2);
+  len = 0;
+  CreateRtpPacket(kSeqNum, kSsrc, kPayload, kTimestamp, packet_, &len);
+  EXPECT_EQ(0, hist_->PutRTPPacket(packet_, 300, kMaxPacketLength,
+                                   capture_time_ms, kAllowRetransmission));
+  EXPECT_EQ(0, hist_->PutRTPPacket(packet_, 900, kMaxPacketLength,
+                                   capture_time_ms, kAllowRetransmission));
+  ASSERT_TRUE(hist_->GetBestFittingPacket(300, &packet, &time));
+  EXPECT_EQ(900u, packet->length());
+}
+
 }  // namespace webrtc
@@ -565,18 +565,20 @@ size_t RTPSender::TrySendRedundantPayloads(size_t bytes_to_send) {
       return 0;
   }
 
-  uint8_t buffer[IP_PACKET_SIZE];
   int bytes_left = static_cast<int>(bytes_to_send);
   while (bytes_left > 0) {
-    size_t length = bytes_left;
+    rtc::scoped_refptr<RTPPacketHistory::StoredPacket> packet;
     int64_t capture_time_ms;
-    if (!packet_history_.GetBestFittingPacket(buffer, &length,
+    if (!packet_history_.GetBestFittingPacket(bytes_left, &packet,
                                               &capture_time_ms)) {
       break;
     }
-    if (!PrepareAndSendPacket(buffer, length, capture_time_ms, true, false))
+    const size_t length = packet->length();
+    if (!PrepareAndSendPacket(packet->data(), length, capture_time_ms, true,
+                              false)) {
       break;
-    RtpUtility::RtpHeaderParser rtp_parser(buffer, length);
+    }
+    RtpUtility::RtpHeaderParser rtp_parser(packet->data(), length);
     RTPHeader rtp_header;
     rtp_parser.Parse(rtp_header);
     bytes_left -= static_cast<int>(length - rtp_header.headerLength);
@@ -696,18 +698,19 @@ bool RTPSender::StorePackets() const {
 }
 
 int32_t RTPSender::ReSendPacket(uint16_t packet_id, int64_t min_resend_time) {
-  size_t length = IP_PACKET_SIZE;
-  uint8_t data_buffer[IP_PACKET_SIZE];
+  // Hold a reference to the stored packet rather than copying it, since with
+  // pacing only the header is needed here.
+  rtc::scoped_refptr<RTPPacketHistory::StoredPacket> packet;
   int64_t capture_time_ms;
   if (!packet_history_.GetPacketAndSetSendTime(packet_id, min_resend_time, true,
-                                               data_buffer, &length,
-                                               &capture_time_ms)) {
+                                               &packet, &capture_time_ms)) {
     // Packet not found.
     return 0;
   }
+  const size_t length = packet->length();
 
   if (paced_sender_) {
-    RtpUtility::RtpHeaderParser rtp_parser(data_buffer, length);
+    RtpUtility::RtpHeaderParser rtp_parser(packet->data(), length);
     RTPHeader header;
     if (!rtp_parser.Parse(header)) {
       assert(false);
@@ -729,7 +732,7 @@ int32_t RTPSender::ReSendPacket(uint16_t packet_id, int64_t min_resend_time) {
     CriticalSectionScoped lock(send_critsect_.get());
     rtx = rtx_;
   }
-  return PrepareAndSendPacket(data_buffer, length, capture_time_ms,
+  return PrepareAndSendPacket(packet->data(), length, capture_time_ms,
                               (rtx & kRtxRetransmitted) > 0, true) ?
       static_cast<int32_t>(length) : -1;
 }
@@ -858,15 +861,13 @@ void RTPSender::UpdateNACKBitRate(uint32_t bytes, int64_t now) {
 bool RTPSender::TimeToSendPacket(uint16_t sequence_number,
                                  int64_t capture_time_ms,
                                  bool retransmission) {
-  size_t length = IP_PACKET_SIZE;
-  uint8_t data_buffer[IP_PACKET_SIZE];
+  rtc::scoped_refptr<RTPPacketHistory::StoredPacket> packet;
   int64_t stored_time_ms;
 
   if (!packet_history_.GetPacketAndSetSendTime(sequence_number,
                                                0,
                                                retransmission,
-                                               data_buffer,
-                                               &length,
+                                               &packet,
                                                &stored_time_ms)) {
     // Packet cannot be found. Allow sending to continue.
     return true;
@@ -879,20 +880,18 @@ bool RTPSender::TimeToSendPacket(uint16_t sequence_number,
     CriticalSectionScoped lock(send_critsect_.get());
     rtx = rtx_;
   }
-  return PrepareAndSendPacket(data_buffer,
-                              length,
+  return PrepareAndSendPacket(packet->data(),
+                              packet->length(),
                               capture_time_ms,
                               retransmission && (rtx & kRtxRetransmitted) > 0,
                               retransmission);
 }
 
-bool RTPSender::PrepareAndSendPacket(uint8_t* buffer,
+bool RTPSender::PrepareAndSendPacket(const uint8_t* buffer,
                                      size_t length,
                                      int64_t capture_time_ms,
                                      bool send_over_rtx,
                                      bool is_retransmit) {
-  uint8_t *buffer_to_send_ptr = buffer;
-
   RtpUtility::RtpHeaderParser rtp_parser(buffer, length);
   RTPHeader rtp_header;
   rtp_parser.Parse(rtp_header);
@@ -905,23 +904,25 @@ bool RTPSender::PrepareAndSendPacket(uint8_t* buffer,
       TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"), "PrepareAndSendPacket",
       "timestamp", rtp_header.timestamp, "seqnum", rtp_header.sequenceNumber);
 
-  uint8_t data_buffer_rtx[IP_PACKET_SIZE];
+  uint8_t data_buffer[IP_PACKET_SIZE];
   if (send_over_rtx) {
-    BuildRtxPacket(buffer, &length, data_buffer_rtx);
-    buffer_to_send_ptr = data_buffer_rtx;
+    BuildRtxPacket(buffer, &length, data_buffer);
+  } else {
+    assert(length <= sizeof(data_buffer));
+    memcpy(data_buffer, buffer, length);
   }
 
   int64_t now_ms = clock_->TimeInMilliseconds();
   int64_t diff_ms = now_ms - capture_time_ms;
-  UpdateTransmissionTimeOffset(buffer_to_send_ptr, length, rtp_header,
+  UpdateTransmissionTimeOffset(data_buffer, length, rtp_header,
                                diff_ms);
-  UpdateAbsoluteSendTime(buffer_to_send_ptr, length, rtp_header, now_ms);
-  bool ret = SendPacketToNetwork(buffer_to_send_ptr, length);
+  UpdateAbsoluteSendTime(data_buffer, length, rtp_header, now_ms);
+  bool ret = SendPacketToNetwork(data_buffer, length);
   if (ret) {
     CriticalSectionScoped lock(send_critsect_.get());
     media_has_been_sent_ = true;
   }
-  UpdateRtpStats(buffer_to_send_ptr, length, rtp_header, send_over_rtx,
+  UpdateRtpStats(data_buffer, length, rtp_header, send_over_rtx,
                  is_retransmit);
   return ret;
 }
@@ -1795,13 +1796,12 @@ int32_t RTPSender::SetFecParameters(
   return 0;
 }
 
-void RTPSender::BuildRtxPacket(uint8_t* buffer, size_t* length,
+void RTPSender::BuildRtxPacket(const uint8_t* buffer, size_t* length,
                                uint8_t* buffer_rtx) {
   CriticalSectionScoped cs(send_critsect_.get());
   uint8_t* data_buffer_rtx = buffer_rtx;
   // Add RTX header.
-  RtpUtility::RtpHeaderParser rtp_parser(
-      reinterpret_cast<const uint8_t*>(buffer), *length);
+  RtpUtility::RtpHeaderParser rtp_parser(buffer, *length);
 
   RTPHeader rtp_header;
   rtp_parser.Parse(rtp_header);
@@ -314,7 +314,10 @@ class RTPSender : public RTPSenderInterface {
 
   void UpdateNACKBitRate(uint32_t bytes, int64_t now);
 
-  bool PrepareAndSendPacket(uint8_t* buffer,
+  // Sends a copy of |buffer|, over RTX if |send_over_rtx| is set, with the
+  // header extensions updated. |buffer| itself is left untouched, so it can
+  // be a packet referenced from the packet history.
+  bool PrepareAndSendPacket(const uint8_t* buffer,
                             size_t length,
                             int64_t capture_time_ms,
                             bool send_over_rtx,
@@ -327,7 +330,7 @@ class RTPSender : public RTPSenderInterface {
 
   size_t BuildPaddingPacket(uint8_t* packet, size_t header_length);
 
-  void BuildRtxPacket(uint8_t* buffer, size_t* length,
+  void BuildRtxPacket(const uint8_t* buffer, size_t* length,
                       uint8_t* buffer_rtx);
 
   bool SendPacketToNetwork(const uint8_t *packet, size_t size);
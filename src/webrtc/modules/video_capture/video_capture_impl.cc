@@ -258,8 +258,6 @@ int32_t VideoCaptureImpl::IncomingFrame(
             return -1;
         }
 
-        int stride_y = width;
-        int stride_uv = (width + 1) / 2;
         int target_width = width;
         int target_height = height;
 
@@ -275,25 +273,25 @@ int32_t VideoCaptureImpl::IncomingFrame(
           }
         }
 
-        // TODO(mikhal): Update correct aligned stride values.
-        //Calc16ByteAlignedStride(target_width, &stride_y, &stride_uv);
         // Setting absolute height (in case it was negative).
         // In Windows, the image starts bottom left, instead of top left.
         // Setting a negative source height, inverts the image (within LibYuv).
-        int ret = _captureFrame.CreateEmptyFrame(target_width,
-                                                 abs(target_height),
-                                                 stride_y,
-                                                 stride_uv, stride_uv);
-        if (ret < 0)
+        if (target_width <= 0 || target_height == 0)
         {
             LOG(LS_ERROR) << "Failed to create empty frame, this should only "
                              "happen due to bad parameters.";
             return -1;
         }
+        // The buffer comes from a pool and is shared, not copied, by everyone
+        // downstream; it returns to the pool when the last of them is done.
+        // The frame must hold the only reference while it is written to.
+        I420VideoFrame capture_frame(
+            _bufferPool.CreateBuffer(target_width, abs(target_height)), 0, 0,
+            kVideoRotation_0);
         const int conversionResult = ConvertToI420(
             commonVideoType, videoFrame, 0, 0,  // No cropping
             width, height, videoFrameLength,
-            apply_rotation ? _rotateFrame : kVideoRotation_0, &_captureFrame);
+            apply_rotation ? _rotateFrame : kVideoRotation_0, &capture_frame);
         if (conversionResult < 0)
         {
           LOG(LS_ERROR) << "Failed to convert capture frame from type "
@@ -302,14 +300,14 @@ int32_t VideoCaptureImpl::IncomingFrame(
         }
 
         if (!apply_rotation) {
-          _captureFrame.set_rotation(_rotateFrame);
+          capture_frame.set_rotation(_rotateFrame);
         } else {
-          _captureFrame.set_rotation(kVideoRotation_0);
+          capture_frame.set_rotation(kVideoRotation_0);
         }
-        _captureFrame.set_ntp_time_ms(captureTime);
-        _captureFrame.set_render_time_ms(TickTime::MillisecondTimestamp());
+        capture_frame.set_ntp_time_ms(captureTime);
+        capture_frame.set_render_time_ms(TickTime::MillisecondTimestamp());
 
-        DeliverCapturedFrame(_captureFrame);
+        DeliverCapturedFrame(capture_frame);
     }
     else // Encoded format
     {
@@ -15,6 +15,7 @@
  * video_capture_impl.h
  */
 
+#include "webrtc/common_video/interface/i420_buffer_pool.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/common_video/rotation.h"
 #include "webrtc/modules/video_capture/include/video_capture.h"
@@ -132,7 +133,7 @@ private:
     VideoRotation _rotateFrame;  // Set if the frame should be rotated by the
                                  // capture module.
 
-    I420VideoFrame _captureFrame;
+    I420BufferPool _bufferPool;
 
     // Indicate whether rotation should be applied before delivered externally.
     bool apply_rotation_;
@@ -54,6 +54,18 @@ bool LessForBitRate(const FrameStatistic& s1, const FrameStatistic& s2) {
     return s1.bit_rate_in_kbps < s2.bit_rate_in_kbps;
 }
 
+// Returns the element of |values| at the given percentile, using the nearest
+// rank method, or -1 if |values| is empty. Reorders |values|.
+static int Percentile(int percentile, std::vector<int>* values) {
+  if (values->empty())
+    return -1;
+  assert(percentile >= 0 && percentile <= 100);
+  size_t rank = (values->size() * percentile + 99) / 100;
+  size_t index = rank > 0 ? rank - 1 : 0;
+  std::nth_element(values->begin(), values->begin() + index, values->end());
+  return (*values)[index];
+}
+
 FrameStatistic& Stats::NewFrame(int frame_number) {
   assert(frame_number >= 0);
   FrameStatistic stat;
@@ -186,5 +198,23 @@ void Stats::PrintSummary() {
          (total_encoding_time_in_us + total_decoding_time_in_us) / 1000);
 }
 
+int Stats::EncodeTimePercentileInUs(int percentile) const {
+  std::vector<int> times;
+  for (const FrameStatistic& stat : stats_) {
+    if (stat.encoding_successful)
+      times.push_back(stat.encode_time_in_us);
+  }
+  return Percentile(percentile, &times);
+}
+
+int Stats::DecodeTimePercentileInUs(int percentile) const {
+  std::vector<int> times;
+  for (const FrameStatistic& stat : stats_) {
+    if (stat.decoding_successful)
+      times.push_back(stat.decode_time_in_us);
+  }
+  return Percentile(percentile, &times);
+}
+
 }  // namespace test
 }  // namespace webrtc
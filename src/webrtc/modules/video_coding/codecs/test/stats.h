@@ -61,6 +61,12 @@ class Stats {
   // processing
   void PrintSummary();
 
+  // Returns the time it took to encode, respectively decode, the frame at the
+  // given |percentile| (0-100) when the frames are ordered by that time, or -1
+  // if no frames were encoded (decoded) successfully.
+  int EncodeTimePercentileInUs(int percentile) const;
+  int DecodeTimePercentileInUs(int percentile) const;
+
   std::vector<FrameStatistic> stats_;
 };
 
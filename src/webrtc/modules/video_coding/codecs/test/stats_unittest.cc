@@ -60,5 +60,28 @@ TEST_F(StatsTest, AddMany) {
   stats_->PrintSummary();  // should not crash
 }
 
+TEST_F(StatsTest, TimePercentiles) {
+  EXPECT_EQ(-1, stats_->EncodeTimePercentileInUs(50));
+  EXPECT_EQ(-1, stats_->DecodeTimePercentileInUs(50));
+  // Frame i takes 100 - i us to encode and 1000 + i us to decode.
+  for (int i = 0; i < 100; ++i) {
+    FrameStatistic& frame_stat = stats_->NewFrame(i);
+    frame_stat.encoding_successful = true;
+    frame_stat.encode_time_in_us = 100 - i;
+    // The last frame can't be decoded and doesn't count.
+    frame_stat.decoding_successful = i < 99;
+    frame_stat.decode_time_in_us = 1000 + i;
+  }
+  EXPECT_EQ(1, stats_->EncodeTimePercentileInUs(0));
+  EXPECT_EQ(50, stats_->EncodeTimePercentileInUs(50));
+  EXPECT_EQ(95, stats_->EncodeTimePercentileInUs(95));
+  EXPECT_EQ(99, stats_->EncodeTimePercentileInUs(99));
+  EXPECT_EQ(100, stats_->EncodeTimePercentileInUs(100));
+  EXPECT_EQ(1000, stats_->DecodeTimePercentileInUs(0));
+  EXPECT_EQ(1049, stats_->DecodeTimePercentileInUs(50));
+  EXPECT_EQ(1098, stats_->DecodeTimePercentileInUs(99));
+  EXPECT_EQ(1098, stats_->DecodeTimePercentileInUs(100));
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -32,6 +32,7 @@ TestConfig::TestConfig()
       exclude_frame_types(kExcludeOnlyFirstKeyFrame),
       frame_length_in_bytes(0),
       use_single_core(false),
+      number_of_cores(0),
       keyframe_interval(0),
       codec_settings(NULL),
       verbose(true) {}
@@ -105,7 +106,8 @@ bool VideoProcessorImpl::Init() {
   // Init the encoder and decoder
   uint32_t nbr_of_cores = 1;
   if (!config_.use_single_core) {
-    nbr_of_cores = CpuInfo::DetectNumberOfCores();
+    nbr_of_cores = config_.number_of_cores > 0 ?
+        config_.number_of_cores : CpuInfo::DetectNumberOfCores();
   }
   int32_t init_result =
       encoder_->InitEncode(config_.codec_settings, nbr_of_cores,
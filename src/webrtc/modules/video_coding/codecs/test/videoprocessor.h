@@ -87,6 +87,11 @@ struct TestConfig {
   // Default: false.
   bool use_single_core;
 
+  // If >0 and |use_single_core| is false, the number of cores the encoder and
+  // decoder are told they may use, instead of the number of available cores.
+  // Default: 0.
+  int number_of_cores;
+
   // If set to a value >0 this setting forces the encoder to create a keyframe
   // every Nth frame. Note that the encoder may create a keyframe in other
   // locations in addition to the interval that is set using this parameter.
@@ -0,0 +1,283 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Benchmarks the encoders and decoders offline: each clip is encoded and
+// decoded as fast as possible for every combination of codec, resolution,
+// bitrate and number of cores, and the per-frame latency percentiles, the
+// frame rates, the CPU time and the quality are reported. The clips are
+// foreman_cif scaled up to the tested resolutions, or a clip given with
+// --clip.
+
+#if defined(WEBRTC_POSIX)
+#include <sys/resource.h>
+#endif
+#include <stdio.h>
+
+#include <sstream>
+#include <string>
+
+#include "gflags/gflags.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_video/libyuv/include/scaler.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/video_coding/codecs/test/packet_manipulator.h"
+#include "webrtc/modules/video_coding/codecs/test/videoprocessor.h"
+#include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/modules/video_coding/codecs/vp9/include/vp9.h"
+#include "webrtc/modules/video_coding/main/interface/video_coding.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/frame_reader.h"
+#include "webrtc/test/testsupport/frame_writer.h"
+#include "webrtc/test/testsupport/metrics/video_metrics.h"
+#include "webrtc/test/testsupport/packet_reader.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+DEFINE_string(clip, "",
+              "I420 clip to benchmark instead of the scaled foreman_cif clips. "
+              "Requires --clip_width and --clip_height.");
+DEFINE_int32(clip_width, 0, "Width of the --clip.");
+DEFINE_int32(clip_height, 0, "Height of the --clip.");
+DEFINE_int32(clip_bitrate, 1000, "Lowest bitrate in kbps for the --clip.");
+DEFINE_int32(num_frames, 60, "Number of frames to process of each clip.");
+
+namespace webrtc {
+namespace test {
+namespace {
+
+const int kCifWidth = 352;
+const int kCifHeight = 288;
+const int kFrameRate = 30;
+const int kPercentiles[] = {50, 95, 99};
+// Numbers of cores the codecs are told they may use.
+const int kNumCores[] = {1, 2, 4, 8, 16};
+// Each resolution is run at its bitrate and at twice that.
+const int kBitrateFactors[] = {1, 2};
+
+struct Codec {
+  const char* name;
+  VideoCodecType type;
+};
+
+const Codec kCodecs[] = {
+  {"vp8", kVideoCodecVP8},
+  {"vp9", kVideoCodecVP9},
+};
+
+struct Resolution {
+  const char* name;
+  int width;
+  int height;
+  int bitrate_kbps;
+};
+
+const Resolution kResolutions[] = {
+  {"360p", 640, 360, 500},
+  {"720p", 1280, 720, 1000},
+  {"1080p", 1920, 1080, 2000},
+};
+
+int64_t GetCpuTimeUs() {
+#if defined(WEBRTC_POSIX)
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru) == 0) {
+    return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000LL +
+           ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+  }
+#endif
+  return 0;
+}
+
+// Writes the first |num_frames| frames of foreman_cif, scaled to
+// |width|x|height|, to a new file and returns its name.
+std::string CreateScaledClip(int width, int height, int num_frames) {
+  const size_t cif_length = CalcBufferSize(kI420, kCifWidth, kCifHeight);
+  const size_t scaled_length = CalcBufferSize(kI420, width, height);
+  FrameReaderImpl frame_reader(ResourcePath("foreman_cif", "yuv"), cif_length);
+  const std::string filename =
+      TempFilename(OutputPath(), "videoprocessor_perftest_input");
+  FrameWriterImpl frame_writer(filename, scaled_length);
+  EXPECT_TRUE(frame_reader.Init());
+  EXPECT_TRUE(frame_writer.Init());
+
+  Scaler scaler;
+  EXPECT_EQ(0, scaler.Set(kCifWidth, kCifHeight, width, height, kI420, kI420,
+                          kScaleBilinear));
+  rtc::scoped_ptr<uint8_t[]> cif_buffer(new uint8_t[cif_length]);
+  rtc::scoped_ptr<uint8_t[]> scaled_buffer(new uint8_t[scaled_length]);
+  I420VideoFrame cif_frame;
+  I420VideoFrame scaled_frame;
+  for (int i = 0; i < num_frames && frame_reader.ReadFrame(cif_buffer.get());
+       ++i) {
+    cif_frame.CreateFrame(cif_buffer.get(), kCifWidth, kCifHeight,
+                          kVideoRotation_0);
+    EXPECT_EQ(0, scaler.Scale(cif_frame, &scaled_frame));
+    ExtractBuffer(scaled_frame, scaled_length, scaled_buffer.get());
+    frame_writer.WriteFrame(scaled_buffer.get());
+  }
+  frame_reader.Close();
+  frame_writer.Close();
+  return filename;
+}
+
+VideoEncoder* CreateEncoder(VideoCodecType type) {
+  if (type == kVideoCodecVP8)
+    return VP8Encoder::Create();
+  return VP9Encoder::Create();
+}
+
+VideoDecoder* CreateDecoder(VideoCodecType type) {
+  if (type == kVideoCodecVP8)
+    return VP8Decoder::Create();
+  return VP9Decoder::Create();
+}
+
+// Encodes and decodes up to --num_frames frames of |input_filename| with
+// |codec| at |bitrate_kbps|, telling the codec it may use |number_of_cores|
+// cores, and prints the results.
+void RunCodec(const Codec& codec,
+              const Resolution& resolution,
+              const std::string& input_filename,
+              int bitrate_kbps,
+              int number_of_cores) {
+  VideoCodec codec_settings;
+  VideoCodingModule::Codec(codec.type, &codec_settings);
+  codec_settings.width = resolution.width;
+  codec_settings.height = resolution.height;
+  codec_settings.startBitrate = bitrate_kbps;
+  codec_settings.maxBitrate = 2 * bitrate_kbps;
+  codec_settings.maxFramerate = kFrameRate;
+
+  TestConfig config;
+  config.input_filename = input_filename;
+  config.output_filename =
+      TempFilename(OutputPath(), "videoprocessor_perftest_output");
+  config.frame_length_in_bytes =
+      CalcBufferSize(kI420, resolution.width, resolution.height);
+  config.number_of_cores = number_of_cores;
+  config.codec_settings = &codec_settings;
+  config.verbose = false;
+
+  rtc::scoped_ptr<VideoEncoder> encoder(CreateEncoder(codec.type));
+  rtc::scoped_ptr<VideoDecoder> decoder(CreateDecoder(codec.type));
+  FrameReaderImpl frame_reader(config.input_filename,
+                               config.frame_length_in_bytes);
+  FrameWriterImpl frame_writer(config.output_filename,
+                               config.frame_length_in_bytes);
+  ASSERT_TRUE(frame_reader.Init());
+  ASSERT_TRUE(frame_writer.Init());
+  PacketReader packet_reader;
+  PacketManipulatorImpl packet_manipulator(&packet_reader,
+                                           config.networking_config, false);
+  Stats stats;
+  rtc::scoped_ptr<VideoProcessor> processor(new VideoProcessorImpl(
+      encoder.get(), decoder.get(), &frame_reader, &frame_writer,
+      &packet_manipulator, config, &stats));
+  ASSERT_TRUE(processor->Init());
+  processor->SetRates(bitrate_kbps, kFrameRate);
+
+  const int64_t start_cpu_time_us = GetCpuTimeUs();
+  const int64_t start_time_ms = TickTime::MillisecondTimestamp();
+  int frame_number = 0;
+  while (frame_number < FLAGS_num_frames &&
+         processor->ProcessFrame(frame_number)) {
+    ++frame_number;
+  }
+  const int64_t elapsed_ms = TickTime::MillisecondTimestamp() - start_time_ms;
+  const int64_t cpu_time_us = GetCpuTimeUs() - start_cpu_time_us;
+  frame_reader.Close();
+  frame_writer.Close();
+  ASSERT_GT(frame_number, 0);
+
+  int64_t total_encode_time_us = 0;
+  int64_t total_decode_time_us = 0;
+  int num_decoded_frames = 0;
+  for (const FrameStatistic& stat : stats.stats_) {
+    total_encode_time_us += stat.encode_time_in_us;
+    if (stat.decoding_successful) {
+      total_decode_time_us += stat.decode_time_in_us;
+      ++num_decoded_frames;
+    }
+  }
+  QualityMetricsResult psnr;
+  EXPECT_EQ(0, I420PSNRFromFiles(config.input_filename.c_str(),
+                                 config.output_filename.c_str(),
+                                 resolution.width, resolution.height, &psnr));
+  remove(config.output_filename.c_str());
+
+  std::stringstream trace;
+  trace << resolution.name << "_" << bitrate_kbps << "kbps_" << number_of_cores
+        << "_cores";
+  const std::string name = codec.name;
+  for (int percentile : kPercentiles) {
+    std::stringstream modifier;
+    modifier << "_p" << percentile;
+    PrintResult(name + "_encode_time", modifier.str(), trace.str(),
+                stats.EncodeTimePercentileInUs(percentile), "us", false);
+    PrintResult(name + "_decode_time", modifier.str(), trace.str(),
+                stats.DecodeTimePercentileInUs(percentile), "us", false);
+  }
+  if (total_encode_time_us > 0) {
+    PrintResult(name + "_encode_rate", "", trace.str(),
+                1000000.0 * stats.stats_.size() / total_encode_time_us, "fps",
+                false);
+  }
+  if (total_decode_time_us > 0) {
+    PrintResult(name + "_decode_rate", "", trace.str(),
+                1000000.0 * num_decoded_frames / total_decode_time_us, "fps",
+                false);
+  }
+  if (elapsed_ms > 0) {
+    PrintResult(name + "_throughput", "", trace.str(),
+                1000.0 * frame_number / elapsed_ms, "fps", false);
+  }
+  PrintResult(name + "_cpu_time", "", trace.str(),
+              cpu_time_us / 1000.0 / frame_number, "ms/frame", false);
+  PrintResult(name + "_psnr", "", trace.str(), psnr.average, "dB", false);
+}
+
+// Runs every codec on |input_filename| for each bitrate and number of cores.
+void RunMatrix(const Resolution& resolution,
+               const std::string& input_filename) {
+  for (const Codec& codec : kCodecs) {
+    for (int bitrate_factor : kBitrateFactors) {
+      for (int number_of_cores : kNumCores) {
+        RunCodec(codec, resolution, input_filename,
+                 bitrate_factor * resolution.bitrate_kbps, number_of_cores);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(VideoProcessorPerfTest, EncodeDecodeThroughput) {
+  if (!FLAGS_clip.empty()) {
+    ASSERT_GT(FLAGS_clip_width, 0);
+    ASSERT_GT(FLAGS_clip_height, 0);
+    std::stringstream name;
+    name << FLAGS_clip_width << "x" << FLAGS_clip_height;
+    const std::string name_str = name.str();
+    const Resolution resolution = {name_str.c_str(), FLAGS_clip_width,
+                                   FLAGS_clip_height, FLAGS_clip_bitrate};
+    RunMatrix(resolution, FLAGS_clip);
+    return;
+  }
+  for (const Resolution& resolution : kResolutions) {
+    const std::string input_filename =
+        CreateScaledClip(resolution.width, resolution.height, FLAGS_num_frames);
+    RunMatrix(resolution, input_filename);
+    remove(input_filename.c_str());
+  }
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -12,11 +12,9 @@
 
 #include <algorithm>
 
-// NOTE(ajm): Path provided by gyp.
-#include "libyuv/scale.h"  // NOLINT
-
 #include "webrtc/common.h"
 #include "webrtc/modules/video_coding/codecs/vp8/screenshare_layers.h"
+#include "webrtc/system_wrappers/interface/worker_pool.h"
 
 namespace {
 
@@ -139,12 +137,15 @@ class AdapterEncodedImageCallback : public webrtc::EncodedImageCallback {
 namespace webrtc {
 
 SimulcastEncoderAdapter::SimulcastEncoderAdapter(VideoEncoderFactory* factory)
-    : factory_(factory), encoded_complete_callback_(NULL) {
+    : factory_(factory),
+      pyramid_scaler_(WorkerPool::GetSharedPool()),
+      encoded_complete_callback_(NULL) {
   memset(&codec_, 0, sizeof(webrtc::VideoCodec));
 }
 
 SimulcastEncoderAdapter::~SimulcastEncoderAdapter() {
   Release();
+  WorkerPool::ReturnSharedPool();
 }
 
 int SimulcastEncoderAdapter::Release() {
@@ -228,6 +229,17 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
     streaminfos_.push_back(StreamInfo(encoder, callback, stream_codec.width,
                                       stream_codec.height, send_stream));
   }
+
+  std::vector<PyramidScaler::Resolution> resolutions;
+  for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
+    resolutions.push_back(PyramidScaler::Resolution(
+        streaminfos_[stream_idx].width, streaminfos_[stream_idx].height));
+  }
+  // kScaleBox filters with libyuv::kFilterBilinear, in both directions.
+  if (pyramid_scaler_.Set(resolutions, kScaleBox) < 0) {
+    Release();
+    return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+  }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -261,8 +273,15 @@ int SimulcastEncoderAdapter::Encode(
     }
   }
 
-  int src_width = input_image.width();
-  int src_height = input_image.height();
+  // The frames for all streams are scaled at once, each from the next larger
+  // one. Streams of the input resolution get the input image as is, as do
+  // all streams if the input image is empty (e.g. a keyframe request for
+  // encoders with internal camera sources).
+  std::vector<I420VideoFrame> stream_images;
+  if (!input_image.IsZeroSize() &&
+      pyramid_scaler_.Scale(input_image, &stream_images) < 0) {
+    return WEBRTC_VIDEO_CODEC_ERROR;
+  }
   for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
     std::vector<VideoFrameType> stream_frame_types;
     if (send_key_frame) {
@@ -272,46 +291,9 @@ int SimulcastEncoderAdapter::Encode(
       stream_frame_types.push_back(kDeltaFrame);
     }
 
-    int dst_width = streaminfos_[stream_idx].width;
-    int dst_height = streaminfos_[stream_idx].height;
-    // If scaling isn't required, because the input resolution
-    // matches the destination or the input image is empty (e.g.
-    // a keyframe request for encoders with internal camera
-    // sources), pass the image on directly. Otherwise, we'll
-    // scale it to match what the encoder expects (below).
-    if ((dst_width == src_width && dst_height == src_height) ||
-        input_image.IsZeroSize()) {
-      streaminfos_[stream_idx].encoder->Encode(input_image,
-                                               codec_specific_info,
-                                               &stream_frame_types);
-    } else {
-      I420VideoFrame dst_frame;
-      // Making sure that destination frame is of sufficient size.
-      // Aligning stride values based on width.
-      dst_frame.CreateEmptyFrame(dst_width, dst_height,
-                                 dst_width, (dst_width + 1) / 2,
-                                 (dst_width + 1) / 2);
-      libyuv::I420Scale(input_image.buffer(kYPlane),
-                        input_image.stride(kYPlane),
-                        input_image.buffer(kUPlane),
-                        input_image.stride(kUPlane),
-                        input_image.buffer(kVPlane),
-                        input_image.stride(kVPlane),
-                        src_width, src_height,
-                        dst_frame.buffer(kYPlane),
-                        dst_frame.stride(kYPlane),
-                        dst_frame.buffer(kUPlane),
-                        dst_frame.stride(kUPlane),
-                        dst_frame.buffer(kVPlane),
-                        dst_frame.stride(kVPlane),
-                        dst_width, dst_height,
-                        libyuv::kFilterBilinear);
-      dst_frame.set_timestamp(input_image.timestamp());
-      dst_frame.set_render_time_ms(input_image.render_time_ms());
-      streaminfos_[stream_idx].encoder->Encode(dst_frame,
-                                               codec_specific_info,
-                                               &stream_frame_types);
-    }
+    streaminfos_[stream_idx].encoder->Encode(
+        input_image.IsZeroSize() ? input_image : stream_images[stream_idx],
+        codec_specific_info, &stream_frame_types);
   }
 
   return WEBRTC_VIDEO_CODEC_OK;
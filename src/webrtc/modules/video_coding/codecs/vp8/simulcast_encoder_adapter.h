@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_video/libyuv/include/scaler.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
 
 namespace webrtc {
@@ -104,6 +105,8 @@ class SimulcastEncoderAdapter : public VP8Encoder {
 
   rtc::scoped_ptr<VideoEncoderFactory> factory_;
   rtc::scoped_ptr<Config> screensharing_extra_options_;
+  // Scales the input for all streams, on threads shared with other scalers.
+  PyramidScaler pyramid_scaler_;
   VideoCodec codec_;
   std::vector<StreamInfo> streaminfos_;
   EncodedImageCallback* encoded_complete_callback_;
@@ -9,6 +9,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/scoped_ptr.h"
@@ -252,6 +253,60 @@ TEST_F(TestVp8Impl, DISABLED_ON_ANDROID(DecodeWithACompleteKeyFrame)) {
   EXPECT_GT(I420PSNR(&input_frame_, &decoded_frame_), 36);
 }
 
+TEST_F(TestVp8Impl, DISABLED_ON_ANDROID(EncodesOnlyUpdatedRegion)) {
+  SetUpEncodeDecode();
+  EXPECT_EQ(0, encoder_->Encode(input_frame_, NULL, NULL));
+  EXPECT_GT(WaitForEncodedFrame(), 0u);
+  EXPECT_EQ(0, decoder_->Decode(encoded_frame_, false, NULL));
+  // Let the encoder refine the key frame, nothing changes.
+  input_frame_.set_updated_region(
+      UpdatedRegion(std::vector<UpdatedRegion::Rect>()));
+  for (int i = 0; i < 30; ++i) {
+    EXPECT_EQ(0, encoder_->Encode(input_frame_, NULL, NULL));
+    EXPECT_GT(WaitForEncodedFrame(), 0u);
+    EXPECT_EQ(0, decoder_->Decode(encoded_frame_, false, NULL));
+  }
+  EXPECT_GT(WaitForDecodedFrame(), 0u);
+  I420VideoFrame static_frame;
+  static_frame.CopyFrame(decoded_frame_);
+
+  // Change the whole picture, but tell the encoder that only the top left
+  // macroblock changed.
+  I420VideoFrame changed_frame;
+  changed_frame.CopyFrame(input_frame_);
+  uint8_t* changed = changed_frame.buffer(kYPlane);
+  const int changed_stride = changed_frame.stride(kYPlane);
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x)
+      changed[y * changed_stride + x] ^= 0x80;
+  }
+  const UpdatedRegion::Rect kUpdatedRect = {0, 0, 16, 16};
+  changed_frame.set_updated_region(
+      UpdatedRegion(std::vector<UpdatedRegion::Rect>(1, kUpdatedRect)));
+  EXPECT_EQ(0, encoder_->Encode(changed_frame, NULL, NULL));
+  EXPECT_GT(WaitForEncodedFrame(), 0u);
+  EXPECT_EQ(kDeltaFrame, encoded_frame_._frameType);
+  EXPECT_EQ(0, decoder_->Decode(encoded_frame_, false, NULL));
+  EXPECT_GT(WaitForDecodedFrame(), 0u);
+
+  // The updated macroblock follows the input.
+  const int stride = decoded_frame_.stride(kYPlane);
+  const uint8_t* decoded = decoded_frame_.buffer(kYPlane);
+  EXPECT_NEAR(changed[8 * changed_stride + 8], decoded[8 * stride + 8], 16);
+  // The rest of the picture mostly stays as it was, the encoder only refines
+  // a few rows of it.
+  int num_changed_pixels = 0;
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      if (abs(decoded[y * stride + x] -
+              static_frame.buffer(kYPlane)[y * stride + x]) > 64) {
+        ++num_changed_pixels;
+      }
+    }
+  }
+  EXPECT_LT(num_changed_pixels, kWidth * kHeight / 4);
+}
+
 TEST_F(TestVp8Impl, TestReset) {
   SetUpEncodeDecode();
   EXPECT_EQ(0, encoder_->Encode(input_frame_, NULL, NULL));
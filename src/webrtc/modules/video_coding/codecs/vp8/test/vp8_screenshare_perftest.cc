@@ -0,0 +1,179 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures how long VP8 takes to encode a mostly static screen share, someone
+// typing into a web page, when the encoder is told which part of each frame
+// changed and when it isn't.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/modules/video_coding/main/interface/video_coding.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kWidth = 1850;
+const int kHeight = 1110;
+const int kNumFrames = 150;
+const int kFrameRate = 5;
+const int kBitrateKbps = 500;
+// Size and advance of the typed characters.
+const int kCharWidth = 12;
+const int kCharHeight = 20;
+const int kLineLength = 80;
+
+class EncodedFrameCollector : public EncodedImageCallback {
+ public:
+  int32_t Encoded(const EncodedImage& encoded_image,
+                  const CodecSpecificInfo* codec_specific_info,
+                  const RTPFragmentationHeader* fragmentation) override {
+    if (encoded_image._length == 0)
+      return 0;
+    frame_ = encoded_image;
+    buffer_.assign(encoded_image._buffer,
+                   encoded_image._buffer + encoded_image._length);
+    frame_._buffer = &buffer_[0];
+    frame_._size = buffer_.size();
+    frame_._completeFrame = true;
+    has_frame_ = true;
+    return 0;
+  }
+
+  // Returns the frame encoded since the last call, if any.
+  bool TakeFrame(EncodedImage* frame) {
+    if (!has_frame_)
+      return false;
+    *frame = frame_;
+    has_frame_ = false;
+    return true;
+  }
+
+ private:
+  EncodedImage frame_;
+  std::vector<uint8_t> buffer_;
+  bool has_frame_ = false;
+};
+
+class DecodedFrameCollector : public DecodedImageCallback {
+ public:
+  int32_t Decoded(I420VideoFrame& decoded_image) override {
+    frame_.CopyFrame(decoded_image);
+    return 0;
+  }
+
+  const I420VideoFrame& frame() const { return frame_; }
+
+ private:
+  I420VideoFrame frame_;
+};
+
+// Types the |index|th character, a dark block, into the Y plane of |frame| and
+// returns where it went.
+UpdatedRegion::Rect TypeCharacter(int index, I420VideoFrame* frame) {
+  const UpdatedRegion::Rect rect = {
+      100 + (index % kLineLength) * kCharWidth,
+      300 + (index / kLineLength) * kCharHeight, kCharWidth, kCharHeight};
+  for (int y = rect.y; y < rect.y + rect.height; ++y) {
+    memset(frame->buffer(kYPlane) + y * frame->stride(kYPlane) + rect.x,
+           16 + index % 64, rect.width);
+  }
+  return rect;
+}
+
+void RunScreenshare(const std::string& trace, bool use_updated_region) {
+  const size_t length = CalcBufferSize(kI420, kWidth, kHeight);
+  rtc::scoped_ptr<uint8_t[]> buffer(new uint8_t[length]);
+  FILE* file = fopen(
+      test::ResourcePath("web_screenshot_1850_1110", "yuv").c_str(), "rb");
+  ASSERT_TRUE(file != NULL);
+  ASSERT_EQ(length, fread(buffer.get(), 1, length, file));
+  fclose(file);
+  I420VideoFrame screen;
+  ASSERT_EQ(0, screen.CreateFrame(buffer.get(), kWidth, kHeight,
+                                  kVideoRotation_0));
+
+  VideoCodec codec_settings;
+  VideoCodingModule::Codec(kVideoCodecVP8, &codec_settings);
+  codec_settings.width = kWidth;
+  codec_settings.height = kHeight;
+  codec_settings.startBitrate = kBitrateKbps;
+  codec_settings.maxBitrate = kBitrateKbps;
+  codec_settings.maxFramerate = kFrameRate;
+  codec_settings.mode = kScreensharing;
+  codec_settings.codecSpecific.VP8.numberOfTemporalLayers = 1;
+  codec_settings.codecSpecific.VP8.automaticResizeOn = false;
+
+  rtc::scoped_ptr<VideoEncoder> encoder(VP8Encoder::Create());
+  rtc::scoped_ptr<VideoDecoder> decoder(VP8Decoder::Create());
+  EncodedFrameCollector encoded_frames;
+  DecodedFrameCollector decoded_frames;
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder->InitEncode(&codec_settings, 1, 1440));
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder->InitDecode(&codec_settings, 1));
+  encoder->RegisterEncodeCompleteCallback(&encoded_frames);
+  decoder->RegisterDecodeCompleteCallback(&decoded_frames);
+
+  int64_t encode_time_us = 0;
+  size_t encoded_bytes = 0;
+  double psnr = 0;
+  for (int i = 0; i < kNumFrames; ++i) {
+    // The first frame, a key frame, shows the page; then one character is
+    // typed per frame.
+    if (i > 0) {
+      const UpdatedRegion::Rect rect = TypeCharacter(i - 1, &screen);
+      screen.set_updated_region(use_updated_region
+          ? UpdatedRegion(std::vector<UpdatedRegion::Rect>(1, rect))
+          : UpdatedRegion());
+    }
+    screen.set_timestamp(i * 90000 / kFrameRate);
+    const int64_t start_us = TickTime::MicrosecondTimestamp();
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Encode(screen, NULL, NULL));
+    encode_time_us += TickTime::MicrosecondTimestamp() - start_us;
+
+    EncodedImage encoded_frame;
+    if (encoded_frames.TakeFrame(&encoded_frame)) {
+      encoded_bytes += encoded_frame._length;
+      EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+                decoder->Decode(encoded_frame, false, NULL));
+    }
+    psnr += I420PSNR(&screen, &decoded_frames.frame());
+  }
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Release());
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder->Release());
+
+  test::PrintResult("vp8_screenshare_encode_time", "", trace,
+                    static_cast<double>(encode_time_us) / kNumFrames, "us",
+                    false);
+  test::PrintResult("vp8_screenshare_frame_size", "", trace,
+                    static_cast<double>(encoded_bytes) / kNumFrames, "bytes",
+                    false);
+  test::PrintResult("vp8_screenshare_psnr", "", trace, psnr / kNumFrames, "dB",
+                    false);
+}
+
+}  // namespace
+
+TEST(Vp8ScreensharePerfTest, Typing) {
+  RunScreenshare("full_frame", false);
+  RunScreenshare("updated_region", true);
+}
+
+}  // namespace webrtc
@@ -37,6 +37,13 @@ namespace {
 
 enum { kVp8ErrorPropagationTh = 30 };
 enum { kVp832ByteAlign = 32 };
+enum { kVp8MacroblockSize = 16 };
+// Number of frames for which a macroblock is encoded after it changed, which
+// lets its quality converge to that of the rest of the frame.
+enum { kVp8ActiveFramesAfterUpdate = 10 };
+// Number of frames over which all macroblocks are encoded once more when only
+// the updated region is, so that static content still improves.
+enum { kVp8RefreshFrames = 20 };
 
 // VP8 denoiser states.
 enum denoiserState {
@@ -116,7 +123,9 @@ VP8EncoderImpl::VP8EncoderImpl()
       down_scale_bitrate_(0),
       tl0_frame_dropper_(),
       tl1_frame_dropper_(kTl1MaxTimeToDropFrames),
-      key_frame_request_(kMaxSimulcastStreams, false) {
+      key_frame_request_(kMaxSimulcastStreams, false),
+      active_map_enabled_(false),
+      refresh_mb_row_(0) {
   uint32_t seed = static_cast<uint32_t>(TickTime::MillisecondTimestamp());
   srand(seed);
 
@@ -144,6 +153,8 @@ int VP8EncoderImpl::Release() {
     delete [] image._buffer;
     encoded_images_.pop_back();
   }
+  macroblock_countdown_.clear();
+  active_map_enabled_ = false;
   while (!encoders_.empty()) {
     vpx_codec_ctx_t& encoder = encoders_.back();
     if (vpx_codec_destroy(&encoder)) {
@@ -744,6 +755,15 @@ int VP8EncoderImpl::Encode(
       return ret;
   }
 
+  // The updated region doesn't apply to a scaled down frame. It's marked before
+  // the frame may be dropped, so the next encoded frame includes it.
+  const bool use_updated_region =
+      frame.updated_region().known() &&
+      input_image.width() == frame.width() &&
+      input_image.height() == frame.height();
+  MarkUpdatedMacroblocks(use_updated_region ? frame.updated_region()
+                                            : UpdatedRegion());
+
   // Since we are extracting raw pointers from |input_image| to
   // |raw_images_[0]|, the resolution of these frames must match. Note that
   // |input_image| might be scaled from |frame|. In that case, the resolution of
@@ -877,6 +897,14 @@ int VP8EncoderImpl::Encode(
                       VP8E_SET_TEMPORAL_LAYER_ID,
                       temporal_layers_[stream_idx]->CurrentLayerId());
   }
+  // Skipped macroblocks are copied from the last frame, which only holds the
+  // previous input if every frame references it, i.e. with a single stream
+  // and temporal layer, and without reference picture selection.
+  SetActiveMap(use_updated_region && !send_key_frame &&
+               !only_predict_from_key_frame && !feedback_mode_ &&
+               encoders_.size() == 1 &&
+               codec_.codecSpecific.VP8.numberOfTemporalLayers <= 1);
+
   // TODO(holmer): Ideally the duration should be the timestamp diff of this
   // frame and the next frame to be encoded, which we don't have. Instead we
   // would like to use the duration of the previous frame. Unfortunately the
@@ -898,12 +926,82 @@ int VP8EncoderImpl::Encode(
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
   timestamp_ += duration;
-  return GetEncodedPartitions(input_image, only_predict_from_key_frame);
+  int ret = GetEncodedPartitions(input_image, only_predict_from_key_frame);
+  if (encoded_images_[0]._length > 0)
+    MacroblocksEncoded();
+  return ret;
+}
+
+void VP8EncoderImpl::MarkUpdatedMacroblocks(
+    const UpdatedRegion& updated_region) {
+  const int width = codec_.width;
+  const int height = codec_.height;
+  const int mb_cols = (width + kVp8MacroblockSize - 1) / kVp8MacroblockSize;
+  const int mb_rows = (height + kVp8MacroblockSize - 1) / kVp8MacroblockSize;
+  if (!updated_region.known() ||
+      macroblock_countdown_.size() != static_cast<size_t>(mb_cols * mb_rows)) {
+    macroblock_countdown_.assign(mb_cols * mb_rows,
+                                 kVp8ActiveFramesAfterUpdate);
+    return;
+  }
+  for (const UpdatedRegion::Rect& rect : updated_region.rects()) {
+    const int left = std::max(rect.x, 0) / kVp8MacroblockSize;
+    const int top = std::max(rect.y, 0) / kVp8MacroblockSize;
+    const int right = (std::min(rect.x + rect.width, width) +
+                       kVp8MacroblockSize - 1) / kVp8MacroblockSize;
+    const int bottom = (std::min(rect.y + rect.height, height) +
+                        kVp8MacroblockSize - 1) / kVp8MacroblockSize;
+    for (int row = top; row < bottom; ++row) {
+      for (int col = left; col < right; ++col) {
+        macroblock_countdown_[row * mb_cols + col] =
+            kVp8ActiveFramesAfterUpdate;
+      }
+    }
+  }
+}
+
+void VP8EncoderImpl::MacroblocksEncoded() {
+  for (uint8_t& countdown : macroblock_countdown_) {
+    if (countdown > 0)
+      --countdown;
+  }
+  const int mb_cols = (codec_.width + kVp8MacroblockSize - 1) /
+                      kVp8MacroblockSize;
+  const int mb_rows = static_cast<int>(macroblock_countdown_.size()) / mb_cols;
+  const int band_rows =
+      std::max(1, (mb_rows + kVp8RefreshFrames - 1) / kVp8RefreshFrames);
+  if (refresh_mb_row_ >= mb_rows)
+    refresh_mb_row_ = 0;
+  const int end_row = std::min(refresh_mb_row_ + band_rows, mb_rows);
+  for (int i = refresh_mb_row_ * mb_cols; i < end_row * mb_cols; ++i)
+    macroblock_countdown_[i] = std::max<uint8_t>(macroblock_countdown_[i], 1);
+  refresh_mb_row_ = end_row;
+}
+
+void VP8EncoderImpl::SetActiveMap(bool enable) {
+  if (!enable && !active_map_enabled_)
+    return;
+  vpx_active_map_t map;
+  map.cols = (codec_.width + kVp8MacroblockSize - 1) / kVp8MacroblockSize;
+  map.rows = (codec_.height + kVp8MacroblockSize - 1) / kVp8MacroblockSize;
+  map.active_map = NULL;
+  if (enable) {
+    active_map_.resize(macroblock_countdown_.size());
+    for (size_t i = 0; i < active_map_.size(); ++i)
+      active_map_[i] = macroblock_countdown_[i] > 0 ? 1 : 0;
+    map.active_map = &active_map_[0];
+  }
+  active_map_enabled_ =
+      vpx_codec_control(&encoders_[0], VP8E_SET_ACTIVEMAP, &map) ==
+          VPX_CODEC_OK && enable;
 }
 
 // TODO(pbos): Make sure this works for properly for >1 encoders.
 int VP8EncoderImpl::UpdateCodecFrameSize(
     const I420VideoFrame& input_image) {
+  // The active map has the size of the current frames.
+  SetActiveMap(false);
+  macroblock_countdown_.clear();
   codec_.width = input_image.width();
   codec_.height = input_image.height();
   // Update the cpu_speed setting for resolution change.
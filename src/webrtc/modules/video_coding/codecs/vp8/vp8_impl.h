@@ -94,6 +94,19 @@ class VP8EncoderImpl : public VP8Encoder {
 
   uint32_t MaxIntraTarget(uint32_t optimal_buffer_size);
 
+  // Marks the macroblocks of the top stream which are covered by
+  // |updated_region| to be encoded for the next frames. An unknown region marks
+  // all of them.
+  void MarkUpdatedMacroblocks(const UpdatedRegion& updated_region);
+
+  // Makes the encoder skip all macroblocks but the marked ones, or encode all
+  // of them again if |enable| is false.
+  void SetActiveMap(bool enable);
+
+  // Counts down the marked macroblocks after a frame was encoded, and marks
+  // the next band of macroblock rows to refine the static parts of the frame.
+  void MacroblocksEncoded();
+
   EncodedImageCallback* encoded_complete_callback_;
   VideoCodec codec_;
   bool inited_;
@@ -120,6 +133,12 @@ class VP8EncoderImpl : public VP8Encoder {
   std::vector<vpx_codec_enc_cfg_t> configurations_;
   std::vector<vpx_rational_t> downsampling_factors_;
   QualityScaler quality_scaler_;
+  // For each macroblock of the top stream, in raster order, the number of
+  // encoded frames for which it's still active since it last changed.
+  std::vector<uint8_t> macroblock_countdown_;
+  std::vector<unsigned char> active_map_;
+  bool active_map_enabled_;
+  int refresh_mb_row_;
 };  // end of VP8EncoderImpl class
 
 class VP8DecoderImpl : public VP8Decoder {
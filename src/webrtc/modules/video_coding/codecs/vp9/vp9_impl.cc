@@ -14,6 +14,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <algorithm>
 #include <vector>
 
 #include "vpx/vpx_encoder.h"
@@ -32,6 +33,22 @@
 
 namespace {
 
+// The encoder and decoder run one thread per tile column, and tile columns are
+// at least 256 pixels wide.
+const int kMinTileColumnWidth = 256;
+const int kMaxNumThreads = 8;
+
+// Only positive speeds, currently: 0 - 8.
+// O means slowest/best quality, 8 means fastest/lower quality.
+const int kMaxCpuSpeed = 8;
+// The speed is raised when encoding takes more than this share of the frame
+// interval, and lowered again when it takes less than the low share.
+const float kHighEncodeUsagePercent = 80.0f;
+const float kLowEncodeUsagePercent = 40.0f;
+const int kMinFramesBetweenSpeedChanges = 30;
+// Weight of the previous average encode time when a frame is encoded.
+const float kEncodeTimeAlpha = 0.9f;
+
 // VP9DecoderImpl::ReturnFrame helper function used with WrappedI420Buffer.
 static void WrappedI420BufferNoLongerUsedCb(
     webrtc::Vp9FrameBufferPool::Vp9FrameBuffer* img_buffer) {
@@ -53,6 +70,9 @@ VP9EncoderImpl::VP9EncoderImpl()
       timestamp_(0),
       picture_id_(0),
       cpu_speed_(3),
+      min_cpu_speed_(7),
+      avg_encode_time_ms_(0.0f),
+      frames_since_speed_change_(0),
       rc_max_intra_target_(0),
       encoder_(NULL),
       config_(NULL),
@@ -195,6 +215,23 @@ int VP9EncoderImpl::InitEncode(const VideoCodec* inst,
     config_->kf_mode = VPX_KF_DISABLED;
   }
 
+  // Allow the user to set the complexity. The encoder speeds up from this
+  // setting when it can't keep up with the frame rate.
+  switch (inst->codecSpecific.VP9.complexity) {
+    case kComplexityHigh:
+      min_cpu_speed_ = 6;
+      break;
+    case kComplexityHigher:
+      min_cpu_speed_ = 5;
+      break;
+    case kComplexityMax:
+      min_cpu_speed_ = 4;
+      break;
+    default:
+      min_cpu_speed_ = 7;
+      break;
+  }
+
   // Determine number of threads based on the image size and #cores.
   config_->g_threads = NumberOfThreads(config_->g_w,
                                        config_->g_h,
@@ -207,23 +244,22 @@ int VP9EncoderImpl::NumberOfThreads(int width,
                                     int number_of_cores) {
   // Keep the number of encoder threads equal to the possible number of column
   // tiles, which is (1, 2, 4, 8). See comments below for VP9E_SET_TILE_COLUMNS.
-  if (width * height >= 1280 * 720 && number_of_cores > 4) {
-    return 4;
-  } else if (width * height >= 640 * 480 && number_of_cores > 2) {
-    return 2;
-  } else {
-    // 1 thread less than VGA.
-    return 1;
-  }
+  // One core is left for capture and the rest of the pipeline.
+  const int max_threads = std::min(
+      std::min(width / kMinTileColumnWidth, number_of_cores - 1),
+      kMaxNumThreads);
+  int threads = 1;
+  while (threads * 2 <= max_threads)
+    threads *= 2;
+  return threads;
 }
 
 int VP9EncoderImpl::InitAndSetControlSettings(const VideoCodec* inst) {
   if (vpx_codec_enc_init(encoder_, vpx_codec_vp9_cx(), config_, 0)) {
     return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
   }
-  // Only positive speeds, currently: 0 - 8.
-  // O means slowest/best quality, 8 means fastest/lower quality.
-  cpu_speed_ = 7;
+  cpu_speed_ = min_cpu_speed_;
+  frames_since_speed_change_ = 0;
   // Note: some of these codec controls still use "VP8" in the control name.
   // TODO(marpan): Update this in the next/future libvpx version.
   vpx_codec_control(encoder_, VP8E_SET_CPUUSED, cpu_speed_);
@@ -235,7 +271,13 @@ int VP9EncoderImpl::InitAndSetControlSettings(const VideoCodec* inst) {
   // log2 unit: e.g., 0 = 1 tile column, 1 = 2 tile columns, 2 = 4 tile columns.
   // The number tile columns will be capped by the encoder based on image size
   // (minimum width of tile column is 256 pixels, maximum is 4096).
-  vpx_codec_control(encoder_, VP9E_SET_TILE_COLUMNS, (config_->g_threads >> 1));
+  int tile_columns_log2 = 0;
+  while ((2 << tile_columns_log2) <= static_cast<int>(config_->g_threads))
+    ++tile_columns_log2;
+  vpx_codec_control(encoder_, VP9E_SET_TILE_COLUMNS, tile_columns_log2);
+  // Don't let frames depend on the entropy contexts of previous frames, so
+  // that decoders can parse frames in parallel.
+  vpx_codec_control(encoder_, VP9E_SET_FRAME_PARALLEL_DECODING, 1);
 #if !defined(WEBRTC_ARCH_ARM)
   // Note denoiser is still off by default until further testing/optimization,
   // i.e., codecSpecific.VP9.denoisingOn == 0.
@@ -297,14 +339,42 @@ int VP9EncoderImpl::Encode(const I420VideoFrame& input_image,
   }
   assert(codec_.maxFramerate > 0);
   uint32_t duration = 90000 / codec_.maxFramerate;
+  const int64_t encode_start_us = TickTime::MicrosecondTimestamp();
   if (vpx_codec_encode(encoder_, raw_, timestamp_, duration, flags,
                        VPX_DL_REALTIME)) {
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
+  UpdateCpuSpeed(TickTime::MicrosecondTimestamp() - encode_start_us);
   timestamp_ += duration;
   return GetEncodedPartitions(input_image);
 }
 
+void VP9EncoderImpl::UpdateCpuSpeed(int64_t encode_time_us) {
+  const float encode_time_ms = encode_time_us / 1000.0f;
+  if (frames_since_speed_change_++ == 0) {
+    avg_encode_time_ms_ = encode_time_ms;
+  } else {
+    avg_encode_time_ms_ = kEncodeTimeAlpha * avg_encode_time_ms_ +
+                          (1 - kEncodeTimeAlpha) * encode_time_ms;
+  }
+  if (frames_since_speed_change_ < kMinFramesBetweenSpeedChanges)
+    return;
+  const float usage_percent =
+      avg_encode_time_ms_ * codec_.maxFramerate / 10.0f;
+  int cpu_speed = cpu_speed_;
+  if (usage_percent > kHighEncodeUsagePercent && cpu_speed_ < kMaxCpuSpeed) {
+    ++cpu_speed;
+  } else if (usage_percent < kLowEncodeUsagePercent &&
+             cpu_speed_ > min_cpu_speed_) {
+    --cpu_speed;
+  }
+  if (cpu_speed != cpu_speed_) {
+    cpu_speed_ = cpu_speed;
+    vpx_codec_control(encoder_, VP8E_SET_CPUUSED, cpu_speed_);
+    frames_since_speed_change_ = 0;
+  }
+}
+
 void VP9EncoderImpl::PopulateCodecSpecific(CodecSpecificInfo* codec_specific,
                                        const vpx_codec_cx_pkt& pkt,
                                        uint32_t timestamp) {
@@ -392,6 +462,7 @@ VP9Decoder* VP9Decoder::Create() {
 VP9DecoderImpl::VP9DecoderImpl()
     : decode_complete_callback_(NULL),
       inited_(false),
+      number_of_cores_(1),
       decoder_(NULL),
       key_frame_required_(true) {
   memset(&codec_, 0, sizeof(codec_));
@@ -414,7 +485,7 @@ int VP9DecoderImpl::Reset() {
   if (!inited_) {
     return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
   }
-  InitDecode(&codec_, 1);
+  InitDecode(&codec_, number_of_cores_);
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -430,8 +501,8 @@ int VP9DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
     decoder_ = new vpx_codec_ctx_t;
   }
   vpx_codec_dec_cfg_t  cfg;
-  // Setting number of threads to a constant value (1)
-  cfg.threads = 1;
+  // The decoder only starts as many threads as there are tile columns.
+  cfg.threads = std::min(number_of_cores, kMaxNumThreads);
   cfg.h = cfg.w = 0;  // set after decode
   vpx_codec_flags_t flags = 0;
   if (vpx_codec_dec_init(decoder_, vpx_codec_vp9_dx(), &cfg, flags)) {
@@ -441,6 +512,7 @@ int VP9DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
     // Save VideoCodec instance for later; mainly for duplicating the decoder.
     codec_ = *inst;
   }
+  number_of_cores_ = number_of_cores;
 
   if (!frame_buffer_pool_.InitializeVpxUsePool(decoder_)) {
     return WEBRTC_VIDEO_CODEC_MEMORY;
@@ -48,6 +48,10 @@ class VP9EncoderImpl : public VP9Encoder {
   // Determine number of encoder threads to use.
   int NumberOfThreads(int width, int height, int number_of_cores);
 
+  // Adjusts |cpu_speed_| to keep the time spent encoding a frame within a
+  // share of the frame interval.
+  void UpdateCpuSpeed(int64_t encode_time_us);
+
   // Call encoder initialize function and set control settings.
   int InitAndSetControlSettings(const VideoCodec* inst);
 
@@ -72,6 +76,12 @@ class VP9EncoderImpl : public VP9Encoder {
   int64_t timestamp_;
   uint16_t picture_id_;
   int cpu_speed_;
+  // The slowest speed |cpu_speed_| is adjusted to, set from the complexity.
+  int min_cpu_speed_;
+  // Filtered time to encode a frame, and the number of frames encoded since
+  // |cpu_speed_| last changed.
+  float avg_encode_time_ms_;
+  int frames_since_speed_change_;
   uint32_t rc_max_intra_target_;
   vpx_codec_ctx_t* encoder_;
   vpx_codec_enc_cfg_t* config_;
@@ -106,6 +116,7 @@ class VP9DecoderImpl : public VP9Decoder {
   Vp9FrameBufferPool frame_buffer_pool_;
   DecodedImageCallback* decode_complete_callback_;
   bool inited_;
+  int number_of_cores_;
   vpx_codec_ctx_t* decoder_;
   VideoCodec codec_;
   bool key_frame_required_;
@@ -127,6 +127,8 @@ class VideoSender {
   VCMGenericEncoder* _encoder;
   VCMEncodedFrameCallback _encodedFrameCallback;
   std::vector<FrameType> _nextFrameTypes;
+  // What changed in the frames dropped since a frame was last encoded.
+  UpdatedRegion dropped_region_;
   media_optimization::MediaOptimization _mediaOpt;
   VCMSendStatisticsCallback* _sendStatsCallback;
   VCMCodecDataBase _codecDataBase;
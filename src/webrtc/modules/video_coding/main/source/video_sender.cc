@@ -71,6 +71,7 @@ VideoSender::VideoSender(Clock* clock,
       _encoder(nullptr),
       _encodedFrameCallback(post_encode_callback),
       _nextFrameTypes(1, kVideoFrameDelta),
+      dropped_region_(std::vector<UpdatedRegion::Rect>()),
       _mediaOpt(clock_),
       _sendStatsCallback(nullptr),
       _codecDataBase(encoder_rate_observer),
@@ -344,9 +345,11 @@ int32_t VideoSender::AddVideoFrame(const I420VideoFrame& videoFrame,
   // TODO(holmer): Add support for dropping frames per stream. Currently we
   // only have one frame dropper for all streams.
   if (_nextFrameTypes[0] == kFrameEmpty) {
+    dropped_region_.Union(videoFrame.updated_region());
     return VCM_OK;
   }
   if (_mediaOpt.DropFrame()) {
+    dropped_region_.Union(videoFrame.updated_region());
     _encoder->OnDroppedFrame();
     return VCM_OK;
   }
@@ -358,8 +361,16 @@ int32_t VideoSender::AddVideoFrame(const I420VideoFrame& videoFrame,
     LOG(LS_ERROR) << "Incoming frame doesn't match set resolution. Dropping.";
     return VCM_PARAMETER_ERROR;
   }
-  int32_t ret =
-      _encoder->Encode(videoFrame, codecSpecificInfo, _nextFrameTypes);
+  // The region of the encoded frame has to include the dropped ones.
+  I420VideoFrame merged_frame;
+  const I420VideoFrame* frame = &videoFrame;
+  UpdatedRegion updated_region = videoFrame.updated_region();
+  if (updated_region.MergeDropped(&dropped_region_)) {
+    merged_frame.ShallowCopy(videoFrame);
+    merged_frame.set_updated_region(updated_region);
+    frame = &merged_frame;
+  }
+  int32_t ret = _encoder->Encode(*frame, codecSpecificInfo, _nextFrameTypes);
   recorder_->Add(videoFrame);
   if (ret < 0) {
     LOG(LS_ERROR) << "Failed to encode frame. Error code: " << ret;
@@ -454,7 +454,7 @@ class RtpPlayerImpl : public RtpPlayerInterface {
   SsrcHandlers ssrc_handlers_;
   Clock* clock_;
   rtc::scoped_ptr<test::RtpFileReader> packet_source_;
-  test::RtpPacket next_packet_;
+  test::RtpPacketRef next_packet_;
   uint32_t next_rtp_time_;
   bool first_packet_;
   int64_t first_packet_rtp_time_;
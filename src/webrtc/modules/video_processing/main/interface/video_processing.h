@@ -159,9 +159,9 @@ class VideoProcessingModule : public Module {
          Pointer to the video frame.
 
      \param[in,out] stats
-         Frame statistics provided by GetFrameStats(). On return the stats will
-         be reset to zero if the frame was altered. Call GetFrameStats() again
-         if the statistics for the altered frame are required.
+         Frame statistics provided by GetFrameStats(). If the frame was
+         altered, the stats are updated to match it on return, so there is no
+         need to call GetFrameStats() again.
 
      \return 0 on success, -1 on failure.
   */
@@ -32,9 +32,6 @@ int32_t VPMBrightnessDetection::ProcessFrame(
   if (frame.IsZeroSize()) {
     return VPM_PARAMETER_ERROR;
   }
-  int width = frame.width();
-  int height = frame.height();
-
   if (!VideoProcessingModule::ValidFrameStats(stats)) {
     return VPM_PARAMETER_ERROR;
   }
@@ -59,15 +56,11 @@ int32_t VPMBrightnessDetection::ProcessFrame(
 
   if (prop_high < 0.4) {
     if (stats.mean < 90 || stats.mean > 170) {
-      // Standard deviation of Y
-      const uint8_t* buffer = frame.buffer(kYPlane);
+      // Standard deviation of Y, from the histogram.
       float std_y = 0;
-      for (int h = 0; h < height; h += (1 << stats.subSamplHeight)) {
-        int row = h*width;
-        for (int w = 0; w < width; w += (1 << stats.subSamplWidth)) {
-          std_y += (buffer[w + row] - stats.mean) * (buffer[w + row] -
-              stats.mean);
-        }
+      for (int i = 0; i < 256; i++) {
+        const int diff = i - static_cast<int>(stats.mean);
+        std_y += stats.hist[i] * static_cast<float>(diff * diff);
       }
       std_y = sqrt(std_y / stats.num_pixels);
 
@@ -33,6 +33,7 @@ VPMContentAnalysis::VPMContentAnalysis(bool runtime_cpu_detection)
       content_metrics_(NULL) {
   ComputeSpatialMetrics = &VPMContentAnalysis::ComputeSpatialMetrics_C;
   TemporalDiffMetric = &VPMContentAnalysis::TemporalDiffMetric_C;
+  ComputeFusedMetrics = NULL;
 
   if (runtime_cpu_detection) {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
@@ -40,6 +41,8 @@ VPMContentAnalysis::VPMContentAnalysis(bool runtime_cpu_detection)
       ComputeSpatialMetrics = &VPMContentAnalysis::ComputeSpatialMetrics_SSE2;
       TemporalDiffMetric = &VPMContentAnalysis::TemporalDiffMetric_SSE2;
     }
+    if (WebRtc_GetCPUInfo(kAVX2))
+      ComputeFusedMetrics = &VPMContentAnalysis::ComputeFusedMetrics_AVX2;
 #endif
   }
   Release();
@@ -63,15 +66,21 @@ VideoContentMetrics* VPMContentAnalysis::ComputeContentMetrics(
   // Only interested in the Y plane.
   orig_frame_ = inputFrame.buffer(kYPlane);
 
-  // Compute spatial metrics: 3 spatial prediction errors.
-  (this->*ComputeSpatialMetrics)();
+  if (ComputeFusedMetrics != NULL) {
+    // Spatial and motion metrics, saving the rows they use as the previous
+    // frame.
+    (this->*ComputeFusedMetrics)();
+  } else {
+    // Compute spatial metrics: 3 spatial prediction errors.
+    (this->*ComputeSpatialMetrics)();
 
-  // Compute motion metrics
-  if (first_frame_ == false)
-    ComputeMotionMetrics();
+    // Compute motion metrics
+    if (first_frame_ == false)
+      ComputeMotionMetrics();
 
-  // Saving current frame as previous one: Y only.
-  memcpy(prev_frame_, orig_frame_, width_ * height_);
+    // Saving current frame as previous one: Y only.
+    memcpy(prev_frame_, orig_frame_, width_ * height_);
+  }
 
   first_frame_ =  false;
   ca_Init_ = true;
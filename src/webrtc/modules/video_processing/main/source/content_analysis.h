@@ -60,9 +60,18 @@ class VPMContentAnalysis {
   ComputeSpatialMetricsFunc ComputeSpatialMetrics;
   int32_t ComputeSpatialMetrics_C();
 
+  // Computes the spatial metrics and, after the first frame, the temporal
+  // difference metric in one pass over every |skip_num_|th row of the frame,
+  // and saves those rows as the previous frame in the same pass; the other
+  // rows of the previous frame are never read. NULL when there is no such
+  // version for the CPU, then the metrics are computed separately.
+  typedef int32_t (VPMContentAnalysis::*ComputeFusedMetricsFunc)();
+  ComputeFusedMetricsFunc ComputeFusedMetrics;
+
 #if defined(WEBRTC_ARCH_X86_FAMILY)
   int32_t ComputeSpatialMetrics_SSE2();
   int32_t TemporalDiffMetric_SSE2();
+  int32_t ComputeFusedMetrics_AVX2();
 #endif
 
   const uint8_t* orig_frame_;
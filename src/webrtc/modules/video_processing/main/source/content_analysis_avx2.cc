@@ -0,0 +1,195 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_processing/main/source/content_analysis.h"
+
+#include <immintrin.h>
+#include <math.h>
+
+namespace webrtc {
+
+namespace {
+
+// Sums of one row, in 32 bit lanes.
+struct RowSums {
+  __m256i spatial_err;
+  __m256i spatial_err_v;
+  __m256i spatial_err_h;
+  __m256i pixel_sq;
+};
+
+// Adds the spatial prediction errors and the squares of the pixels |c|, with
+// the neighbours |l|, |r|, |t| and |b|, to |sums|. Each holds 32 pixels.
+inline void AddSpatialErrors(__m256i c, __m256i l, __m256i r, __m256i t,
+                             __m256i b, RowSums* sums) {
+  const __m256i z = _mm256_setzero_si256();
+  const __m256i ones = _mm256_set1_epi16(1);
+  const __m256i byte_ones = _mm256_set1_epi8(1);
+  __m256i se_16 = z;
+  __m256i sev_16 = z;
+  __m256i seh_16 = z;
+  // Both halves are widened to 16 bits the same way, the order of the pixels
+  // doesn't matter for the sums. The sums of two neighbours are widened by
+  // adding the interleaved bytes.
+  for (int half = 0; half < 2; ++half) {
+    const __m256i c16 = half ? _mm256_unpackhi_epi8(c, z)
+                             : _mm256_unpacklo_epi8(c, z);
+    const __m256i lr = _mm256_maddubs_epi16(
+        half ? _mm256_unpackhi_epi8(l, r) : _mm256_unpacklo_epi8(l, r),
+        byte_ones);
+    const __m256i tb = _mm256_maddubs_epi16(
+        half ? _mm256_unpackhi_epi8(t, b) : _mm256_unpacklo_epi8(t, b),
+        byte_ones);
+    const __m256i c2 = _mm256_add_epi16(c16, c16);
+    // At most 4 * 255 each, 2 * 4 * 255 for both halves.
+    se_16 = _mm256_add_epi16(se_16, _mm256_abs_epi16(_mm256_sub_epi16(
+        _mm256_add_epi16(c2, c2), _mm256_add_epi16(lr, tb))));
+    sev_16 = _mm256_add_epi16(sev_16,
+                              _mm256_abs_epi16(_mm256_sub_epi16(c2, tb)));
+    seh_16 = _mm256_add_epi16(seh_16,
+                              _mm256_abs_epi16(_mm256_sub_epi16(c2, lr)));
+    sums->pixel_sq = _mm256_add_epi32(sums->pixel_sq,
+                                      _mm256_madd_epi16(c16, c16));
+  }
+  sums->spatial_err = _mm256_add_epi32(sums->spatial_err,
+                                       _mm256_madd_epi16(se_16, ones));
+  sums->spatial_err_v = _mm256_add_epi32(sums->spatial_err_v,
+                                         _mm256_madd_epi16(sev_16, ones));
+  sums->spatial_err_h = _mm256_add_epi32(sums->spatial_err_h,
+                                         _mm256_madd_epi16(seh_16, ones));
+}
+
+// Adds the 32 bit lanes of |sum_32| to the 64 bit lanes of |sum_64|.
+inline __m256i AddTo64(__m256i sum_64, __m256i sum_32) {
+  const __m256i z = _mm256_setzero_si256();
+  return _mm256_add_epi64(sum_64,
+                          _mm256_add_epi64(_mm256_unpacklo_epi32(sum_32, z),
+                                           _mm256_unpackhi_epi32(sum_32, z)));
+}
+
+inline uint64_t SumLanes(__m256i sum_64) {
+  uint64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sum_64);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+// Loads 16 pixels into the low half of the result, the high half is zero and
+// adds nothing to the sums.
+inline __m256i Load16(const uint8_t* p) {
+  return _mm256_inserti128_si256(
+      _mm256_setzero_si256(),
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), 0);
+}
+
+inline __m256i Load32(const uint8_t* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+}  // namespace
+
+int32_t VPMContentAnalysis::ComputeFusedMetrics_AVX2() {
+  const int32_t width_end = ((width_ - 2 * border_) & -16) + border_;
+  const bool temporal = !first_frame_;
+  const __m256i z = _mm256_setzero_si256();
+
+  __m256i se_64 = z;
+  __m256i sev_64 = z;
+  __m256i seh_64 = z;
+  __m256i sqsum_64 = z;
+  __m256i sum_64 = z;
+  __m256i sad_64 = z;
+  uint32_t num_pixels = 0;
+
+  // The row sums fit in 32 bits for widths well beyond 8K: per lane and 32
+  // pixels they grow by at most 2 * 2 * 4 * 255 and 4 * 255 * 255.
+  for (int i = border_; i < height_ - border_; i += skip_num_) {
+    const uint8_t* line = orig_frame_ + i * width_;
+    uint8_t* prev_line = prev_frame_ + i * width_;
+    RowSums sums = {z, z, z, z};
+    int j = border_;
+    for (; j + 32 <= width_end; j += 32) {
+      const __m256i c = Load32(line + j);
+      AddSpatialErrors(c, Load32(line + j - 1), Load32(line + j + 1),
+                       Load32(line + j - width_), Load32(line + j + width_),
+                       &sums);
+      sum_64 = _mm256_add_epi64(sum_64, _mm256_sad_epu8(c, z));
+      if (temporal) {
+        sad_64 = _mm256_add_epi64(sad_64,
+                                  _mm256_sad_epu8(c, Load32(prev_line + j)));
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(prev_line + j), c);
+    }
+    // The width is a multiple of 16, so at most 16 pixels are left.
+    if (j < width_end) {
+      const __m256i c = Load16(line + j);
+      AddSpatialErrors(c, Load16(line + j - 1), Load16(line + j + 1),
+                       Load16(line + j - width_), Load16(line + j + width_),
+                       &sums);
+      sum_64 = _mm256_add_epi64(sum_64, _mm256_sad_epu8(c, z));
+      if (temporal) {
+        sad_64 = _mm256_add_epi64(sad_64,
+                                  _mm256_sad_epu8(c, Load16(prev_line + j)));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(prev_line + j),
+                       _mm256_castsi256_si128(c));
+    }
+    se_64 = AddTo64(se_64, sums.spatial_err);
+    sev_64 = AddTo64(sev_64, sums.spatial_err_v);
+    seh_64 = AddTo64(seh_64, sums.spatial_err_h);
+    sqsum_64 = AddTo64(sqsum_64, sums.pixel_sq);
+    num_pixels += (width_end - border_);
+  }
+
+  const uint64_t spatialErrSum = SumLanes(se_64);
+  const uint64_t spatialErrVSum = SumLanes(sev_64);
+  const uint64_t spatialErrHSum = SumLanes(seh_64);
+  const uint64_t pixelSum = SumLanes(sum_64);
+
+  // Normalize over all pixels.
+  const float spatialErr  = (float)(spatialErrSum >> 2);
+  const float spatialErrH = (float)(spatialErrHSum >> 1);
+  const float spatialErrV = (float)(spatialErrVSum >> 1);
+  const float norm = (float)pixelSum;
+
+  // 2X2:
+  spatial_pred_err_ = spatialErr / norm;
+
+  // 1X2:
+  spatial_pred_err_h_ = spatialErrH / norm;
+
+  // 2X1:
+  spatial_pred_err_v_ = spatialErrV / norm;
+
+  if (!temporal)
+    return VPM_OK;
+
+  const uint64_t pixelSqSum = SumLanes(sqsum_64);
+  const uint64_t tempDiffSum = SumLanes(sad_64);
+
+  // Default.
+  motion_magnitude_ = 0.0f;
+
+  if (tempDiffSum == 0) return VPM_OK;
+
+  // Normalize over all pixels.
+  const float tempDiffAvg = (float)tempDiffSum / (float)(num_pixels);
+  const float pixelSumAvg = (float)pixelSum / (float)(num_pixels);
+  const float pixelSqSumAvg = (float)pixelSqSum / (float)(num_pixels);
+  float contrast = pixelSqSumAvg - (pixelSumAvg * pixelSumAvg);
+
+  if (contrast > 0.0) {
+    contrast = sqrt(contrast);
+    motion_magnitude_ = tempDiffAvg/contrast;
+  }
+
+  return VPM_OK;
+}
+
+}  // namespace webrtc
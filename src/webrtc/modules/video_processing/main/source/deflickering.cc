@@ -15,7 +15,6 @@
 
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 #include "webrtc/system_wrappers/interface/logging.h"
-#include "webrtc/system_wrappers/interface/sort.h"
 
 namespace webrtc {
 
@@ -100,12 +99,6 @@ int32_t VPMDeflickering::ProcessFrame(I420VideoFrame* frame,
     return VPM_GENERAL_ERROR;
   }
 
-  // Stricter height check due to subsampling size calculation below.
-  if (height < 2) {
-    LOG(LS_ERROR) << "Invalid frame size.";
-    return VPM_GENERAL_ERROR;
-  }
-
   if (!VideoProcessingModule::ValidFrameStats(*stats)) {
     return VPM_GENERAL_ERROR;
   }
@@ -120,24 +113,8 @@ int32_t VPMDeflickering::ProcessFrame(I420VideoFrame* frame,
     return 0;
   }
 
-  // Size of luminance component.
-  const uint32_t y_size = height * width;
-
   const uint32_t y_sub_size = width * (((height - 1) >>
       kLog2OfDownsamplingFactor) + 1);
-  uint8_t* y_sorted = new uint8_t[y_sub_size];
-  uint32_t sort_row_idx = 0;
-  for (int i = 0; i < height; i += kDownsamplingFactor) {
-    memcpy(y_sorted + sort_row_idx * width,
-        frame->buffer(kYPlane) + i * width, width);
-    sort_row_idx++;
-  }
-
-  webrtc::Sort(y_sorted, y_sub_size, webrtc::TYPE_UWord8);
-
-  uint32_t prob_idx_uw32 = 0;
-  quant_uw8[0] = 0;
-  quant_uw8[kNumQuants - 1] = 255;
 
   // Ensure we won't get an overflow below.
   // In practice, the number of subsampled pixels will not become this large.
@@ -146,15 +123,33 @@ int32_t VPMDeflickering::ProcessFrame(I420VideoFrame* frame,
     return -1;
   }
 
+  // The quantiles are read off a histogram of every kDownsamplingFactor-th
+  // row, which gives the same values as sorting those rows. The frame stats
+  // sample too few pixels for that at high resolutions.
+  uint32_t sub_hist[256];
+  memset(sub_hist, 0, sizeof(sub_hist));
+  for (int i = 0; i < height; i += kDownsamplingFactor) {
+    const uint8_t* row = frame->buffer(kYPlane) + i * frame->stride(kYPlane);
+    for (int j = 0; j < width; j++) {
+      sub_hist[row[j]]++;
+    }
+  }
+
+  quant_uw8[0] = 0;
+  quant_uw8[kNumQuants - 1] = 255;
+  uint32_t value = 0;
+  uint32_t num_below = 0;  // Number of pixels below |value|.
   for (int32_t i = 0; i < kNumProbs; i++) {
     // <Q0>.
-    prob_idx_uw32 = WEBRTC_SPL_UMUL_32_16(y_sub_size, prob_uw16_[i]) >> 11;
-    quant_uw8[i + 1] = y_sorted[prob_idx_uw32];
+    const uint32_t prob_idx_uw32 =
+        WEBRTC_SPL_UMUL_32_16(y_sub_size, prob_uw16_[i]) >> 11;
+    while (num_below + sub_hist[value] <= prob_idx_uw32) {
+      num_below += sub_hist[value];
+      value++;
+    }
+    quant_uw8[i + 1] = static_cast<uint8_t>(value);
   }
 
-  delete [] y_sorted;
-  y_sorted = NULL;
-
   // Shift history for new frame.
   memmove(quant_hist_uw8_[1], quant_hist_uw8_[0],
       (kFrameHistory_size - 1) * kNumQuants * sizeof(uint8_t));
@@ -223,13 +218,25 @@ int32_t VPMDeflickering::ProcessFrame(I420VideoFrame* frame,
   }
 
   // Map to the output frame.
-  uint8_t* buffer = frame->buffer(kYPlane);
-  for (uint32_t i = 0; i < y_size; i++) {
-    buffer[i] = map_uw8[buffer[i]];
+  for (int i = 0; i < height; i++) {
+    uint8_t* row = frame->buffer(kYPlane) + i * frame->stride(kYPlane);
+    for (int j = 0; j < width; j++) {
+      row[j] = map_uw8[row[j]];
+    }
   }
 
-  // Frame was altered, so reset stats.
-  VideoProcessingModule::ClearFrameStats(stats);
+  // Frame was altered; the same pixels are sampled, so map the stats too.
+  uint32_t hist[256];
+  memset(hist, 0, sizeof(hist));
+  for (int32_t i = 0; i < 256; i++) {
+    hist[map_uw8[i]] += stats->hist[i];
+  }
+  memcpy(stats->hist, hist, sizeof(hist));
+  stats->sum = 0;
+  for (int32_t i = 0; i < 256; i++) {
+    stats->sum += i * stats->hist[i];
+  }
+  stats->mean = stats->sum / stats->num_pixels;
 
   return VPM_OK;
 }
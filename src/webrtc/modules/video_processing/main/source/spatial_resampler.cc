@@ -10,6 +10,7 @@
 
 #include "webrtc/modules/video_processing/main/source/spatial_resampler.h"
 
+#include "webrtc/system_wrappers/interface/worker_pool.h"
 
 namespace webrtc {
 
@@ -17,9 +18,13 @@ VPMSimpleSpatialResampler::VPMSimpleSpatialResampler()
     : resampling_mode_(kFastRescaling),
       target_width_(0),
       target_height_(0),
-      scaler_() {}
+      scaler_() {
+  scaler_.SetThreadPool(WorkerPool::GetSharedPool());
+}
 
-VPMSimpleSpatialResampler::~VPMSimpleSpatialResampler() {}
+VPMSimpleSpatialResampler::~VPMSimpleSpatialResampler() {
+  WorkerPool::ReturnSharedPool();
+}
 
 
 int32_t VPMSimpleSpatialResampler::SetTargetFrameSize(int32_t width,
@@ -70,22 +70,38 @@ int32_t VideoProcessingModule::GetFrameStats(FrameStats* stats,
 
   int width = frame.width();
   int height = frame.height();
+  int stride = frame.stride(kYPlane);
 
   ClearFrameStats(stats);  // The histogram needs to be zeroed out.
   SetSubSampling(stats, width, height);
-
+  const int step_width = 1 << stats->subSamplWidth;
+  const int step_height = 1 << stats->subSamplHeight;
+
+  // This is the only pass over the luminance; the sum, the mean and whatever
+  // the VPM functions need later are derived from the histogram. Consecutive
+  // pixels are counted in separate histograms, so that runs of equal pixels
+  // don't wait on the same counter.
+  uint32_t hist[4][256];
+  memset(hist, 0, sizeof(hist));
   const uint8_t* buffer = frame.buffer(kYPlane);
-  // Compute histogram and sum of frame
-  for (int i = 0; i < height; i += (1 << stats->subSamplHeight)) {
-    int k = i * width;
-    for (int j = 0; j < width; j += (1 << stats->subSamplWidth)) {
-      stats->hist[buffer[k + j]]++;
-      stats->sum += buffer[k + j];
+  for (int i = 0; i < height; i += step_height) {
+    const uint8_t* row = buffer + i * stride;
+    int j = 0;
+    for (; j + 3 * step_width < width; j += 4 * step_width) {
+      hist[0][row[j]]++;
+      hist[1][row[j + step_width]]++;
+      hist[2][row[j + 2 * step_width]]++;
+      hist[3][row[j + 3 * step_width]]++;
     }
+    for (; j < width; j += step_width)
+      hist[0][row[j]]++;
   }
 
-  stats->num_pixels = (width * height) / ((1 << stats->subSamplWidth) *
-                     (1 << stats->subSamplHeight));
+  for (int i = 0; i < 256; i++) {
+    stats->hist[i] = hist[0][i] + hist[1][i] + hist[2][i] + hist[3][i];
+    stats->sum += i * stats->hist[i];
+    stats->num_pixels += stats->hist[i];
+  }
   assert(stats->num_pixels > 0);
 
   // Compute mean value of frame
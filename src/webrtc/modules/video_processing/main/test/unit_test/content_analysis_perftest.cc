@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures how long the content analysis of a frame takes with the C version,
+// and with the fastest version the CPU supports.
+
+#include <stdio.h>
+
+#include <sstream>
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_video/libyuv/include/scaler.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/video_processing/main/source/content_analysis.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kCifWidth = 352;
+const int kCifHeight = 288;
+// The analysis alternates between two consecutive frames, so there is motion.
+const int kNumSourceFrames = 2;
+const int kNumFrames = 100;
+
+struct Resolution {
+  const char* name;
+  int width;
+  int height;
+};
+
+const Resolution kResolutions[] = {
+  {"720p", 1280, 720},
+  {"1080p", 1920, 1080},
+  {"4k", 3840, 2160},
+};
+
+void MeasureContentAnalysis(const I420VideoFrame* frames,
+                            bool runtime_cpu_detection,
+                            const std::string& trace) {
+  VPMContentAnalysis content_analysis(runtime_cpu_detection);
+  // The first frame only has spatial metrics.
+  ASSERT_TRUE(content_analysis.ComputeContentMetrics(frames[0]) != NULL);
+  const int64_t start_us = TickTime::MicrosecondTimestamp();
+  for (int i = 1; i <= kNumFrames; ++i) {
+    content_analysis.ComputeContentMetrics(frames[i % kNumSourceFrames]);
+  }
+  const int64_t elapsed_us = TickTime::MicrosecondTimestamp() - start_us;
+  test::PrintResult("content_analysis_time", "", trace,
+                    static_cast<double>(elapsed_us) / kNumFrames, "us", false);
+}
+
+}  // namespace
+
+TEST(ContentAnalysisPerfTest, Resolutions) {
+  const size_t cif_length = CalcBufferSize(kI420, kCifWidth, kCifHeight);
+  rtc::scoped_ptr<uint8_t[]> cif_buffer(new uint8_t[cif_length]);
+  FILE* file = fopen(test::ResourcePath("foreman_cif", "yuv").c_str(), "rb");
+  ASSERT_TRUE(file != NULL);
+  I420VideoFrame cif_frames[kNumSourceFrames];
+  for (I420VideoFrame& cif_frame : cif_frames) {
+    ASSERT_EQ(cif_length, fread(cif_buffer.get(), 1, cif_length, file));
+    ASSERT_EQ(0, cif_frame.CreateFrame(cif_buffer.get(), kCifWidth, kCifHeight,
+                                       kVideoRotation_0));
+  }
+  fclose(file);
+
+  for (const Resolution& resolution : kResolutions) {
+    Scaler scaler;
+    ASSERT_EQ(0, scaler.Set(kCifWidth, kCifHeight, resolution.width,
+                            resolution.height, kI420, kI420, kScaleBilinear));
+    I420VideoFrame frames[kNumSourceFrames];
+    for (int i = 0; i < kNumSourceFrames; ++i)
+      ASSERT_EQ(0, scaler.Scale(cif_frames[i], &frames[i]));
+
+    std::stringstream trace;
+    trace << resolution.name << "_";
+    MeasureContentAnalysis(frames, false, trace.str() + "c");
+    MeasureContentAnalysis(frames, true, trace.str() + "optimized");
+  }
+}
+
+}  // namespace webrtc
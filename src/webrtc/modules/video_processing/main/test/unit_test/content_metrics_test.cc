@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include "webrtc/common_video/libyuv/include/scaler.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/video_processing/main/interface/video_processing.h"
 #include "webrtc/modules/video_processing/main/source/content_analysis.h"
@@ -40,4 +41,41 @@ TEST_F(VideoProcessingModuleTest, ContentAnalysis) {
   ASSERT_NE(0, feof(source_file_)) << "Error reading source file";
 }
 
+// From 4CIF up only every second or fourth row is analyzed.
+TEST_F(VideoProcessingModuleTest, ContentAnalysisSubsampled) {
+  const int kSizes[][2] = {{704, 576}, {1920, 1080}};
+  const int kNumFrames = 20;
+  rtc::scoped_ptr<uint8_t[]> video_buffer(new uint8_t[frame_length_]);
+  for (size_t i = 0; i < sizeof(kSizes) / sizeof(kSizes[0]); ++i) {
+    VPMContentAnalysis ca_c(false);
+    VPMContentAnalysis ca_optimized(true);
+    Scaler scaler;
+    ASSERT_EQ(0, scaler.Set(width_, height_, kSizes[i][0], kSizes[i][1],
+                            kI420, kI420, kScaleBox));
+    rewind(source_file_);
+    for (int n = 0; n < kNumFrames; ++n) {
+      ASSERT_EQ(frame_length_,
+                fread(video_buffer.get(), 1, frame_length_, source_file_));
+      EXPECT_EQ(0, ConvertToI420(kI420, video_buffer.get(), 0, 0, width_,
+                                 height_, 0, kVideoRotation_0, &video_frame_));
+      I420VideoFrame scaled_frame;
+      ASSERT_EQ(0, scaler.Scale(video_frame_, &scaled_frame));
+      VideoContentMetrics* metrics_c =
+          ca_c.ComputeContentMetrics(scaled_frame);
+      VideoContentMetrics* metrics_optimized =
+          ca_optimized.ComputeContentMetrics(scaled_frame);
+      ASSERT_TRUE(metrics_c != NULL);
+      ASSERT_TRUE(metrics_optimized != NULL);
+      ASSERT_EQ(metrics_c->spatial_pred_err,
+                metrics_optimized->spatial_pred_err);
+      ASSERT_EQ(metrics_c->spatial_pred_err_v,
+                metrics_optimized->spatial_pred_err_v);
+      ASSERT_EQ(metrics_c->spatial_pred_err_h,
+                metrics_optimized->spatial_pred_err_h);
+      ASSERT_EQ(metrics_c->motion_magnitude,
+                metrics_optimized->motion_magnitude);
+    }
+  }
+}
+
 }  // namespace webrtc
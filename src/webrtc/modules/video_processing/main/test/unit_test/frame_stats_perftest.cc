@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the per-frame latency of the frame statistics, deflickering and
+// brightness detection on a clip with 100 Hz flicker, as seen by a camera
+// capturing at 30 fps.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_video/libyuv/include/scaler.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/video_processing/main/interface/video_processing.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kCifWidth = 352;
+const int kCifHeight = 288;
+const int kFrameRate = 30;
+const int kNumFrames = 90;
+// 100 Hz flicker sampled at 30 fps repeats every third frame.
+const int kFlickerOffsets[] = {0, 20, -20};
+const int kNumFlickerFrames =
+    sizeof(kFlickerOffsets) / sizeof(kFlickerOffsets[0]);
+
+struct Resolution {
+  const char* name;
+  int width;
+  int height;
+};
+
+const Resolution kResolutions[] = {
+  {"vga", 640, 480},
+  {"720p", 1280, 720},
+  {"1080p", 1920, 1080},
+};
+
+// Adds |offset| to the luminance of |frame|.
+void AddFlicker(int offset, I420VideoFrame* frame) {
+  for (int y = 0; y < frame->height(); ++y) {
+    uint8_t* row = frame->buffer(kYPlane) + y * frame->stride(kYPlane);
+    for (int x = 0; x < frame->width(); ++x)
+      row[x] = static_cast<uint8_t>(
+          std::max(0, std::min(255, row[x] + offset)));
+  }
+}
+
+}  // namespace
+
+TEST(FrameStatsPerfTest, DeflickeringAndBrightnessDetection) {
+  const size_t cif_length = CalcBufferSize(kI420, kCifWidth, kCifHeight);
+  rtc::scoped_ptr<uint8_t[]> cif_buffer(new uint8_t[cif_length]);
+  FILE* file = fopen(test::ResourcePath("foreman_cif", "yuv").c_str(), "rb");
+  ASSERT_TRUE(file != NULL);
+  ASSERT_EQ(cif_length, fread(cif_buffer.get(), 1, cif_length, file));
+  fclose(file);
+  I420VideoFrame cif_frame;
+  ASSERT_EQ(0, cif_frame.CreateFrame(cif_buffer.get(), kCifWidth, kCifHeight,
+                                     kVideoRotation_0));
+
+  for (const Resolution& resolution : kResolutions) {
+    Scaler scaler;
+    ASSERT_EQ(0, scaler.Set(kCifWidth, kCifHeight, resolution.width,
+                            resolution.height, kI420, kI420, kScaleBilinear));
+    I420VideoFrame frames[kNumFlickerFrames];
+    for (int i = 0; i < kNumFlickerFrames; ++i) {
+      ASSERT_EQ(0, scaler.Scale(cif_frame, &frames[i]));
+      AddFlicker(kFlickerOffsets[i], &frames[i]);
+    }
+
+    VideoProcessingModule* vpm = VideoProcessingModule::Create(0);
+    I420VideoFrame frame;
+    int64_t stats_time_us = 0;
+    int64_t deflickering_time_us = 0;
+    int64_t brightness_time_us = 0;
+    for (int i = 0; i < kNumFrames; ++i) {
+      ASSERT_EQ(0, frame.CopyFrame(frames[i % kNumFlickerFrames]));
+      frame.set_timestamp(1 + i * 90000 / kFrameRate);
+      VideoProcessingModule::FrameStats stats;
+      int64_t start_us = TickTime::MicrosecondTimestamp();
+      ASSERT_EQ(0, vpm->GetFrameStats(&stats, frame));
+      int64_t end_us = TickTime::MicrosecondTimestamp();
+      stats_time_us += end_us - start_us;
+      start_us = end_us;
+      ASSERT_EQ(0, vpm->Deflickering(&frame, &stats));
+      end_us = TickTime::MicrosecondTimestamp();
+      deflickering_time_us += end_us - start_us;
+      start_us = end_us;
+      // Deflickering() keeps the stats up to date with the frame.
+      ASSERT_GE(vpm->BrightnessDetection(frame, stats), 0);
+      end_us = TickTime::MicrosecondTimestamp();
+      brightness_time_us += end_us - start_us;
+    }
+    VideoProcessingModule::Destroy(vpm);
+
+    const std::string trace = resolution.name;
+    test::PrintResult("frame_stats_time", "", trace,
+                      static_cast<double>(stats_time_us) / kNumFrames, "us",
+                      false);
+    test::PrintResult("deflickering_time", "", trace,
+                      static_cast<double>(deflickering_time_us) / kNumFrames,
+                      "us", false);
+    test::PrintResult("brightness_detection_time", "", trace,
+                      static_cast<double>(brightness_time_us) / kNumFrames,
+                      "us", false);
+    test::PrintResult("preprocessing_time", "", trace,
+                      static_cast<double>(stats_time_us + deflickering_time_us +
+                                          brightness_time_us) / kNumFrames,
+                      "us", false);
+  }
+}
+
+}  // namespace webrtc
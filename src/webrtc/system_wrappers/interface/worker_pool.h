@@ -0,0 +1,154 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// A fixed-size pool of worker threads used to fan independent pieces of work
+// out across cores and join them again (fork/join). The thread which hands
+// work to the pool takes part in it, so a pool created with zero threads runs
+// everything serially on the calling thread. Any number of threads may hand
+// work to the same pool at the same time; their batches share the workers.
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_WORKER_POOL_H_
+#define WEBRTC_SYSTEM_WRAPPERS_INTERFACE_WORKER_POOL_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/system_wrappers/interface/static_instance.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class ConditionVariableWrapper;
+class CriticalSectionWrapper;
+
+class WorkerPool {
+ public:
+  // A unit of work. Tasks in the same batch must be independent of each other
+  // since they may run concurrently and in any order.
+  class Task {
+   public:
+    virtual void Run() = 0;
+
+   protected:
+    virtual ~Task() {}
+  };
+
+  // The allocation free form of a task: called with the context and index
+  // which were passed to Run().
+  typedef void (*TaskFunction)(void* context, size_t index);
+
+  // Creates a pool with |num_threads| worker threads, named |thread_name|.
+  // Threads which fail to start are left out.
+  WorkerPool(size_t num_threads, const char* thread_name);
+  // As above, with the threads running at |priority|, e.g. to match that of
+  // a real-time thread which waits for their work.
+  WorkerPool(size_t num_threads,
+             const char* thread_name,
+             ThreadPriority priority);
+  ~WorkerPool();
+
+  // Returns the number of worker threads that is reasonable to create on this
+  // machine, i.e. one per core minus the one the caller is running on.
+  static size_t DefaultNumThreads();
+
+  // Returns the pool shared by the video processing code of the process,
+  // e.g. the scalers and the desktop differ. It is created on first use. Each
+  // call must be matched by a ReturnSharedPool().
+  static WorkerPool* GetSharedPool();
+  static void ReturnSharedPool();
+
+  // Runs all |num_tasks| tasks in |tasks| on the worker threads and the calling
+  // thread, and returns when every task has completed.
+  void RunTasks(Task* const* tasks, size_t num_tasks);
+
+  // Calls |function| with |context| and each index in [0, |num_tasks|), and
+  // returns when all calls have returned. Doesn't allocate memory.
+  void Run(TaskFunction function, void* context, size_t num_tasks);
+
+  // Calls |function| with |context| once on each thread: with index 0 on the
+  // calling thread and with index i on worker thread i, and returns when all
+  // calls have returned. Work which is split the same way on every call thus
+  // stays on the same threads, and in their caches. Calls are serialized with
+  // each other but share the workers with Run(). Doesn't allocate memory.
+  void RunOnEachThread(TaskFunction function, void* context);
+
+  size_t num_threads() const { return threads_.size(); }
+
+ protected:
+  static WorkerPool* CreateInstance();
+
+ private:
+  friend WorkerPool* GetStaticInstance<WorkerPool>(
+      CountOperation count_operation);
+
+  // A call of Run() or RunOnEachThread().
+  struct Job {
+    Job(TaskFunction function, void* context, size_t num_tasks);
+
+    const TaskFunction function;
+    void* const context;
+    const size_t num_tasks;
+    size_t next_task;
+    size_t num_done;
+    // The next job in the queue of |first_job_|.
+    Job* next;
+  };
+
+  struct Worker {
+    WorkerPool* pool;
+    // The index this worker's thread is called with by RunOnEachThread().
+    size_t index;
+    // The value of |each_count_| when this worker last ran its part of a
+    // RunOnEachThread() job.
+    uint32_t each_count;
+  };
+
+  static bool WorkerThread(void* obj);
+  bool Process(Worker* worker);
+
+  static void RunTask(void* context, size_t index);
+
+  // Runs the next unstarted task of |job|, which must have one, with |crit_|
+  // released. Takes |job| off the queue once all its tasks are started.
+  void RunNextTask(Job* job) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  // Runs task |index| of |job| with |crit_| released.
+  void RunTaskOfJob(Job* job, size_t index) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  const rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+  // Serializes RunOnEachThread() calls.
+  const rtc::scoped_ptr<CriticalSectionWrapper> each_crit_;
+  // Wakes the worker threads when there is new work.
+  const rtc::scoped_ptr<ConditionVariableWrapper> work_cond_;
+  // Signaled when the last task of a job has returned.
+  const rtc::scoped_ptr<ConditionVariableWrapper> done_cond_;
+  // Worker |i| runs on |threads_[i]|. Written before the threads start.
+  std::vector<Worker> workers_;
+  ScopedVector<ThreadWrapper> threads_;
+
+  // Jobs of Run() with unstarted tasks, oldest first.
+  Job* first_job_ GUARDED_BY(crit_);
+  Job* last_job_ GUARDED_BY(crit_);
+  // The current RunOnEachThread() job, or NULL.
+  Job* each_job_ GUARDED_BY(crit_);
+  uint32_t each_count_ GUARDED_BY(crit_);
+  bool stopping_ GUARDED_BY(crit_);
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerPool);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_INTERFACE_WORKER_POOL_H_
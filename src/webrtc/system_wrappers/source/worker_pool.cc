@@ -0,0 +1,192 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/worker_pool.h"
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/system_wrappers/interface/condition_variable_wrapper.h"
+#include "webrtc/system_wrappers/interface/cpu_info.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+
+namespace webrtc {
+
+// The shared pool runs memory bound work, e.g. scaling, which more threads
+// than this don't make faster.
+static const size_t kMaxSharedPoolThreads = 7;
+
+WorkerPool::Job::Job(TaskFunction function, void* context, size_t num_tasks)
+    : function(function),
+      context(context),
+      num_tasks(num_tasks),
+      next_task(0),
+      num_done(0),
+      next(NULL) {
+}
+
+WorkerPool::WorkerPool(size_t num_threads, const char* thread_name)
+    : WorkerPool(num_threads, thread_name, kNormalPriority) {
+}
+
+WorkerPool::WorkerPool(size_t num_threads,
+                       const char* thread_name,
+                       ThreadPriority priority)
+    : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      each_crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      work_cond_(ConditionVariableWrapper::CreateConditionVariable()),
+      done_cond_(ConditionVariableWrapper::CreateConditionVariable()),
+      first_job_(NULL),
+      last_job_(NULL),
+      each_job_(NULL),
+      each_count_(0),
+      stopping_(false) {
+  // The threads use the elements of |workers_|, so it must not reallocate.
+  workers_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    Worker worker = { this, i + 1, 0 };
+    workers_.push_back(worker);
+    rtc::scoped_ptr<ThreadWrapper> thread =
+        ThreadWrapper::CreateThread(&WorkerPool::WorkerThread,
+                                    &workers_.back(), thread_name);
+    if (!thread->Start()) {
+      workers_.pop_back();
+      break;
+    }
+    if (priority != kNormalPriority)
+      thread->SetPriority(priority);
+    threads_.push_back(thread.release());
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    CriticalSectionScoped cs(crit_.get());
+    stopping_ = true;
+    work_cond_->WakeAll();
+  }
+  for (ThreadWrapper* thread : threads_)
+    thread->Stop();
+}
+
+size_t WorkerPool::DefaultNumThreads() {
+  uint32_t num_cores = CpuInfo::DetectNumberOfCores();
+  return num_cores > 1 ? num_cores - 1 : 0;
+}
+
+WorkerPool* WorkerPool::GetSharedPool() {
+  return GetStaticInstance<WorkerPool>(kAddRef);
+}
+
+void WorkerPool::ReturnSharedPool() {
+  GetStaticInstance<WorkerPool>(kRelease);
+}
+
+WorkerPool* WorkerPool::CreateInstance() {
+  return new WorkerPool(std::min(DefaultNumThreads(), kMaxSharedPoolThreads),
+                        "SharedWorkerThread");
+}
+
+void WorkerPool::RunTasks(Task* const* tasks, size_t num_tasks) {
+  Run(&WorkerPool::RunTask, const_cast<Task**>(tasks), num_tasks);
+}
+
+void WorkerPool::Run(TaskFunction function, void* context, size_t num_tasks) {
+  if (threads_.empty() || num_tasks <= 1) {
+    for (size_t i = 0; i < num_tasks; ++i)
+      function(context, i);
+    return;
+  }
+  Job job(function, context, num_tasks);
+  CriticalSectionScoped cs(crit_.get());
+  if (last_job_)
+    last_job_->next = &job;
+  else
+    first_job_ = &job;
+  last_job_ = &job;
+  work_cond_->WakeAll();
+
+  // Help out instead of idling while the job is processed.
+  while (job.next_task < job.num_tasks)
+    RunNextTask(&job);
+  while (job.num_done < job.num_tasks)
+    done_cond_->SleepCS(*crit_);
+}
+
+void WorkerPool::RunOnEachThread(TaskFunction function, void* context) {
+  if (threads_.empty()) {
+    function(context, 0);
+    return;
+  }
+  CriticalSectionScoped each_cs(each_crit_.get());
+  Job job(function, context, threads_.size() + 1);
+  // Each worker takes its own index, so there is nothing to hand out.
+  job.next_task = job.num_tasks;
+  CriticalSectionScoped cs(crit_.get());
+  each_job_ = &job;
+  ++each_count_;
+  work_cond_->WakeAll();
+  RunTaskOfJob(&job, 0);
+  while (job.num_done < job.num_tasks)
+    done_cond_->SleepCS(*crit_);
+  each_job_ = NULL;
+}
+
+bool WorkerPool::WorkerThread(void* obj) {
+  Worker* worker = static_cast<Worker*>(obj);
+  return worker->pool->Process(worker);
+}
+
+bool WorkerPool::Process(Worker* worker) {
+  CriticalSectionScoped cs(crit_.get());
+  if (stopping_)
+    return false;
+  if (each_job_ && worker->each_count != each_count_) {
+    worker->each_count = each_count_;
+    RunTaskOfJob(each_job_, worker->index);
+  } else if (first_job_) {
+    RunNextTask(first_job_);
+  } else {
+    work_cond_->SleepCS(*crit_);
+  }
+  return true;
+}
+
+void WorkerPool::RunTask(void* context, size_t index) {
+  static_cast<Task**>(context)[index]->Run();
+}
+
+void WorkerPool::RunNextTask(Job* job) {
+  DCHECK_LT(job->next_task, job->num_tasks);
+  const size_t index = job->next_task++;
+  if (job->next_task == job->num_tasks) {
+    // All tasks are handed out; take the job off the queue.
+    Job* previous = NULL;
+    for (Job* it = first_job_; it != job; it = it->next)
+      previous = it;
+    if (previous)
+      previous->next = job->next;
+    else
+      first_job_ = job->next;
+    if (last_job_ == job)
+      last_job_ = previous;
+  }
+  RunTaskOfJob(job, index);
+}
+
+void WorkerPool::RunTaskOfJob(Job* job, size_t index) {
+  crit_->Leave();
+  job->function(job->context, index);
+  crit_->Enter();
+  if (++job->num_done == job->num_tasks)
+    done_cond_->WakeAll();
+}
+
+}  // namespace webrtc
@@ -0,0 +1,237 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/worker_pool.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+class CountingTask : public WorkerPool::Task {
+ public:
+  explicit CountingTask(Atomic32* total) : total_(total), runs_(0) {}
+  virtual ~CountingTask() {}
+
+  void Run() override {
+    ++runs_;
+    ++(*total_);
+  }
+
+  int runs() const { return runs_; }
+
+ private:
+  Atomic32* const total_;
+  int runs_;
+};
+
+class ThreadRecordingTask : public WorkerPool::Task {
+ public:
+  ThreadRecordingTask() : thread_id_(0) {}
+  virtual ~ThreadRecordingTask() {}
+
+  void Run() override { thread_id_ = ThreadWrapper::GetThreadId(); }
+
+  uint32_t thread_id() const { return thread_id_; }
+
+ private:
+  uint32_t thread_id_;
+};
+
+void RunCountingTasks(WorkerPool* pool, size_t num_tasks) {
+  Atomic32 total;
+  std::vector<CountingTask> tasks(num_tasks, CountingTask(&total));
+  std::vector<WorkerPool::Task*> task_ptrs;
+  for (CountingTask& task : tasks)
+    task_ptrs.push_back(&task);
+  pool->RunTasks(&task_ptrs[0], task_ptrs.size());
+  EXPECT_EQ(static_cast<int32_t>(num_tasks), total.Value());
+  for (const CountingTask& task : tasks)
+    EXPECT_EQ(1, task.runs());
+}
+
+void CountIndex(void* context, size_t index) {
+  ++static_cast<Atomic32*>(context)[index];
+}
+
+const size_t kMaxThreads = 8;
+
+// Records the thread each index of RunOnEachThread() was called on.
+struct EachThreadCalls {
+  EachThreadCalls() {
+    for (size_t i = 0; i < kMaxThreads; ++i)
+      thread_ids[i] = 0;
+  }
+
+  Atomic32 counts[kMaxThreads];
+  uint32_t thread_ids[kMaxThreads];
+};
+
+void RecordThread(void* context, size_t index) {
+  EachThreadCalls* calls = static_cast<EachThreadCalls*>(context);
+  ++calls->counts[index];
+  calls->thread_ids[index] = ThreadWrapper::GetThreadId();
+}
+
+// Runs |num_jobs_| jobs on a pool from its own thread.
+class JobRunner {
+ public:
+  JobRunner(WorkerPool* pool, int num_jobs)
+      : pool_(pool), num_jobs_(num_jobs) {}
+
+  static bool Run(void* obj) { return static_cast<JobRunner*>(obj)->Process(); }
+
+  int32_t count(size_t index) { return counts_[index].Value(); }
+
+  static const size_t kNumTasks = 16;
+
+ private:
+  bool Process() {
+    for (int i = 0; i < num_jobs_; ++i)
+      pool_->Run(&CountIndex, counts_, kNumTasks);
+    return false;
+  }
+
+  WorkerPool* const pool_;
+  const int num_jobs_;
+  Atomic32 counts_[kNumTasks];
+};
+
+}  // namespace
+
+TEST(WorkerPoolTest, RunsEveryTaskOnce) {
+  WorkerPool pool(4, "worker_pool_test");
+  EXPECT_EQ(4u, pool.num_threads());
+  RunCountingTasks(&pool, 1);
+  RunCountingTasks(&pool, 3);
+  RunCountingTasks(&pool, 100);
+}
+
+TEST(WorkerPoolTest, RunsTasksAtRealtimePriority) {
+  // Raising the priority may not be permitted, which leaves the threads at
+  // normal priority; they must run the tasks either way.
+  WorkerPool pool(3, "worker_pool_test", kRealtimePriority);
+  EXPECT_EQ(3u, pool.num_threads());
+  RunCountingTasks(&pool, 10);
+}
+
+TEST(WorkerPoolTest, RunsBatchesBackToBack) {
+  WorkerPool pool(2, "worker_pool_test");
+  for (int i = 0; i < 1000; ++i)
+    RunCountingTasks(&pool, 7);
+}
+
+TEST(WorkerPoolTest, ZeroThreadsRunsOnCallingThread) {
+  WorkerPool pool(0, "worker_pool_test");
+  ThreadRecordingTask tasks[3];
+  WorkerPool::Task* task_ptrs[] = {&tasks[0], &tasks[1], &tasks[2]};
+  pool.RunTasks(task_ptrs, 3);
+  for (const ThreadRecordingTask& task : tasks)
+    EXPECT_EQ(ThreadWrapper::GetThreadId(), task.thread_id());
+}
+
+TEST(WorkerPoolTest, CallsFunctionWithEveryIndexOnce) {
+  WorkerPool pool(3, "worker_pool_test");
+  Atomic32 counts[10];
+  pool.Run(&CountIndex, counts, 10);
+  for (Atomic32& count : counts)
+    EXPECT_EQ(1, count.Value());
+}
+
+TEST(WorkerPoolTest, RunsJobsOfSeveralThreadsAtOnce) {
+  const int kNumJobs = 500;
+  WorkerPool pool(2, "worker_pool_test");
+  ScopedVector<JobRunner> runners;
+  ScopedVector<ThreadWrapper> threads;
+  for (int i = 0; i < 3; ++i) {
+    runners.push_back(new JobRunner(&pool, kNumJobs));
+    threads.push_back(ThreadWrapper::CreateThread(&JobRunner::Run,
+                                                  runners.back(),
+                                                  "job_runner").release());
+    ASSERT_TRUE(threads.back()->Start());
+  }
+  for (ThreadWrapper* thread : threads)
+    EXPECT_TRUE(thread->Stop());
+  for (JobRunner* runner : runners) {
+    for (size_t i = 0; i < JobRunner::kNumTasks; ++i)
+      EXPECT_EQ(kNumJobs, runner->count(i));
+  }
+}
+
+TEST(WorkerPoolTest, RunsOnEachThreadOnce) {
+  WorkerPool pool(3, "worker_pool_test");
+  EachThreadCalls first;
+  pool.RunOnEachThread(&RecordThread, &first);
+  EXPECT_EQ(ThreadWrapper::GetThreadId(), first.thread_ids[0]);
+  for (size_t i = 0; i < kMaxThreads; ++i)
+    EXPECT_EQ(i < 4 ? 1 : 0, first.counts[i].Value());
+  for (size_t i = 1; i < 4; ++i) {
+    for (size_t j = 0; j < i; ++j)
+      EXPECT_NE(first.thread_ids[j], first.thread_ids[i]);
+  }
+
+  // Each index stays on its thread.
+  for (int repeat = 0; repeat < 100; ++repeat) {
+    EachThreadCalls calls;
+    pool.RunOnEachThread(&RecordThread, &calls);
+    for (size_t i = 0; i < 4; ++i) {
+      EXPECT_EQ(1, calls.counts[i].Value());
+      EXPECT_EQ(first.thread_ids[i], calls.thread_ids[i]);
+    }
+  }
+}
+
+TEST(WorkerPoolTest, RunsOnEachThreadWhileOtherJobsRun) {
+  const int kNumJobs = 200;
+  WorkerPool pool(2, "worker_pool_test");
+  JobRunner runner(&pool, kNumJobs);
+  rtc::scoped_ptr<ThreadWrapper> thread =
+      ThreadWrapper::CreateThread(&JobRunner::Run, &runner, "job_runner");
+  ASSERT_TRUE(thread->Start());
+  for (int repeat = 0; repeat < kNumJobs; ++repeat) {
+    EachThreadCalls calls;
+    pool.RunOnEachThread(&RecordThread, &calls);
+    for (size_t i = 0; i < 3; ++i)
+      EXPECT_EQ(1, calls.counts[i].Value());
+  }
+  EXPECT_TRUE(thread->Stop());
+  for (size_t i = 0; i < JobRunner::kNumTasks; ++i)
+    EXPECT_EQ(kNumJobs, runner.count(i));
+}
+
+TEST(WorkerPoolTest, RunsOnCallingThreadWithoutWorkers) {
+  WorkerPool pool(0, "worker_pool_test");
+  EachThreadCalls calls;
+  pool.RunOnEachThread(&RecordThread, &calls);
+  EXPECT_EQ(1, calls.counts[0].Value());
+  EXPECT_EQ(0, calls.counts[1].Value());
+  EXPECT_EQ(ThreadWrapper::GetThreadId(), calls.thread_ids[0]);
+}
+
+TEST(WorkerPoolTest, SharedPoolIsShared) {
+  WorkerPool* pool = WorkerPool::GetSharedPool();
+  EXPECT_EQ(pool, WorkerPool::GetSharedPool());
+  WorkerPool::ReturnSharedPool();
+  RunCountingTasks(pool, 20);
+  WorkerPool::ReturnSharedPool();
+}
+
+TEST(WorkerPoolTest, EmptyBatch) {
+  WorkerPool pool(2, "worker_pool_test");
+  pool.RunTasks(NULL, 0);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/test/mapped_file.h"
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "webrtc/base/scoped_ptr.h"
+
+namespace webrtc {
+namespace test {
+
+// Non-NULL address for the mapping of an empty file, which can't be mapped.
+static const uint8_t kEmptyFile[1] = {0};
+
+MappedFile::MappedFile()
+    : data_(NULL),
+      size_(0)
+#if defined(WEBRTC_WIN)
+      , file_(INVALID_HANDLE_VALUE),
+      mapping_(NULL)
+#endif
+{
+}
+
+#if defined(WEBRTC_WIN)
+
+MappedFile* MappedFile::Open(const std::string& filename) {
+  rtc::scoped_ptr<MappedFile> mapped_file(new MappedFile());
+  mapped_file->file_ = ::CreateFileA(
+      filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (mapped_file->file_ == INVALID_HANDLE_VALUE)
+    return NULL;
+  LARGE_INTEGER size;
+  if (!::GetFileSizeEx(mapped_file->file_, &size))
+    return NULL;
+  if (size.QuadPart == 0) {
+    mapped_file->data_ = kEmptyFile;
+    return mapped_file.release();
+  }
+  mapped_file->mapping_ = ::CreateFileMapping(mapped_file->file_, NULL,
+                                              PAGE_READONLY, 0, 0, NULL);
+  if (mapped_file->mapping_ == NULL)
+    return NULL;
+  mapped_file->data_ = static_cast<const uint8_t*>(
+      ::MapViewOfFile(mapped_file->mapping_, FILE_MAP_READ, 0, 0, 0));
+  if (mapped_file->data_ == NULL)
+    return NULL;
+  mapped_file->size_ = static_cast<size_t>(size.QuadPart);
+  return mapped_file.release();
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != NULL && data_ != kEmptyFile)
+    ::UnmapViewOfFile(data_);
+  if (mapping_ != NULL)
+    ::CloseHandle(mapping_);
+  if (file_ != INVALID_HANDLE_VALUE)
+    ::CloseHandle(file_);
+}
+
+#else
+
+MappedFile* MappedFile::Open(const std::string& filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return NULL;
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) {
+    close(fd);
+    return NULL;
+  }
+  rtc::scoped_ptr<MappedFile> mapped_file(new MappedFile());
+  if (file_stat.st_size == 0) {
+    close(fd);
+    mapped_file->data_ = kEmptyFile;
+    return mapped_file.release();
+  }
+  const size_t size = static_cast<size_t>(file_stat.st_size);
+  void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the file is closed.
+  close(fd);
+  if (data == MAP_FAILED)
+    return NULL;
+  // Packets are mostly read front to back; let the kernel read ahead.
+  madvise(data, size, MADV_SEQUENTIAL);
+  mapped_file->data_ = static_cast<const uint8_t*>(data);
+  mapped_file->size_ = size;
+  return mapped_file.release();
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != NULL && data_ != kEmptyFile)
+    munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+#endif
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,48 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef WEBRTC_TEST_MAPPED_FILE_H_
+#define WEBRTC_TEST_MAPPED_FILE_H_
+
+#include <string>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace test {
+
+// A read-only memory mapping of a whole file, for reading large files without
+// copying them through stdio buffers.
+class MappedFile {
+ public:
+  // Returns NULL if the file can't be opened or mapped.
+  static MappedFile* Open(const std::string& filename);
+
+  ~MappedFile();
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  MappedFile();
+
+  const uint8_t* data_;
+  size_t size_;
+#if defined(WEBRTC_WIN)
+  void* file_;
+  void* mapping_;
+#endif
+
+  DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+}  // namespace test
+}  // namespace webrtc
+#endif  // WEBRTC_TEST_MAPPED_FILE_H_
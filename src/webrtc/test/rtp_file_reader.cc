@@ -11,7 +11,9 @@
 #include "webrtc/test/rtp_file_reader.h"
 
 #include <stdio.h>
+#include <string.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
@@ -20,12 +22,13 @@
 #include "webrtc/base/format_macros.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
+#include "webrtc/test/mapped_file.h"
 
 namespace webrtc {
 namespace test {
 
 static const size_t kFirstLineLength = 40;
-static uint16_t kPacketHeaderSize = 8;
+static const uint16_t kPacketHeaderSize = 8;
 
 #if 1
 # define DEBUG_LOG(text)
@@ -43,109 +46,274 @@ static uint16_t kPacketHeaderSize = 8;
     }                                                  \
   } while (0)
 
-bool ReadUint32(uint32_t* out, FILE* file) {
-  *out = 0;
-  for (size_t i = 0; i < 4; ++i) {
-    *out <<= 8;
-    uint8_t tmp;
-    if (fread(&tmp, 1, sizeof(uint8_t), file) != sizeof(uint8_t))
-      return false;
-    *out |= tmp;
+static const char kIndexMagic[] = "RTPIDX2\n";
+// The index stores a checksum of this many bytes at the start and at the end
+// of the file it was built for, to catch files rewritten with the same size.
+static const size_t kIndexChecksumBlockSize = 4096;
+
+static uint32_t LoadUint32(const uint8_t* data) {
+  return (static_cast<uint32_t>(data[0]) << 24) |
+         (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) | data[3];
+}
+
+static uint16_t LoadUint16(const uint8_t* data) {
+  return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+// 64-bit FNV-1a.
+static uint64_t Checksum(uint64_t hash, const uint8_t* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= data[i];
+    hash *= 1099511628211ull;
   }
-  return true;
+  return hash;
 }
 
-bool ReadUint16(uint16_t* out, FILE* file) {
-  *out = 0;
-  for (size_t i = 0; i < 2; ++i) {
-    *out <<= 8;
-    uint8_t tmp;
-    if (fread(&tmp, 1, sizeof(uint8_t), file) != sizeof(uint8_t))
-      return false;
-    *out |= tmp;
+bool RtpFileReader::NextPacket(RtpPacket* packet) {
+  RtpPacketRef packet_ref;
+  if (!NextPacket(&packet_ref))
+    return false;
+  if (packet_ref.length > RtpPacket::kMaxPacketBufferSize) {
+    FATAL() << "Packet is too large to fit: " << packet_ref.length
+            << " bytes vs " << RtpPacket::kMaxPacketBufferSize
+            << " bytes allocated. Consider increasing the buffer "
+               "size";
   }
+  memcpy(packet->data, packet_ref.data, packet_ref.length);
+  packet->length = packet_ref.length;
+  packet->original_length = packet_ref.original_length;
+  packet->time_ms = packet_ref.time_ms;
   return true;
 }
 
+// Maps the file, and reads packets from it either in file order or, once the
+// index is needed, in index order.
 class RtpFileReaderImpl : public RtpFileReader {
  public:
-  virtual bool Init(const std::string& filename) = 0;
-};
+  RtpFileReaderImpl()
+      : position_(0),
+        packet_number_(0),
+        use_index_(false),
+        next_index_entry_(0),
+        ssrc_filter_(0) {}
+  virtual ~RtpFileReaderImpl() {}
+
+  using RtpFileReader::NextPacket;
+
+  bool Init(const std::string& filename, const std::string& index_filename) {
+    index_filename_ = index_filename;
+    file_.reset(MappedFile::Open(filename));
+    if (!file_) {
+      printf("ERROR: Can't open file: %s\n", filename.c_str());
+      return false;
+    }
+    if (!ReadFileHeader(&position_))
+      return false;
+    first_position_ = position_;
+    return true;
+  }
 
-class InterleavedRtpFileReader : public RtpFileReaderImpl {
- public:
-  virtual ~InterleavedRtpFileReader() {
-    if (file_ != NULL) {
-      fclose(file_);
-      file_ = NULL;
+  bool NextPacket(RtpPacketRef* packet) override {
+    if (!use_index_) {
+      if (!ReadPacketAt(&position_, packet_number_, packet))
+        return false;
+      ++packet_number_;
+      return true;
+    }
+    while (next_index_entry_ < index_.size()) {
+      const size_t packet_number = next_index_entry_++;
+      const IndexEntry& entry = index_[packet_number];
+      if (ssrc_filter_ != 0 && entry.ssrc != ssrc_filter_)
+        continue;
+      uint64_t position = entry.position;
+      return ReadPacketAt(&position, packet_number, packet);
+    }
+    return false;
+  }
+
+  bool SeekToTime(uint32_t time_ms) override {
+    StartUsingIndex();
+    // Packets are stored in the order they were captured, so their times
+    // don't decrease.
+    std::vector<IndexEntry>::const_iterator it = std::lower_bound(
+        index_.begin(), index_.end(), time_ms, &EntryTimeLessThan);
+    next_index_entry_ = it - index_.begin();
+    return it != index_.end();
+  }
+
+  void SetSsrcFilter(uint32_t ssrc) override {
+    if (ssrc != 0)
+      StartUsingIndex();
+    ssrc_filter_ = ssrc;
+  }
+
+ protected:
+  // Parses the file header, and returns the position of the first packet.
+  virtual bool ReadFileHeader(uint64_t* first_position) = 0;
+
+  // Reads the |packet_number|th packet, found at |*position|, and advances
+  // |*position| to the next packet.
+  virtual bool ReadPacketAt(uint64_t* position,
+                            size_t packet_number,
+                            RtpPacketRef* packet) = 0;
+
+  const uint8_t* data() const { return file_->data(); }
+  size_t size() const { return file_->size(); }
+
+ private:
+  // Written to the index file in host byte order.
+  struct IndexEntry {
+    uint64_t position;
+    uint32_t time_ms;
+    uint32_t ssrc;  // Zero for RTCP packets.
+  };
+
+  static bool EntryTimeLessThan(const IndexEntry& entry, uint32_t time_ms) {
+    return entry.time_ms < time_ms;
+  }
+
+  void StartUsingIndex() {
+    if (use_index_)
+      return;
+    if (index_filename_.empty() || !LoadIndex()) {
+      BuildIndex();
+      if (!index_filename_.empty())
+        SaveIndex();
+    }
+    use_index_ = true;
+    // Continue from where reading in file order left off.
+    next_index_entry_ = std::min(packet_number_, index_.size());
+  }
+
+  void BuildIndex() {
+    index_.clear();
+    uint64_t position = first_position_;
+    RtpPacketRef packet;
+    while (true) {
+      IndexEntry entry;
+      entry.position = position;
+      if (!ReadPacketAt(&position, index_.size(), &packet))
+        break;
+      entry.time_ms = packet.time_ms;
+      entry.ssrc = 0;
+      RtpUtility::RtpHeaderParser rtp_parser(packet.data, packet.length);
+      if (packet.length >= 12 && !rtp_parser.RTCP())
+        entry.ssrc = LoadUint32(&packet.data[8]);
+      index_.push_back(entry);
     }
   }
 
-  virtual bool Init(const std::string& filename) {
-    file_ = fopen(filename.c_str(), "rb");
-    if (file_ == NULL) {
-      printf("ERROR: Can't open file: %s\n", filename.c_str());
+  // Identifies the contents of the file the index is built for.
+  uint64_t FileChecksum() const {
+    const size_t block_size = std::min(kIndexChecksumBlockSize, size());
+    uint64_t hash = Checksum(14695981039346656037ull, data(), block_size);
+    return Checksum(hash, data() + size() - block_size, block_size);
+  }
+
+  bool LoadIndex() {
+    rtc::scoped_ptr<MappedFile> index_file(MappedFile::Open(index_filename_));
+    if (!index_file)
+      return false;
+    const size_t kHeaderSize = sizeof(kIndexMagic) - 1 + 3 * sizeof(uint64_t);
+    if (index_file->size() < kHeaderSize ||
+        memcmp(index_file->data(), kIndexMagic, sizeof(kIndexMagic) - 1) != 0) {
       return false;
     }
+    uint64_t header[3];  // File size, file checksum, number of entries.
+    memcpy(header, index_file->data() + sizeof(kIndexMagic) - 1,
+           sizeof(header));
+    if (header[0] != size() || header[1] != FileChecksum() ||
+        (index_file->size() - kHeaderSize) / sizeof(IndexEntry) != header[2] ||
+        (index_file->size() - kHeaderSize) % sizeof(IndexEntry) != 0) {
+      // Stale or truncated.
+      return false;
+    }
+    index_.resize(static_cast<size_t>(header[2]));
+    if (!index_.empty()) {
+      memcpy(&index_[0], index_file->data() + kHeaderSize,
+             index_.size() * sizeof(IndexEntry));
+    }
     return true;
   }
-  virtual bool NextPacket(RtpPacket* packet) {
-    assert(file_ != NULL);
-    packet->length = RtpPacket::kMaxPacketBufferSize;
-    uint32_t len = 0;
-    TRY(ReadUint32(&len, file_));
-    if (packet->length < len) {
-      FATAL() << "Packet is too large to fit: " << len << " bytes vs "
-              << packet->length
-              << " bytes allocated. Consider increasing the buffer "
-                 "size";
-    }
-    if (fread(packet->data, 1, len, file_) != len)
-      return false;
 
+  void SaveIndex() const {
+    // The index is only a cache, so failing to save it is fine.
+    FILE* file = fopen(index_filename_.c_str(), "wb");
+    if (file == NULL)
+      return;
+    const uint64_t header[3] = {size(), FileChecksum(), index_.size()};
+    fwrite(kIndexMagic, 1, sizeof(kIndexMagic) - 1, file);
+    fwrite(header, sizeof(header), 1, file);
+    if (!index_.empty())
+      fwrite(&index_[0], sizeof(IndexEntry), index_.size(), file);
+    fclose(file);
+  }
+
+  // Empty if the index isn't cached in a file.
+  std::string index_filename_;
+  rtc::scoped_ptr<MappedFile> file_;
+  uint64_t first_position_;
+  uint64_t position_;
+  size_t packet_number_;
+
+  std::vector<IndexEntry> index_;
+  bool use_index_;
+  size_t next_index_entry_;
+  uint32_t ssrc_filter_;
+};
+
+class InterleavedRtpFileReader : public RtpFileReaderImpl {
+ public:
+  InterleavedRtpFileReader() {}
+
+ protected:
+  bool ReadFileHeader(uint64_t* first_position) override {
+    *first_position = 0;
+    return true;
+  }
+
+  bool ReadPacketAt(uint64_t* position,
+                    size_t packet_number,
+                    RtpPacketRef* packet) override {
+    TRY(*position + 4 <= size());
+    uint32_t len = LoadUint32(data() + *position);
+    TRY(*position + 4 + len <= size());
+
+    packet->data = data() + *position + 4;
     packet->length = len;
     packet->original_length = len;
-    packet->time_ms = time_ms_;
-    time_ms_ += 5;
+    packet->time_ms = static_cast<uint32_t>(5 * packet_number);
+    *position += 4 + len;
     return true;
   }
 
  private:
-  FILE* file_ = NULL;
-  int64_t time_ms_ = 0;
+  DISALLOW_COPY_AND_ASSIGN(InterleavedRtpFileReader);
 };
 
 // Read RTP packets from file in rtpdump format, as documented at:
 // http://www.cs.columbia.edu/irt/software/rtptools/
 class RtpDumpReader : public RtpFileReaderImpl {
  public:
-  RtpDumpReader() : file_(NULL) {}
-  virtual ~RtpDumpReader() {
-    if (file_ != NULL) {
-      fclose(file_);
-      file_ = NULL;
-    }
-  }
-
-  bool Init(const std::string& filename) {
-    file_ = fopen(filename.c_str(), "rb");
-    if (file_ == NULL) {
-      printf("ERROR: Can't open file: %s\n", filename.c_str());
-      return false;
-    }
-
-    char firstline[kFirstLineLength + 1] = {0};
-    if (fgets(firstline, kFirstLineLength, file_) == NULL) {
-      DEBUG_LOG("ERROR: Can't read from file\n");
-      return false;
+  RtpDumpReader() {}
+
+ protected:
+  bool ReadFileHeader(uint64_t* first_position) override {
+    // The first line, as read by fgets() with a buffer of kFirstLineLength.
+    size_t line_length = 0;
+    while (line_length < std::min(kFirstLineLength - 1, size())) {
+      if (data()[line_length++] == '\n')
+        break;
     }
-    if (strncmp(firstline, "#!rtpplay", 9) == 0) {
-      if (strncmp(firstline, "#!rtpplay1.0", 12) != 0) {
+    std::string firstline(reinterpret_cast<const char*>(data()), line_length);
+    if (firstline.compare(0, 9, "#!rtpplay") == 0) {
+      if (firstline.compare(0, 12, "#!rtpplay1.0") != 0) {
         DEBUG_LOG("ERROR: wrong rtpplay version, must be 1.0\n");
         return false;
       }
-    } else if (strncmp(firstline, "#!RTPencode", 11) == 0) {
-      if (strncmp(firstline, "#!RTPencode1.0", 14) != 0) {
+    } else if (firstline.compare(0, 11, "#!RTPencode") == 0) {
+      if (firstline.compare(0, 14, "#!RTPencode1.0") != 0) {
         DEBUG_LOG("ERROR: wrong RTPencode version, must be 1.0\n");
         return false;
       }
@@ -154,52 +322,35 @@ class RtpDumpReader : public RtpFileReaderImpl {
       return false;
     }
 
-    uint32_t start_sec;
-    uint32_t start_usec;
-    uint32_t source;
-    uint16_t port;
-    uint16_t padding;
-    TRY(ReadUint32(&start_sec, file_));
-    TRY(ReadUint32(&start_usec, file_));
-    TRY(ReadUint32(&source, file_));
-    TRY(ReadUint16(&port, file_));
-    TRY(ReadUint16(&padding, file_));
-
+    // Skip start_sec, start_usec, source, port and padding.
+    static const size_t kFileHeaderSize = 4 + 4 + 4 + 2 + 2;
+    TRY(line_length + kFileHeaderSize <= size());
+    *first_position = line_length + kFileHeaderSize;
     return true;
   }
 
-  bool NextPacket(RtpPacket* packet) override {
-    uint8_t* rtp_data = packet->data;
-    packet->length = RtpPacket::kMaxPacketBufferSize;
-
-    uint16_t len;
-    uint16_t plen;
-    uint32_t offset;
-    TRY(ReadUint16(&len, file_));
-    TRY(ReadUint16(&plen, file_));
-    TRY(ReadUint32(&offset, file_));
+  bool ReadPacketAt(uint64_t* position,
+                    size_t packet_number,
+                    RtpPacketRef* packet) override {
+    TRY(*position + kPacketHeaderSize <= size());
+    const uint8_t* header = data() + *position;
+    uint16_t len = LoadUint16(header);
+    uint16_t plen = LoadUint16(header + 2);
+    uint32_t offset = LoadUint32(header + 4);
 
     // Use 'len' here because a 'plen' of 0 specifies rtcp.
-    len -= kPacketHeaderSize;
-    if (packet->length < len) {
-      FATAL() << "Packet is too large to fit: " << len << " bytes vs "
-              << packet->length
-              << " bytes allocated. Consider increasing the buffer "
-                 "size";
-    }
-    if (fread(rtp_data, 1, len, file_) != len) {
-      return false;
-    }
+    TRY(len >= kPacketHeaderSize);
+    TRY(*position + len <= size());
 
-    packet->length = len;
+    packet->data = header + kPacketHeaderSize;
+    packet->length = len - kPacketHeaderSize;
     packet->original_length = plen;
     packet->time_ms = offset;
+    *position += len;
     return true;
   }
 
  private:
-  FILE* file_;
-
   DISALLOW_COPY_AND_ASSIGN(RtpDumpReader);
 };
 
@@ -245,46 +396,50 @@ const uint32_t kPcapBOMNoSwapOrder = 0xa1b2c3d4UL;
 class PcapReader : public RtpFileReaderImpl {
  public:
   PcapReader()
-    : file_(NULL),
+    : read_pos_(0),
+      eof_(false),
       swap_pcap_byte_order_(false),
 #ifdef WEBRTC_ARCH_BIG_ENDIAN
       swap_network_byte_order_(false),
 #else
       swap_network_byte_order_(true),
 #endif
-      read_buffer_(),
       packets_by_ssrc_(),
-      packets_(),
-      next_packet_it_() {
+      packets_() {
   }
 
-  virtual ~PcapReader() {
-    if (file_ != NULL) {
-      fclose(file_);
-      file_ = NULL;
-    }
+ protected:
+  // The packets are identified by their number in |packets_|.
+  bool ReadFileHeader(uint64_t* first_position) override {
+    *first_position = 0;
+    return Initialize() == kResultSuccess;
   }
 
-  bool Init(const std::string& filename) override {
-    return Initialize(filename) == kResultSuccess;
+  bool ReadPacketAt(uint64_t* position,
+                    size_t packet_number,
+                    RtpPacketRef* packet) override {
+    if (*position >= packets_.size())
+      return false;
+    const RtpPacketMarker& marker = packets_[static_cast<size_t>(*position)];
+    packet->data = data() + marker.pos_in_file;
+    packet->length = marker.payload_length;
+    packet->original_length = marker.payload_length;
+    packet->time_ms = marker.time_offset_ms;
+    ++*position;
+    return true;
   }
 
-  int Initialize(const std::string& filename) {
-    file_ = fopen(filename.c_str(), "rb");
-    if (file_ == NULL) {
-      printf("ERROR: Can't open file: %s\n", filename.c_str());
-      return kResultFail;
-    }
-
+ private:
+  int Initialize() {
     if (ReadGlobalHeader() < 0) {
       return kResultFail;
     }
 
     int total_packet_count = 0;
     uint32_t stream_start_ms = 0;
-    int32_t next_packet_pos = ftell(file_);
+    size_t next_packet_pos = read_pos_;
     for (;;) {
-      TRY_PCAP(fseek(file_, next_packet_pos, SEEK_SET));
+      read_pos_ = next_packet_pos;
       int result = ReadPacket(&next_packet_pos, stream_start_ms,
                               ++total_packet_count);
       if (result == kResultFail) {
@@ -297,7 +452,7 @@ class PcapReader : public RtpFileReaderImpl {
       }
     }
 
-    if (feof(file_) == 0) {
+    if (!eof_) {
       printf("Failed reading file!\n");
       return kResultFail;
     }
@@ -330,40 +485,9 @@ class PcapReader : public RtpFileReaderImpl {
     // - Can also use srcip:port->dstip:port pairs, assuming few SSRC collisions
     //   for up/down streams.
 
-    next_packet_it_ = packets_.begin();
     return kResultSuccess;
   }
 
-  bool NextPacket(RtpPacket* packet) override {
-    uint32_t length = RtpPacket::kMaxPacketBufferSize;
-    if (NextPcap(packet->data, &length, &packet->time_ms) != kResultSuccess)
-      return false;
-    packet->length = static_cast<size_t>(length);
-    packet->original_length = packet->length;
-    return true;
-  }
-
-  virtual int NextPcap(uint8_t* data, uint32_t* length, uint32_t* time_ms) {
-    assert(data);
-    assert(length);
-    assert(time_ms);
-
-    if (next_packet_it_ == packets_.end()) {
-      return -1;
-    }
-    if (*length < next_packet_it_->payload_length) {
-      return -1;
-    }
-    TRY_PCAP(fseek(file_, next_packet_it_->pos_in_file, SEEK_SET));
-    TRY_PCAP(Read(data, next_packet_it_->payload_length));
-    *length = next_packet_it_->payload_length;
-    *time_ms = next_packet_it_->time_offset_ms;
-    next_packet_it_++;
-
-    return 0;
-  }
-
- private:
   // A marker of an RTP packet within the file.
   struct RtpPacketMarker {
     uint32_t packet_number;   // One-based index (like in WireShark)
@@ -373,7 +497,7 @@ class PcapReader : public RtpFileReaderImpl {
     uint16_t source_port;
     uint16_t dest_port;
     RTPHeader rtp_header;
-    int32_t pos_in_file;      // Byte offset of payload from start of file.
+    size_t pos_in_file;       // Byte offset of payload from start of file.
     uint32_t payload_length;
   };
 
@@ -419,7 +543,7 @@ class PcapReader : public RtpFileReaderImpl {
     return kResultSuccess;
   }
 
-  int ReadPacket(int32_t* next_packet_pos, uint32_t stream_start_ms,
+  int ReadPacket(size_t* next_packet_pos, uint32_t stream_start_ms,
                  uint32_t number) {
     assert(next_packet_pos);
 
@@ -432,21 +556,26 @@ class PcapReader : public RtpFileReaderImpl {
     TRY_PCAP(Read(&incl_len, false));
     TRY_PCAP(Read(&orig_len, false));
 
-    *next_packet_pos = ftell(file_) + incl_len;
+    *next_packet_pos = read_pos_ + incl_len;
 
     RtpPacketMarker marker = {0};
     marker.packet_number = number;
     marker.time_offset_ms = CalcTimeDelta(ts_sec, ts_usec, stream_start_ms);
     TRY_PCAP(ReadPacketHeader(&marker));
-    marker.pos_in_file = ftell(file_);
+    marker.pos_in_file = read_pos_;
 
-    if (marker.payload_length > sizeof(read_buffer_)) {
+    if (marker.payload_length > kMaxReadBufferSize) {
       printf("Packet too large!\n");
       return kResultFail;
     }
-    TRY_PCAP(Read(read_buffer_, marker.payload_length));
+    TRY_PCAP(Skip(marker.payload_length));
+    if (read_pos_ > size()) {
+      eof_ = true;
+      return kResultFail;
+    }
 
-    RtpUtility::RtpHeaderParser rtp_parser(read_buffer_, marker.payload_length);
+    RtpUtility::RtpHeaderParser rtp_parser(data() + marker.pos_in_file,
+                                           marker.payload_length);
     if (rtp_parser.RTCP()) {
       rtp_parser.ParseRtcp(&marker.rtp_header);
       packets_.push_back(marker);
@@ -465,7 +594,7 @@ class PcapReader : public RtpFileReaderImpl {
   }
 
   int ReadPacketHeader(RtpPacketMarker* marker) {
-    int32_t file_pos = ftell(file_);
+    size_t file_pos = read_pos_;
 
     // Check for BSD null/loopback frame header. The header is just 4 bytes in
     // native byte order, so we check for both versions as we don't care about
@@ -481,7 +610,7 @@ class PcapReader : public RtpFileReaderImpl {
       }
     }
 
-    TRY_PCAP(fseek(file_, file_pos, SEEK_SET));
+    read_pos_ = file_pos;
 
     // Check for Ethernet II, IP frame header.
     uint16_t type;
@@ -564,11 +693,24 @@ class PcapReader : public RtpFileReaderImpl {
     return kResultSuccess;
   }
 
+  // Reads |count| bytes at the read position, or flags the end of the file.
+  const uint8_t* ReadBytes(size_t count) {
+    if (read_pos_ > size() || size() - read_pos_ < count) {
+      eof_ = true;
+      return NULL;
+    }
+    const uint8_t* bytes = data() + read_pos_;
+    read_pos_ += count;
+    return bytes;
+  }
+
   int Read(uint32_t* out, bool expect_network_order) {
     uint32_t tmp = 0;
-    if (fread(&tmp, 1, sizeof(uint32_t), file_) != sizeof(uint32_t)) {
+    const uint8_t* bytes = ReadBytes(sizeof(tmp));
+    if (bytes == NULL) {
       return kResultFail;
     }
+    memcpy(&tmp, bytes, sizeof(tmp));
     if ((!expect_network_order && swap_pcap_byte_order_) ||
         (expect_network_order && swap_network_byte_order_)) {
       tmp = ((tmp >> 24) & 0x000000ff) | (tmp << 24) |
@@ -580,9 +722,11 @@ class PcapReader : public RtpFileReaderImpl {
 
   int Read(uint16_t* out, bool expect_network_order) {
     uint16_t tmp = 0;
-    if (fread(&tmp, 1, sizeof(uint16_t), file_) != sizeof(uint16_t)) {
+    const uint8_t* bytes = ReadBytes(sizeof(tmp));
+    if (bytes == NULL) {
       return kResultFail;
     }
+    memcpy(&tmp, bytes, sizeof(tmp));
     if ((!expect_network_order && swap_pcap_byte_order_) ||
         (expect_network_order && swap_network_byte_order_)) {
       tmp = ((tmp >> 8) & 0x00ff) | (tmp << 8);
@@ -591,48 +735,40 @@ class PcapReader : public RtpFileReaderImpl {
     return kResultSuccess;
   }
 
-  int Read(uint8_t* out, uint32_t count) {
-    if (fread(out, 1, count, file_) != count) {
-      return kResultFail;
-    }
-    return kResultSuccess;
-  }
-
   int Read(int32_t* out, bool expect_network_order) {
-    int32_t tmp = 0;
-    if (fread(&tmp, 1, sizeof(uint32_t), file_) != sizeof(uint32_t)) {
+    uint32_t tmp = 0;
+    if (Read(&tmp, expect_network_order) != kResultSuccess) {
       return kResultFail;
     }
-    if ((!expect_network_order && swap_pcap_byte_order_) ||
-        (expect_network_order && swap_network_byte_order_)) {
-      tmp = ((tmp >> 24) & 0x000000ff) | (tmp << 24) |
-          ((tmp >> 8) & 0x0000ff00) | ((tmp << 8) & 0x00ff0000);
-    }
-    *out = tmp;
+    *out = static_cast<int32_t>(tmp);
     return kResultSuccess;
   }
 
+  // Seeking past the end is allowed, like fseek(); the next read fails.
   int Skip(uint32_t length) {
-    if (fseek(file_, length, SEEK_CUR) != 0) {
-      return kResultFail;
-    }
+    read_pos_ += length;
     return kResultSuccess;
   }
 
-  FILE* file_;
+  size_t read_pos_;
+  bool eof_;
   bool swap_pcap_byte_order_;
   const bool swap_network_byte_order_;
-  uint8_t read_buffer_[kMaxReadBufferSize];
 
   SsrcMap packets_by_ssrc_;
   std::vector<RtpPacketMarker> packets_;
-  PacketIterator next_packet_it_;
 
   DISALLOW_COPY_AND_ASSIGN(PcapReader);
 };
 
 RtpFileReader* RtpFileReader::Create(FileFormat format,
                                      const std::string& filename) {
+  return Create(format, filename, "");
+}
+
+RtpFileReader* RtpFileReader::Create(FileFormat format,
+                                     const std::string& filename,
+                                     const std::string& index_filename) {
   RtpFileReaderImpl* reader = NULL;
   switch (format) {
     case kPcap:
@@ -645,7 +781,7 @@ RtpFileReader* RtpFileReader::Create(FileFormat format,
       reader = new InterleavedRtpFileReader();
       break;
   }
-  if (!reader->Init(filename)) {
+  if (!reader->Init(filename, index_filename)) {
     delete reader;
     return NULL;
   }
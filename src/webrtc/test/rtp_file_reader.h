@@ -30,6 +30,18 @@ struct RtpPacket {
   uint32_t time_ms;
 };
 
+// A packet read without copying. |data| points into the file mapping of the
+// reader which returned it, and stays valid for the lifetime of that reader.
+struct RtpPacketRef {
+  RtpPacketRef() : data(NULL), length(0), original_length(0), time_ms(0) {}
+
+  const uint8_t* data;
+  size_t length;
+  size_t original_length;
+  uint32_t time_ms;
+};
+
+// Reads packets from a memory mapped file.
 class RtpFileReader {
  public:
   enum FileFormat { kPcap, kRtpDump, kLengthPacketInterleaved };
@@ -37,8 +49,28 @@ class RtpFileReader {
   virtual ~RtpFileReader() {}
   static RtpFileReader* Create(FileFormat format,
                                const std::string& filename);
+  // As above, but caches the index used for seeking and filtering in
+  // |index_filename|, e.g. in the output directory. The index is loaded from
+  // there if it was saved for the same contents of |filename|, and saved there
+  // once it has been built otherwise.
+  static RtpFileReader* Create(FileFormat format,
+                               const std::string& filename,
+                               const std::string& index_filename);
+
+  // Copies the next packet into |packet|.
+  bool NextPacket(RtpPacket* packet);
+
+  // Returns the next packet without copying it.
+  virtual bool NextPacket(RtpPacketRef* packet) = 0;
+
+  // Makes the next packet returned the first one with a time at or after
+  // |time_ms|. Returns false if there is no such packet. Seeking and filtering
+  // use an index of the packet times and SSRCs, which is built on first use.
+  virtual bool SeekToTime(uint32_t time_ms) = 0;
 
-  virtual bool NextPacket(RtpPacket* packet) = 0;
+  // Only returns the RTP packets of |ssrc| from now on, skipping over other
+  // packets without reading them. Zero returns all packets again.
+  virtual void SetSsrcFilter(uint32_t ssrc) = 0;
 };
 }  // namespace test
 }  // namespace webrtc
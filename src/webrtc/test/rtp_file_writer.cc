@@ -13,6 +13,7 @@
 #include <stdio.h>
 
 #include <string>
+#include <vector>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/constructormagic.h"
@@ -22,6 +23,18 @@ namespace test {
 
 static const uint16_t kPacketHeaderSize = 8;
 static const char kFirstLine[] = "#!rtpplay1.0 0.0.0.0/0\n";
+// Writes are collected into chunks of this size, so that writing a long dump
+// costs a few large sequential writes rather than several per packet.
+static const size_t kWriteBufferSize = 1 << 20;
+
+bool RtpFileWriter::WritePacket(const RtpPacket* packet) {
+  RtpPacketRef packet_ref;
+  packet_ref.data = packet->data;
+  packet_ref.length = packet->length;
+  packet_ref.original_length = packet->original_length;
+  packet_ref.time_ms = packet->time_ms;
+  return WritePacket(packet_ref);
+}
 
 // Write RTP packets to file in rtpdump format, as documented at:
 // http://www.cs.columbia.edu/irt/software/rtptools/
@@ -29,63 +42,74 @@ class RtpDumpWriter : public RtpFileWriter {
  public:
   explicit RtpDumpWriter(FILE* file) : file_(file) {
     CHECK(file_ != NULL);
+    // The file's own stdio buffer would only add a copy.
+    setvbuf(file_, NULL, _IONBF, 0);
+    buffer_.reserve(kWriteBufferSize);
     Init();
   }
   virtual ~RtpDumpWriter() {
     if (file_ != NULL) {
-      fclose(file_);
+      // Packets which WritePacket() accepted may still be lost here.
+      const bool flushed = Flush();
+      if (fclose(file_) != 0 || !flushed)
+        printf("ERROR: Can't write the end of the RTP dump.\n");
       file_ = NULL;
     }
   }
 
-  bool WritePacket(const RtpPacket* packet) override {
-    uint16_t len = static_cast<uint16_t>(packet->length + kPacketHeaderSize);
-    CHECK_GE(packet->original_length, packet->length);
-    uint16_t plen = static_cast<uint16_t>(packet->original_length);
-    uint32_t offset = packet->time_ms;
-    CHECK(WriteUint16(len));
-    CHECK(WriteUint16(plen));
-    CHECK(WriteUint32(offset));
-    return fwrite(packet->data, sizeof(uint8_t), packet->length, file_) ==
-           packet->length;
+  bool WritePacket(const RtpPacketRef& packet) override {
+    uint16_t len = static_cast<uint16_t>(packet.length + kPacketHeaderSize);
+    CHECK_GE(packet.original_length, packet.length);
+    uint16_t plen = static_cast<uint16_t>(packet.original_length);
+    uint32_t offset = packet.time_ms;
+    if (buffer_.size() + kPacketHeaderSize + packet.length > kWriteBufferSize &&
+        !Flush()) {
+      return false;
+    }
+    WriteUint16(len);
+    WriteUint16(plen);
+    WriteUint32(offset);
+    buffer_.insert(buffer_.end(), packet.data, packet.data + packet.length);
+    return true;
   }
 
  private:
   bool Init() {
-    fprintf(file_, "%s", kFirstLine);
+    buffer_.insert(buffer_.end(), kFirstLine,
+                   kFirstLine + sizeof(kFirstLine) - 1);
 
-    CHECK(WriteUint32(0));
-    CHECK(WriteUint32(0));
-    CHECK(WriteUint32(0));
-    CHECK(WriteUint16(0));
-    CHECK(WriteUint16(0));
+    WriteUint32(0);
+    WriteUint32(0);
+    WriteUint32(0);
+    WriteUint16(0);
+    WriteUint16(0);
 
     return true;
   }
 
-  bool WriteUint32(uint32_t in) {
+  bool Flush() {
+    if (buffer_.empty())
+      return true;
+    const size_t written =
+        fwrite(&buffer_[0], sizeof(uint8_t), buffer_.size(), file_);
+    const bool success = written == buffer_.size();
+    buffer_.clear();
+    return success;
+  }
+
+  void WriteUint32(uint32_t in) {
     // Loop through shifts = {24, 16, 8, 0}.
-    for (int shifts = 24; shifts >= 0; shifts -= 8) {
-      uint8_t tmp = static_cast<uint8_t>((in >> shifts) & 0xFF);
-      if (fwrite(&tmp, sizeof(uint8_t), 1, file_) != 1)
-        return false;
-    }
-    return true;
+    for (int shifts = 24; shifts >= 0; shifts -= 8)
+      buffer_.push_back(static_cast<uint8_t>((in >> shifts) & 0xFF));
   }
 
-  bool WriteUint16(uint16_t in) {
-    // Write 8 MSBs.
-    uint8_t tmp = static_cast<uint8_t>((in >> 8) & 0xFF);
-    if (fwrite(&tmp, sizeof(uint8_t), 1, file_) != 1)
-      return false;
-    // Write 8 LSBs.
-    tmp = static_cast<uint8_t>(in & 0xFF);
-    if (fwrite(&tmp, sizeof(uint8_t), 1, file_) != 1)
-      return false;
-    return true;
+  void WriteUint16(uint16_t in) {
+    buffer_.push_back(static_cast<uint8_t>((in >> 8) & 0xFF));
+    buffer_.push_back(static_cast<uint8_t>(in & 0xFF));
   }
 
   FILE* file_;
+  std::vector<uint8_t> buffer_;
 
   DISALLOW_COPY_AND_ASSIGN(RtpDumpWriter);
 };
@@ -26,7 +26,13 @@ class RtpFileWriter {
   virtual ~RtpFileWriter() {}
   static RtpFileWriter* Create(FileFormat format, const std::string& filename);
 
-  virtual bool WritePacket(const RtpPacket* packet) = 0;
+  bool WritePacket(const RtpPacket* packet);
+
+  // Packets are buffered and written in large chunks; the file is complete
+  // once the writer is deleted. Returns false if writing an earlier chunk
+  // failed, so true only means that |packet| was buffered. A failure to write
+  // the last chunk is printed when the writer is deleted.
+  virtual bool WritePacket(const RtpPacketRef& packet) = 0;
 };
 }  // namespace test
 }  // namespace webrtc
@@ -8,8 +8,11 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
 #include <string.h>
 
+#include <vector>
+
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/test/rtp_file_reader.h"
@@ -38,8 +41,48 @@ class RtpFileWriterTest : public ::testing::Test {
     }
   }
 
+  // Writes RTP packets alternating between |ssrcs|, |interval_ms| apart.
+  void WriteRtpStreams(int num_packets,
+                       const std::vector<uint32_t>& ssrcs,
+                       uint32_t interval_ms) {
+    ASSERT_TRUE(rtp_writer_.get() != NULL);
+    test::RtpPacket packet;
+    for (int i = 0; i < num_packets; ++i) {
+      const uint32_t ssrc = ssrcs[i % ssrcs.size()];
+      packet.length = 100 + i % 1000;
+      packet.original_length = packet.length;
+      packet.time_ms = i * interval_ms;
+      memset(packet.data, i, packet.length);
+      packet.data[0] = 0x80;
+      packet.data[1] = 96;
+      packet.data[8] = static_cast<uint8_t>(ssrc >> 24);
+      packet.data[9] = static_cast<uint8_t>(ssrc >> 16);
+      packet.data[10] = static_cast<uint8_t>(ssrc >> 8);
+      packet.data[11] = static_cast<uint8_t>(ssrc);
+      EXPECT_TRUE(rtp_writer_->WritePacket(&packet));
+    }
+  }
+
   void CloseOutputFile() { rtp_writer_.reset(); }
 
+  test::RtpFileReader* OpenInputFile() {
+    EXPECT_TRUE(rtp_writer_.get() == NULL)
+        << "Must call CloseOutputFile before OpenInputFile";
+    return test::RtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                       filename_);
+  }
+
+  // Opens the written file with its index cached in |index_filename()|.
+  test::RtpFileReader* OpenInputFileWithIndex() {
+    EXPECT_TRUE(rtp_writer_.get() == NULL)
+        << "Must call CloseOutputFile before OpenInputFileWithIndex";
+    return test::RtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                       filename_, index_filename());
+  }
+
+  const std::string& filename() const { return filename_; }
+  std::string index_filename() const { return filename_ + ".idx"; }
+
   void VerifyFileContents(int expected_packets) {
     ASSERT_TRUE(rtp_writer_.get() == NULL)
         << "Must call CloseOutputFile before VerifyFileContents";
@@ -72,4 +115,104 @@ TEST_F(RtpFileWriterTest, WriteToRtpDump) {
   VerifyFileContents(10);
 }
 
+TEST_F(RtpFileWriterTest, WriteLargeRtpDump) {
+  // More than fits in the write buffer.
+  Init("test_rtp_file_writer_large.rtp");
+  const int kNumPackets = 5000;
+  WriteRtpStreams(kNumPackets, std::vector<uint32_t>(1, 1234), 1);
+  CloseOutputFile();
+  rtc::scoped_ptr<test::RtpFileReader> rtp_reader(OpenInputFile());
+  ASSERT_TRUE(rtp_reader.get() != NULL);
+  test::RtpPacketRef packet;
+  int i = 0;
+  while (rtp_reader->NextPacket(&packet)) {
+    EXPECT_EQ(static_cast<size_t>(100 + i % 1000), packet.length);
+    EXPECT_EQ(static_cast<uint32_t>(i), packet.time_ms);
+    EXPECT_EQ(static_cast<uint8_t>(i), packet.data[packet.length - 1]);
+    ++i;
+  }
+  EXPECT_EQ(kNumPackets, i);
+}
+
+TEST_F(RtpFileWriterTest, SeekAndFilterBySsrc) {
+  Init("test_rtp_file_writer_seek.rtp");
+  remove(index_filename().c_str());
+  std::vector<uint32_t> ssrcs;
+  ssrcs.push_back(1111);
+  ssrcs.push_back(2222);
+  ssrcs.push_back(3333);
+  WriteRtpStreams(300, ssrcs, 10);
+  CloseOutputFile();
+
+  // Builds and saves the index.
+  rtc::scoped_ptr<test::RtpFileReader> rtp_reader(OpenInputFileWithIndex());
+  ASSERT_TRUE(rtp_reader.get() != NULL);
+  ASSERT_TRUE(rtp_reader->SeekToTime(1005));
+  test::RtpPacketRef packet;
+  ASSERT_TRUE(rtp_reader->NextPacket(&packet));
+  EXPECT_EQ(1010u, packet.time_ms);
+  EXPECT_FALSE(rtp_reader->SeekToTime(3000));
+  EXPECT_FALSE(rtp_reader->NextPacket(&packet));
+
+  // Loads the saved index.
+  rtp_reader.reset(OpenInputFileWithIndex());
+  ASSERT_TRUE(rtp_reader.get() != NULL);
+  rtp_reader->SetSsrcFilter(2222);
+  ASSERT_TRUE(rtp_reader->SeekToTime(1500));
+  int num_packets = 0;
+  while (rtp_reader->NextPacket(&packet)) {
+    EXPECT_EQ(2222u, (static_cast<uint32_t>(packet.data[10]) << 8) |
+                         packet.data[11]);
+    EXPECT_GE(packet.time_ms, 1500u);
+    ++num_packets;
+  }
+  EXPECT_EQ(50, num_packets);
+
+  // Without the filter, packets are returned from the seek position on.
+  rtp_reader->SetSsrcFilter(0);
+  ASSERT_TRUE(rtp_reader->SeekToTime(2970));
+  ASSERT_TRUE(rtp_reader->NextPacket(&packet));
+  EXPECT_EQ(2970u, packet.time_ms);
+  ASSERT_TRUE(rtp_reader->NextPacket(&packet));
+  EXPECT_EQ(2980u, packet.time_ms);
+}
+
+TEST_F(RtpFileWriterTest, IgnoresIndexOfOtherContents) {
+  Init("test_rtp_file_writer_stale_index.rtp");
+  remove(index_filename().c_str());
+  WriteRtpStreams(30, std::vector<uint32_t>(1, 1111), 10);
+  CloseOutputFile();
+  rtc::scoped_ptr<test::RtpFileReader> rtp_reader(OpenInputFileWithIndex());
+  ASSERT_TRUE(rtp_reader.get() != NULL);
+  rtp_reader->SetSsrcFilter(1111);
+  rtp_reader.reset();
+
+  // The same size, but another SSRC.
+  Init("test_rtp_file_writer_stale_index.rtp");
+  WriteRtpStreams(30, std::vector<uint32_t>(1, 2222), 10);
+  CloseOutputFile();
+  rtp_reader.reset(OpenInputFileWithIndex());
+  ASSERT_TRUE(rtp_reader.get() != NULL);
+  rtp_reader->SetSsrcFilter(2222);
+  int num_packets = 0;
+  test::RtpPacketRef packet;
+  while (rtp_reader->NextPacket(&packet))
+    ++num_packets;
+  EXPECT_EQ(30, num_packets);
+}
+
+TEST_F(RtpFileWriterTest, DoesNotWriteIndexUnlessAsked) {
+  Init("test_rtp_file_writer_no_index.rtp");
+  remove(index_filename().c_str());
+  WriteRtpStreams(30, std::vector<uint32_t>(1, 1111), 10);
+  CloseOutputFile();
+  rtc::scoped_ptr<test::RtpFileReader> rtp_reader(OpenInputFile());
+  ASSERT_TRUE(rtp_reader.get() != NULL);
+  ASSERT_TRUE(rtp_reader->SeekToTime(100));
+  FILE* index_file = fopen(index_filename().c_str(), "rb");
+  EXPECT_TRUE(index_file == NULL);
+  if (index_file)
+    fclose(index_file);
+}
+
 }  // namespace webrtc
@@ -57,6 +57,8 @@
       'target_name': 'rtp_test_utils',
       'type': 'static_library',
       'sources': [
+        'mapped_file.cc',
+        'mapped_file.h',
         'rtcp_packet_parser.cc',
         'rtcp_packet_parser.h',
         'rtp_file_reader.cc',
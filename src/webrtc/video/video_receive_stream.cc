@@ -47,6 +47,8 @@ std::string VideoReceiveStream::Config::ToString() const {
   ss << ", rtp: " << rtp.ToString();
   ss << ", renderer: " << (renderer != nullptr ? "(renderer)" : "nullptr");
   ss << ", render_delay_ms: " << render_delay_ms;
+  ss << ", disable_prerenderer_smoothing: "
+     << (disable_prerenderer_smoothing ? "true" : "false");
   ss << ", audio_channel_id: " << audio_channel_id;
   ss << ", pre_decode_callback: "
      << (pre_decode_callback != nullptr ? "(EncodedFrameObserver)" : "nullptr");
@@ -236,7 +238,8 @@ VideoReceiveStream::VideoReceiveStream(int num_cpu_cores,
     CHECK_EQ(0, vie_channel_->SetReceiveCodec(codec));
   }
 
-  incoming_video_stream_.reset(new IncomingVideoStream(0));
+  incoming_video_stream_.reset(
+      new IncomingVideoStream(0, config.disable_prerenderer_smoothing));
   incoming_video_stream_->SetExpectedRenderDelay(config.render_delay_ms);
   incoming_video_stream_->SetExternalCallback(this);
   vie_channel_->SetIncomingVideoStream(incoming_video_stream_.get());
@@ -68,6 +68,7 @@ ViECapturer::ViECapturer(ProcessThread* module_process_thread,
       capture_event_(*EventWrapper::Create()),
       deliver_event_(*EventWrapper::Create()),
       stop_(0),
+      dropped_region_(std::vector<UpdatedRegion::Rect>()),
       last_captured_timestamp_(0),
       delta_ntp_internal_ms_(
           Clock::GetRealTimeClock()->CurrentNtpInMilliseconds() -
@@ -128,9 +129,17 @@ void ViECapturer::IncomingFrame(const I420VideoFrame& video_frame) {
   if (incoming_frame.ntp_time_ms() <= last_captured_timestamp_) {
     // We don't allow the same capture time for two frames, drop this one.
     LOG(LS_WARNING) << "Same/old NTP timestamp for incoming frame. Dropping.";
+    dropped_region_.Union(incoming_frame.updated_region());
     return;
   }
 
+  // A frame which hasn't been delivered yet is replaced, i.e. dropped.
+  if (!captured_frame_.IsZeroSize())
+    dropped_region_.Union(captured_frame_.updated_region());
+  UpdatedRegion updated_region = incoming_frame.updated_region();
+  if (updated_region.MergeDropped(&dropped_region_))
+    incoming_frame.set_updated_region(updated_region);
+
   captured_frame_.ShallowCopy(incoming_frame);
   last_captured_timestamp_ = incoming_frame.ntp_time_ms();
 
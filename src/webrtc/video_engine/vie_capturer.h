@@ -84,6 +84,9 @@ class ViECapturer {
   volatile int stop_;
 
   I420VideoFrame captured_frame_ GUARDED_BY(capture_cs_.get());
+  // What changed in the frames which were dropped since a frame was last
+  // captured, which the next captured frame has to cover.
+  UpdatedRegion dropped_region_ GUARDED_BY(capture_cs_.get());
   // Used to make sure incoming time stamp is increasing for every frame.
   int64_t last_captured_timestamp_;
   // Delta used for translating between NTP and internal timestamps.
@@ -128,6 +128,7 @@ ViEEncoder::ViEEncoder(int32_t channel_id,
       network_is_transmitting_(true),
       encoder_paused_(false),
       encoder_paused_and_dropped_frame_(false),
+      dropped_region_(std::vector<UpdatedRegion::Rect>()),
       fec_enabled_(false),
       nack_enabled_(false),
       codec_observer_(NULL),
@@ -498,6 +499,7 @@ void ViEEncoder::DeliverFrame(int id,
   if (!send_payload_router_->active()) {
     // We've paused or we have no channels attached, don't waste resources on
     // encoding.
+    dropped_region_.Union(video_frame.updated_region());
     return;
   }
   {
@@ -505,6 +507,7 @@ void ViEEncoder::DeliverFrame(int id,
     time_of_last_frame_activity_ms_ = TickTime::MillisecondTimestamp();
     if (EncoderPaused()) {
       TraceFrameDropStart();
+      dropped_region_.Union(video_frame.updated_region());
       return;
     }
     TraceFrameDropEnd();
@@ -519,6 +522,7 @@ void ViEEncoder::DeliverFrame(int id,
     const int ret = vpm_->PreprocessFrame(video_frame, &decimated_frame);
     if (ret == 1) {
       // Drop this frame.
+      dropped_region_.Union(video_frame.updated_region());
       return;
     }
     if (ret != VPM_OK) {
@@ -548,9 +552,20 @@ void ViEEncoder::DeliverFrame(int id,
 
   if (video_frame.native_handle() != NULL) {
     // TODO(wuchengli): add texture support. http://crbug.com/362437
+    dropped_region_.Union(video_frame.updated_region());
     return;
   }
 
+  // The encoder only knows about the frames it gets, so the region of this one
+  // has to include what changed in the dropped ones.
+  I420VideoFrame merged_frame;
+  UpdatedRegion updated_region = output_frame->updated_region();
+  if (updated_region.MergeDropped(&dropped_region_)) {
+    merged_frame.ShallowCopy(*output_frame);
+    merged_frame.set_updated_region(updated_region);
+    output_frame = &merged_frame;
+  }
+
 #ifdef VIDEOCODEC_VP8
   if (vcm_->SendCodec() == webrtc::kVideoCodecVP8) {
     webrtc::CodecSpecificInfo codec_specific_info;
@@ -235,6 +235,9 @@ class ViEEncoder
   bool network_is_transmitting_ GUARDED_BY(data_cs_);
   bool encoder_paused_ GUARDED_BY(data_cs_);
   bool encoder_paused_and_dropped_frame_ GUARDED_BY(data_cs_);
+  // What changed in the frames dropped since a frame was last passed to the
+  // encoder. Only used on the thread which delivers frames.
+  UpdatedRegion dropped_region_;
   std::map<unsigned int, int64_t> time_last_intra_request_ms_
       GUARDED_BY(data_cs_);
 
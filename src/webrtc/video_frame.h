@@ -11,6 +11,8 @@
 #ifndef WEBRTC_VIDEO_FRAME_H_
 #define WEBRTC_VIDEO_FRAME_H_
 
+#include <vector>
+
 #include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/common_video/interface/video_frame_buffer.h"
 #include "webrtc/common_video/rotation.h"
@@ -18,6 +20,42 @@
 
 namespace webrtc {
 
+// The part of a frame which changed since the previous frame, e.g. the damage
+// reported by a screen capturer. An unknown region, which is the default, means
+// that the whole frame may have changed; a known region without rectangles
+// means that nothing did.
+class UpdatedRegion {
+ public:
+  // A rectangle of the frame, in pixels.
+  struct Rect {
+    int x;
+    int y;
+    int width;
+    int height;
+  };
+
+  UpdatedRegion() : known_(false) {}
+  explicit UpdatedRegion(const std::vector<Rect>& rects)
+      : known_(true), rects_(rects) {}
+
+  bool known() const { return known_; }
+  // True if the region is known to be empty, i.e. nothing changed.
+  bool IsEmpty() const { return known_ && rects_.empty(); }
+  const std::vector<Rect>& rects() const { return rects_; }
+
+  // Adds |other| to this region, e.g. the region of a dropped frame which the
+  // next frame has to cover. The union is unknown if either region is.
+  void Union(const UpdatedRegion& other);
+  // Adds |dropped|, the region of the frames dropped before the one this is
+  // the region of, and leaves |dropped| empty for the next run of drops.
+  // Returns false, leaving this region as it is, if nothing was dropped.
+  bool MergeDropped(UpdatedRegion* dropped);
+
+ private:
+  bool known_;
+  std::vector<Rect> rects_;
+};
+
 class I420VideoFrame {
  public:
   I420VideoFrame();
@@ -145,6 +183,15 @@ class I420VideoFrame {
   // Get render time in miliseconds.
   int64_t render_time_ms() const { return render_time_ms_; }
 
+  // Set the region which changed since the previous frame. Encoders may skip
+  // the rest of the frame.
+  void set_updated_region(const UpdatedRegion& updated_region) {
+    updated_region_ = updated_region;
+  }
+
+  // Get the region which changed since the previous frame.
+  const UpdatedRegion& updated_region() const { return updated_region_; }
+
   // Return true if underlying plane buffers are of zero size, false if not.
   bool IsZeroSize() const;
 
@@ -167,6 +214,7 @@ class I420VideoFrame {
   int64_t ntp_time_ms_;
   int64_t render_time_ms_;
   VideoRotation rotation_;
+  UpdatedRegion updated_region_;
 };
 
 enum VideoFrameType {
@@ -93,6 +93,7 @@ class VideoReceiveStream {
     Config()
         : renderer(NULL),
           render_delay_ms(0),
+          disable_prerenderer_smoothing(false),
           audio_channel_id(-1),
           pre_decode_callback(NULL),
           pre_render_callback(NULL),
@@ -166,6 +167,11 @@ class VideoReceiveStream {
     // Only valid if 'renderer' is set.
     int render_delay_ms;
 
+    // If set, frames are delivered to 'renderer' as soon as they are decoded,
+    // instead of at their render time. Meant for renderers which don't
+    // display the frames, e.g. when recording or mixing them on a server.
+    bool disable_prerenderer_smoothing;
+
     // Audio channel corresponding to this video stream, used for audio/video
     // synchronization. 'audio_channel_id' is ignored if no VoiceEngine is set
     // when creating the VideoEngine instance. '-1' disables a/v sync.
@@ -10,6 +10,8 @@
 
 #include "webrtc/voice_engine/channel.h"
 
+#include <string.h>
+
 #include <algorithm>
 
 #include "webrtc/base/format_macros.h"
@@ -148,6 +150,38 @@ class VoERtcpObserver : public RtcpBandwidthObserver {
   std::map<uint32_t, uint32_t> extended_max_sequence_number_;
 };
 
+SendEncoderSettings::SendEncoderSettings()
+    : bitrate_bps(0),
+      packet_loss_rate(0),
+      vad_enabled(false),
+      vad_mode(VADNormal),
+      dtx_enabled(false),
+      red_enabled(false),
+      red_payload_type(-1),
+      codec_fec_enabled(false),
+      opus_max_playback_rate_hz(0),
+      opus_dtx_enabled(false),
+      cn_payload_type_16khz(-1),
+      cn_payload_type_32khz(-1) {
+  memset(&codec, 0, sizeof(codec));
+}
+
+bool SendEncoderSettings::operator==(const SendEncoderSettings& other) const {
+  return codec == other.codec &&
+         bitrate_bps == other.bitrate_bps &&
+         packet_loss_rate == other.packet_loss_rate &&
+         vad_enabled == other.vad_enabled &&
+         vad_mode == other.vad_mode &&
+         dtx_enabled == other.dtx_enabled &&
+         red_enabled == other.red_enabled &&
+         red_payload_type == other.red_payload_type &&
+         codec_fec_enabled == other.codec_fec_enabled &&
+         opus_max_playback_rate_hz == other.opus_max_playback_rate_hz &&
+         opus_dtx_enabled == other.opus_dtx_enabled &&
+         cn_payload_type_16khz == other.cn_payload_type_16khz &&
+         cn_payload_type_32khz == other.cn_payload_type_32khz;
+}
+
 int32_t
 Channel::SendData(FrameType frameType,
                   uint8_t   payloadType,
@@ -162,38 +196,19 @@ Channel::SendData(FrameType frameType,
                  frameType, payloadType, timeStamp,
                  payloadSize, fragmentation);
 
-    if (_includeAudioLevelIndication)
-    {
-        // Store current audio level in the RTP/RTCP module.
-        // The level will be used in combination with voice-activity state
-        // (frameType) to add an RTP header extension
-        _rtpRtcpModule->SetAudioLevel(rms_level_.RMS());
-    }
+    // The encoder has sent all the audio it was given.
+    encoder_has_buffered_audio_ = false;
 
-    // Push data from ACM to RTP/RTCP-module to deliver audio frame for
-    // packetization.
-    // This call will trigger Transport::SendPacket() from the RTP/RTCP module.
-    if (_rtpRtcpModule->SendOutgoingData((FrameType&)frameType,
-                                        payloadType,
-                                        timeStamp,
-                                        // Leaving the time when this frame was
-                                        // received from the capture device as
-                                        // undefined for voice for now.
-                                        -1,
-                                        payloadData,
-                                        payloadSize,
-                                        fragmentation) == -1)
+    // The channels sharing the encoder of this one send the same payload.
+    for (int i = 0; i < num_shared_encoder_followers_; ++i)
     {
-        _engineStatisticsPtr->SetLastError(
-            VE_RTP_RTCP_MODULE_ERROR, kTraceWarning,
-            "Channel::SendData() failed to send data to RTP/RTCP module");
-        return -1;
+        shared_encoder_followers_[i]->SendEncodedData(
+            _channelId, frameType, payloadType, timeStamp, payloadData,
+            payloadSize, fragmentation);
     }
 
-    _lastLocalTimeStamp = timeStamp;
-    _lastPayloadType = payloadType;
-
-    return 0;
+    return SendEncodedData(_channelId, frameType, payloadType, timeStamp,
+                           payloadData, payloadSize, fragmentation);
 }
 
 int32_t
@@ -202,6 +217,11 @@ Channel::InFrameType(FrameType frame_type)
     WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId,_channelId),
                  "Channel::InFrameType(frame_type=%d)", frame_type);
 
+    for (int i = 0; i < num_shared_encoder_followers_; ++i)
+    {
+        shared_encoder_followers_[i]->InFrameType(frame_type);
+    }
+
     CriticalSectionScoped cs(&_callbackCritSect);
     _sendFrameType = (frame_type == kAudioFrameSpeech);
     return 0;
@@ -824,7 +844,16 @@ Channel::Channel(int32_t channelId,
     rtcp_observer_(new VoERtcpObserver(this)),
     network_predictor_(new NetworkPredictor(Clock::GetRealTimeClock())),
     assoc_send_channel_lock_(CriticalSectionWrapper::CreateCriticalSection()),
-    associate_send_channel_(ChannelOwner(nullptr))
+    associate_send_channel_(ChannelOwner(nullptr)),
+    send_encoder_settings_lock_(
+        CriticalSectionWrapper::CreateCriticalSection()),
+    shared_encoder_followers_(NULL),
+    num_shared_encoder_followers_(0),
+    encoder_id_(-1),
+    encoder_has_buffered_audio_(false),
+    timestamp_encoder_id_(-1),
+    timestamp_offset_(0),
+    last_send_input_timestamp_(0)
 {
     WEBRTC_TRACE(kTraceMemory, kTraceVoice, VoEId(_instanceId,_channelId),
                  "Channel::Channel() - ctor");
@@ -1345,6 +1374,9 @@ Channel::SetSendCodec(const CodecInst& codec)
         return -1;
     }
 
+    CriticalSectionScoped lock(send_encoder_settings_lock_.get());
+    send_encoder_settings_.codec = codec;
+    send_encoder_settings_.bitrate_bps = codec.rate;
     return 0;
 }
 
@@ -1352,6 +1384,8 @@ void Channel::SetBitRate(int bitrate_bps) {
   WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId, _channelId),
                "Channel::SetBitRate(bitrate_bps=%d)", bitrate_bps);
   audio_coding_->SetBitRate(bitrate_bps);
+  CriticalSectionScoped lock(send_encoder_settings_lock_.get());
+  send_encoder_settings_.bitrate_bps = bitrate_bps;
 }
 
 void Channel::OnIncomingFractionLoss(int fraction_lost) {
@@ -1359,10 +1393,12 @@ void Channel::OnIncomingFractionLoss(int fraction_lost) {
   uint8_t average_fraction_loss = network_predictor_->GetLossRate();
 
   // Normalizes rate to 0 - 100.
-  if (audio_coding_->SetPacketLossRate(
-      100 * average_fraction_loss / 255) != 0) {
+  const int packet_loss_rate = 100 * average_fraction_loss / 255;
+  if (audio_coding_->SetPacketLossRate(packet_loss_rate) != 0) {
     assert(false);  // This should not happen.
   }
+  CriticalSectionScoped lock(send_encoder_settings_lock_.get());
+  send_encoder_settings_.packet_loss_rate = packet_loss_rate;
 }
 
 int32_t
@@ -1380,6 +1416,10 @@ Channel::SetVADStatus(bool enableVAD, ACMVADMode mode, bool disableDTX)
             "SetVADStatus() failed to set VAD");
         return -1;
     }
+    CriticalSectionScoped lock(send_encoder_settings_lock_.get());
+    send_encoder_settings_.vad_enabled = enableVAD;
+    send_encoder_settings_.vad_mode = mode;
+    send_encoder_settings_.dtx_enabled = !disableDTX;
     return 0;
 }
 
@@ -1561,6 +1601,11 @@ Channel::SetSendCNPayloadType(int type, PayloadFrequencies frequency)
             return -1;
         }
     }
+    CriticalSectionScoped lock(send_encoder_settings_lock_.get());
+    if (frequency == kFreq32000Hz)
+        send_encoder_settings_.cn_payload_type_32khz = type;
+    else if (frequency == kFreq16000Hz)
+        send_encoder_settings_.cn_payload_type_16khz = type;
     return 0;
 }
 
@@ -1574,6 +1619,8 @@ int Channel::SetOpusMaxPlaybackRate(int frequency_hz) {
         "SetOpusMaxPlaybackRate() failed to set maximum playback rate");
     return -1;
   }
+  CriticalSectionScoped lock(send_encoder_settings_lock_.get());
+  send_encoder_settings_.opus_max_playback_rate_hz = frequency_hz;
   return 0;
 }
 
@@ -1587,6 +1634,8 @@ int Channel::SetOpusDtx(bool enable_dtx) {
         VE_AUDIO_CODING_MODULE_ERROR, kTraceError, "SetOpusDtx() failed");
     return -1;
   }
+  CriticalSectionScoped lock(send_encoder_settings_lock_.get());
+  send_encoder_settings_.opus_dtx_enabled = enable_dtx;
   return 0;
 }
 
@@ -3304,6 +3353,10 @@ int Channel::SetREDStatus(bool enable, int redPayloadtype) {
         "SetREDStatus() failed to set RED state in the ACM");
     return -1;
   }
+  CriticalSectionScoped lock(send_encoder_settings_lock_.get());
+  send_encoder_settings_.red_enabled = enable;
+  if (enable)
+    send_encoder_settings_.red_payload_type = redPayloadtype;
   return 0;
 }
 
@@ -3345,6 +3398,8 @@ int Channel::SetCodecFECStatus(bool enable) {
         "SetCodecFECStatus() failed to set FEC state");
     return -1;
   }
+  CriticalSectionScoped lock(send_encoder_settings_lock_.get());
+  send_encoder_settings_.codec_fec_enabled = enable;
   return 0;
 }
 
@@ -3548,11 +3603,13 @@ Channel::EncodeAndSend()
     }
 
     _audioFrame.id_ = _channelId;
-
     // --- Add 10ms of raw (PCM) audio data to the encoder @ 32kHz.
 
     // The ACM resamples internally.
     _audioFrame.timestamp_ = _timeStamp;
+    encoder_id_ = _channelId;
+    // Cleared by SendData() if the encoder completes a packet.
+    encoder_has_buffered_audio_ = true;
     // This call will trigger AudioPacketizationCallback::SendData if encoding
     // is done and payload is ready for packetization and transmission.
     // Otherwise, it will return without invoking the callback.
@@ -3567,6 +3624,103 @@ Channel::EncodeAndSend()
     return 0;
 }
 
+uint32_t Channel::EncodeAndSend(Channel* const* followers, int num_followers) {
+  shared_encoder_followers_ = followers;
+  num_shared_encoder_followers_ = num_followers;
+  const uint32_t result = EncodeAndSend();
+  shared_encoder_followers_ = NULL;
+  num_shared_encoder_followers_ = 0;
+  // The followers skipped their encoders, but their audio was sent all the
+  // same.
+  for (int i = 0; i < num_followers; ++i) {
+    followers[i]->encoder_id_ = _channelId;
+    followers[i]->UpdateLocalTimeStamp();
+  }
+  return result;
+}
+
+SendEncoderSettings Channel::GetSendEncoderSettings() const {
+  CriticalSectionScoped lock(send_encoder_settings_lock_.get());
+  return send_encoder_settings_;
+}
+
+int32_t Channel::EncoderId() const {
+  return encoder_id_;
+}
+
+bool Channel::EncoderHasBufferedAudio() const {
+  return encoder_has_buffered_audio_;
+}
+
+bool Channel::HasSameAudioToEncode(const Channel& other) const {
+  return _audioFrame.samples_per_channel_ > 0 &&
+         _audioFrame.samples_per_channel_ ==
+             other._audioFrame.samples_per_channel_ &&
+         _audioFrame.num_channels_ == other._audioFrame.num_channels_ &&
+         _audioFrame.sample_rate_hz_ == other._audioFrame.sample_rate_hz_ &&
+         memcmp(_audioFrame.data_, other._audioFrame.data_,
+                sizeof(_audioFrame.data_[0]) *
+                    _audioFrame.samples_per_channel_ *
+                    _audioFrame.num_channels_) == 0;
+}
+
+int32_t Channel::SendEncodedData(int32_t encoder_id,
+                                 FrameType frame_type,
+                                 uint8_t payload_type,
+                                 uint32_t timestamp,
+                                 const uint8_t* payload_data,
+                                 size_t payload_size,
+                                 const RTPFragmentationHeader* fragmentation) {
+  if (encoder_id != timestamp_encoder_id_) {
+    // The timestamps of another encoder are unrelated to the ones sent so far.
+    // Continue from the last payload sent, by the audio captured since.
+    if (timestamp_encoder_id_ != -1) {
+      const CodecInst codec = GetSendEncoderSettings().codec;
+      // The RTP clock rate of G722 is 8000 Hz, half its sampling rate.
+      const int64_t rtp_rate_hz =
+          STR_CASE_CMP(codec.plname, "G722") == 0 ? 8000 : codec.plfreq;
+      const uint32_t elapsed = static_cast<uint32_t>(
+          (_timeStamp - last_send_input_timestamp_) * rtp_rate_hz /
+          _audioFrame.sample_rate_hz_);
+      timestamp_offset_ = _lastLocalTimeStamp + elapsed - timestamp;
+    }
+    timestamp_encoder_id_ = encoder_id;
+  }
+  last_send_input_timestamp_ = _timeStamp;
+  timestamp += timestamp_offset_;
+
+  if (_includeAudioLevelIndication) {
+    // Store current audio level in the RTP/RTCP module.
+    // The level will be used in combination with voice-activity state
+    // (frameType) to add an RTP header extension
+    _rtpRtcpModule->SetAudioLevel(rms_level_.RMS());
+  }
+
+  // Push data from ACM to RTP/RTCP-module to deliver audio frame for
+  // packetization.
+  // This call will trigger Transport::SendPacket() from the RTP/RTCP module.
+  if (_rtpRtcpModule->SendOutgoingData(frame_type,
+                                       payload_type,
+                                       timestamp,
+                                       // Leaving the time when this frame was
+                                       // received from the capture device as
+                                       // undefined for voice for now.
+                                       -1,
+                                       payload_data,
+                                       payload_size,
+                                       fragmentation) == -1) {
+    _engineStatisticsPtr->SetLastError(
+        VE_RTP_RTCP_MODULE_ERROR, kTraceWarning,
+        "Channel::SendData() failed to send data to RTP/RTCP module");
+    return -1;
+  }
+
+  _lastLocalTimeStamp = timestamp;
+  _lastPayloadType = payload_type;
+
+  return 0;
+}
+
 void Channel::DisassociateSendChannel(int channel_id) {
   CriticalSectionScoped lock(assoc_send_channel_lock_.get());
   Channel* channel = associate_send_channel_.channel();
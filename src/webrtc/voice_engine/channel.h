@@ -152,6 +152,30 @@ private:
     State state_;
 };
 
+// The settings which, together with the audio, determine what the send side
+// of a channel's audio coding module produces. Channels with equal settings
+// encode the same audio to the same payload.
+struct SendEncoderSettings {
+    SendEncoderSettings();
+
+    bool operator==(const SendEncoderSettings& other) const;
+
+    CodecInst codec;
+    int bitrate_bps;
+    int packet_loss_rate;
+    bool vad_enabled;
+    ACMVADMode vad_mode;
+    bool dtx_enabled;
+    bool red_enabled;
+    int red_payload_type;
+    bool codec_fec_enabled;
+    int opus_max_playback_rate_hz;
+    bool opus_dtx_enabled;
+    // -1 while the default payload type is used.
+    int cn_payload_type_16khz;
+    int cn_payload_type_32khz;
+};
+
 class Channel:
     public RtpData,
     public RtpFeedback,
@@ -441,6 +465,24 @@ public:
                      int number_of_channels);
     uint32_t PrepareEncodeAndSend(int mixingFrequency);
     uint32_t EncodeAndSend();
+    // Same as EncodeAndSend(), but also sends the encoded audio on each of the
+    // |num_followers| |followers|, which don't encode their audio themselves.
+    // All of them must have the same send encoder settings and audio to
+    // encode as this channel.
+    uint32_t EncodeAndSend(Channel* const* followers, int num_followers);
+    SendEncoderSettings GetSendEncoderSettings() const;
+    // Returns the id of the channel whose encoder got the audio of the last
+    // EncodeAndSend() of this channel, i.e. this channel's or its leader's, or
+    // -1 before the first one.
+    int32_t EncoderId() const;
+    // Returns true if this channel's encoder holds audio which it hasn't sent
+    // as a packet yet. Encode groups may only change between packets, when
+    // none of their encoders does; a channel which switched encoders in the
+    // middle of a packet would lose or repeat the audio in it.
+    bool EncoderHasBufferedAudio() const;
+    // Returns true if, after PrepareEncodeAndSend(), |other| has the same audio
+    // to encode as this channel.
+    bool HasSameAudioToEncode(const Channel& other) const;
 
     // Associate to a send channel.
     // Used for obtaining RTT for a receive-only channel.
@@ -468,6 +510,15 @@ private:
     int InsertInbandDtmfTone();
     int32_t MixOrReplaceAudioWithFile(int mixingFrequency);
     int32_t MixAudioWithFile(AudioFrame& audioFrame, int mixingFrequency);
+    // Sends audio encoded by the channel |encoder_id|, this one or the one
+    // whose encoder it shares. |timestamp| is in the clock of that encoder.
+    int32_t SendEncodedData(int32_t encoder_id,
+                            FrameType frame_type,
+                            uint8_t payload_type,
+                            uint32_t timestamp,
+                            const uint8_t* payload_data,
+                            size_t payload_size,
+                            const RTPFragmentationHeader* fragmentation);
     int32_t SendPacketRaw(const void *data, size_t len, bool RTCP);
     void UpdatePacketDelay(uint32_t timestamp,
                            uint16_t sequenceNumber);
@@ -586,6 +637,23 @@ private:
     // An associated send channel.
     rtc::scoped_ptr<CriticalSectionWrapper> assoc_send_channel_lock_;
     ChannelOwner associate_send_channel_ GUARDED_BY(assoc_send_channel_lock_);
+    // Encoder sharing.
+    rtc::scoped_ptr<CriticalSectionWrapper> send_encoder_settings_lock_;
+    SendEncoderSettings send_encoder_settings_
+        GUARDED_BY(send_encoder_settings_lock_);
+    // The channels which send the audio encoded by this one, while encoding.
+    Channel* const* shared_encoder_followers_;
+    int num_shared_encoder_followers_;
+    // See EncoderId() and EncoderHasBufferedAudio(). Only used by the
+    // transmit mixer, which encodes the channels.
+    int32_t encoder_id_;
+    bool encoder_has_buffered_audio_;
+    // The channel whose encoder made the last payload sent, or -1 before the
+    // first one, and the offset from its timestamps to the ones sent.
+    int32_t timestamp_encoder_id_;
+    uint32_t timestamp_offset_;
+    // |_timeStamp| when the last payload was sent.
+    uint32_t last_send_input_timestamp_;
 };
 
 }  // namespace voe
@@ -45,6 +45,18 @@ class Config;
 
 const int kVoEDefault = -1;
 
+// Passed to VoiceEngine::Create(const Config&) to encode the sending channels
+// on |num_threads| threads, one of them the audio device thread, instead of on
+// the audio device thread alone. The channels then call their transports on
+// several threads at once.
+struct AudioEncodeThreadsConfig {
+  AudioEncodeThreadsConfig() : enabled(false), num_threads(1) {}
+  explicit AudioEncodeThreadsConfig(int value)
+      : enabled(true), num_threads(value) {}
+  bool enabled;
+  int num_threads;
+};
+
 // VoiceEngineObserver
 class WEBRTC_DLLEXPORT VoiceEngineObserver {
  public:
@@ -177,6 +189,13 @@ class WEBRTC_DLLEXPORT VoEBase {
   // implements the interface in its FakeWebRtcVoiceEngine.
   virtual AudioTransport* audio_transport() { return NULL; }
 
+  // Gets the number of blocks of captured audio which have been processed,
+  // encoded and sent, and the number of them which took longer than the
+  // audio they hold, missing the real-time deadline of the audio device.
+  virtual int GetCaptureDeadlineMisses(int* num_blocks, int* num_misses) {
+    return -1;
+  }
+
   // Associate a send channel to a receive channel.
   // Used for obtaining RTT for a receive-only channel.
   // One should be careful not to crate a circular association, e.g.,
@@ -10,10 +10,12 @@
 
 #include "webrtc/voice_engine/shared_data.h"
 
+#include "webrtc/common.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 #include "webrtc/voice_engine/channel.h"
+#include "webrtc/voice_engine/include/voe_base.h"
 #include "webrtc/voice_engine/output_mixer.h"
 #include "webrtc/voice_engine/transmit_mixer.h"
 
@@ -43,6 +45,11 @@ SharedData::SharedData(const Config& config) :
         _transmitMixerPtr->SetEngineInformation(*_moduleProcessThreadPtr,
                                                 _engineStatistics,
                                                 _channelManager);
+        if (config.Get<AudioEncodeThreadsConfig>().enabled)
+        {
+            _transmitMixerPtr->SetEncodeThreads(
+                config.Get<AudioEncodeThreadsConfig>().num_threads);
+        }
     }
     _audioDeviceLayer = AudioDeviceModule::kPlatformDefaultAudio;
 }
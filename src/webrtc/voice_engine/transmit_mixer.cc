@@ -15,6 +15,7 @@
 #include "webrtc/system_wrappers/interface/event_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
 #include "webrtc/system_wrappers/interface/trace.h"
+#include "webrtc/system_wrappers/interface/worker_pool.h"
 #include "webrtc/voice_engine/channel.h"
 #include "webrtc/voice_engine/channel_manager.h"
 #include "webrtc/voice_engine/include/voe_external_media.h"
@@ -294,12 +295,21 @@ TransmitMixer::SetAudioProcessingModule(AudioProcessing* audioProcessingModule)
     return 0;
 }
 
+void TransmitMixer::SetEncodeThreads(int num_threads) {
+  // The audio device thread, which calls in, encodes as well. The pool's
+  // threads run at its priority since it waits for them.
+  encode_pool_.reset(num_threads > 1
+                         ? new WorkerPool(num_threads - 1, "VoiceEncodeThread",
+                                          kRealtimePriority)
+                         : NULL);
+}
+
 void TransmitMixer::GetSendCodecInfo(int* max_sample_rate, int* max_channels) {
   *max_sample_rate = 8000;
   *max_channels = 1;
-  for (ChannelManager::Iterator it(_channelManagerPtr); it.IsValid();
-       it.Increment()) {
-    Channel* channel = it.GetChannel();
+  _channelManagerPtr->GetAllChannels(&channels_);
+  for (size_t i = 0; i < channels_.size(); ++i) {
+    Channel* channel = channels_[i].channel();
     if (channel->Sending()) {
       CodecInst codec;
       channel->GetSendCodec(codec);
@@ -307,6 +317,7 @@ void TransmitMixer::GetSendCodecInfo(int* max_sample_rate, int* max_channels) {
       *max_channels = std::max(*max_channels, codec.channels);
     }
   }
+  channels_.clear();
 }
 
 int32_t
@@ -410,10 +421,10 @@ TransmitMixer::DemuxAndMix()
     WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId, -1),
                  "TransmitMixer::DemuxAndMix()");
 
-    for (ChannelManager::Iterator it(_channelManagerPtr); it.IsValid();
-         it.Increment())
+    _channelManagerPtr->GetAllChannels(&channels_);
+    for (size_t i = 0; i < channels_.size(); ++i)
     {
-        Channel* channelPtr = it.GetChannel();
+        Channel* channelPtr = channels_[i].channel();
         if (channelPtr->Sending())
         {
             // Demultiplex makes a copy of its input.
@@ -421,6 +432,7 @@ TransmitMixer::DemuxAndMix()
             channelPtr->PrepareEncodeAndSend(_audioFrame.sample_rate_hz_);
         }
     }
+    channels_.clear();
     return 0;
 }
 
@@ -445,15 +457,18 @@ TransmitMixer::EncodeAndSend()
     WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId, -1),
                  "TransmitMixer::EncodeAndSend()");
 
-    for (ChannelManager::Iterator it(_channelManagerPtr); it.IsValid();
-         it.Increment())
+    // |channels_| holds the channels until they are encoded.
+    _channelManagerPtr->GetAllChannels(&channels_);
+    for (size_t i = 0; i < channels_.size(); ++i)
     {
-        Channel* channelPtr = it.GetChannel();
+        Channel* channelPtr = channels_[i].channel();
         if (channelPtr->Sending())
         {
-            channelPtr->EncodeAndSend();
+            sending_channels_.push_back(channelPtr);
         }
     }
+    EncodeAndSendSendingChannels();
+    channels_.clear();
     return 0;
 }
 
@@ -462,8 +477,102 @@ void TransmitMixer::EncodeAndSend(const int voe_channels[],
   for (int i = 0; i < number_of_voe_channels; ++i) {
     voe::ChannelOwner ch = _channelManagerPtr->GetChannel(voe_channels[i]);
     voe::Channel* channel_ptr = ch.channel();
-    if (channel_ptr && channel_ptr->Sending())
-      channel_ptr->EncodeAndSend();
+    if (channel_ptr && channel_ptr->Sending()) {
+      channels_.push_back(ch);
+      sending_channels_.push_back(channel_ptr);
+    }
+  }
+  EncodeAndSendSendingChannels();
+  channels_.clear();
+}
+
+void TransmitMixer::EncodeAndSendSendingChannels() {
+  const size_t num_channels = sending_channels_.size();
+  encode_groups_.clear();
+  if (num_channels == 1) {
+    grouped_channels_.assign(1, sending_channels_[0]);
+    encode_groups_.push_back(0);
+  } else if (num_channels > 1) {
+    // Channels which have the same send encoder settings and audio to encode
+    // are grouped, and only the first channel of each group encodes; the
+    // others send its payload. This way a speaker sent to many peers with the
+    // same codec is encoded once.
+    encoder_settings_.clear();
+    for (size_t i = 0; i < num_channels; ++i) {
+      encoder_settings_.push_back(
+          sending_channels_[i]->GetSendEncoderSettings());
+    }
+    // |leaders_[i]| is the index of the channel whose encoder gets the audio
+    // of channel i, or |num_channels| until that is decided.
+    leaders_.assign(num_channels, num_channels);
+    // The groups may only change between packets. A channel whose last audio
+    // went to an encoder which hasn't sent it yet stays with that encoder, even
+    // if its audio now differs, so that the packet is completed. Only a change
+    // of settings, which restarts the encoder anyway, splits it off.
+    for (size_t i = 0; i < num_channels; ++i) {
+      const int32_t encoder_id = sending_channels_[i]->EncoderId();
+      for (size_t j = 0; j < num_channels; ++j) {
+        if (sending_channels_[j]->ChannelId() == encoder_id) {
+          if (sending_channels_[j]->EncoderHasBufferedAudio()) {
+            leaders_[i] =
+                encoder_settings_[i] == encoder_settings_[j] ? j : i;
+          }
+          break;
+        }
+      }
+    }
+    // The other channels are between packets, and are grouped afresh with the
+    // channels which encode themselves among them.
+    for (size_t i = 0; i < num_channels; ++i) {
+      if (leaders_[i] != num_channels)
+        continue;
+      leaders_[i] = i;
+      for (size_t j = 0; j < i; ++j) {
+        if (leaders_[j] == j &&
+            !sending_channels_[j]->EncoderHasBufferedAudio() &&
+            encoder_settings_[j] == encoder_settings_[i] &&
+            sending_channels_[i]->HasSameAudioToEncode(*sending_channels_[j])) {
+          leaders_[i] = j;
+          break;
+        }
+      }
+    }
+    grouped_channels_.clear();
+    for (size_t i = 0; i < num_channels; ++i) {
+      if (leaders_[i] != i)
+        continue;
+      encode_groups_.push_back(grouped_channels_.size());
+      grouped_channels_.push_back(sending_channels_[i]);
+      for (size_t j = 0; j < num_channels; ++j) {
+        if (j != i && leaders_[j] == i)
+          grouped_channels_.push_back(sending_channels_[j]);
+      }
+    }
+  }
+  sending_channels_.clear();
+  if (encode_groups_.empty())
+    return;
+
+  const size_t num_groups = encode_groups_.size();
+  encode_groups_.push_back(grouped_channels_.size());
+  if (encode_pool_) {
+    encode_pool_->Run(&TransmitMixer::EncodeGroup, this, num_groups);
+  } else {
+    for (size_t i = 0; i < num_groups; ++i)
+      EncodeGroup(this, i);
+  }
+}
+
+void TransmitMixer::EncodeGroup(void* context, size_t index) {
+  TransmitMixer* const mixer = static_cast<TransmitMixer*>(context);
+  const size_t begin = mixer->encode_groups_[index];
+  const size_t end = mixer->encode_groups_[index + 1];
+  Channel* const leader = mixer->grouped_channels_[begin];
+  if (end - begin == 1) {
+    leader->EncodeAndSend();
+  } else {
+    leader->EncodeAndSend(&mixer->grouped_channels_[begin + 1],
+                          static_cast<int>(end - begin - 1));
   }
 }
 
@@ -11,6 +11,8 @@
 #ifndef WEBRTC_VOICE_ENGINE_TRANSMIT_MIXER_H
 #define WEBRTC_VOICE_ENGINE_TRANSMIT_MIXER_H
 
+#include <vector>
+
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/common_audio/resampler/include/push_resampler.h"
 #include "webrtc/common_types.h"
@@ -19,6 +21,8 @@
 #include "webrtc/modules/utility/interface/file_player.h"
 #include "webrtc/modules/utility/interface/file_recorder.h"
 #include "webrtc/voice_engine/include/voe_base.h"
+#include "webrtc/voice_engine/channel.h"
+#include "webrtc/voice_engine/channel_manager.h"
 #include "webrtc/voice_engine/level_indicator.h"
 #include "webrtc/voice_engine/monitor_module.h"
 #include "webrtc/voice_engine/voice_engine_defines.h"
@@ -29,10 +33,10 @@ class AudioProcessing;
 class ProcessThread;
 class VoEExternalMedia;
 class VoEMediaProcess;
+class WorkerPool;
 
 namespace voe {
 
-class ChannelManager;
 class MixedAudio;
 class Statistics;
 
@@ -50,6 +54,10 @@ public:
     int32_t SetAudioProcessingModule(
         AudioProcessing* audioProcessingModule);
 
+    // Encodes the sending channels on |num_threads| threads, including the
+    // audio device thread. Must be called before the capture starts.
+    void SetEncodeThreads(int num_threads);
+
     int32_t PrepareDemux(const void* audioSamples,
                          uint32_t nSamples,
                          uint8_t  nChannels,
@@ -65,6 +73,7 @@ public:
     // channels for demux.
     void DemuxAndMix(const int voe_channels[], int number_of_voe_channels);
 
+    // Channels with the same send encoder settings and audio share one encode.
     int32_t EncodeAndSend();
     // Used by the Chrome to pass the recording data to the specific VoE
     // channels for encoding and sending to the network.
@@ -172,6 +181,12 @@ private:
     // sending codecs.
     void GetSendCodecInfo(int* max_sample_rate, int* max_channels);
 
+    // Encodes and sends the audio of |sending_channels_|, on |encode_pool_| if
+    // there is one, and clears them.
+    void EncodeAndSendSendingChannels();
+    // Encodes the |index|th group of |grouped_channels_|.
+    static void EncodeGroup(void* context, size_t index);
+
     void GenerateAudioFrame(const int16_t audioSamples[],
                             int nSamples,
                             int nChannels,
@@ -230,6 +245,19 @@ private:
     bool stereo_codec_;
     bool swap_stereo_channels_;
     rtc::scoped_ptr<int16_t[]> mono_buffer_;
+
+    rtc::scoped_ptr<WorkerPool> encode_pool_;
+    // Used on the audio device thread only. They keep their memory, so the
+    // capture doesn't allocate once they have grown to hold all channels.
+    std::vector<ChannelOwner> channels_;
+    std::vector<Channel*> sending_channels_;
+    std::vector<SendEncoderSettings> encoder_settings_;
+    std::vector<size_t> leaders_;
+    // The sending channels by encode group, each starting with the channel
+    // which encodes, and the index of the first channel of each group. The
+    // last index is the number of channels.
+    std::vector<Channel*> grouped_channels_;
+    std::vector<size_t> encode_groups_;
 };
 
 }  // namespace voe
@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures how long the send side of the voice engine takes per 10 ms of
+// captured audio when one speaker is sent to many peers, such as in a
+// conference server, with the same Opus settings for every peer and with
+// different ones, encoding on the capture thread alone and on encode threads.
+
+#include <math.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common.h"
+#include "webrtc/modules/audio_device/include/fake_audio_device.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/perf_test.h"
+#include "webrtc/voice_engine/include/voe_base.h"
+#include "webrtc/voice_engine/include/voe_codec.h"
+#include "webrtc/voice_engine/include/voe_network.h"
+
+namespace webrtc {
+namespace {
+
+const int kSampleRateHz = 48000;
+const int kSamplesPer10Ms = kSampleRateHz / 100;
+const int kNumFrames = 500;
+const int kNumChannels[] = {1, 2, 4, 8, 16, 32};
+const int kNumEncodeThreads = 4;
+const int kOpusPayloadType = 96;
+
+class NullTransport : public Transport {
+ public:
+  int SendPacket(int channel, const void* data, size_t len) override {
+    return static_cast<int>(len);
+  }
+  int SendRTCPPacket(int channel, const void* data, size_t len) override {
+    return static_cast<int>(len);
+  }
+};
+
+// Sends a tone on |num_channels| Opus channels and prints the time taken per
+// 10 ms frame, and how many frames missed their real-time deadline. With
+// |same_settings| false, each channel has its own payload type, so the
+// channels can't share an encoder. With |num_encode_threads| above one, the
+// channels are encoded on that many threads.
+void MeasureSend(int num_channels, bool same_settings, int num_encode_threads,
+                 const std::string& trace) {
+  Config config;
+  if (num_encode_threads > 1)
+    config.Set<AudioEncodeThreadsConfig>(
+        new AudioEncodeThreadsConfig(num_encode_threads));
+  VoiceEngine* voe = VoiceEngine::Create(config);
+  VoEBase* base = VoEBase::GetInterface(voe);
+  VoECodec* codec = VoECodec::GetInterface(voe);
+  VoENetwork* network = VoENetwork::GetInterface(voe);
+  FakeAudioDeviceModule adm;
+  NullTransport transport;
+  ASSERT_EQ(0, base->Init(&adm, nullptr));
+
+  std::vector<int> channels;
+  for (int i = 0; i < num_channels; ++i) {
+    const int channel = base->CreateChannel();
+    ASSERT_NE(-1, channel);
+    ASSERT_EQ(0, network->RegisterExternalTransport(channel, transport));
+    CodecInst opus = {kOpusPayloadType + (same_settings ? 0 : i), "opus",
+                      48000, 960, 1, 32000};
+    ASSERT_EQ(0, codec->SetSendCodec(channel, opus));
+    ASSERT_EQ(0, base->StartSend(channel));
+    channels.push_back(channel);
+  }
+
+  int16_t audio[kSamplesPer10Ms];
+  int64_t elapsed_us = 0;
+  for (int i = 0; i < kNumFrames; ++i) {
+    for (int j = 0; j < kSamplesPer10Ms; ++j) {
+      audio[j] = static_cast<int16_t>(
+          8000 * sin(2 * M_PI * 440 * (i * kSamplesPer10Ms + j) /
+                     kSampleRateHz));
+    }
+    uint32_t mic_level = 0;
+    const int64_t start_us = TickTime::MicrosecondTimestamp();
+    base->audio_transport()->RecordedDataIsAvailable(
+        audio, kSamplesPer10Ms, 2, 1, kSampleRateHz, 0, 0, 0, false,
+        mic_level);
+    elapsed_us += TickTime::MicrosecondTimestamp() - start_us;
+  }
+  test::PrintResult("send_time_per_10ms", "", trace,
+                    static_cast<double>(elapsed_us) / kNumFrames, "us", false);
+  int num_blocks = 0;
+  int num_misses = 0;
+  ASSERT_EQ(0, base->GetCaptureDeadlineMisses(&num_blocks, &num_misses));
+  EXPECT_EQ(kNumFrames, num_blocks);
+  test::PrintResult("deadline_misses", "", trace, num_misses, "frames", false);
+
+  for (int channel : channels)
+    base->DeleteChannel(channel);
+  base->Terminate();
+  network->Release();
+  codec->Release();
+  base->Release();
+  VoiceEngine::Delete(voe);
+}
+
+}  // namespace
+
+TEST(TransmitMixerPerfTest, OpusChannels) {
+  for (int num_channels : kNumChannels) {
+    std::stringstream trace;
+    trace << num_channels << "_channels_";
+    MeasureSend(num_channels, true, 1, trace.str() + "same_settings");
+    MeasureSend(num_channels, false, 1, trace.str() + "different_settings");
+  }
+}
+
+TEST(TransmitMixerPerfTest, OpusChannelsOnEncodeThreads) {
+  for (int num_channels : kNumChannels) {
+    std::stringstream trace;
+    trace << num_channels << "_channels_" << kNumEncodeThreads << "_threads_";
+    MeasureSend(num_channels, true, kNumEncodeThreads,
+                trace.str() + "same_settings");
+    MeasureSend(num_channels, false, kNumEncodeThreads,
+                trace.str() + "different_settings");
+  }
+}
+
+}  // namespace webrtc
@@ -10,8 +10,16 @@
 
 #include "webrtc/voice_engine/transmit_mixer.h"
 
+#include <math.h>
+#include <string.h>
+
+#include <vector>
+
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/voice_engine/include/voe_codec.h"
 #include "webrtc/voice_engine/include/voe_external_media.h"
+#include "webrtc/voice_engine/include/voe_volume_control.h"
+#include "webrtc/voice_engine/voice_engine_fixture.h"
 
 namespace webrtc {
 namespace voe {
@@ -54,6 +62,161 @@ TEST(TransmitMixerTest, RegisterExternalMediaCallback) {
   TransmitMixer::Destroy(tm);
 }
 
+const int kRtpHeaderSize = 12;
+const int kSampleRateHz = 48000;
+const int kSamplesPer10Ms = kSampleRateHz / 100;
+// Opus sends 20 ms packets by default.
+const uint32_t kTimestampsPerPacket = 2 * kSamplesPer10Ms;
+
+struct RtpPacket {
+  uint16_t sequence_number;
+  uint32_t timestamp;
+  std::vector<uint8_t> payload;
+};
+
+class RecordingTransport : public Transport {
+ public:
+  int SendPacket(int channel, const void* data, size_t len) override {
+    const uint8_t* packet = static_cast<const uint8_t*>(data);
+    EXPECT_GT(len, static_cast<size_t>(kRtpHeaderSize));
+    RtpPacket rtp_packet;
+    rtp_packet.sequence_number =
+        static_cast<uint16_t>((packet[2] << 8) | packet[3]);
+    rtp_packet.timestamp = (static_cast<uint32_t>(packet[4]) << 24) |
+                           (packet[5] << 16) | (packet[6] << 8) | packet[7];
+    rtp_packet.payload.assign(packet + kRtpHeaderSize, packet + len);
+    packets_.push_back(rtp_packet);
+    return static_cast<int>(len);
+  }
+
+  int SendRTCPPacket(int channel, const void* data, size_t len) override {
+    return static_cast<int>(len);
+  }
+
+  const std::vector<RtpPacket>& packets() const { return packets_; }
+
+ private:
+  std::vector<RtpPacket> packets_;
+};
+
+class TransmitMixerSharedEncoderTest : public VoiceEngineFixture {
+ protected:
+  TransmitMixerSharedEncoderTest()
+      : codec_(VoECodec::GetInterface(voe_)),
+        volume_(VoEVolumeControl::GetInterface(voe_)),
+        frame_index_(0) {}
+
+  ~TransmitMixerSharedEncoderTest() {
+    codec_->Release();
+    volume_->Release();
+  }
+
+  int CreateSendingChannel(RecordingTransport* transport, int payload_type) {
+    const int channel = base_->CreateChannel();
+    EXPECT_NE(-1, channel);
+    EXPECT_EQ(0, network_->RegisterExternalTransport(channel, *transport));
+    CodecInst opus = {payload_type, "opus", 48000, 960, 2, 64000};
+    EXPECT_EQ(0, codec_->SetSendCodec(channel, opus));
+    EXPECT_EQ(0, base_->StartSend(channel));
+    return channel;
+  }
+
+  // Captures |num_frames| 10 ms frames of a tone.
+  void Capture(int num_frames) {
+    int16_t audio[kSamplesPer10Ms];
+    for (int i = 0; i < num_frames; ++i, ++frame_index_) {
+      for (int j = 0; j < kSamplesPer10Ms; ++j) {
+        const int n = frame_index_ * kSamplesPer10Ms + j;
+        audio[j] = static_cast<int16_t>(
+            8000 * sin(2 * M_PI * 440 * n / kSampleRateHz));
+      }
+      uint32_t mic_level = 0;
+      EXPECT_EQ(0, base_->audio_transport()->RecordedDataIsAvailable(
+                       audio, kSamplesPer10Ms, 2, 1, kSampleRateHz, 0, 0, 0,
+                       false, mic_level));
+    }
+  }
+
+  // Expects |packets| to be consecutive 20 ms packets.
+  void ExpectContinuous(const std::vector<RtpPacket>& packets) {
+    for (size_t i = 1; i < packets.size(); ++i) {
+      EXPECT_EQ(static_cast<uint16_t>(packets[i - 1].sequence_number + 1),
+                packets[i].sequence_number);
+      EXPECT_EQ(packets[i - 1].timestamp + kTimestampsPerPacket,
+                packets[i].timestamp);
+    }
+  }
+
+  VoECodec* codec_;
+  VoEVolumeControl* volume_;
+  int frame_index_;
+};
+
+TEST_F(TransmitMixerSharedEncoderTest, ChannelsWithSameCodecSendSamePayload) {
+  EXPECT_EQ(0, base_->Init(&adm_, nullptr));
+  RecordingTransport transport1;
+  RecordingTransport transport2;
+  RecordingTransport transport3;
+  const int channel1 = CreateSendingChannel(&transport1, 120);
+  const int channel2 = CreateSendingChannel(&transport2, 120);
+  // Another payload type is another encoder setting.
+  const int channel3 = CreateSendingChannel(&transport3, 121);
+
+  Capture(20);
+  // The second channel stops sharing while its audio is muted.
+  EXPECT_EQ(0, volume_->SetInputMute(channel2, true));
+  Capture(20);
+  EXPECT_EQ(0, volume_->SetInputMute(channel2, false));
+  Capture(20);
+  EXPECT_EQ(0, base_->DeleteChannel(channel1));
+  EXPECT_EQ(0, base_->DeleteChannel(channel2));
+  EXPECT_EQ(0, base_->DeleteChannel(channel3));
+
+  const std::vector<RtpPacket>& packets1 = transport1.packets();
+  const std::vector<RtpPacket>& packets2 = transport2.packets();
+  const std::vector<RtpPacket>& packets3 = transport3.packets();
+  ASSERT_EQ(30u, packets1.size());
+  ASSERT_EQ(30u, packets2.size());
+  ASSERT_EQ(30u, packets3.size());
+  ExpectContinuous(packets1);
+  ExpectContinuous(packets2);
+  ExpectContinuous(packets3);
+  for (size_t i = 0; i < packets1.size(); ++i) {
+    const bool muted = i >= 10 && i < 20;
+    EXPECT_EQ(!muted, packets1[i].payload == packets2[i].payload) << i;
+  }
+}
+
+TEST_F(TransmitMixerSharedEncoderTest, ChannelsRegroupBetweenPackets) {
+  EXPECT_EQ(0, base_->Init(&adm_, nullptr));
+  RecordingTransport transport1;
+  RecordingTransport transport2;
+  const int channel1 = CreateSendingChannel(&transport1, 120);
+  const int channel2 = CreateSendingChannel(&transport2, 120);
+
+  // Mute and unmute the second channel in the middle of a packet. It keeps
+  // the shared encoder until the packet is sent, and its own one until the
+  // next.
+  Capture(21);
+  EXPECT_EQ(0, volume_->SetInputMute(channel2, true));
+  Capture(20);
+  EXPECT_EQ(0, volume_->SetInputMute(channel2, false));
+  Capture(19);
+  EXPECT_EQ(0, base_->DeleteChannel(channel1));
+  EXPECT_EQ(0, base_->DeleteChannel(channel2));
+
+  const std::vector<RtpPacket>& packets1 = transport1.packets();
+  const std::vector<RtpPacket>& packets2 = transport2.packets();
+  ASSERT_EQ(30u, packets1.size());
+  ASSERT_EQ(30u, packets2.size());
+  ExpectContinuous(packets1);
+  ExpectContinuous(packets2);
+  for (size_t i = 0; i < packets1.size(); ++i) {
+    const bool own_encoder = i >= 11 && i < 21;
+    EXPECT_EQ(!own_encoder, packets1[i].payload == packets2[i].payload) << i;
+  }
+}
+
 }  // namespace
 }  // namespace voe
 }  // namespace webrtc
@@ -18,6 +18,7 @@
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/file_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/voice_engine/channel.h"
 #include "webrtc/voice_engine/include/voe_errors.h"
 #include "webrtc/voice_engine/output_mixer.h"
@@ -633,6 +634,12 @@ int32_t VoEBaseImpl::AddExternalTransportBuild(char* str) const {
 
 int VoEBaseImpl::LastError() { return (shared_->statistics().LastError()); }
 
+int VoEBaseImpl::GetCaptureDeadlineMisses(int* num_blocks, int* num_misses) {
+  *num_blocks = capture_blocks_.Value();
+  *num_misses = capture_deadline_misses_.Value();
+  return 0;
+}
+
 int32_t VoEBaseImpl::StartPlayout() {
   if (shared_->audio_device()->Playing()) {
     return 0;
@@ -748,6 +755,7 @@ int VoEBaseImpl::ProcessRecordedDataWithAPM(
     int32_t clock_drift, uint32_t volume, bool key_pressed) {
   assert(shared_->transmit_mixer() != nullptr);
   assert(shared_->audio_device() != nullptr);
+  const int64_t start_us = TickTime::MicrosecondTimestamp();
 
   uint32_t max_volume = 0;
   uint16_t voe_mic_level = 0;
@@ -795,6 +803,14 @@ int VoEBaseImpl::ProcessRecordedDataWithAPM(
                                              number_of_voe_channels);
   }
 
+  // The deadline is missed if the block took longer than the audio it holds.
+  const int64_t elapsed_us = TickTime::MicrosecondTimestamp() - start_us;
+  ++capture_blocks_;
+  if (elapsed_us * sample_rate >
+      static_cast<int64_t>(number_of_frames) * 1000000) {
+    ++capture_deadline_misses_;
+  }
+
   // Scale from VoE to ADM level range.
   uint32_t new_voe_mic_level = shared_->transmit_mixer()->CaptureLevel();
   if (new_voe_mic_level != voe_mic_level) {
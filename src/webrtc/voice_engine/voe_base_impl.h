@@ -14,6 +14,7 @@
 #include "webrtc/voice_engine/include/voe_base.h"
 
 #include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
 #include "webrtc/voice_engine/shared_data.h"
 
 namespace webrtc {
@@ -51,6 +52,8 @@ class VoEBaseImpl : public VoEBase,
 
   AudioTransport* audio_transport() override { return this; }
 
+  int GetCaptureDeadlineMisses(int* num_blocks, int* num_misses) override;
+
   int AssociateSendChannel(int channel, int accociate_send_channel) override;
 
   // AudioTransport
@@ -126,6 +129,10 @@ class VoEBaseImpl : public VoEBase,
 
   AudioFrame audioFrame_;
   voe::SharedData* shared_;
+
+  // Counted on the audio device thread.
+  Atomic32 capture_blocks_;
+  Atomic32 capture_deadline_misses_;
 };
 
 }  // namespace webrtc